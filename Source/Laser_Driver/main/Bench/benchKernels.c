@@ -0,0 +1,295 @@
+#include <stdio.h>
+#include <string.h>
+
+#include "sdkconfig.h"
+
+#include "tempConversion.h"
+#include "textFormat.h"
+#if !CONFIG_IDF_TARGET_LINUX
+#include "adcController.h"
+#endif
+#include "benchmark.h"
+
+/******************************************************************************
+*   Private Definitions
+*******************************************************************************/
+#define BK_TEMP_TABLE_SIZE                  (67)//-40C to 125C by 2.5C, as the NTC table
+#define BK_TEMP_FIRST_ADC                   (199)
+#define BK_TEMP_ADC_STEP                    (55)
+#define BK_TEMP_ADC_TOLERANCE               (10)
+
+#define BK_FRAME_NB_CHANNELS                (4)//Bus voltage, reference, phase currents
+#define BK_FRAME_NB_SAMPLES                 (256)//Conversion results of one ADC frame
+#define BK_CHANNEL_NB_SAMPLES               (BK_FRAME_NB_SAMPLES / BK_FRAME_NB_CHANNELS)
+
+//ADC digital controller output, TYPE2 format (esp32s3, 4 bytes per result)
+#define BK_TYPE2_DATA_MASK                  (0x0FFF)
+#define BK_TYPE2_CHANNEL_SHIFT              (13)
+#define BK_TYPE2_CHANNEL_MASK               (0x0F)
+
+#define BK_AVG_WINDOW                       (16)//As the bus voltage average (pwrMonitoring.c)
+
+#define BK_CALIB_NB_SAMPLES                 (64)
+
+#define BK_LINE_SIZE                        (96)
+
+/******************************************************************************
+*   Private Macros
+*******************************************************************************/
+#define BK_ARRAY_SIZE(arr)                  (sizeof(arr) / sizeof(arr[0]))
+
+/******************************************************************************
+*   Private Data Types
+*******************************************************************************/
+
+
+/******************************************************************************
+*   Private Functions Declaration
+*******************************************************************************/
+static uint32_t hashLine(const char *pLine, size_t len);
+static void setupTconv(void);
+static uint32_t runTconv(uint32_t iteration);
+static void setupFrame(void);
+static uint32_t runDeinterleave(uint32_t iteration);
+static uint32_t runAverage(uint32_t iteration);
+#if !CONFIG_IDF_TARGET_LINUX
+static uint32_t runCalib(uint32_t iteration);
+#endif
+static uint32_t runFmt(uint32_t iteration);
+static uint32_t runSnprintf(uint32_t iteration);
+
+/******************************************************************************
+*   Public Variables
+*******************************************************************************/
+//Registered kernels (bench list|run)
+const BENCH_Kernel_t bench_kernels[] = {
+    BENCH_KERNEL(tconv,         setupTconv,     runTconv),
+    BENCH_KERNEL(deinterleave,  setupFrame,     runDeinterleave),
+    BENCH_KERNEL(average,       setupFrame,     runAverage),
+#if !CONFIG_IDF_TARGET_LINUX
+    BENCH_KERNEL(calib,         setupFrame,     runCalib),
+#endif
+    BENCH_KERNEL(fmt,           NULL,           runFmt),
+    BENCH_KERNEL(snprintf,      NULL,           runSnprintf),
+};
+
+const uint32_t bench_nb_kernels = BK_ARRAY_SIZE(bench_kernels);
+
+/******************************************************************************
+*   Private Variables
+*******************************************************************************/
+static TEMP_Conv_t temp_table[BK_TEMP_TABLE_SIZE];
+static TEMP_Conv_Config_t temp_config = {
+    .pConvTable = temp_table,
+    .table_size = BK_TEMP_TABLE_SIZE,
+    .adc_tolerance = BK_TEMP_ADC_TOLERANCE,
+};
+
+static uint32_t adc_frame[BK_FRAME_NB_SAMPLES];
+static uint16_t channel_samples[BK_FRAME_NB_CHANNELS][BK_CHANNEL_NB_SAMPLES];
+static uint16_t average_samples[BK_CHANNEL_NB_SAMPLES];
+#if !CONFIG_IDF_TARGET_LINUX
+static uint16_t calib_samples[BK_CALIB_NB_SAMPLES];
+#endif
+
+static char line[BK_LINE_SIZE];
+
+/******************************************************************************
+*   Error Check
+*******************************************************************************/
+_Static_assert((BK_TEMP_FIRST_ADC + (BK_TEMP_TABLE_SIZE * BK_TEMP_ADC_STEP)) < 4096, "Temperature table out of the ADC range");
+_Static_assert(BK_CALIB_NB_SAMPLES <= BK_CHANNEL_NB_SAMPLES, "Calibration samples out of the frame");
+
+/******************************************************************************
+*   Private Functions Definitions
+*******************************************************************************/
+/***************************************************************************//*!
+*  \brief Hash line.
+*
+*   This function folds a formatted line in the kernel result.
+*
+*******************************************************************************/
+static uint32_t hashLine(const char *pLine, size_t len){
+
+    uint32_t hash = (uint32_t)len;
+
+    for(size_t i=0; i<len; i++){
+        hash = (hash * 31) + (uint8_t)pLine[i];
+    }
+
+    return hash;
+}
+
+/***************************************************************************//*!
+*  \brief Temperature conversion setup.
+*
+*   This function builds a conversion table of the size of the NTC table
+*   (temperatureMonitoring.c), the search cost depends on it.
+*
+*******************************************************************************/
+static void setupTconv(void){
+
+    for(uint32_t i=0; i<BK_TEMP_TABLE_SIZE; i++){
+        temp_table[i].adc_value = (uint16_t)(BK_TEMP_FIRST_ADC + (i * BK_TEMP_ADC_STEP));
+        temp_table[i].temperature = (int16_t)(-4000 + (int32_t)(i * 250));
+    }
+}
+
+/***************************************************************************//*!
+*  \brief Temperature conversion kernel.
+*
+*   This function converts an ADC value sweeping the whole table.
+*
+*******************************************************************************/
+static uint32_t runTconv(uint32_t iteration){
+
+    uint16_t adc_value = (uint16_t)(BK_TEMP_FIRST_ADC + ((iteration * 37) % ((BK_TEMP_TABLE_SIZE - 1) * BK_TEMP_ADC_STEP)));
+
+    return (uint16_t)TCONV_ConvertToTemp(adc_value, &temp_config);
+}
+
+/***************************************************************************//*!
+*  \brief ADC frame setup.
+*
+*   This function fills an ADC frame (channels in sequence, TYPE2 format)
+*   and its de-interleaved samples.
+*
+*******************************************************************************/
+static void setupFrame(void){
+
+    for(uint32_t i=0; i<BK_FRAME_NB_SAMPLES; i++){
+        uint32_t channel = i % BK_FRAME_NB_CHANNELS;
+        uint32_t data = ((i * 1103) + (channel * 1000)) & BK_TYPE2_DATA_MASK;
+        adc_frame[i] = data | (channel << BK_TYPE2_CHANNEL_SHIFT);
+        channel_samples[channel][i / BK_FRAME_NB_CHANNELS] = (uint16_t)data;
+    }
+}
+
+/***************************************************************************//*!
+*  \brief Frame de-interleave kernel.
+*
+*   This function splits one ADC frame into per channel samples.
+*
+*******************************************************************************/
+static uint32_t runDeinterleave(uint32_t iteration){
+
+    uint32_t nb_samples[BK_FRAME_NB_CHANNELS] = {0};
+
+    (void)iteration;
+
+    for(uint32_t i=0; i<BK_FRAME_NB_SAMPLES; i++){
+
+        uint32_t result = adc_frame[i];
+        uint32_t channel = (result >> BK_TYPE2_CHANNEL_SHIFT) & BK_TYPE2_CHANNEL_MASK;
+
+        if((channel >= BK_FRAME_NB_CHANNELS) || (nb_samples[channel] >= BK_CHANNEL_NB_SAMPLES))   continue;
+
+        channel_samples[channel][nb_samples[channel]++] = (uint16_t)(result & BK_TYPE2_DATA_MASK);
+    }
+
+    return nb_samples[0] + channel_samples[BK_FRAME_NB_CHANNELS - 1][BK_CHANNEL_NB_SAMPLES - 1];
+}
+
+/***************************************************************************//*!
+*  \brief Moving average kernel.
+*
+*   This function computes the running average of the samples of one
+*   channel of a frame over BK_AVG_WINDOW samples.
+*
+*******************************************************************************/
+static uint32_t runAverage(uint32_t iteration){
+
+    const uint16_t *pSamples = channel_samples[iteration % BK_FRAME_NB_CHANNELS];
+    uint32_t sum = 0;
+
+    for(uint32_t i=0; i<BK_CHANNEL_NB_SAMPLES; i++){
+
+        sum += pSamples[i];
+        if(i >= BK_AVG_WINDOW)  sum -= pSamples[i - BK_AVG_WINDOW];
+
+        average_samples[i] = (uint16_t)(sum / ((i < BK_AVG_WINDOW) ? (i + 1) : BK_AVG_WINDOW));
+    }
+
+    return average_samples[BK_CHANNEL_NB_SAMPLES - 1];
+}
+
+#if !CONFIG_IDF_TARGET_LINUX
+/***************************************************************************//*!
+*  \brief Calibration kernel.
+*
+*   This function applies the ADC calibration (curve fitting scheme) to the
+*   bus voltage samples of a frame, as pwrMonitoring.c does. Needs the ADC
+*   controller initialized.
+*
+*******************************************************************************/
+static uint32_t runCalib(uint32_t iteration){
+
+    (void)iteration;
+
+    memcpy(calib_samples, channel_samples[0], sizeof(calib_samples));
+
+    if(ADC_CTRL_STATUS_SUCCESS != ADC_ApplyCalibration(ADC_CTRL_CHANNEL_BUS_VOLT, ADC_CTRL_ATTEN_12DB,
+                                                       calib_samples, BK_CALIB_NB_SAMPLES)){
+        return 0;
+    }
+
+    return calib_samples[BK_CALIB_NB_SAMPLES - 1];
+}
+#endif
+
+/***************************************************************************//*!
+*  \brief Formatting kernel.
+*
+*   This function formats a status line with the FMT_xxx() functions.
+*
+*******************************************************************************/
+static uint32_t runFmt(uint32_t iteration){
+
+    FMT_Buffer_t fmt;
+
+    FMT_Init(&fmt, line, sizeof(line));
+    FMT_String(&fmt, "bus ");
+    FMT_Unit(&fmt, 2400 + (int32_t)(iteration % 100), FMT_UNIT_10MV);
+    FMT_String(&fmt, " ia ");
+    FMT_Unit(&fmt, (int32_t)(iteration % 500), FMT_UNIT_10MA);
+    FMT_String(&fmt, " temp ");
+    FMT_Unit(&fmt, 2500 + (int32_t)(iteration % 2000), FMT_UNIT_CENTI_DEG);
+    FMT_String(&fmt, " fault 0x");
+    size_t len = FMT_Hex(&fmt, iteration & 0x3, 4);
+
+    return hashLine(line, len);
+}
+
+/***************************************************************************//*!
+*  \brief Formatting kernel (snprintf).
+*
+*   This function formats the same status line with snprintf()
+*   (reference).
+*
+*******************************************************************************/
+static uint32_t runSnprintf(uint32_t iteration){
+
+    int32_t bus_10mv = 2400 + (int32_t)(iteration % 100);
+    int32_t ia_10ma = (int32_t)(iteration % 500);
+    int32_t temperature = 2500 + (int32_t)(iteration % 2000);
+
+    int len = snprintf(line, sizeof(line), "bus %ld.%02ldV ia %ld.%02ldA temp %ld.%02ldC fault 0x%04lX",
+                       (long)(bus_10mv / 100), (long)(bus_10mv % 100), (long)(ia_10ma / 100), (long)(ia_10ma % 100),
+                       (long)(temperature / 100), (long)(temperature % 100), (unsigned long)(iteration & 0x3));
+
+    return hashLine(line, (len > 0) ? (size_t)len : 0);
+}
+
+/******************************************************************************
+*   CallBack Functions implementation
+*******************************************************************************/
+
+
+/******************************************************************************
+*   Public Functions Definitions
+*******************************************************************************/
+
+
+/******************************************************************************
+*   Interrupts
+*******************************************************************************/
@@ -0,0 +1,215 @@
+#include <string.h>
+
+#include "benchmark.h"
+
+/******************************************************************************
+*   Private Definitions
+*******************************************************************************/
+
+
+/******************************************************************************
+*   Private Macros
+*******************************************************************************/
+#define BENCH_SUB_SAT(a, b)                 (((a) > (b)) ? ((a) - (b)) : 0)
+
+/******************************************************************************
+*   Private Data Types
+*******************************************************************************/
+
+
+/******************************************************************************
+*   Private Functions Declaration
+*******************************************************************************/
+static uint32_t runEmpty(uint32_t iteration);
+static BENCH_Ret_t runPasses(BENCH_Run_t run, uint32_t nb_iterations, BENCH_CFG_Counters_t *pCounters);
+
+/******************************************************************************
+*   Public Variables
+*******************************************************************************/
+
+
+/******************************************************************************
+*   Private Variables
+*******************************************************************************/
+static volatile uint32_t bench_sink = 0;
+
+/******************************************************************************
+*   Error Check
+*******************************************************************************/
+
+
+/******************************************************************************
+*   Private Functions Definitions
+*******************************************************************************/
+/***************************************************************************//*!
+*  \brief Empty kernel.
+*
+*   This function is the bench baseline (loop and call overhead).
+*
+*******************************************************************************/
+static uint32_t runEmpty(uint32_t iteration){
+
+    return iteration;
+}
+
+/***************************************************************************//*!
+*  \brief Run passes.
+*
+*   This function runs the iterations once per counter pass. Not inlined
+*   nor specialized: the baseline and the kernels run the same loop.
+*
+*******************************************************************************/
+static __attribute__((noipa)) BENCH_Ret_t runPasses(BENCH_Run_t run, uint32_t nb_iterations, BENCH_CFG_Counters_t *pCounters){
+
+    uint32_t nb_passes = BENCH_CFG_GetNbPasses();
+    uint32_t sink = 0;
+
+    memset(pCounters, 0, sizeof(*pCounters));
+
+    //Warm up (caches, first call paths)
+    sink += run(0);
+
+    for(uint32_t pass=0; pass<nb_passes; pass++){
+
+        if(BENCH_CFG_STATUS_OK != BENCH_CFG_StartPass(pass))    return BENCH_STATUS_ERROR;
+
+        for(uint32_t i=0; i<nb_iterations; i++){
+            sink += run(i);
+        }
+
+        if(BENCH_CFG_STATUS_OK != BENCH_CFG_StopPass(pass, pCounters))  return BENCH_STATUS_ERROR;
+    }
+
+    bench_sink = sink;
+
+    return BENCH_STATUS_OK;
+}
+
+/******************************************************************************
+*   CallBack Functions implementation
+*******************************************************************************/
+
+
+/******************************************************************************
+*   Public Functions Definitions
+*******************************************************************************/
+/***************************************************************************//*!
+*  \brief Get number of kernels.
+*
+*   This function return the number of registered kernels.
+*
+*   Preconditions: None.
+*
+*   Side Effects: None.
+*
+*   \return     Number of kernels
+*
+*******************************************************************************/
+uint32_t BENCH_GetNbKernels(void){
+
+    return bench_nb_kernels;
+}
+
+/***************************************************************************//*!
+*  \brief Get kernel name.
+*
+*   This function return the name of a registered kernel.
+*
+*   Preconditions: None.
+*
+*   Side Effects: None.
+*
+*   \param[in]  index               Kernel index.
+*
+*   \return     Name (NULL if invalid)
+*
+*******************************************************************************/
+const char *BENCH_GetKernelName(uint32_t index){
+
+    if(index >= bench_nb_kernels)   return NULL;
+
+    return bench_kernels[index].name;
+}
+
+/***************************************************************************//*!
+*  \brief Find kernel.
+*
+*   This function is used to find a registered kernel by name.
+*
+*   Preconditions: None.
+*
+*   Side Effects: None.
+*
+*   \param[in]  pName               Kernel name.
+*   \param[out] pIndex              Kernel index.
+*
+*   \return     Operation status
+*
+*******************************************************************************/
+BENCH_Ret_t BENCH_FindKernel(const char *pName, uint32_t *pIndex){
+
+    if((pName == NULL) || (pIndex == NULL)) return BENCH_STATUS_ERROR;
+
+    for(uint32_t i=0; i<bench_nb_kernels; i++){
+        if(strcmp(pName, bench_kernels[i].name) == 0){
+            *pIndex = i;
+            return BENCH_STATUS_OK;
+        }
+    }
+
+    return BENCH_STATUS_ERROR;
+}
+
+/***************************************************************************//*!
+*  \brief Run kernel.
+*
+*   This function is used to run a kernel for a number of iterations, once
+*   per counter pass of the platform (BENCH_CFG_GetNbPasses()), after a
+*   warm up iteration. The cost of an empty kernel is removed from the
+*   totals.
+*
+*   Preconditions: Called from a task pinned to a core.
+*
+*   Side Effects: Blocks the caller during the run.
+*
+*   \param[in]  index               Kernel index.
+*   \param[in]  nb_iterations       Iterations (1 -> BENCH_MAX_ITERATIONS).
+*   \param[out] pResult             Result.
+*
+*   \return     Operation status
+*
+*******************************************************************************/
+BENCH_Ret_t BENCH_Run(uint32_t index, uint32_t nb_iterations, BENCH_Result_t *pResult){
+
+    BENCH_CFG_Counters_t base;
+
+    if((index >= bench_nb_kernels) || (pResult == NULL))    return BENCH_STATUS_ERROR;
+
+    if((nb_iterations == 0) || (nb_iterations > BENCH_MAX_ITERATIONS))  return BENCH_STATUS_ERROR;
+
+    const BENCH_Kernel_t *pKernel = &bench_kernels[index];
+
+    *pResult = (BENCH_Result_t){
+        .name = pKernel->name,
+        .nb_iterations = nb_iterations,
+        .counter_mask = BENCH_CFG_GetCounterMask(),
+    };
+
+    if(pKernel->setup != NULL)  pKernel->setup();
+
+    if(BENCH_STATUS_OK != runPasses(runEmpty, nb_iterations, &base))    return BENCH_STATUS_ERROR;
+    if(BENCH_STATUS_OK != runPasses(pKernel->run, nb_iterations, &pResult->counters))   return BENCH_STATUS_ERROR;
+
+    BENCH_CFG_Counters_t *pCounters = &pResult->counters;
+    pCounters->time_ns = BENCH_SUB_SAT(pCounters->time_ns, base.time_ns);
+    pCounters->cycles = BENCH_SUB_SAT(pCounters->cycles, base.cycles);
+    pCounters->instructions = BENCH_SUB_SAT(pCounters->instructions, base.instructions);
+    pCounters->icache_misses = BENCH_SUB_SAT(pCounters->icache_misses, base.icache_misses);
+    pCounters->dcache_misses = BENCH_SUB_SAT(pCounters->dcache_misses, base.dcache_misses);
+
+    return BENCH_STATUS_OK;
+}
+
+/******************************************************************************
+*   Interrupts
+*******************************************************************************/
@@ -0,0 +1,128 @@
+#ifndef __BENCHMARK_H
+#define __BENCHMARK_H
+
+#include <stdint.h>
+#include <stdbool.h>
+
+#include "benchmark_cfg.h"
+
+/******************************************************************************
+*   Public Definitions
+*******************************************************************************/
+#define BENCH_DEFAULT_ITERATIONS            (1000)
+#define BENCH_MAX_ITERATIONS                (100000)
+
+/******************************************************************************
+*   Public Macros
+*******************************************************************************/
+//Kernel registration (bench_kernels[] of benchKernels.c): name, setup
+//function (NULL: none), kernel function
+#define BENCH_KERNEL(name, setup, run)      {#name, (setup), (run)}
+
+/******************************************************************************
+*   Public Data Types
+*******************************************************************************/
+typedef void(*BENCH_Setup_t)(void);
+typedef uint32_t(*BENCH_Run_t)(uint32_t iteration);//Result kept (not optimized out)
+
+typedef struct BENCH_Kernel_s{
+    const char *name;
+    BENCH_Setup_t setup;                //Input data, called once before the passes
+    BENCH_Run_t run;                    //One iteration
+}BENCH_Kernel_t;
+
+typedef struct BENCH_Result_s{
+    const char *name;
+    uint32_t nb_iterations;
+    uint32_t counter_mask;              //Counters measured (BENCH_CFG_COUNTER_xxx)
+    BENCH_CFG_Counters_t counters;      //Totals of the iterations, call overhead removed
+}BENCH_Result_t;
+
+typedef enum BENCH_Ret_e{
+    BENCH_STATUS_ERROR,
+    BENCH_STATUS_OK,
+}BENCH_Ret_t;
+
+/******************************************************************************
+*   Public Variables
+*******************************************************************************/
+extern const BENCH_Kernel_t bench_kernels[];    //benchKernels.c
+extern const uint32_t bench_nb_kernels;         //benchKernels.c
+
+/******************************************************************************
+*   Error Check
+*******************************************************************************/
+
+
+/******************************************************************************
+*   Public Functions Declarations
+*******************************************************************************/
+/***************************************************************************//*!
+*  \brief Get number of kernels.
+*
+*   This function return the number of registered kernels.
+*
+*   Preconditions: None.
+*
+*   Side Effects: None.
+*
+*   \return     Number of kernels
+*
+*******************************************************************************/
+uint32_t BENCH_GetNbKernels(void);
+
+/***************************************************************************//*!
+*  \brief Get kernel name.
+*
+*   This function return the name of a registered kernel.
+*
+*   Preconditions: None.
+*
+*   Side Effects: None.
+*
+*   \param[in]  index               Kernel index.
+*
+*   \return     Name (NULL if invalid)
+*
+*******************************************************************************/
+const char *BENCH_GetKernelName(uint32_t index);
+
+/***************************************************************************//*!
+*  \brief Find kernel.
+*
+*   This function is used to find a registered kernel by name.
+*
+*   Preconditions: None.
+*
+*   Side Effects: None.
+*
+*   \param[in]  pName               Kernel name.
+*   \param[out] pIndex              Kernel index.
+*
+*   \return     Operation status
+*
+*******************************************************************************/
+BENCH_Ret_t BENCH_FindKernel(const char *pName, uint32_t *pIndex);
+
+/***************************************************************************//*!
+*  \brief Run kernel.
+*
+*   This function is used to run a kernel for a number of iterations, once
+*   per counter pass of the platform (BENCH_CFG_GetNbPasses()), after a
+*   warm up iteration. The cost of an empty kernel is removed from the
+*   totals.
+*
+*   Preconditions: Called from a task pinned to a core.
+*
+*   Side Effects: Blocks the caller during the run.
+*
+*   \param[in]  index               Kernel index.
+*   \param[in]  nb_iterations       Iterations (1 -> BENCH_MAX_ITERATIONS).
+*   \param[out] pResult             Result.
+*
+*   \return     Operation status
+*
+*******************************************************************************/
+BENCH_Ret_t BENCH_Run(uint32_t index, uint32_t nb_iterations, BENCH_Result_t *pResult);
+
+#endif//__BENCHMARK_H
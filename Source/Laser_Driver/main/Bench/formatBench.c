@@ -0,0 +1,282 @@
+#include <stdio.h>
+
+#include "freertos/FreeRTOS.h"
+#include "freertos/task.h"
+
+#include "esp_cpu.h"
+
+#include "textFormat.h"
+#include "formatBench.h"
+
+/******************************************************************************
+*   Private Definitions
+*******************************************************************************/
+#define FBENCH_STACK_SIZE                   (4096)
+#define FBENCH_LINE_SIZE                    (96)
+#define FBENCH_HASH_INIT                    (0x811C9DC5UL)//FNV-1a
+#define FBENCH_HASH_PRIME                   (0x01000193UL)
+
+/******************************************************************************
+*   Private Macros
+*******************************************************************************/
+#define FBENCH_ABS(value)                   (((value) < 0) ? (0U - (uint32_t)(value)) : (uint32_t)(value))
+#define FBENCH_SIGN(value)                  (((value) < 0) ? "-" : "")
+
+/******************************************************************************
+*   Private Data Types
+*******************************************************************************/
+typedef struct FBENCH_Values_s{
+    int32_t bus_10mv;
+    int32_t ia_10ma;
+    int32_t ib_10ma;
+    int32_t temperature;
+    uint32_t fault_flags;
+}FBENCH_Values_t;
+
+typedef size_t (*FBENCH_Formatter_t)(char *pBuffer, size_t size, const FBENCH_Values_t *pValues);
+
+typedef struct FBENCH_Task_s{
+    FBENCH_Formatter_t pFormatter;
+    uint32_t nb_rounds;
+    TaskHandle_t caller_handle;
+    uint64_t total_cycles;
+    uint32_t max_cycles;
+    uint32_t stack_used;                //Bytes
+    uint32_t line_len;                  //Last line
+    uint32_t hash;                      //Every line
+    char line[FBENCH_LINE_SIZE];        //Outside the bench task stack
+}FBENCH_Task_t;
+
+/******************************************************************************
+*   Private Functions Declaration
+*******************************************************************************/
+static void benchValues(uint32_t round, FBENCH_Values_t *pValues);
+static size_t benchNone(char *pBuffer, size_t size, const FBENCH_Values_t *pValues);
+static size_t benchPrintf(char *pBuffer, size_t size, const FBENCH_Values_t *pValues);
+static size_t benchFmt(char *pBuffer, size_t size, const FBENCH_Values_t *pValues);
+static void tBenchTask(void *pvParameters);
+static bool runBench(FBENCH_Formatter_t pFormatter, uint32_t nb_rounds);
+
+/******************************************************************************
+*   Public Variables
+*******************************************************************************/
+
+
+/******************************************************************************
+*   Private Variables
+*******************************************************************************/
+//Shell task only
+static FBENCH_Task_t bench_task;
+
+/******************************************************************************
+*   Error Check
+*******************************************************************************/
+
+
+/******************************************************************************
+*   Private Functions Definitions
+*******************************************************************************/
+/***************************************************************************//*!
+*  \brief Bench values.
+*
+*   This function generates the status line values of a bench round
+*   (negative currents included).
+*
+*******************************************************************************/
+static void benchValues(uint32_t round, FBENCH_Values_t *pValues){
+
+    pValues->bus_10mv = 2400 + (int32_t)(round % 200);
+    pValues->ia_10ma = 500 - (int32_t)((round * 7) % 1000);
+    pValues->ib_10ma = (int32_t)((round * 13) % 1000) - 500;
+    pValues->temperature = 2500 + (int32_t)((round * 3) % 6000);
+    pValues->fault_flags = round & 0x03;
+}
+
+/***************************************************************************//*!
+*  \brief Bench no formatter.
+*
+*   This function is the bench baseline (bench task overhead).
+*
+*******************************************************************************/
+static size_t benchNone(char *pBuffer, size_t size, const FBENCH_Values_t *pValues){
+
+    (void)size;
+    (void)pValues;
+
+    pBuffer[0] = '\0';
+    return 0;
+}
+
+/***************************************************************************//*!
+*  \brief Bench snprintf formatter.
+*
+*   This function formats the status line with snprintf().
+*
+*******************************************************************************/
+static size_t benchPrintf(char *pBuffer, size_t size, const FBENCH_Values_t *pValues){
+
+    int len = snprintf(pBuffer, size, "bus %s%lu.%02luV ia %s%lu.%02luA ib %s%lu.%02luA temp %s%lu.%02luC fault 0x%04lX",
+                       FBENCH_SIGN(pValues->bus_10mv), FBENCH_ABS(pValues->bus_10mv) / 100, FBENCH_ABS(pValues->bus_10mv) % 100,
+                       FBENCH_SIGN(pValues->ia_10ma), FBENCH_ABS(pValues->ia_10ma) / 100, FBENCH_ABS(pValues->ia_10ma) % 100,
+                       FBENCH_SIGN(pValues->ib_10ma), FBENCH_ABS(pValues->ib_10ma) / 100, FBENCH_ABS(pValues->ib_10ma) % 100,
+                       FBENCH_SIGN(pValues->temperature), FBENCH_ABS(pValues->temperature) / 100, FBENCH_ABS(pValues->temperature) % 100,
+                       pValues->fault_flags);
+
+    if(len < 0) return 0;
+    return ((size_t)len < size) ? (size_t)len : (size - 1);
+}
+
+/***************************************************************************//*!
+*  \brief Bench FMT formatter.
+*
+*   This function formats the status line with the FMT_xxx() functions.
+*
+*******************************************************************************/
+static size_t benchFmt(char *pBuffer, size_t size, const FBENCH_Values_t *pValues){
+
+    FMT_Buffer_t fmt;
+
+    FMT_Init(&fmt, pBuffer, size);
+    FMT_String(&fmt, "bus ");
+    FMT_Unit(&fmt, pValues->bus_10mv, FMT_UNIT_10MV);
+    FMT_String(&fmt, " ia ");
+    FMT_Unit(&fmt, pValues->ia_10ma, FMT_UNIT_10MA);
+    FMT_String(&fmt, " ib ");
+    FMT_Unit(&fmt, pValues->ib_10ma, FMT_UNIT_10MA);
+    FMT_String(&fmt, " temp ");
+    FMT_Unit(&fmt, pValues->temperature, FMT_UNIT_CENTI_DEG);
+    FMT_String(&fmt, " fault 0x");
+
+    return FMT_Hex(&fmt, pValues->fault_flags, 4);
+}
+
+/***************************************************************************//*!
+*  \brief Bench task.
+*
+*   This function formats the bench lines (cycles per line), then reports
+*   its stack use (high water mark of a fresh stack) to the caller.
+*
+*******************************************************************************/
+static void tBenchTask(void *pvParameters){
+
+    FBENCH_Task_t *pTask = (FBENCH_Task_t *)pvParameters;
+    FBENCH_Values_t values;
+
+    for(uint32_t round=0; round<pTask->nb_rounds; round++){
+
+        benchValues(round, &values);
+
+        uint32_t start_cycles = esp_cpu_get_cycle_count();
+        size_t len = pTask->pFormatter(pTask->line, sizeof(pTask->line), &values);
+        uint32_t cycles = esp_cpu_get_cycle_count() - start_cycles;
+
+        pTask->total_cycles += cycles;
+        if(cycles > pTask->max_cycles)  pTask->max_cycles = cycles;
+        pTask->line_len = len;
+
+        for(size_t i=0; i<len; i++){
+            pTask->hash = (pTask->hash ^ (uint8_t)pTask->line[i]) * FBENCH_HASH_PRIME;
+        }
+    }
+
+    //Stack in bytes (StackType_t is uint8_t)
+    pTask->stack_used = FBENCH_STACK_SIZE - uxTaskGetStackHighWaterMark(NULL);
+
+    xTaskNotifyGive(pTask->caller_handle);
+    vTaskDelete(NULL);
+}
+
+/***************************************************************************//*!
+*  \brief Run bench.
+*
+*   This function runs a formatter in a new bench task (caller core,
+*   cycle counter of one core) and waits for its results in bench_task.
+*
+*******************************************************************************/
+static bool runBench(FBENCH_Formatter_t pFormatter, uint32_t nb_rounds){
+
+    bench_task = (FBENCH_Task_t){
+        .pFormatter = pFormatter,
+        .nb_rounds = nb_rounds,
+        .caller_handle = xTaskGetCurrentTaskHandle(),
+        .hash = FBENCH_HASH_INIT,
+    };
+
+    if(pdPASS != xTaskCreatePinnedToCore(tBenchTask,
+                                         "Fmt bench",
+                                         FBENCH_STACK_SIZE,
+                                         &bench_task,
+                                         uxTaskPriorityGet(NULL),
+                                         NULL,
+                                         xPortGetCoreID())){
+
+        return false;
+    }
+
+    ulTaskNotifyTake(pdTRUE, portMAX_DELAY);
+    return true;
+}
+
+/******************************************************************************
+*   CallBack Functions implementation
+*******************************************************************************/
+
+
+/******************************************************************************
+*   Public Functions Definitions
+*******************************************************************************/
+/***************************************************************************//*!
+*  \brief Format benchmark.
+*
+*   This function is used to compare the FMT_xxx() functions with
+*   snprintf() on a status line (voltage, currents, temperature and fault
+*   flags): cycles per line and stack use. Each formatter runs in its own
+*   bench task, on the caller core, at the caller priority. The per call
+*   counters of the same formatters are in the kernel harness (fmt,
+*   snprintf kernels).
+*
+*   Preconditions: Called from a task.
+*
+*   Side Effects: Blocks the caller during the bench.
+*
+*   \param[in]  nb_rounds           Number of lines per formatter
+*                                   (1 -> FBENCH_MAX_ROUNDS).
+*   \param[out] pResult             Benchmark results.
+*
+*   \return     Operation status
+*
+*******************************************************************************/
+FBENCH_Ret_t FBENCH_Run(uint32_t nb_rounds, FBENCH_Result_t *pResult){
+
+    uint32_t base_stack;
+    uint32_t printf_hash;
+
+    if((pResult == NULL) || (nb_rounds == 0) || (nb_rounds > FBENCH_MAX_ROUNDS)){
+        return FBENCH_STATUS_ERROR;
+    }
+
+    *pResult = (FBENCH_Result_t){.nb_lines = nb_rounds};
+
+    //Bench task overhead
+    if(!runBench(benchNone, 1)) return FBENCH_STATUS_ERROR;
+    base_stack = bench_task.stack_used;
+
+    if(!runBench(benchPrintf, nb_rounds))   return FBENCH_STATUS_ERROR;
+    pResult->printf_avg_cycles = (uint32_t)(bench_task.total_cycles / nb_rounds);
+    pResult->printf_max_cycles = bench_task.max_cycles;
+    pResult->printf_stack = bench_task.stack_used - base_stack;
+    printf_hash = bench_task.hash;
+
+    if(!runBench(benchFmt, nb_rounds))  return FBENCH_STATUS_ERROR;
+    pResult->fmt_avg_cycles = (uint32_t)(bench_task.total_cycles / nb_rounds);
+    pResult->fmt_max_cycles = bench_task.max_cycles;
+    pResult->fmt_stack = bench_task.stack_used - base_stack;
+    pResult->line_len = bench_task.line_len;
+    pResult->is_match = (bench_task.hash == printf_hash);
+
+    return FBENCH_STATUS_OK;
+}
+
+/******************************************************************************
+*   Interrupts
+*******************************************************************************/
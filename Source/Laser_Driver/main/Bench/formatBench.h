@@ -0,0 +1,74 @@
+#ifndef __FORMAT_BENCH_H
+#define __FORMAT_BENCH_H
+
+#include <stdint.h>
+#include <stdbool.h>
+
+/******************************************************************************
+*   Public Definitions
+*******************************************************************************/
+#define FBENCH_MAX_ROUNDS                   (10000)
+
+
+/******************************************************************************
+*   Public Macros
+*******************************************************************************/
+
+
+/******************************************************************************
+*   Public Data Types
+*******************************************************************************/
+typedef struct FBENCH_Result_s{
+    uint32_t nb_lines;                  //Lines formatted per formatter
+    uint32_t line_len;                  //Status line length
+    bool is_match;                      //Both formatters wrote the same lines
+    uint32_t printf_avg_cycles;         //snprintf()
+    uint32_t printf_max_cycles;
+    uint32_t printf_stack;              //Stack bytes (bench task overhead removed)
+    uint32_t fmt_avg_cycles;            //FMT_xxx() functions
+    uint32_t fmt_max_cycles;
+    uint32_t fmt_stack;
+}FBENCH_Result_t;
+
+typedef enum FBENCH_Ret_e{
+    FBENCH_STATUS_ERROR,
+    FBENCH_STATUS_OK,
+}FBENCH_Ret_t;
+
+/******************************************************************************
+*   Public Variables
+*******************************************************************************/
+
+
+/******************************************************************************
+*   Error Check
+*******************************************************************************/
+
+
+/******************************************************************************
+*   Public Functions Declarations
+*******************************************************************************/
+/***************************************************************************//*!
+*  \brief Format benchmark.
+*
+*   This function is used to compare the FMT_xxx() functions with
+*   snprintf() on a status line (voltage, currents, temperature and fault
+*   flags): cycles per line and stack use. Each formatter runs in its own
+*   bench task, on the caller core, at the caller priority. The per call
+*   counters of the same formatters are in the kernel harness (fmt,
+*   snprintf kernels).
+*
+*   Preconditions: Called from a task.
+*
+*   Side Effects: Blocks the caller during the bench.
+*
+*   \param[in]  nb_rounds           Number of lines per formatter
+*                                   (1 -> FBENCH_MAX_ROUNDS).
+*   \param[out] pResult             Benchmark results.
+*
+*   \return     Operation status
+*
+*******************************************************************************/
+FBENCH_Ret_t FBENCH_Run(uint32_t nb_rounds, FBENCH_Result_t *pResult);
+
+#endif//__FORMAT_BENCH_H
@@ -0,0 +1,193 @@
+#include "freertos/FreeRTOS.h"
+#include "freertos/task.h"
+
+#include "esp_timer.h"
+#include "xtensa/config/core-isa.h"
+#include "xtensa/xt_perf_consts.h"
+#include "xtensa_perfmon_access.h"
+
+#include "benchmark_cfg.h"
+
+/******************************************************************************
+*   Private Definitions
+*******************************************************************************/
+#define BENCH_CFG_NB_PASSES                 (2)//Two hardware counters per pass
+#define BENCH_CFG_NB_PM                     (2)
+
+#define BENCH_CFG_PM_KERNEL_COUNT           (0)
+#define BENCH_CFG_PM_TRACE_LEVEL            (-1)//Every interrupt level (core interrupts counted)
+
+/******************************************************************************
+*   Private Macros
+*******************************************************************************/
+
+
+/******************************************************************************
+*   Private Data Types
+*******************************************************************************/
+typedef struct BENCH_CFG_Pm_Event_s{
+    uint16_t select;
+    uint16_t mask;
+}BENCH_CFG_Pm_Event_t;
+
+/******************************************************************************
+*   Private Functions Declaration
+*******************************************************************************/
+
+
+/******************************************************************************
+*   Public Variables
+*******************************************************************************/
+
+
+/******************************************************************************
+*   Private Variables
+*******************************************************************************/
+//Performance counter events of each pass (PM0, PM1)
+static const BENCH_CFG_Pm_Event_t pass_events[BENCH_CFG_NB_PASSES][BENCH_CFG_NB_PM] = {
+    {
+        {XTPERF_CNT_CYCLES,     XTPERF_MASK_CYCLES},
+        {XTPERF_CNT_INSN,       XTPERF_MASK_INSN_ALL},
+    },
+    {
+        {XTPERF_CNT_I_MEM,      XTPERF_MASK_I_MEM_CACHE_MISSES},//Uncached fetches included
+        {XTPERF_CNT_D_ACCESS_U1, XTPERF_MASK_D_ACCESS_CACHE_MISSES},
+    },
+};
+
+static int64_t pass_start_us = 0;
+
+/******************************************************************************
+*   Error Check
+*******************************************************************************/
+#if (XCHAL_NUM_PERF_COUNTERS < BENCH_CFG_NB_PM)
+#error "Not enough performance counters"
+#endif
+
+/******************************************************************************
+*   Private Functions Definitions
+*******************************************************************************/
+
+
+/******************************************************************************
+*   CallBack Functions implementation
+*******************************************************************************/
+
+
+/******************************************************************************
+*   Public Functions Definitions
+*******************************************************************************/
+/***************************************************************************//*!
+*  \brief Get counter mask.
+*
+*   This function return the counters measured on this platform
+*   (BENCH_CFG_COUNTER_xxx).
+*
+*   Preconditions: None.
+*
+*   Side Effects: None.
+*
+*   \return     Counter mask
+*
+*******************************************************************************/
+uint32_t BENCH_CFG_GetCounterMask(void){
+
+    return BENCH_CFG_COUNTER_TIME | BENCH_CFG_COUNTER_CYCLES | BENCH_CFG_COUNTER_INSTRUCTIONS |
+           BENCH_CFG_COUNTER_ICACHE_MISSES | BENCH_CFG_COUNTER_DCACHE_MISSES;
+}
+
+/***************************************************************************//*!
+*  \brief Get number of passes.
+*
+*   This function return the number of passes needed to read every counter
+*   (the hardware counts a few events at a time).
+*
+*   Preconditions: None.
+*
+*   Side Effects: None.
+*
+*   \return     Number of passes
+*
+*******************************************************************************/
+uint32_t BENCH_CFG_GetNbPasses(void){
+
+    return BENCH_CFG_NB_PASSES;
+}
+
+/***************************************************************************//*!
+*  \brief Start pass.
+*
+*   This function is used to clear and start the counters of a pass.
+*
+*   Preconditions: Called from a task pinned to a core (counters of one
+*   core).
+*
+*   Side Effects: None.
+*
+*   \param[in]  pass                Pass (0 -> BENCH_CFG_GetNbPasses()-1).
+*
+*   \return     Operation status
+*
+*******************************************************************************/
+BENCH_CFG_Ret_t BENCH_CFG_StartPass(uint32_t pass){
+
+    if(pass >= BENCH_CFG_NB_PASSES)  return BENCH_CFG_STATUS_ERROR;
+
+    //The performance counters are per core
+    if(xTaskGetCoreID(NULL) == tskNO_AFFINITY)  return BENCH_CFG_STATUS_ERROR;
+
+    xtensa_perfmon_stop();
+    for(uint32_t pm=0; pm<BENCH_CFG_NB_PM; pm++){
+        xtensa_perfmon_init(pm, pass_events[pass][pm].select, pass_events[pass][pm].mask,
+                            BENCH_CFG_PM_KERNEL_COUNT, BENCH_CFG_PM_TRACE_LEVEL);
+    }
+
+    pass_start_us = esp_timer_get_time();
+    xtensa_perfmon_start();
+
+    return BENCH_CFG_STATUS_OK;
+}
+
+/***************************************************************************//*!
+*  \brief Stop pass.
+*
+*   This function is used to stop the counters of a pass and store them in
+*   the results (counters of the other passes left untouched).
+*
+*   Preconditions: Pass started.
+*
+*   Side Effects: None.
+*
+*   \param[in]  pass                Pass.
+*   \param[out] pCounters           Counters.
+*
+*   \return     Operation status (error on a counter overflow)
+*
+*******************************************************************************/
+BENCH_CFG_Ret_t BENCH_CFG_StopPass(uint32_t pass, BENCH_CFG_Counters_t *pCounters){
+
+    xtensa_perfmon_stop();
+    int64_t elapsed_us = esp_timer_get_time() - pass_start_us;
+
+    if((pass >= BENCH_CFG_NB_PASSES) || (pCounters == NULL))  return BENCH_CFG_STATUS_ERROR;
+
+    //32 bits counters
+    for(uint32_t pm=0; pm<BENCH_CFG_NB_PM; pm++){
+        if(ESP_OK != xtensa_perfmon_overflow(pm))   return BENCH_CFG_STATUS_ERROR;
+    }
+
+    if(pass == 0){
+        pCounters->time_ns = (uint64_t)elapsed_us * 1000;
+        pCounters->cycles = xtensa_perfmon_value(0);
+        pCounters->instructions = xtensa_perfmon_value(1);
+    }else{
+        pCounters->icache_misses = xtensa_perfmon_value(0);
+        pCounters->dcache_misses = xtensa_perfmon_value(1);
+    }
+
+    return BENCH_CFG_STATUS_OK;
+}
+
+/******************************************************************************
+*   Interrupts
+*******************************************************************************/
@@ -0,0 +1,116 @@
+#ifndef __BENCHMARK_CFG_H
+#define __BENCHMARK_CFG_H
+
+#include <stdint.h>
+#include <stdbool.h>
+
+/******************************************************************************
+*   Public Definitions
+*******************************************************************************/
+//Counters (BENCH_CFG_GetCounterMask())
+#define BENCH_CFG_COUNTER_TIME              (1UL << 0)
+#define BENCH_CFG_COUNTER_CYCLES            (1UL << 1)
+#define BENCH_CFG_COUNTER_INSTRUCTIONS      (1UL << 2)
+#define BENCH_CFG_COUNTER_ICACHE_MISSES     (1UL << 3)
+#define BENCH_CFG_COUNTER_DCACHE_MISSES     (1UL << 4)
+
+/******************************************************************************
+*   Public Macros
+*******************************************************************************/
+
+
+/******************************************************************************
+*   Public Data Types
+*******************************************************************************/
+typedef struct BENCH_CFG_Counters_s{
+    uint64_t time_ns;
+    uint64_t cycles;
+    uint64_t instructions;
+    uint64_t icache_misses;
+    uint64_t dcache_misses;
+}BENCH_CFG_Counters_t;
+
+typedef enum BENCH_CFG_Ret_e{
+    BENCH_CFG_STATUS_ERROR,
+    BENCH_CFG_STATUS_OK,
+}BENCH_CFG_Ret_t;
+
+/******************************************************************************
+*   Public Variables
+*******************************************************************************/
+
+
+/******************************************************************************
+*   Error Check
+*******************************************************************************/
+
+
+/******************************************************************************
+*   Public Functions Declarations
+*******************************************************************************/
+/***************************************************************************//*!
+*  \brief Get counter mask.
+*
+*   This function return the counters measured on this platform
+*   (BENCH_CFG_COUNTER_xxx).
+*
+*   Preconditions: None.
+*
+*   Side Effects: None.
+*
+*   \return     Counter mask
+*
+*******************************************************************************/
+uint32_t BENCH_CFG_GetCounterMask(void);
+
+/***************************************************************************//*!
+*  \brief Get number of passes.
+*
+*   This function return the number of passes needed to read every counter
+*   (the hardware counts a few events at a time).
+*
+*   Preconditions: None.
+*
+*   Side Effects: None.
+*
+*   \return     Number of passes
+*
+*******************************************************************************/
+uint32_t BENCH_CFG_GetNbPasses(void);
+
+/***************************************************************************//*!
+*  \brief Start pass.
+*
+*   This function is used to clear and start the counters of a pass.
+*
+*   Preconditions: Called from a task pinned to a core (counters of one
+*   core).
+*
+*   Side Effects: None.
+*
+*   \param[in]  pass                Pass (0 -> BENCH_CFG_GetNbPasses()-1).
+*
+*   \return     Operation status
+*
+*******************************************************************************/
+BENCH_CFG_Ret_t BENCH_CFG_StartPass(uint32_t pass);
+
+/***************************************************************************//*!
+*  \brief Stop pass.
+*
+*   This function is used to stop the counters of a pass and store them in
+*   the results (counters of the other passes left untouched).
+*
+*   Preconditions: Pass started.
+*
+*   Side Effects: None.
+*
+*   \param[in]  pass                Pass.
+*   \param[out] pCounters           Counters.
+*
+*   \return     Operation status (error on a counter overflow)
+*
+*******************************************************************************/
+BENCH_CFG_Ret_t BENCH_CFG_StopPass(uint32_t pass, BENCH_CFG_Counters_t *pCounters);
+
+#endif//__BENCHMARK_CFG_H
@@ -0,0 +1,98 @@
+#include <time.h>
+
+#include "benchmark_cfg.h"
+
+/******************************************************************************
+*   Private Definitions
+*******************************************************************************/
+#define SIM_BENCH_NB_PASSES                 (1)
+
+/******************************************************************************
+*   Private Macros
+*******************************************************************************/
+
+
+/******************************************************************************
+*   Private Data Types
+*******************************************************************************/
+
+
+/******************************************************************************
+*   Private Functions Declaration
+*******************************************************************************/
+static uint64_t getTimeNs(void);
+
+/******************************************************************************
+*   Public Variables
+*******************************************************************************/
+
+
+/******************************************************************************
+*   Private Variables
+*******************************************************************************/
+static uint64_t pass_start_ns = 0;
+
+/******************************************************************************
+*   Error Check
+*******************************************************************************/
+
+
+/******************************************************************************
+*   Private Functions Definitions
+*******************************************************************************/
+/***************************************************************************//*!
+*  \brief Get time.
+*
+*   This function return the host monotonic clock (wall clock, no CPU
+*   counters on the host).
+*
+*******************************************************************************/
+static uint64_t getTimeNs(void){
+
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+
+    return ((uint64_t)ts.tv_sec * 1000000000ULL) + (uint64_t)ts.tv_nsec;
+}
+
+/******************************************************************************
+*   CallBack Functions implementation
+*******************************************************************************/
+
+
+/******************************************************************************
+*   Public Functions Definitions
+*******************************************************************************/
+uint32_t BENCH_CFG_GetCounterMask(void){
+
+    return BENCH_CFG_COUNTER_TIME;
+}
+
+uint32_t BENCH_CFG_GetNbPasses(void){
+
+    return SIM_BENCH_NB_PASSES;
+}
+
+BENCH_CFG_Ret_t BENCH_CFG_StartPass(uint32_t pass){
+
+    if(pass >= SIM_BENCH_NB_PASSES)  return BENCH_CFG_STATUS_ERROR;
+
+    pass_start_ns = getTimeNs();
+
+    return BENCH_CFG_STATUS_OK;
+}
+
+BENCH_CFG_Ret_t BENCH_CFG_StopPass(uint32_t pass, BENCH_CFG_Counters_t *pCounters){
+
+    uint64_t elapsed_ns = getTimeNs() - pass_start_ns;
+
+    if((pass >= SIM_BENCH_NB_PASSES) || (pCounters == NULL))  return BENCH_CFG_STATUS_ERROR;
+
+    pCounters->time_ns = elapsed_ns;
+
+    return BENCH_CFG_STATUS_OK;
+}
+
+/******************************************************************************
+*   Interrupts
+*******************************************************************************/
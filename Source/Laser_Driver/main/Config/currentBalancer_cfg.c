@@ -0,0 +1,242 @@
+#include "freertos/FreeRTOS.h"
+
+#include "esp_timer.h"
+#include "esp_log.h"
+
+#include "temperatureMonitoring.h"
+#include "currentRegulator.h"
+#include "currentBalancer_cfg.h"
+
+/******************************************************************************
+*   Private Definitions
+*******************************************************************************/
+#define LOG_LOCAL_LEVEL                     (ESP_LOG_INFO)
+
+/******************************************************************************
+*   Private Macros
+*******************************************************************************/
+#define IS_TEMP_VALID(temp)                 (((temp) != (int16_t)TEMP_ERROR_INVALID) && \
+                                             ((temp) != (int16_t)TEMP_ERROR_SHORT) && \
+                                             ((temp) != (int16_t)TEMP_ERROR_OPEN))
+
+/******************************************************************************
+*   Private Data Types
+*******************************************************************************/
+
+
+/******************************************************************************
+*   Private Functions Declaration
+*******************************************************************************/
+static void periodicTimerCallback(void *arg);
+
+/******************************************************************************
+*   Public Variables
+*******************************************************************************/
+
+
+/******************************************************************************
+*   Private Variables
+*******************************************************************************/
+static esp_timer_handle_t periodic_timer_handle = NULL;
+static CBAL_CFG_PeriodicCallback_t periodic_callback = NULL;
+
+static const TEMP_Sensor_Id_t phase_sensor_ids[CBAL_CFG_NB_PHASE] = {
+    TEMP_SENSOR_ID_PHASE_A,
+    TEMP_SENSOR_ID_PHASE_B,
+};
+
+static const CREG_Phase_t phase_ids[CBAL_CFG_NB_PHASE] = {
+    CREG_PHASE_A,
+    CREG_PHASE_B,
+};
+
+static const char * TAG = "CBAL CFG";
+
+/******************************************************************************
+*   Error Check
+*******************************************************************************/
+
+
+/******************************************************************************
+*   Private Functions Definitions
+*******************************************************************************/
+
+
+/******************************************************************************
+*   CallBack Functions implementation
+*******************************************************************************/
+/***************************************************************************//*!
+*  \brief Periodic timer callback.
+*
+*   This function is called by the esp_timer task every balancing period.
+*
+*******************************************************************************/
+static void periodicTimerCallback(void *arg){
+
+    CBAL_CFG_PeriodicCallback_t callback = periodic_callback;
+
+    if(callback != NULL)    callback();
+}
+
+/******************************************************************************
+*   Public Functions Definitions
+*******************************************************************************/
+/***************************************************************************//*!
+*  \brief Init current balancer hardware.
+*
+*   This function is used to initialize the resources used by the current
+*   balancer (periodic timer).
+*
+*   Preconditions: None.
+*
+*   Side Effects: None.
+*
+*   \return     Operation status
+*
+*******************************************************************************/
+CBAL_CFG_Ret_t CBAL_CFG_InitHardware(void){
+
+    const esp_timer_create_args_t timer_args = {
+        .callback = periodicTimerCallback,
+        .arg = NULL,
+        .dispatch_method = ESP_TIMER_TASK,
+        .name = "CBAL",
+    };
+
+    if(ESP_OK != esp_timer_create(&timer_args, &periodic_timer_handle)){
+        ESP_LOGE(TAG, "Failed to create balancing timer");
+        return CBAL_CFG_STATUS_ERROR;
+    }
+
+    return CBAL_CFG_STATUS_OK;
+}
+
+/***************************************************************************//*!
+*  \brief Start balancing periodic call.
+*
+*   This function is used to call the callback every period_ms (from a
+*   task context, the callback can block).
+*
+*   Preconditions: Hardware initialized.
+*
+*   Side Effects: None.
+*
+*   \param[in]  period_ms           Period.
+*   \param[in]  callback            Periodic callback.
+*
+*   \return     Operation status
+*
+*******************************************************************************/
+CBAL_CFG_Ret_t CBAL_CFG_StartPeriodic(uint32_t period_ms, CBAL_CFG_PeriodicCallback_t callback){
+
+    if((callback == NULL) || (period_ms == 0) || (periodic_timer_handle == NULL)){
+        return CBAL_CFG_STATUS_ERROR;
+    }
+
+    periodic_callback = callback;
+
+    if(ESP_OK != esp_timer_start_periodic(periodic_timer_handle, (uint64_t)period_ms * 1000)){
+        periodic_callback = NULL;
+        ESP_LOGE(TAG, "Failed to start balancing timer");
+        return CBAL_CFG_STATUS_ERROR;
+    }
+
+    return CBAL_CFG_STATUS_OK;
+}
+
+/***************************************************************************//*!
+*  \brief Stop balancing periodic call.
+*
+*   This function is used to stop the periodic callback.
+*
+*   Preconditions: Hardware initialized.
+*
+*   Side Effects: None.
+*
+*   \return     Operation status
+*
+*******************************************************************************/
+CBAL_CFG_Ret_t CBAL_CFG_StopPeriodic(void){
+
+    if(periodic_timer_handle == NULL)   return CBAL_CFG_STATUS_ERROR;
+
+    periodic_callback = NULL;
+
+    //Not running -> ESP_ERR_INVALID_STATE (nothing to stop)
+    esp_timer_stop(periodic_timer_handle);
+
+    return CBAL_CFG_STATUS_OK;
+}
+
+/***************************************************************************//*!
+*  \brief Read phase measurements.
+*
+*   This function is used to read the latest temperature and current
+*   regulation state of a phase.
+*
+*   Preconditions: Hardware initialized.
+*
+*   Side Effects: None.
+*
+*   \param[in]  phase               Phase index.
+*   \param[out] pMeas               Pointer to store the phase measurements.
+*
+*   \return     Operation status (error if the temperature is not valid)
+*
+*******************************************************************************/
+CBAL_CFG_Ret_t CBAL_CFG_ReadPhase(uint8_t phase, CBAL_CFG_Phase_Meas_t *pMeas){
+
+    CREG_Phase_Status_t status;
+    int16_t temperature = TEMP_ERROR_INVALID;
+
+    if((phase >= CBAL_CFG_NB_PHASE) || (pMeas == NULL)){
+        return CBAL_CFG_STATUS_ERROR;
+    }
+
+    if(TEMP_STATUS_OK != TEMP_GetTemperature(phase_sensor_ids[phase], &temperature)){
+        return CBAL_CFG_STATUS_ERROR;
+    }
+
+    if(!IS_TEMP_VALID(temperature)) return CBAL_CFG_STATUS_ERROR;
+
+    if(CREG_STATUS_OK != CREG_GetPhaseStatus(phase_ids[phase], &status)){
+        return CBAL_CFG_STATUS_ERROR;
+    }
+
+    pMeas->temperature = temperature;
+    pMeas->current_10ma = status.current_10ma;
+    pMeas->setpoint_10ma = status.target_10ma;
+    pMeas->saturated = status.saturated;
+
+    return CBAL_CFG_STATUS_OK;
+}
+
+/***************************************************************************//*!
+*  \brief Set phase setpoint.
+*
+*   This function is used to send a current setpoint to a phase regulator.
+*
+*   Preconditions: Hardware initialized.
+*
+*   Side Effects: None.
+*
+*   \param[in]  phase               Phase index.
+*   \param[in]  setpoint_10ma       Current setpoint.
+*
+*   \return     Operation status
+*
+*******************************************************************************/
+CBAL_CFG_Ret_t CBAL_CFG_SetPhaseSetpoint(uint8_t phase, int16_t setpoint_10ma){
+
+    if(phase >= CBAL_CFG_NB_PHASE)  return CBAL_CFG_STATUS_ERROR;
+
+    if(CREG_STATUS_OK != CREG_SetSetpoint(phase_ids[phase], setpoint_10ma)){
+        return CBAL_CFG_STATUS_ERROR;
+    }
+
+    return CBAL_CFG_STATUS_OK;
+}
+
+/******************************************************************************
+*   Interrupts
+*******************************************************************************/
@@ -0,0 +1,127 @@
+#ifndef __CURRENT_BALANCER_CFG_H
+#define __CURRENT_BALANCER_CFG_H
+
+#include <stdint.h>
+#include <stdbool.h>
+
+/******************************************************************************
+*   Public Definitions
+*******************************************************************************/
+#define CBAL_CFG_NB_PHASE                   (2)
+
+/******************************************************************************
+*   Public Macros
+*******************************************************************************/
+typedef void(*CBAL_CFG_PeriodicCallback_t)(void);
+
+/******************************************************************************
+*   Public Data Types
+*******************************************************************************/
+typedef struct CBAL_CFG_Phase_Meas_s{
+    int16_t temperature;                //Phase temperature (0.01C)
+    int16_t current_10ma;               //Measured phase current
+    int16_t setpoint_10ma;              //Regulator setpoint
+    bool saturated;                     //Regulator output saturated
+}CBAL_CFG_Phase_Meas_t;
+
+typedef enum CBAL_CFG_Ret_e{
+    CBAL_CFG_STATUS_ERROR,
+    CBAL_CFG_STATUS_OK,
+}CBAL_CFG_Ret_t;
+
+/******************************************************************************
+*   Public Variables
+*******************************************************************************/
+
+
+/******************************************************************************
+*   Error Check
+*******************************************************************************/
+
+
+/******************************************************************************
+*   Public Functions Declarations
+*******************************************************************************/
+/***************************************************************************//*!
+*  \brief Init current balancer hardware.
+*
+*   This function is used to initialize the resources used by the current
+*   balancer (periodic timer).
+*
+*   Preconditions: None.
+*
+*   Side Effects: None.
+*
+*   \return     Operation status
+*
+*******************************************************************************/
+CBAL_CFG_Ret_t CBAL_CFG_InitHardware(void);
+
+/***************************************************************************//*!
+*  \brief Start balancing periodic call.
+*
+*   This function is used to call the callback every period_ms (from a
+*   task context, the callback can block).
+*
+*   Preconditions: Hardware initialized.
+*
+*   Side Effects: None.
+*
+*   \param[in]  period_ms           Period.
+*   \param[in]  callback            Periodic callback.
+*
+*   \return     Operation status
+*
+*******************************************************************************/
+CBAL_CFG_Ret_t CBAL_CFG_StartPeriodic(uint32_t period_ms, CBAL_CFG_PeriodicCallback_t callback);
+
+/***************************************************************************//*!
+*  \brief Stop balancing periodic call.
+*
+*   This function is used to stop the periodic callback.
+*
+*   Preconditions: Hardware initialized.
+*
+*   Side Effects: None.
+*
+*   \return     Operation status
+*
+*******************************************************************************/
+CBAL_CFG_Ret_t CBAL_CFG_StopPeriodic(void);
+
+/***************************************************************************//*!
+*  \brief Read phase measurements.
+*
+*   This function is used to read the latest temperature and current
+*   regulation state of a phase.
+*
+*   Preconditions: Hardware initialized.
+*
+*   Side Effects: None.
+*
+*   \param[in]  phase               Phase index.
+*   \param[out] pMeas               Pointer to store the phase measurements.
+*
+*   \return     Operation status (error if the temperature is not valid)
+*
+*******************************************************************************/
+CBAL_CFG_Ret_t CBAL_CFG_ReadPhase(uint8_t phase, CBAL_CFG_Phase_Meas_t *pMeas);
+
+/***************************************************************************//*!
+*  \brief Set phase setpoint.
+*
+*   This function is used to send a current setpoint to a phase regulator.
+*
+*   Preconditions: Hardware initialized.
+*
+*   Side Effects: None.
+*
+*   \param[in]  phase               Phase index.
+*   \param[in]  setpoint_10ma       Current setpoint.
+*
+*   \return     Operation status
+*
+*******************************************************************************/
+CBAL_CFG_Ret_t CBAL_CFG_SetPhaseSetpoint(uint8_t phase, int16_t setpoint_10ma);
+
+#endif//__CURRENT_BALANCER_CFG_H
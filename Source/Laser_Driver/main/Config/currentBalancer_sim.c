@@ -0,0 +1,170 @@
+#include "esp_log.h"
+
+#include "currentRegulator.h"
+#include "currentRegulator_sim.h"
+#include "currentBalancer_cfg.h"
+#include "currentBalancer_sim.h"
+
+/******************************************************************************
+*   Private Definitions
+*******************************************************************************/
+#define LOG_LOCAL_LEVEL                     (ESP_LOG_INFO)
+
+/******************************************************************************
+*   Private Macros
+*******************************************************************************/
+
+
+/******************************************************************************
+*   Private Data Types
+*******************************************************************************/
+
+
+/******************************************************************************
+*   Private Functions Declaration
+*******************************************************************************/
+
+
+/******************************************************************************
+*   Public Variables
+*******************************************************************************/
+
+
+/******************************************************************************
+*   Private Variables
+*******************************************************************************/
+static uint32_t balancing_period_ms = 0;
+static CBAL_CFG_PeriodicCallback_t periodic_callback = NULL;
+
+static const CREG_Phase_t phase_ids[CBAL_CFG_NB_PHASE] = {
+    CREG_PHASE_A,
+    CREG_PHASE_B,
+};
+
+static const char * TAG = "CBAL SIM";
+
+/******************************************************************************
+*   Error Check
+*******************************************************************************/
+
+
+/******************************************************************************
+*   Private Functions Definitions
+*******************************************************************************/
+
+
+/******************************************************************************
+*   CallBack Functions implementation
+*******************************************************************************/
+
+
+/******************************************************************************
+*   Public Functions Definitions
+*******************************************************************************/
+//Simulated implementation of the currentBalancer_cfg.h interface
+CBAL_CFG_Ret_t CBAL_CFG_InitHardware(void){
+
+    ESP_LOGI(TAG, "Using simulated phase temperatures");
+
+    periodic_callback = NULL;
+    balancing_period_ms = 0;
+
+    return CBAL_CFG_STATUS_OK;
+}
+
+CBAL_CFG_Ret_t CBAL_CFG_StartPeriodic(uint32_t period_ms, CBAL_CFG_PeriodicCallback_t callback){
+
+    if((callback == NULL) || (period_ms == 0)){
+        return CBAL_CFG_STATUS_ERROR;
+    }
+
+    //No timer: the balancing is run by CBAL_SIM_Advance()
+    balancing_period_ms = period_ms;
+    periodic_callback = callback;
+
+    return CBAL_CFG_STATUS_OK;
+}
+
+CBAL_CFG_Ret_t CBAL_CFG_StopPeriodic(void){
+
+    periodic_callback = NULL;
+
+    return CBAL_CFG_STATUS_OK;
+}
+
+CBAL_CFG_Ret_t CBAL_CFG_ReadPhase(uint8_t phase, CBAL_CFG_Phase_Meas_t *pMeas){
+
+    CREG_SIM_Plant_State_t state;
+    CREG_Phase_Status_t status;
+
+    if((phase >= CBAL_CFG_NB_PHASE) || (pMeas == NULL)){
+        return CBAL_CFG_STATUS_ERROR;
+    }
+
+    if((CREG_CFG_STATUS_OK != CREG_SIM_GetPlantState(phase, &state)) ||
+       (CREG_STATUS_OK != CREG_GetPhaseStatus(phase_ids[phase], &status))){
+        return CBAL_CFG_STATUS_ERROR;
+    }
+
+    //Phase temperature sensor is on the phase heatsink
+    pMeas->temperature = state.heatsink_temperature;
+    pMeas->current_10ma = status.current_10ma;
+    pMeas->setpoint_10ma = status.target_10ma;
+    pMeas->saturated = status.saturated;
+
+    return CBAL_CFG_STATUS_OK;
+}
+
+CBAL_CFG_Ret_t CBAL_CFG_SetPhaseSetpoint(uint8_t phase, int16_t setpoint_10ma){
+
+    if(phase >= CBAL_CFG_NB_PHASE)  return CBAL_CFG_STATUS_ERROR;
+
+    if(CREG_STATUS_OK != CREG_SetSetpoint(phase_ids[phase], setpoint_10ma)){
+        return CBAL_CFG_STATUS_ERROR;
+    }
+
+    return CBAL_CFG_STATUS_OK;
+}
+
+/***************************************************************************//*!
+*  \brief Advance balancing simulation.
+*
+*   This function is used to advance the simulation by the specified number
+*   of balancing periods. The regulation loop (and the plant) is advanced
+*   over each balancing period then the balancing callback is executed.
+*
+*   Preconditions: Regulator and balancer started.
+*
+*   Side Effects: None.
+*
+*   \param[in]  nb_periods          Number of balancing periods to simulate.
+*
+*   \return     Operation status
+*
+*******************************************************************************/
+CBAL_CFG_Ret_t CBAL_SIM_Advance(uint32_t nb_periods){
+
+    CREG_Loop_Stats_t stats;
+
+    if((periodic_callback == NULL) || (balancing_period_ms == 0)){
+        return CBAL_CFG_STATUS_ERROR;
+    }
+
+    if(CREG_STATUS_OK != CREG_GetLoopStats(&stats)){
+        return CBAL_CFG_STATUS_ERROR;
+    }
+
+    uint32_t nb_loops = (stats.rate_hz * balancing_period_ms) / 1000;
+    for(uint32_t i=0; i<nb_periods; i++){
+        if(CREG_CFG_STATUS_OK != CREG_SIM_Advance(nb_loops)){
+            return CBAL_CFG_STATUS_ERROR;
+        }
+        periodic_callback();
+    }
+
+    return CBAL_CFG_STATUS_OK;
+}
+
+/******************************************************************************
+*   Interrupts
+*******************************************************************************/
@@ -1,8 +1,10 @@
-#ifndef __SHELL_COM_UART_H
-#define __SHELL_COM_UART_H
+#ifndef __CURRENT_BALANCER_SIM_H
+#define __CURRENT_BALANCER_SIM_H
 
 #include <stdint.h>
-#include "driver/uart.h"
+#include <stdbool.h>
+
+#include "currentBalancer_cfg.h"
 
 /******************************************************************************
 *   Public Definitions
@@ -17,17 +19,7 @@
 /******************************************************************************
 *   Public Data Types
 *******************************************************************************/
-typedef struct SHCOM_Config_s{
-    uint8_t tx_gpio;
-    uint8_t rx_gpio;
-    uint32_t baudrate;
-    uart_port_t port;
-}SHCOM_Config_t;
 
-typedef enum SHCOM_Ret_e{
-    SHCOM_STATUS_ERROR,
-    SHCOM_STATUS_OK,
-}SHCOM_Ret_t;
 
 /******************************************************************************
 *   Public Variables
@@ -43,32 +35,21 @@ typedef enum SHCOM_Ret_e{
 *   Public Functions Declarations
 *******************************************************************************/
 /***************************************************************************//*!
-*  \brief Shell communication peripheral initialization.
-*
-*   This function is use to initialize required peripherals for the Shell
-*   communication.
-*
-*   Preconditions:  None.
-*
-*	\param[in]  pConfig     Pointer to com config.
+*  \brief Advance balancing simulation.
 *
-*	\return		Operation status.
-*
-*******************************************************************************/
-SHCOM_Ret_t SHCOM_InitCom(SHCOM_Config_t *pConfig);
-
-/***************************************************************************//*!
-*  \brief Shell communication print character.
+*   This function is used to advance the simulation by the specified number
+*   of balancing periods. The regulation loop (and the plant) is advanced
+*   over each balancing period then the balancing callback is executed.
 *
-*   This function is use by the shell to print character out.
+*   Preconditions: Regulator and balancer started.
 *
-*   Preconditions:  None.
+*   Side Effects: None.
 *
-*	\param[in]  c                   Character to print.
+*   \param[in]  nb_periods          Number of balancing periods to simulate.
 *
-*	\return		Operation status.
+*   \return     Operation status
 *
 *******************************************************************************/
-SHCOM_Ret_t SHCOM_PrintCharacter(char c);
+CBAL_CFG_Ret_t CBAL_SIM_Advance(uint32_t nb_periods);
 
-#endif//__SHELL_COM_UART_H
\ No newline at end of file
+#endif//__CURRENT_BALANCER_SIM_H
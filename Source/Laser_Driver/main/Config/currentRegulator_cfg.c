@@ -0,0 +1,462 @@
+#include "freertos/FreeRTOS.h"
+
+#include "driver/gptimer.h"
+#include "esp_cpu.h"
+#include "esp_private/esp_clk.h"
+#include "esp_log.h"
+
+#include "taskPriority.h"
+#include "coreAffinity.h"
+#include "adcController.h"
+#include "phaseDriver.h"
+#include "currentRegulator_cfg.h"
+
+/******************************************************************************
+*   Private Definitions
+*******************************************************************************/
+#define LOOP_TIMER_RESOLUTION_HZ            (1000000)//1MHz -> 1us per tick
+
+//Phase current sense (raw 12bits ADC @12dB -> 10mA, scale in currentRegulator_cfg.h)
+#define CURRENT_SENSE_ATTEN                 (ADC_CTRL_ATTEN_12DB)
+
+#define LOG_LOCAL_LEVEL                     (ESP_LOG_INFO)
+
+/******************************************************************************
+*   Private Macros
+*******************************************************************************/
+#define RAW_TO_10MA(raw)                    ((int16_t)(((uint32_t)(raw) * CREG_CFG_SENSE_FULL_SCALE_10MA) / CREG_CFG_SENSE_FULL_SCALE_RAW))
+
+/******************************************************************************
+*   Private Data Types
+*******************************************************************************/
+
+
+/******************************************************************************
+*   Private Functions Declaration
+*******************************************************************************/
+static bool loopTimerCallback(gptimer_handle_t timer,
+                              const gptimer_alarm_event_data_t *edata,
+                              void *user_ctx);
+static void phaseSampleCallback(uint8_t phase_id);
+static esp_err_t initHardware(void *pArg);
+
+/******************************************************************************
+*   Public Variables
+*******************************************************************************/
+
+
+/******************************************************************************
+*   Private Variables
+*******************************************************************************/
+static gptimer_handle_t loop_timer_handle = NULL;
+static volatile CREG_CFG_LoopCallback_t loop_callback = NULL;
+static bool is_timer_running = false;
+
+//Latest phase current samples (taken in the middle of each phase on-time)
+static volatile uint16_t phase_current_raw[CREG_CFG_NB_PHASE];
+static volatile bool is_sample_ready[CREG_CFG_NB_PHASE];
+
+static const ADC_Ctrl_Channel_t phase_current_channels[CREG_CFG_NB_PHASE] = {
+    ADC_CTRL_CHANNEL_I_pA,
+    ADC_CTRL_CHANNEL_I_pB,
+};
+
+static const PHASE_Id_t phase_ids[CREG_CFG_NB_PHASE] = {
+    PHASE_ID_A,
+    PHASE_ID_B,
+};
+
+static const char * TAG = "CREG CFG";
+
+/******************************************************************************
+*   Error Check
+*******************************************************************************/
+#if (CREG_CFG_MAX_DUTY != PHASE_DUTY_FULL_SCALE)
+#error "Current regulator duty scale must match the phase driver duty scale"
+#endif
+
+/******************************************************************************
+*   Private Functions Definitions
+*******************************************************************************/
+/***************************************************************************//*!
+*  \brief Init hardware.
+*
+*   This function initializes the phase outputs, the loop timer and the
+*   current sampling, their interrupts are allocated on the calling core.
+*
+*   Preconditions: None.
+*
+*   Side Effects: None.
+*
+*   \param[in]  pArg                Unused.
+*
+*   \return     ESP status
+*
+*******************************************************************************/
+static esp_err_t initHardware(void *pArg){
+
+    //Init phase outputs
+    if(PHASE_STATUS_OK != PHASE_InitDriver()){
+        ESP_LOGE(TAG, "Failed to init phase driver");
+        return ESP_FAIL;
+    }
+
+    //Init loop timer
+    gptimer_config_t timer_config = {
+        .clk_src = GPTIMER_CLK_SRC_DEFAULT,
+        .direction = GPTIMER_COUNT_UP,
+        .resolution_hz = LOOP_TIMER_RESOLUTION_HZ,
+    };
+    if(ESP_OK != gptimer_new_timer(&timer_config, &loop_timer_handle)){
+        ESP_LOGE(TAG, "Failed to create loop timer");
+        return ESP_FAIL;
+    }
+
+    gptimer_event_callbacks_t timer_cbs = {
+        .on_alarm = loopTimerCallback,
+    };
+    if(ESP_OK != gptimer_register_event_callbacks(loop_timer_handle, &timer_cbs, NULL)){
+        ESP_LOGE(TAG, "Failed to register loop timer callback");
+        return ESP_FAIL;
+    }
+
+    is_timer_running = false;
+
+    if(PHASE_STATUS_OK != PHASE_RegisterSampleCallback(phaseSampleCallback)){
+        ESP_LOGE(TAG, "Failed to register phase sample callback");
+        return ESP_FAIL;
+    }
+
+    return ESP_OK;
+}
+
+/******************************************************************************
+*   CallBack Functions implementation
+*******************************************************************************/
+/***************************************************************************//*!
+*  \brief Loop timer callback.
+*
+*   This function is called from the loop timer alarm interrupt and
+*   execute the regulation loop callback.
+*
+*******************************************************************************/
+static bool IRAM_ATTR loopTimerCallback(gptimer_handle_t timer,
+                                        const gptimer_alarm_event_data_t *edata,
+                                        void *user_ctx){
+
+    CREG_CFG_LoopCallback_t callback = loop_callback;
+    if(callback != NULL){
+        callback();
+    }
+
+    return false;//No task woken
+}
+
+/***************************************************************************//*!
+*  \brief Phase sample callback.
+*
+*   This function is called from the MCPWM interrupt in the middle of a
+*   phase on-time (requested by the loop) and sample the phase current.
+*   Sampling both phases at their own on-time keeps the measurement
+*   consistent whatever the phase shift.
+*
+*******************************************************************************/
+static void IRAM_ATTR phaseSampleCallback(uint8_t phase_id){
+
+    uint16_t raw = 0;
+
+    for(uint8_t i=0; i<CREG_CFG_NB_PHASE; i++){
+        if(phase_ids[i] == phase_id){
+            if(ADC_CTRL_STATUS_SUCCESS == ADC_StartTimeCriticalSampling(phase_current_channels[i], 1, &raw)){
+                phase_current_raw[i] = raw;
+                is_sample_ready[i] = true;
+            }
+            break;
+        }
+    }
+}
+
+/******************************************************************************
+*   Public Functions Definitions
+*******************************************************************************/
+/***************************************************************************//*!
+*  \brief Init current regulator hardware.
+*
+*   This function is used to initialize the hardware used by the current
+*   regulator (loop timer, current sampling and phase outputs), with
+*   their interrupts on the control core (CONTROL_ISR_CORE).
+*
+*   Preconditions: None.
+*
+*   Side Effects: None.
+*
+*   \return     Operation status
+*
+*******************************************************************************/
+CREG_CFG_Ret_t CREG_CFG_InitHardware(void){
+
+    //Loop timer and phase interrupts on the control core
+    if(ESP_OK != CORE_RunOnCore(CONTROL_ISR_CORE, initHardware, NULL)){
+        return CREG_CFG_STATUS_ERROR;
+    }
+
+    return CREG_CFG_STATUS_OK;
+}
+
+/***************************************************************************//*!
+*  \brief Start regulation loop timer.
+*
+*   This function is used to start the periodic loop timer. The callback
+*   is called from the timer interrupt at the specified rate. The phase
+*   current channels are reserved for time critical sampling while the
+*   loop is running.
+*
+*   Preconditions: Hardware initialized.
+*
+*   Side Effects: ADC controller unavailable until the timer is stopped.
+*
+*   \param[in]  rate_hz             Loop rate.
+*   \param[in]  callback            Loop callback.
+*
+*   \return     Operation status
+*
+*******************************************************************************/
+CREG_CFG_Ret_t CREG_CFG_StartLoopTimer(uint32_t rate_hz, CREG_CFG_LoopCallback_t callback){
+
+    if((loop_timer_handle == NULL) || (callback == NULL) || (rate_hz == 0) || is_timer_running){
+        return CREG_CFG_STATUS_ERROR;
+    }
+
+    //Reserve the ADC for the phase currents
+    if(ADC_CTRL_STATUS_SUCCESS != ADC_SetupTimeCriticalGroup(ADC_CTRL_CHANNEL_I_pA_MASK | ADC_CTRL_CHANNEL_I_pB_MASK,
+                                                              CURRENT_SENSE_ATTEN)){
+        ESP_LOGE(TAG, "Failed to setup phase current sampling");
+        return CREG_CFG_STATUS_ERROR;
+    }
+
+    gptimer_alarm_config_t alarm_config = {
+        .reload_count = 0,
+        .alarm_count = LOOP_TIMER_RESOLUTION_HZ / rate_hz,
+        .flags.auto_reload_on_alarm = true,
+    };
+    loop_callback = callback;
+    for(uint8_t i=0; i<CREG_CFG_NB_PHASE; i++){
+        is_sample_ready[i] = false;
+        PHASE_TriggerSample(phase_ids[i]);
+    }
+
+    if((ESP_OK != gptimer_set_alarm_action(loop_timer_handle, &alarm_config)) ||
+       (ESP_OK != gptimer_set_raw_count(loop_timer_handle, 0)) ||
+       (ESP_OK != gptimer_enable(loop_timer_handle))){
+        loop_callback = NULL;
+        ADC_ReleaseAdcFromCriticalGroup(ADC_CTRL_CHANNEL_I_pA_MASK | ADC_CTRL_CHANNEL_I_pB_MASK);
+        ESP_LOGE(TAG, "Failed to setup loop timer");
+        return CREG_CFG_STATUS_ERROR;
+    }
+
+    if(ESP_OK != gptimer_start(loop_timer_handle)){
+        gptimer_disable(loop_timer_handle);
+        loop_callback = NULL;
+        ADC_ReleaseAdcFromCriticalGroup(ADC_CTRL_CHANNEL_I_pA_MASK | ADC_CTRL_CHANNEL_I_pB_MASK);
+        ESP_LOGE(TAG, "Failed to start loop timer");
+        return CREG_CFG_STATUS_ERROR;
+    }
+    is_timer_running = true;
+
+    return CREG_CFG_STATUS_OK;
+}
+
+/***************************************************************************//*!
+*  \brief Stop regulation loop timer.
+*
+*   This function is used to stop the periodic loop timer and release
+*   the phase current channels.
+*
+*   Preconditions: Hardware initialized.
+*
+*   Side Effects: None.
+*
+*   \return     Operation status
+*
+*******************************************************************************/
+CREG_CFG_Ret_t CREG_CFG_StopLoopTimer(void){
+
+    if(!is_timer_running){
+        //Nothing to do
+        return CREG_CFG_STATUS_OK;
+    }
+
+    if((ESP_OK != gptimer_stop(loop_timer_handle)) ||
+       (ESP_OK != gptimer_disable(loop_timer_handle))){
+        ESP_LOGE(TAG, "Failed to stop loop timer");
+        return CREG_CFG_STATUS_ERROR;
+    }
+    is_timer_running = false;
+    loop_callback = NULL;
+
+    if(ADC_CTRL_STATUS_SUCCESS != ADC_ReleaseAdcFromCriticalGroup(ADC_CTRL_CHANNEL_I_pA_MASK | ADC_CTRL_CHANNEL_I_pB_MASK)){
+        ESP_LOGE(TAG, "Failed to release phase current sampling");
+        return CREG_CFG_STATUS_ERROR;
+    }
+
+    return CREG_CFG_STATUS_OK;
+}
+
+/***************************************************************************//*!
+*  \brief Read phase current.
+*
+*   This function is used to read the latest current sample of a phase
+*   (taken in the middle of the phase on-time) and request the next one.
+*   In 10mA (5A -> 500). Called from the loop interrupt.
+*
+*   Preconditions: Loop timer started.
+*
+*   Side Effects: None.
+*
+*   \param[in]  phase               Phase index.
+*   \param[out] pCurrent_10ma       Pointer to store the current.
+*
+*   \return     Operation status (error if no new sample)
+*
+*******************************************************************************/
+CREG_CFG_Ret_t IRAM_ATTR CREG_CFG_ReadPhaseCurrent(uint8_t phase, int16_t *pCurrent_10ma){
+
+    if(phase >= CREG_CFG_NB_PHASE)  return CREG_CFG_STATUS_ERROR;
+
+    bool is_ready = is_sample_ready[phase];
+    uint16_t raw = phase_current_raw[phase];
+
+    //Request next sample
+    is_sample_ready[phase] = false;
+    PHASE_TriggerSample(phase_ids[phase]);
+
+    if(!is_ready)   return CREG_CFG_STATUS_ERROR;
+
+    *pCurrent_10ma = RAW_TO_10MA(raw);
+
+    return CREG_CFG_STATUS_OK;
+}
+
+/***************************************************************************//*!
+*  \brief Set phase duty.
+*
+*   This function is used to apply a duty-cycle to a phase output
+*   (0 -> CREG_CFG_MAX_DUTY). Called from the loop interrupt.
+*
+*   Preconditions: Hardware initialized.
+*
+*   Side Effects: None.
+*
+*   \param[in]  phase               Phase index.
+*   \param[in]  duty                Duty-cycle (in 0.01%).
+*
+*   \return     Operation status
+*
+*******************************************************************************/
+CREG_CFG_Ret_t IRAM_ATTR CREG_CFG_SetPhaseDuty(uint8_t phase, uint16_t duty){
+
+    if(phase >= CREG_CFG_NB_PHASE)  return CREG_CFG_STATUS_ERROR;
+
+    if(PHASE_STATUS_OK != PHASE_SetDuty(phase_ids[phase], duty)){
+        return CREG_CFG_STATUS_ERROR;
+    }
+
+    return CREG_CFG_STATUS_OK;
+}
+
+/***************************************************************************//*!
+*  \brief Enable phases.
+*
+*   This function is used to enable/disable the phases power stage. The
+*   regulator takes the exclusive use of the phases while enabled: refused
+*   if the phases are used by someone else (open loop measurement,
+*   waveform playback).
+*
+*   Preconditions: Hardware initialized.
+*
+*   Side Effects: None.
+*
+*   \param[in]  enable              Phases enable state.
+*
+*   \return     Operation status
+*
+*******************************************************************************/
+CREG_CFG_Ret_t CREG_CFG_EnablePhases(bool enable){
+
+    if(!enable){
+        //Phases left untouched if used by someone else
+        return (PHASE_STATUS_OK == PHASE_Release(PHASE_OWNER_REGULATOR)) ? CREG_CFG_STATUS_OK : CREG_CFG_STATUS_ERROR;
+    }
+
+    if(PHASE_STATUS_OK != PHASE_Acquire(PHASE_OWNER_REGULATOR)){
+        ESP_LOGE(TAG, "Phases used by someone else");
+        return CREG_CFG_STATUS_ERROR;
+    }
+
+    if(PHASE_STATUS_OK != PHASE_SetEnable(true)){
+        PHASE_Release(PHASE_OWNER_REGULATOR);
+        return CREG_CFG_STATUS_ERROR;
+    }
+
+    return CREG_CFG_STATUS_OK;
+}
+
+/***************************************************************************//*!
+*  \brief Set phases trip.
+*
+*   This function is used to trip the phase outputs (duty forced to 0 and
+*   held at 0, whoever drives the phases) or to clear the trip. Can be
+*   called from an ISR.
+*
+*   Preconditions: Hardware initialized.
+*
+*   Side Effects: None.
+*
+*   \param[in]  is_tripped          Phases trip state.
+*
+*******************************************************************************/
+void IRAM_ATTR CREG_CFG_SetPhaseTrip(bool is_tripped){
+
+    if(is_tripped)  PHASE_Trip();
+    else            PHASE_ClearTrip();
+}
+
+/***************************************************************************//*!
+*  \brief Get cycle count.
+*
+*   This function return the CPU cycle counter (loop instrumentation).
+*   Called from the loop interrupt.
+*
+*   Preconditions: None.
+*
+*   Side Effects: None.
+*
+*   \return     Cycle count
+*
+*******************************************************************************/
+uint32_t IRAM_ATTR CREG_CFG_GetCycleCount(void){
+
+    return (uint32_t)esp_cpu_get_cycle_count();
+}
+
+/***************************************************************************//*!
+*  \brief Get cycle counter frequency.
+*
+*   This function return the frequency of the cycle counter.
+*
+*   Preconditions: None.
+*
+*   Side Effects: None.
+*
+*   \return     Cycle counter frequency (Hz)
+*
+*******************************************************************************/
+uint32_t CREG_CFG_GetCycleFreqHz(void){
+
+    return (uint32_t)esp_clk_cpu_freq();
+}
+
+/******************************************************************************
+*   Interrupts
+*******************************************************************************/
+
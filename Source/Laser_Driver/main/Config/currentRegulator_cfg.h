@@ -0,0 +1,195 @@
+#ifndef __CURRENT_REGULATOR_CFG_H
+#define __CURRENT_REGULATOR_CFG_H
+
+#include <stdint.h>
+#include <stdbool.h>
+
+/******************************************************************************
+*   Public Definitions
+*******************************************************************************/
+#define CREG_CFG_NB_PHASE                   (2)
+#define CREG_CFG_MAX_DUTY                   (10000)//100.00%
+
+//Phase current sense (I_pA/I_pB): sense voltage = current x CREG_CFG_SENSE_MV_PER_A,
+//sampled raw by the ADC @12dB. CREG_CFG_SENSE_MV_PER_A is the board sense gain
+//(shunt resistance x amplifier gain) and must match the fitted parts, the
+//over-current fault (CREG_FAULT_OVERCURRENT_10MA) relies on it.
+#define CREG_CFG_SENSE_FULL_SCALE_RAW       (4095)//12bits
+#define CREG_CFG_SENSE_FULL_SCALE_MV        (3100)//ADC input range @12dB (esp32s3 datasheet)
+#define CREG_CFG_SENSE_MV_PER_A             (500)
+#define CREG_CFG_SENSE_FULL_SCALE_10MA      ((CREG_CFG_SENSE_FULL_SCALE_MV * 100) / CREG_CFG_SENSE_MV_PER_A)
+
+/******************************************************************************
+*   Public Macros
+*******************************************************************************/
+typedef void(*CREG_CFG_LoopCallback_t)(void);
+
+/******************************************************************************
+*   Public Data Types
+*******************************************************************************/
+typedef enum CREG_CFG_Ret_e{
+    CREG_CFG_STATUS_ERROR,
+    CREG_CFG_STATUS_OK,
+}CREG_CFG_Ret_t;
+
+/******************************************************************************
+*   Public Variables
+*******************************************************************************/
+
+
+/******************************************************************************
+*   Error Check
+*******************************************************************************/
+
+
+/******************************************************************************
+*   Public Functions Declarations
+*******************************************************************************/
+/***************************************************************************//*!
+*  \brief Init current regulator hardware.
+*
+*   This function is used to initialize the hardware used by the current
+*   regulator (loop timer, phase current sampling and phase outputs), with
+*   their interrupts on the control core (CONTROL_ISR_CORE).
+*
+*   Preconditions: None.
+*
+*   Side Effects: None.
+*
+*   \return     Operation status
+*
+*******************************************************************************/
+CREG_CFG_Ret_t CREG_CFG_InitHardware(void);
+
+/***************************************************************************//*!
+*  \brief Start regulation loop timer.
+*
+*   This function is used to start the periodic loop timer. The callback
+*   is called from the timer interrupt at the specified rate.
+*
+*   Preconditions: Hardware initialized.
+*
+*   Side Effects: None.
+*
+*   \param[in]  rate_hz             Loop rate.
+*   \param[in]  callback            Loop callback.
+*
+*   \return     Operation status
+*
+*******************************************************************************/
+CREG_CFG_Ret_t CREG_CFG_StartLoopTimer(uint32_t rate_hz, CREG_CFG_LoopCallback_t callback);
+
+/***************************************************************************//*!
+*  \brief Stop regulation loop timer.
+*
+*   This function is used to stop the periodic loop timer.
+*
+*   Preconditions: Hardware initialized.
+*
+*   Side Effects: None.
+*
+*   \return     Operation status
+*
+*******************************************************************************/
+CREG_CFG_Ret_t CREG_CFG_StopLoopTimer(void);
+
+/***************************************************************************//*!
+*  \brief Read phase current.
+*
+*   This function is used to read the instantaneous current of a phase.
+*   In 10mA (5A -> 500). Called from the loop interrupt.
+*
+*   Preconditions: Loop timer started.
+*
+*   Side Effects: None.
+*
+*   \param[in]  phase               Phase index.
+*   \param[out] pCurrent_10ma       Pointer to store the current.
+*
+*   \return     Operation status
+*
+*******************************************************************************/
+CREG_CFG_Ret_t CREG_CFG_ReadPhaseCurrent(uint8_t phase, int16_t *pCurrent_10ma);
+
+/***************************************************************************//*!
+*  \brief Set phase duty.
+*
+*   This function is used to apply a duty-cycle to a phase output
+*   (0 -> CREG_CFG_MAX_DUTY). Called from the loop interrupt.
+*
+*   Preconditions: Hardware initialized.
+*
+*   Side Effects: None.
+*
+*   \param[in]  phase               Phase index.
+*   \param[in]  duty                Duty-cycle (in 0.01%).
+*
+*   \return     Operation status
+*
+*******************************************************************************/
+CREG_CFG_Ret_t CREG_CFG_SetPhaseDuty(uint8_t phase, uint16_t duty);
+
+/***************************************************************************//*!
+*  \brief Enable phases.
+*
+*   This function is used to enable/disable the phases power stage. The
+*   regulator takes the exclusive use of the phases while enabled: refused
+*   if the phases are used by someone else.
+*
+*   Preconditions: Hardware initialized.
+*
+*   Side Effects: None.
+*
+*   \param[in]  enable              Phases enable state.
+*
+*   \return     Operation status
+*
+*******************************************************************************/
+CREG_CFG_Ret_t CREG_CFG_EnablePhases(bool enable);
+
+/***************************************************************************//*!
+*  \brief Set phases trip.
+*
+*   This function is used to trip the phase outputs (duty forced to 0 and
+*   held at 0, whoever drives the phases) or to clear the trip. Can be
+*   called from an ISR.
+*
+*   Preconditions: Hardware initialized.
+*
+*   Side Effects: None.
+*
+*   \param[in]  is_tripped          Phases trip state.
+*
+*******************************************************************************/
+void CREG_CFG_SetPhaseTrip(bool is_tripped);
+
+/***************************************************************************//*!
+*  \brief Get cycle count.
+*
+*   This function return the CPU cycle counter (loop instrumentation).
+*   Called from the loop interrupt.
+*
+*   Preconditions: None.
+*
+*   Side Effects: None.
+*
+*   \return     Cycle count
+*
+*******************************************************************************/
+uint32_t CREG_CFG_GetCycleCount(void);
+
+/***************************************************************************//*!
+*  \brief Get cycle counter frequency.
+*
+*   This function return the frequency of the cycle counter.
+*
+*   Preconditions: None.
+*
+*   Side Effects: None.
+*
+*   \return     Cycle counter frequency (Hz)
+*
+*******************************************************************************/
+uint32_t CREG_CFG_GetCycleFreqHz(void);
+
+#endif//__CURRENT_REGULATOR_CFG_H
@@ -0,0 +1,444 @@
+#include <time.h>
+
+#include "esp_log.h"
+
+#include "currentRegulator_cfg.h"
+#include "currentRegulator_sim.h"
+
+/******************************************************************************
+*   Private Definitions
+*******************************************************************************/
+#define SIM_STEP_US                         (10)//Plant integration step
+
+//Phase power stage (averaged model: L.di/dt = d.Vbus - Vf - R.i)
+#define SIM_PHASE_INDUCTANCE_H              (1.0e-3f)
+#define SIM_PHASE_RESISTANCE_OHM            (4.0f)
+#define SIM_BUS_RESISTANCE_OHM              (0.5f)
+
+//Diode stack (Vf drift with junction temperature)
+#define SIM_DIODE_VF_25C_V                  (6.0f)
+#define SIM_DIODE_VF_TEMPCO_V_PER_C         (-0.012f)
+#define SIM_DIODE_RTH_C_PER_W               (3.0f)
+#define SIM_DIODE_TAU_TH_S                  (0.2f)
+
+//Phase temperature sensor (phase heatsink, whole phase power)
+#define SIM_HEATSINK_TAU_TH_S               (2.0f)
+
+#define LOG_LOCAL_LEVEL                     (ESP_LOG_INFO)
+
+/******************************************************************************
+*   Private Macros
+*******************************************************************************/
+
+
+/******************************************************************************
+*   Private Data Types
+*******************************************************************************/
+typedef struct SIM_Phase_s{
+    float current_a;
+    float diode_temp_c;
+    float diode_vf_v;
+    float heatsink_temp_c;
+    float heatsink_rth_c_per_w;
+    uint16_t duty;
+}SIM_Phase_t;
+
+/******************************************************************************
+*   Private Functions Declaration
+*******************************************************************************/
+static float getBusVoltage(void);
+static void integratePlant(uint32_t duration_us);
+static int16_t getNoise(void);
+
+/******************************************************************************
+*   Public Variables
+*******************************************************************************/
+
+
+/******************************************************************************
+*   Private Variables
+*******************************************************************************/
+static SIM_Phase_t sim_phases[CREG_CFG_NB_PHASE];
+
+static float bus_voltage_v = CREG_SIM_DEFAULT_BUS_VOLTAGE_10MV / 100.0f;
+static float ambient_temp_c = CREG_SIM_DEFAULT_AMBIENT_TEMP / 100.0f;
+static uint16_t sim_noise_10ma = CREG_SIM_DEFAULT_NOISE_10MA;
+static uint32_t noise_seed = 1;
+
+static uint64_t sim_time_us = 0;
+static uint32_t loop_rate_hz = 0;
+static CREG_CFG_LoopCallback_t loop_callback = NULL;
+static bool phases_enabled = false;
+static bool phases_tripped = false;
+
+static const char * TAG = "CREG SIM";
+
+/******************************************************************************
+*   Error Check
+*******************************************************************************/
+
+
+/******************************************************************************
+*   Private Functions Definitions
+*******************************************************************************/
+/***************************************************************************//*!
+*  \brief Get bus voltage.
+*
+*   This function return the bus voltage after the source resistance sag
+*   caused by the phases input current.
+*
+*******************************************************************************/
+static float getBusVoltage(void){
+
+    float input_current_a = 0;
+    for(uint8_t i=0; i<CREG_CFG_NB_PHASE; i++){
+        input_current_a += sim_phases[i].current_a * (sim_phases[i].duty / (float)CREG_CFG_MAX_DUTY);
+    }
+
+    return bus_voltage_v - (SIM_BUS_RESISTANCE_OHM * input_current_a);
+}
+
+/***************************************************************************//*!
+*  \brief Integrate plant.
+*
+*   This function integrate the plant (phase current and diode temperature)
+*   over the specified duration with a fixed SIM_STEP_US step.
+*
+*******************************************************************************/
+static void integratePlant(uint32_t duration_us){
+
+    const float dt = SIM_STEP_US * 1e-6f;
+
+    for(uint32_t t=0; t<duration_us; t+=SIM_STEP_US){
+
+        float bus_v = getBusVoltage();
+
+        for(uint8_t i=0; i<CREG_CFG_NB_PHASE; i++){
+            SIM_Phase_t *pPhase = &sim_phases[i];
+
+            //Diode forward voltage (temperature dependant)
+            pPhase->diode_vf_v = SIM_DIODE_VF_25C_V + (SIM_DIODE_VF_TEMPCO_V_PER_C * (pPhase->diode_temp_c - 25.0f));
+
+            //Phase current (diode blocks reverse current)
+            float drive_v = phases_enabled ? (bus_v * (pPhase->duty / (float)CREG_CFG_MAX_DUTY)) : 0;
+            float di = ((drive_v - pPhase->diode_vf_v - (SIM_PHASE_RESISTANCE_OHM * pPhase->current_a)) / SIM_PHASE_INDUCTANCE_H) * dt;
+            pPhase->current_a += di;
+            if(pPhase->current_a < 0)   pPhase->current_a = 0;
+
+            //Diode junction temperature (first order thermal model)
+            float power_w = pPhase->diode_vf_v * pPhase->current_a;
+            float temp_target_c = ambient_temp_c + (SIM_DIODE_RTH_C_PER_W * power_w);
+            pPhase->diode_temp_c += ((temp_target_c - pPhase->diode_temp_c) / SIM_DIODE_TAU_TH_S) * dt;
+
+            //Phase heatsink temperature (diodes + series resistance power)
+            float phase_power_w = power_w + (SIM_PHASE_RESISTANCE_OHM * pPhase->current_a * pPhase->current_a);
+            float heatsink_target_c = ambient_temp_c + (pPhase->heatsink_rth_c_per_w * phase_power_w);
+            pPhase->heatsink_temp_c += ((heatsink_target_c - pPhase->heatsink_temp_c) / SIM_HEATSINK_TAU_TH_S) * dt;
+        }
+    }
+    sim_time_us += duration_us;
+}
+
+/***************************************************************************//*!
+*  \brief Get noise.
+*
+*   This function return a deterministic pseudo random noise sample
+*   (-noise -> +noise amplitude).
+*
+*******************************************************************************/
+static int16_t getNoise(void){
+
+    if(sim_noise_10ma == 0) return 0;
+
+    noise_seed = (noise_seed * 1103515245UL) + 12345UL;
+    return (int16_t)((int32_t)((noise_seed >> 16) % ((2 * sim_noise_10ma) + 1)) - sim_noise_10ma);
+}
+
+/******************************************************************************
+*   CallBack Functions implementation
+*******************************************************************************/
+
+
+/******************************************************************************
+*   Public Functions Definitions
+*******************************************************************************/
+//Simulated implementation of the currentRegulator_cfg.h interface
+CREG_CFG_Ret_t CREG_CFG_InitHardware(void){
+
+    ESP_LOGI(TAG, "Using simulated plant");
+
+    CREG_SIM_ResetPlant();
+    loop_callback = NULL;
+    loop_rate_hz = 0;
+
+    return CREG_CFG_STATUS_OK;
+}
+
+CREG_CFG_Ret_t CREG_CFG_StartLoopTimer(uint32_t rate_hz, CREG_CFG_LoopCallback_t callback){
+
+    if((callback == NULL) || (rate_hz == 0)){
+        return CREG_CFG_STATUS_ERROR;
+    }
+
+    //No timer: the loop is run by CREG_SIM_Advance()
+    loop_rate_hz = rate_hz;
+    loop_callback = callback;
+
+    return CREG_CFG_STATUS_OK;
+}
+
+CREG_CFG_Ret_t CREG_CFG_StopLoopTimer(void){
+
+    loop_callback = NULL;
+
+    return CREG_CFG_STATUS_OK;
+}
+
+CREG_CFG_Ret_t CREG_CFG_ReadPhaseCurrent(uint8_t phase, int16_t *pCurrent_10ma){
+
+    if(phase >= CREG_CFG_NB_PHASE)  return CREG_CFG_STATUS_ERROR;
+
+    //Quantize as the ADC would (same current sense scale as the hardware)
+    int32_t current_10ma = (int32_t)((sim_phases[phase].current_a * 100.0f) + 0.5f) + getNoise();
+    if(current_10ma < 0)    current_10ma = 0;
+    if(current_10ma > CREG_CFG_SENSE_FULL_SCALE_10MA)   current_10ma = CREG_CFG_SENSE_FULL_SCALE_10MA;
+    uint32_t raw = (((uint32_t)current_10ma * CREG_CFG_SENSE_FULL_SCALE_RAW) + (CREG_CFG_SENSE_FULL_SCALE_10MA / 2)) / CREG_CFG_SENSE_FULL_SCALE_10MA;
+
+    *pCurrent_10ma = (int16_t)(((raw * CREG_CFG_SENSE_FULL_SCALE_10MA) + (CREG_CFG_SENSE_FULL_SCALE_RAW / 2)) / CREG_CFG_SENSE_FULL_SCALE_RAW);
+
+    return CREG_CFG_STATUS_OK;
+}
+
+CREG_CFG_Ret_t CREG_CFG_SetPhaseDuty(uint8_t phase, uint16_t duty){
+
+    if(phase >= CREG_CFG_NB_PHASE)  return CREG_CFG_STATUS_ERROR;
+
+    if(phases_tripped)  duty = 0;
+    sim_phases[phase].duty = (duty > CREG_CFG_MAX_DUTY) ? CREG_CFG_MAX_DUTY : duty;
+
+    return CREG_CFG_STATUS_OK;
+}
+
+CREG_CFG_Ret_t CREG_CFG_EnablePhases(bool enable){
+
+    phases_enabled = enable;
+
+    return CREG_CFG_STATUS_OK;
+}
+
+void CREG_CFG_SetPhaseTrip(bool is_tripped){
+
+    phases_tripped = is_tripped;
+
+    if(is_tripped){
+        for(uint8_t i=0; i<CREG_CFG_NB_PHASE; i++){
+            sim_phases[i].duty = 0;
+        }
+    }
+}
+
+uint32_t CREG_CFG_GetCycleCount(void){
+
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+
+    return (uint32_t)((ts.tv_sec * 1000000000ULL) + ts.tv_nsec);
+}
+
+uint32_t CREG_CFG_GetCycleFreqHz(void){
+
+    return 1000000000UL;//ns counter
+}
+
+/***************************************************************************//*!
+*  \brief Reset simulated plant.
+*
+*   This function is used to reset the simulated plant to its default
+*   state (no current, diodes and heatsinks at ambient temperature, default
+*   bus voltage, heatsinks thermal resistance and noise level).
+*
+*   Preconditions: None.
+*
+*   Side Effects: None.
+*
+*******************************************************************************/
+void CREG_SIM_ResetPlant(void){
+
+    bus_voltage_v = CREG_SIM_DEFAULT_BUS_VOLTAGE_10MV / 100.0f;
+    ambient_temp_c = CREG_SIM_DEFAULT_AMBIENT_TEMP / 100.0f;
+    sim_noise_10ma = CREG_SIM_DEFAULT_NOISE_10MA;
+    noise_seed = 1;
+    sim_time_us = 0;
+
+    for(uint8_t i=0; i<CREG_CFG_NB_PHASE; i++){
+        sim_phases[i].current_a = 0;
+        sim_phases[i].diode_temp_c = ambient_temp_c;
+        sim_phases[i].diode_vf_v = SIM_DIODE_VF_25C_V;
+        sim_phases[i].heatsink_temp_c = ambient_temp_c;
+        sim_phases[i].heatsink_rth_c_per_w = CREG_SIM_DEFAULT_HEATSINK_RTH / 100.0f;
+        sim_phases[i].duty = 0;
+    }
+}
+
+/***************************************************************************//*!
+*  \brief Advance simulation.
+*
+*   This function is used to advance the simulation by the specified number
+*   of loop periods. The plant is integrated over each loop period then the
+*   loop callback is executed (synchronous and deterministic).
+*
+*   Preconditions: Loop timer started.
+*
+*   Side Effects: None.
+*
+*   \param[in]  nb_loops            Number of loop periods to simulate.
+*
+*   \return     Operation status
+*
+*******************************************************************************/
+CREG_CFG_Ret_t CREG_SIM_Advance(uint32_t nb_loops){
+
+    if((loop_callback == NULL) || (loop_rate_hz == 0)){
+        return CREG_CFG_STATUS_ERROR;
+    }
+
+    uint32_t period_us = 1000000UL / loop_rate_hz;
+    for(uint32_t i=0; i<nb_loops; i++){
+        integratePlant(period_us);
+        loop_callback();
+    }
+
+    return CREG_CFG_STATUS_OK;
+}
+
+/***************************************************************************//*!
+*  \brief Set bus voltage.
+*
+*   This function is used to set the simulated bus open circuit voltage.
+*   In 10mV (24V -> 2400).
+*
+*   Preconditions: None.
+*
+*   Side Effects: None.
+*
+*   \param[in]  voltage_10mv        Bus voltage.
+*
+*******************************************************************************/
+void CREG_SIM_SetBusVoltage(int16_t voltage_10mv){
+
+    bus_voltage_v = voltage_10mv / 100.0f;
+}
+
+/***************************************************************************//*!
+*  \brief Set ambient temperature.
+*
+*   This function is used to set the simulated ambient temperature.
+*   In 0.01C (25C -> 2500).
+*
+*   Preconditions: None.
+*
+*   Side Effects: None.
+*
+*   \param[in]  temperature         Ambient temperature.
+*
+*******************************************************************************/
+void CREG_SIM_SetAmbientTemperature(int16_t temperature){
+
+    ambient_temp_c = temperature / 100.0f;
+}
+
+/***************************************************************************//*!
+*  \brief Set measurement noise.
+*
+*   This function is used to set the peak amplitude of the (pseudo random)
+*   current measurement noise. In 10mA.
+*
+*   Preconditions: None.
+*
+*   Side Effects: None.
+*
+*   \param[in]  noise_10ma          Noise amplitude.
+*
+*******************************************************************************/
+void CREG_SIM_SetNoise(uint16_t noise_10ma){
+
+    sim_noise_10ma = noise_10ma;
+}
+
+/***************************************************************************//*!
+*  \brief Set heatsink thermal resistance.
+*
+*   This function is used to set the thermal resistance between a phase
+*   heatsink (phase temperature sensor) and the ambient. In 0.01C/W.
+*
+*   Preconditions: None.
+*
+*   Side Effects: None.
+*
+*   \param[in]  phase               Phase index.
+*   \param[in]  rth                 Thermal resistance.
+*
+*   \return     Operation status
+*
+*******************************************************************************/
+CREG_CFG_Ret_t CREG_SIM_SetHeatsinkRth(uint8_t phase, uint16_t rth){
+
+    if(phase >= CREG_CFG_NB_PHASE)  return CREG_CFG_STATUS_ERROR;
+
+    sim_phases[phase].heatsink_rth_c_per_w = rth / 100.0f;
+
+    return CREG_CFG_STATUS_OK;
+}
+
+/***************************************************************************//*!
+*  \brief Get plant state.
+*
+*   This function is used to get the simulated plant state of a phase.
+*
+*   Preconditions: None.
+*
+*   Side Effects: None.
+*
+*   \param[in]  phase               Phase index.
+*   \param[out] pState              Pointer to store the plant state.
+*
+*   \return     Operation status
+*
+*******************************************************************************/
+CREG_CFG_Ret_t CREG_SIM_GetPlantState(uint8_t phase, CREG_SIM_Plant_State_t *pState){
+
+    if((phase >= CREG_CFG_NB_PHASE) || (pState == NULL)){
+        return CREG_CFG_STATUS_ERROR;
+    }
+
+    pState->current_10ma = (int16_t)((sim_phases[phase].current_a * 100.0f) + 0.5f);
+    pState->bus_voltage_10mv = (int16_t)(getBusVoltage() * 100.0f);
+    pState->diode_temperature = (int16_t)(sim_phases[phase].diode_temp_c * 100.0f);
+    pState->diode_voltage_10mv = (int16_t)(sim_phases[phase].diode_vf_v * 100.0f);
+    pState->heatsink_temperature = (int16_t)(sim_phases[phase].heatsink_temp_c * 100.0f);
+    pState->duty = sim_phases[phase].duty;
+
+    return CREG_CFG_STATUS_OK;
+}
+
+/***************************************************************************//*!
+*  \brief Get simulation time.
+*
+*   This function return the simulated time since the last plant reset.
+*
+*   Preconditions: None.
+*
+*   Side Effects: None.
+*
+*   \return     Simulated time (us)
+*
+*******************************************************************************/
+uint64_t CREG_SIM_GetTimeUs(void){
+
+    return sim_time_us;
+}
+
+/******************************************************************************
+*   Interrupts
+*******************************************************************************/
+
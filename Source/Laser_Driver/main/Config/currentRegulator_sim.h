@@ -0,0 +1,173 @@
+#ifndef __CURRENT_REGULATOR_SIM_H
+#define __CURRENT_REGULATOR_SIM_H
+
+#include <stdint.h>
+#include <stdbool.h>
+
+#include "currentRegulator_cfg.h"
+
+/******************************************************************************
+*   Public Definitions
+*******************************************************************************/
+#define CREG_SIM_DEFAULT_BUS_VOLTAGE_10MV   (2400)//24V
+#define CREG_SIM_DEFAULT_AMBIENT_TEMP       (2500)//25C
+#define CREG_SIM_DEFAULT_NOISE_10MA         (2)
+#define CREG_SIM_DEFAULT_HEATSINK_RTH       (100)//1C/W
+
+/******************************************************************************
+*   Public Macros
+*******************************************************************************/
+
+
+/******************************************************************************
+*   Public Data Types
+*******************************************************************************/
+typedef struct CREG_SIM_Plant_State_s{
+    int16_t current_10ma;               //Real phase current (no noise)
+    int16_t bus_voltage_10mv;           //Bus voltage (after sag)
+    int16_t diode_temperature;          //Diode temperature (0.01C)
+    int16_t diode_voltage_10mv;         //Diode forward voltage
+    int16_t heatsink_temperature;       //Phase heatsink temperature (0.01C)
+    uint16_t duty;                      //Applied duty (0.01%)
+}CREG_SIM_Plant_State_t;
+
+/******************************************************************************
+*   Public Variables
+*******************************************************************************/
+
+
+/******************************************************************************
+*   Error Check
+*******************************************************************************/
+
+
+/******************************************************************************
+*   Public Functions Declarations
+*******************************************************************************/
+/***************************************************************************//*!
+*  \brief Reset simulated plant.
+*
+*   This function is used to reset the simulated plant to its default
+*   state (no current, diodes and heatsinks at ambient temperature, default
+*   bus voltage, heatsinks thermal resistance and noise level).
+*
+*   Preconditions: None.
+*
+*   Side Effects: None.
+*
+*******************************************************************************/
+void CREG_SIM_ResetPlant(void);
+
+/***************************************************************************//*!
+*  \brief Advance simulation.
+*
+*   This function is used to advance the simulation by the specified number
+*   of loop periods. The plant is integrated over each loop period then the
+*   loop callback is executed (synchronous and deterministic).
+*
+*   Preconditions: Loop timer started.
+*
+*   Side Effects: None.
+*
+*   \param[in]  nb_loops            Number of loop periods to simulate.
+*
+*   \return     Operation status
+*
+*******************************************************************************/
+CREG_CFG_Ret_t CREG_SIM_Advance(uint32_t nb_loops);
+
+/***************************************************************************//*!
+*  \brief Set bus voltage.
+*
+*   This function is used to set the simulated bus open circuit voltage.
+*   In 10mV (24V -> 2400).
+*
+*   Preconditions: None.
+*
+*   Side Effects: None.
+*
+*   \param[in]  voltage_10mv        Bus voltage.
+*
+*******************************************************************************/
+void CREG_SIM_SetBusVoltage(int16_t voltage_10mv);
+
+/***************************************************************************//*!
+*  \brief Set ambient temperature.
+*
+*   This function is used to set the simulated ambient temperature.
+*   In 0.01C (25C -> 2500).
+*
+*   Preconditions: None.
+*
+*   Side Effects: None.
+*
+*   \param[in]  temperature         Ambient temperature.
+*
+*******************************************************************************/
+void CREG_SIM_SetAmbientTemperature(int16_t temperature);
+
+/***************************************************************************//*!
+*  \brief Set measurement noise.
+*
+*   This function is used to set the peak amplitude of the (pseudo random)
+*   current measurement noise. In 10mA.
+*
+*   Preconditions: None.
+*
+*   Side Effects: None.
+*
+*   \param[in]  noise_10ma          Noise amplitude.
+*
+*******************************************************************************/
+void CREG_SIM_SetNoise(uint16_t noise_10ma);
+
+/***************************************************************************//*!
+*  \brief Set heatsink thermal resistance.
+*
+*   This function is used to set the thermal resistance between a phase
+*   heatsink (phase temperature sensor) and the ambient. In 0.01C/W.
+*
+*   Preconditions: None.
+*
+*   Side Effects: None.
+*
+*   \param[in]  phase               Phase index.
+*   \param[in]  rth                 Thermal resistance.
+*
+*   \return     Operation status
+*
+*******************************************************************************/
+CREG_CFG_Ret_t CREG_SIM_SetHeatsinkRth(uint8_t phase, uint16_t rth);
+
+/***************************************************************************//*!
+*  \brief Get plant state.
+*
+*   This function is used to get the simulated plant state of a phase.
+*
+*   Preconditions: None.
+*
+*   Side Effects: None.
+*
+*   \param[in]  phase               Phase index.
+*   \param[out] pState              Pointer to store the plant state.
+*
+*   \return     Operation status
+*
+*******************************************************************************/
+CREG_CFG_Ret_t CREG_SIM_GetPlantState(uint8_t phase, CREG_SIM_Plant_State_t *pState);
+
+/***************************************************************************//*!
+*  \brief Get simulation time.
+*
+*   This function return the simulated time since the last plant reset.
+*
+*   Preconditions: None.
+*
+*   Side Effects: None.
+*
+*   \return     Simulated time (us)
+*
+*******************************************************************************/
+uint64_t CREG_SIM_GetTimeUs(void);
+
+#endif//__CURRENT_REGULATOR_SIM_H
@@ -1,6 +1,11 @@
+#include <string.h>
+
 #include "freertos/FreeRTOS.h"
 #include "freertos/semphr.h"
 
+#include "esp_attr.h"
+#include "esp_cpu.h"
+#include "esp_clk_tree.h"
 #include "driver/gpio.h"
 #include "ledDriver_cfg.h"
 
@@ -9,22 +14,70 @@
 *******************************************************************************/
 #define LDRV_TIMER_MODE                     (LEDC_LOW_SPEED_MODE)
 #define LDRV_DEFAULT_FREQ_HZ                (1000)
-#define LDRV_DEFAULT_DUTY_RES               (LEDC_TIMER_8_BIT)
+
+#define LDRV_GAMMA_DUTY_RES                 (14)//Gamma table resolution (LEDC timer width)
+#define LDRV_GAMMA_NB_LEVELS                (LDRV_CFG_MAX_PWM_DUTY + 1)
+#define LDRV_GAMMA_NB_SEGMENTS              (8)//Linear segments per perceptual fade
+
+#define LDRV_MAX_FADE_CYCLES                (1023)//LEDC duty cycle field (cycles per step)
+#define LDRV_MAX_FADE_SCALE                 (1023)//LEDC duty scale field (duty per step)
 
 /******************************************************************************
 *   Private Macros
 *******************************************************************************/
-
+#define LDRV_SLOT_BIT(slot)                 (1U << (slot))
+#define LDRV_MIN(a, b)                      (((a) < (b)) ? (a) : (b))
 
 /******************************************************************************
 *   Private Data Types
 *******************************************************************************/
-
+//Hardware fade segment, played by the LEDC without CPU
+typedef struct LDRV_Segment_s{
+    uint16_t target_duty;
+    uint16_t scale;                     //Duty per step (0 -> set target_duty and hold)
+    uint16_t cycle_num;                 //PWM cycles per step (hold -> hold time)
+}LDRV_Segment_t;
+
+typedef struct LDRV_Sequence_s{
+    LDRV_Segment_t segment[LDRV_CFG_MAX_NB_CHANNEL][LDRV_CFG_MAX_NB_SEGMENT];
+    uint8_t nb_segment[LDRV_CFG_MAX_NB_CHANNEL];
+    uint8_t index[LDRV_CFG_MAX_NB_CHANNEL];
+    ledc_channel_t channel[LDRV_CFG_MAX_NB_CHANNEL];
+    ledc_timer_t timer;
+    uint8_t nb_channels;
+    uint8_t playing_mask;               //Channels still playing the current loop
+    uint32_t nb_loops;                  //Remaining loops (0 -> forever)
+    bool is_running;
+    LDRV_CFG_Sequence_Stats_t stats;
+}LDRV_Sequence_t;
+
+//Fade end callback context of a sequence channel
+typedef struct LDRV_Slot_Context_s{
+    uint8_t led_index;
+    uint8_t slot;
+}LDRV_Slot_Context_t;
 
 /******************************************************************************
 *   Private Functions Declaration
 *******************************************************************************/
-
+static LDRV_CFG_Ret_t configTimer(ledc_timer_t timer, uint32_t freq_hz);
+static uint32_t levelToDuty(uint32_t level, LDRV_CFG_Active_Level_t active_level, ledc_timer_t timer);
+static uint32_t dutyToLevel(uint32_t duty, LDRV_CFG_Active_Level_t active_level, ledc_timer_t timer);
+static uint8_t compileHold(uint32_t duty,
+                           uint64_t total_cycles,
+                           LDRV_Segment_t *pSegment,
+                           uint8_t nb_free);
+static uint8_t compileKeyframe(uint32_t from_level,
+                               uint32_t to_level,
+                               const LDRV_CFG_Keyframe_t *pKeyframe,
+                               uint32_t freq_hz,
+                               LDRV_CFG_Active_Level_t active_level,
+                               ledc_timer_t timer,
+                               LDRV_Segment_t *pSegment,
+                               uint8_t nb_free);
+static bool startSegment(LDRV_Sequence_t *pSequence, uint8_t slot);
+static void restartSequence(LDRV_Sequence_t *pSequence);
+static bool fadeEndCallback(const ledc_cb_param_t *param, void *user_arg);
 
 /******************************************************************************
 *   Public Variables
@@ -35,22 +88,431 @@
 *   Private Variables
 *******************************************************************************/
 static SemaphoreHandle_t ldrv_mutex_handle = NULL;
-
+static StaticSemaphore_t ldrv_mutex_buffer;
+
+//Gamma 2.2 at LDRV_GAMMA_DUTY_RES bits, 100% is (1 << LDRV_GAMMA_DUTY_RES)
+//Levels above 0 never round down to off
+static const uint16_t gamma_table[LDRV_GAMMA_NB_LEVELS] = {
+        0,     1,     1,     1,     2,     3,     4,     6,     8,    10,    13,    16,
+       20,    23,    28,    32,    37,    42,    48,    54,    61,    67,    75,    82,
+       90,    99,   108,   117,   127,   137,   148,   159,   170,   182,   195,   207,
+      221,   234,   249,   263,   278,   294,   310,   326,   343,   361,   379,   397,
+      416,   435,   455,   475,   496,   517,   539,   561,   584,   607,   630,   654,
+      679,   704,   730,   756,   783,   810,   838,   866,   894,   924,   953,   984,
+     1014,  1046,  1077,  1110,  1142,  1176,  1210,  1244,  1279,  1314,  1350,  1387,
+     1424,  1461,  1499,  1538,  1577,  1617,  1657,  1698,  1739,  1781,  1824,  1866,
+     1910,  1954,  1999,  2044,  2089,  2136,  2182,  2230,  2278,  2326,  2375,  2425,
+     2475,  2526,  2577,  2629,  2681,  2734,  2788,  2842,  2896,  2951,  3007,  3064,
+     3121,  3178,  3236,  3295,  3354,  3414,  3474,  3535,  3597,  3659,  3721,  3785,
+     3849,  3913,  3978,  4044,  4110,  4177,  4244,  4312,  4380,  4450,  4519,  4590,
+     4660,  4732,  4804,  4877,  4950,  5024,  5098,  5173,  5249,  5325,  5402,  5480,
+     5558,  5637,  5716,  5796,  5876,  5957,  6039,  6121,  6204,  6288,  6372,  6457,
+     6542,  6628,  6715,  6802,  6890,  6978,  7067,  7157,  7247,  7338,  7429,  7522,
+     7614,  7708,  7802,  7896,  7992,  8087,  8184,  8281,  8379,  8477,  8576,  8676,
+     8776,  8877,  8978,  9080,  9183,  9287,  9391,  9495,  9601,  9707,  9813,  9920,
+    10028, 10137, 10246, 10355, 10466, 10577, 10688, 10801, 10914, 11027, 11141, 11256,
+    11372, 11488, 11605, 11722, 11840, 11959, 12078, 12198, 12319, 12440, 12562, 12685,
+    12808, 12932, 13057, 13182, 13308, 13434, 13561, 13689, 13818, 13947, 14077, 14207,
+    14338, 14470, 14602, 14736, 14869, 15004, 15139, 15274, 15411, 15548, 15686, 15824,
+    15963, 16103, 16243, 16384,
+};
+
+//Duty resolution of each timer (highest the clock allows)
+static uint8_t timer_duty_res[LEDC_TIMER_MAX];
+
+//One sequence per led (under sequence_spinlock once running, read by the fade end ISR)
+static LDRV_Sequence_t sequence[LDRV_CFG_MAX_NB_LED];
+static LDRV_Slot_Context_t slot_context[LDRV_CFG_MAX_NB_LED][LDRV_CFG_MAX_NB_CHANNEL];
+static portMUX_TYPE sequence_spinlock = portMUX_INITIALIZER_UNLOCKED;
 
 /******************************************************************************
 *   Error Check
 *******************************************************************************/
+#if (LDRV_CFG_MAX_NB_CHANNEL > 8)
+#error "Too many channels for the sequence playing mask"
+#endif
 
+#if (LDRV_CFG_MAX_NB_SEGMENT > 255)
+#error "Too many segments for the sequence index"
+#endif
+
+#if (LDRV_CFG_MAX_PWM_DUTY != 255)
+#error "Gamma table built for 256 levels"
+#endif
 
 /******************************************************************************
 *   Private Functions Definitions
 *******************************************************************************/
+/***************************************************************************//*!
+*  \brief Config timer.
+*
+*   Configure a led timer at the highest duty resolution the clock allows
+*   for the frequency (capped to the gamma table resolution).
+*
+*   Preconditions: None.
+*
+*   Side Effects: Duty of the timer channels rescaled on their next update.
+*
+*   \param[in]  timer               Ledc timer
+*   \param[in]  freq_hz             PWM frequency (in Hz)
+*
+*   \return     Operation status
+*
+*******************************************************************************/
+static LDRV_CFG_Ret_t configTimer(ledc_timer_t timer, uint32_t freq_hz){
+
+    uint32_t xtal_freq_hz = 0;
+
+    if(ESP_OK != esp_clk_tree_src_get_freq_hz(SOC_MOD_CLK_XTAL,
+                                              ESP_CLK_TREE_SRC_FREQ_PRECISION_CACHED,
+                                              &xtal_freq_hz)){
+        return LDRV_CFG_STATUS_ERROR;
+    }
+
+    uint32_t duty_res = ledc_find_suitable_duty_resolution(xtal_freq_hz, freq_hz);
+    duty_res = LDRV_MIN(duty_res, LDRV_MIN(LDRV_GAMMA_DUTY_RES, LEDC_TIMER_BIT_MAX - 1));
+    if(duty_res == 0)   return LDRV_CFG_STATUS_ERROR;
+
+    ledc_timer_config_t ledc_timer = {
+        .speed_mode = LDRV_TIMER_MODE,
+        .duty_resolution = duty_res,
+        .timer_num = timer,
+        .freq_hz = freq_hz,
+        .clk_cfg = LEDC_USE_XTAL_CLK,
+    };
+
+    if(ESP_OK != ledc_timer_config(&ledc_timer)){
+        return LDRV_CFG_STATUS_ERROR;
+    }
+
+    timer_duty_res[timer] = (uint8_t)duty_res;
+
+    return LDRV_CFG_STATUS_OK;
+}
+
+/***************************************************************************//*!
+*  \brief Level to duty.
+*
+*   Convert a perceptual level to the LEDC duty of a timer: gamma table
+*   scaled to the timer resolution, inverted if the led is active low.
+*
+*   Preconditions: Timer configured.
+*
+*   Side Effects: None.
+*
+*   \param[in]  level               Level (0 to LDRV_CFG_MAX_PWM_DUTY)
+*   \param[in]  active_level        Led active level
+*   \param[in]  timer               Ledc timer
+*
+*   \return     LEDC duty
+*
+*******************************************************************************/
+static uint32_t levelToDuty(uint32_t level, LDRV_CFG_Active_Level_t active_level, ledc_timer_t timer){
+
+    uint8_t duty_res = timer_duty_res[timer];
+
+    if(level > LDRV_CFG_MAX_PWM_DUTY)   level = LDRV_CFG_MAX_PWM_DUTY;
+
+    uint32_t duty = gamma_table[level] >> (LDRV_GAMMA_DUTY_RES - duty_res);
+    if((level > 0) && (duty == 0))  duty = 1;
+
+    if(active_level == LDRV_CFG_ACTIVE_LOW)     duty = (1UL << duty_res) - duty;
+
+    return duty;
+}
+
+/***************************************************************************//*!
+*  \brief Duty to level.
+*
+*   Convert a LEDC duty back to the closest perceptual level at or below it.
+*
+*   Preconditions: Timer configured.
+*
+*   Side Effects: None.
+*
+*   \param[in]  duty                LEDC duty
+*   \param[in]  active_level        Led active level
+*   \param[in]  timer               Ledc timer
+*
+*   \return     Level (0 to LDRV_CFG_MAX_PWM_DUTY)
+*
+*******************************************************************************/
+static uint32_t dutyToLevel(uint32_t duty, LDRV_CFG_Active_Level_t active_level, ledc_timer_t timer){
+
+    uint8_t duty_res = timer_duty_res[timer];
+    uint32_t max_duty = 1UL << duty_res;
+
+    if(duty > max_duty)     duty = max_duty;
+    if(active_level == LDRV_CFG_ACTIVE_LOW)     duty = max_duty - duty;
+
+    uint32_t gamma_duty = duty << (LDRV_GAMMA_DUTY_RES - duty_res);
+    uint32_t low = 0;
+    uint32_t high = LDRV_CFG_MAX_PWM_DUTY;
+
+    //Highest level with gamma_table[level] <= gamma_duty
+    while(low < high){
+        uint32_t mid = (low + high + 1) / 2;
+        if(gamma_table[mid] <= gamma_duty)  low = mid;
+        else                                high = mid - 1;
+    }
+
+    return low;
+}
+
+/***************************************************************************//*!
+*  \brief Compile hold.
+*
+*   Compile a duty hold into hardware segments of at most
+*   LDRV_MAX_FADE_CYCLES cycles.
+*
+*   Preconditions: None.
+*
+*   Side Effects: None.
+*
+*   \param[in]  duty                LEDC duty
+*   \param[in]  total_cycles        Hold time (in PWM cycles, at least 1)
+*   \param[out] pSegment            Pointer to store the segments
+*   \param[in]  nb_free             Number of segments available
+*
+*   \return     Number of segments (0 -> not enough segments)
+*
+*******************************************************************************/
+static uint8_t compileHold(uint32_t duty,
+                           uint64_t total_cycles,
+                           LDRV_Segment_t *pSegment,
+                           uint8_t nb_free){
+
+    uint8_t nb_segment = 0;
+
+    while(total_cycles > 0){
+        if(nb_segment >= nb_free)   return 0;
+
+        uint32_t cycles = (uint32_t)LDRV_MIN(total_cycles, LDRV_MAX_FADE_CYCLES);
+        pSegment[nb_segment].target_duty = (uint16_t)duty;
+        pSegment[nb_segment].scale = 0;
+        pSegment[nb_segment].cycle_num = (uint16_t)cycles;
+        total_cycles -= cycles;
+        nb_segment++;
+    }
+
+    return nb_segment;
+}
+
+/***************************************************************************//*!
+*  \brief Compile keyframe.
+*
+*   Compile one keyframe of one channel into hardware segments. A fade is
+*   split in up to LDRV_GAMMA_NB_SEGMENTS linear segments between gamma
+*   corrected levels (same step/cycle split as ledc_set_fade_with_time for
+*   each), a hold is split in segments of at most LDRV_MAX_FADE_CYCLES cycles.
+*
+*   Preconditions: Timer configured.
+*
+*   Side Effects: None.
+*
+*   \param[in]  from_level          Channel level at the keyframe start
+*   \param[in]  to_level            Channel level at the keyframe end
+*   \param[in]  pKeyframe           Pointer to the keyframe
+*   \param[in]  freq_hz             PWM frequency (in Hz)
+*   \param[in]  active_level        Led active level
+*   \param[in]  timer               Ledc timer
+*   \param[out] pSegment            Pointer to store the segments
+*   \param[in]  nb_free             Number of segments available
+*
+*   \return     Number of segments (0 -> not enough segments)
+*
+*******************************************************************************/
+static uint8_t compileKeyframe(uint32_t from_level,
+                               uint32_t to_level,
+                               const LDRV_CFG_Keyframe_t *pKeyframe,
+                               uint32_t freq_hz,
+                               LDRV_CFG_Active_Level_t active_level,
+                               ledc_timer_t timer,
+                               LDRV_Segment_t *pSegment,
+                               uint8_t nb_free){
+
+    uint64_t total_cycles = ((uint64_t)pKeyframe->time_ms * freq_hz) / 1000;
+    uint32_t level_delta = (to_level > from_level) ? (to_level - from_level) : (from_level - to_level);
+    uint8_t nb_segment = 0;
+
+    //At least one PWM period per keyframe (fade end interrupt)
+    if(total_cycles == 0)   total_cycles = 1;
+
+    if((pKeyframe->is_fade == false) || (level_delta == 0)){
+        return compileHold(levelToDuty(to_level, active_level, timer), total_cycles, pSegment, nb_free);
+    }
+
+    uint32_t nb_steps = LDRV_MIN(level_delta, LDRV_GAMMA_NB_SEGMENTS);
+    uint32_t step_from_duty = levelToDuty(from_level, active_level, timer);
+
+    for(uint32_t step=1; step<=nb_steps; step++){
+
+        //Equal level (perceptual) and time slices
+        int32_t step_level = (int32_t)from_level + (((int32_t)to_level - (int32_t)from_level) * (int32_t)step) / (int32_t)nb_steps;
+        uint32_t step_to_duty = levelToDuty((uint32_t)step_level, active_level, timer);
+        uint64_t step_cycles = ((total_cycles * step) / nb_steps) - ((total_cycles * (step - 1)) / nb_steps);
+        uint32_t duty_delta = (step_to_duty > step_from_duty) ? (step_to_duty - step_from_duty) : (step_from_duty - step_to_duty);
+
+        if(step_cycles == 0)    step_cycles = 1;
+
+        if(duty_delta == 0){
+            uint8_t nb_hold = compileHold(step_to_duty, step_cycles, &pSegment[nb_segment], nb_free - nb_segment);
+            if(nb_hold == 0)    return 0;
+            nb_segment += nb_hold;
+        }
+        else{
+            if(nb_segment >= nb_free)   return 0;
+
+            pSegment[nb_segment].target_duty = (uint16_t)step_to_duty;
+            if(step_cycles > duty_delta){
+                pSegment[nb_segment].scale = 1;
+                pSegment[nb_segment].cycle_num = (uint16_t)LDRV_MIN(step_cycles / duty_delta, LDRV_MAX_FADE_CYCLES);
+            }
+            else{
+                pSegment[nb_segment].scale = (uint16_t)LDRV_MIN(duty_delta / step_cycles, LDRV_MAX_FADE_SCALE);
+                pSegment[nb_segment].cycle_num = 1;
+            }
+            nb_segment++;
+        }
+
+        step_from_duty = step_to_duty;
+    }
+
+    return nb_segment;
+}
+
+/***************************************************************************//*!
+*  \brief Start segment.
+*
+*   Start the current segment of a sequence channel.
+*
+*   Preconditions: Called with sequence_spinlock taken.
+*
+*   Side Effects: None.
+*
+*   \param[in]  pSequence           Pointer to the sequence
+*   \param[in]  slot                Sequence channel index
+*
+*   \return     (True -> started / False -> channel busy or error)
+*
+*******************************************************************************/
+static bool IRAM_ATTR startSegment(LDRV_Sequence_t *pSequence, uint8_t slot){
+
+    const LDRV_Segment_t *pSegment = &pSequence->segment[slot][pSequence->index[slot]];
+
+    if(ESP_OK != ledc_set_fade_step_and_start_isr(LDRV_TIMER_MODE,
+                                                  pSequence->channel[slot],
+                                                  pSegment->target_duty,
+                                                  pSegment->scale,
+                                                  pSegment->cycle_num)){
+        pSequence->stats.nb_errors++;
+        return false;
+    }
+
+    pSequence->stats.nb_segments++;
+    return true;
+}
+
+/***************************************************************************//*!
+*  \brief Restart sequence.
+*
+*   Start the first segment of all the sequence channels in one batch (same
+*   PWM period). If a channel is still busy, the others are started one by
+*   one. The sequence stops if no channel could be started.
+*
+*   Preconditions: Called with sequence_spinlock taken.
+*
+*   Side Effects: None.
+*
+*   \param[in]  pSequence           Pointer to the sequence
+*
+*******************************************************************************/
+static void IRAM_ATTR restartSequence(LDRV_Sequence_t *pSequence){
+
+    ledc_batch_param_t batch[LDRV_CFG_MAX_NB_CHANNEL];
+
+    pSequence->playing_mask = 0;
+
+    for(uint8_t slot=0; slot<pSequence->nb_channels; slot++){
+        pSequence->index[slot] = 0;
+        batch[slot].channel = pSequence->channel[slot];
+        batch[slot].target_duty = pSequence->segment[slot][0].target_duty;
+        batch[slot].scale = pSequence->segment[slot][0].scale;
+        batch[slot].cycle_num = pSequence->segment[slot][0].cycle_num;
+    }
+
+    //All channels latched on the same PWM period
+    if(ESP_OK == ledc_set_batch_and_update_isr(LDRV_TIMER_MODE, pSequence->timer, batch, pSequence->nb_channels)){
+        pSequence->playing_mask = LDRV_SLOT_BIT(pSequence->nb_channels) - 1;
+        pSequence->stats.nb_segments += pSequence->nb_channels;
+        return;
+    }
+
+    //A channel still busy: start the others one by one
+    pSequence->stats.nb_errors++;
+    for(uint8_t slot=0; slot<pSequence->nb_channels; slot++){
+        if(startSegment(pSequence, slot))   pSequence->playing_mask |= LDRV_SLOT_BIT(slot);
+    }
 
+    if(pSequence->playing_mask == 0)    pSequence->is_running = false;
+}
 
 /******************************************************************************
 *   CallBack Functions implementation
 *******************************************************************************/
+/***************************************************************************//*!
+*  \brief Fade end callback.
+*
+*   Called by the LEDC fade end ISR of a sequence channel: start the next
+*   segment of the channel. At the end of the loop the channel waits for the
+*   others, the last one restarts all of them (no drift between channels).
+*
+*******************************************************************************/
+static bool IRAM_ATTR fadeEndCallback(const ledc_cb_param_t *param, void *user_arg){
+
+    uint32_t start_cycles = esp_cpu_get_cycle_count();
+    const LDRV_Slot_Context_t *pContext = (const LDRV_Slot_Context_t *)user_arg;
+    LDRV_Sequence_t *pSequence = &sequence[pContext->led_index];
+    uint8_t slot = pContext->slot;
+    bool is_started = false;
+
+    portENTER_CRITICAL_ISR(&sequence_spinlock);
+
+    //Stopped, or end of a fade not started by the sequence
+    if((pSequence->is_running == false) || ((pSequence->playing_mask & LDRV_SLOT_BIT(slot)) == 0)){
+        portEXIT_CRITICAL_ISR(&sequence_spinlock);
+        return false;
+    }
+
+    if((pSequence->index[slot] + 1) < pSequence->nb_segment[slot]){
+        pSequence->index[slot]++;
+        is_started = startSegment(pSequence, slot);
+    }
+
+    if(is_started == false){
+        pSequence->playing_mask &= ~LDRV_SLOT_BIT(slot);
+
+        if(pSequence->playing_mask == 0){
+            pSequence->stats.nb_loops++;
+
+            if(pSequence->nb_loops == 1){
+                pSequence->is_running = false;
+            }
+            else{
+                if(pSequence->nb_loops > 1)     pSequence->nb_loops--;
+                restartSequence(pSequence);
+            }
+        }
+    }
+
+    uint32_t cycles = esp_cpu_get_cycle_count() - start_cycles;
+    pSequence->stats.total_isr_cycles += cycles;
+    if(cycles > pSequence->stats.max_isr_cycles)    pSequence->stats.max_isr_cycles = cycles;
 
+    portEXIT_CRITICAL_ISR(&sequence_spinlock);
+
+    return false;
+}
 
 /******************************************************************************
 *   Public Functions Definitions
@@ -69,7 +531,7 @@ static SemaphoreHandle_t ldrv_mutex_handle = NULL;
 *******************************************************************************/
 LDRV_CFG_Ret_t LDRV_CFG_InitDriver(void){
 
-    ldrv_mutex_handle = xSemaphoreCreateMutex();
+    ldrv_mutex_handle = xSemaphoreCreateMutexStatic(&ldrv_mutex_buffer);
     if(ldrv_mutex_handle == NULL){
         return LDRV_CFG_STATUS_ERROR;
     }
@@ -148,14 +610,9 @@ LDRV_CFG_Ret_t LDRV_CFG_SetuptLedSingle(LDRV_CFG_Single_Config_t *pConfig){
 LDRV_CFG_Ret_t LDRV_CFG_SetupLedSinglePwm(LDRV_CFG_Single_Pwm_Config_t *pConfig){
 
     //Config ledc 
-    ledc_timer_config_t ledc_timer = {
-        .speed_mode = LDRV_TIMER_MODE,
-        .duty_resolution = LDRV_DEFAULT_DUTY_RES,
-        .timer_num = pConfig->led_timer,
-        .freq_hz = LDRV_DEFAULT_FREQ_HZ,
-        .clk_cfg = LEDC_USE_XTAL_CLK,
-    };
-    ledc_timer_config(&ledc_timer);
+    if(LDRV_CFG_STATUS_OK != configTimer(pConfig->led_timer, LDRV_DEFAULT_FREQ_HZ)){
+        return LDRV_CFG_STATUS_ERROR;
+    }
 
     ledc_channel_config_t ledc_channel = {
         .speed_mode = LDRV_TIMER_MODE,
@@ -163,11 +620,9 @@ LDRV_CFG_Ret_t LDRV_CFG_SetupLedSinglePwm(LDRV_CFG_Single_Pwm_Config_t *pConfig)
         .timer_sel = pConfig->led_timer,
         .intr_type = LEDC_INTR_DISABLE,
         .gpio_num = pConfig->gpio_num,
-        .duty = LDRV_CFG_MIN_PWM_DUTY,
+        .duty = levelToDuty(LDRV_CFG_MIN_PWM_DUTY, pConfig->active_level, pConfig->led_timer),
         .hpoint = 0,
     };
-    ///Inverse duty cycle min value if active low
-    if(pConfig->active_level == LDRV_CFG_ACTIVE_LOW)   ledc_channel.duty = LDRV_CFG_MAX_PWM_DUTY;
 
     ledc_channel_config(&ledc_channel);
 
@@ -191,14 +646,9 @@ LDRV_CFG_Ret_t LDRV_CFG_SetupLedSinglePwm(LDRV_CFG_Single_Pwm_Config_t *pConfig)
 LDRV_CFG_Ret_t LDRV_CFG_SetupLedRgb(LDRV_CFG_Rgb_Config_t *pConfig){
 
     //config ledc timer 
-    ledc_timer_config_t ledc_timer = {
-        .speed_mode = LDRV_TIMER_MODE,
-        .duty_resolution = LDRV_DEFAULT_DUTY_RES,
-        .timer_num = pConfig->led_timer,
-        .freq_hz = LDRV_DEFAULT_FREQ_HZ,
-        .clk_cfg = LEDC_USE_XTAL_CLK,
-    };
-    ledc_timer_config(&ledc_timer);
+    if(LDRV_CFG_STATUS_OK != configTimer(pConfig->led_timer, LDRV_DEFAULT_FREQ_HZ)){
+        return LDRV_CFG_STATUS_ERROR;
+    }
 
     //config ledc channels
     ledc_channel_config_t rgb_channel = {
@@ -207,11 +657,9 @@ LDRV_CFG_Ret_t LDRV_CFG_SetupLedRgb(LDRV_CFG_Rgb_Config_t *pConfig){
         .timer_sel = pConfig->led_timer,
         .intr_type = LEDC_INTR_DISABLE,
         .gpio_num = pConfig->red_gpio_num,
-        .duty = LDRV_CFG_MIN_PWM_DUTY,
+        .duty = levelToDuty(LDRV_CFG_MIN_PWM_DUTY, pConfig->active_level, pConfig->led_timer),
         .hpoint = 0,
     };
-    //Inverse duty cycle min value if active low
-    if(pConfig->active_level == LDRV_CFG_ACTIVE_LOW)  rgb_channel.duty = LDRV_CFG_MAX_PWM_DUTY;
     ledc_channel_config(&rgb_channel);
 
     rgb_channel.channel = pConfig->green_channel;
@@ -260,21 +708,30 @@ LDRV_CFG_Ret_t LDRV_CFG_SetLedSingleState(uint8_t state,
 /***************************************************************************//*!
 *  \brief Set single led pwm duty-cycle.
 *
-*   Set the duty-cycle of a single led.
+*   Set the duty-cycle of a single led from a perceptual level (gamma
+*   corrected, active level applied). The led sequence is stopped.
 *   
 *   Preconditions: None.
 *
 *   Side Effects: None.
 *
-*   \param[in]  duty                Led duty-cycle
+*   \param[in]  duty                Led level (0 to LDRV_CFG_MAX_PWM_DUTY)
+*   \param[in]  led_index           Led index (sequence of the led)
 *   \param[in]  pConfig             Pointer to led configuration
 *
 *   \return     Operation status
 *
 *******************************************************************************/
 LDRV_CFG_Ret_t LDRV_CFG_SetLedSinglePwmDuty(uint32_t duty, 
+                                            uint8_t led_index,
                                             LDRV_CFG_Single_Pwm_Config_t *pConfig){
 
+    if(LDRV_CFG_STATUS_OK != LDRV_CFG_StopSequence(led_index)){
+        return LDRV_CFG_STATUS_ERROR;
+    }
+
+    duty = levelToDuty(duty, pConfig->active_level, pConfig->led_timer);
+
     if(ESP_OK != ledc_set_duty(LDRV_TIMER_MODE, pConfig->led_channel, duty)){
         return LDRV_CFG_STATUS_ERROR;
     }
@@ -291,14 +748,16 @@ LDRV_CFG_Ret_t LDRV_CFG_SetLedSinglePwmDuty(uint32_t duty,
 /***************************************************************************//*!
 *  \brief Fade the duty-cycle of a single led.
 *
-*   Fade the duty-cycle to a target value over an amount of time (in ms).
+*   Fade the level to a target value over an amount of time (in ms). The
+*   fade is perceptually linear (one shot sequence of the led).
 *   
-*   Preconditions: None.
+*   Preconditions: Fade service started.
 *
 *   Side Effects: None.
 *
-*   \param[in]  target_duty         Final duty-cycle
+*   \param[in]  target_duty         Final level (0 to LDRV_CFG_MAX_PWM_DUTY)
 *   \param[in]  fade_time_ms        Fade time in ms
+*   \param[in]  led_index           Led index (sequence of the led)
 *   \param[in]  pConfig             Pointer to led configuration
 *
 *   \return     Operation status
@@ -306,32 +765,34 @@ LDRV_CFG_Ret_t LDRV_CFG_SetLedSinglePwmDuty(uint32_t duty,
 *******************************************************************************/
 LDRV_CFG_Ret_t LDRV_CFG_FadeLedSinglePwmDuty(uint32_t target_duty, 
                                              uint32_t fade_time_ms, 
+                                             uint8_t led_index,
                                              LDRV_CFG_Single_Pwm_Config_t *pConfig){
 
-    if(ESP_OK != ledc_set_fade_time_and_start(LDRV_TIMER_MODE, 
-                                              pConfig->led_channel, 
-                                              target_duty, 
-                                              fade_time_ms, 
-                                              LEDC_FADE_NO_WAIT)){
-
-        return LDRV_CFG_STATUS_ERROR;
-    }
+    LDRV_CFG_Keyframe_t keyframe = {
+        .level = {target_duty},
+        .time_ms = fade_time_ms,
+        .is_fade = true,
+    };
 
-    return LDRV_CFG_STATUS_OK;
+    return LDRV_CFG_StartSequence(led_index, &keyframe, 1, 1, &pConfig->led_channel, 1,
+                                  pConfig->led_timer, pConfig->active_level);
 }
 
 /***************************************************************************//*!
 *  \brief Set RGB led pwm duty-cycles.
 *
-*   Set the duty-cycles of a RGB led.
+*   Set the duty-cycles of a RGB led from perceptual levels (gamma
+*   corrected, active level applied). The 3 channels change on the same
+*   PWM period. The led sequence is stopped.
 *   
 *   Preconditions: None.
 *
 *   Side Effects: None.
 *
-*   \param[in]  red_duty            RGB red duty-cycle
-*   \param[in]  green_duty          RGB green duty-cycle
-*   \param[in]  blue_duty           RGB blue duty-cycle
+*   \param[in]  red_duty            RGB red level
+*   \param[in]  green_duty          RGB green level
+*   \param[in]  blue_duty           RGB blue level
+*   \param[in]  led_index           Led index (sequence of the led)
 *   \param[in]  pConfig             Pointer to led configuration
 *
 *   \return     Operation status
@@ -340,37 +801,27 @@ LDRV_CFG_Ret_t LDRV_CFG_FadeLedSinglePwmDuty(uint32_t target_duty,
 LDRV_CFG_Ret_t LDRV_CFG_SetLedRgbColor(uint32_t red_duty, 
                                        uint32_t green_duty, 
                                        uint32_t blue_duty, 
+                                       uint8_t led_index,
                                        LDRV_CFG_Rgb_Config_t *pConfig){
 
-    //set and update red rgb duty-cycle
-    if(ESP_OK != ledc_set_duty(LDRV_TIMER_MODE, pConfig->red_channel, red_duty)){
+    if(LDRV_CFG_STATUS_OK != LDRV_CFG_StopSequence(led_index)){
         return LDRV_CFG_STATUS_ERROR;
     }
-    else{
-        if(ESP_OK != ledc_update_duty(LDRV_TIMER_MODE, pConfig->red_channel)){
-            return LDRV_CFG_STATUS_ERROR;
-        }
-    }
 
-    //set and update green duty-cycle
-    if(ESP_OK != ledc_set_duty(LDRV_TIMER_MODE, pConfig->green_channel, green_duty)){
-        return LDRV_CFG_STATUS_ERROR;
-    }   
-    else{
-        if(ESP_OK != ledc_update_duty(LDRV_TIMER_MODE, pConfig->green_channel)){
-            return LDRV_CFG_STATUS_ERROR;
-        }
-    } 
+    red_duty = levelToDuty(red_duty, pConfig->active_level, pConfig->led_timer);
+    green_duty = levelToDuty(green_duty, pConfig->active_level, pConfig->led_timer);
+    blue_duty = levelToDuty(blue_duty, pConfig->active_level, pConfig->led_timer);
+
+    //Set and latch the 3 duty-cycles on the same PWM period
+    const ledc_batch_param_t batch[] = {
+        {.channel = pConfig->red_channel, .target_duty = red_duty},
+        {.channel = pConfig->green_channel, .target_duty = green_duty},
+        {.channel = pConfig->blue_channel, .target_duty = blue_duty},
+    };
 
-    //set and update blue duty-cycle
-    if(ESP_OK != ledc_set_duty(LDRV_TIMER_MODE, pConfig->blue_channel, blue_duty)){
+    if(ESP_OK != ledc_set_batch_and_update(LDRV_TIMER_MODE, pConfig->led_timer, batch, 3)){
         return LDRV_CFG_STATUS_ERROR;
     }
-    else{
-        if(ESP_OK != ledc_update_duty(LDRV_TIMER_MODE, pConfig->blue_channel)){
-            return LDRV_CFG_STATUS_ERROR;
-        }
-    }
 
     return LDRV_CFG_STATUS_OK;
 }
@@ -378,16 +829,18 @@ LDRV_CFG_Ret_t LDRV_CFG_SetLedRgbColor(uint32_t red_duty,
 /***************************************************************************//*!
 *  \brief Fade the duty-cycles of a RGB led.
 *
-*   Fade the duty-cycles to target values over an amount of time (in ms).
+*   Fade the levels to target values over an amount of time (in ms). The
+*   fade is perceptually linear (one shot sequence of the led).
 *   
-*   Preconditions: None.
+*   Preconditions: Fade service started.
 *
 *   Side Effects: None.
 *
-*   \param[in]  target_red_duty         Final RGB red duty-cycle
-*   \param[in]  target_green_duty       Final RGB green duty-cycle 
-*   \param[in]  target_blue_duty        Final RGB blue duty-cycle
+*   \param[in]  target_red_duty         Final RGB red level
+*   \param[in]  target_green_duty       Final RGB green level
+*   \param[in]  target_blue_duty        Final RGB blue level
 *   \param[in]  fade_time_ms            Fade time in ms
+*   \param[in]  led_index               Led index (sequence of the led)
 *   \param[in]  pConfig                 Pointer to led configuration
 *
 *   \return     Operation status
@@ -397,45 +850,26 @@ LDRV_CFG_Ret_t LDRV_CFG_FadeLedRgbColor(uint32_t target_red_duty,
                                         uint32_t target_green_duty,
                                         uint32_t target_blue_duty,
                                         uint32_t fade_time_ms,
+                                        uint8_t led_index,
                                         LDRV_CFG_Rgb_Config_t *pConfig){
 
-    //Start red rgb fade
-    if(ESP_OK != ledc_set_fade_time_and_start(LDRV_TIMER_MODE, 
-                                              pConfig->red_channel, 
-                                              target_red_duty, 
-                                              fade_time_ms, 
-                                              LEDC_FADE_NO_WAIT)){
-
-        return LDRV_CFG_STATUS_ERROR;
-    }
-
-    //Start green rgb fade
-    if(ESP_OK != ledc_set_fade_time_and_start(LDRV_TIMER_MODE, 
-                                              pConfig->green_channel, 
-                                              target_green_duty, 
-                                              fade_time_ms, 
-                                              LEDC_FADE_NO_WAIT)){
+    const ledc_channel_t channels[] = {pConfig->red_channel, pConfig->green_channel, pConfig->blue_channel};
 
-        return LDRV_CFG_STATUS_ERROR;
-    }
-
-    //Start blue rgb fade
-    if(ESP_OK != ledc_set_fade_time_and_start(LDRV_TIMER_MODE, 
-                                              pConfig->blue_channel, 
-                                              target_blue_duty, 
-                                              fade_time_ms, 
-                                              LEDC_FADE_NO_WAIT)){
-
-        return LDRV_CFG_STATUS_ERROR;
-    }
+    LDRV_CFG_Keyframe_t keyframe = {
+        .level = {target_red_duty, target_green_duty, target_blue_duty},
+        .time_ms = fade_time_ms,
+        .is_fade = true,
+    };
 
-    return LDRV_CFG_STATUS_OK;
+    return LDRV_CFG_StartSequence(led_index, &keyframe, 1, 1, channels, 3,
+                                  pConfig->led_timer, pConfig->active_level);
 }
 
 /***************************************************************************//*!
 *  \brief Set single led pwm frequency
 *
-*   Set PWM frequency of a single led.
+*   Set PWM frequency of a single led. The timer runs at the highest duty
+*   resolution the clock allows for this frequency.
 *   
 *   Preconditions: None.
 *
@@ -450,7 +884,7 @@ LDRV_CFG_Ret_t LDRV_CFG_FadeLedRgbColor(uint32_t target_red_duty,
 LDRV_CFG_Ret_t LDRV_CFG_SetLedSinglePwmFreq(uint32_t freq_hz, 
                                             LDRV_CFG_Single_Pwm_Config_t *pConfig){
 
-    if(ESP_OK != ledc_set_freq(LDRV_TIMER_MODE, pConfig->led_timer, freq_hz)){
+    if(LDRV_CFG_STATUS_OK != configTimer(pConfig->led_timer, freq_hz)){
         return LDRV_CFG_STATUS_ERROR;
     }
 
@@ -460,7 +894,8 @@ LDRV_CFG_Ret_t LDRV_CFG_SetLedSinglePwmFreq(uint32_t freq_hz,
 /***************************************************************************//*!
 *  \brief Set RGB led pwms frequency
 *
-*   Set PWMs frequency of a RGB led.
+*   Set PWMs frequency of a RGB led. The timer runs at the highest duty
+*   resolution the clock allows for this frequency.
 *   
 *   Preconditions: None.
 *
@@ -475,7 +910,7 @@ LDRV_CFG_Ret_t LDRV_CFG_SetLedSinglePwmFreq(uint32_t freq_hz,
 LDRV_CFG_Ret_t LDRV_CFG_SetLedRgbFreq(uint32_t freq_hz, 
                                       LDRV_CFG_Rgb_Config_t *pConfig){
 
-    if(ESP_OK != ledc_set_freq(LDRV_TIMER_MODE, pConfig->led_timer, freq_hz)){
+    if(LDRV_CFG_STATUS_OK != configTimer(pConfig->led_timer, freq_hz)){
         return LDRV_CFG_STATUS_ERROR;
     }
 
@@ -528,6 +963,179 @@ LDRV_CFG_Ret_t LDRV_CFG_GetLedRgbFreq(uint32_t *pFreq_hz,
     return LDRV_CFG_STATUS_OK;
 }
 
+/***************************************************************************//*!
+*  \brief Start led sequence
+*
+*   Compile the keyframes into LEDC hardware fade segments (step, cycles per
+*   step, hold time) and start playing them on the given channels. Levels
+*   are gamma corrected, a fade is split in linear segments along the gamma
+*   curve (perceptually linear). The next segment of each channel is
+*   started from the LEDC fade end interrupt: no task runs while the
+*   sequence plays. The channels resynchronize at the end of each loop.
+*   Each led has its own sequence, the running one is stopped first.
+*
+*   Preconditions: Fade service started, channels configured on timer.
+*
+*   Side Effects: Fade end callback of the channels replaced.
+*
+*   \param[in]  led_index           Led index (one sequence per led)
+*   \param[in]  pKeyframes          Pointer to the keyframes (level per channel)
+*   \param[in]  nb_keyframes        Number of keyframes
+*   \param[in]  nb_loops            Number of loops (0 -> forever)
+*   \param[in]  pChannels           Pointer to the ledc channels
+*   \param[in]  nb_channels         Number of channels
+*   \param[in]  timer               Ledc timer of the channels
+*   \param[in]  active_level        Led active level
+*
+*   \return     Operation status
+*
+*******************************************************************************/
+LDRV_CFG_Ret_t LDRV_CFG_StartSequence(uint8_t led_index,
+                                      const LDRV_CFG_Keyframe_t *pKeyframes,
+                                      uint8_t nb_keyframes,
+                                      uint32_t nb_loops,
+                                      const ledc_channel_t *pChannels,
+                                      uint8_t nb_channels,
+                                      ledc_timer_t timer,
+                                      LDRV_CFG_Active_Level_t active_level){
+
+    if(led_index >= LDRV_CFG_MAX_NB_LED)    return LDRV_CFG_STATUS_ERROR;
+    if((pKeyframes == NULL) || (nb_keyframes == 0) || (nb_keyframes > LDRV_CFG_MAX_NB_KEYFRAME))     return LDRV_CFG_STATUS_ERROR;
+    if((pChannels == NULL) || (nb_channels == 0) || (nb_channels > LDRV_CFG_MAX_NB_CHANNEL))        return LDRV_CFG_STATUS_ERROR;
+
+    LDRV_Sequence_t *pSequence = &sequence[led_index];
+
+    if(LDRV_CFG_STATUS_OK != LDRV_CFG_StopSequence(led_index)){
+        return LDRV_CFG_STATUS_ERROR;
+    }
+
+    uint32_t freq_hz = ledc_get_freq(LDRV_TIMER_MODE, timer);
+    if((freq_hz == 0) || (timer_duty_res[timer] == 0))  return LDRV_CFG_STATUS_ERROR;
+
+    //Compile while stopped (not read by the fade end ISR)
+    for(uint8_t slot=0; slot<nb_channels; slot++){
+
+        //Sequence loops: the first keyframe starts from the last one
+        //One shot: the first keyframe starts from the current duty
+        uint32_t from_level = pKeyframes[nb_keyframes - 1].level[slot];
+        if(nb_loops == 1){
+            from_level = dutyToLevel(ledc_get_duty(LDRV_TIMER_MODE, pChannels[slot]), active_level, timer);
+        }
+
+        uint8_t nb_segment = 0;
+
+        for(uint8_t i=0; i<nb_keyframes; i++){
+            uint32_t to_level = LDRV_MIN(pKeyframes[i].level[slot], LDRV_CFG_MAX_PWM_DUTY);
+            uint8_t nb_compiled = compileKeyframe(from_level,
+                                                  to_level,
+                                                  &pKeyframes[i],
+                                                  freq_hz,
+                                                  active_level,
+                                                  timer,
+                                                  &pSequence->segment[slot][nb_segment],
+                                                  LDRV_CFG_MAX_NB_SEGMENT - nb_segment);
+            if(nb_compiled == 0)    return LDRV_CFG_STATUS_ERROR;
+
+            nb_segment += nb_compiled;
+            from_level = to_level;
+        }
+
+        pSequence->nb_segment[slot] = nb_segment;
+        pSequence->channel[slot] = pChannels[slot];
+        slot_context[led_index][slot].led_index = led_index;
+        slot_context[led_index][slot].slot = slot;
+    }
+
+    for(uint8_t slot=0; slot<nb_channels; slot++){
+
+        ledc_cbs_t callbacks = {.fade_cb = fadeEndCallback};
+
+        //Fade left running by the fade API
+        if((ESP_OK != ledc_fade_stop(LDRV_TIMER_MODE, pChannels[slot])) ||
+           (ESP_OK != ledc_cb_register(LDRV_TIMER_MODE, pChannels[slot], &callbacks, &slot_context[led_index][slot]))){
+            return LDRV_CFG_STATUS_ERROR;
+        }
+    }
+
+    portENTER_CRITICAL(&sequence_spinlock);
+    memset(&pSequence->stats, 0, sizeof(pSequence->stats));
+    pSequence->nb_channels = nb_channels;
+    pSequence->timer = timer;
+    pSequence->nb_loops = nb_loops;
+    pSequence->is_running = true;
+    restartSequence(pSequence);
+    bool is_running = pSequence->is_running;
+    portEXIT_CRITICAL(&sequence_spinlock);
+
+    return is_running ? LDRV_CFG_STATUS_OK : LDRV_CFG_STATUS_ERROR;
+}
+
+/***************************************************************************//*!
+*  \brief Stop led sequence
+*
+*   Stop the running sequence of a led, the channels keep their current
+*   duty.
+*
+*   Preconditions: None.
+*
+*   Side Effects: None.
+*
+*   \param[in]  led_index           Led index
+*
+*   \return     Operation status
+*
+*******************************************************************************/
+LDRV_CFG_Ret_t LDRV_CFG_StopSequence(uint8_t led_index){
+
+    if(led_index >= LDRV_CFG_MAX_NB_LED)    return LDRV_CFG_STATUS_ERROR;
+
+    LDRV_Sequence_t *pSequence = &sequence[led_index];
+
+    portENTER_CRITICAL(&sequence_spinlock);
+    bool was_running = pSequence->is_running;
+    pSequence->is_running = false;
+    uint8_t nb_channels = pSequence->nb_channels;
+    portEXIT_CRITICAL(&sequence_spinlock);
+
+    if(was_running == false)    return LDRV_CFG_STATUS_OK;
+
+    //No segment started past this point: stop the ones in progress
+    for(uint8_t slot=0; slot<nb_channels; slot++){
+        if(ESP_OK != ledc_fade_stop(LDRV_TIMER_MODE, pSequence->channel[slot])){
+            return LDRV_CFG_STATUS_ERROR;
+        }
+    }
+
+    return LDRV_CFG_STATUS_OK;
+}
+
+/***************************************************************************//*!
+*  \brief Get led sequence statistics
+*
+*   Get the statistics of the current (or last) sequence of a led.
+*
+*   Preconditions: None.
+*
+*   Side Effects: None.
+*
+*   \param[in]  led_index           Led index
+*   \param[out] pStats              Pointer to store the statistics
+*
+*   \return     Operation status
+*
+*******************************************************************************/
+LDRV_CFG_Ret_t LDRV_CFG_GetSequenceStats(uint8_t led_index, LDRV_CFG_Sequence_Stats_t *pStats){
+
+    if((led_index >= LDRV_CFG_MAX_NB_LED) || (pStats == NULL))  return LDRV_CFG_STATUS_ERROR;
+
+    portENTER_CRITICAL(&sequence_spinlock);
+    *pStats = sequence[led_index].stats;
+    pStats->is_running = sequence[led_index].is_running;
+    portEXIT_CRITICAL(&sequence_spinlock);
+
+    return LDRV_CFG_STATUS_OK;
+}
+
 /***************************************************************************//*!
 *  \brief Take led driver mutex
 *
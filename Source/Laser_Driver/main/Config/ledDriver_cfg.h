@@ -2,15 +2,20 @@
 #define __LED_DRIVER_CFG_H
 
 #include <stdint.h>
+#include <stdbool.h>
 #include "driver/ledc.h"
 
 /******************************************************************************
 *   Public Definitions
 *******************************************************************************/
 #define LDRV_CFG_MAX_NB_LED                 (3)
-#define LDRV_CFG_MAX_PWM_DUTY               (255)
+#define LDRV_CFG_MAX_PWM_DUTY               (255)//Perceptual level, gamma corrected to the LEDC duty
 #define LDRV_CFG_MIN_PWM_DUTY               (0)
 
+#define LDRV_CFG_MAX_NB_CHANNEL             (3)//Channels per led (RGB)
+#define LDRV_CFG_MAX_NB_KEYFRAME            (16)//Keyframes per sequence
+#define LDRV_CFG_MAX_NB_SEGMENT             (64)//Hardware fade segments per channel
+
 /******************************************************************************
 *   Public Macros
 *******************************************************************************/
@@ -50,6 +55,22 @@ typedef struct LDRV_CFG_Rgb_Config_s{
     ledc_channel_t blue_channel;
 }LDRV_CFG_Rgb_Config_t;
 
+//Sequence keyframe: the channels reach level at the end of the keyframe
+typedef struct LDRV_CFG_Keyframe_s{
+    uint32_t level[LDRV_CFG_MAX_NB_CHANNEL];//0 to LDRV_CFG_MAX_PWM_DUTY
+    uint32_t time_ms;
+    bool is_fade;                       //Perceptual fade from the previous keyframe, else set and hold
+}LDRV_CFG_Keyframe_t;
+
+typedef struct LDRV_CFG_Sequence_Stats_s{
+    bool is_running;
+    uint32_t nb_segments;               //Hardware segments chained from the fade end ISR
+    uint32_t nb_loops;                  //Sequence loops completed
+    uint32_t nb_errors;                 //Segment start failures
+    uint32_t max_isr_cycles;            //Longest fade end callback
+    uint64_t total_isr_cycles;          //CPU cycles spent in the fade end callback
+}LDRV_CFG_Sequence_Stats_t;
+
 typedef enum LDRV_CFG_Ret_e{
     LDRV_CFG_STATUS_ERROR,
     LDRV_CFG_STATUS_OK,
@@ -166,32 +187,37 @@ LDRV_CFG_Ret_t LDRV_CFG_SetLedSingleState(uint8_t state,
 /***************************************************************************//*!
 *  \brief Set single led pwm duty-cycle.
 *
-*   Set the duty-cycle of a single led.
+*   Set the duty-cycle of a single led from a perceptual level (gamma
+*   corrected, active level applied). The led sequence is stopped.
 *   
 *   Preconditions: None.
 *
 *   Side Effects: None.
 *
-*   \param[in]  duty                Led duty-cycle
+*   \param[in]  duty                Led level (0 to LDRV_CFG_MAX_PWM_DUTY)
+*   \param[in]  led_index           Led index (sequence of the led)
 *   \param[in]  pConfig             Pointer to led configuration
 *
 *   \return     Operation status
 *
 *******************************************************************************/
 LDRV_CFG_Ret_t LDRV_CFG_SetLedSinglePwmDuty(uint32_t duty, 
+                                            uint8_t led_index,
                                             LDRV_CFG_Single_Pwm_Config_t *pConfig);
 
 /***************************************************************************//*!
 *  \brief Fade the duty-cycle of a single led.
 *
-*   Fade the duty-cycle to a target value over an amount of time (in ms).
+*   Fade the level to a target value over an amount of time (in ms). The
+*   fade is perceptually linear (one shot sequence of the led).
 *   
-*   Preconditions: None.
+*   Preconditions: Fade service started.
 *
 *   Side Effects: None.
 *
-*   \param[in]  target_duty         Final duty-cycle
+*   \param[in]  target_duty         Final level (0 to LDRV_CFG_MAX_PWM_DUTY)
 *   \param[in]  fade_time_ms        Fade time in ms
+*   \param[in]  led_index           Led index (sequence of the led)
 *   \param[in]  pConfig             Pointer to led configuration
 *
 *   \return     Operation status
@@ -199,20 +225,24 @@ LDRV_CFG_Ret_t LDRV_CFG_SetLedSinglePwmDuty(uint32_t duty,
 *******************************************************************************/
 LDRV_CFG_Ret_t LDRV_CFG_FadeLedSinglePwmDuty(uint32_t target_duty, 
                                              uint32_t fade_time_ms, 
+                                             uint8_t led_index,
                                              LDRV_CFG_Single_Pwm_Config_t *pConfig);
 
 /***************************************************************************//*!
 *  \brief Set RGB led pwm duty-cycles.
 *
-*   Set the duty-cycles of a RGB led.
+*   Set the duty-cycles of a RGB led from perceptual levels (gamma
+*   corrected, active level applied). The 3 channels change on the same
+*   PWM period. The led sequence is stopped.
 *   
 *   Preconditions: None.
 *
 *   Side Effects: None.
 *
-*   \param[in]  red_duty            RGB red duty-cycle
-*   \param[in]  green_duty          RGB green duty-cycle
-*   \param[in]  blue_duty           RGB blue duty-cycle
+*   \param[in]  red_duty            RGB red level
+*   \param[in]  green_duty          RGB green level
+*   \param[in]  blue_duty           RGB blue level
+*   \param[in]  led_index           Led index (sequence of the led)
 *   \param[in]  pConfig             Pointer to led configuration
 *
 *   \return     Operation status
@@ -221,21 +251,24 @@ LDRV_CFG_Ret_t LDRV_CFG_FadeLedSinglePwmDuty(uint32_t target_duty,
 LDRV_CFG_Ret_t LDRV_CFG_SetLedRgbColor(uint32_t red_duty, 
                                        uint32_t green_duty, 
                                        uint32_t blue_duty, 
+                                       uint8_t led_index,
                                        LDRV_CFG_Rgb_Config_t *pConfig);
 
 /***************************************************************************//*!
 *  \brief Fade the duty-cycles of a RGB led.
 *
-*   Fade the duty-cycles to target values over an amount of time (in ms).
+*   Fade the levels to target values over an amount of time (in ms). The
+*   fade is perceptually linear (one shot sequence of the led).
 *   
-*   Preconditions: None.
+*   Preconditions: Fade service started.
 *
 *   Side Effects: None.
 *
-*   \param[in]  target_red_duty         Final RGB red duty-cycle
-*   \param[in]  target_green_duty       Final RGB green duty-cycle 
-*   \param[in]  target_blue_duty        Final RGB blue duty-cycle
+*   \param[in]  target_red_duty         Final RGB red level
+*   \param[in]  target_green_duty       Final RGB green level
+*   \param[in]  target_blue_duty        Final RGB blue level
 *   \param[in]  fade_time_ms            Fade time in ms
+*   \param[in]  led_index               Led index (sequence of the led)
 *   \param[in]  pConfig                 Pointer to led configuration
 *
 *   \return     Operation status
@@ -245,12 +278,14 @@ LDRV_CFG_Ret_t LDRV_CFG_FadeLedRgbColor(uint32_t target_red_duty,
                                         uint32_t target_green_duty,
                                         uint32_t target_blue_duty,
                                         uint32_t fade_time_ms,
+                                        uint8_t led_index,
                                         LDRV_CFG_Rgb_Config_t *pConfig);
 
 /***************************************************************************//*!
 *  \brief Set single led pwm frequency
 *
-*   Set PWM frequency of a single led.
+*   Set PWM frequency of a single led. The timer runs at the highest duty
+*   resolution the clock allows for this frequency.
 *   
 *   Preconditions: None.
 *
@@ -268,7 +303,8 @@ LDRV_CFG_Ret_t LDRV_CFG_SetLedSinglePwmFreq(uint32_t freq_hz,
 /***************************************************************************//*!
 *  \brief Set RGB led pwms frequency
 *
-*   Set PWMs frequency of a RGB led.
+*   Set PWMs frequency of a RGB led. The timer runs at the highest duty
+*   resolution the clock allows for this frequency.
 *   
 *   Preconditions: None.
 *
@@ -319,6 +355,76 @@ LDRV_CFG_Ret_t LDRV_CFG_GetLedSinglePwmFreq(uint32_t *pFreq_hz,
 LDRV_CFG_Ret_t LDRV_CFG_GetLedRgbFreq(uint32_t *pFreq_hz,
                                       LDRV_CFG_Rgb_Config_t *pConfig);
 
+/***************************************************************************//*!
+*  \brief Start led sequence
+*
+*   Compile the keyframes into LEDC hardware fade segments (step, cycles per
+*   step, hold time) and start playing them on the given channels. Levels
+*   are gamma corrected, a fade is split in linear segments along the gamma
+*   curve (perceptually linear). The next segment of each channel is
+*   started from the LEDC fade end interrupt: no task runs while the
+*   sequence plays. The channels resynchronize at the end of each loop.
+*   Each led has its own sequence, the running one is stopped first.
+*
+*   Preconditions: Fade service started, channels configured on timer.
+*
+*   Side Effects: Fade end callback of the channels replaced.
+*
+*   \param[in]  led_index           Led index (one sequence per led)
+*   \param[in]  pKeyframes          Pointer to the keyframes (level per channel)
+*   \param[in]  nb_keyframes        Number of keyframes
+*   \param[in]  nb_loops            Number of loops (0 -> forever)
+*   \param[in]  pChannels           Pointer to the ledc channels
+*   \param[in]  nb_channels         Number of channels
+*   \param[in]  timer               Ledc timer of the channels
+*   \param[in]  active_level        Led active level
+*
+*   \return     Operation status
+*
+*******************************************************************************/
+LDRV_CFG_Ret_t LDRV_CFG_StartSequence(uint8_t led_index,
+                                      const LDRV_CFG_Keyframe_t *pKeyframes,
+                                      uint8_t nb_keyframes,
+                                      uint32_t nb_loops,
+                                      const ledc_channel_t *pChannels,
+                                      uint8_t nb_channels,
+                                      ledc_timer_t timer,
+                                      LDRV_CFG_Active_Level_t active_level);
+
+/***************************************************************************//*!
+*  \brief Stop led sequence
+*
+*   Stop the running sequence of a led, the channels keep their current
+*   duty.
+*
+*   Preconditions: None.
+*
+*   Side Effects: None.
+*
+*   \param[in]  led_index           Led index
+*
+*   \return     Operation status
+*
+*******************************************************************************/
+LDRV_CFG_Ret_t LDRV_CFG_StopSequence(uint8_t led_index);
+
+/***************************************************************************//*!
+*  \brief Get led sequence statistics
+*
+*   Get the statistics of the current (or last) sequence of a led.
+*
+*   Preconditions: None.
+*
+*   Side Effects: None.
+*
+*   \param[in]  led_index           Led index
+*   \param[out] pStats              Pointer to store the statistics
+*
+*   \return     Operation status
+*
+*******************************************************************************/
+LDRV_CFG_Ret_t LDRV_CFG_GetSequenceStats(uint8_t led_index, LDRV_CFG_Sequence_Stats_t *pStats);
+
 /***************************************************************************//*!
 *  \brief Take led driver mutex
 *
@@ -0,0 +1,125 @@
+/******************************************************************************
+*   Includes
+*******************************************************************************/
+#include "currentRegulator.h"
+#include "currentBalancer.h"
+#include "menu_cfg.h"
+
+/******************************************************************************
+*   Private Definitions
+*******************************************************************************/
+#define ARRAY_SIZE(arr)                 (sizeof(arr) / sizeof(arr[0]))
+
+/******************************************************************************
+*   Private Macros
+*******************************************************************************/
+
+
+/******************************************************************************
+*   Private Data Types
+*******************************************************************************/
+
+
+/******************************************************************************
+*   Private Functions Declaration
+*******************************************************************************/
+static int32_t getPhaseSetpoint(CREG_Phase_t phase);
+static int32_t getPhaseASetpoint(void);
+static int32_t getPhaseBSetpoint(void);
+static bool setPhaseASetpoint(int32_t value);
+static bool setPhaseBSetpoint(int32_t value);
+static int32_t getTotalSetpoint(void);
+static bool setTotalSetpoint(int32_t value);
+
+/******************************************************************************
+*   Public Variables
+*******************************************************************************/
+
+
+/******************************************************************************
+*   Private Variables
+*******************************************************************************/
+//Add menu items inside the menu_item_table
+static const MENU_Item_t menu_item_table[] = {
+    {"Phase A",     "A", 0, CREG_MAX_SETPOINT_10MA,         1, 10, 2, getPhaseASetpoint, setPhaseASetpoint},
+    {"Phase B",     "A", 0, CREG_MAX_SETPOINT_10MA,         1, 10, 2, getPhaseBSetpoint, setPhaseBSetpoint},
+    {"Total",       "A", 0, CBAL_MAX_TOTAL_SETPOINT_10MA,   1, 10, 2, getTotalSetpoint,  setTotalSetpoint},
+};
+
+static const uint8_t nb_menu_item = ARRAY_SIZE(menu_item_table);
+
+/******************************************************************************
+*   Error Check
+*******************************************************************************/
+
+
+/******************************************************************************
+*   Private Functions Definitions
+*******************************************************************************/
+static int32_t getPhaseSetpoint(CREG_Phase_t phase){
+
+    CREG_Phase_Status_t status = {0};
+    CREG_GetPhaseStatus(phase, &status);
+    return status.setpoint_10ma;
+}
+
+static int32_t getPhaseASetpoint(void){
+
+    return getPhaseSetpoint(CREG_PHASE_A);
+}
+
+static int32_t getPhaseBSetpoint(void){
+
+    return getPhaseSetpoint(CREG_PHASE_B);
+}
+
+static bool setPhaseASetpoint(int32_t value){
+
+    return (CREG_STATUS_OK == CREG_SetSetpoint(CREG_PHASE_A, (int16_t)value));
+}
+
+static bool setPhaseBSetpoint(int32_t value){
+
+    return (CREG_STATUS_OK == CREG_SetSetpoint(CREG_PHASE_B, (int16_t)value));
+}
+
+static int32_t getTotalSetpoint(void){
+
+    int16_t total_10ma = 0;
+    CBAL_GetTotalSetpoint(&total_10ma);
+    return total_10ma;
+}
+
+static bool setTotalSetpoint(int32_t value){
+
+    return (CBAL_STATUS_OK == CBAL_SetTotalSetpoint((int16_t)value));
+}
+
+/******************************************************************************
+*   CallBack Functions implementation
+*******************************************************************************/
+
+
+/******************************************************************************
+*   Public Functions Definitions
+*******************************************************************************/
+/***************************************************************************//*!
+*  \brief Get menu item table.
+*
+*   This function return the menu items.
+*
+*   Preconditions: None.
+*
+*   Side Effects: None.
+*
+*   \return     Menu item table
+*
+*******************************************************************************/
+MENU_CFG_Items_Context_t MENU_CFG_GetItemTable(void){
+
+    return (MENU_CFG_Items_Context_t){.nb_item = nb_menu_item, .pTable = menu_item_table};
+}
+
+/******************************************************************************
+*   Interrupts
+*******************************************************************************/
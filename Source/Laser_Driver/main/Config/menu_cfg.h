@@ -0,0 +1,53 @@
+#ifndef __MENU_CFG_H
+#define __MENU_CFG_H
+
+#include <stdint.h>
+
+#include "menu.h"
+
+/******************************************************************************
+*   Public Definitions
+*******************************************************************************/
+#define MENU_CFG_TITLE                      "Laser driver"
+
+/******************************************************************************
+*   Public Macros
+*******************************************************************************/
+
+
+/******************************************************************************
+*   Public Data Types
+*******************************************************************************/
+typedef struct MENU_CFG_Items_Context_s{
+    const MENU_Item_t *pTable;
+    uint8_t nb_item;
+}MENU_CFG_Items_Context_t;
+
+/******************************************************************************
+*   Public Variables
+*******************************************************************************/
+
+
+/******************************************************************************
+*   Error Check
+*******************************************************************************/
+
+
+/******************************************************************************
+*   Public Functions Declarations
+*******************************************************************************/
+/***************************************************************************//*!
+*  \brief Get menu item table.
+*
+*   This function return the menu items.
+*
+*   Preconditions: None.
+*
+*   Side Effects: None.
+*
+*   \return     Menu item table
+*
+*******************************************************************************/
+MENU_CFG_Items_Context_t MENU_CFG_GetItemTable(void);
+
+#endif//__MENU_CFG_H
@@ -1,8 +1,12 @@
 /******************************************************************************
 *   Includes
 *******************************************************************************/
+#include <stdlib.h>
 #include <string.h>
+
 #include "myShell_cfg.h"
+#include "shellCommands.h"
+#include "shellJobs.h"
 
 /******************************************************************************
 *   Private Definitions
@@ -12,6 +16,12 @@
 /******************************************************************************
 *   Private Macros
 *******************************************************************************/
+//Table handler running a command on the shell workers (shellJobs.c) instead
+//of the listener task: long commands do not stop the input (Ctrl-C)
+#define SHELL_CFG_JOB(handler)                                                  \
+    static int handler##Job(int argc, char *argv[]){                            \
+        return (SHJOB_STATUS_OK == SHJOB_Submit(handler, argc, argv)) ? 0 : -1; \
+    }
 
 
 /******************************************************************************
@@ -22,6 +32,7 @@
 /******************************************************************************
 *   Private Functions Declaration
 *******************************************************************************/
+static bool parseInt(const char *pString, int32_t *pValue);
 
 
 /******************************************************************************
@@ -34,15 +45,67 @@
 *******************************************************************************/
 //Add shell commands inside the the shell_cmd_table 
 //The table should minimally contain the 'help' function.
+//Long commands run as jobs (xxxJob handlers), the others in the listener task.
+SHELL_CFG_JOB(SHCMD_RippleHandler)
+SHELL_CFG_JOB(SHCMD_LedHandler)
+SHELL_CFG_JOB(SHCMD_FmtHandler)
+SHELL_CFG_JOB(SHCMD_CoreHandler)
+SHELL_CFG_JOB(SHCMD_TasksHandler)
+SHELL_CFG_JOB(SHCMD_TraceHandler)
+SHELL_CFG_JOB(SHCMD_BenchHandler)
+
 static SHELL_Command_t shell_cmd_table[] = {
     {"help", SHELL_HelpHandler, "Lists all commands"},
+    {"ripple", SHCMD_RippleHandlerJob, "Bus ripple, phases in sync vs interleaved: ripple [duty] [nb_samples]"},
+    {"wave", SHCMD_WaveHandler, "Duty waveform playback: wave ramp|triangle|sine|stream|push|stop|stat"},
+    {"disp", SHCMD_DispHandler, "Status display: disp stat|text <line> <text>|clear"},
+    {"led", SHCMD_LedHandlerJob, "Status led effects: led blink|breathe|pulse|cycle|stop|stat|bench"},
+    {"com", SHCMD_ComHandler, "Shell port statistics: com stat|reset"},
+    {"tlm", SHCMD_TlmHandler, "Binary telemetry: tlm on|off|rate|adc|stat"},
+    {"fmt", SHCMD_FmtHandlerJob, "Text formatting: fmt bench [nb_rounds]"},
+    {"watch", SHCMD_WatchHandler, "Live readings: watch <fields|all> [rate_hz]|stop|stat"},
+    {"job", SHCMD_JobHandler, "Command jobs (<command> & in background, Ctrl-C): job list|kill <id>|stat|reset"},
+    {"core", SHCMD_CoreHandlerJob, "Core placement: core plan|bench [duration_ms]"},
+    {"tasks", SHCMD_TasksHandlerJob, "Task CPU, stack and latency statistics: tasks list|reset"},
+    {"trace", SHCMD_TraceHandlerJob, "Event trace (CSV dump): trace start [ring|once]|stop|dump|stat"},
+    {"bench", SHCMD_BenchHandlerJob, "Kernel micro-benchmarks (CSV): bench list|run [kernel|all] [nb_iterations]"},
 };
 
 static uint32_t nb_shell_cmd = ARRAY_SIZE(shell_cmd_table);
 
+/******************************************************************************
+*   Error Check
+*******************************************************************************/
+
 /******************************************************************************
 *   Private Functions Definitions
 *******************************************************************************/
+/***************************************************************************//*!
+*  \brief Parse integer.
+*
+*   This function parses a whole decimal or 0x hexadecimal integer.
+*
+*   Preconditions: None.
+*
+*   Side Effects: None.
+*
+*   \param[in]  pString             String.
+*   \param[out] pValue              Value.
+*
+*   \return     true if the whole string is a number.
+*
+*******************************************************************************/
+static bool parseInt(const char *pString, int32_t *pValue){
+
+    char *pEnd = NULL;
+    long value = strtol(pString, &pEnd, 0);
+
+    if((pEnd == pString) || (*pEnd != '\0'))   return false;
+    if((value < INT32_MIN) || (value > INT32_MAX))  return false;
+
+    *pValue = (int32_t)value;
+    return true;
+}
 
 
 /******************************************************************************
@@ -66,6 +129,85 @@ SHELL_Commands_Context_t SHELL_CFG_GetCommandTable(void){
     return (SHELL_Commands_Context_t){.nb_command = nb_shell_cmd, .pTable = shell_cmd_table};
 }
 
+/***************************************************************************//*!
+*  \brief Parse Shell command arguments.
+*
+*   This function parses the command arguments (argv[1] onward) against
+*   the command argument schema into typed values. Optional arguments not
+*   given get their default value.
+*
+*   Preconditions: None.
+*
+*   Side Effects: None.
+*
+*   \param[in]  pSchema             Argument schema.
+*   \param[in]  nb_args             Number of arguments in the schema.
+*   \param[in]  argc                Number of arguments (command included).
+*   \param[in]  argv                Arguments (command included).
+*   \param[out] pArgs               Typed arguments (nb_args).
+*
+*   \return     true if the arguments match the schema.
+*
+*******************************************************************************/
+bool SHELL_CFG_ParseArgs(const SHELL_CFG_Arg_Schema_t *pSchema, uint8_t nb_args,
+                         int argc, char *argv[], SHELL_CFG_Arg_t *pArgs){
+
+    if((pSchema == NULL) || (pArgs == NULL) || (argc < 1))  return false;
+
+    //Extra arguments
+    if((argc - 1) > nb_args)    return false;
+
+    for(uint8_t i=0; i<nb_args; i++){
+
+        const SHELL_CFG_Arg_Schema_t *pArg = &pSchema[i];
+        int arg = i + 1;
+
+        pArgs[i] = (SHELL_CFG_Arg_t){.is_set = false, .value = pArg->default_value, .pString = NULL};
+
+        if(arg >= argc){
+            if(!pArg->is_optional)  return false;
+            continue;
+        }
+
+        pArgs[i].is_set = true;
+        pArgs[i].pString = argv[arg];
+
+        switch(pArg->type){
+
+            case SHELL_CFG_ARG_INT:
+            {
+                if(!parseInt(argv[arg], &pArgs[i].value))   return false;
+                if((pArgs[i].value < pArg->min) || (pArgs[i].value > pArg->max))    return false;
+            }
+            break;
+
+            case SHELL_CFG_ARG_KEYWORD:
+            {
+                int32_t index = 0;
+
+                if(pArg->pKeywords == NULL) return false;
+
+                while((pArg->pKeywords[index] != NULL) && (strcmp(pArg->pKeywords[index], argv[arg]) != 0)){
+                    index++;
+                }
+
+                if(pArg->pKeywords[index] == NULL)  return false;
+                pArgs[i].value = index;
+            }
+            break;
+
+            case SHELL_CFG_ARG_STRING:
+            default:
+            {
+                //Raw argument only
+            }
+            break;
+        }
+    }
+
+    return true;
+}
+
 
 /******************************************************************************
 *   Interrupts
@@ -1,6 +1,8 @@
 #ifndef _MY_SHELL_CFG_H
 #define _MY_SHELL_CFG_H
 
+#include <stdbool.h>
+
 #include "myShell.h"
 
 /******************************************************************************
@@ -23,6 +25,28 @@ typedef struct SHELL_Commands_Context_s{
     uint32_t nb_command;
 }SHELL_Commands_Context_t;
 
+typedef enum SHELL_CFG_Arg_Type_e{
+    SHELL_CFG_ARG_INT,                  //Decimal or 0x hexadecimal, in [min, max]
+    SHELL_CFG_ARG_KEYWORD,              //Index in the keyword list
+    SHELL_CFG_ARG_STRING,
+}SHELL_CFG_Arg_Type_t;
+
+typedef struct SHELL_CFG_Arg_Schema_s{
+    const char *pName;
+    SHELL_CFG_Arg_Type_t type;
+    bool is_optional;                   //Only followed by optional arguments
+    int32_t min;
+    int32_t max;
+    int32_t default_value;              //Optional argument not given
+    const char * const *pKeywords;      //Keyword list (NULL terminated)
+}SHELL_CFG_Arg_Schema_t;
+
+typedef struct SHELL_CFG_Arg_s{
+    bool is_set;                        //Given on the command line
+    int32_t value;                      //Number or keyword index
+    const char *pString;                //Raw argument (NULL if not given)
+}SHELL_CFG_Arg_t;
+
 /******************************************************************************
 *   Public Variables
 *******************************************************************************/
@@ -51,4 +75,27 @@ typedef struct SHELL_Commands_Context_s{
 *******************************************************************************/
 SHELL_Commands_Context_t SHELL_CFG_GetCommandTable(void);
 
+/***************************************************************************//*!
+*  \brief Parse Shell command arguments.
+*
+*   This function parses the command arguments (argv[1] onward) against
+*   the command argument schema into typed values. Optional arguments not
+*   given get their default value.
+*
+*   Preconditions: None.
+*
+*   Side Effects: None.
+*
+*   \param[in]  pSchema             Argument schema.
+*   \param[in]  nb_args             Number of arguments in the schema.
+*   \param[in]  argc                Number of arguments (command included).
+*   \param[in]  argv                Arguments (command included).
+*   \param[out] pArgs               Typed arguments (nb_args).
+*
+*   \return     true if the arguments match the schema.
+*
+*******************************************************************************/
+bool SHELL_CFG_ParseArgs(const SHELL_CFG_Arg_Schema_t *pSchema, uint8_t nb_args,
+                         int argc, char *argv[], SHELL_CFG_Arg_t *pArgs);
+
 #endif//_MY_SHELL_CFG_H
\ No newline at end of file
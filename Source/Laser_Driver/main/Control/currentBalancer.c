@@ -0,0 +1,457 @@
+#include <string.h>
+
+#include "freertos/FreeRTOS.h"
+#include "freertos/semphr.h"
+
+#include "esp_log.h"
+
+#include "currentBalancer.h"
+#include "currentBalancer_cfg.h"
+
+/******************************************************************************
+*   Private Definitions
+*******************************************************************************/
+#define CBAL_SHARE_SHIFT                    (15)//Phase A share is Q15 internally
+#define CBAL_SHARE_ONE                      (1L<<CBAL_SHARE_SHIFT)
+#define CBAL_SHARE_FILTER_SHIFT             (2)//Share low pass (~4 periods)
+
+//Saturated phase: allowed current = measured current + margin
+#define CBAL_TRACKING_MARGIN_10MA           (5)
+
+#define LOG_LOCAL_LEVEL                     (ESP_LOG_INFO)
+
+/******************************************************************************
+*   Private Macros
+*******************************************************************************/
+#define MIN(a, b)                           (((a) < (b)) ? (a) : (b))
+
+/******************************************************************************
+*   Private Data Types
+*******************************************************************************/
+
+
+/******************************************************************************
+*   Private Functions Declaration
+*******************************************************************************/
+static int16_t computePhaseLimit(uint8_t phase, const CBAL_CFG_Phase_Meas_t *pMeas);
+static void balancePhases(void);
+
+/******************************************************************************
+*   Public Variables
+*******************************************************************************/
+
+
+/******************************************************************************
+*   Private Variables
+*******************************************************************************/
+static SemaphoreHandle_t cbal_mutex_handle = NULL;
+static StaticSemaphore_t cbal_mutex_buffer;
+
+static CBAL_Phase_Limits_t phase_limits[CBAL_CFG_NB_PHASE];
+
+//Total request, also set from the button scan context (must not block)
+static int16_t total_request_10ma = 0;
+static portMUX_TYPE cbal_spinlock = portMUX_INITIALIZER_UNLOCKED;
+
+static int32_t share_a_q15 = CBAL_SHARE_ONE/2;
+static bool is_running = false;
+
+static CBAL_Status_t cbal_status;
+
+static const char * TAG = "CBAL";
+
+/******************************************************************************
+*   Error Check
+*******************************************************************************/
+_Static_assert(CBAL_CFG_NB_PHASE == CREG_PHASE_INVALID, "Current balancer config phase number mismatch");
+
+/******************************************************************************
+*   Private Functions Definitions
+*******************************************************************************/
+/***************************************************************************//*!
+*  \brief Compute phase current limit.
+*
+*   This function return the current limit of a phase: the phase max
+*   current derated linearly with the temperature (derating_temp -> max_temp)
+*   and, if the regulator can not follow its setpoint (saturated), the
+*   current the phase actually delivers.
+*
+*   Preconditions: None.
+*
+*   Side Effects: None.
+*
+*   \param[in]  phase               Phase index.
+*   \param[in]  pMeas               Pointer to the phase measurements.
+*
+*   \return     Phase current limit (10mA)
+*
+*******************************************************************************/
+static int16_t computePhaseLimit(uint8_t phase, const CBAL_CFG_Phase_Meas_t *pMeas){
+
+    const CBAL_Phase_Limits_t *pLimits = &phase_limits[phase];
+    int32_t limit_10ma = pLimits->max_current_10ma;
+
+    if(pMeas->temperature >= pLimits->max_temp){
+        limit_10ma = 0;
+    }
+    else if(pMeas->temperature > pLimits->derating_temp){
+        limit_10ma = (limit_10ma * (pLimits->max_temp - pMeas->temperature)) /
+                     (pLimits->max_temp - pLimits->derating_temp);
+    }
+
+    //Do not ask more than the phase can deliver (ex: low bus voltage)
+    if(pMeas->saturated && (pMeas->current_10ma < (pMeas->setpoint_10ma - CBAL_TRACKING_MARGIN_10MA))){
+        limit_10ma = MIN(limit_10ma, pMeas->current_10ma + CBAL_TRACKING_MARGIN_10MA);
+    }
+
+    return (int16_t)limit_10ma;
+}
+
+/***************************************************************************//*!
+*  \brief Balance phases.
+*
+*   This function is the periodic balancing step. The total setpoint is
+*   split proportionally to the phases temperature headroom (low pass
+*   filtered split), then each phase is clamped to its current limit and
+*   the excess is moved to the other phase. It runs in the esp_timer task:
+*   if the state is locked by a caller the cycle is skipped (setpoints kept)
+*   instead of stalling the other timer callbacks.
+*
+*   Preconditions: None.
+*
+*   Side Effects: None.
+*
+*******************************************************************************/
+static void balancePhases(void){
+
+    CBAL_CFG_Phase_Meas_t meas;
+    CBAL_Phase_Status_t phase_status[CBAL_CFG_NB_PHASE];
+    int32_t setpoint_10ma[CBAL_CFG_NB_PHASE];
+    int32_t sum_headroom = 0;
+    int32_t sum_limit = 0;
+    int32_t request_10ma = 0;
+
+    if(pdTRUE != xSemaphoreTake(cbal_mutex_handle, 0)){
+        ESP_LOGD(TAG, "Balance cycle skipped: state locked");
+        return;
+    }
+
+    if(!is_running){
+        xSemaphoreGive(cbal_mutex_handle);
+        return;
+    }
+
+    for(uint8_t i=0; i<CBAL_CFG_NB_PHASE; i++){
+        CBAL_Phase_Status_t *pPhase = &phase_status[i];
+
+        memset(pPhase, 0, sizeof(CBAL_Phase_Status_t));
+
+        //Invalid measurement -> the phase gets no current
+        if(CBAL_CFG_STATUS_OK == CBAL_CFG_ReadPhase(i, &meas)){
+            pPhase->is_valid = true;
+            pPhase->temperature = meas.temperature;
+            pPhase->current_10ma = meas.current_10ma;
+            pPhase->limit_10ma = computePhaseLimit(i, &meas);
+
+            if(meas.temperature < phase_limits[i].max_temp){
+                pPhase->temp_headroom = phase_limits[i].max_temp - meas.temperature;
+            }
+        }
+
+        sum_headroom += pPhase->temp_headroom;
+        sum_limit += pPhase->limit_10ma;
+    }
+
+    //Share proportional to the temperature headroom (hotter phase -> less current)
+    int32_t target_q15 = CBAL_SHARE_ONE/2;
+    if(sum_headroom > 0){
+        target_q15 = (int32_t)(((int64_t)phase_status[CREG_PHASE_A].temp_headroom << CBAL_SHARE_SHIFT) / sum_headroom);
+    }
+    share_a_q15 += (target_q15 - share_a_q15) >> CBAL_SHARE_FILTER_SHIFT;
+
+    portENTER_CRITICAL(&cbal_spinlock);
+    request_10ma = total_request_10ma;
+    portEXIT_CRITICAL(&cbal_spinlock);
+
+    setpoint_10ma[CREG_PHASE_A] = (request_10ma * share_a_q15) >> CBAL_SHARE_SHIFT;
+    setpoint_10ma[CREG_PHASE_B] = request_10ma - setpoint_10ma[CREG_PHASE_A];
+
+    //Clamp to the phase limits, move the excess to the other phase
+    for(uint8_t i=0; i<CBAL_CFG_NB_PHASE; i++){
+        uint8_t other = (i + 1) % CBAL_CFG_NB_PHASE;
+        int32_t excess = setpoint_10ma[i] - phase_status[i].limit_10ma;
+
+        if(excess > 0){
+            setpoint_10ma[i] -= excess;
+            setpoint_10ma[other] += excess;
+        }
+    }
+
+    int32_t total_10ma = 0;
+    for(uint8_t i=0; i<CBAL_CFG_NB_PHASE; i++){
+        setpoint_10ma[i] = MIN(setpoint_10ma[i], phase_status[i].limit_10ma);
+        phase_status[i].setpoint_10ma = (int16_t)setpoint_10ma[i];
+        total_10ma += setpoint_10ma[i];
+
+        if(CBAL_CFG_STATUS_OK != CBAL_CFG_SetPhaseSetpoint(i, phase_status[i].setpoint_10ma)){
+            ESP_LOGE(TAG, "Failed to set phase %u setpoint", i);
+        }
+    }
+
+    //Publish
+    cbal_status.request_10ma = (int16_t)request_10ma;
+    cbal_status.setpoint_10ma = (int16_t)total_10ma;
+    cbal_status.headroom_10ma = (int16_t)(sum_limit - total_10ma);
+    cbal_status.share_a = (uint16_t)((share_a_q15 * CBAL_SHARE_FULL_SCALE) >> CBAL_SHARE_SHIFT);
+    cbal_status.is_limited = (total_10ma < request_10ma);
+    memcpy(cbal_status.phase, phase_status, sizeof(cbal_status.phase));
+
+    xSemaphoreGive(cbal_mutex_handle);
+}
+
+/******************************************************************************
+*   CallBack Functions implementation
+*******************************************************************************/
+
+
+/******************************************************************************
+*   Public Functions Definitions
+*******************************************************************************/
+/***************************************************************************//*!
+*  \brief Current balancer initialization.
+*
+*   This function is used to initialize the phases current balancer. The
+*   balancer is left stopped with a null total setpoint and the default
+*   phase limits.
+*
+*   Preconditions: Current regulator initialized.
+*
+*   Side Effects: None.
+*
+*   \return     Operation status
+*
+*******************************************************************************/
+CBAL_Ret_t CBAL_InitBalancer(void){
+
+    for(uint8_t i=0; i<CBAL_CFG_NB_PHASE; i++){
+        phase_limits[i].max_current_10ma = CBAL_DEFAULT_MAX_CURRENT_10MA;
+        phase_limits[i].derating_temp = CBAL_DEFAULT_DERATING_TEMP;
+        phase_limits[i].max_temp = CBAL_DEFAULT_MAX_TEMP;
+    }
+    total_request_10ma = 0;
+    share_a_q15 = CBAL_SHARE_ONE/2;
+    is_running = false;
+    memset(&cbal_status, 0, sizeof(cbal_status));
+
+    //Create mutex
+    cbal_mutex_handle = xSemaphoreCreateMutexStatic(&cbal_mutex_buffer);
+    if(cbal_mutex_handle == NULL){
+        ESP_LOGE(TAG, "Failed to create CBAL mutex");
+        return CBAL_STATUS_ERROR;
+    }
+
+    if(CBAL_CFG_STATUS_OK != CBAL_CFG_InitHardware()){
+        ESP_LOGE(TAG, "Failed to init balancer hardware");
+        return CBAL_STATUS_ERROR;
+    }
+
+    return CBAL_STATUS_OK;
+}
+
+/***************************************************************************//*!
+*  \brief Start current balancing.
+*
+*   This function is used to start the balancing (every CBAL_PERIOD_MS).
+*   The balancer owns the phases setpoint while running (do not call
+*   CREG_SetSetpoint() directly). The split restarts from 50/50.
+*
+*   Preconditions: Balancer initialized.
+*
+*   Side Effects: None.
+*
+*   \return     Operation status
+*
+*******************************************************************************/
+CBAL_Ret_t CBAL_Start(void){
+
+    xSemaphoreTake(cbal_mutex_handle, portMAX_DELAY);
+
+    if(is_running){
+        xSemaphoreGive(cbal_mutex_handle);
+        ESP_LOGE(TAG, "Balancer already running");
+        return CBAL_STATUS_ERROR;
+    }
+
+    share_a_q15 = CBAL_SHARE_ONE/2;
+
+    if(CBAL_CFG_STATUS_OK != CBAL_CFG_StartPeriodic(CBAL_PERIOD_MS, balancePhases)){
+        xSemaphoreGive(cbal_mutex_handle);
+        ESP_LOGE(TAG, "Failed to start balancing");
+        return CBAL_STATUS_ERROR;
+    }
+    is_running = true;
+
+    xSemaphoreGive(cbal_mutex_handle);
+
+    return CBAL_STATUS_OK;
+}
+
+/***************************************************************************//*!
+*  \brief Stop current balancing.
+*
+*   This function is used to stop the balancing. Both phases setpoint are
+*   set to 0.
+*
+*   Preconditions: Balancer initialized.
+*
+*   Side Effects: None.
+*
+*   \return     Operation status
+*
+*******************************************************************************/
+CBAL_Ret_t CBAL_Stop(void){
+
+    CBAL_Ret_t ret = CBAL_STATUS_OK;
+
+    xSemaphoreTake(cbal_mutex_handle, portMAX_DELAY);
+
+    if(CBAL_CFG_STATUS_OK != CBAL_CFG_StopPeriodic()){
+        ESP_LOGE(TAG, "Failed to stop balancing");
+        ret = CBAL_STATUS_ERROR;
+    }
+    is_running = false;
+
+    for(uint8_t i=0; i<CBAL_CFG_NB_PHASE; i++){
+        CBAL_CFG_SetPhaseSetpoint(i, 0);
+        cbal_status.phase[i].setpoint_10ma = 0;
+    }
+    cbal_status.setpoint_10ma = 0;
+
+    xSemaphoreGive(cbal_mutex_handle);
+
+    return ret;
+}
+
+/***************************************************************************//*!
+*  \brief Set total current setpoint.
+*
+*   This function is used to set the total current (phase A + phase B) to
+*   distribute. In 10mA (0 -> CBAL_MAX_TOTAL_SETPOINT_10MA). Does not
+*   block, can be called from the button scan context.
+*
+*   Preconditions: Balancer initialized.
+*
+*   Side Effects: None.
+*
+*   \param[in]  total_10ma          Total current setpoint.
+*
+*   \return     Operation status
+*
+*******************************************************************************/
+CBAL_Ret_t CBAL_SetTotalSetpoint(int16_t total_10ma){
+
+    if((total_10ma < 0) || (total_10ma > CBAL_MAX_TOTAL_SETPOINT_10MA)){
+        ESP_LOGE(TAG, "Invalid total setpoint: %d", total_10ma);
+        return CBAL_STATUS_ERROR;
+    }
+
+    //Spinlock only: the balance cycle holds the mutex while reading the phases
+    portENTER_CRITICAL(&cbal_spinlock);
+    total_request_10ma = total_10ma;
+    portEXIT_CRITICAL(&cbal_spinlock);
+
+    return CBAL_STATUS_OK;
+}
+
+/***************************************************************************//*!
+*  \brief Get total current setpoint.
+*
+*   This function is used to get the requested total current. In 10mA.
+*   Does not block, can be called from the button scan context.
+*
+*   Preconditions: Balancer initialized.
+*
+*   Side Effects: None.
+*
+*   \param[out] pTotal_10ma         Pointer to store the total current setpoint.
+*
+*   \return     Operation status
+*
+*******************************************************************************/
+CBAL_Ret_t CBAL_GetTotalSetpoint(int16_t *pTotal_10ma){
+
+    if(pTotal_10ma == NULL) return CBAL_STATUS_ERROR;
+
+    portENTER_CRITICAL(&cbal_spinlock);
+    *pTotal_10ma = total_request_10ma;
+    portEXIT_CRITICAL(&cbal_spinlock);
+
+    return CBAL_STATUS_OK;
+}
+
+/***************************************************************************//*!
+*  \brief Set phase limits.
+*
+*   This function is used to set the current and temperature limits of a
+*   phase. The phase current limit is derated linearly from max_current
+*   at derating_temp to 0 at max_temp.
+*
+*   Preconditions: Balancer initialized.
+*
+*   Side Effects: None.
+*
+*   \param[in]  phase               Phase.
+*   \param[in]  pLimits             Pointer to the phase limits.
+*
+*   \return     Operation status
+*
+*******************************************************************************/
+CBAL_Ret_t CBAL_SetPhaseLimits(CREG_Phase_t phase, const CBAL_Phase_Limits_t *pLimits){
+
+    if((phase >= CREG_PHASE_INVALID) || (pLimits == NULL)){
+        return CBAL_STATUS_ERROR;
+    }
+
+    if((pLimits->max_current_10ma < 0) ||
+       (pLimits->max_current_10ma > CREG_MAX_SETPOINT_10MA) ||
+       (pLimits->max_temp <= pLimits->derating_temp)){
+        ESP_LOGE(TAG, "Invalid phase %u limits", phase);
+        return CBAL_STATUS_ERROR;
+    }
+
+    xSemaphoreTake(cbal_mutex_handle, portMAX_DELAY);
+    phase_limits[phase] = *pLimits;
+    xSemaphoreGive(cbal_mutex_handle);
+
+    return CBAL_STATUS_OK;
+}
+
+/***************************************************************************//*!
+*  \brief Get balancer status.
+*
+*   This function is used to get the latest balancing status (split,
+*   per phase limits and the total current headroom).
+*
+*   Preconditions: Balancer initialized.
+*
+*   Side Effects: None.
+*
+*   \param[out] pStatus             Pointer to store the balancer status.
+*
+*   \return     Operation status
+*
+*******************************************************************************/
+CBAL_Ret_t CBAL_GetStatus(CBAL_Status_t *pStatus){
+
+    if(pStatus == NULL) return CBAL_STATUS_ERROR;
+
+    xSemaphoreTake(cbal_mutex_handle, portMAX_DELAY);
+    *pStatus = cbal_status;
+    xSemaphoreGive(cbal_mutex_handle);
+
+    return CBAL_STATUS_OK;
+}
+
+/******************************************************************************
+*   Interrupts
+*******************************************************************************/
@@ -0,0 +1,190 @@
+#ifndef __CURRENT_BALANCER_H
+#define __CURRENT_BALANCER_H
+
+#include <stdint.h>
+#include <stdbool.h>
+
+#include "currentRegulator.h"
+
+/******************************************************************************
+*   Public Definitions
+*******************************************************************************/
+#define CBAL_PERIOD_MS                      (100)//Balancing period
+
+#define CBAL_MAX_TOTAL_SETPOINT_10MA        (2*CREG_MAX_SETPOINT_10MA)
+
+#define CBAL_DEFAULT_MAX_CURRENT_10MA       (CREG_MAX_SETPOINT_10MA)
+#define CBAL_DEFAULT_DERATING_TEMP          (7000)//70C
+#define CBAL_DEFAULT_MAX_TEMP               (8500)//85C
+
+#define CBAL_SHARE_FULL_SCALE               (10000)//100.00%
+
+/******************************************************************************
+*   Public Macros
+*******************************************************************************/
+
+
+/******************************************************************************
+*   Public Data Types
+*******************************************************************************/
+typedef struct CBAL_Phase_Limits_s{
+    int16_t max_current_10ma;           //Phase current limit (below derating_temp)
+    int16_t derating_temp;              //Start of the linear derating (0.01C)
+    int16_t max_temp;                   //Null current limit temperature (0.01C)
+}CBAL_Phase_Limits_t;
+
+typedef struct CBAL_Phase_Status_s{
+    bool is_valid;                      //Phase measurements valid
+    int16_t temperature;                //Phase temperature (0.01C)
+    int16_t temp_headroom;              //max_temp - temperature (0.01C)
+    int16_t current_10ma;               //Measured phase current
+    int16_t limit_10ma;                 //Derated current limit
+    int16_t setpoint_10ma;              //Setpoint sent to the regulator
+}CBAL_Phase_Status_t;
+
+typedef struct CBAL_Status_s{
+    int16_t request_10ma;               //Requested total current
+    int16_t setpoint_10ma;              //Distributed total current
+    int16_t headroom_10ma;              //Total current still available
+    uint16_t share_a;                   //Phase A share of the total (0.01%)
+    bool is_limited;                    //Request not reachable
+    CBAL_Phase_Status_t phase[CREG_PHASE_INVALID];
+}CBAL_Status_t;
+
+typedef enum CBAL_Ret_e{
+    CBAL_STATUS_ERROR,
+    CBAL_STATUS_OK,
+}CBAL_Ret_t;
+
+/******************************************************************************
+*   Public Variables
+*******************************************************************************/
+
+
+/******************************************************************************
+*   Error Check
+*******************************************************************************/
+
+
+/******************************************************************************
+*   Public Functions Declarations
+*******************************************************************************/
+/***************************************************************************//*!
+*  \brief Current balancer initialization.
+*
+*   This function is used to initialize the phases current balancer. The
+*   balancer is left stopped with a null total setpoint and the default
+*   phase limits.
+*
+*   Preconditions: Current regulator initialized.
+*
+*   Side Effects: None.
+*
+*   \return     Operation status
+*
+*******************************************************************************/
+CBAL_Ret_t CBAL_InitBalancer(void);
+
+/***************************************************************************//*!
+*  \brief Start current balancing.
+*
+*   This function is used to start the balancing (every CBAL_PERIOD_MS).
+*   The balancer owns the phases setpoint while running (do not call
+*   CREG_SetSetpoint() directly). The split restarts from 50/50.
+*
+*   Preconditions: Balancer initialized.
+*
+*   Side Effects: None.
+*
+*   \return     Operation status
+*
+*******************************************************************************/
+CBAL_Ret_t CBAL_Start(void);
+
+/***************************************************************************//*!
+*  \brief Stop current balancing.
+*
+*   This function is used to stop the balancing. Both phases setpoint are
+*   set to 0.
+*
+*   Preconditions: Balancer initialized.
+*
+*   Side Effects: None.
+*
+*   \return     Operation status
+*
+*******************************************************************************/
+CBAL_Ret_t CBAL_Stop(void);
+
+/***************************************************************************//*!
+*  \brief Set total current setpoint.
+*
+*   This function is used to set the total current (phase A + phase B) to
+*   distribute. In 10mA (0 -> CBAL_MAX_TOTAL_SETPOINT_10MA). Does not
+*   block, can be called from the button scan context.
+*
+*   Preconditions: Balancer initialized.
+*
+*   Side Effects: None.
+*
+*   \param[in]  total_10ma          Total current setpoint.
+*
+*   \return     Operation status
+*
+*******************************************************************************/
+CBAL_Ret_t CBAL_SetTotalSetpoint(int16_t total_10ma);
+
+/***************************************************************************//*!
+*  \brief Get total current setpoint.
+*
+*   This function is used to get the requested total current. In 10mA.
+*   Does not block, can be called from the button scan context.
+*
+*   Preconditions: Balancer initialized.
+*
+*   Side Effects: None.
+*
+*   \param[out] pTotal_10ma         Pointer to store the total current setpoint.
+*
+*   \return     Operation status
+*
+*******************************************************************************/
+CBAL_Ret_t CBAL_GetTotalSetpoint(int16_t *pTotal_10ma);
+
+/***************************************************************************//*!
+*  \brief Set phase limits.
+*
+*   This function is used to set the current and temperature limits of a
+*   phase. The phase current limit is derated linearly from max_current
+*   at derating_temp to 0 at max_temp.
+*
+*   Preconditions: Balancer initialized.
+*
+*   Side Effects: None.
+*
+*   \param[in]  phase               Phase.
+*   \param[in]  pLimits             Pointer to the phase limits.
+*
+*   \return     Operation status
+*
+*******************************************************************************/
+CBAL_Ret_t CBAL_SetPhaseLimits(CREG_Phase_t phase, const CBAL_Phase_Limits_t *pLimits);
+
+/***************************************************************************//*!
+*  \brief Get balancer status.
+*
+*   This function is used to get the latest balancing status (split,
+*   per phase limits and the total current headroom).
+*
+*   Preconditions: Balancer initialized.
+*
+*   Side Effects: None.
+*
+*   \param[out] pStatus             Pointer to store the balancer status.
+*
+*   \return     Operation status
+*
+*******************************************************************************/
+CBAL_Ret_t CBAL_GetStatus(CBAL_Status_t *pStatus);
+
+#endif//__CURRENT_BALANCER_H
@@ -0,0 +1,1007 @@
+#include <math.h>
+
+#include "freertos/FreeRTOS.h"
+#include "freertos/semphr.h"
+
+#include "esp_attr.h"
+#include "esp_log.h"
+
+#include "trace.h"
+#include "currentRegulator.h"
+#include "currentRegulator_cfg.h"
+
+/******************************************************************************
+*   Private Definitions
+*******************************************************************************/
+#define CREG_INTEGRATOR_MAX_Q16             ((int32_t)CREG_CFG_MAX_DUTY<<CREG_GAIN_SHIFT)
+
+#define CREG_RAMP_SHIFT                     (15)//Ramp table is Q15 (0 -> 1.0)
+#define CREG_RAMP_ONE                       (1UL<<CREG_RAMP_SHIFT)
+#define CREG_RAMP_EXP_RATE                  (4.0f)//Exponential profile time constants over the ramp
+
+#define CREG_TARGET_ERROR_PCT               (1)//Time to target error band
+#define CREG_TARGET_MIN_BAND_10MA           (2)
+
+#define LOG_LOCAL_LEVEL                     (ESP_LOG_INFO)
+
+/******************************************************************************
+*   Private Macros
+*******************************************************************************/
+#define PER_MS_TO_PER_LOOP(x, rate)         (((int64_t)(x) * 1000) / (rate))
+
+/******************************************************************************
+*   Private Data Types
+*******************************************************************************/
+typedef struct CREG_Params_s{
+    int32_t kp_q16;                     //Proportional gain
+    int32_t ki_q16;                     //Integral gain (per loop)
+    int32_t slew_step_q16;              //Setpoint step (per loop), 0 -> no limit
+}CREG_Params_t;
+
+typedef struct CREG_Phase_Ctrl_s{
+    //Written by the API (under creg_spinlock)
+    volatile int16_t setpoint_10ma;
+    volatile bool params_pending;
+    CREG_Params_t pending_params;
+    int32_t kp_q16;
+    int32_t ki_ms_q16;
+    uint16_t slew_10ma_per_ms;
+
+    //Loop state (owned by the loop)
+    CREG_Params_t params;
+    int32_t target_q16;
+    int32_t integrator_q16;
+    bool is_ramping;
+    uint32_t ramp_pos_q16;              //Position in the ramp table
+    uint32_t nb_loops;                  //Loops since the phase (re)start
+    uint32_t loops_to_target;           //0 -> target not reached yet
+
+    //Published by the loop (under creg_spinlock)
+    CREG_Phase_Status_t status;
+}CREG_Phase_Ctrl_t;
+
+/******************************************************************************
+*   Private Functions Declaration
+*******************************************************************************/
+static void computeParams(CREG_Phase_Ctrl_t *pCtrl, uint32_t rate_hz, CREG_Params_t *pParams);
+static void updatePendingParams(CREG_Phase_Ctrl_t *pCtrl);
+static void resetLoopState(void);
+static void computeRampTable(CREG_Ramp_Profile_t profile);
+static void restartRamp(CREG_Phase_Ctrl_t *pCtrl);
+static int32_t rampTarget(CREG_Phase_Ctrl_t *pCtrl, int32_t setpoint_q16);
+static void regulatePhase(uint8_t phase);
+static void regulationLoop(void);
+
+/******************************************************************************
+*   Public Variables
+*******************************************************************************/
+
+
+/******************************************************************************
+*   Private Variables
+*******************************************************************************/
+static SemaphoreHandle_t creg_mutex_handle = NULL;
+static StaticSemaphore_t creg_mutex_buffer;
+static portMUX_TYPE creg_spinlock = portMUX_INITIALIZER_UNLOCKED;
+
+static CREG_Phase_Ctrl_t phase_ctrl[CREG_CFG_NB_PHASE];
+
+static bool is_running = false;
+static uint32_t loop_rate_hz = CREG_DEFAULT_LOOP_RATE_HZ;
+static uint32_t loop_period_cycles = 0;
+
+//Start ramp (table written with the loop stopped)
+static CREG_Ramp_Profile_t ramp_profile = CREG_DEFAULT_RAMP_PROFILE;
+static uint16_t ramp_duration_ms = CREG_DEFAULT_RAMP_TIME_MS;
+static uint16_t ramp_table[CREG_RAMP_TABLE_SIZE];
+static uint32_t ramp_step_q16 = 0;
+
+static volatile uint8_t fault_flags = CREG_FAULT_NONE;
+
+//Loop statistics (under creg_spinlock)
+static uint32_t prev_loop_start = 0;
+static uint64_t sum_cycles = 0;
+static CREG_Loop_Stats_t loop_stats;
+
+static const char * TAG = "CREG";
+
+/******************************************************************************
+*   Error Check
+*******************************************************************************/
+_Static_assert(CREG_CFG_NB_PHASE == CREG_PHASE_INVALID, "Current regulator config phase number mismatch");
+_Static_assert(CREG_FAULT_OVERCURRENT_10MA < CREG_CFG_SENSE_FULL_SCALE_10MA, "Over-current threshold above the current sense range");
+
+#if (CREG_MAX_LOOP_RATE_HZ > 20000) || (CREG_MIN_LOOP_RATE_HZ < 1000)
+#error "Invalid current regulator loop rate range"
+#endif
+
+/******************************************************************************
+*   Private Functions Definitions
+*******************************************************************************/
+/***************************************************************************//*!
+*  \brief Compute loop parameters.
+*
+*   This function is used to convert the phase gains/slew rate (per ms)
+*   in loop parameters (per loop execution) for the specified loop rate.
+*
+*   Preconditions: None.
+*
+*   Side Effects: None.
+*
+*   \param[in]  pCtrl               Pointer to phase control.
+*   \param[in]  rate_hz             Loop rate.
+*   \param[out] pParams             Pointer to store the loop parameters.
+*
+*******************************************************************************/
+static void computeParams(CREG_Phase_Ctrl_t *pCtrl, uint32_t rate_hz, CREG_Params_t *pParams){
+
+    pParams->kp_q16 = pCtrl->kp_q16;
+    pParams->ki_q16 = (int32_t)PER_MS_TO_PER_LOOP(pCtrl->ki_ms_q16, rate_hz);
+    pParams->slew_step_q16 = (int32_t)PER_MS_TO_PER_LOOP((int64_t)pCtrl->slew_10ma_per_ms<<CREG_GAIN_SHIFT, rate_hz);
+
+    //Keep a minimum step when a slew rate limit is set
+    if((pCtrl->slew_10ma_per_ms != 0) && (pParams->slew_step_q16 == 0)){
+        pParams->slew_step_q16 = 1;
+    }
+}
+
+/***************************************************************************//*!
+*  \brief Update pending parameters.
+*
+*   This function is used to post new loop parameters to the loop. The
+*   loop applies them at its next execution.
+*
+*   Preconditions: None.
+*
+*   Side Effects: None.
+*
+*   \param[in]  pCtrl               Pointer to phase control.
+*
+*******************************************************************************/
+static void updatePendingParams(CREG_Phase_Ctrl_t *pCtrl){
+
+    CREG_Params_t params;
+    computeParams(pCtrl, loop_rate_hz, &params);
+
+    portENTER_CRITICAL(&creg_spinlock);
+    pCtrl->pending_params = params;
+    pCtrl->params_pending = true;
+    portEXIT_CRITICAL(&creg_spinlock);
+}
+
+/***************************************************************************//*!
+*  \brief Reset loop state.
+*
+*   This function is used to reset the loop state of every phase and
+*   the loop statistics (loop must be stopped).
+*
+*   Preconditions: Loop stopped.
+*
+*   Side Effects: None.
+*
+*******************************************************************************/
+static void resetLoopState(void){
+
+    portENTER_CRITICAL(&creg_spinlock);
+    for(uint8_t i=0; i<CREG_CFG_NB_PHASE; i++){
+        computeParams(&phase_ctrl[i], loop_rate_hz, &phase_ctrl[i].params);
+        phase_ctrl[i].params_pending = false;
+        restartRamp(&phase_ctrl[i]);
+        phase_ctrl[i].status.target_10ma = 0;
+        phase_ctrl[i].status.current_10ma = 0;
+        phase_ctrl[i].status.duty = 0;
+        phase_ctrl[i].status.saturated = false;
+        phase_ctrl[i].status.ramping = false;
+    }
+    prev_loop_start = 0;
+    portEXIT_CRITICAL(&creg_spinlock);
+
+    CREG_ResetLoopStats();
+}
+
+/***************************************************************************//*!
+*  \brief Compute ramp table.
+*
+*   This function is used to fill the normalized ramp table (Q15, 0 -> 1.0
+*   over CREG_RAMP_TABLE_SIZE points) of a ramp profile.
+*
+*   Preconditions: Loop stopped.
+*
+*   Side Effects: None.
+*
+*   \param[in]  profile             Ramp profile.
+*
+*******************************************************************************/
+static void computeRampTable(CREG_Ramp_Profile_t profile){
+
+    const float exp_scale = 1.0f / (1.0f - expf(-CREG_RAMP_EXP_RATE));
+
+    for(uint8_t i=0; i<CREG_RAMP_TABLE_SIZE; i++){
+        float x = (float)i / (CREG_RAMP_TABLE_SIZE - 1);
+        float y = x;
+
+        switch(profile){
+
+            case CREG_RAMP_S_CURVE:
+            {
+                y = x * x * (3.0f - (2.0f * x));
+            }
+            break;
+
+            case CREG_RAMP_EXPONENTIAL:
+            {
+                //Normalized so the ramp ends exactly at the setpoint
+                y = (1.0f - expf(-CREG_RAMP_EXP_RATE * x)) * exp_scale;
+            }
+            break;
+
+            case CREG_RAMP_LINEAR:
+            case CREG_RAMP_NONE:
+            default:
+            break;
+        }
+
+        ramp_table[i] = (uint16_t)((y * CREG_RAMP_ONE) + 0.5f);
+    }
+    ramp_table[CREG_RAMP_TABLE_SIZE - 1] = CREG_RAMP_ONE;
+}
+
+/***************************************************************************//*!
+*  \brief Restart ramp.
+*
+*   This function is used to restart a phase from a null output: null
+*   target, null integrator and start ramp armed.
+*
+*   Preconditions: Called from the loop or with the loop stopped.
+*
+*   Side Effects: None.
+*
+*   \param[in]  pCtrl               Pointer to phase control.
+*
+*******************************************************************************/
+static void IRAM_ATTR restartRamp(CREG_Phase_Ctrl_t *pCtrl){
+
+    pCtrl->target_q16 = 0;
+    pCtrl->integrator_q16 = 0;
+    pCtrl->is_ramping = (ramp_profile != CREG_RAMP_NONE);
+    pCtrl->ramp_pos_q16 = 0;
+    pCtrl->nb_loops = 0;
+    pCtrl->loops_to_target = 0;
+}
+
+/***************************************************************************//*!
+*  \brief Ramp target.
+*
+*   This function return the ramp target (Q16) of a phase and advance its
+*   ramp by one loop (interpolation in the ramp table, no division).
+*
+*   Preconditions: Called from the loop.
+*
+*   Side Effects: None.
+*
+*   \param[in]  pCtrl               Pointer to phase control.
+*   \param[in]  setpoint_q16        Phase setpoint.
+*
+*   \return     Ramp target (Q16)
+*
+*******************************************************************************/
+static int32_t IRAM_ATTR rampTarget(CREG_Phase_Ctrl_t *pCtrl, int32_t setpoint_q16){
+
+    pCtrl->ramp_pos_q16 += ramp_step_q16;
+
+    uint32_t index = pCtrl->ramp_pos_q16>>16;
+    if(index >= (CREG_RAMP_TABLE_SIZE - 1)){
+        pCtrl->is_ramping = false;
+        return setpoint_q16;
+    }
+
+    uint32_t frac = pCtrl->ramp_pos_q16 & 0xFFFF;
+    int32_t shape_q15 = ramp_table[index] + 
+                        (int32_t)((((int32_t)ramp_table[index + 1] - ramp_table[index]) * (int64_t)frac)>>16);
+
+    return (int32_t)(((int64_t)setpoint_q16 * shape_q15)>>CREG_RAMP_SHIFT);
+}
+
+/***************************************************************************//*!
+*  \brief Regulate phase.
+*
+*   This function execute one PI iteration on a phase:
+*   - Hold the output off while a fault is latched.
+*   - Ramp (start) or slew rate limit the setpoint.
+*   - Sample the phase current (over-current fault).
+*   - Compute the PI output (conditional integration anti-windup).
+*   - Apply the new duty-cycle (fault checked again under lock).
+*
+*   Preconditions: Called from the loop interrupt.
+*
+*   Side Effects: None.
+*
+*   \param[in]  phase               Phase index.
+*
+*******************************************************************************/
+static void IRAM_ATTR regulatePhase(uint8_t phase){
+
+    CREG_Phase_Ctrl_t *pCtrl = &phase_ctrl[phase];
+
+    //Apply new parameters if any
+    if(pCtrl->params_pending){
+        portENTER_CRITICAL_ISR(&creg_spinlock);
+        pCtrl->params = pCtrl->pending_params;
+        pCtrl->params_pending = false;
+        portEXIT_CRITICAL_ISR(&creg_spinlock);
+    }
+
+    //Fault latched -> output off, restart with the ramp once cleared
+    if(fault_flags != CREG_FAULT_NONE){
+        CREG_CFG_SetPhaseDuty(phase, 0);
+        restartRamp(pCtrl);
+
+        portENTER_CRITICAL_ISR(&creg_spinlock);
+        pCtrl->status.target_10ma = 0;
+        pCtrl->status.duty = 0;
+        pCtrl->status.saturated = false;
+        pCtrl->status.ramping = false;
+        portEXIT_CRITICAL_ISR(&creg_spinlock);
+        return;
+    }
+
+    //Start ramp, then slew rate limit the setpoint
+    int32_t setpoint_q16 = (int32_t)pCtrl->setpoint_10ma<<CREG_GAIN_SHIFT;
+    int32_t step_q16 = pCtrl->params.slew_step_q16;
+    if(pCtrl->is_ramping){
+        pCtrl->target_q16 = rampTarget(pCtrl, setpoint_q16);
+    }
+    else if((step_q16 == 0) || (setpoint_q16 == pCtrl->target_q16)){
+        pCtrl->target_q16 = setpoint_q16;
+    }
+    else if(setpoint_q16 > pCtrl->target_q16){
+        pCtrl->target_q16 = ((setpoint_q16 - pCtrl->target_q16) > step_q16) ?
+                            (pCtrl->target_q16 + step_q16) : setpoint_q16;
+    }
+    else{
+        pCtrl->target_q16 = ((pCtrl->target_q16 - setpoint_q16) > step_q16) ?
+                            (pCtrl->target_q16 - step_q16) : setpoint_q16;
+    }
+    int32_t target_10ma = pCtrl->target_q16>>CREG_GAIN_SHIFT;
+
+    //Sample phase current
+    int16_t current_10ma = 0;
+    if(CREG_CFG_STATUS_OK != CREG_CFG_ReadPhaseCurrent(phase, &current_10ma)){
+        //No valid measurement -> hold the output
+        return;
+    }
+
+    if(current_10ma > CREG_FAULT_OVERCURRENT_10MA){
+        CREG_TriggerFault(CREG_FAULT_OVERCURRENT);
+        return;
+    }
+
+    //Time to target (first entry in the error band once the ramp is done)
+    pCtrl->nb_loops++;
+    if((pCtrl->loops_to_target == 0) && (!pCtrl->is_ramping) && (target_10ma > 0) &&
+       (target_10ma == pCtrl->setpoint_10ma)){
+        int32_t band_10ma = (target_10ma * CREG_TARGET_ERROR_PCT) / 100;
+        if(band_10ma < CREG_TARGET_MIN_BAND_10MA)    band_10ma = CREG_TARGET_MIN_BAND_10MA;
+
+        int32_t target_error = target_10ma - current_10ma;
+        if((target_error <= band_10ma) && (target_error >= -band_10ma)){
+            pCtrl->loops_to_target = pCtrl->nb_loops;
+        }
+    }
+
+    int32_t duty = 0;
+    bool saturated = false;
+    if(target_10ma <= 0){
+        //Null setpoint -> output off
+        pCtrl->integrator_q16 = 0;
+    }
+    else{
+        int32_t error = target_10ma - current_10ma;
+        int64_t output_q16 = ((int64_t)pCtrl->params.kp_q16 * error) + pCtrl->integrator_q16;
+        duty = (int32_t)(output_q16>>CREG_GAIN_SHIFT);
+
+        //Saturate the output, freeze integration while pushing in the saturation
+        if(duty >= CREG_CFG_MAX_DUTY){
+            duty = CREG_CFG_MAX_DUTY;
+            saturated = (error > 0);
+        }
+        else if(duty <= 0){
+            duty = 0;
+            saturated = (error < 0);
+        }
+
+        if(!saturated){
+            int64_t integrator_q16 = pCtrl->integrator_q16 + ((int64_t)pCtrl->params.ki_q16 * error);
+            if(integrator_q16 > CREG_INTEGRATOR_MAX_Q16)   integrator_q16 = CREG_INTEGRATOR_MAX_Q16;
+            if(integrator_q16 < 0)                         integrator_q16 = 0;
+            pCtrl->integrator_q16 = (int32_t)integrator_q16;
+        }
+    }
+
+    //Apply the duty unless a fault was latched meanwhile (CREG_TriggerFault()
+    //from the other core zeroes the outputs after setting the flag)
+    portENTER_CRITICAL_ISR(&creg_spinlock);
+    if(fault_flags != CREG_FAULT_NONE){
+        portEXIT_CRITICAL_ISR(&creg_spinlock);
+        CREG_CFG_SetPhaseDuty(phase, 0);
+        return;
+    }
+    CREG_CFG_SetPhaseDuty(phase, (uint16_t)duty);
+
+    //Publish phase status
+    pCtrl->status.target_10ma = (int16_t)target_10ma;
+    pCtrl->status.current_10ma = current_10ma;
+    pCtrl->status.duty = (uint16_t)duty;
+    pCtrl->status.saturated = saturated;
+    pCtrl->status.ramping = pCtrl->is_ramping;
+    portEXIT_CRITICAL_ISR(&creg_spinlock);
+}
+
+/******************************************************************************
+*   CallBack Functions implementation
+*******************************************************************************/
+/***************************************************************************//*!
+*  \brief Regulation loop.
+*
+*   This function is the regulation loop called from the loop timer
+*   interrupt. Regulate every phase and update the loop statistics.
+*
+*   Preconditions: Loop timer started.
+*
+*   Side Effects: None.
+*
+*******************************************************************************/
+static void IRAM_ATTR regulationLoop(void){
+
+    TRACE_BEGIN(TRACE_REG_LOOP, 0);
+
+    uint32_t loop_start = CREG_CFG_GetCycleCount();
+
+    for(uint8_t i=0; i<CREG_CFG_NB_PHASE; i++){
+        regulatePhase(i);
+    }
+
+    uint32_t loop_cycles = CREG_CFG_GetCycleCount() - loop_start;
+
+    //Update loop statistics
+    portENTER_CRITICAL_ISR(&creg_spinlock);
+    if(loop_stats.nb_loops != 0){
+        uint32_t interval = loop_start - prev_loop_start;
+        if(interval > loop_stats.max_interval_cycles)   loop_stats.max_interval_cycles = interval;
+    }
+    prev_loop_start = loop_start;
+
+    loop_stats.nb_loops++;
+    loop_stats.last_cycles = loop_cycles;
+    if(loop_cycles < loop_stats.min_cycles)     loop_stats.min_cycles = loop_cycles;
+    if(loop_cycles > loop_stats.max_cycles)     loop_stats.max_cycles = loop_cycles;
+    if(loop_cycles > loop_period_cycles)        loop_stats.nb_overruns++;
+    sum_cycles += loop_cycles;
+    portEXIT_CRITICAL_ISR(&creg_spinlock);
+
+    TRACE_END(TRACE_REG_LOOP, 0);
+}
+
+/******************************************************************************
+*   Public Functions Definitions
+*******************************************************************************/
+/***************************************************************************//*!
+*  \brief Current regulator initialization.
+*
+*   This function is used to initialize the phases current regulator and the
+*   underlying hardware (loop timer, current sampling and phase outputs).
+*   The regulator is left stopped with a null setpoint.
+*
+*   Preconditions: None.
+*
+*   Side Effects: None.
+*
+*   \return     Operation status
+*
+*******************************************************************************/
+CREG_Ret_t CREG_InitRegulator(void){
+
+    ESP_LOGI(TAG, "Regulator initialization");
+
+    //Init global variables
+    is_running = false;
+    loop_rate_hz = CREG_DEFAULT_LOOP_RATE_HZ;
+    for(uint8_t i=0; i<CREG_CFG_NB_PHASE; i++){
+        phase_ctrl[i].setpoint_10ma = 0;
+        phase_ctrl[i].kp_q16 = CREG_DEFAULT_KP_Q16;
+        phase_ctrl[i].ki_ms_q16 = CREG_DEFAULT_KI_Q16;
+        phase_ctrl[i].slew_10ma_per_ms = CREG_DEFAULT_SLEW_10MA_PER_MS;
+        phase_ctrl[i].status.setpoint_10ma = 0;
+    }
+    ramp_profile = CREG_DEFAULT_RAMP_PROFILE;
+    ramp_duration_ms = CREG_DEFAULT_RAMP_TIME_MS;
+    computeRampTable(ramp_profile);
+    fault_flags = CREG_FAULT_NONE;
+    resetLoopState();
+
+    //Create mutex
+    creg_mutex_handle = xSemaphoreCreateMutexStatic(&creg_mutex_buffer);
+    if(creg_mutex_handle == NULL){
+        ESP_LOGE(TAG, "Failed to create CREG mutex");
+        return CREG_STATUS_ERROR;
+    }
+
+    if(CREG_CFG_STATUS_OK != CREG_CFG_InitHardware()){
+        ESP_LOGE(TAG, "Failed to init regulator hardware");
+        return CREG_STATUS_ERROR;
+    }
+
+    return CREG_STATUS_OK;
+}
+
+/***************************************************************************//*!
+*  \brief Start current regulation.
+*
+*   This function is used to start the regulation loop at the specified rate
+*   (CREG_MIN_LOOP_RATE_HZ -> CREG_MAX_LOOP_RATE_HZ). The loop restarts from
+*   a null duty and a null integrator, the setpoint ramps from 0 to the
+*   requested setpoint following the ramp profile (or the slew rate).
+*
+*   Preconditions: Regulator initialized and stopped, no fault latched,
+*                  phases not used by someone else.
+*
+*   Side Effects: None.
+*
+*   \param[in]  rate_hz             Loop rate.
+*
+*   \return     Operation status
+*
+*******************************************************************************/
+CREG_Ret_t CREG_Start(uint32_t rate_hz){
+
+    if((rate_hz < CREG_MIN_LOOP_RATE_HZ) || (rate_hz > CREG_MAX_LOOP_RATE_HZ)){
+        ESP_LOGE(TAG, "Invalid loop rate: %lu Hz", rate_hz);
+        return CREG_STATUS_ERROR;
+    }
+
+    if(creg_mutex_handle == NULL)   return CREG_STATUS_ERROR;
+
+    xSemaphoreTake(creg_mutex_handle, portMAX_DELAY);
+
+    if(is_running){
+        xSemaphoreGive(creg_mutex_handle);
+        ESP_LOGE(TAG, "Regulator already running");
+        return CREG_STATUS_ERROR;
+    }
+
+    if(fault_flags != CREG_FAULT_NONE){
+        xSemaphoreGive(creg_mutex_handle);
+        ESP_LOGE(TAG, "Fault latched: 0x%02x", fault_flags);
+        return CREG_STATUS_ERROR;
+    }
+
+    loop_rate_hz = rate_hz;
+    loop_period_cycles = CREG_CFG_GetCycleFreqHz() / rate_hz;
+
+    //Ramp step so the table end is reached in ramp_time_ms at most
+    uint32_t ramp_loops = ((uint32_t)ramp_duration_ms * rate_hz) / 1000;
+    if(ramp_loops == 0) ramp_loops = 1;
+    ramp_step_q16 = ((((uint32_t)CREG_RAMP_TABLE_SIZE - 1)<<16) + ramp_loops - 1) / ramp_loops;
+
+    resetLoopState();
+
+    portENTER_CRITICAL(&creg_spinlock);
+    loop_stats.rate_hz = rate_hz;
+    loop_stats.cpu_freq_hz = CREG_CFG_GetCycleFreqHz();
+    portEXIT_CRITICAL(&creg_spinlock);
+
+    //Refused while the phases are used by someone else
+    if(CREG_CFG_STATUS_OK != CREG_CFG_EnablePhases(true)){
+        xSemaphoreGive(creg_mutex_handle);
+        ESP_LOGE(TAG, "Failed to enable phases");
+        return CREG_STATUS_ERROR;
+    }
+
+    if(CREG_CFG_STATUS_OK != CREG_CFG_StartLoopTimer(rate_hz, regulationLoop)){
+        CREG_CFG_EnablePhases(false);
+        xSemaphoreGive(creg_mutex_handle);
+        ESP_LOGE(TAG, "Failed to start loop timer");
+        return CREG_STATUS_ERROR;
+    }
+    is_running = true;
+
+    xSemaphoreGive(creg_mutex_handle);
+
+    ESP_LOGI(TAG, "Regulation started at %lu Hz", rate_hz);
+
+    return CREG_STATUS_OK;
+}
+
+/***************************************************************************//*!
+*  \brief Stop current regulation.
+*
+*   This function is used to stop the regulation loop. Both phases duty
+*   are forced to 0.
+*
+*   Preconditions: Regulator initialized.
+*
+*   Side Effects: None.
+*
+*   \return     Operation status
+*
+*******************************************************************************/
+CREG_Ret_t CREG_Stop(void){
+
+    CREG_Ret_t ret = CREG_STATUS_OK;
+
+    if(creg_mutex_handle == NULL)   return CREG_STATUS_ERROR;
+
+    xSemaphoreTake(creg_mutex_handle, portMAX_DELAY);
+
+    if(CREG_CFG_STATUS_OK != CREG_CFG_StopLoopTimer()){
+        ESP_LOGE(TAG, "Failed to stop loop timer");
+        ret = CREG_STATUS_ERROR;
+    }
+
+    //Force outputs off whatever the timer state (phases may be used by
+    //someone else when the regulator is stopped)
+    if(is_running){
+        for(uint8_t i=0; i<CREG_CFG_NB_PHASE; i++){
+            CREG_CFG_SetPhaseDuty(i, 0);
+        }
+        CREG_CFG_EnablePhases(false);
+    }
+    is_running = false;
+
+    portENTER_CRITICAL(&creg_spinlock);
+    for(uint8_t i=0; i<CREG_CFG_NB_PHASE; i++){
+        phase_ctrl[i].status.duty = 0;
+        phase_ctrl[i].status.saturated = false;
+    }
+    portEXIT_CRITICAL(&creg_spinlock);
+
+    xSemaphoreGive(creg_mutex_handle);
+
+    return ret;
+}
+
+/***************************************************************************//*!
+*  \brief Is regulator running.
+*
+*   This function return if the regulation loop is running.
+*
+*   Preconditions: None.
+*
+*   Side Effects: None.
+*
+*   \return     Regulator running (True) or stopped (False)
+*
+*******************************************************************************/
+bool CREG_IsRunning(void){
+
+    bool running = false;
+
+    if(creg_mutex_handle == NULL)   return false;
+
+    xSemaphoreTake(creg_mutex_handle, portMAX_DELAY);
+    running = is_running;
+    xSemaphoreGive(creg_mutex_handle);
+
+    return running;
+}
+
+/***************************************************************************//*!
+*  \brief Set start ramp profile.
+*
+*   This function is used to set the setpoint ramp applied when the phases
+*   are enabled (CREG_Start() and CREG_ClearFault()). The target reaches
+*   the setpoint in ramp_time_ms at most, whatever the loop rate. Later
+*   setpoint changes follow the slew rate.
+*
+*   Preconditions: Regulator initialized and stopped.
+*
+*   Side Effects: None.
+*
+*   \param[in]  profile             Ramp profile.
+*   \param[in]  ramp_time_ms        Ramp time (CREG_MIN_RAMP_TIME_MS -> CREG_MAX_RAMP_TIME_MS).
+*
+*   \return     Operation status
+*
+*******************************************************************************/
+CREG_Ret_t CREG_SetRampProfile(CREG_Ramp_Profile_t profile, uint16_t ramp_time_ms){
+
+    if((profile >= CREG_RAMP_INVALID) ||
+       (ramp_time_ms < CREG_MIN_RAMP_TIME_MS) || (ramp_time_ms > CREG_MAX_RAMP_TIME_MS)){
+        ESP_LOGE(TAG, "Invalid ramp profile");
+        return CREG_STATUS_ERROR;
+    }
+
+    if(creg_mutex_handle == NULL)   return CREG_STATUS_ERROR;
+
+    xSemaphoreTake(creg_mutex_handle, portMAX_DELAY);
+
+    //The loop reads the table without lock
+    if(is_running){
+        xSemaphoreGive(creg_mutex_handle);
+        ESP_LOGE(TAG, "Regulator running");
+        return CREG_STATUS_ERROR;
+    }
+
+    ramp_profile = profile;
+    ramp_duration_ms = ramp_time_ms;
+    computeRampTable(profile);
+
+    xSemaphoreGive(creg_mutex_handle);
+
+    return CREG_STATUS_OK;
+}
+
+/***************************************************************************//*!
+*  \brief Trigger regulator fault.
+*
+*   This function is used to latch a fault: both phases duty are forced to 0
+*   immediately and held at 0 until CREG_ClearFault(), whoever drives the
+*   phases (phases tripped). Can be called from an ISR.
+*
+*   Preconditions: Regulator initialized.
+*
+*   Side Effects: None.
+*
+*   \param[in]  fault               Fault flags (CREG_FAULT_xxx).
+*
+*******************************************************************************/
+void IRAM_ATTR CREG_TriggerFault(uint8_t fault){
+
+    portENTER_CRITICAL_SAFE(&creg_spinlock);
+    fault_flags |= fault;
+    portEXIT_CRITICAL_SAFE(&creg_spinlock);
+
+    TRACE_EVENT(TRACE_REG_FAULT, fault);
+
+    //Do not wait for the next loop, outputs held off for every phases user
+    CREG_CFG_SetPhaseTrip(true);
+}
+
+/***************************************************************************//*!
+*  \brief Get latched faults.
+*
+*   This function return the latched fault flags (CREG_FAULT_xxx).
+*
+*   Preconditions: None.
+*
+*   Side Effects: None.
+*
+*   \return     Fault flags
+*
+*******************************************************************************/
+uint8_t CREG_GetFault(void){
+
+    return fault_flags;
+}
+
+/***************************************************************************//*!
+*  \brief Clear latched faults.
+*
+*   This function is used to clear the latched faults. If the regulator is
+*   running the phases restart with the start ramp profile (no step from 0
+*   to the setpoint).
+*
+*   Preconditions: Regulator initialized.
+*
+*   Side Effects: None.
+*
+*   \return     Operation status
+*
+*******************************************************************************/
+CREG_Ret_t CREG_ClearFault(void){
+
+    //The loop restarts the ramp of every phase while the fault is latched
+    portENTER_CRITICAL(&creg_spinlock);
+    fault_flags = CREG_FAULT_NONE;
+    portEXIT_CRITICAL(&creg_spinlock);
+
+    CREG_CFG_SetPhaseTrip(false);
+
+    return CREG_STATUS_OK;
+}
+
+/***************************************************************************//*!
+*  \brief Set phase current setpoint.
+*
+*   This function is used to set the current setpoint of a phase.
+*   In 10mA (5A -> 500). The loop reaches the new setpoint at the
+*   configured slew rate.
+*
+*   Preconditions: Regulator initialized.
+*
+*   Side Effects: None.
+*
+*   \param[in]  phase               Phase.
+*   \param[in]  setpoint_10ma       Current setpoint.
+*
+*   \return     Operation status
+*
+*******************************************************************************/
+CREG_Ret_t CREG_SetSetpoint(CREG_Phase_t phase, int16_t setpoint_10ma){
+
+    if((phase >= CREG_PHASE_INVALID) || (setpoint_10ma < 0) ||
+       (setpoint_10ma > CREG_MAX_SETPOINT_10MA)){
+        ESP_LOGE(TAG, "Invalid setpoint");
+        return CREG_STATUS_ERROR;
+    }
+
+    portENTER_CRITICAL(&creg_spinlock);
+    phase_ctrl[phase].setpoint_10ma = setpoint_10ma;
+    phase_ctrl[phase].status.setpoint_10ma = setpoint_10ma;
+    portEXIT_CRITICAL(&creg_spinlock);
+
+    return CREG_STATUS_OK;
+}
+
+/***************************************************************************//*!
+*  \brief Set phase regulator gains.
+*
+*   This function is used to set the PI gains of a phase (Q16 fixed point).
+*   Kp is in 0.01% duty per 10mA, Ki in 0.01% duty per 10mA per ms (so the
+*   gains do not depend on the loop rate). The new gains are applied by
+*   the loop at its next execution.
+*
+*   Preconditions: Regulator initialized.
+*
+*   Side Effects: None.
+*
+*   \param[in]  phase               Phase.
+*   \param[in]  kp_q16              Proportional gain.
+*   \param[in]  ki_q16              Integral gain.
+*
+*   \return     Operation status
+*
+*******************************************************************************/
+CREG_Ret_t CREG_SetGains(CREG_Phase_t phase, int32_t kp_q16, int32_t ki_q16){
+
+    if((phase >= CREG_PHASE_INVALID) || (kp_q16 < 0) || (ki_q16 < 0)){
+        ESP_LOGE(TAG, "Invalid gains");
+        return CREG_STATUS_ERROR;
+    }
+
+    if(creg_mutex_handle == NULL)   return CREG_STATUS_ERROR;
+
+    xSemaphoreTake(creg_mutex_handle, portMAX_DELAY);
+    phase_ctrl[phase].kp_q16 = kp_q16;
+    phase_ctrl[phase].ki_ms_q16 = ki_q16;
+    updatePendingParams(&phase_ctrl[phase]);
+    xSemaphoreGive(creg_mutex_handle);
+
+    return CREG_STATUS_OK;
+}
+
+/***************************************************************************//*!
+*  \brief Set phase setpoint slew rate.
+*
+*   This function is used to set the maximum setpoint slew rate of a phase.
+*   In 10mA per ms (0 -> no slew rate limit).
+*
+*   Preconditions: Regulator initialized.
+*
+*   Side Effects: None.
+*
+*   \param[in]  phase               Phase.
+*   \param[in]  slew_10ma_per_ms    Slew rate.
+*
+*   \return     Operation status
+*
+*******************************************************************************/
+CREG_Ret_t CREG_SetSlewRate(CREG_Phase_t phase, uint16_t slew_10ma_per_ms){
+
+    if(phase >= CREG_PHASE_INVALID){
+        ESP_LOGE(TAG, "Invalid phase");
+        return CREG_STATUS_ERROR;
+    }
+
+    if(creg_mutex_handle == NULL)   return CREG_STATUS_ERROR;
+
+    xSemaphoreTake(creg_mutex_handle, portMAX_DELAY);
+    phase_ctrl[phase].slew_10ma_per_ms = slew_10ma_per_ms;
+    updatePendingParams(&phase_ctrl[phase]);
+    xSemaphoreGive(creg_mutex_handle);
+
+    return CREG_STATUS_OK;
+}
+
+/***************************************************************************//*!
+*  \brief Get phase regulation status.
+*
+*   This function is used to get the latest regulation status of a phase.
+*
+*   Preconditions: Regulator initialized.
+*
+*   Side Effects: None.
+*
+*   \param[in]  phase               Phase.
+*   \param[out] pStatus             Pointer to store the phase status.
+*
+*   \return     Operation status
+*
+*******************************************************************************/
+CREG_Ret_t CREG_GetPhaseStatus(CREG_Phase_t phase, CREG_Phase_Status_t *pStatus){
+
+    if((phase >= CREG_PHASE_INVALID) || (pStatus == NULL)){
+        ESP_LOGE(TAG, "Invalid status buffer");
+        return CREG_STATUS_ERROR;
+    }
+
+    uint32_t loops_to_target = 0;
+    portENTER_CRITICAL(&creg_spinlock);
+    *pStatus = phase_ctrl[phase].status;
+    loops_to_target = phase_ctrl[phase].loops_to_target;
+    portEXIT_CRITICAL(&creg_spinlock);
+
+    pStatus->time_to_target_us = (uint32_t)(((uint64_t)loops_to_target * 1000000) / loop_rate_hz);
+
+    return CREG_STATUS_OK;
+}
+
+/***************************************************************************//*!
+*  \brief Get loop statistics.
+*
+*   This function is used to get the regulation loop timing statistics.
+*
+*   Preconditions: Regulator initialized.
+*
+*   Side Effects: None.
+*
+*   \param[out] pStats              Pointer to store the loop statistics.
+*
+*   \return     Operation status
+*
+*******************************************************************************/
+CREG_Ret_t CREG_GetLoopStats(CREG_Loop_Stats_t *pStats){
+
+    if(pStats == NULL){
+        ESP_LOGE(TAG, "Invalid stats buffer");
+        return CREG_STATUS_ERROR;
+    }
+
+    uint64_t sum = 0;
+    portENTER_CRITICAL(&creg_spinlock);
+    *pStats = loop_stats;
+    sum = sum_cycles;
+    portEXIT_CRITICAL(&creg_spinlock);
+
+    if(pStats->nb_loops != 0){
+        pStats->avg_cycles = (uint32_t)(sum / pStats->nb_loops);
+    }
+    else{
+        pStats->min_cycles = 0;
+    }
+
+    return CREG_STATUS_OK;
+}
+
+/***************************************************************************//*!
+*  \brief Reset loop statistics.
+*
+*   This function is used to reset the regulation loop timing statistics.
+*
+*   Preconditions: Regulator initialized.
+*
+*   Side Effects: None.
+*
+*   \return     Operation status
+*
+*******************************************************************************/
+CREG_Ret_t CREG_ResetLoopStats(void){
+
+    portENTER_CRITICAL(&creg_spinlock);
+    sum_cycles = 0;
+    loop_stats.nb_loops = 0;
+    loop_stats.nb_overruns = 0;
+    loop_stats.last_cycles = 0;
+    loop_stats.min_cycles = UINT32_MAX;
+    loop_stats.max_cycles = 0;
+    loop_stats.avg_cycles = 0;
+    loop_stats.max_interval_cycles = 0;
+    portEXIT_CRITICAL(&creg_spinlock);
+
+    return CREG_STATUS_OK;
+}
+
+/******************************************************************************
+*   Interrupts
+*******************************************************************************/
+
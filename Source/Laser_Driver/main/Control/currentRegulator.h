@@ -0,0 +1,335 @@
+#ifndef __CURRENT_REGULATOR_H
+#define __CURRENT_REGULATOR_H
+
+#include <stdint.h>
+#include <stdbool.h>
+
+/******************************************************************************
+*   Public Definitions
+*******************************************************************************/
+#define CREG_MIN_LOOP_RATE_HZ               (1000)
+#define CREG_MAX_LOOP_RATE_HZ               (20000)
+#define CREG_DEFAULT_LOOP_RATE_HZ           (10000)
+
+#define CREG_GAIN_SHIFT                     (16)//Gains are Q16 fixed point
+#define CREG_GAIN_ONE                       (1L<<CREG_GAIN_SHIFT)
+
+#define CREG_DEFAULT_KP_Q16                 (2*CREG_GAIN_ONE)//0.01% duty per 10mA
+#define CREG_DEFAULT_KI_Q16                 (20*CREG_GAIN_ONE)//0.01% duty per 10mA per ms
+#define CREG_DEFAULT_SLEW_10MA_PER_MS       (50)//0.5A/ms
+
+#define CREG_MAX_SETPOINT_10MA              (500)//5A
+
+#define CREG_MIN_RAMP_TIME_MS               (1)
+#define CREG_MAX_RAMP_TIME_MS               (2000)
+#define CREG_DEFAULT_RAMP_TIME_MS           (5)
+#define CREG_DEFAULT_RAMP_PROFILE           (CREG_RAMP_S_CURVE)
+#define CREG_RAMP_TABLE_SIZE                (65)//64 interpolated segments
+
+#define CREG_FAULT_OVERCURRENT_10MA         (CREG_MAX_SETPOINT_10MA + (CREG_MAX_SETPOINT_10MA / 10))
+
+#define CREG_FAULT_NONE                     (0x00)
+#define CREG_FAULT_OVERCURRENT              (0x01)//Phase current above CREG_FAULT_OVERCURRENT_10MA
+#define CREG_FAULT_EXTERNAL                 (0x02)//CREG_TriggerFault()
+
+/******************************************************************************
+*   Public Macros
+*******************************************************************************/
+
+
+/******************************************************************************
+*   Public Data Types
+*******************************************************************************/
+typedef enum CREG_Phase_e{
+    CREG_PHASE_A,
+    CREG_PHASE_B,
+
+    CREG_PHASE_INVALID,
+}CREG_Phase_t;
+
+typedef enum CREG_Ramp_Profile_e{
+    CREG_RAMP_NONE,                     //Setpoint slew rate only
+    CREG_RAMP_LINEAR,
+    CREG_RAMP_S_CURVE,                  //Smoothstep (null slope at both ends)
+    CREG_RAMP_EXPONENTIAL,              //Fast start, slow approach
+
+    CREG_RAMP_INVALID,
+}CREG_Ramp_Profile_t;
+
+typedef struct CREG_Phase_Status_s{
+    int16_t setpoint_10ma;              //Requested setpoint
+    int16_t target_10ma;                //Slew limited setpoint
+    int16_t current_10ma;               //Latest measured current
+    uint16_t duty;                      //Latest applied duty (0.01%)
+    bool saturated;                     //Output saturated (integration frozen)
+    bool ramping;                       //Start ramp in progress
+    uint32_t time_to_target_us;         //Start to current within 1% (0 -> not reached)
+}CREG_Phase_Status_t;
+
+typedef struct CREG_Loop_Stats_s{
+    uint32_t rate_hz;                   //Loop rate
+    uint32_t nb_loops;                  //Number of loop executed
+    uint32_t nb_overruns;               //Loops longer than the loop period
+    uint32_t last_cycles;               //Last loop execution time (CPU cycles)
+    uint32_t min_cycles;                //Min loop execution time (CPU cycles)
+    uint32_t max_cycles;                //Max loop execution time (CPU cycles)
+    uint32_t avg_cycles;                //Average loop execution time (CPU cycles)
+    uint32_t max_interval_cycles;       //Max interval between 2 loops (CPU cycles)
+    uint32_t cpu_freq_hz;               //CPU cycle counter frequency
+}CREG_Loop_Stats_t;
+
+typedef enum CREG_Ret_e{
+    CREG_STATUS_ERROR,
+    CREG_STATUS_OK,
+}CREG_Ret_t;
+
+/******************************************************************************
+*   Public Variables
+*******************************************************************************/
+
+
+/******************************************************************************
+*   Error Check
+*******************************************************************************/
+
+
+/******************************************************************************
+*   Public Functions Declarations
+*******************************************************************************/
+/***************************************************************************//*!
+*  \brief Current regulator initialization.
+*
+*   This function is used to initialize the phases current regulator and the
+*   underlying hardware (loop timer, current sampling and phase outputs).
+*   The regulator is left stopped with a null setpoint.
+*
+*   Preconditions: None.
+*
+*   Side Effects: None.
+*
+*   \return     Operation status
+*
+*******************************************************************************/
+CREG_Ret_t CREG_InitRegulator(void);
+
+/***************************************************************************//*!
+*  \brief Start current regulation.
+*
+*   This function is used to start the regulation loop at the specified rate
+*   (CREG_MIN_LOOP_RATE_HZ -> CREG_MAX_LOOP_RATE_HZ). The loop restarts from
+*   a null duty and a null integrator, the setpoint ramps from 0 to the
+*   requested setpoint following the ramp profile (or the slew rate).
+*
+*   Preconditions: Regulator initialized and stopped, no fault latched,
+*                  phases not used by someone else.
+*
+*   Side Effects: None.
+*
+*   \param[in]  rate_hz             Loop rate.
+*
+*   \return     Operation status
+*
+*******************************************************************************/
+CREG_Ret_t CREG_Start(uint32_t rate_hz);
+
+/***************************************************************************//*!
+*  \brief Stop current regulation.
+*
+*   This function is used to stop the regulation loop. Both phases duty
+*   are forced to 0.
+*
+*   Preconditions: Regulator initialized.
+*
+*   Side Effects: None.
+*
+*   \return     Operation status
+*
+*******************************************************************************/
+CREG_Ret_t CREG_Stop(void);
+
+/***************************************************************************//*!
+*  \brief Is regulator running.
+*
+*   This function return if the regulation loop is running.
+*
+*   Preconditions: None.
+*
+*   Side Effects: None.
+*
+*   \return     Regulator running (True) or stopped (False)
+*
+*******************************************************************************/
+bool CREG_IsRunning(void);
+
+/***************************************************************************//*!
+*  \brief Set start ramp profile.
+*
+*   This function is used to set the setpoint ramp applied when the phases
+*   are enabled (CREG_Start() and CREG_ClearFault()). The target reaches
+*   the setpoint in ramp_time_ms at most, whatever the loop rate. Later
+*   setpoint changes follow the slew rate.
+*
+*   Preconditions: Regulator initialized and stopped.
+*
+*   Side Effects: None.
+*
+*   \param[in]  profile             Ramp profile.
+*   \param[in]  ramp_time_ms        Ramp time (CREG_MIN_RAMP_TIME_MS -> CREG_MAX_RAMP_TIME_MS).
+*
+*   \return     Operation status
+*
+*******************************************************************************/
+CREG_Ret_t CREG_SetRampProfile(CREG_Ramp_Profile_t profile, uint16_t ramp_time_ms);
+
+/***************************************************************************//*!
+*  \brief Trigger regulator fault.
+*
+*   This function is used to latch a fault: both phases duty are forced to 0
+*   immediately and held at 0 until CREG_ClearFault(), whoever drives the
+*   phases (phases tripped). Can be called from an ISR.
+*
+*   Preconditions: Regulator initialized.
+*
+*   Side Effects: None.
+*
+*   \param[in]  fault               Fault flags (CREG_FAULT_xxx).
+*
+*******************************************************************************/
+void CREG_TriggerFault(uint8_t fault);
+
+/***************************************************************************//*!
+*  \brief Get latched faults.
+*
+*   This function return the latched fault flags (CREG_FAULT_xxx).
+*
+*   Preconditions: None.
+*
+*   Side Effects: None.
+*
+*   \return     Fault flags
+*
+*******************************************************************************/
+uint8_t CREG_GetFault(void);
+
+/***************************************************************************//*!
+*  \brief Clear latched faults.
+*
+*   This function is used to clear the latched faults. If the regulator is
+*   running the phases restart with the start ramp profile (no step from 0
+*   to the setpoint).
+*
+*   Preconditions: Regulator initialized.
+*
+*   Side Effects: None.
+*
+*   \return     Operation status
+*
+*******************************************************************************/
+CREG_Ret_t CREG_ClearFault(void);
+
+/***************************************************************************//*!
+*  \brief Set phase current setpoint.
+*
+*   This function is used to set the current setpoint of a phase.
+*   In 10mA (5A -> 500). The loop reaches the new setpoint at the
+*   configured slew rate.
+*
+*   Preconditions: Regulator initialized.
+*
+*   Side Effects: None.
+*
+*   \param[in]  phase               Phase.
+*   \param[in]  setpoint_10ma       Current setpoint.
+*
+*   \return     Operation status
+*
+*******************************************************************************/
+CREG_Ret_t CREG_SetSetpoint(CREG_Phase_t phase, int16_t setpoint_10ma);
+
+/***************************************************************************//*!
+*  \brief Set phase regulator gains.
+*
+*   This function is used to set the PI gains of a phase (Q16 fixed point).
+*   Kp is in 0.01% duty per 10mA, Ki in 0.01% duty per 10mA per ms (so the
+*   gains do not depend on the loop rate). The new gains are applied by
+*   the loop at its next execution.
+*
+*   Preconditions: Regulator initialized.
+*
+*   Side Effects: None.
+*
+*   \param[in]  phase               Phase.
+*   \param[in]  kp_q16              Proportional gain.
+*   \param[in]  ki_q16              Integral gain.
+*
+*   \return     Operation status
+*
+*******************************************************************************/
+CREG_Ret_t CREG_SetGains(CREG_Phase_t phase, int32_t kp_q16, int32_t ki_q16);
+
+/***************************************************************************//*!
+*  \brief Set phase setpoint slew rate.
+*
+*   This function is used to set the maximum setpoint slew rate of a phase.
+*   In 10mA per ms (0 -> no slew rate limit).
+*
+*   Preconditions: Regulator initialized.
+*
+*   Side Effects: None.
+*
+*   \param[in]  phase               Phase.
+*   \param[in]  slew_10ma_per_ms    Slew rate.
+*
+*   \return     Operation status
+*
+*******************************************************************************/
+CREG_Ret_t CREG_SetSlewRate(CREG_Phase_t phase, uint16_t slew_10ma_per_ms);
+
+/***************************************************************************//*!
+*  \brief Get phase regulation status.
+*
+*   This function is used to get the latest regulation status of a phase.
+*
+*   Preconditions: Regulator initialized.
+*
+*   Side Effects: None.
+*
+*   \param[in]  phase               Phase.
+*   \param[out] pStatus             Pointer to store the phase status.
+*
+*   \return     Operation status
+*
+*******************************************************************************/
+CREG_Ret_t CREG_GetPhaseStatus(CREG_Phase_t phase, CREG_Phase_Status_t *pStatus);
+
+/***************************************************************************//*!
+*  \brief Get loop statistics.
+*
+*   This function is used to get the regulation loop timing statistics.
+*
+*   Preconditions: Regulator initialized.
+*
+*   Side Effects: None.
+*
+*   \param[out] pStats              Pointer to store the loop statistics.
+*
+*   \return     Operation status
+*
+*******************************************************************************/
+CREG_Ret_t CREG_GetLoopStats(CREG_Loop_Stats_t *pStats);
+
+/***************************************************************************//*!
+*  \brief Reset loop statistics.
+*
+*   This function is used to reset the regulation loop timing statistics.
+*
+*   Preconditions: Regulator initialized.
+*
+*   Side Effects: None.
+*
+*   \return     Operation status
+*
+*******************************************************************************/
+CREG_Ret_t CREG_ResetLoopStats(void);
+
+#endif//__CURRENT_REGULATOR_H
@@ -8,9 +8,13 @@
 #include "esp_adc/adc_continuous.h"
 #include "esp_adc/adc_cali.h"
 #include "esp_adc/adc_cali_scheme.h"
+#include "esp_private/adc_private.h"
 
 #include "soc/soc_caps.h"
 
+#include "taskPriority.h"
+#include "coreAffinity.h"
+#include "trace.h"
 #include "adcController.h"
 
 /******************************************************************************
@@ -34,6 +38,7 @@
 /******************************************************************************
 *   Private Functions Declaration
 *******************************************************************************/
+static esp_err_t newContinuousHandle(void *pArg);
 static volatile bool IRAM_ATTR continuous_conv_done_callback(adc_continuous_handle_t handle,
                                                              const adc_continuous_evt_data_t *data,
                                                              void *user_data);
@@ -53,6 +58,7 @@ static uint32_t active_ctrl_channels = 0;
 static volatile adcContinuousCallback_t active_continuous_callback = NULL;
 
 static SemaphoreHandle_t adc_mutex_handle = NULL;
+static StaticSemaphore_t adc_mutex_buffer;
 
 /******************************************************************************
 *   Error Check
@@ -62,12 +68,34 @@ static SemaphoreHandle_t adc_mutex_handle = NULL;
 /******************************************************************************
 *   Private Functions Definitions
 *******************************************************************************/
+/***************************************************************************//*!
+*  \brief New continuous handle.
+*
+*   This function creates the continuous sampling handle, its DMA interrupt
+*   is allocated on the calling core.
+*
+*   Preconditions: None.
+*
+*   Side Effects: None.
+*
+*   \param[in]  pArg                Pointer to the handle config.
+*
+*   \return     ESP status
+*
+*******************************************************************************/
+static esp_err_t newContinuousHandle(void *pArg){
+
+    return adc_continuous_new_handle((adc_continuous_handle_cfg_t*)pArg, &continuous_handle);
+}
+
 static volatile bool IRAM_ATTR continuous_conv_done_callback(adc_continuous_handle_t handle,
                                                              const adc_continuous_evt_data_t *data,
                                                              void *user_data){
 
     BaseType_t mustYield = pdFALSE;
 
+    TRACE_EVENT(TRACE_ADC_FRAME, data->size);
+
     //If continuous callback available -> Call it to signal sampling completion
     if(active_continuous_callback != NULL)  active_continuous_callback(data->conv_frame_buffer, data->size);
 
@@ -101,7 +129,7 @@ ADC_Ctrl_Ret_t ADC_InitController(void){
     active_ctrl_channels = 0;
 
     //Create mutex
-    adc_mutex_handle = xSemaphoreCreateMutex();
+    adc_mutex_handle = xSemaphoreCreateMutexStatic(&adc_mutex_buffer);
     if(adc_mutex_handle == NULL){
         return ADC_CTRL_STATUS_FAIL;
     }
@@ -166,6 +194,76 @@ ADC_Ctrl_Ret_t ADC_SetupTimeCriticalSampling(ADC_Ctrl_Channel_t ctrl_channel,
     return ADC_CTRL_STATUS_SUCCESS;
 }
 
+/***************************************************************************//*!
+*  \brief Setup Time Critical group sampling
+*
+*   This function is used to configure the ADC for a time critical sampling 
+*   of several channels (ex: phase currents sampled inside a control loop 
+*   interrupt). Every channel of the mask can then be sampled with
+*   ADC_StartTimeCriticalSampling().
+*   
+*   Preconditions: ADC controller available.
+*
+*   Side Effects: None.
+*
+*   \param[in]  channel_mask        ADC ctrl channels to sample.
+*   \param[in]  ctrl_atten          ADC ctrl attenuation.
+*
+*   \return     Operation status
+*
+*******************************************************************************/
+ADC_Ctrl_Ret_t ADC_SetupTimeCriticalGroup(ADC_Ctrl_Channel_Mask_t channel_mask, 
+                                          ADC_Ctrl_Atten_t ctrl_atten){
+
+    xSemaphoreTake(adc_mutex_handle, portMAX_DELAY);
+
+    if((channel_mask == 0) || (channel_mask >= (1<<ADC_CTRL_CHANNEL_INVALID))){
+        //Invalid channel mask
+        xSemaphoreGive(adc_mutex_handle);
+        return ADC_CTRL_STATUS_FAIL;
+    }
+
+    if(active_ctrl_channels != 0){
+        //ADC already in used
+        xSemaphoreGive(adc_mutex_handle);
+        return ADC_CTRL_STATUS_FAIL;
+    }
+
+    //Init unit
+    adc_oneshot_unit_init_cfg_t init_config = {
+        .unit_id = ADC_UNIT,
+        .ulp_mode = ADC_ULP_MODE_DISABLE,
+    };
+    if(ESP_OK != adc_oneshot_new_unit(&init_config, &oneshot_handle)){
+        oneshot_handle = NULL;
+        xSemaphoreGive(adc_mutex_handle);
+        return ADC_CTRL_STATUS_FAIL;
+    }
+
+    //Init every channels of the group
+    adc_oneshot_chan_cfg_t chan_config = {
+        .bitwidth = ADC_BITWIDTH_12,
+        .atten = ctrl_atten,
+    };
+    for(uint8_t i=0; i<ADC_CTRL_CHANNEL_INVALID; i++){
+        if((channel_mask & (1<<i)) == 0)    continue;
+
+        if(ESP_OK != adc_oneshot_config_channel(oneshot_handle, i, &chan_config)){
+            adc_oneshot_del_unit(oneshot_handle);
+            oneshot_handle = NULL;
+            xSemaphoreGive(adc_mutex_handle);
+            return ADC_CTRL_STATUS_FAIL;
+        }
+    }
+
+    //Update active channels
+    active_ctrl_channels = channel_mask;
+
+    xSemaphoreGive(adc_mutex_handle);
+
+    return ADC_CTRL_STATUS_SUCCESS;
+}
+
 /***************************************************************************//*!
 *  \brief Start Time Critical sampling
 *
@@ -188,7 +286,9 @@ ADC_Ctrl_Ret_t IRAM_ATTR ADC_StartTimeCriticalSampling(ADC_Ctrl_Channel_t ctrl_c
                                                        uint32_t nb_samples,
                                                        uint16_t *pResult){
 
-    if((ctrl_channel == ADC_CTRL_CHANNEL_INVALID) || (active_ctrl_channels != (1ULL<<ctrl_channel))){
+    if((ctrl_channel >= ADC_CTRL_CHANNEL_INVALID) || 
+       ((active_ctrl_channels & (1ULL<<ctrl_channel)) == 0) ||
+       (oneshot_handle == NULL) || (nb_samples == 0)){
         //Invalid channel and/or ADC not available
         return ADC_CTRL_STATUS_FAIL;
     }
@@ -196,7 +296,8 @@ ADC_Ctrl_Ret_t IRAM_ATTR ADC_StartTimeCriticalSampling(ADC_Ctrl_Channel_t ctrl_c
     uint32_t adc_value = 0;
     for(uint32_t i=0; i<nb_samples; i++){
         int tmp_adc = 0;
-        adc_oneshot_read(oneshot_handle, ctrl_channel, &tmp_adc);
+        //ISR safe read (no driver lock taken)
+        adc_oneshot_read_isr(oneshot_handle, ctrl_channel, &tmp_adc);
         adc_value += tmp_adc;
     }
     adc_value /= nb_samples;
@@ -371,7 +472,7 @@ ADC_Ctrl_Ret_t ADC_StartSampling(ADC_Ctrl_Mode_t mode, void *pConfig){
                 .max_store_buf_size = ((ADC_Ctrl_ContinuousConfig_t*)pConfig)->nb_sample * SOC_ADC_DIGI_DATA_BYTES_PER_CONV * nb_channel_mask,
                 .conv_frame_size = ((ADC_Ctrl_ContinuousConfig_t*)pConfig)->nb_sample * SOC_ADC_DIGI_DATA_BYTES_PER_CONV * nb_channel_mask,
             };
-            if(ESP_OK != adc_continuous_new_handle(&adc_config, &continuous_handle)){
+            if(ESP_OK != CORE_RunOnCore(CONTROL_ISR_CORE, newContinuousHandle, &adc_config)){
                 active_ctrl_channels = 0;
                 xSemaphoreGive(adc_mutex_handle);
                 return ADC_CTRL_STATUS_FAIL;
@@ -580,6 +681,41 @@ ADC_Ctrl_Ret_t ADC_ReleaseAdcFromCriticalSampling(ADC_Ctrl_Channel_t ctrl_channe
     return ADC_CTRL_STATUS_SUCCESS;
 }
 
+/***************************************************************************//*!
+*  \brief Release ADC controller from critial group sampling
+*
+*   This function is used to release the ADC controller from a critical group
+*   sampling setup with ADC_SetupTimeCriticalGroup().
+*   
+*   Preconditions: None.
+*
+*   Side Effects: None.
+*
+*   \param[in]  channel_mask        active controller channel mask
+*
+*   \return     Operation status
+*
+*******************************************************************************/
+ADC_Ctrl_Ret_t ADC_ReleaseAdcFromCriticalGroup(ADC_Ctrl_Channel_Mask_t channel_mask){
+
+    xSemaphoreTake(adc_mutex_handle, portMAX_DELAY);
+
+    if((channel_mask == 0) || (active_ctrl_channels != channel_mask)){
+        //Mask do not correspond to the active one
+        xSemaphoreGive(adc_mutex_handle);
+        return ADC_CTRL_STATUS_FAIL;
+    }
+
+    //De-init and release ADC
+    adc_oneshot_del_unit(oneshot_handle);
+    oneshot_handle = NULL;
+    active_ctrl_channels = 0;
+
+    xSemaphoreGive(adc_mutex_handle);
+
+    return ADC_CTRL_STATUS_SUCCESS;
+}
+
 /***************************************************************************//*!
 *  \brief Is ADC controller available
 *
@@ -93,6 +93,27 @@ ADC_Ctrl_Ret_t ADC_InitController(void);
 ADC_Ctrl_Ret_t ADC_SetupTimeCriticalSampling(ADC_Ctrl_Channel_t ctrl_channel, 
                                              ADC_Ctrl_Atten_t ctrl_atten);
 
+/***************************************************************************//*!
+*  \brief Setup Time Critical group sampling
+*
+*   This function is used to configure the ADC for a time critical sampling 
+*   of several channels (ex: phase currents sampled inside a control loop 
+*   interrupt). Every channel of the mask can then be sampled with
+*   ADC_StartTimeCriticalSampling().
+*   
+*   Preconditions: ADC controller available.
+*
+*   Side Effects: None.
+*
+*   \param[in]  channel_mask        ADC ctrl channels to sample.
+*   \param[in]  ctrl_atten          ADC ctrl attenuation.
+*
+*   \return     Operation status
+*
+*******************************************************************************/
+ADC_Ctrl_Ret_t ADC_SetupTimeCriticalGroup(ADC_Ctrl_Channel_Mask_t channel_mask, 
+                                          ADC_Ctrl_Atten_t ctrl_atten);
+
 /***************************************************************************//*!
 *  \brief Start Time Critical sampling
 *
@@ -188,6 +209,23 @@ ADC_Ctrl_Ret_t ADC_ReleaseAdcController(ADC_Ctrl_Channel_Mask_t channel_mask);
 *******************************************************************************/
 ADC_Ctrl_Ret_t ADC_ReleaseAdcFromCriticalSampling(ADC_Ctrl_Channel_t ctrl_channel);
 
+/***************************************************************************//*!
+*  \brief Release ADC controller from critial group sampling
+*
+*   This function is used to release the ADC controller from a critical group
+*   sampling setup with ADC_SetupTimeCriticalGroup().
+*   
+*   Preconditions: None.
+*
+*   Side Effects: None.
+*
+*   \param[in]  channel_mask        active controller channel mask
+*
+*   \return     Operation status
+*
+*******************************************************************************/
+ADC_Ctrl_Ret_t ADC_ReleaseAdcFromCriticalGroup(ADC_Ctrl_Channel_Mask_t channel_mask);
+
 /***************************************************************************//*!
 *  \brief Is ADC controller available
 *
@@ -0,0 +1,256 @@
+#include <stdint.h>
+
+#include "iot_button.h"
+#include "button_gpio.h"
+#include "driver/gpio.h"
+#include "freertos/FreeRTOS.h"
+#include "esp_timer.h"
+#include "esp_log.h"
+
+#include "hwi.h"
+#include "buttonDriver.h"
+
+/******************************************************************************
+*   Private Definitions
+*******************************************************************************/
+#define BTN_ACTIVE_LEVEL                    (0)//Active low, internal pull-up
+
+//Oldest raw edge that can still belong to the detected event: debounce
+//window plus one scan period of margin. Older edges are glitches.
+#define BTN_EDGE_MAX_AGE_US                 ((CONFIG_BUTTON_DEBOUNCE_TICKS + 2) * CONFIG_BUTTON_PERIOD_TIME_MS * 1000)
+
+#define LOG_LOCAL_LEVEL                     (ESP_LOG_INFO)
+
+/******************************************************************************
+*   Private Macros
+*******************************************************************************/
+#define BTN_ID_TO_CTX(id)                   ((void *)(uintptr_t)(id))
+#define BTN_CTX_TO_ID(ctx)                  ((BTN_Id_t)(uintptr_t)(ctx))
+
+/******************************************************************************
+*   Private Data Types
+*******************************************************************************/
+typedef struct BTN_Edge_s{
+    int64_t press_us;                   //First raw edge to the active level (0: none)
+    int64_t release_us;                 //First raw edge to the idle level (0: none)
+}BTN_Edge_t;
+
+typedef struct BTN_Repeat_s{
+    int64_t next_repeat_us;             //Next auto repeat time
+    uint32_t nb_repeats;
+}BTN_Repeat_t;
+
+/******************************************************************************
+*   Private Functions Declaration
+*******************************************************************************/
+static int64_t takeEdgeTime(BTN_Id_t id, bool is_press);
+static void pressDownCallback(void *button_handle, void *usr_data);
+static void pressUpCallback(void *button_handle, void *usr_data);
+static void longPressStartCallback(void *button_handle, void *usr_data);
+static void longPressHoldCallback(void *button_handle, void *usr_data);
+static void btnEdgeIsr(void *arg);
+
+/******************************************************************************
+*   Public Variables
+*******************************************************************************/
+
+
+/******************************************************************************
+*   Private Variables
+*******************************************************************************/
+static const uint8_t btn_gpio[BTN_ID_INVALID] = {
+    [BTN_ID_P]          = HWI_BTN_P_GPIO,
+    [BTN_ID_M]          = HWI_BTN_M_GPIO,
+    [BTN_ID_SELECT]     = HWI_BTN_SELECT_GPIO,
+};
+
+static button_handle_t btn_handle[BTN_ID_INVALID] = {NULL};
+static BTN_EventCallback_t event_callback = NULL;
+
+//Only accessed from the button scan context
+static BTN_Repeat_t btn_repeat[BTN_ID_INVALID];
+
+//Written by the GPIO interrupt, read from the button scan context
+static BTN_Edge_t btn_edge[BTN_ID_INVALID];
+static portMUX_TYPE btn_spinlock = portMUX_INITIALIZER_UNLOCKED;
+
+static const char * TAG = "BTN";
+
+/******************************************************************************
+*   Error Check
+*******************************************************************************/
+#if (BTN_REPEAT_FAST_PERIOD_MS > BTN_REPEAT_PERIOD_MS)
+#error "Button fast repeat period longer than the repeat period"
+#endif
+
+/******************************************************************************
+*   Private Functions Definitions
+*******************************************************************************/
+/***************************************************************************//*!
+*  \brief Take button raw edge time.
+*
+*   This function return the time of the first raw edge that led to the
+*   debounced press (release) and clears the pending edges of the button:
+*   the bounces seen before the detection are not the next event edge.
+*   An edge older than the debounce window is a glitch that never made an
+*   event, the detection time is used instead.
+*
+*   Preconditions: None.
+*
+*   Side Effects: None.
+*
+*   \param[in]  id                  Button id.
+*   \param[in]  is_press            true: press edge, false: release edge.
+*
+*   \return     Edge time (us), detection time if no edge was recorded
+*
+*******************************************************************************/
+static int64_t takeEdgeTime(BTN_Id_t id, bool is_press){
+
+    int64_t now_us = esp_timer_get_time();
+
+    portENTER_CRITICAL(&btn_spinlock);
+    int64_t edge_us = is_press ? btn_edge[id].press_us : btn_edge[id].release_us;
+    btn_edge[id].press_us = 0;
+    btn_edge[id].release_us = 0;
+    portEXIT_CRITICAL(&btn_spinlock);
+
+    return ((edge_us > 0) && (edge_us <= now_us) && ((now_us - edge_us) <= BTN_EDGE_MAX_AGE_US)) ? edge_us : now_us;
+}
+
+/******************************************************************************
+*   CallBack Functions implementation
+*******************************************************************************/
+static void pressDownCallback(void *button_handle, void *usr_data){
+
+    BTN_Id_t id = BTN_CTX_TO_ID(usr_data);
+
+    event_callback(id, BTN_EVENT_PRESS, takeEdgeTime(id, true));
+}
+
+static void pressUpCallback(void *button_handle, void *usr_data){
+
+    BTN_Id_t id = BTN_CTX_TO_ID(usr_data);
+
+    event_callback(id, BTN_EVENT_RELEASE, takeEdgeTime(id, false));
+}
+
+static void longPressStartCallback(void *button_handle, void *usr_data){
+
+    BTN_Id_t id = BTN_CTX_TO_ID(usr_data);
+    int64_t now_us = esp_timer_get_time();
+
+    btn_repeat[id].nb_repeats = 0;
+    btn_repeat[id].next_repeat_us = now_us + (BTN_REPEAT_PERIOD_MS * 1000);
+
+    event_callback(id, BTN_EVENT_LONG_PRESS, now_us);
+}
+
+static void longPressHoldCallback(void *button_handle, void *usr_data){
+
+    BTN_Id_t id = BTN_CTX_TO_ID(usr_data);
+    int64_t now_us = esp_timer_get_time();
+
+    //Hold events come at the component serial rate, repeat at our own pace
+    if(now_us < btn_repeat[id].next_repeat_us) return;
+
+    btn_repeat[id].nb_repeats++;
+    btn_repeat[id].next_repeat_us += (btn_repeat[id].nb_repeats < BTN_REPEAT_FAST_COUNT) ?
+                                     (BTN_REPEAT_PERIOD_MS * 1000) :
+                                     (BTN_REPEAT_FAST_PERIOD_MS * 1000);
+
+    event_callback(id, BTN_EVENT_REPEAT, now_us);
+}
+
+/******************************************************************************
+*   Public Functions Definitions
+*******************************************************************************/
+/***************************************************************************//*!
+*  \brief Button driver initialization.
+*
+*   This function is used to initialize the front panel buttons (P, M,
+*   SELECT). The buttons are debounced by the espressif/button component
+*   scan timer. The component power save mode is not used: the pins GPIO
+*   interrupt timestamps the first raw edge of each press/release, so the
+*   reported event time includes the scan and debounce delay.
+*
+*   Preconditions: None.
+*
+*   Side Effects: None.
+*
+*   \param[in]  callback            Button event callback.
+*
+*   \return     Operation status
+*
+*******************************************************************************/
+BTN_Ret_t BTN_InitDriver(BTN_EventCallback_t callback){
+
+    if(callback == NULL)    return BTN_STATUS_ERROR;
+
+    event_callback = callback;
+
+    button_config_t btn_config = {
+        .long_press_time = BTN_LONG_PRESS_MS,
+        .short_press_time = 0,//Component default
+    };
+
+    for(uint8_t id=0; id<BTN_ID_INVALID; id++){
+
+        button_gpio_config_t gpio_config = {
+            .gpio_num = btn_gpio[id],
+            .active_level = BTN_ACTIVE_LEVEL,
+            .enable_power_save = false,//GPIO interrupt used for the edge time
+            .disable_pull = false,
+        };
+
+        if(ESP_OK != iot_button_new_gpio_device(&btn_config, &gpio_config, &btn_handle[id])){
+            ESP_LOGE(TAG, "Failed to create button on GPIO %u", btn_gpio[id]);
+            return BTN_STATUS_ERROR;
+        }
+
+        if((ESP_OK != iot_button_register_cb(btn_handle[id], BUTTON_PRESS_DOWN, NULL, pressDownCallback, BTN_ID_TO_CTX(id))) ||
+           (ESP_OK != iot_button_register_cb(btn_handle[id], BUTTON_PRESS_UP, NULL, pressUpCallback, BTN_ID_TO_CTX(id))) ||
+           (ESP_OK != iot_button_register_cb(btn_handle[id], BUTTON_LONG_PRESS_START, NULL, longPressStartCallback, BTN_ID_TO_CTX(id))) ||
+           (ESP_OK != iot_button_register_cb(btn_handle[id], BUTTON_LONG_PRESS_HOLD, NULL, longPressHoldCallback, BTN_ID_TO_CTX(id)))){
+
+            ESP_LOGE(TAG, "Failed to register button %u callbacks", id);
+            return BTN_STATUS_ERROR;
+        }
+    }
+
+    //Raw edge timestamps (service may already be installed by another driver)
+    esp_err_t err = gpio_install_isr_service(0);
+    if((err != ESP_OK) && (err != ESP_ERR_INVALID_STATE)){
+        ESP_LOGE(TAG, "Failed to install GPIO ISR service");
+        return BTN_STATUS_ERROR;
+    }
+
+    for(uint8_t id=0; id<BTN_ID_INVALID; id++){
+        if((ESP_OK != gpio_set_intr_type(btn_gpio[id], GPIO_INTR_ANYEDGE)) ||
+           (ESP_OK != gpio_isr_handler_add(btn_gpio[id], btnEdgeIsr, BTN_ID_TO_CTX(id))) ||
+           (ESP_OK != gpio_intr_enable(btn_gpio[id]))){
+
+            ESP_LOGE(TAG, "Failed to setup button %u edge interrupt", id);
+            return BTN_STATUS_ERROR;
+        }
+    }
+
+    return BTN_STATUS_OK;
+}
+
+/******************************************************************************
+*   Interrupts
+*******************************************************************************/
+static void IRAM_ATTR btnEdgeIsr(void *arg){
+
+    BTN_Id_t id = BTN_CTX_TO_ID(arg);
+    int64_t now_us = esp_timer_get_time();
+    bool is_active = (gpio_get_level(btn_gpio[id]) == BTN_ACTIVE_LEVEL);
+
+    //Keep the first edge only, the bounces that follow are not the input time.
+    //An edge left by a glitch (no event) is replaced once out of the window.
+    portENTER_CRITICAL_ISR(&btn_spinlock);
+    int64_t *pEdge_us = is_active ? &btn_edge[id].press_us : &btn_edge[id].release_us;
+    if((*pEdge_us == 0) || ((now_us - *pEdge_us) > BTN_EDGE_MAX_AGE_US))    *pEdge_us = now_us;
+    portEXIT_CRITICAL_ISR(&btn_spinlock);
+}
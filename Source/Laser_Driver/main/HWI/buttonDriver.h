@@ -0,0 +1,82 @@
+#ifndef __BUTTON_DRIVER_H
+#define __BUTTON_DRIVER_H
+
+#include <stdint.h>
+
+/******************************************************************************
+*   Public Definitions
+*******************************************************************************/
+#define BTN_LONG_PRESS_MS                   (500)
+#define BTN_REPEAT_PERIOD_MS                (120)//Auto repeat after a long press
+#define BTN_REPEAT_FAST_PERIOD_MS           (40)
+#define BTN_REPEAT_FAST_COUNT               (8)//Repeats before the fast period
+
+/******************************************************************************
+*   Public Macros
+*******************************************************************************/
+
+
+/******************************************************************************
+*   Public Data Types
+*******************************************************************************/
+typedef enum BTN_Id_e{
+    BTN_ID_P,
+    BTN_ID_M,
+    BTN_ID_SELECT,
+
+    BTN_ID_INVALID,
+}BTN_Id_t;
+
+typedef enum BTN_Event_e{
+    BTN_EVENT_PRESS,                    //Debounced press
+    BTN_EVENT_LONG_PRESS,               //Held for BTN_LONG_PRESS_MS
+    BTN_EVENT_REPEAT,                   //Auto repeat while held after a long press
+    BTN_EVENT_RELEASE,
+
+    BTN_EVENT_INVALID,
+}BTN_Event_t;
+
+//Called from the button scan context (esp_timer task), must not block.
+//timestamp_us is the esp_timer time of the first raw edge for a press or a
+//release (before scan/debounce), of the event detection otherwise.
+typedef void(*BTN_EventCallback_t)(BTN_Id_t id, BTN_Event_t event, int64_t timestamp_us);
+
+typedef enum BTN_Ret_e{
+    BTN_STATUS_ERROR,
+    BTN_STATUS_OK,
+}BTN_Ret_t;
+
+/******************************************************************************
+*   Public Variables
+*******************************************************************************/
+
+
+/******************************************************************************
+*   Error Check
+*******************************************************************************/
+
+
+/******************************************************************************
+*   Public Functions Declarations
+*******************************************************************************/
+/***************************************************************************//*!
+*  \brief Button driver initialization.
+*
+*   This function is used to initialize the front panel buttons (P, M,
+*   SELECT). The buttons are debounced by the espressif/button component
+*   scan timer. The component power save mode is not used: the pins GPIO
+*   interrupt timestamps the first raw edge of each press/release, so the
+*   reported event time includes the scan and debounce delay.
+*
+*   Preconditions: None.
+*
+*   Side Effects: None.
+*
+*   \param[in]  callback            Button event callback.
+*
+*   \return     Operation status
+*
+*******************************************************************************/
+BTN_Ret_t BTN_InitDriver(BTN_EventCallback_t callback);
+
+#endif//__BUTTON_DRIVER_H
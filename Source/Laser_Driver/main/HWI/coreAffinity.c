@@ -0,0 +1,497 @@
+#include <string.h>
+#include <stdlib.h>
+
+#include "freertos/FreeRTOS.h"
+#include "freertos/semphr.h"
+#include "freertos/task.h"
+
+#include "driver/gptimer.h"
+#include "esp_attr.h"
+#include "esp_log.h"
+#include "esp_timer.h"
+
+#include "taskPriority.h"
+#include "coreAffinity.h"
+
+/******************************************************************************
+*   Private Definitions
+*******************************************************************************/
+#define CORE_RUN_STACK_SIZE                 (4096)//Driver installs
+
+#define CORE_BENCH_TIMER_RESOLUTION_HZ      (10000000)//10MHz -> 100ns per tick
+#define CORE_BENCH_NS_PER_TICK              (1000000000 / CORE_BENCH_TIMER_RESOLUTION_HZ)
+#define CORE_BENCH_HIST_STEP_NS             (1000)//Latency histogram, 1us per bin
+#define CORE_BENCH_HIST_SIZE                (256)//Last bin: 255us and above
+#define CORE_BENCH_PROBE_WAIT_MS            (10)//Probe end check without interrupt
+#define CORE_BENCH_LOAD_BUFFER_SIZE         (16384)//Copied back and forth, above the cache line set
+#define CORE_BENCH_LOAD_BUSY_US             (800)//Load busy time per tick
+#define CORE_BENCH_STACK_SIZE               (2048)
+
+#define LOG_LOCAL_LEVEL                     (ESP_LOG_INFO)
+
+/******************************************************************************
+*   Private Macros
+*******************************************************************************/
+
+
+/******************************************************************************
+*   Private Data Types
+*******************************************************************************/
+typedef struct CORE_Run_s{
+    CORE_Function_t function;
+    void *pArg;
+    esp_err_t ret;
+    StaticSemaphore_t done_buffer;
+    SemaphoreHandle_t done_handle;
+}CORE_Run_t;
+
+/******************************************************************************
+*   Private Functions Declaration
+*******************************************************************************/
+static void tRunTask(void *pvParameters);
+static esp_err_t newBenchTimer(void *pArg);
+static void computeLatency(CORE_Latency_t *pLatency);
+static bool runBench(BaseType_t probe_core_id, uint32_t duration_ms, CORE_Latency_t *pLatency);
+static bool benchTimerCallback(gptimer_handle_t timer,
+                               const gptimer_alarm_event_data_t *edata,
+                               void *user_ctx);
+static void tProbeTask(void *pvParameters);
+static void tLoadTask(void *pvParameters);
+
+/******************************************************************************
+*   Public Variables
+*******************************************************************************/
+
+
+/******************************************************************************
+*   Private Variables
+*******************************************************************************/
+static portMUX_TYPE bench_spinlock = portMUX_INITIALIZER_UNLOCKED;
+static bool is_bench_running = false;
+
+//Benchmark run (one at a time)
+static gptimer_handle_t bench_timer_handle = NULL;
+static volatile TaskHandle_t probe_task_handle = NULL;
+static SemaphoreHandle_t bench_done_handle = NULL;
+static StaticSemaphore_t bench_done_buffer;
+static volatile bool is_bench_stopping = false;
+
+//Probe results (owned by the probe task during a run)
+static uint32_t latency_hist[CORE_BENCH_HIST_SIZE];
+static uint32_t nb_samples = 0;
+static uint32_t nb_missed = 0;
+static uint32_t min_ns = 0;
+static uint32_t max_ns = 0;
+static uint64_t sum_ns = 0;
+
+static const char * TAG = "CORE";
+
+/******************************************************************************
+*   Error Check
+*******************************************************************************/
+#if (CORE_BENCH_TIMER_RESOLUTION_HZ / 1000000 * CORE_BENCH_PERIOD_US) <= (CORE_BENCH_HIST_SIZE * CORE_BENCH_HIST_STEP_NS / CORE_BENCH_NS_PER_TICK)
+#error "Benchmark period must be above the histogram range"
+#endif
+
+/******************************************************************************
+*   Private Functions Definitions
+*******************************************************************************/
+/***************************************************************************//*!
+*  \brief Run task.
+*
+*   This function is the temporary task running a function on a core.
+*
+*   Preconditions: None.
+*
+*   Side Effects: Deletes itself.
+*
+*   \param[in]  pvParameters        Run context.
+*
+*******************************************************************************/
+static void tRunTask(void *pvParameters){
+
+    CORE_Run_t *pRun = (CORE_Run_t*)pvParameters;
+
+    pRun->ret = pRun->function(pRun->pArg);
+    xSemaphoreGive(pRun->done_handle);
+
+    vTaskDelete(NULL);
+}
+
+/***************************************************************************//*!
+*  \brief New benchmark timer.
+*
+*   This function creates the benchmark timer, its interrupt is allocated
+*   on the calling core (callbacks registration).
+*
+*   Preconditions: None.
+*
+*   Side Effects: None.
+*
+*   \param[out] pArg                Pointer to store the timer handle.
+*
+*   \return     ESP status
+*
+*******************************************************************************/
+static esp_err_t newBenchTimer(void *pArg){
+
+    gptimer_handle_t *pTimer = (gptimer_handle_t*)pArg;
+
+    gptimer_config_t timer_config = {
+        .clk_src = GPTIMER_CLK_SRC_DEFAULT,
+        .direction = GPTIMER_COUNT_UP,
+        .resolution_hz = CORE_BENCH_TIMER_RESOLUTION_HZ,
+    };
+    esp_err_t ret = gptimer_new_timer(&timer_config, pTimer);
+    if(ret != ESP_OK)   return ret;
+
+    gptimer_event_callbacks_t timer_cbs = {
+        .on_alarm = benchTimerCallback,
+    };
+    ret = gptimer_register_event_callbacks(*pTimer, &timer_cbs, NULL);
+    if(ret != ESP_OK){
+        gptimer_del_timer(*pTimer);
+        *pTimer = NULL;
+    }
+
+    return ret;
+}
+
+/***************************************************************************//*!
+*  \brief Compute latency.
+*
+*   This function computes the latency results of the last run.
+*
+*   Preconditions: Probe task ended.
+*
+*   Side Effects: None.
+*
+*   \param[out] pLatency            Latency results.
+*
+*******************************************************************************/
+static void computeLatency(CORE_Latency_t *pLatency){
+
+    memset(pLatency, 0, sizeof(CORE_Latency_t));
+    pLatency->nb_samples = nb_samples;
+    pLatency->nb_missed = nb_missed;
+    if(nb_samples == 0) return;
+
+    pLatency->min_ns = min_ns;
+    pLatency->max_ns = max_ns;
+    pLatency->avg_ns = (uint32_t)(sum_ns / nb_samples);
+
+    //99th percentile, upper bound of its bin
+    uint32_t p99_rank = nb_samples - (nb_samples / 100);
+    uint32_t count = 0;
+    for(uint32_t bin=0; bin<CORE_BENCH_HIST_SIZE; bin++){
+        count += latency_hist[bin];
+        if(count >= p99_rank){
+            pLatency->p99_ns = (bin + 1) * CORE_BENCH_HIST_STEP_NS;
+            break;
+        }
+    }
+    if(pLatency->p99_ns > max_ns)   pLatency->p99_ns = max_ns;
+}
+
+/***************************************************************************//*!
+*  \brief Run benchmark.
+*
+*   This function runs the probe on a core (or without affinity) with the
+*   load task on the I/O core, for the run duration.
+*
+*   Preconditions: Benchmark timer and done semaphore created.
+*
+*   Side Effects: Blocks the caller duration_ms.
+*
+*   \param[in]  probe_core_id       Probe core (tskNO_AFFINITY: floating).
+*   \param[in]  duration_ms         Run duration.
+*   \param[out] pLatency            Latency results.
+*
+*   \return     true if the run completed
+*
+*******************************************************************************/
+static bool runBench(BaseType_t probe_core_id, uint32_t duration_ms, CORE_Latency_t *pLatency){
+
+    memset(latency_hist, 0, sizeof(latency_hist));
+    nb_samples = 0;
+    nb_missed = 0;
+    min_ns = UINT32_MAX;
+    max_ns = 0;
+    sum_ns = 0;
+    is_bench_stopping = false;
+
+    if(pdPASS != xTaskCreatePinnedToCore(tLoadTask,
+                                         "Core load",
+                                         CORE_BENCH_STACK_SIZE,
+                                         NULL,
+                                         UI_TASK_PRIORITY,
+                                         NULL,
+                                         TASK_CORE(IO_CORE_ID))){
+
+        return false;
+    }
+
+    TaskHandle_t task_handle = NULL;
+    if(pdPASS != xTaskCreatePinnedToCore(tProbeTask,
+                                         "Core probe",
+                                         CORE_BENCH_STACK_SIZE,
+                                         NULL,
+                                         SENSOR_TASK_PRIORITY,
+                                         &task_handle,
+                                         probe_core_id)){
+
+        is_bench_stopping = true;
+        xSemaphoreTake(bench_done_handle, portMAX_DELAY);
+        return false;
+    }
+    probe_task_handle = task_handle;
+
+    gptimer_alarm_config_t alarm_config = {
+        .alarm_count = (uint64_t)CORE_BENCH_TIMER_RESOLUTION_HZ / 1000000 * CORE_BENCH_PERIOD_US,
+        .reload_count = 0,
+        .flags.auto_reload_on_alarm = true,
+    };
+    gptimer_set_raw_count(bench_timer_handle, 0);
+    gptimer_set_alarm_action(bench_timer_handle, &alarm_config);
+    gptimer_enable(bench_timer_handle);
+    gptimer_start(bench_timer_handle);
+
+    vTaskDelay(pdMS_TO_TICKS(duration_ms));
+
+    gptimer_stop(bench_timer_handle);
+    gptimer_disable(bench_timer_handle);
+
+    //Probe and load tasks end on their next check
+    is_bench_stopping = true;
+    xSemaphoreTake(bench_done_handle, portMAX_DELAY);
+    xSemaphoreTake(bench_done_handle, portMAX_DELAY);
+    probe_task_handle = NULL;
+
+    computeLatency(pLatency);
+
+    return true;
+}
+
+/***************************************************************************//*!
+*  \brief Probe task.
+*
+*   This function is the benchmark probe: it wakes up on the timer
+*   interrupt and reads the timer count since the alarm (reload at 0).
+*
+*   Preconditions: None.
+*
+*   Side Effects: Deletes itself.
+*
+*******************************************************************************/
+static void tProbeTask(void *pvParameters){
+
+    while(!is_bench_stopping){
+        uint32_t nb_notify = ulTaskNotifyTake(pdTRUE, pdMS_TO_TICKS(CORE_BENCH_PROBE_WAIT_MS));
+        uint64_t count = 0;
+        gptimer_get_raw_count(bench_timer_handle, &count);
+        if(nb_notify == 0)  continue;
+
+        //Late by a period or more: the count restarted, not measured
+        if(nb_notify > 1){
+            nb_missed += nb_notify - 1;
+            continue;
+        }
+
+        uint32_t latency_ns = (uint32_t)count * CORE_BENCH_NS_PER_TICK;
+        uint32_t bin = latency_ns / CORE_BENCH_HIST_STEP_NS;
+        if(bin >= CORE_BENCH_HIST_SIZE) bin = CORE_BENCH_HIST_SIZE - 1;
+
+        latency_hist[bin]++;
+        nb_samples++;
+        sum_ns += latency_ns;
+        if(latency_ns < min_ns) min_ns = latency_ns;
+        if(latency_ns > max_ns) max_ns = latency_ns;
+    }
+
+    xSemaphoreGive(bench_done_handle);
+    vTaskDelete(NULL);
+}
+
+/***************************************************************************//*!
+*  \brief Load task.
+*
+*   This function stands for the user interface work on the I/O core: it
+*   copies a buffer larger than the cache line set for CORE_BENCH_LOAD_BUSY_US
+*   every tick.
+*
+*   Preconditions: None.
+*
+*   Side Effects: Deletes itself.
+*
+*******************************************************************************/
+static void tLoadTask(void *pvParameters){
+
+    uint8_t *pBuffer = malloc(2 * CORE_BENCH_LOAD_BUFFER_SIZE);
+
+    while(!is_bench_stopping){
+        if(pBuffer != NULL){
+            int64_t start_us = esp_timer_get_time();
+            while((esp_timer_get_time() - start_us) < CORE_BENCH_LOAD_BUSY_US){
+                memcpy(pBuffer, &pBuffer[CORE_BENCH_LOAD_BUFFER_SIZE], CORE_BENCH_LOAD_BUFFER_SIZE);
+                memcpy(&pBuffer[CORE_BENCH_LOAD_BUFFER_SIZE], pBuffer, CORE_BENCH_LOAD_BUFFER_SIZE);
+            }
+        }
+        vTaskDelay(1);
+    }
+
+    free(pBuffer);
+    xSemaphoreGive(bench_done_handle);
+    vTaskDelete(NULL);
+}
+
+/******************************************************************************
+*   CallBack Functions implementation
+*******************************************************************************/
+/***************************************************************************//*!
+*  \brief Benchmark timer callback.
+*
+*   This function is the benchmark timer alarm interrupt: it wakes up the
+*   probe task.
+*
+*   Preconditions: None.
+*
+*   Side Effects: None.
+*
+*   \return     true if a higher priority task was woken
+*
+*******************************************************************************/
+static bool IRAM_ATTR benchTimerCallback(gptimer_handle_t timer,
+                                         const gptimer_alarm_event_data_t *edata,
+                                         void *user_ctx){
+
+    BaseType_t task_woken = pdFALSE;
+    TaskHandle_t task_handle = probe_task_handle;
+
+    if(task_handle != NULL) vTaskNotifyGiveFromISR(task_handle, &task_woken);
+
+    return (task_woken == pdTRUE);
+}
+
+/******************************************************************************
+*   Public Functions Definitions
+*******************************************************************************/
+/***************************************************************************//*!
+*  \brief Run on core.
+*
+*   This function runs a function on a core and waits for it: the drivers
+*   allocate their interrupt on the core installing them, so the install
+*   follows the task placement plan (taskPriority.h). The function runs in
+*   a temporary task pinned to the core, at the caller priority.
+*
+*   Preconditions: Called from a task.
+*
+*   Side Effects: None.
+*
+*   \param[in]  core_id             Core (tskNO_AFFINITY: caller core).
+*   \param[in]  function            Function.
+*   \param[in]  pArg                Function argument.
+*
+*   \return     Function return value (ESP_ERR_NO_MEM if the task failed)
+*
+*******************************************************************************/
+esp_err_t CORE_RunOnCore(BaseType_t core_id, CORE_Function_t function, void *pArg){
+
+    if(function == NULL)    return ESP_ERR_INVALID_ARG;
+    if(core_id == tskNO_AFFINITY)   return function(pArg);
+
+    CORE_Run_t run = {
+        .function = function,
+        .pArg = pArg,
+        .ret = ESP_FAIL,
+    };
+    run.done_handle = xSemaphoreCreateBinaryStatic(&run.done_buffer);
+
+    if(pdPASS != xTaskCreatePinnedToCore(tRunTask,
+                                         "Core run",
+                                         CORE_RUN_STACK_SIZE,
+                                         &run,
+                                         uxTaskPriorityGet(NULL),
+                                         NULL,
+                                         core_id)){
+
+        vSemaphoreDelete(run.done_handle);
+        return ESP_ERR_NO_MEM;
+    }
+
+    xSemaphoreTake(run.done_handle, portMAX_DELAY);
+    vSemaphoreDelete(run.done_handle);
+
+    return run.ret;
+}
+
+/***************************************************************************//*!
+*  \brief Core latency benchmark.
+*
+*   This function measures the latency from a periodic timer interrupt
+*   (control core) to a probe task at the sensor task priority, while a
+*   load task stands for the UI work on the I/O core. It runs the probe
+*   pinned to the control core, then without affinity.
+*
+*   Preconditions: Called from a task.
+*
+*   Side Effects: Blocks the caller 2 x duration_ms.
+*
+*   \param[in]  duration_ms         Run duration (CORE_BENCH_MIN_DURATION_MS to
+*                                   CORE_BENCH_MAX_DURATION_MS).
+*   \param[out] pBench              Benchmark results.
+*
+*   \return     Operation status
+*
+*******************************************************************************/
+CORE_Ret_t CORE_BenchLatency(uint32_t duration_ms, CORE_Bench_t *pBench){
+
+    if((pBench == NULL) ||
+       (duration_ms < CORE_BENCH_MIN_DURATION_MS) ||
+       (duration_ms > CORE_BENCH_MAX_DURATION_MS)){
+
+        return CORE_STATUS_ERROR;
+    }
+
+    portENTER_CRITICAL(&bench_spinlock);
+    bool is_busy = is_bench_running;
+    is_bench_running = true;
+    portEXIT_CRITICAL(&bench_spinlock);
+    if(is_busy) return CORE_STATUS_ERROR;
+
+    memset(pBench, 0, sizeof(CORE_Bench_t));
+    pBench->duration_ms = duration_ms;
+
+    CORE_Ret_t ret = CORE_STATUS_ERROR;
+    bench_done_handle = xSemaphoreCreateCountingStatic(2, 0, &bench_done_buffer);
+    if(bench_done_handle == NULL){
+        ESP_LOGE(TAG, "Failed to create bench semaphore");
+    }
+    else if(ESP_OK != CORE_RunOnCore(CONTROL_ISR_CORE, newBenchTimer, &bench_timer_handle)){
+        ESP_LOGE(TAG, "Failed to create bench timer");
+    }
+    else{
+        if(runBench(SENSOR_TASK_CORE, duration_ms, &pBench->pinned) &&
+           runBench(tskNO_AFFINITY, duration_ms, &pBench->floating)){
+
+            ret = CORE_STATUS_OK;
+        }
+        gptimer_del_timer(bench_timer_handle);
+        bench_timer_handle = NULL;
+    }
+
+    if(bench_done_handle != NULL){
+        vSemaphoreDelete(bench_done_handle);
+        bench_done_handle = NULL;
+    }
+
+    portENTER_CRITICAL(&bench_spinlock);
+    is_bench_running = false;
+    portEXIT_CRITICAL(&bench_spinlock);
+
+    return ret;
+}
+
+/******************************************************************************
+*   Interrupts
+*******************************************************************************/
+
@@ -0,0 +1,101 @@
+#ifndef __CORE_AFFINITY_H
+#define __CORE_AFFINITY_H
+
+#include <stdint.h>
+#include <stdbool.h>
+
+#include "freertos/FreeRTOS.h"
+#include "esp_err.h"
+
+/******************************************************************************
+*   Public Definitions
+*******************************************************************************/
+#define CORE_BENCH_PERIOD_US                (1000)//Timer interrupt period
+#define CORE_BENCH_MIN_DURATION_MS          (100)
+#define CORE_BENCH_MAX_DURATION_MS          (10000)
+
+/******************************************************************************
+*   Public Macros
+*******************************************************************************/
+//Function run on a core (driver install: interrupt allocated on that core)
+typedef esp_err_t (*CORE_Function_t)(void *pArg);
+
+/******************************************************************************
+*   Public Data Types
+*******************************************************************************/
+typedef struct CORE_Latency_s{
+    uint32_t nb_samples;                //Task wakeups measured
+    uint32_t nb_missed;                 //Interrupts without a task wakeup
+    uint32_t min_ns;                    //Timer interrupt to task latency
+    uint32_t avg_ns;
+    uint32_t p99_ns;
+    uint32_t max_ns;
+}CORE_Latency_t;
+
+typedef struct CORE_Bench_s{
+    uint32_t duration_ms;               //Per run
+    CORE_Latency_t pinned;              //Probe pinned to the control core
+    CORE_Latency_t floating;            //Probe without affinity
+}CORE_Bench_t;
+
+typedef enum CORE_Ret_e{
+    CORE_STATUS_ERROR,
+    CORE_STATUS_OK,
+}CORE_Ret_t;
+
+/******************************************************************************
+*   Public Variables
+*******************************************************************************/
+
+
+/******************************************************************************
+*   Error Check
+*******************************************************************************/
+
+
+/******************************************************************************
+*   Public Functions Declarations
+*******************************************************************************/
+/***************************************************************************//*!
+*  \brief Run on core.
+*
+*   This function runs a function on a core and waits for it: the drivers
+*   allocate their interrupt on the core installing them, so the install
+*   follows the task placement plan (taskPriority.h). The function runs in
+*   a temporary task pinned to the core, at the caller priority.
+*
+*   Preconditions: Called from a task.
+*
+*   Side Effects: None.
+*
+*   \param[in]  core_id             Core (tskNO_AFFINITY: caller core).
+*   \param[in]  function            Function.
+*   \param[in]  pArg                Function argument.
+*
+*   \return     Function return value (ESP_ERR_NO_MEM if the task failed)
+*
+*******************************************************************************/
+esp_err_t CORE_RunOnCore(BaseType_t core_id, CORE_Function_t function, void *pArg);
+
+/***************************************************************************//*!
+*  \brief Core latency benchmark.
+*
+*   This function measures the latency from a periodic timer interrupt
+*   (control core) to a probe task at the sensor task priority, while a
+*   load task stands for the UI work on the I/O core. It runs the probe
+*   pinned to the control core, then without affinity.
+*
+*   Preconditions: Called from a task.
+*
+*   Side Effects: Blocks the caller 2 x duration_ms.
+*
+*   \param[in]  duration_ms         Run duration (CORE_BENCH_MIN_DURATION_MS to
+*                                   CORE_BENCH_MAX_DURATION_MS).
+*   \param[out] pBench              Benchmark results.
+*
+*   \return     Operation status
+*
+*******************************************************************************/
+CORE_Ret_t CORE_BenchLatency(uint32_t duration_ms, CORE_Bench_t *pBench);
+
+#endif//__CORE_AFFINITY_H
@@ -0,0 +1,666 @@
+#include "freertos/FreeRTOS.h"
+
+#include "driver/gpio.h"
+#include "driver/mcpwm_prelude.h"
+#include "esp_log.h"
+
+#include "hwi.h"
+#include "phaseDriver.h"
+
+/******************************************************************************
+*   Private Definitions
+*******************************************************************************/
+#define PHASE_MCPWM_GROUP                   (0)
+#define PHASE_TIMER_RESOLUTION_HZ           (10000000)//10MHz -> 0.1us per tick
+#define PHASE_PWM_FREQ_HZ                   (20000)
+#define PHASE_PERIOD_TICKS                  (PHASE_TIMER_RESOLUTION_HZ/PHASE_PWM_FREQ_HZ)
+#define PHASE_MAX_SHIFT_DEG                 (360)
+#define PHASE_SAMPLE_OFF_TICKS              (PHASE_PERIOD_TICKS)//Never reached (counter 0 -> period-1): no compare event
+
+#define LOG_LOCAL_LEVEL                     (ESP_LOG_INFO)
+
+/******************************************************************************
+*   Private Macros
+*******************************************************************************/
+#define DUTY_TO_TICKS(duty)                 (((uint32_t)(duty) * PHASE_PERIOD_TICKS) / PHASE_DUTY_FULL_SCALE)
+//Phase B counter value loaded when phase A counter restarts (B lags A by shift_deg)
+#define SHIFT_TO_SYNC_TICKS(shift_deg)      ((((PHASE_MAX_SHIFT_DEG - (uint32_t)(shift_deg)) % PHASE_MAX_SHIFT_DEG) * PHASE_PERIOD_TICKS) / PHASE_MAX_SHIFT_DEG)
+
+/******************************************************************************
+*   Private Data Types
+*******************************************************************************/
+typedef struct PHASE_Output_s{
+    mcpwm_timer_handle_t timer;
+    mcpwm_oper_handle_t oper;
+    mcpwm_cmpr_handle_t cmpr;
+    mcpwm_cmpr_handle_t sample_cmpr;
+    mcpwm_gen_handle_t gen;
+    volatile uint16_t duty;
+    volatile uint32_t sample_ticks;     //Middle of the on-time
+    volatile bool sample_armed;
+}PHASE_Output_t;
+
+/******************************************************************************
+*   Private Functions Declaration
+*******************************************************************************/
+static PHASE_Ret_t setupPhaseOutput(PHASE_Output_t *pOutput, uint8_t gpio_num);
+static bool sampleCmprCallback(mcpwm_cmpr_handle_t comparator,
+                               const mcpwm_compare_event_data_t *edata,
+                               void *user_ctx);
+
+/******************************************************************************
+*   Public Variables
+*******************************************************************************/
+
+
+/******************************************************************************
+*   Private Variables
+*******************************************************************************/
+static PHASE_Output_t phase_outputs[PHASE_ID_INVALID];
+static mcpwm_sync_handle_t phase_sync_handle = NULL;
+static uint16_t phase_shift_deg = PHASE_DEFAULT_SHIFT_DEG;
+static volatile PHASE_SampleCallback_t sample_callback = NULL;
+
+//Phases use (under phase_spinlock)
+static portMUX_TYPE phase_spinlock = portMUX_INITIALIZER_UNLOCKED;
+static volatile PHASE_Owner_t phase_owner = PHASE_OWNER_NONE;
+static volatile bool is_tripped = false;
+
+static const uint8_t phase_gpios[PHASE_ID_INVALID] = {
+    [PHASE_ID_A] = HWI_PA_DIM_GPIO,
+    [PHASE_ID_B] = HWI_PB_DIM_GPIO,
+};
+
+static const char * TAG = "PHASE";
+
+/******************************************************************************
+*   Error Check
+*******************************************************************************/
+#if (PHASE_PERIOD_TICKS > 0xFFFF)
+#error "Phase PWM period does not fit the MCPWM timer"
+#endif
+
+#if (PHASE_DEFAULT_SHIFT_DEG >= PHASE_MAX_SHIFT_DEG)
+#error "Invalid default phase shift"
+#endif
+
+/******************************************************************************
+*   Private Functions Definitions
+*******************************************************************************/
+/***************************************************************************//*!
+*  \brief Setup phase output.
+*
+*   This function is used to allocate and configure the MCPWM resources
+*   (timer/operator/comparators/generator) of a phase dimming output. The
+*   output is high at the start of the period and low on compare match.
+*   A second comparator is moved to the middle of the on-time when a
+*   sample is requested and is used to trigger the phase current sampling
+*   (out of the counter range otherwise: no interrupt). The timer is not
+*   started.
+*
+*   Preconditions: None.
+*
+*   Side Effects: None.
+*
+*   \param[in]  pOutput             Pointer to phase output.
+*   \param[in]  gpio_num            Dimming gpio.
+*
+*   \return     Operation status
+*
+*******************************************************************************/
+static PHASE_Ret_t setupPhaseOutput(PHASE_Output_t *pOutput, uint8_t gpio_num){
+
+    mcpwm_timer_config_t timer_config = {
+        .group_id = PHASE_MCPWM_GROUP,
+        .clk_src = MCPWM_TIMER_CLK_SRC_DEFAULT,
+        .resolution_hz = PHASE_TIMER_RESOLUTION_HZ,
+        .count_mode = MCPWM_TIMER_COUNT_MODE_UP,
+        .period_ticks = PHASE_PERIOD_TICKS,
+    };
+    if(ESP_OK != mcpwm_new_timer(&timer_config, &pOutput->timer)){
+        return PHASE_STATUS_ERROR;
+    }
+
+    mcpwm_operator_config_t oper_config = {
+        .group_id = PHASE_MCPWM_GROUP,
+    };
+    if(ESP_OK != mcpwm_new_operator(&oper_config, &pOutput->oper)){
+        return PHASE_STATUS_ERROR;
+    }
+
+    if(ESP_OK != mcpwm_operator_connect_timer(pOutput->oper, pOutput->timer)){
+        return PHASE_STATUS_ERROR;
+    }
+
+    //Compare value is updated when the timer counts to zero (glitch free)
+    mcpwm_comparator_config_t cmpr_config = {
+        .flags.update_cmp_on_tez = true,
+    };
+    if(ESP_OK != mcpwm_new_comparator(pOutput->oper, &cmpr_config, &pOutput->cmpr)){
+        return PHASE_STATUS_ERROR;
+    }
+
+    if(ESP_OK != mcpwm_new_comparator(pOutput->oper, &cmpr_config, &pOutput->sample_cmpr)){
+        return PHASE_STATUS_ERROR;
+    }
+
+    mcpwm_comparator_event_callbacks_t cmpr_cbs = {
+        .on_reach = sampleCmprCallback,
+    };
+    if(ESP_OK != mcpwm_comparator_register_event_callbacks(pOutput->sample_cmpr, &cmpr_cbs, pOutput)){
+        return PHASE_STATUS_ERROR;
+    }
+
+    mcpwm_generator_config_t gen_config = {
+        .gen_gpio_num = gpio_num,
+    };
+    if(ESP_OK != mcpwm_new_generator(pOutput->oper, &gen_config, &pOutput->gen)){
+        return PHASE_STATUS_ERROR;
+    }
+
+    //Start with a 0% duty-cycle, no sample requested
+    pOutput->duty = 0;
+    pOutput->sample_ticks = 0;
+    pOutput->sample_armed = false;
+    if((ESP_OK != mcpwm_comparator_set_compare_value(pOutput->cmpr, 0)) ||
+       (ESP_OK != mcpwm_comparator_set_compare_value(pOutput->sample_cmpr, PHASE_SAMPLE_OFF_TICKS))){
+        return PHASE_STATUS_ERROR;
+    }
+
+    //High on empty, low on compare
+    if(ESP_OK != mcpwm_generator_set_action_on_timer_event(pOutput->gen,
+                    MCPWM_GEN_TIMER_EVENT_ACTION(MCPWM_TIMER_DIRECTION_UP, MCPWM_TIMER_EVENT_EMPTY, MCPWM_GEN_ACTION_HIGH))){
+        return PHASE_STATUS_ERROR;
+    }
+    if(ESP_OK != mcpwm_generator_set_action_on_compare_event(pOutput->gen,
+                    MCPWM_GEN_COMPARE_EVENT_ACTION(MCPWM_TIMER_DIRECTION_UP, pOutput->cmpr, MCPWM_GEN_ACTION_LOW))){
+        return PHASE_STATUS_ERROR;
+    }
+
+    return PHASE_STATUS_OK;
+}
+
+/******************************************************************************
+*   CallBack Functions implementation
+*******************************************************************************/
+/***************************************************************************//*!
+*  \brief Sample comparator callback.
+*
+*   This function is called from the MCPWM interrupt in the middle of a
+*   phase on-time, once per sample request. Park the sample comparator
+*   and call the sample callback.
+*
+*******************************************************************************/
+static bool IRAM_ATTR sampleCmprCallback(mcpwm_cmpr_handle_t comparator,
+                                         const mcpwm_compare_event_data_t *edata,
+                                         void *user_ctx){
+
+    PHASE_Output_t *pOutput = (PHASE_Output_t*)user_ctx;
+    PHASE_SampleCallback_t callback = sample_callback;
+    bool is_armed = false;
+
+    //One shot, no more compare event until the next request
+    portENTER_CRITICAL_ISR(&phase_spinlock);
+    is_armed = pOutput->sample_armed;
+    pOutput->sample_armed = false;
+    mcpwm_comparator_set_compare_value(pOutput->sample_cmpr, PHASE_SAMPLE_OFF_TICKS);
+    portEXIT_CRITICAL_ISR(&phase_spinlock);
+
+    if(is_armed && (callback != NULL)){
+        callback((uint8_t)(pOutput - phase_outputs));
+    }
+
+    return false;//No task woken
+}
+
+
+/******************************************************************************
+*   Public Functions Definitions
+*******************************************************************************/
+/***************************************************************************//*!
+*  \brief Phase driver initialization.
+*
+*   This function is used to initialize the phases dimming PWM outputs
+*   (HWI_PA_DIM_GPIO / HWI_PB_DIM_GPIO) and the phase enable gpio. The PWM
+*   outputs are started with a 0% duty-cycle and the phases are disabled.
+*   Phase B timer is synchronized on phase A timer with a
+*   PHASE_DEFAULT_SHIFT_DEG phase shift (interleaved dimming).
+*
+*   Preconditions: None.
+*
+*   Side Effects: None.
+*
+*   \return     Operation status
+*
+*******************************************************************************/
+PHASE_Ret_t PHASE_InitDriver(void){
+
+    //Init phase enable gpio (phases disabled)
+    gpio_config_t gpio_cfg = {
+        .mode = GPIO_MODE_OUTPUT,
+        .pull_down_en = GPIO_PULLDOWN_DISABLE,
+        .pull_up_en = GPIO_PULLUP_DISABLE,
+        .intr_type = GPIO_INTR_DISABLE,
+        .pin_bit_mask = (1ULL << HWI_PHASE_EN_GPIO),
+    };
+    if(ESP_OK != gpio_config(&gpio_cfg)){
+        ESP_LOGE(TAG, "Failed to init phase enable gpio");
+        return PHASE_STATUS_ERROR;
+    }
+    gpio_set_level(HWI_PHASE_EN_GPIO, 0);
+
+    //Init phases dimming outputs
+    for(uint8_t i=0; i<PHASE_ID_INVALID; i++){
+        if(PHASE_STATUS_OK != setupPhaseOutput(&phase_outputs[i], phase_gpios[i])){
+            ESP_LOGE(TAG, "Failed to init phase %d output", i);
+            return PHASE_STATUS_ERROR;
+        }
+    }
+
+    //Phase A timer restart is the sync source of phase B timer
+    mcpwm_timer_sync_src_config_t sync_config = {
+        .timer_event = MCPWM_TIMER_EVENT_EMPTY,
+    };
+    if(ESP_OK != mcpwm_new_timer_sync_src(phase_outputs[PHASE_ID_A].timer, &sync_config, &phase_sync_handle)){
+        ESP_LOGE(TAG, "Failed to create phase sync source");
+        return PHASE_STATUS_ERROR;
+    }
+
+    phase_shift_deg = PHASE_DEFAULT_SHIFT_DEG;
+    mcpwm_timer_sync_phase_config_t phase_config = {
+        .sync_src = phase_sync_handle,
+        .count_value = SHIFT_TO_SYNC_TICKS(phase_shift_deg),
+        .direction = MCPWM_TIMER_DIRECTION_UP,
+    };
+    if(ESP_OK != mcpwm_timer_set_phase_on_sync(phase_outputs[PHASE_ID_B].timer, &phase_config)){
+        ESP_LOGE(TAG, "Failed to set phase B sync");
+        return PHASE_STATUS_ERROR;
+    }
+
+    //Start timers
+    for(uint8_t i=0; i<PHASE_ID_INVALID; i++){
+        if((ESP_OK != mcpwm_timer_enable(phase_outputs[i].timer)) ||
+           (ESP_OK != mcpwm_timer_start_stop(phase_outputs[i].timer, MCPWM_TIMER_START_NO_STOP))){
+            ESP_LOGE(TAG, "Failed to start phase %d timer", i);
+            return PHASE_STATUS_ERROR;
+        }
+    }
+
+    return PHASE_STATUS_OK;
+}
+
+/***************************************************************************//*!
+*  \brief Set phase dimming duty-cycle.
+*
+*   This function is used to set the dimming duty-cycle of a phase
+*   (0 -> PHASE_DUTY_FULL_SCALE). The new duty-cycle (and the sample
+*   point) is latched by the hardware at the next PWM period. Forced to
+*   0 while the phases are tripped. Can be called from an ISR.
+*
+*   Preconditions: Phase driver initialized.
+*
+*   Side Effects: None.
+*
+*   \param[in]  phase_id            Phase ID.
+*   \param[in]  duty                Duty-cycle (in 0.01%).
+*
+*   \return     Operation status
+*
+*******************************************************************************/
+PHASE_Ret_t IRAM_ATTR PHASE_SetDuty(PHASE_Id_t phase_id, uint16_t duty){
+
+    if(phase_id >= PHASE_ID_INVALID)    return PHASE_STATUS_ERROR;
+
+    if(duty > PHASE_DUTY_FULL_SCALE)    duty = PHASE_DUTY_FULL_SCALE;
+
+    PHASE_Output_t *pOutput = &phase_outputs[phase_id];
+    PHASE_Ret_t ret = PHASE_STATUS_OK;
+
+    portENTER_CRITICAL_SAFE(&phase_spinlock);
+
+    //Held off until the trip is cleared
+    if(is_tripped)  duty = 0;
+
+    //Sample point follows the middle of the on-time (moved now if requested)
+    uint32_t duty_ticks = DUTY_TO_TICKS(duty);
+    pOutput->sample_ticks = duty_ticks/2;
+    if((ESP_OK != mcpwm_comparator_set_compare_value(pOutput->cmpr, duty_ticks)) ||
+       (pOutput->sample_armed && (ESP_OK != mcpwm_comparator_set_compare_value(pOutput->sample_cmpr, pOutput->sample_ticks)))){
+        ret = PHASE_STATUS_ERROR;
+    }
+    else{
+        pOutput->duty = duty;
+    }
+
+    portEXIT_CRITICAL_SAFE(&phase_spinlock);
+
+    return ret;
+}
+
+/***************************************************************************//*!
+*  \brief Get phase dimming duty-cycle.
+*
+*   This function is used to get the latest duty-cycle applied to a phase.
+*
+*   Preconditions: Phase driver initialized.
+*
+*   Side Effects: None.
+*
+*   \param[in]  phase_id            Phase ID.
+*   \param[out] pDuty               Pointer to store the duty-cycle (in 0.01%).
+*
+*   \return     Operation status
+*
+*******************************************************************************/
+PHASE_Ret_t PHASE_GetDuty(PHASE_Id_t phase_id, uint16_t *pDuty){
+
+    if((phase_id >= PHASE_ID_INVALID) || (pDuty == NULL)){
+        return PHASE_STATUS_ERROR;
+    }
+
+    *pDuty = phase_outputs[phase_id].duty;
+
+    return PHASE_STATUS_OK;
+}
+
+/***************************************************************************//*!
+*  \brief Set phases enable state.
+*
+*   This function is used to enable/disable the phases (HWI_PHASE_EN_GPIO).
+*   Enabling is refused if the phases are not acquired or are tripped.
+*
+*   Preconditions: Phase driver initialized, phases acquired (enable).
+*
+*   Side Effects: None.
+*
+*   \param[in]  enable              Phases enable state.
+*
+*   \return     Operation status
+*
+*******************************************************************************/
+PHASE_Ret_t PHASE_SetEnable(bool enable){
+
+    bool is_allowed = true;
+
+    portENTER_CRITICAL(&phase_spinlock);
+    if(enable && ((phase_owner == PHASE_OWNER_NONE) || is_tripped)){
+        is_allowed = false;
+    }
+    portEXIT_CRITICAL(&phase_spinlock);
+
+    if(!is_allowed) return PHASE_STATUS_ERROR;
+
+    if(ESP_OK != gpio_set_level(HWI_PHASE_EN_GPIO, enable ? 1 : 0)){
+        return PHASE_STATUS_ERROR;
+    }
+
+    return PHASE_STATUS_OK;
+}
+
+/***************************************************************************//*!
+*  \brief Set phase shift.
+*
+*   This function is used to set the phase shift between phase A and
+*   phase B dimming (0 -> 359 deg, phase B lags phase A). 180 deg
+*   interleaves the on-times and minimizes the bus ripple. Applied at the
+*   next phase A period.
+*
+*   Preconditions: Phase driver initialized.
+*
+*   Side Effects: None.
+*
+*   \param[in]  shift_deg           Phase shift (in deg).
+*
+*   \return     Operation status
+*
+*******************************************************************************/
+PHASE_Ret_t PHASE_SetPhaseShift(uint16_t shift_deg){
+
+    if((shift_deg >= PHASE_MAX_SHIFT_DEG) || (phase_sync_handle == NULL)){
+        return PHASE_STATUS_ERROR;
+    }
+
+    mcpwm_timer_sync_phase_config_t phase_config = {
+        .sync_src = phase_sync_handle,
+        .count_value = SHIFT_TO_SYNC_TICKS(shift_deg),
+        .direction = MCPWM_TIMER_DIRECTION_UP,
+    };
+    if(ESP_OK != mcpwm_timer_set_phase_on_sync(phase_outputs[PHASE_ID_B].timer, &phase_config)){
+        return PHASE_STATUS_ERROR;
+    }
+    phase_shift_deg = shift_deg;
+
+    return PHASE_STATUS_OK;
+}
+
+/***************************************************************************//*!
+*  \brief Get phase shift.
+*
+*   This function is used to get the phase shift between phase A and
+*   phase B dimming.
+*
+*   Preconditions: Phase driver initialized.
+*
+*   Side Effects: None.
+*
+*   \param[out] pShift_deg          Pointer to store the phase shift (in deg).
+*
+*   \return     Operation status
+*
+*******************************************************************************/
+PHASE_Ret_t PHASE_GetPhaseShift(uint16_t *pShift_deg){
+
+    if(pShift_deg == NULL)  return PHASE_STATUS_ERROR;
+
+    *pShift_deg = phase_shift_deg;
+
+    return PHASE_STATUS_OK;
+}
+
+/***************************************************************************//*!
+*  \brief Register sample callback.
+*
+*   This function is used to register the callback called (from the MCPWM
+*   interrupt) in the middle of a phase on-time after PHASE_TriggerSample().
+*
+*   Preconditions: None.
+*
+*   Side Effects: None.
+*
+*   \param[in]  callback            Sample callback (NULL to unregister).
+*
+*   \return     Operation status
+*
+*******************************************************************************/
+PHASE_Ret_t PHASE_RegisterSampleCallback(PHASE_SampleCallback_t callback){
+
+    sample_callback = callback;
+
+    return PHASE_STATUS_OK;
+}
+
+/***************************************************************************//*!
+*  \brief Trigger phase sample.
+*
+*   This function is used to request one call of the sample callback at
+*   the middle of the phase on-time (so each phase is sampled in its own
+*   on-time whatever the phase shift). The sample comparator is moved to
+*   the sample point and takes effect at the next PWM period. Can be
+*   called from an ISR.
+*
+*   Preconditions: Phase driver initialized.
+*
+*   Side Effects: None.
+*
+*   \param[in]  phase_id            Phase ID.
+*
+*   \return     Operation status
+*
+*******************************************************************************/
+PHASE_Ret_t IRAM_ATTR PHASE_TriggerSample(PHASE_Id_t phase_id){
+
+    if(phase_id >= PHASE_ID_INVALID)    return PHASE_STATUS_ERROR;
+
+    PHASE_Output_t *pOutput = &phase_outputs[phase_id];
+    PHASE_Ret_t ret = PHASE_STATUS_OK;
+
+    portENTER_CRITICAL_SAFE(&phase_spinlock);
+    if(!pOutput->sample_armed){
+        if(ESP_OK != mcpwm_comparator_set_compare_value(pOutput->sample_cmpr, pOutput->sample_ticks)){
+            ret = PHASE_STATUS_ERROR;
+        }
+        else{
+            pOutput->sample_armed = true;
+        }
+    }
+    portEXIT_CRITICAL_SAFE(&phase_spinlock);
+
+    return ret;
+}
+
+/***************************************************************************//*!
+*  \brief Acquire phases.
+*
+*   This function is used to take the exclusive use of the phases before
+*   enabling them (current regulator, open loop measurements). Refused if
+*   the phases are already owned or are tripped.
+*
+*   Preconditions: None.
+*
+*   Side Effects: None.
+*
+*   \param[in]  owner               Phases user.
+*
+*   \return     Operation status
+*
+*******************************************************************************/
+PHASE_Ret_t PHASE_Acquire(PHASE_Owner_t owner){
+
+    PHASE_Ret_t ret = PHASE_STATUS_ERROR;
+
+    if((owner == PHASE_OWNER_NONE) || (owner >= PHASE_OWNER_INVALID))   return PHASE_STATUS_ERROR;
+
+    portENTER_CRITICAL(&phase_spinlock);
+    if((phase_owner == PHASE_OWNER_NONE) && (!is_tripped)){
+        phase_owner = owner;
+        ret = PHASE_STATUS_OK;
+    }
+    portEXIT_CRITICAL(&phase_spinlock);
+
+    return ret;
+}
+
+/***************************************************************************//*!
+*  \brief Release phases.
+*
+*   This function is used to give the phases back: both duty-cycles are
+*   set to 0 and the phases are disabled. Refused (phases untouched) if
+*   the phases are owned by someone else.
+*
+*   Preconditions: Phase driver initialized.
+*
+*   Side Effects: Phases disabled.
+*
+*   \param[in]  owner               Phases user.
+*
+*   \return     Operation status
+*
+*******************************************************************************/
+PHASE_Ret_t PHASE_Release(PHASE_Owner_t owner){
+
+    //Only the owner changes the owner
+    if((owner == PHASE_OWNER_NONE) || (owner != phase_owner))   return PHASE_STATUS_ERROR;
+
+    //Outputs off before anyone else can acquire the phases
+    for(uint8_t i=0; i<PHASE_ID_INVALID; i++){
+        PHASE_SetDuty((PHASE_Id_t)i, 0);
+    }
+    gpio_set_level(HWI_PHASE_EN_GPIO, 0);
+
+    portENTER_CRITICAL(&phase_spinlock);
+    phase_owner = PHASE_OWNER_NONE;
+    portEXIT_CRITICAL(&phase_spinlock);
+
+    return PHASE_STATUS_OK;
+}
+
+/***************************************************************************//*!
+*  \brief Get phases owner.
+*
+*   This function return the current user of the phases.
+*
+*   Preconditions: None.
+*
+*   Side Effects: None.
+*
+*   \return     Phases owner (PHASE_OWNER_NONE if free)
+*
+*******************************************************************************/
+PHASE_Owner_t PHASE_GetOwner(void){
+
+    return phase_owner;
+}
+
+/***************************************************************************//*!
+*  \brief Trip phases.
+*
+*   This function is used to trip the phases: both duty-cycles are forced
+*   to 0 and held at 0 (whoever owns the phases) until PHASE_ClearTrip().
+*   Can be called from an ISR.
+*
+*   Preconditions: Phase driver initialized.
+*
+*   Side Effects: None.
+*
+*******************************************************************************/
+void IRAM_ATTR PHASE_Trip(void){
+
+    portENTER_CRITICAL_SAFE(&phase_spinlock);
+    is_tripped = true;
+    portEXIT_CRITICAL_SAFE(&phase_spinlock);
+
+    for(uint8_t i=0; i<PHASE_ID_INVALID; i++){
+        PHASE_SetDuty((PHASE_Id_t)i, 0);
+    }
+}
+
+/***************************************************************************//*!
+*  \brief Clear phases trip.
+*
+*   This function is used to clear the phases trip. Can be called from an
+*   ISR.
+*
+*   Preconditions: None.
+*
+*   Side Effects: None.
+*
+*******************************************************************************/
+void IRAM_ATTR PHASE_ClearTrip(void){
+
+    portENTER_CRITICAL_SAFE(&phase_spinlock);
+    is_tripped = false;
+    portEXIT_CRITICAL_SAFE(&phase_spinlock);
+}
+
+/***************************************************************************//*!
+*  \brief Is phases tripped.
+*
+*   This function return if the phases are tripped. Can be called from an
+*   ISR.
+*
+*   Preconditions: None.
+*
+*   Side Effects: None.
+*
+*   \return     Tripped (True) or not (False)
+*
+*******************************************************************************/
+bool IRAM_ATTR PHASE_IsTripped(void){
+
+    return is_tripped;
+}
+
+/******************************************************************************
+*   Interrupts
+*******************************************************************************/
+
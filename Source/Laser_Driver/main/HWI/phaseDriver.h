@@ -0,0 +1,294 @@
+#ifndef __PHASE_DRIVER_H
+#define __PHASE_DRIVER_H
+
+#include <stdint.h>
+#include <stdbool.h>
+
+/******************************************************************************
+*   Public Definitions
+*******************************************************************************/
+#define PHASE_DUTY_FULL_SCALE               (10000)//100.00%
+#define PHASE_DEFAULT_SHIFT_DEG             (180)//Interleaved phases
+
+/******************************************************************************
+*   Public Macros
+*******************************************************************************/
+typedef void(*PHASE_SampleCallback_t)(uint8_t phase_id);
+
+
+/******************************************************************************
+*   Public Data Types
+*******************************************************************************/
+typedef enum PHASE_Id_e{
+    PHASE_ID_A,
+    PHASE_ID_B,
+
+    PHASE_ID_INVALID,
+}PHASE_Id_t;
+
+//Phases user (exclusive, see PHASE_Acquire())
+typedef enum PHASE_Owner_e{
+    PHASE_OWNER_NONE,
+    PHASE_OWNER_REGULATOR,              //Closed loop current regulator
+    PHASE_OWNER_OPEN_LOOP,              //Open loop duty (ripple measurement)
+    PHASE_OWNER_WAVEFORM,               //Waveform playback
+
+    PHASE_OWNER_INVALID,
+}PHASE_Owner_t;
+
+typedef enum PHASE_Ret_e{
+    PHASE_STATUS_ERROR,
+    PHASE_STATUS_OK,
+}PHASE_Ret_t;
+
+/******************************************************************************
+*   Public Variables
+*******************************************************************************/
+
+
+/******************************************************************************
+*   Error Check
+*******************************************************************************/
+
+
+/******************************************************************************
+*   Public Functions Declarations
+*******************************************************************************/
+/***************************************************************************//*!
+*  \brief Phase driver initialization.
+*
+*   This function is used to initialize the phases dimming PWM outputs
+*   (HWI_PA_DIM_GPIO / HWI_PB_DIM_GPIO) and the phase enable gpio. The PWM
+*   outputs are started with a 0% duty-cycle and the phases are disabled.
+*   Phase B timer is synchronized on phase A timer with a
+*   PHASE_DEFAULT_SHIFT_DEG phase shift (interleaved dimming).
+*
+*   Preconditions: None.
+*
+*   Side Effects: None.
+*
+*   \return     Operation status
+*
+*******************************************************************************/
+PHASE_Ret_t PHASE_InitDriver(void);
+
+/***************************************************************************//*!
+*  \brief Set phase dimming duty-cycle.
+*
+*   This function is used to set the dimming duty-cycle of a phase
+*   (0 -> PHASE_DUTY_FULL_SCALE). The new duty-cycle (and the sample
+*   point) is latched by the hardware at the next PWM period. Forced to
+*   0 while the phases are tripped. Can be called from an ISR.
+*
+*   Preconditions: Phase driver initialized.
+*
+*   Side Effects: None.
+*
+*   \param[in]  phase_id            Phase ID.
+*   \param[in]  duty                Duty-cycle (in 0.01%).
+*
+*   \return     Operation status
+*
+*******************************************************************************/
+PHASE_Ret_t PHASE_SetDuty(PHASE_Id_t phase_id, uint16_t duty);
+
+/***************************************************************************//*!
+*  \brief Get phase dimming duty-cycle.
+*
+*   This function is used to get the latest duty-cycle applied to a phase.
+*
+*   Preconditions: Phase driver initialized.
+*
+*   Side Effects: None.
+*
+*   \param[in]  phase_id            Phase ID.
+*   \param[out] pDuty               Pointer to store the duty-cycle (in 0.01%).
+*
+*   \return     Operation status
+*
+*******************************************************************************/
+PHASE_Ret_t PHASE_GetDuty(PHASE_Id_t phase_id, uint16_t *pDuty);
+
+/***************************************************************************//*!
+*  \brief Set phases enable state.
+*
+*   This function is used to enable/disable the phases (HWI_PHASE_EN_GPIO).
+*   Enabling is refused if the phases are not acquired or are tripped.
+*
+*   Preconditions: Phase driver initialized, phases acquired (enable).
+*
+*   Side Effects: None.
+*
+*   \param[in]  enable              Phases enable state.
+*
+*   \return     Operation status
+*
+*******************************************************************************/
+PHASE_Ret_t PHASE_SetEnable(bool enable);
+
+/***************************************************************************//*!
+*  \brief Set phase shift.
+*
+*   This function is used to set the phase shift between phase A and
+*   phase B dimming (0 -> 359 deg, phase B lags phase A). 180 deg
+*   interleaves the on-times and minimizes the bus ripple. Applied at the
+*   next phase A period.
+*
+*   Preconditions: Phase driver initialized.
+*
+*   Side Effects: None.
+*
+*   \param[in]  shift_deg           Phase shift (in deg).
+*
+*   \return     Operation status
+*
+*******************************************************************************/
+PHASE_Ret_t PHASE_SetPhaseShift(uint16_t shift_deg);
+
+/***************************************************************************//*!
+*  \brief Get phase shift.
+*
+*   This function is used to get the phase shift between phase A and
+*   phase B dimming.
+*
+*   Preconditions: Phase driver initialized.
+*
+*   Side Effects: None.
+*
+*   \param[out] pShift_deg          Pointer to store the phase shift (in deg).
+*
+*   \return     Operation status
+*
+*******************************************************************************/
+PHASE_Ret_t PHASE_GetPhaseShift(uint16_t *pShift_deg);
+
+/***************************************************************************//*!
+*  \brief Register sample callback.
+*
+*   This function is used to register the callback called (from the MCPWM
+*   interrupt) in the middle of a phase on-time after PHASE_TriggerSample().
+*
+*   Preconditions: None.
+*
+*   Side Effects: None.
+*
+*   \param[in]  callback            Sample callback (NULL to unregister).
+*
+*   \return     Operation status
+*
+*******************************************************************************/
+PHASE_Ret_t PHASE_RegisterSampleCallback(PHASE_SampleCallback_t callback);
+
+/***************************************************************************//*!
+*  \brief Trigger phase sample.
+*
+*   This function is used to request one call of the sample callback at
+*   the middle of the phase on-time (so each phase is sampled in its own
+*   on-time whatever the phase shift). The sample comparator is moved to
+*   the sample point and takes effect at the next PWM period. Can be
+*   called from an ISR.
+*
+*   Preconditions: Phase driver initialized.
+*
+*   Side Effects: None.
+*
+*   \param[in]  phase_id            Phase ID.
+*
+*   \return     Operation status
+*
+*******************************************************************************/
+PHASE_Ret_t PHASE_TriggerSample(PHASE_Id_t phase_id);
+
+/***************************************************************************//*!
+*  \brief Acquire phases.
+*
+*   This function is used to take the exclusive use of the phases before
+*   enabling them (current regulator, open loop measurements). Refused if
+*   the phases are already owned or are tripped.
+*
+*   Preconditions: None.
+*
+*   Side Effects: None.
+*
+*   \param[in]  owner               Phases user.
+*
+*   \return     Operation status
+*
+*******************************************************************************/
+PHASE_Ret_t PHASE_Acquire(PHASE_Owner_t owner);
+
+/***************************************************************************//*!
+*  \brief Release phases.
+*
+*   This function is used to give the phases back: both duty-cycles are
+*   set to 0 and the phases are disabled. Refused (phases untouched) if
+*   the phases are owned by someone else.
+*
+*   Preconditions: Phase driver initialized.
+*
+*   Side Effects: Phases disabled.
+*
+*   \param[in]  owner               Phases user.
+*
+*   \return     Operation status
+*
+*******************************************************************************/
+PHASE_Ret_t PHASE_Release(PHASE_Owner_t owner);
+
+/***************************************************************************//*!
+*  \brief Get phases owner.
+*
+*   This function return the current user of the phases.
+*
+*   Preconditions: None.
+*
+*   Side Effects: None.
+*
+*   \return     Phases owner (PHASE_OWNER_NONE if free)
+*
+*******************************************************************************/
+PHASE_Owner_t PHASE_GetOwner(void);
+
+/***************************************************************************//*!
+*  \brief Trip phases.
+*
+*   This function is used to trip the phases: both duty-cycles are forced
+*   to 0 and held at 0 (whoever owns the phases) until PHASE_ClearTrip().
+*   Can be called from an ISR.
+*
+*   Preconditions: Phase driver initialized.
+*
+*   Side Effects: None.
+*
+*******************************************************************************/
+void PHASE_Trip(void);
+
+/***************************************************************************//*!
+*  \brief Clear phases trip.
+*
+*   This function is used to clear the phases trip. Can be called from an
+*   ISR.
+*
+*   Preconditions: None.
+*
+*   Side Effects: None.
+*
+*******************************************************************************/
+void PHASE_ClearTrip(void);
+
+/***************************************************************************//*!
+*  \brief Is phases tripped.
+*
+*   This function return if the phases are tripped. Can be called from an
+*   ISR.
+*
+*   Preconditions: None.
+*
+*   Side Effects: None.
+*
+*   \return     Tripped (True) or not (False)
+*
+*******************************************************************************/
+bool PHASE_IsTripped(void);
+
+#endif//__PHASE_DRIVER_H
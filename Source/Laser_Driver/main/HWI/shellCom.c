@@ -0,0 +1,809 @@
+#include <stdio.h>
+#include <stdarg.h>
+#include <string.h>
+
+#include "freertos/FreeRTOS.h"
+#include "freertos/task.h"
+
+#include "esp_cpu.h"
+#include "esp_timer.h"
+
+#include "myShell.h"
+#include "shellCom.h"
+#include "shellComTransport.h"
+#include "taskPriority.h"
+#include "memoryMap.h"
+#include "taskStats.h"
+#include "coreAffinity.h"
+
+/******************************************************************************
+*   Private Definitions
+*******************************************************************************/
+#define PRINTF_BUFFER_SIZE              (128)
+
+#define TX_RING_SIZE                    (2048)//Output ring (power of 2, records)
+#define TX_LINE_BUFFER_SIZE             (128)//Shell per character output
+#define TX_RECORD_HEADER_SIZE           (sizeof(uint32_t))
+#define TX_RECORD_READY                 (0x80000000UL)//Header flag, payload written
+#define TX_RECORD_LEN_MASK              (0x0000FFFFUL)
+#define TX_MAX_RECORD_LEN               (SHCOM_TX_MAX_SEGMENT_LEN)
+#define TX_SHELL_WAIT_MS                (100)//Shell tasks wait for room, others drop
+
+/******************************************************************************
+*   Private Macros
+*******************************************************************************/
+#define TX_RECORD_SIZE(len)             (TX_RECORD_HEADER_SIZE + (((len) + 3) & ~3UL))
+#define TX_RING_OFFSET(pos)             ((pos) & (TX_RING_SIZE - 1))
+
+
+/******************************************************************************
+*   Private Data Types
+*******************************************************************************/
+typedef struct SHCOM_Line_s{
+    TaskHandle_t task_handle;           //Shell task owning the line
+    size_t len;
+    char buffer[TX_LINE_BUFFER_SIZE];
+}SHCOM_Line_t;
+
+/******************************************************************************
+*   Private Functions Declaration
+*******************************************************************************/
+static void feedShell(const uint8_t *pData, size_t len);
+static void tListenerTask(void *pvParameters);
+static void copyToRing(uint32_t pos, const uint8_t *pData, size_t len);
+static SHCOM_Ret_t writeRecord(const char *pData, size_t len);
+static SHCOM_Line_t *currentLine(void);
+static void flushLine(SHCOM_Line_t *pLine);
+static uint32_t readyRecord(uint32_t pos, uint32_t *pLen);
+static uint32_t sendRecords(uint32_t tail);
+static void releaseRecords(uint32_t tail, uint32_t end);
+static void tSenderTask(void *pvParameters);
+static esp_err_t initTransport(void *pArg);
+
+/******************************************************************************
+*   Public Variables
+*******************************************************************************/
+
+
+/******************************************************************************
+*   Private Variables
+*******************************************************************************/
+static const SHCOM_Transport_t * const transports[SHCOM_TRANSPORT_INVALID] = {
+    [SHCOM_TRANSPORT_UART] = &shcom_uart_transport,
+    [SHCOM_TRANSPORT_UART_DMA] = &shcom_uart_dma_transport,
+    [SHCOM_TRANSPORT_USB_JTAG] = &shcom_usb_jtag_transport,
+};
+
+static const SHCOM_Transport_t *pTransport = NULL;
+static TaskHandle_t listener_task_handle = NULL;
+static StackType_t listener_task_stack[SHCOM_TASK_STACK_SIZE];
+static StaticTask_t listener_task_buffer;
+static SHCOM_BreakCallback_t break_callback = NULL;
+
+//Output ring: producers reserve a record (head) with a compare and swap,
+//write the payload then set the ready flag in the record header. The sender
+//task hands the ready records to the transport in order, clears them and
+//releases them (tail). Free space is always zero. DMA capable memory (sent
+//without copy by the UART DMA transport).
+static uint32_t tx_ring[TX_RING_SIZE / sizeof(uint32_t)] = {0};
+static uint32_t tx_head = 0;
+static uint32_t tx_tail = 0;
+static TaskHandle_t sender_task_handle = NULL;
+static StackType_t sender_task_stack[SHCOM_TX_TASK_STACK_SIZE];
+static StaticTask_t sender_task_buffer;
+
+//Shell output line of each shell task (listener, registered workers): a
+//line is only accessed from its task, lines of tasks printing at the same
+//time are not mixed. Registered once, never removed.
+static SHCOM_Line_t tx_lines[SHCOM_MAX_SHELL_TASKS];
+static uint32_t tx_nb_lines = 0;
+static portMUX_TYPE tx_lines_spinlock = portMUX_INITIALIZER_UNLOCKED;
+
+//Updated by the producers without lock
+static uint32_t tx_nb_records = 0;
+static uint32_t tx_nb_bytes = 0;
+static uint32_t tx_nb_dropped = 0;
+
+static SHCOM_Stats_t rx_stats;
+static int64_t rx_stats_start_us = 0;
+static portMUX_TYPE rx_stats_spinlock = portMUX_INITIALIZER_UNLOCKED;
+
+/******************************************************************************
+*   Error Check
+*******************************************************************************/
+_Static_assert((TX_RING_SIZE & (TX_RING_SIZE - 1)) == 0, "Output ring size must be a power of 2");
+_Static_assert(TX_MAX_RECORD_LEN <= (TX_RING_SIZE / 4), "Output record too large for the ring");
+
+
+/******************************************************************************
+*   Private Functions Definitions
+*******************************************************************************/
+/***************************************************************************//*!
+*  \brief Feed shell.
+*
+*   This function hands received characters to the shell, Ctrl-C goes to
+*   the break callback instead.
+*
+*   Preconditions:  Called from the listener task.
+*
+*   \param[in]  pData               Pointer to the characters.
+*   \param[in]  len                 Number of characters.
+*
+*******************************************************************************/
+static void feedShell(const uint8_t *pData, size_t len){
+
+    uint32_t nb_lines = 0;
+
+    for(size_t i=0; i<len; i++){
+
+        if(pData[i] == SHCOM_BREAK_CHARACTER){
+            SHCOM_BreakCallback_t callback = __atomic_load_n(&break_callback, __ATOMIC_ACQUIRE);
+            if(callback != NULL)    callback();
+            continue;
+        }
+
+        SHELL_RecvChar((char)pData[i]);
+        if(pData[i] == SHCOM_LINE_TERMINATOR)   nb_lines++;
+    }
+
+    portENTER_CRITICAL(&rx_stats_spinlock);
+    rx_stats.nb_lines += nb_lines;
+    rx_stats.nb_bytes += len;
+    portEXIT_CRITICAL(&rx_stats_spinlock);
+}
+
+/***************************************************************************//*!
+*  \brief Listener task.
+*
+*   This function is the shell input listener task. It blocks on the
+*   transport input events and hands the input to the shell.
+*
+*   Preconditions:  None.
+*
+*******************************************************************************/
+static void tListenerTask(void *pvParameters){
+
+    SHCOM_RegisterShellTask();
+
+    SHCOM_Line_t *pLine = currentLine();
+
+    for(;;){
+
+        pTransport->pWaitInput();
+        TSTAT_MarkRunning(false);
+
+        uint32_t start_cycles = esp_cpu_get_cycle_count();
+
+        bool is_overflow = (SHCOM_STATUS_OK != pTransport->pReadInput(feedShell));
+
+        //Echo and prompt of the partial line
+        flushLine(pLine);
+
+        uint32_t cycles = esp_cpu_get_cycle_count() - start_cycles;
+
+        portENTER_CRITICAL(&rx_stats_spinlock);
+        rx_stats.nb_wakeups++;
+        rx_stats.busy_cycles += cycles;
+        if(is_overflow) rx_stats.nb_overflows++;
+        portEXIT_CRITICAL(&rx_stats_spinlock);
+    }
+    vTaskDelete(NULL);
+}
+
+/***************************************************************************//*!
+*  \brief Copy to ring.
+*
+*   This function copies data to the output ring (wraps around the end).
+*
+*   Preconditions:  Space reserved.
+*
+*   \param[in]  pos                 Ring position.
+*   \param[in]  pData               Pointer to the data.
+*   \param[in]  len                 Number of bytes.
+*
+*******************************************************************************/
+static void copyToRing(uint32_t pos, const uint8_t *pData, size_t len){
+
+    uint8_t *pRing = (uint8_t *)tx_ring;
+    uint32_t offset = TX_RING_OFFSET(pos);
+    size_t first_len = TX_RING_SIZE - offset;
+
+    if(first_len > len) first_len = len;
+
+    memcpy(&pRing[offset], pData, first_len);
+    memcpy(pRing, &pData[first_len], len - first_len);
+}
+
+/***************************************************************************//*!
+*  \brief Write record.
+*
+*   This function writes data to the output ring as one record, written out
+*   in one piece (lines of different tasks are not interleaved). It never
+*   blocks: the record is dropped when the ring is full, except for the
+*   shell tasks (listener, registered workers) that wait up to
+*   TX_SHELL_WAIT_MS for room.
+*
+*   Preconditions:  Sender task created.
+*
+*   \param[in]  pData               Pointer to the data.
+*   \param[in]  len                 Number of bytes (truncated to
+*                                   TX_MAX_RECORD_LEN).
+*
+*   \return     Operation status.
+*
+*******************************************************************************/
+static SHCOM_Ret_t writeRecord(const char *pData, size_t len){
+
+    if(sender_task_handle == NULL) return SHCOM_STATUS_ERROR;
+    if(len == 0)    return SHCOM_STATUS_OK;
+    if(len > TX_MAX_RECORD_LEN)    len = TX_MAX_RECORD_LEN;
+
+    uint32_t record_size = TX_RECORD_SIZE(len);
+    TickType_t wait_ticks = (currentLine() != NULL) ? pdMS_TO_TICKS(TX_SHELL_WAIT_MS) : 0;
+    uint32_t head = __atomic_load_n(&tx_head, __ATOMIC_RELAXED);
+
+    //Reserve the record
+    for(;;){
+        uint32_t tail = __atomic_load_n(&tx_tail, __ATOMIC_ACQUIRE);
+
+        if(((head - tail) + record_size) > TX_RING_SIZE){
+            if(wait_ticks == 0){
+                __atomic_fetch_add(&tx_nb_dropped, 1, __ATOMIC_RELAXED);
+                return SHCOM_STATUS_ERROR;
+            }
+
+            vTaskDelay(1);
+            wait_ticks--;
+            head = __atomic_load_n(&tx_head, __ATOMIC_RELAXED);
+            continue;
+        }
+
+        if(__atomic_compare_exchange_n(&tx_head, &head, head + record_size,
+                                       true, __ATOMIC_RELAXED, __ATOMIC_RELAXED)){
+            break;
+        }
+    }
+
+    //Payload then header (published to the sender)
+    copyToRing(head + TX_RECORD_HEADER_SIZE, (const uint8_t *)pData, len);
+    __atomic_store_n(&tx_ring[TX_RING_OFFSET(head) / sizeof(uint32_t)],
+                     TX_RECORD_READY | len, __ATOMIC_RELEASE);
+
+    __atomic_fetch_add(&tx_nb_records, 1, __ATOMIC_RELAXED);
+    __atomic_fetch_add(&tx_nb_bytes, len, __ATOMIC_RELAXED);
+
+    TSTAT_MarkReady(sender_task_handle);
+    xTaskNotifyGive(sender_task_handle);
+
+    return SHCOM_STATUS_OK;
+}
+
+/***************************************************************************//*!
+*  \brief Current line.
+*
+*   This function gets the shell output line of the calling task.
+*
+*   Preconditions:  None.
+*
+*   \return     Pointer to the line, NULL if not a shell task.
+*
+*******************************************************************************/
+static SHCOM_Line_t *currentLine(void){
+
+    TaskHandle_t task_handle = xTaskGetCurrentTaskHandle();
+    uint32_t nb_lines = __atomic_load_n(&tx_nb_lines, __ATOMIC_ACQUIRE);
+
+    for(uint32_t i=0; i<nb_lines; i++){
+        if(tx_lines[i].task_handle == task_handle)  return &tx_lines[i];
+    }
+
+    return NULL;
+}
+
+/***************************************************************************//*!
+*  \brief Flush line.
+*
+*   This function writes the shell characters buffered so far.
+*
+*   Preconditions:  Called from the line task.
+*
+*   \param[in]  pLine               Pointer to the line (NULL: none).
+*
+*******************************************************************************/
+static void flushLine(SHCOM_Line_t *pLine){
+
+    if((pLine == NULL) || (pLine->len == 0))   return;
+
+    writeRecord(pLine->buffer, pLine->len);
+    pLine->len = 0;
+}
+
+/***************************************************************************//*!
+*  \brief Ready record.
+*
+*   This function checks the output ring record at a position.
+*
+*   Preconditions:  None.
+*
+*   \param[in]  pos                 Ring position of the record.
+*   \param[out] pLen                Pointer to store the payload length.
+*
+*   \return     Record size, 0 if not written yet.
+*
+*******************************************************************************/
+static uint32_t readyRecord(uint32_t pos, uint32_t *pLen){
+
+    uint32_t *pHeader = &tx_ring[TX_RING_OFFSET(pos) / sizeof(uint32_t)];
+    uint32_t header = __atomic_load_n(pHeader, __ATOMIC_ACQUIRE);
+
+    if(!(header & TX_RECORD_READY))    return 0;
+
+    *pLen = header & TX_RECORD_LEN_MASK;
+    return TX_RECORD_SIZE(*pLen);
+}
+
+/***************************************************************************//*!
+*  \brief Send records.
+*
+*   This function hands the ready records to the transport straight from
+*   the output ring (up to the transport segment count), then waits until
+*   they are sent.
+*
+*   Preconditions:  Called from the sender task.
+*
+*   \param[in]  tail                Ring position of the first record.
+*
+*   \return     Ring position after the records sent.
+*
+*******************************************************************************/
+static uint32_t sendRecords(uint32_t tail){
+
+    uint8_t *pRing = (uint8_t *)tx_ring;
+    uint32_t pos = tail;
+    uint32_t nb_segments = 0;
+    uint32_t len;
+    uint32_t record_size;
+
+    //Whole records only, a wrapped record takes two segments.
+    //Not written yet: next commit notifies again.
+    while(((nb_segments + 2) <= pTransport->max_tx_segments) &&
+          ((record_size = readyRecord(pos, &len)) != 0)){
+
+        uint32_t offset = TX_RING_OFFSET(pos + TX_RECORD_HEADER_SIZE);
+        uint32_t first_len = TX_RING_SIZE - offset;
+
+        if(first_len > len) first_len = len;
+
+        pTransport->pSend(&pRing[offset], first_len);
+        if(len > first_len){
+            pTransport->pSend(pRing, len - first_len);
+        }
+
+        nb_segments += (len > first_len) ? 2 : 1;
+        pos += record_size;
+    }
+
+    //The transport may read the ring: release once sent
+    if((pos != tail) && (pTransport->pFlush != NULL))   pTransport->pFlush();
+
+    return pos;
+}
+
+/***************************************************************************//*!
+*  \brief Release records.
+*
+*   This function clears the records sent and releases them to the
+*   producers.
+*
+*   Preconditions:  Called from the sender task.
+*
+*   \param[in]  tail                Ring position of the first record.
+*   \param[in]  end                 Ring position after the last record.
+*
+*******************************************************************************/
+static void releaseRecords(uint32_t tail, uint32_t end){
+
+    uint8_t *pRing = (uint8_t *)tx_ring;
+    uint32_t size = end - tail;
+    uint32_t offset = TX_RING_OFFSET(tail);
+    uint32_t first_len = TX_RING_SIZE - offset;
+
+    if(first_len > size)    first_len = size;
+
+    //Free space must read as not ready
+    memset(&pRing[offset], 0, first_len);
+    memset(pRing, 0, size - first_len);
+
+    __atomic_store_n(&tx_tail, end, __ATOMIC_RELEASE);
+}
+
+/***************************************************************************//*!
+*  \brief Sender task.
+*
+*   This function is the shell output sender task. It hands the ready
+*   records of the output ring to the transport, then clears and releases
+*   them.
+*
+*   Preconditions:  None.
+*
+*******************************************************************************/
+static void tSenderTask(void *pvParameters){
+
+    for(;;){
+
+        ulTaskNotifyTake(pdTRUE, portMAX_DELAY);
+        TSTAT_MarkRunning(false);
+
+        uint32_t tail = tx_tail;
+
+        for(;;){
+            uint32_t end = sendRecords(tail);
+
+            if(end == tail) break;
+
+            releaseRecords(tail, end);
+            tail = end;
+        }
+    }
+    vTaskDelete(NULL);
+}
+
+/***************************************************************************//*!
+*  \brief Init transport.
+*
+*   This function initializes the configured transport, its port interrupt
+*   is allocated on the calling core.
+*
+*   Preconditions:  Transport checked.
+*
+*   \param[in]  pArg                Pointer to com config.
+*
+*   \return     ESP status.
+*
+*******************************************************************************/
+static esp_err_t initTransport(void *pArg){
+
+    SHCOM_Config_t *pConfig = (SHCOM_Config_t*)pArg;
+
+    return (SHCOM_STATUS_OK == transports[pConfig->transport]->pInit(pConfig)) ? ESP_OK : ESP_FAIL;
+}
+
+/******************************************************************************
+*   CallBack Functions implementation
+*******************************************************************************/
+
+
+/******************************************************************************
+*   Public Functions Definitions
+*******************************************************************************/
+/***************************************************************************//*!
+*  \brief Shell communication peripheral initialization.
+*
+*   This function is use to initialize required peripherals for the Shell
+*   communication: the transport selected in the config (UART, UART DMA or
+*   USB Serial/JTAG), then the listener and sender tasks.
+*
+*   Preconditions:  None.
+*
+*	\param[in]  pConfig     Pointer to com config.
+*
+*	\return		Operation status.
+*
+*******************************************************************************/
+SHCOM_Ret_t SHCOM_InitCom(SHCOM_Config_t *pConfig){
+
+    if((pConfig == NULL) || (pConfig->transport >= SHCOM_TRANSPORT_INVALID)){
+        return SHCOM_STATUS_ERROR;
+    }
+
+    //Port interrupt on the I/O core, with the listener and sender tasks
+    if(ESP_OK != CORE_RunOnCore(SHCOM_TASK_CORE, initTransport, pConfig)){
+        return SHCOM_STATUS_ERROR;
+    }
+
+    pTransport = transports[pConfig->transport];
+    SHCOM_ResetStats();
+
+    //Create sender task
+    sender_task_handle = xTaskCreateStaticPinnedToCore(tSenderTask,
+                                                       "Sender task",
+                                                       SHCOM_TX_TASK_STACK_SIZE,
+                                                       NULL,
+                                                       SHCOM_TX_TASK_PRIORITY,
+                                                       sender_task_stack,
+                                                       &sender_task_buffer,
+                                                       SHCOM_TX_TASK_CORE);
+    if(sender_task_handle == NULL){
+
+        return SHCOM_STATUS_ERROR;
+    }
+
+    //Create listener task
+    listener_task_handle = xTaskCreateStaticPinnedToCore(tListenerTask,
+                                                         "Listener task",
+                                                         SHCOM_TASK_STACK_SIZE,
+                                                         NULL,
+                                                         SHCOM_TASK_PRIORITY,
+                                                         listener_task_stack,
+                                                         &listener_task_buffer,
+                                                         SHCOM_TASK_CORE);
+    if(listener_task_handle == NULL){
+
+        return SHCOM_STATUS_ERROR;
+    }
+
+    return SHCOM_STATUS_OK;
+}
+
+/***************************************************************************//*!
+*  \brief Shell communication print character.
+*
+*   This function is use by the shell to print character out. Characters
+*   are buffered in the calling task line and written on new line, when
+*   the buffer is full, at the end of the received input processing or on
+*   SHCOM_FlushLine().
+*
+*   Preconditions:  Called from a shell task (listener or registered).
+*
+*	\param[in]  c                   Character to print.
+*
+*	\return		Operation status.
+*
+*******************************************************************************/
+SHCOM_Ret_t SHCOM_PrintCharacter(char c){
+
+    SHCOM_Line_t *pLine = currentLine();
+
+    if(pLine == NULL)   return SHCOM_STATUS_ERROR;
+
+    pLine->buffer[pLine->len++] = c;
+
+    if((c == '\n') || (pLine->len >= sizeof(pLine->buffer))){
+        flushLine(pLine);
+    }
+
+    return SHCOM_STATUS_OK;
+}
+
+/***************************************************************************//*!
+*  \brief Shell communication flush line.
+*
+*   This function is use to write the shell characters buffered so far by
+*   the calling task (end of a command run outside of the listener).
+*
+*   Preconditions:  None.
+*
+*	\return		Operation status.
+*
+*******************************************************************************/
+SHCOM_Ret_t SHCOM_FlushLine(void){
+
+    flushLine(currentLine());
+
+    return SHCOM_STATUS_OK;
+}
+
+/***************************************************************************//*!
+*  \brief Shell communication register shell task.
+*
+*   This function is use to give the calling task its own shell output line
+*   (SHCOM_PrintCharacter()), for the tasks running shell commands besides
+*   the listener. Like the listener, its output waits for room in the
+*   output ring instead of being dropped. Registering twice is harmless.
+*
+*   Preconditions:  None.
+*
+*	\return		Operation status (error if SHCOM_MAX_SHELL_TASKS reached).
+*
+*******************************************************************************/
+SHCOM_Ret_t SHCOM_RegisterShellTask(void){
+
+    TaskHandle_t task_handle = xTaskGetCurrentTaskHandle();
+    SHCOM_Ret_t ret = SHCOM_STATUS_OK;
+
+    if(currentLine() != NULL)   return SHCOM_STATUS_OK;
+
+    portENTER_CRITICAL(&tx_lines_spinlock);
+    uint32_t nb_lines = tx_nb_lines;
+    if(nb_lines < SHCOM_MAX_SHELL_TASKS){
+        tx_lines[nb_lines].task_handle = task_handle;
+        tx_lines[nb_lines].len = 0;
+        //Published once set (lock free readers)
+        __atomic_store_n(&tx_nb_lines, nb_lines + 1, __ATOMIC_RELEASE);
+    }
+    else{
+        ret = SHCOM_STATUS_ERROR;
+    }
+    portEXIT_CRITICAL(&tx_lines_spinlock);
+
+    return ret;
+}
+
+/***************************************************************************//*!
+*  \brief Shell communication print string.
+*
+*   This function is use to print a string out. The string is written out
+*   in one piece, it is dropped when the output ring is full (never blocks,
+*   except the shell tasks that wait for room).
+*
+*   Preconditions:  Shell communication initialized.
+*
+*	\param[in]  pString             String to print.
+*
+*	\return		Operation status.
+*
+*******************************************************************************/
+SHCOM_Ret_t SHCOM_Print(const char *pString){
+
+    if(pString == NULL) return SHCOM_STATUS_ERROR;
+
+    //Keep the shell output of the task in order
+    flushLine(currentLine());
+
+    return writeRecord(pString, strlen(pString));
+}
+
+/***************************************************************************//*!
+*  \brief Shell communication write.
+*
+*   This function is use to write binary data out (telemetry frames),
+*   multiplexed with the shell text. The data is written out in one piece,
+*   it is dropped when the output ring is full (never blocks).
+*
+*   Preconditions:  Shell communication initialized.
+*
+*	\param[in]  pData               Data to write.
+*	\param[in]  len                 Data length.
+*
+*	\return		Operation status.
+*
+*******************************************************************************/
+SHCOM_Ret_t SHCOM_Write(const uint8_t *pData, size_t len){
+
+    if((pData == NULL) || (len > TX_MAX_RECORD_LEN))   return SHCOM_STATUS_ERROR;
+
+    return writeRecord((const char *)pData, len);
+}
+
+/***************************************************************************//*!
+*  \brief Shell communication formatted print.
+*
+*   This function is use to print a formatted string out (printf like).
+*   The output is truncated to PRINTF_BUFFER_SIZE characters and
+*   written out in one piece, like SHCOM_Print().
+*
+*   Preconditions:  Shell communication initialized.
+*
+*	\param[in]  pFormat             Format string.
+*
+*	\return		Operation status.
+*
+*******************************************************************************/
+SHCOM_Ret_t SHCOM_Printf(const char *pFormat, ...){
+
+    char buffer[PRINTF_BUFFER_SIZE];
+    va_list args;
+
+    if(pFormat == NULL) return SHCOM_STATUS_ERROR;
+
+    va_start(args, pFormat);
+    int len = vsnprintf(buffer, sizeof(buffer), pFormat, args);
+    va_end(args);
+
+    if(len < 0) return SHCOM_STATUS_ERROR;
+    if(len >= (int)sizeof(buffer))  len = sizeof(buffer) - 1;
+
+    //Keep the shell output of the task in order
+    flushLine(currentLine());
+
+    return writeRecord(buffer, len);
+}
+
+/***************************************************************************//*!
+*  \brief Shell communication get transmit backlog.
+*
+*   This function is use to get the output ring bytes not sent yet (cheap
+*   check for producers that adapt their rate to the transport).
+*
+*   Preconditions:  None.
+*
+*	\return		Bytes pending.
+*
+*******************************************************************************/
+uint32_t SHCOM_GetTxPending(void){
+
+    return __atomic_load_n(&tx_head, __ATOMIC_RELAXED) -
+           __atomic_load_n(&tx_tail, __ATOMIC_RELAXED);
+}
+
+/***************************************************************************//*!
+*  \brief Shell communication get statistics.
+*
+*   This function is use to get the receive path (lines, bytes, listener
+*   wakeups and CPU cycles), transmit path and transport statistics since
+*   the last reset.
+*
+*   Preconditions:  None.
+*
+*	\param[out] pStats              Pointer to store the statistics.
+*
+*	\return		Operation status.
+*
+*******************************************************************************/
+SHCOM_Ret_t SHCOM_GetStats(SHCOM_Stats_t *pStats){
+
+    if(pStats == NULL)  return SHCOM_STATUS_ERROR;
+
+    portENTER_CRITICAL(&rx_stats_spinlock);
+    *pStats = rx_stats;
+    pStats->elapsed_us = esp_timer_get_time() - rx_stats_start_us;
+    portEXIT_CRITICAL(&rx_stats_spinlock);
+
+    pStats->nb_tx_records = __atomic_load_n(&tx_nb_records, __ATOMIC_RELAXED);
+    pStats->nb_tx_bytes = __atomic_load_n(&tx_nb_bytes, __ATOMIC_RELAXED);
+    pStats->nb_tx_dropped = __atomic_load_n(&tx_nb_dropped, __ATOMIC_RELAXED);
+    pStats->tx_pending = __atomic_load_n(&tx_head, __ATOMIC_RELAXED) -
+                         __atomic_load_n(&tx_tail, __ATOMIC_RELAXED);
+
+    memset(&pStats->transport, 0, sizeof(pStats->transport));
+    pStats->pTransport = "none";
+
+    if(pTransport != NULL){
+        pStats->pTransport = pTransport->pName;
+        pTransport->pGetStats(&pStats->transport);
+    }
+
+    return SHCOM_STATUS_OK;
+}
+
+/***************************************************************************//*!
+*  \brief Shell communication reset statistics.
+*
+*   This function is use to reset the receive path, transmit path and
+*   transport statistics.
+*
+*   Preconditions:  None.
+*
+*	\return		Operation status.
+*
+*******************************************************************************/
+SHCOM_Ret_t SHCOM_ResetStats(void){
+
+    portENTER_CRITICAL(&rx_stats_spinlock);
+    memset(&rx_stats, 0, sizeof(rx_stats));
+    rx_stats_start_us = esp_timer_get_time();
+    portEXIT_CRITICAL(&rx_stats_spinlock);
+
+    __atomic_store_n(&tx_nb_records, 0, __ATOMIC_RELAXED);
+    __atomic_store_n(&tx_nb_bytes, 0, __ATOMIC_RELAXED);
+    __atomic_store_n(&tx_nb_dropped, 0, __ATOMIC_RELAXED);
+
+    if(pTransport != NULL)  pTransport->pResetStats();
+
+    return SHCOM_STATUS_OK;
+}
+
+/***************************************************************************//*!
+*  \brief Shell communication set break callback.
+*
+*   This function is use to set the function called when Ctrl-C is
+*   received (cancel the running command). The character is not handed to
+*   the shell.
+*
+*   Preconditions:  None.
+*
+*	\param[in]  callback            Break callback (NULL: Ctrl-C ignored).
+*
+*	\return		Operation status.
+*
+*******************************************************************************/
+SHCOM_Ret_t SHCOM_SetBreakCallback(SHCOM_BreakCallback_t callback){
+
+    __atomic_store_n(&break_callback, callback, __ATOMIC_RELEASE);
+
+    return SHCOM_STATUS_OK;
+}
+
+/******************************************************************************
+*   Interrupts
+*******************************************************************************/
@@ -0,0 +1,255 @@
+#ifndef __SHELL_COM_H
+#define __SHELL_COM_H
+
+#include <stdint.h>
+#include <stdbool.h>
+#include "driver/uart.h"
+
+/******************************************************************************
+*   Public Definitions
+*******************************************************************************/
+#define SHCOM_LINE_TERMINATOR           ('\r')//Enter key, also ends CR LF lines
+#define SHCOM_BREAK_CHARACTER           ('\x03')//Ctrl-C, not handed to the shell
+#define SHCOM_MAX_SHELL_TASKS           (4)//Tasks with a shell output line (listener included)
+
+
+/******************************************************************************
+*   Public Macros
+*******************************************************************************/
+
+
+/******************************************************************************
+*   Public Data Types
+*******************************************************************************/
+typedef enum SHCOM_TransportType_e{
+    SHCOM_TRANSPORT_UART,               //UART driver (FIFO interrupts)
+    SHCOM_TRANSPORT_UART_DMA,           //UART with UHCI/GDMA transfers (multi-megabaud streaming)
+    SHCOM_TRANSPORT_USB_JTAG,           //Native USB Serial/JTAG (no external converter)
+
+    SHCOM_TRANSPORT_INVALID,
+}SHCOM_TransportType_t;
+
+typedef struct SHCOM_Config_s{
+    SHCOM_TransportType_t transport;
+    uint8_t tx_gpio;                    //UART transports only
+    uint8_t rx_gpio;
+    uint32_t baudrate;
+    uart_port_t port;
+}SHCOM_Config_t;
+
+typedef struct SHCOM_TransportStats_s{
+    uint64_t nb_rx_bytes;               //Bytes read from the transport
+    uint64_t nb_tx_bytes;               //Bytes handed to the transport
+    uint32_t rx_queued;                 //Bytes waiting in the transport receive queue
+    uint32_t tx_queued;                 //Bytes waiting in the transport transmit queue
+    uint32_t nb_rx_dropped;             //Bytes lost on receive (overflow)
+    uint32_t nb_tx_dropped;             //Bytes not sent (host not reading)
+    uint32_t nb_isr;                    //Transport interrupts (0: not available)
+    uint64_t isr_cycles;                //Interrupt CPU cycles
+}SHCOM_TransportStats_t;
+
+typedef struct SHCOM_Stats_s{
+    uint32_t nb_lines;                  //Complete lines received
+    uint32_t nb_bytes;
+    uint32_t nb_wakeups;                //Listener task wakeups (input events)
+    uint32_t nb_overflows;              //Buffer full / FIFO overflow (input lost)
+    uint64_t busy_cycles;               //Listener CPU cycles
+    uint32_t nb_tx_records;             //Lines / strings written out
+    uint32_t nb_tx_bytes;
+    uint32_t nb_tx_dropped;             //Output ring full (host not reading)
+    uint32_t tx_pending;                //Output ring bytes not sent yet
+    const char *pTransport;             //Transport name
+    SHCOM_TransportStats_t transport;
+    int64_t elapsed_us;                 //Time since the statistics reset
+}SHCOM_Stats_t;
+
+//Called on SHCOM_BREAK_CHARACTER (listener task)
+typedef void (*SHCOM_BreakCallback_t)(void);
+
+typedef enum SHCOM_Ret_e{
+    SHCOM_STATUS_ERROR,
+    SHCOM_STATUS_OK,
+}SHCOM_Ret_t;
+
+/******************************************************************************
+*   Public Variables
+*******************************************************************************/
+
+
+/******************************************************************************
+*   Error Check
+*******************************************************************************/
+
+
+/******************************************************************************
+*   Public Functions Declarations
+*******************************************************************************/
+/***************************************************************************//*!
+*  \brief Shell communication peripheral initialization.
+*
+*   This function is use to initialize required peripherals for the Shell
+*   communication: the transport selected in the config (UART, UART DMA or
+*   USB Serial/JTAG), then the listener and sender tasks.
+*
+*   Preconditions:  None.
+*
+*	\param[in]  pConfig     Pointer to com config.
+*
+*	\return		Operation status.
+*
+*******************************************************************************/
+SHCOM_Ret_t SHCOM_InitCom(SHCOM_Config_t *pConfig);
+
+/***************************************************************************//*!
+*  \brief Shell communication print character.
+*
+*   This function is use by the shell to print character out. Characters
+*   are buffered in the calling task line and written on new line, when
+*   the buffer is full, at the end of the received input processing or on
+*   SHCOM_FlushLine().
+*
+*   Preconditions:  Called from a shell task (listener or registered).
+*
+*	\param[in]  c                   Character to print.
+*
+*	\return		Operation status.
+*
+*******************************************************************************/
+SHCOM_Ret_t SHCOM_PrintCharacter(char c);
+
+/***************************************************************************//*!
+*  \brief Shell communication flush line.
+*
+*   This function is use to write the shell characters buffered so far by
+*   the calling task (end of a command run outside of the listener).
+*
+*   Preconditions:  None.
+*
+*	\return		Operation status.
+*
+*******************************************************************************/
+SHCOM_Ret_t SHCOM_FlushLine(void);
+
+/***************************************************************************//*!
+*  \brief Shell communication register shell task.
+*
+*   This function is use to give the calling task its own shell output line
+*   (SHCOM_PrintCharacter()), for the tasks running shell commands besides
+*   the listener. Like the listener, its output waits for room in the
+*   output ring instead of being dropped. Registering twice is harmless.
+*
+*   Preconditions:  None.
+*
+*	\return		Operation status (error if SHCOM_MAX_SHELL_TASKS reached).
+*
+*******************************************************************************/
+SHCOM_Ret_t SHCOM_RegisterShellTask(void);
+
+/***************************************************************************//*!
+*  \brief Shell communication print string.
+*
+*   This function is use to print a string out. The string is written out
+*   in one piece, it is dropped when the output ring is full (never blocks,
+*   except the shell tasks that wait for room).
+*
+*   Preconditions:  Shell communication initialized.
+*
+*	\param[in]  pString             String to print.
+*
+*	\return		Operation status.
+*
+*******************************************************************************/
+SHCOM_Ret_t SHCOM_Print(const char *pString);
+
+/***************************************************************************//*!
+*  \brief Shell communication write.
+*
+*   This function is use to write binary data out (telemetry frames),
+*   multiplexed with the shell text. The data is written out in one piece,
+*   it is dropped when the output ring is full (never blocks).
+*
+*   Preconditions:  Shell communication initialized.
+*
+*	\param[in]  pData               Data to write.
+*	\param[in]  len                 Data length.
+*
+*	\return		Operation status.
+*
+*******************************************************************************/
+SHCOM_Ret_t SHCOM_Write(const uint8_t *pData, size_t len);
+
+/***************************************************************************//*!
+*  \brief Shell communication formatted print.
+*
+*   This function is use to print a formatted string out (printf like).
+*   The output is truncated to 128 characters and written out in one
+*   piece, like SHCOM_Print().
+*
+*   Preconditions:  Shell communication initialized.
+*
+*	\param[in]  pFormat             Format string.
+*
+*	\return		Operation status.
+*
+*******************************************************************************/
+SHCOM_Ret_t SHCOM_Printf(const char *pFormat, ...);
+
+/***************************************************************************//*!
+*  \brief Shell communication get transmit backlog.
+*
+*   This function is use to get the output ring bytes not sent yet (cheap
+*   check for producers that adapt their rate to the transport).
+*
+*   Preconditions:  None.
+*
+*	\return		Bytes pending.
+*
+*******************************************************************************/
+uint32_t SHCOM_GetTxPending(void);
+
+/***************************************************************************//*!
+*  \brief Shell communication get statistics.
+*
+*   This function is use to get the receive path (lines, bytes, listener
+*   wakeups and CPU cycles), transmit path and transport statistics since
+*   the last reset.
+*
+*   Preconditions:  None.
+*
+*	\param[out] pStats              Pointer to store the statistics.
+*
+*	\return		Operation status.
+*
+*******************************************************************************/
+SHCOM_Ret_t SHCOM_GetStats(SHCOM_Stats_t *pStats);
+
+/***************************************************************************//*!
+*  \brief Shell communication reset statistics.
+*
+*   This function is use to reset the receive path, transmit path and
+*   transport statistics.
+*
+*   Preconditions:  None.
+*
+*	\return		Operation status.
+*
+*******************************************************************************/
+SHCOM_Ret_t SHCOM_ResetStats(void);
+
+/***************************************************************************//*!
+*  \brief Shell communication set break callback.
+*
+*   This function is use to set the function called when Ctrl-C is
+*   received (cancel the running command). The character is not handed to
+*   the shell.
+*
+*   Preconditions:  None.
+*
+*	\param[in]  callback            Break callback (NULL: Ctrl-C ignored).
+*
+*	\return		Operation status.
+*
+*******************************************************************************/
+SHCOM_Ret_t SHCOM_SetBreakCallback(SHCOM_BreakCallback_t callback);
+
+#endif//__SHELL_COM_H
\ No newline at end of file
@@ -0,0 +1,67 @@
+#ifndef __SHELL_COM_TRANSPORT_H
+#define __SHELL_COM_TRANSPORT_H
+
+#include <stdint.h>
+#include <stddef.h>
+#include "shellCom.h"
+
+/******************************************************************************
+*   Public Definitions
+*******************************************************************************/
+#define SHCOM_TX_MAX_SEGMENT_LEN        (512)//Largest pSend() segment (output record)
+
+
+/******************************************************************************
+*   Public Macros
+*******************************************************************************/
+
+
+/******************************************************************************
+*   Public Data Types
+*******************************************************************************/
+//Called by the transport for every received chunk (listener task)
+typedef void (*SHCOM_RecvHandler_t)(const uint8_t *pData, size_t len);
+
+//Shell communication transport. The receive functions are only called from
+//the listener task, the transmit functions only from the sender task.
+typedef struct SHCOM_Transport_s{
+    const char *pName;
+    uint32_t max_tx_segments;           //Segments queued before pFlush (a record takes 1 or 2)
+
+    //Initialize the peripheral and its driver
+    SHCOM_Ret_t (*pInit)(const SHCOM_Config_t *pConfig);
+
+    //Block until the next input event
+    void (*pWaitInput)(void);
+
+    //Read the input of the last event through the handler, error when
+    //input was lost
+    SHCOM_Ret_t (*pReadInput)(SHCOM_RecvHandler_t recvHandler);
+
+    //Queue an output ring segment, valid until pFlush returns
+    SHCOM_Ret_t (*pSend)(const uint8_t *pData, size_t len);
+
+    //Wait until the queued segments are sent (NULL: pSend copies)
+    void (*pFlush)(void);
+
+    void (*pGetStats)(SHCOM_TransportStats_t *pStats);
+    void (*pResetStats)(void);
+}SHCOM_Transport_t;
+
+/******************************************************************************
+*   Public Variables
+*******************************************************************************/
+extern const SHCOM_Transport_t shcom_uart_transport;       //shellComUART.c
+extern const SHCOM_Transport_t shcom_uart_dma_transport;   //shellComUART.c
+extern const SHCOM_Transport_t shcom_usb_jtag_transport;   //shellComUSB.c
+
+/******************************************************************************
+*   Error Check
+*******************************************************************************/
+
+
+/******************************************************************************
+*   Public Functions Declarations
+*******************************************************************************/
+
+#endif//__SHELL_COM_TRANSPORT_H
@@ -1,16 +1,34 @@
+#include <string.h>
+
 #include "freertos/FreeRTOS.h"
 #include "freertos/queue.h"
-#include "freertos/task.h"
+#include "freertos/semphr.h"
+
+#include "esp_attr.h"
+#include "driver/uart.h"
 
-#include "myShell.h"
-#include "shellComUART.h"
-#include "taskPriority.h"
+#include "shellCom.h"
+#include "shellComTransport.h"
+#include "uartDma.h"
 
 /******************************************************************************
 *   Private Definitions
 *******************************************************************************/
 #define UART_EVENT_QUEUE_SIZE           (16)
-#define UART_RX_TIMEOUT_MS              (250)
+#define UART_RX_BUFFER_SIZE             (1024)//Driver ring buffer (pasted scripts)
+#define UART_TX_BUFFER_SIZE             (256)//Driver ring buffer (2 FIFOs)
+#define UART_LINE_BUFFER_SIZE           (256)//Longer lines are read in chunks
+#define UART_TX_SEGMENTS                (2)//uart_write_bytes() copies, one record at a time
+
+#define UART_PATTERN_QUEUE_SIZE         (16)//Lines pending in the driver ring buffer
+#define UART_PATTERN_CHR_TOUT           (9)//Baud cycles (pattern of 1 char, unused)
+#define UART_PATTERN_POST_IDLE          (0)//Terminator detected inside a burst
+#define UART_PATTERN_PRE_IDLE           (0)
+
+#define UART_DMA_RX_NB_BUFFERS          (4)
+#define UART_DMA_RX_BUFFER_SIZE         (256)
+#define UART_DMA_RX_IDLE_THR            (20)//Bit times (2 characters) ending a receive buffer
+#define UART_DMA_TX_QUEUE_DEPTH         (UDMA_QUEUE_DEPTH)//Ring segments in flight (2 per wrapped record)
 
 /******************************************************************************
 *   Private Macros
@@ -20,129 +38,226 @@
 /******************************************************************************
 *   Private Data Types
 *******************************************************************************/
-
+typedef struct UART_DmaRx_s{
+    uint8_t *pBuffer;
+    size_t len;
+    bool is_stalled;                    //No buffer left queued, input may be lost
+}UART_DmaRx_t;
 
 /******************************************************************************
 *   Private Functions Declaration
 *******************************************************************************/
-static void tUartListenerTask(void *pvParameters);
+static SHCOM_Ret_t initPort(const SHCOM_Config_t *pConfig);
+static size_t readBuffered(size_t len, SHCOM_RecvHandler_t recvHandler);
+static void readLines(bool is_partial_line, SHCOM_RecvHandler_t recvHandler);
+
+static SHCOM_Ret_t uartInit(const SHCOM_Config_t *pConfig);
+static void uartWaitInput(void);
+static SHCOM_Ret_t uartReadInput(SHCOM_RecvHandler_t recvHandler);
+static SHCOM_Ret_t uartSend(const uint8_t *pData, size_t len);
+static void uartGetStats(SHCOM_TransportStats_t *pStats);
+static void uartResetStats(void);
+
+static SHCOM_Ret_t dmaInit(const SHCOM_Config_t *pConfig);
+static void dmaWaitInput(void);
+static SHCOM_Ret_t dmaReadInput(SHCOM_RecvHandler_t recvHandler);
+static SHCOM_Ret_t dmaSend(const uint8_t *pData, size_t len);
+static void dmaFlush(void);
+static void dmaGetStats(SHCOM_TransportStats_t *pStats);
+static void dmaResetStats(void);
+static bool dmaRxDoneCallback(uint8_t *pBuffer, size_t len, bool is_stalled);
+static bool dmaTxDoneCallback(const uint8_t *pBuffer, size_t len);
 
 /******************************************************************************
 *   Public Variables
 *******************************************************************************/
-
+const SHCOM_Transport_t shcom_uart_transport = {
+    .pName = "uart",
+    .max_tx_segments = UART_TX_SEGMENTS,
+    .pInit = uartInit,
+    .pWaitInput = uartWaitInput,
+    .pReadInput = uartReadInput,
+    .pSend = uartSend,
+    .pFlush = NULL,
+    .pGetStats = uartGetStats,
+    .pResetStats = uartResetStats,
+};
+
+const SHCOM_Transport_t shcom_uart_dma_transport = {
+    .pName = "uart dma",
+    .max_tx_segments = UART_DMA_TX_QUEUE_DEPTH,
+    .pInit = dmaInit,
+    .pWaitInput = dmaWaitInput,
+    .pReadInput = dmaReadInput,
+    .pSend = dmaSend,
+    .pFlush = dmaFlush,
+    .pGetStats = dmaGetStats,
+    .pResetStats = dmaResetStats,
+};
 
 /******************************************************************************
 *   Private Variables
 *******************************************************************************/
-static QueueHandle_t uart_event_queue_handle = NULL;
-static TaskHandle_t uart_listener_task_handle = NULL;
-
 static uart_port_t uart_port;
-static uint32_t uart_tx_gpio;
-static uint32_t uart_rx_gpio;
+
+//Interrupt driven driver (listener task only)
+static QueueHandle_t uart_event_queue_handle = NULL;
+static uart_event_t uart_event;
+static uint8_t uart_line_buffer[UART_LINE_BUFFER_SIZE];
+
+//DMA mode
+static QueueHandle_t uart_dma_rx_queue_handle = NULL;
+static StaticQueue_t uart_dma_rx_queue_buffer;
+static uint8_t uart_dma_rx_queue_storage[UART_DMA_RX_NB_BUFFERS * sizeof(UART_DmaRx_t)];
+static SemaphoreHandle_t uart_dma_tx_done_sem_handle = NULL;
+static StaticSemaphore_t uart_dma_tx_done_sem_buffer;
+static uint8_t uart_dma_rx_buffers[UART_DMA_RX_NB_BUFFERS][UART_DMA_RX_BUFFER_SIZE];
+static UART_DmaRx_t uart_dma_rx;
+static uint32_t uart_dma_tx_nb_segments = 0;//Sender task only
+static uint32_t uart_dma_tx_queued = 0;
+static uint32_t uart_dma_rx_queued = 0;
+
+//Updated by the listener and sender tasks
+static uint64_t uart_nb_rx_bytes = 0;
+static uint64_t uart_nb_tx_bytes = 0;
+static uint32_t uart_nb_rx_dropped = 0;
+static uint32_t uart_nb_tx_dropped = 0;
+static portMUX_TYPE uart_stats_spinlock = portMUX_INITIALIZER_UNLOCKED;
 
 /******************************************************************************
 *   Error Check
 *******************************************************************************/
-
+_Static_assert(SHCOM_TX_MAX_SEGMENT_LEN <= UDMA_MAX_TRANSFER_SIZE, "Output segment larger than a DMA transfer");
+_Static_assert(UART_DMA_RX_NB_BUFFERS <= UDMA_QUEUE_DEPTH, "More receive buffers than DMA queue slots");
 
 /******************************************************************************
 *   Private Functions Definitions
 *******************************************************************************/
 /***************************************************************************//*!
-*  \brief Uart listener task.
+*  \brief Init port.
 *
-*   This function is the UART event listener task.
+*   This function configures the UART port (frame format, baud rate and
+*   pins).
 *
 *   Preconditions:  None.
 *
+*   \param[in]  pConfig             Pointer to com config.
+*
+*   \return     Operation status.
+*
 *******************************************************************************/
-static void tUartListenerTask(void *pvParameters){
-
-    uart_event_t event;
-    size_t buffer_len;
-    uint8_t read_len;
-    uint8_t incoming_byte;
-
-    for(;;){
-
-        while(pdTRUE == xQueueReceive(uart_event_queue_handle, 
-                                      &event, 
-                                      0)){
-
-            switch(event.type){
-                
-                case UART_DATA:
-                {
-                    uart_get_buffered_data_len(uart_port, &buffer_len);
-                }
-                break;
-
-                case UART_BUFFER_FULL:
-                case UART_FIFO_OVF:
-                {
-                    uart_get_buffered_data_len(uart_port, &buffer_len);
-                    uart_flush_input(uart_port);
-                }
-                break;
-
-                case UART_BREAK:
-                case UART_FRAME_ERR:
-                case UART_PATTERN_DET:
-                default:
-                {
-                    //Do nothing...
-                }
-                break;
-            }
+static SHCOM_Ret_t initPort(const SHCOM_Config_t *pConfig){
 
-        }
+    uart_config_t config = {
+        .baud_rate = pConfig->baudrate,
+        .data_bits = UART_DATA_8_BITS,
+        .parity = UART_PARITY_DISABLE,
+        .stop_bits = UART_STOP_BITS_1,
+        .flow_ctrl = UART_HW_FLOWCTRL_DISABLE,
+        .source_clk = UART_SCLK_DEFAULT,
+    };
 
-        read_len = uart_read_bytes(uart_port, &incoming_byte, 1, UART_RX_TIMEOUT_MS/portTICK_PERIOD_MS);
-        if(read_len > 0){
-            SHELL_RecvChar((char)incoming_byte);
-        }
+    if((ESP_OK != uart_param_config(pConfig->port, &config)) ||
+       (ESP_OK != uart_set_pin(pConfig->port,
+                               pConfig->tx_gpio,
+                               pConfig->rx_gpio,
+                               UART_PIN_NO_CHANGE,
+                               UART_PIN_NO_CHANGE))){
+
+        return SHCOM_STATUS_ERROR;
     }
-    vTaskDelete(NULL);
+
+    uart_port = pConfig->port;
+
+    return SHCOM_STATUS_OK;
 }
 
-/******************************************************************************
-*   CallBack Functions implementation
+/***************************************************************************//*!
+*  \brief Read buffered.
+*
+*   This function reads bytes from the driver buffer in chunks and hands
+*   them to the receive handler.
+*
+*   Preconditions:  Called from the listener task.
+*
+*   \param[in]  len                 Number of bytes to read.
+*   \param[in]  recvHandler         Receive handler.
+*
+*   \return     Number of bytes read.
+*
 *******************************************************************************/
+static size_t readBuffered(size_t len, SHCOM_RecvHandler_t recvHandler){
 
+    size_t nb_bytes = 0;
 
-/******************************************************************************
-*   Public Functions Definitions
+    while(len > 0){
+        size_t chunk_len = (len < sizeof(uart_line_buffer)) ? len : sizeof(uart_line_buffer);
+        int read_len = uart_read_bytes(uart_port, uart_line_buffer, chunk_len, 0);
+        if(read_len <= 0)   break;
+
+        recvHandler(uart_line_buffer, read_len);
+        nb_bytes += read_len;
+        len -= read_len;
+    }
+
+    return nb_bytes;
+}
+
+/***************************************************************************//*!
+*  \brief Read lines.
+*
+*   This function reads the complete lines (up to the terminator found by
+*   the pattern detection) from the driver buffer, one read per line, and
+*   hands them to the receive handler. The partial line left is only read
+*   when the sender went idle (interactive typing, echo).
+*
+*   Preconditions:  Called from the listener task.
+*
+*   \param[in]  is_partial_line     Read the partial line left.
+*   \param[in]  recvHandler         Receive handler.
+*
 *******************************************************************************/
+static void readLines(bool is_partial_line, SHCOM_RecvHandler_t recvHandler){
+
+    size_t nb_bytes = 0;
+    int pattern_pos;
+
+    //Complete lines (position of the terminator in the driver buffer)
+    while((pattern_pos = uart_pattern_pop_pos(uart_port)) >= 0){
+        nb_bytes += readBuffered((size_t)pattern_pos + 1, recvHandler);
+    }
+
+    //Partial line: read whatever is buffered
+    if(is_partial_line){
+        size_t buffer_len = 0;
+        uart_get_buffered_data_len(uart_port, &buffer_len);
+        nb_bytes += readBuffered(buffer_len, recvHandler);
+    }
+
+    portENTER_CRITICAL(&uart_stats_spinlock);
+    uart_nb_rx_bytes += nb_bytes;
+    portEXIT_CRITICAL(&uart_stats_spinlock);
+}
+
 /***************************************************************************//*!
-*  \brief Shell communication peripheral initialization.
+*  \brief Uart init.
 *
-*   This function is use to initialize required peripherals for the Shell
-*   communication.
+*   This function installs the interrupt driven UART driver with the line
+*   terminator pattern detection (one event per line instead of per FIFO
+*   chunk).
 *
 *   Preconditions:  None.
 *
-*	\param[in]  pConfig     Pointer to com config.
+*   \param[in]  pConfig             Pointer to com config.
 *
-*	\return		Operation status.
+*   \return     Operation status.
 *
 *******************************************************************************/
-SHCOM_Ret_t SHCOM_InitCom(SHCOM_Config_t *pConfig){
-
-    //Init uart port
-    uart_config_t config = {
-        .baud_rate = pConfig->baudrate,
-        .data_bits = UART_DATA_8_BITS,
-        .parity = UART_PARITY_DISABLE,
-        .stop_bits = UART_STOP_BITS_1,
-        .flow_ctrl = UART_HW_FLOWCTRL_DISABLE,
-        .source_clk = UART_SCLK_DEFAULT,
-    };
+static SHCOM_Ret_t uartInit(const SHCOM_Config_t *pConfig){
 
     if(ESP_OK != uart_driver_install(pConfig->port,
-                                     2*UART_HW_FIFO_LEN(pConfig->port),
-                                     2*UART_HW_FIFO_LEN(pConfig->port),
+                                     UART_RX_BUFFER_SIZE,
+                                     UART_TX_BUFFER_SIZE,
                                      UART_EVENT_QUEUE_SIZE,
                                      &uart_event_queue_handle,
                                      0)){
@@ -150,60 +265,428 @@ SHCOM_Ret_t SHCOM_InitCom(SHCOM_Config_t *pConfig){
         return SHCOM_STATUS_ERROR;
     }
 
-    if(ESP_OK != uart_param_config(pConfig->port, &config)){
+    if(SHCOM_STATUS_OK != initPort(pConfig)){
         return SHCOM_STATUS_ERROR;
     }
 
-    if(ESP_OK != uart_set_pin(pConfig->port, 
-                              pConfig->tx_gpio, 
-                              pConfig->rx_gpio, 
-                              UART_PIN_NO_CHANGE, 
-                              UART_PIN_NO_CHANGE)){
+    if((ESP_OK != uart_enable_pattern_det_baud_intr(pConfig->port,
+                                                    SHCOM_LINE_TERMINATOR,
+                                                    1,
+                                                    UART_PATTERN_CHR_TOUT,
+                                                    UART_PATTERN_POST_IDLE,
+                                                    UART_PATTERN_PRE_IDLE)) ||
+       (ESP_OK != uart_pattern_queue_reset(pConfig->port, UART_PATTERN_QUEUE_SIZE))){
 
         return SHCOM_STATUS_ERROR;
     }
 
     uart_flush(pConfig->port);
 
-    //Store uart port and pins
-    uart_port = pConfig->port;
-    uart_tx_gpio = pConfig->tx_gpio;
-    uart_rx_gpio = pConfig->rx_gpio;
+    return SHCOM_STATUS_OK;
+}
+
+/***************************************************************************//*!
+*  \brief Uart wait input.
+*
+*   This function blocks on the UART event queue.
+*
+*   Preconditions:  Called from the listener task.
+*
+*******************************************************************************/
+static void uartWaitInput(void){
+
+    while(pdTRUE != xQueueReceive(uart_event_queue_handle, &uart_event, portMAX_DELAY));
+}
+
+/***************************************************************************//*!
+*  \brief Uart read input.
+*
+*   This function handles the last UART event: lines are read on the
+*   terminator pattern event, the partial line on the RX idle timeout.
+*
+*   Preconditions:  Called from the listener task.
+*
+*   \param[in]  recvHandler         Receive handler.
+*
+*   \return     Operation status (error: input lost).
+*
+*******************************************************************************/
+static SHCOM_Ret_t uartReadInput(SHCOM_RecvHandler_t recvHandler){
+
+    SHCOM_Ret_t ret = SHCOM_STATUS_OK;
+
+    switch(uart_event.type){
+
+        case UART_PATTERN_DET:
+        {
+            readLines(false, recvHandler);
+        }
+        break;
+
+        case UART_DATA:
+        {
+            //FIFO full events come during a burst: wait for the terminator
+            readLines(uart_event.timeout_flag, recvHandler);
+        }
+        break;
+
+        case UART_BUFFER_FULL:
+        case UART_FIFO_OVF:
+        {
+            //Lines lost: restart from a clean buffer
+            size_t buffer_len = 0;
+            uart_get_buffered_data_len(uart_port, &buffer_len);
+
+            uart_flush_input(uart_port);
+            uart_pattern_queue_reset(uart_port, UART_PATTERN_QUEUE_SIZE);
+            xQueueReset(uart_event_queue_handle);
+
+            portENTER_CRITICAL(&uart_stats_spinlock);
+            uart_nb_rx_dropped += buffer_len;
+            portEXIT_CRITICAL(&uart_stats_spinlock);
+
+            ret = SHCOM_STATUS_ERROR;
+        }
+        break;
+
+        case UART_BREAK:
+        case UART_FRAME_ERR:
+        default:
+        {
+            //Do nothing...
+        }
+        break;
+    }
+
+    return ret;
+}
+
+/***************************************************************************//*!
+*  \brief Uart send.
+*
+*   This function copies a segment to the driver transmit buffer (blocks
+*   while it is full).
+*
+*   Preconditions:  Called from the sender task.
+*
+*   \param[in]  pData               Pointer to the segment.
+*   \param[in]  len                 Segment length.
+*
+*   \return     Operation status.
+*
+*******************************************************************************/
+static SHCOM_Ret_t uartSend(const uint8_t *pData, size_t len){
+
+    int write_len = uart_write_bytes(uart_port, pData, len);
+
+    portENTER_CRITICAL(&uart_stats_spinlock);
+    if(write_len > 0)   uart_nb_tx_bytes += write_len;
+    else                uart_nb_tx_dropped += len;
+    portEXIT_CRITICAL(&uart_stats_spinlock);
+
+    return (write_len == (int)len) ? SHCOM_STATUS_OK : SHCOM_STATUS_ERROR;
+}
+
+/***************************************************************************//*!
+*  \brief Uart get statistics.
+*
+*   This function gets the UART transport statistics: bytes and driver
+*   buffer levels (interrupts not available).
+*
+*   Preconditions:  None.
+*
+*   \param[out] pStats              Pointer to store the statistics.
+*
+*******************************************************************************/
+static void uartGetStats(SHCOM_TransportStats_t *pStats){
+
+    size_t rx_len = 0;
+    size_t tx_free = 0;
+
+    portENTER_CRITICAL(&uart_stats_spinlock);
+    pStats->nb_rx_bytes = uart_nb_rx_bytes;
+    pStats->nb_tx_bytes = uart_nb_tx_bytes;
+    pStats->nb_rx_dropped = uart_nb_rx_dropped;
+    pStats->nb_tx_dropped = uart_nb_tx_dropped;
+    portEXIT_CRITICAL(&uart_stats_spinlock);
 
-    //Create uart listener task
-    if(pdTRUE != xTaskCreate(tUartListenerTask,
-                             "Listener task",
-                             2048,
-                             NULL,
-                             SHCOM_TASK_PRIORITY,
-                             &uart_listener_task_handle)){
+    uart_get_buffered_data_len(uart_port, &rx_len);
+    uart_get_tx_buffer_free_size(uart_port, &tx_free);
 
+    pStats->rx_queued = rx_len;
+    pStats->tx_queued = (tx_free < UART_TX_BUFFER_SIZE) ? (UART_TX_BUFFER_SIZE - tx_free) : 0;
+}
+
+/***************************************************************************//*!
+*  \brief Uart reset statistics.
+*
+*   This function resets the UART transport statistics.
+*
+*   Preconditions:  None.
+*
+*******************************************************************************/
+static void uartResetStats(void){
+
+    portENTER_CRITICAL(&uart_stats_spinlock);
+    uart_nb_rx_bytes = 0;
+    uart_nb_tx_bytes = 0;
+    uart_nb_rx_dropped = 0;
+    uart_nb_tx_dropped = 0;
+    portEXIT_CRITICAL(&uart_stats_spinlock);
+}
+
+/***************************************************************************//*!
+*  \brief DMA init.
+*
+*   This function configures the UART port, attaches the UART DMA to it
+*   and queues the receive buffers.
+*
+*   Preconditions:  UART driver not installed on the port (UHCI reads the
+*                   RX FIFO).
+*
+*   \param[in]  pConfig             Pointer to com config.
+*
+*   \return     Operation status.
+*
+*******************************************************************************/
+static SHCOM_Ret_t dmaInit(const SHCOM_Config_t *pConfig){
+
+    UDMA_Config_t config = {
+        .port = pConfig->port,
+        .rx_idle_thr = UART_DMA_RX_IDLE_THR,
+        .txDoneCallback = dmaTxDoneCallback,
+        .rxDoneCallback = dmaRxDoneCallback,
+    };
+
+    if(SHCOM_STATUS_OK != initPort(pConfig)){
+        return SHCOM_STATUS_ERROR;
+    }
+
+    uart_dma_rx_queue_handle = xQueueCreateStatic(UART_DMA_RX_NB_BUFFERS, sizeof(UART_DmaRx_t),
+                                                  uart_dma_rx_queue_storage, &uart_dma_rx_queue_buffer);
+    uart_dma_tx_done_sem_handle = xSemaphoreCreateCountingStatic(UART_DMA_TX_QUEUE_DEPTH, 0,
+                                                                 &uart_dma_tx_done_sem_buffer);
+
+    if((uart_dma_rx_queue_handle == NULL) || (uart_dma_tx_done_sem_handle == NULL)){
         return SHCOM_STATUS_ERROR;
     }
 
+    if(UDMA_STATUS_OK != UDMA_Init(&config)){
+        return SHCOM_STATUS_ERROR;
+    }
+
+    for(uint32_t i=0; i<UART_DMA_RX_NB_BUFFERS; i++){
+        if(UDMA_STATUS_OK != UDMA_Receive(uart_dma_rx_buffers[i], UART_DMA_RX_BUFFER_SIZE)){
+            return SHCOM_STATUS_ERROR;
+        }
+    }
+
     return SHCOM_STATUS_OK;
 }
 
 /***************************************************************************//*!
-*  \brief Shell communication print character.
+*  \brief DMA wait input.
+*
+*   This function blocks on the received buffers (full or ended on the RX
+*   line idle).
+*
+*   Preconditions:  Called from the listener task.
+*
+*******************************************************************************/
+static void dmaWaitInput(void){
+
+    while(pdTRUE != xQueueReceive(uart_dma_rx_queue_handle, &uart_dma_rx, portMAX_DELAY));
+}
+
+/***************************************************************************//*!
+*  \brief DMA read input.
+*
+*   This function hands the last received buffer to the receive handler
+*   and queues it again for reception.
+*
+*   Preconditions:  Called from the listener task.
+*
+*   \param[in]  recvHandler         Receive handler.
+*
+*   \return     Operation status (error: receive stalled, input may be lost).
+*
+*******************************************************************************/
+static SHCOM_Ret_t dmaReadInput(SHCOM_RecvHandler_t recvHandler){
+
+    recvHandler(uart_dma_rx.pBuffer, uart_dma_rx.len);
+    __atomic_sub_fetch(&uart_dma_rx_queued, uart_dma_rx.len, __ATOMIC_RELAXED);
+
+    UDMA_Receive(uart_dma_rx.pBuffer, UART_DMA_RX_BUFFER_SIZE);
+
+    portENTER_CRITICAL(&uart_stats_spinlock);
+    uart_nb_rx_bytes += uart_dma_rx.len;
+    portEXIT_CRITICAL(&uart_stats_spinlock);
+
+    return uart_dma_rx.is_stalled ? SHCOM_STATUS_ERROR : SHCOM_STATUS_OK;
+}
+
+/***************************************************************************//*!
+*  \brief DMA send.
+*
+*   This function queues a segment to the DMA, without copy.
+*
+*   Preconditions:  Called from the sender task, less than
+*                   UART_DMA_TX_QUEUE_DEPTH segments queued.
+*
+*   \param[in]  pData               Pointer to the segment (DMA capable).
+*   \param[in]  len                 Segment length.
+*
+*   \return     Operation status.
+*
+*******************************************************************************/
+static SHCOM_Ret_t dmaSend(const uint8_t *pData, size_t len){
+
+    SHCOM_Ret_t ret = SHCOM_STATUS_ERROR;
+
+    if(UDMA_STATUS_OK == UDMA_Transmit(pData, len)){
+        uart_dma_tx_nb_segments++;
+        __atomic_add_fetch(&uart_dma_tx_queued, len, __ATOMIC_RELAXED);
+        ret = SHCOM_STATUS_OK;
+    }
+
+    portENTER_CRITICAL(&uart_stats_spinlock);
+    if(ret == SHCOM_STATUS_OK)  uart_nb_tx_bytes += len;
+    else                        uart_nb_tx_dropped += len;
+    portEXIT_CRITICAL(&uart_stats_spinlock);
+
+    return ret;
+}
+
+/***************************************************************************//*!
+*  \brief DMA flush.
+*
+*   This function waits until the queued segments are sent (the DMA reads
+*   the output ring).
+*
+*   Preconditions:  Called from the sender task.
+*
+*******************************************************************************/
+static void dmaFlush(void){
+
+    for(; uart_dma_tx_nb_segments > 0; uart_dma_tx_nb_segments--){
+        xSemaphoreTake(uart_dma_tx_done_sem_handle, portMAX_DELAY);
+    }
+}
+
+/***************************************************************************//*!
+*  \brief DMA get statistics.
 *
-*   This function is use by the shell to print character out.
+*   This function gets the UART DMA transport statistics: bytes, bytes in
+*   flight and interrupts.
 *
 *   Preconditions:  None.
 *
-*	\param[in]  c                   Character to print.
+*   \param[out] pStats              Pointer to store the statistics.
 *
-*	\return		Operation status.
+*******************************************************************************/
+static void dmaGetStats(SHCOM_TransportStats_t *pStats){
+
+    UDMA_Stats_t dma_stats;
+
+    portENTER_CRITICAL(&uart_stats_spinlock);
+    pStats->nb_rx_bytes = uart_nb_rx_bytes;
+    pStats->nb_tx_bytes = uart_nb_tx_bytes;
+    pStats->nb_rx_dropped = uart_nb_rx_dropped;
+    pStats->nb_tx_dropped = uart_nb_tx_dropped;
+    portEXIT_CRITICAL(&uart_stats_spinlock);
+
+    pStats->tx_queued = __atomic_load_n(&uart_dma_tx_queued, __ATOMIC_RELAXED);
+    pStats->rx_queued = __atomic_load_n(&uart_dma_rx_queued, __ATOMIC_RELAXED);
+
+    if(UDMA_STATUS_OK == UDMA_GetStats(&dma_stats)){
+        pStats->nb_isr = dma_stats.nb_isr;
+        pStats->isr_cycles = dma_stats.isr_cycles;
+    }
+}
+
+/***************************************************************************//*!
+*  \brief DMA reset statistics.
+*
+*   This function resets the UART DMA transport statistics.
+*
+*   Preconditions:  None.
 *
 *******************************************************************************/
-SHCOM_Ret_t SHCOM_PrintCharacter(char c){
+static void dmaResetStats(void){
 
-    uart_write_bytes(uart_port, &c, 1);
+    portENTER_CRITICAL(&uart_stats_spinlock);
+    uart_nb_rx_bytes = 0;
+    uart_nb_tx_bytes = 0;
+    uart_nb_rx_dropped = 0;
+    uart_nb_tx_dropped = 0;
+    portEXIT_CRITICAL(&uart_stats_spinlock);
 
-    return SHCOM_STATUS_OK;
+    UDMA_ResetStats();
 }
 
 /******************************************************************************
-*   Interrupts
+*   CallBack Functions implementation
 *******************************************************************************/
+/***************************************************************************//*!
+*  \brief DMA receive done callback.
+*
+*   This function hands a received buffer (full or ended on the RX line
+*   idle) to the listener task, without copy.
+*
+*   Preconditions:  Called from the DMA interrupt.
+*
+*   \param[in]  pBuffer             Received buffer.
+*   \param[in]  len                 Number of bytes received.
+*   \param[in]  is_stalled          No receive buffer left queued.
+*
+*   \return     Higher priority task woken.
+*
+*******************************************************************************/
+static bool IRAM_ATTR dmaRxDoneCallback(uint8_t *pBuffer, size_t len, bool is_stalled){
+
+    BaseType_t is_task_woken = pdFALSE;
+    UART_DmaRx_t rx = {
+        .pBuffer = pBuffer,
+        .len = len,
+        .is_stalled = is_stalled,
+    };
+
+    __atomic_add_fetch(&uart_dma_rx_queued, rx.len, __ATOMIC_RELAXED);
+
+    //Never full: one entry per receive buffer
+    xQueueSendFromISR(uart_dma_rx_queue_handle, &rx, &is_task_woken);
+
+    return (is_task_woken == pdTRUE);
+}
+
+/***************************************************************************//*!
+*  \brief DMA transmit done callback.
+*
+*   This function signals a ring segment sent to the sender task.
+*
+*   Preconditions:  Called from the DMA interrupt.
+*
+*   \param[in]  pBuffer             Sent segment.
+*   \param[in]  len                 Segment length.
+*
+*   \return     Higher priority task woken.
+*
+*******************************************************************************/
+static bool IRAM_ATTR dmaTxDoneCallback(const uint8_t *pBuffer, size_t len){
+
+    BaseType_t is_task_woken = pdFALSE;
 
+    __atomic_sub_fetch(&uart_dma_tx_queued, len, __ATOMIC_RELAXED);
+    xSemaphoreGiveFromISR(uart_dma_tx_done_sem_handle, &is_task_woken);
+
+    return (is_task_woken == pdTRUE);
+}
+
+/******************************************************************************
+*   Public Functions Definitions
+*******************************************************************************/
+
+
+/******************************************************************************
+*   Interrupts
+*******************************************************************************/
@@ -0,0 +1,241 @@
+#include <string.h>
+
+#include "freertos/FreeRTOS.h"
+
+#include "driver/usb_serial_jtag.h"
+
+#include "shellCom.h"
+#include "shellComTransport.h"
+
+/******************************************************************************
+*   Private Definitions
+*******************************************************************************/
+#define USB_RX_BUFFER_SIZE              (1024)//Driver ring buffer (pasted scripts)
+#define USB_TX_BUFFER_SIZE              (2048)//Driver ring buffer (output bursts)
+#define USB_READ_BUFFER_SIZE            (128)//2 full speed packets
+#define USB_TX_SEGMENTS                 (2)//usb_serial_jtag_write_bytes() copies, one record at a time
+#define USB_TX_TIMEOUT_MS               (20)//Host not reading: drop instead of blocking the ring
+
+/******************************************************************************
+*   Private Macros
+*******************************************************************************/
+
+
+/******************************************************************************
+*   Private Data Types
+*******************************************************************************/
+
+
+/******************************************************************************
+*   Private Functions Declaration
+*******************************************************************************/
+static SHCOM_Ret_t usbInit(const SHCOM_Config_t *pConfig);
+static void usbWaitInput(void);
+static SHCOM_Ret_t usbReadInput(SHCOM_RecvHandler_t recvHandler);
+static SHCOM_Ret_t usbSend(const uint8_t *pData, size_t len);
+static void usbGetStats(SHCOM_TransportStats_t *pStats);
+static void usbResetStats(void);
+
+/******************************************************************************
+*   Public Variables
+*******************************************************************************/
+const SHCOM_Transport_t shcom_usb_jtag_transport = {
+    .pName = "usb jtag",
+    .max_tx_segments = USB_TX_SEGMENTS,
+    .pInit = usbInit,
+    .pWaitInput = usbWaitInput,
+    .pReadInput = usbReadInput,
+    .pSend = usbSend,
+    .pFlush = NULL,
+    .pGetStats = usbGetStats,
+    .pResetStats = usbResetStats,
+};
+
+/******************************************************************************
+*   Private Variables
+*******************************************************************************/
+//Listener task only
+static uint8_t usb_read_buffer[USB_READ_BUFFER_SIZE];
+static size_t usb_read_len = 0;
+
+//Updated by the listener and sender tasks
+static uint64_t usb_nb_rx_bytes = 0;
+static uint64_t usb_nb_tx_bytes = 0;
+static uint32_t usb_nb_tx_dropped = 0;
+static portMUX_TYPE usb_stats_spinlock = portMUX_INITIALIZER_UNLOCKED;
+
+/******************************************************************************
+*   Error Check
+*******************************************************************************/
+
+
+/******************************************************************************
+*   Private Functions Definitions
+*******************************************************************************/
+/***************************************************************************//*!
+*  \brief Usb init.
+*
+*   This function installs the USB Serial/JTAG driver (no pins, no baud
+*   rate: the host sets the pace).
+*
+*   Preconditions:  USB Serial/JTAG not used by the console driver.
+*
+*   \param[in]  pConfig             Pointer to com config (unused).
+*
+*   \return     Operation status.
+*
+*******************************************************************************/
+static SHCOM_Ret_t usbInit(const SHCOM_Config_t *pConfig){
+
+    usb_serial_jtag_driver_config_t config = {
+        .rx_buffer_size = USB_RX_BUFFER_SIZE,
+        .tx_buffer_size = USB_TX_BUFFER_SIZE,
+    };
+
+    if(ESP_OK != usb_serial_jtag_driver_install(&config)){
+        return SHCOM_STATUS_ERROR;
+    }
+
+    return SHCOM_STATUS_OK;
+}
+
+/***************************************************************************//*!
+*  \brief Usb wait input.
+*
+*   This function blocks until bytes are received (one read per OUT
+*   packet batch).
+*
+*   Preconditions:  Called from the listener task.
+*
+*******************************************************************************/
+static void usbWaitInput(void){
+
+    int read_len;
+
+    while((read_len = usb_serial_jtag_read_bytes(usb_read_buffer, sizeof(usb_read_buffer), portMAX_DELAY)) <= 0);
+
+    usb_read_len = read_len;
+}
+
+/***************************************************************************//*!
+*  \brief Usb read input.
+*
+*   This function hands the bytes received to the receive handler, then
+*   drains the driver buffer without waiting.
+*
+*   Preconditions:  Called from the listener task.
+*
+*   \param[in]  recvHandler         Receive handler.
+*
+*   \return     Operation status (always ok: USB flow control, no loss).
+*
+*******************************************************************************/
+static SHCOM_Ret_t usbReadInput(SHCOM_RecvHandler_t recvHandler){
+
+    size_t nb_bytes = 0;
+    int read_len;
+
+    recvHandler(usb_read_buffer, usb_read_len);
+    nb_bytes += usb_read_len;
+
+    while((read_len = usb_serial_jtag_read_bytes(usb_read_buffer, sizeof(usb_read_buffer), 0)) > 0){
+        recvHandler(usb_read_buffer, read_len);
+        nb_bytes += read_len;
+    }
+
+    portENTER_CRITICAL(&usb_stats_spinlock);
+    usb_nb_rx_bytes += nb_bytes;
+    portEXIT_CRITICAL(&usb_stats_spinlock);
+
+    return SHCOM_STATUS_OK;
+}
+
+/***************************************************************************//*!
+*  \brief Usb send.
+*
+*   This function copies a segment to the driver transmit buffer. The
+*   segment is dropped when no host is connected or the host does not read
+*   within USB_TX_TIMEOUT_MS.
+*
+*   Preconditions:  Called from the sender task.
+*
+*   \param[in]  pData               Pointer to the segment.
+*   \param[in]  len                 Segment length.
+*
+*   \return     Operation status.
+*
+*******************************************************************************/
+static SHCOM_Ret_t usbSend(const uint8_t *pData, size_t len){
+
+    int write_len = 0;
+
+    if(usb_serial_jtag_is_connected()){
+        write_len = usb_serial_jtag_write_bytes(pData, len, pdMS_TO_TICKS(USB_TX_TIMEOUT_MS));
+    }
+
+    portENTER_CRITICAL(&usb_stats_spinlock);
+    if(write_len > 0)   usb_nb_tx_bytes += write_len;
+    else                usb_nb_tx_dropped += len;
+    portEXIT_CRITICAL(&usb_stats_spinlock);
+
+    return (write_len == (int)len) ? SHCOM_STATUS_OK : SHCOM_STATUS_ERROR;
+}
+
+/***************************************************************************//*!
+*  \brief Usb get statistics.
+*
+*   This function gets the USB Serial/JTAG transport statistics: bytes and
+*   driver buffer levels (interrupts not counted).
+*
+*   Preconditions:  None.
+*
+*   \param[out] pStats              Pointer to store the statistics.
+*
+*******************************************************************************/
+static void usbGetStats(SHCOM_TransportStats_t *pStats){
+
+    size_t rx_len = 0;
+    size_t tx_len = 0;
+
+    portENTER_CRITICAL(&usb_stats_spinlock);
+    pStats->nb_rx_bytes = usb_nb_rx_bytes;
+    pStats->nb_tx_bytes = usb_nb_tx_bytes;
+    pStats->nb_tx_dropped = usb_nb_tx_dropped;
+    portEXIT_CRITICAL(&usb_stats_spinlock);
+
+    usb_serial_jtag_get_buffered_data_len(&rx_len, &tx_len);
+
+    pStats->rx_queued = rx_len;
+    pStats->tx_queued = tx_len;
+}
+
+/***************************************************************************//*!
+*  \brief Usb reset statistics.
+*
+*   This function resets the USB Serial/JTAG transport statistics.
+*
+*   Preconditions:  None.
+*
+*******************************************************************************/
+static void usbResetStats(void){
+
+    portENTER_CRITICAL(&usb_stats_spinlock);
+    usb_nb_rx_bytes = 0;
+    usb_nb_tx_bytes = 0;
+    usb_nb_tx_dropped = 0;
+    portEXIT_CRITICAL(&usb_stats_spinlock);
+}
+
+/******************************************************************************
+*   CallBack Functions implementation
+*******************************************************************************/
+
+
+/******************************************************************************
+*   Public Functions Definitions
+*******************************************************************************/
+
+
+/******************************************************************************
+*   Interrupts
+*******************************************************************************/
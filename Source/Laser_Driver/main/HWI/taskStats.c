@@ -0,0 +1,507 @@
+#include <string.h>
+
+#include "freertos/FreeRTOS.h"
+#include "freertos/task.h"
+#include "freertos/semphr.h"
+
+#include "esp_attr.h"
+#include "esp_cpu.h"
+#include "esp_timer.h"
+#include "esp_freertos_hooks.h"
+#include "esp_rom_sys.h"
+#include "esp_log.h"
+
+#include "taskPriority.h"
+#include "memoryMap.h"
+#include "taskStats.h"
+
+/******************************************************************************
+*   Private Definitions
+*******************************************************************************/
+#define TSTAT_FULL_SCALE                    (1000)//Per mille
+
+#define LOG_LOCAL_LEVEL                     (ESP_LOG_INFO)
+
+/******************************************************************************
+*   Private Macros
+*******************************************************************************/
+
+
+/******************************************************************************
+*   Private Data Types
+*******************************************************************************/
+typedef struct TSTAT_Probe_s{
+    TaskHandle_t task;                  //Set once at registration
+    uint32_t ready_us;                  //0: no ready timestamp (set by the waker, taken by the task)
+    uint32_t nb_wakeups;                //Current window
+    uint32_t max_latency_us;            //Since the last reset
+}TSTAT_Probe_t;
+
+typedef struct TSTAT_Run_Time_s{
+    TaskHandle_t task;
+    uint32_t run_time_us;
+}TSTAT_Run_Time_t;
+
+/******************************************************************************
+*   Private Functions Declaration
+*******************************************************************************/
+static TSTAT_Probe_t *findProbe(TaskHandle_t task);
+static TSTAT_Probe_t *addProbe(TaskHandle_t task);
+static uint32_t getRunTimeDelta(TaskHandle_t task, uint32_t run_time_us);
+static void sampleWindow(void);
+static void tStatsTask(void *pvParameters);
+
+static void IRAM_ATTR tickHook(void);
+
+/******************************************************************************
+*   Public Variables
+*******************************************************************************/
+
+
+/******************************************************************************
+*   Private Variables
+*******************************************************************************/
+static TaskHandle_t stats_task_handle = NULL;
+static StackType_t stats_task_stack[TSTAT_TASK_STACK_SIZE];
+static StaticTask_t stats_task_buffer;
+static SemaphoreHandle_t stats_mutex_handle = NULL;
+static StaticSemaphore_t stats_mutex_buffer;
+static bool is_initialized = false;
+
+//Wakeup probes: registered by their task, ready timestamps set by the wakers
+static TSTAT_Probe_t probes[TSTAT_MAX_PROBES];
+static uint32_t nb_probes = 0;
+static portMUX_TYPE probe_spinlock = portMUX_INITIALIZER_UNLOCKED;
+static volatile uint32_t tick_us[configNUMBER_OF_CORES];//Last tick of each core
+
+//Only accessed from the statistics task
+static TaskStatus_t task_status[TSTAT_MAX_TASKS];
+static TSTAT_Run_Time_t last_run_time[TSTAT_MAX_TASKS];
+static uint32_t nb_last_run_time = 0;
+static uint32_t last_total_us = 0;
+static bool is_first_window = true;
+
+//Last window, under stats_mutex
+static TSTAT_Task_Stats_t window_stats[TSTAT_MAX_TASKS];
+static TSTAT_Summary_t window_summary = {0};
+
+static const char * TAG = "TSTAT";
+
+/******************************************************************************
+*   Error Check
+*******************************************************************************/
+
+
+/******************************************************************************
+*   Private Functions Definitions
+*******************************************************************************/
+/***************************************************************************//*!
+*  \brief Find probe.
+*
+*   This function finds the probe of a task. The probes are only added, a
+*   registered task is never moved.
+*
+*   Preconditions: None.
+*
+*   Side Effects: None.
+*
+*   \param[in]  task                Task.
+*
+*   \return     Probe (NULL if the task has none)
+*
+*******************************************************************************/
+static IRAM_ATTR TSTAT_Probe_t *findProbe(TaskHandle_t task){
+
+    uint32_t nb = __atomic_load_n(&nb_probes, __ATOMIC_ACQUIRE);
+
+    for(uint32_t i=0; i<nb; i++){
+        if(probes[i].task == task)  return &probes[i];
+    }
+
+    return NULL;
+}
+
+/***************************************************************************//*!
+*  \brief Add probe.
+*
+*   This function registers the probe of a task.
+*
+*   Preconditions: Called from the task.
+*
+*   Side Effects: None.
+*
+*   \param[in]  task                Task.
+*
+*   \return     Probe (NULL if TSTAT_MAX_PROBES are registered)
+*
+*******************************************************************************/
+static TSTAT_Probe_t *addProbe(TaskHandle_t task){
+
+    TSTAT_Probe_t *pProbe = NULL;
+
+    portENTER_CRITICAL(&probe_spinlock);
+    if(nb_probes < TSTAT_MAX_PROBES){
+        pProbe = &probes[nb_probes];
+        memset(pProbe, 0, sizeof(TSTAT_Probe_t));
+        pProbe->task = task;
+        __atomic_store_n(&nb_probes, nb_probes + 1, __ATOMIC_RELEASE);
+    }
+    portEXIT_CRITICAL(&probe_spinlock);
+
+    if(pProbe == NULL)  ESP_LOGW(TAG, "No probe left for %s", pcTaskGetName(task));
+
+    return pProbe;
+}
+
+/***************************************************************************//*!
+*  \brief Get run time delta.
+*
+*   This function returns the run time of a task since the previous window.
+*   A task created during the window counts its whole run time.
+*
+*   Preconditions: Called from the statistics task.
+*
+*   Side Effects: None.
+*
+*   \param[in]  task                Task.
+*   \param[in]  run_time_us         Run time counter.
+*
+*   \return     Run time delta in us
+*
+*******************************************************************************/
+static uint32_t getRunTimeDelta(TaskHandle_t task, uint32_t run_time_us){
+
+    for(uint32_t i=0; i<nb_last_run_time; i++){
+        if(last_run_time[i].task == task)   return run_time_us - last_run_time[i].run_time_us;
+    }
+
+    return run_time_us;
+}
+
+/***************************************************************************//*!
+*  \brief Sample window.
+*
+*   This function reads the state of every task, computes the CPU share,
+*   wakeup rate and latency peak over the window and publishes them.
+*
+*   Preconditions: Called from the statistics task.
+*
+*   Side Effects: Suspends the scheduler while the task list is read.
+*
+*******************************************************************************/
+static void sampleWindow(void){
+
+    uint32_t total_us = 0;
+    UBaseType_t nb_tasks = uxTaskGetSystemState(task_status, TSTAT_MAX_TASKS, &total_us);
+
+    if(nb_tasks == 0){
+        xSemaphoreTake(stats_mutex_handle, portMAX_DELAY);
+        window_summary.nb_overflows++;
+        xSemaphoreGive(stats_mutex_handle);
+        return;
+    }
+
+    //Run time counter: esp_timer, us since boot (wraps after 71 minutes)
+    uint32_t elapsed_us = total_us - last_total_us;
+    last_total_us = total_us;
+
+    if(is_first_window || (elapsed_us == 0)){
+        is_first_window = false;
+        for(UBaseType_t i=0; i<nb_tasks; i++){
+            last_run_time[i].task = task_status[i].xHandle;
+            last_run_time[i].run_time_us = task_status[i].ulRunTimeCounter;
+        }
+        nb_last_run_time = nb_tasks;
+        return;
+    }
+
+    xSemaphoreTake(stats_mutex_handle, portMAX_DELAY);
+
+    for(uint32_t core=0; core<configNUMBER_OF_CORES; core++)    window_summary.load_permille[core] = TSTAT_FULL_SCALE;
+
+    for(UBaseType_t i=0; i<nb_tasks; i++){
+
+        TaskStatus_t *pStatus = &task_status[i];
+        TSTAT_Task_Stats_t *pStats = &window_stats[i];
+
+        uint64_t delta_us = getRunTimeDelta(pStatus->xHandle, pStatus->ulRunTimeCounter);
+        uint32_t cpu_permille = (uint32_t)((delta_us * TSTAT_FULL_SCALE) / elapsed_us);
+        if(cpu_permille > TSTAT_FULL_SCALE) cpu_permille = TSTAT_FULL_SCALE;
+
+        strncpy(pStats->name, pStatus->pcTaskName, sizeof(pStats->name) - 1);
+        pStats->name[sizeof(pStats->name) - 1] = '\0';
+        pStats->task_number = pStatus->xTaskNumber;
+        //Core read from the TCB (no xCoreID without the vTaskList option): a
+        //dynamic task deleted since the snapshot may read back garbage
+        pStats->core_id = xTaskGetCoreID(pStatus->xHandle);
+        if((pStats->core_id < 0) || (pStats->core_id >= configNUMBER_OF_CORES)) pStats->core_id = tskNO_AFFINITY;
+        pStats->priority = pStatus->uxCurrentPriority;
+        pStats->cpu_permille = cpu_permille;
+        pStats->stack_free = pStatus->usStackHighWaterMark;//StackType_t is a byte
+        pStats->is_probed = false;
+        pStats->wakeups_per_s = 0;
+        pStats->max_latency_us = 0;
+
+        TSTAT_Probe_t *pProbe = findProbe(pStatus->xHandle);
+        if(pProbe != NULL){
+            portENTER_CRITICAL(&probe_spinlock);
+            uint32_t nb_wakeups = pProbe->nb_wakeups;
+            pProbe->nb_wakeups = 0;
+            pStats->max_latency_us = pProbe->max_latency_us;
+            portEXIT_CRITICAL(&probe_spinlock);
+
+            pStats->is_probed = true;
+            pStats->wakeups_per_s = (uint32_t)(((uint64_t)nb_wakeups * 1000000) / elapsed_us);
+        }
+
+        for(uint32_t core=0; core<configNUMBER_OF_CORES; core++){
+            if(pStatus->xHandle == xTaskGetIdleTaskHandleForCore(core)){
+                window_summary.load_permille[core] = TSTAT_FULL_SCALE - cpu_permille;
+            }
+        }
+
+        last_run_time[i].task = pStatus->xHandle;
+        last_run_time[i].run_time_us = pStatus->ulRunTimeCounter;
+    }
+    nb_last_run_time = nb_tasks;
+
+    //Creation order (the system state follows the scheduler lists)
+    for(UBaseType_t i=1; i<nb_tasks; i++){
+        TSTAT_Task_Stats_t stats = window_stats[i];
+        UBaseType_t j = i;
+        while((j > 0) && (window_stats[j - 1].task_number > stats.task_number)){
+            window_stats[j] = window_stats[j - 1];
+            j--;
+        }
+        window_stats[j] = stats;
+    }
+
+    window_summary.nb_windows++;
+    window_summary.window_ms = elapsed_us / 1000;
+    window_summary.nb_tasks = nb_tasks;
+
+    xSemaphoreGive(stats_mutex_handle);
+}
+
+/***************************************************************************//*!
+*  \brief Statistics task.
+*
+*   This function is the statistics task. It samples a window every
+*   TSTAT_WINDOW_MS and accounts its own CPU time.
+*
+*   Preconditions: None.
+*
+*******************************************************************************/
+static void tStatsTask(void *pvParameters){
+
+    TickType_t last_wake = xTaskGetTickCount();
+
+    ESP_LOGI(TAG, "Starting statistics task");
+
+    for(;;){
+
+        vTaskDelayUntil(&last_wake, pdMS_TO_TICKS(TSTAT_WINDOW_MS));
+
+        uint32_t start_cycles = esp_cpu_get_cycle_count();
+
+        sampleWindow();
+
+        uint32_t sample_us = (esp_cpu_get_cycle_count() - start_cycles) / esp_rom_get_cpu_ticks_per_us();
+
+        xSemaphoreTake(stats_mutex_handle, portMAX_DELAY);
+        window_summary.sample_us = sample_us;
+        xSemaphoreGive(stats_mutex_handle);
+    }
+    vTaskDelete(NULL);
+}
+
+/******************************************************************************
+*   CallBack Functions implementation
+*******************************************************************************/
+/***************************************************************************//*!
+*  \brief Tick hook.
+*
+*   This function is the FreeRTOS tick hook (tick ISR of each core): the
+*   tick time is the ready time of the tasks woken by a timeout.
+*
+*   Preconditions: None.
+*
+*******************************************************************************/
+static void IRAM_ATTR tickHook(void){
+
+    tick_us[xPortGetCoreID()] = (uint32_t)esp_timer_get_time();
+}
+
+/******************************************************************************
+*   Public Functions Definitions
+*******************************************************************************/
+/***************************************************************************//*!
+*  \brief Task statistics initialization.
+*
+*   This function is used to initialize the task statistics: a low priority
+*   task samples the FreeRTOS run time counters and stack high water marks
+*   of every task each TSTAT_WINDOW_MS, and the wakeup probes of the
+*   application tasks.
+*
+*   Preconditions: None.
+*
+*   Side Effects: Registers a tick hook on each core.
+*
+*   \return     Operation status
+*
+*******************************************************************************/
+TSTAT_Ret_t TSTAT_InitStats(void){
+
+    if(is_initialized)  return TSTAT_STATUS_OK;
+
+    //Create mutex
+    stats_mutex_handle = xSemaphoreCreateMutexStatic(&stats_mutex_buffer);
+    if(stats_mutex_handle == NULL){
+        ESP_LOGE(TAG, "Failed to create statistics mutex");
+        return TSTAT_STATUS_ERROR;
+    }
+
+    for(UBaseType_t core=0; core<configNUMBER_OF_CORES; core++){
+        if(ESP_OK != esp_register_freertos_tick_hook_for_cpu(tickHook, core)){
+            ESP_LOGE(TAG, "Failed to register tick hook");
+            return TSTAT_STATUS_ERROR;
+        }
+    }
+
+    is_initialized = true;
+
+    //Create task
+    stats_task_handle = xTaskCreateStaticPinnedToCore(tStatsTask,
+                                                      "Stats task",
+                                                      TSTAT_TASK_STACK_SIZE,
+                                                      NULL,
+                                                      TSTAT_TASK_PRIORITY,
+                                                      stats_task_stack,
+                                                      &stats_task_buffer,
+                                                      TSTAT_TASK_CORE);
+    if(stats_task_handle == NULL){
+
+        ESP_LOGE(TAG, "Failed to create statistics task");
+        return TSTAT_STATUS_ERROR;
+    }
+
+    return TSTAT_STATUS_OK;
+}
+
+/***************************************************************************//*!
+*  \brief Mark task ready.
+*
+*   This function is the wakeup probe of the waker: called just before
+*   notifying a task, it timestamps the task ready. The earliest timestamp
+*   is kept until the task runs.
+*
+*   Preconditions: Task statistics initialized. Task or ISR.
+*
+*   Side Effects: None.
+*
+*   \param[in]  task                Task woken (ignored without probe).
+*
+*******************************************************************************/
+void IRAM_ATTR TSTAT_MarkReady(TaskHandle_t task){
+
+    if(!is_initialized) return;
+
+    TSTAT_Probe_t *pProbe = findProbe(task);
+    if(pProbe == NULL)  return;
+
+    uint32_t expected = 0;
+    uint32_t now_us = (uint32_t)esp_timer_get_time() | 1;//0: no timestamp
+
+    __atomic_compare_exchange_n(&pProbe->ready_us, &expected, now_us, false, __ATOMIC_RELEASE, __ATOMIC_RELAXED);
+}
+
+/***************************************************************************//*!
+*  \brief Mark task running.
+*
+*   This function is the wakeup probe of the task: called when its wait
+*   returns, it counts a wakeup and measures the scheduling latency, from
+*   TSTAT_MarkReady() for an event or from the last tick of the core for a
+*   timeout (vTaskDelay()). A wakeup of an event without TSTAT_MarkReady()
+*   is counted without latency.
+*
+*   Preconditions: Task statistics initialized. Called from the task.
+*
+*   Side Effects: The first call registers the task (TSTAT_MAX_PROBES).
+*
+*   \param[in]  is_timeout          Woken by a timeout.
+*
+*******************************************************************************/
+void TSTAT_MarkRunning(bool is_timeout){
+
+    if(!is_initialized) return;
+
+    TaskHandle_t task = xTaskGetCurrentTaskHandle();
+
+    TSTAT_Probe_t *pProbe = findProbe(task);
+    if(pProbe == NULL){
+        pProbe = addProbe(task);
+        if(pProbe == NULL)  return;
+    }
+
+    //Ready time read before now: the tick hook may run in between
+    uint32_t ready_us = 0;
+    if(is_timeout)  ready_us = tick_us[xPortGetCoreID()];
+    else            ready_us = __atomic_exchange_n(&pProbe->ready_us, 0, __ATOMIC_ACQUIRE);
+
+    uint32_t latency_us = (uint32_t)esp_timer_get_time() - ready_us;
+
+    portENTER_CRITICAL(&probe_spinlock);
+    pProbe->nb_wakeups++;
+    if((ready_us != 0) && (latency_us > pProbe->max_latency_us))    pProbe->max_latency_us = latency_us;
+    portEXIT_CRITICAL(&probe_spinlock);
+}
+
+/***************************************************************************//*!
+*  \brief Get task statistics.
+*
+*   This function is used to get the statistics of every task over the
+*   last window, in creation order.
+*
+*   Preconditions: Task statistics initialized.
+*
+*   Side Effects: None.
+*
+*   \param[out] pStats              Statistics (TSTAT_MAX_TASKS).
+*   \param[out] pSummary            Window summary (NULL if not needed).
+*
+*   \return     Number of tasks
+*
+*******************************************************************************/
+uint32_t TSTAT_GetTasks(TSTAT_Task_Stats_t *pStats, TSTAT_Summary_t *pSummary){
+
+    if(!is_initialized || (pStats == NULL)) return 0;
+
+    xSemaphoreTake(stats_mutex_handle, portMAX_DELAY);
+    uint32_t nb_tasks = window_summary.nb_tasks;
+    memcpy(pStats, window_stats, nb_tasks * sizeof(TSTAT_Task_Stats_t));
+    if(pSummary != NULL)    *pSummary = window_summary;
+    xSemaphoreGive(stats_mutex_handle);
+
+    return nb_tasks;
+}
+
+/***************************************************************************//*!
+*  \brief Reset latency peaks.
+*
+*   This function is used to reset the maximum scheduling latencies.
+*
+*   Preconditions: None.
+*
+*   Side Effects: None.
+*
+*******************************************************************************/
+void TSTAT_ResetPeaks(void){
+
+    portENTER_CRITICAL(&probe_spinlock);
+    for(uint32_t i=0; i<nb_probes; i++) probes[i].max_latency_us = 0;
+    portEXIT_CRITICAL(&probe_spinlock);
+}
+
+/******************************************************************************
+*   Interrupts
+*******************************************************************************/
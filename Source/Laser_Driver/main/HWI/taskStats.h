@@ -0,0 +1,147 @@
+#ifndef __TASK_STATS_H
+#define __TASK_STATS_H
+
+#include <stdint.h>
+#include <stdbool.h>
+
+#include "freertos/FreeRTOS.h"
+#include "freertos/task.h"
+
+/******************************************************************************
+*   Public Definitions
+*******************************************************************************/
+#define TSTAT_WINDOW_MS                     (1000)//CPU and wakeup rate window
+#define TSTAT_MAX_TASKS                     (32)//Every task of the system (IDF tasks included)
+#define TSTAT_MAX_PROBES                    (16)//Tasks with wakeup probes
+
+/******************************************************************************
+*   Public Macros
+*******************************************************************************/
+
+
+/******************************************************************************
+*   Public Data Types
+*******************************************************************************/
+typedef struct TSTAT_Task_Stats_s{
+    char name[configMAX_TASK_NAME_LEN];
+    UBaseType_t task_number;            //Creation order
+    BaseType_t core_id;                 //tskNO_AFFINITY: floating
+    UBaseType_t priority;               //Current priority
+    uint32_t cpu_permille;              //Of one core, last window
+    uint32_t stack_free;                //Stack high water mark in bytes
+    bool is_probed;                     //Wakeup probes in the task loop
+    uint32_t wakeups_per_s;             //Last window
+    uint32_t max_latency_us;            //Ready to running, since the last reset
+}TSTAT_Task_Stats_t;
+
+typedef struct TSTAT_Summary_s{
+    uint32_t nb_windows;                //Windows sampled (0: no statistics yet)
+    uint32_t window_ms;                 //Last window duration
+    uint32_t nb_tasks;
+    uint32_t nb_overflows;              //Windows lost, more than TSTAT_MAX_TASKS tasks
+    uint32_t load_permille[configNUMBER_OF_CORES];//Per core, idle task excluded
+    uint32_t sample_us;                 //Sampling CPU time, last window
+}TSTAT_Summary_t;
+
+typedef enum TSTAT_Ret_e{
+    TSTAT_STATUS_ERROR,
+    TSTAT_STATUS_OK,
+}TSTAT_Ret_t;
+
+/******************************************************************************
+*   Public Variables
+*******************************************************************************/
+
+
+/******************************************************************************
+*   Error Check
+*******************************************************************************/
+#if (configGENERATE_RUN_TIME_STATS != 1) || (configUSE_TRACE_FACILITY != 1)
+#error "Task statistics need CONFIG_FREERTOS_GENERATE_RUN_TIME_STATS"
+#endif
+
+/******************************************************************************
+*   Public Functions Declarations
+*******************************************************************************/
+/***************************************************************************//*!
+*  \brief Task statistics initialization.
+*
+*   This function is used to initialize the task statistics: a low priority
+*   task samples the FreeRTOS run time counters and stack high water marks
+*   of every task each TSTAT_WINDOW_MS, and the wakeup probes of the
+*   application tasks.
+*
+*   Preconditions: None.
+*
+*   Side Effects: Registers a tick hook on each core.
+*
+*   \return     Operation status
+*
+*******************************************************************************/
+TSTAT_Ret_t TSTAT_InitStats(void);
+
+/***************************************************************************//*!
+*  \brief Mark task ready.
+*
+*   This function is the wakeup probe of the waker: called just before
+*   notifying a task, it timestamps the task ready. The earliest timestamp
+*   is kept until the task runs.
+*
+*   Preconditions: Task statistics initialized. Task or ISR.
+*
+*   Side Effects: None.
+*
+*   \param[in]  task                Task woken (ignored without probe).
+*
+*******************************************************************************/
+void TSTAT_MarkReady(TaskHandle_t task);
+
+/***************************************************************************//*!
+*  \brief Mark task running.
+*
+*   This function is the wakeup probe of the task: called when its wait
+*   returns, it counts a wakeup and measures the scheduling latency, from
+*   TSTAT_MarkReady() for an event or from the last tick of the core for a
+*   timeout (vTaskDelay()). A wakeup of an event without TSTAT_MarkReady()
+*   is counted without latency.
+*
+*   Preconditions: Task statistics initialized. Called from the task.
+*
+*   Side Effects: The first call registers the task (TSTAT_MAX_PROBES).
+*
+*   \param[in]  is_timeout          Woken by a timeout.
+*
+*******************************************************************************/
+void TSTAT_MarkRunning(bool is_timeout);
+
+/***************************************************************************//*!
+*  \brief Get task statistics.
+*
+*   This function is used to get the statistics of every task over the
+*   last window, in creation order.
+*
+*   Preconditions: Task statistics initialized.
+*
+*   Side Effects: None.
+*
+*   \param[out] pStats              Statistics (TSTAT_MAX_TASKS).
+*   \param[out] pSummary            Window summary (NULL if not needed).
+*
+*   \return     Number of tasks
+*
+*******************************************************************************/
+uint32_t TSTAT_GetTasks(TSTAT_Task_Stats_t *pStats, TSTAT_Summary_t *pSummary);
+
+/***************************************************************************//*!
+*  \brief Reset latency peaks.
+*
+*   This function is used to reset the maximum scheduling latencies.
+*
+*   Preconditions: None.
+*
+*   Side Effects: None.
+*
+*******************************************************************************/
+void TSTAT_ResetPeaks(void);
+
+#endif//__TASK_STATS_H
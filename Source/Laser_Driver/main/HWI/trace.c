@@ -0,0 +1,248 @@
+#include "freertos/FreeRTOS.h"
+#include "freertos/task.h"
+
+#include "esp_attr.h"
+#include "esp_timer.h"
+
+#if CONFIG_APPTRACE_SV_ENABLE
+#include "SEGGER_SYSVIEW.h"
+#endif
+
+#include "trace.h"
+
+/******************************************************************************
+*   Private Definitions
+*******************************************************************************/
+#define TRACE_INDEX_MASK                    (TRACE_BUFFER_SIZE - 1)
+
+/******************************************************************************
+*   Private Macros
+*******************************************************************************/
+#define TRACE_EVENT_NAME(id, name)          #name,
+
+/******************************************************************************
+*   Private Data Types
+*******************************************************************************/
+
+
+/******************************************************************************
+*   Private Functions Declaration
+*******************************************************************************/
+
+
+/******************************************************************************
+*   Public Variables
+*******************************************************************************/
+
+
+/******************************************************************************
+*   Private Variables
+*******************************************************************************/
+static TRACE_Record_t trace_buffer[TRACE_BUFFER_SIZE];
+static uint32_t trace_head = 0;         //Records claimed since the start
+static uint32_t trace_nb_writers = 0;   //Records being written
+static volatile bool trace_is_running = false;
+static volatile TRACE_Mode_t trace_mode = TRACE_MODE_RING;
+
+static const char * const event_names[TRACE_INVALID] = {
+    TRACE_EVENTS(TRACE_EVENT_NAME)
+};
+
+/******************************************************************************
+*   Error Check
+*******************************************************************************/
+_Static_assert(TRACE_TYPE_INVALID <= (TRACE_TYPE_MASK + 1), "Trace record type does not fit");
+_Static_assert(configNUMBER_OF_CORES <= (0xFF >> TRACE_CORE_SHIFT), "Trace record core does not fit");
+
+/******************************************************************************
+*   Private Functions Definitions
+*******************************************************************************/
+
+
+/******************************************************************************
+*   CallBack Functions implementation
+*******************************************************************************/
+
+
+/******************************************************************************
+*   Public Functions Definitions
+*******************************************************************************/
+/***************************************************************************//*!
+*  \brief Record trace event.
+*
+*   This function records a trace event with its time and core (use the
+*   TRACE_EVENT(), TRACE_BEGIN() and TRACE_END() macros). It is lock free
+*   and returns at once while the trace is stopped.
+*
+*   Preconditions: None. Task or ISR.
+*
+*   Side Effects: None.
+*
+*   \param[in]  event               Event.
+*   \param[in]  type                Point, begin or end.
+*   \param[in]  arg                 Event argument.
+*
+*******************************************************************************/
+void IRAM_ATTR TRACE_Record(TRACE_Event_t event, TRACE_Type_t type, uint16_t arg){
+
+#if CONFIG_APPTRACE_SV_ENABLE
+    //SystemView markers (marker ID: event) when tracing to the host
+    switch(type){
+        case TRACE_TYPE_BEGIN:  SEGGER_SYSVIEW_MarkStart(event);    break;
+        case TRACE_TYPE_END:    SEGGER_SYSVIEW_MarkStop(event);     break;
+        default:                SEGGER_SYSVIEW_Mark(event);         break;
+    }
+#endif
+
+    if(!trace_is_running)   return;
+
+    //TRACE_Stop() waits for the writers before the records are read
+    __atomic_fetch_add(&trace_nb_writers, 1, __ATOMIC_ACQUIRE);
+
+    if(trace_is_running){
+
+        uint32_t index = __atomic_fetch_add(&trace_head, 1, __ATOMIC_RELAXED);
+
+        if((trace_mode == TRACE_MODE_RING) || (index < TRACE_BUFFER_SIZE)){
+
+            TRACE_Record_t *pRecord = &trace_buffer[index & TRACE_INDEX_MASK];
+
+            pRecord->time_us = (uint32_t)esp_timer_get_time();
+            pRecord->event = (uint8_t)event;
+            pRecord->type_core = (uint8_t)type | (uint8_t)(xPortGetCoreID() << TRACE_CORE_SHIFT);
+            pRecord->arg = arg;
+        }
+    }
+
+    __atomic_fetch_sub(&trace_nb_writers, 1, __ATOMIC_RELEASE);
+}
+
+/***************************************************************************//*!
+*  \brief Start trace.
+*
+*   This function is used to clear the trace buffer and start recording.
+*
+*   Preconditions: None.
+*
+*   Side Effects: None.
+*
+*   \param[in]  mode                Ring or once.
+*
+*   \return     Operation status
+*
+*******************************************************************************/
+TRACE_Ret_t TRACE_Start(TRACE_Mode_t mode){
+
+    if(mode >= TRACE_MODE_INVALID)  return TRACE_STATUS_ERROR;
+
+    TRACE_Stop();
+
+    trace_mode = mode;
+    __atomic_store_n(&trace_head, 0, __ATOMIC_RELAXED);
+    trace_is_running = true;
+
+    return TRACE_STATUS_OK;
+}
+
+/***************************************************************************//*!
+*  \brief Stop trace.
+*
+*   This function is used to stop recording. The records are kept until
+*   the next start.
+*
+*   Preconditions: None.
+*
+*   Side Effects: None.
+*
+*******************************************************************************/
+void TRACE_Stop(void){
+
+    trace_is_running = false;
+
+    //A record claimed before the stop is completed first
+    while(__atomic_load_n(&trace_nb_writers, __ATOMIC_ACQUIRE) != 0){
+        vTaskDelay(1);
+    }
+}
+
+/***************************************************************************//*!
+*  \brief Get trace record.
+*
+*   This function is used to read the records of a stopped trace, oldest
+*   first.
+*
+*   Preconditions: Trace stopped.
+*
+*   Side Effects: None.
+*
+*   \param[in]  index               Record index (0: oldest).
+*   \param[out] pRecord             Record.
+*
+*   \return     Operation status (error past the last record or running)
+*
+*******************************************************************************/
+TRACE_Ret_t TRACE_GetRecord(uint32_t index, TRACE_Record_t *pRecord){
+
+    if((pRecord == NULL) || trace_is_running)   return TRACE_STATUS_ERROR;
+
+    uint32_t head = __atomic_load_n(&trace_head, __ATOMIC_ACQUIRE);
+    uint32_t nb_kept = (head < TRACE_BUFFER_SIZE) ? head : TRACE_BUFFER_SIZE;
+
+    if(index >= nb_kept)    return TRACE_STATUS_ERROR;
+
+    //Ring: the oldest records were overwritten. Once: the latest were dropped
+    uint32_t oldest = ((trace_mode == TRACE_MODE_RING) && (head > TRACE_BUFFER_SIZE)) ? (head - TRACE_BUFFER_SIZE) : 0;
+
+    *pRecord = trace_buffer[(oldest + index) & TRACE_INDEX_MASK];
+
+    return TRACE_STATUS_OK;
+}
+
+/***************************************************************************//*!
+*  \brief Get event name.
+*
+*   This function returns the name of an event in the dump.
+*
+*   Preconditions: None.
+*
+*   Side Effects: None.
+*
+*   \param[in]  event               Event.
+*
+*   \return     Name ("?" if invalid)
+*
+*******************************************************************************/
+const char *TRACE_GetEventName(uint8_t event){
+
+    if(event >= TRACE_INVALID)  return "?";
+
+    return event_names[event];
+}
+
+/***************************************************************************//*!
+*  \brief Get trace statistics.
+*
+*   This function is used to get the trace state and counters.
+*
+*   Preconditions: None.
+*
+*   Side Effects: None.
+*
+*   \param[out] pStats              Statistics.
+*
+*******************************************************************************/
+void TRACE_GetStats(TRACE_Stats_t *pStats){
+
+    if(pStats == NULL)  return;
+
+    uint32_t head = __atomic_load_n(&trace_head, __ATOMIC_ACQUIRE);
+
+    pStats->is_running = trace_is_running;
+    pStats->mode = trace_mode;
+    pStats->nb_records = head;
+    pStats->nb_kept = (head < TRACE_BUFFER_SIZE) ? head : TRACE_BUFFER_SIZE;
+}
+
+/******************************************************************************
+*   Interrupts
+*******************************************************************************/
@@ -0,0 +1,494 @@
+#include <string.h>
+
+#include "freertos/FreeRTOS.h"
+
+#include "esp_attr.h"
+#include "esp_cpu.h"
+#include "esp_log.h"
+#include "esp_memory_utils.h"
+#include "esp_private/gdma.h"
+#include "esp_private/periph_ctrl.h"
+#include "hal/dma_types.h"
+#include "hal/uart_ll.h"
+#include "hal/uhci_ll.h"
+
+#include "uartDma.h"
+
+/******************************************************************************
+*   Private Definitions
+*******************************************************************************/
+#define UDMA_UHCI_ID                        (0)//Only one UHCI controller
+#define UDMA_UHCI_MAX_PKT_THRS              (0x1FFF)//pkt_thres.thrs field (13 bits)
+
+/******************************************************************************
+*   Private Macros
+*******************************************************************************/
+
+
+/******************************************************************************
+*   Private Data Types
+*******************************************************************************/
+//Free running head (queued) and tail (completed) counters, the tail slot
+//is the one the DMA works on.
+typedef struct UDMA_Queue_s{
+    gdma_channel_handle_t dma_chan;
+    dma_descriptor_t *pDesc;            //UDMA_QUEUE_DEPTH descriptors (DMA capable)
+    uint8_t *pBuffer[UDMA_QUEUE_DEPTH];
+    size_t size[UDMA_QUEUE_DEPTH];
+    uint32_t head;
+    uint32_t tail;
+    bool is_active;                     //DMA running on the tail slot
+}UDMA_Queue_t;
+
+/******************************************************************************
+*   Private Functions Declaration
+*******************************************************************************/
+static void mountBuffer(dma_descriptor_t *pDesc, uint8_t *pBuffer, size_t size, bool is_tx);
+static void startTx(void);
+static void startRx(void);
+
+static bool txEofCallback(gdma_channel_handle_t dma_chan, gdma_event_data_t *event_data, void *user_data);
+static bool rxEofCallback(gdma_channel_handle_t dma_chan, gdma_event_data_t *event_data, void *user_data);
+
+/******************************************************************************
+*   Public Variables
+*******************************************************************************/
+
+
+/******************************************************************************
+*   Private Variables
+*******************************************************************************/
+static DMA_ATTR dma_descriptor_t udma_tx_desc[UDMA_QUEUE_DEPTH];
+static DMA_ATTR dma_descriptor_t udma_rx_desc[UDMA_QUEUE_DEPTH];
+
+//Queues and statistics (under udma_spinlock)
+static UDMA_Queue_t udma_tx = { .pDesc = udma_tx_desc };
+static UDMA_Queue_t udma_rx = { .pDesc = udma_rx_desc };
+static UDMA_Stats_t udma_stats;
+static portMUX_TYPE udma_spinlock = portMUX_INITIALIZER_UNLOCKED;
+
+static UDMA_TxDoneCallback_t tx_done_callback = NULL;
+static UDMA_RxDoneCallback_t rx_done_callback = NULL;
+static uhci_dev_t *pUhci = NULL;
+static bool is_initialized = false;
+
+static const char * TAG = "UDMA";
+
+/******************************************************************************
+*   Error Check
+*******************************************************************************/
+#if (UDMA_MAX_TRANSFER_SIZE > DMA_DESCRIPTOR_BUFFER_MAX_SIZE_4B_ALIGNED)
+#error "UART DMA transfer size larger than a DMA descriptor buffer"
+#endif
+
+#if (UDMA_MAX_TRANSFER_SIZE > UDMA_UHCI_MAX_PKT_THRS)
+#error "UART DMA transfer size larger than the UHCI packet threshold"
+#endif
+
+/******************************************************************************
+*   Private Functions Definitions
+*******************************************************************************/
+/***************************************************************************//*!
+*  \brief Mount buffer.
+*
+*   This function sets up the descriptor of a buffer and gives it to the
+*   DMA.
+*
+*   Preconditions:  Called with udma_spinlock held.
+*
+*   \param[in]  pDesc               Pointer to the slot descriptor.
+*   \param[in]  pBuffer             Pointer to the buffer.
+*   \param[in]  size                Buffer size (transmit: length).
+*   \param[in]  is_tx               Transmit buffer.
+*
+*******************************************************************************/
+static void IRAM_ATTR mountBuffer(dma_descriptor_t *pDesc, uint8_t *pBuffer, size_t size, bool is_tx){
+
+    pDesc->dw0.size = size;
+    pDesc->dw0.length = is_tx ? size : 0;
+    pDesc->dw0.err_eof = 0;
+    pDesc->dw0.suc_eof = is_tx ? 1 : 0;
+    pDesc->dw0.owner = DMA_DESCRIPTOR_BUFFER_OWNER_DMA;
+    pDesc->buffer = pBuffer;
+    pDesc->next = NULL;
+}
+
+/***************************************************************************//*!
+*  \brief Start transmit.
+*
+*   This function starts the DMA on the transmit tail slot.
+*
+*   Preconditions:  Called with udma_spinlock held, tail slot queued.
+*
+*******************************************************************************/
+static void IRAM_ATTR startTx(void){
+
+    uint32_t slot = udma_tx.tail % UDMA_QUEUE_DEPTH;
+
+    udma_tx.is_active = true;
+    gdma_start(udma_tx.dma_chan, (intptr_t)&udma_tx.pDesc[slot]);
+}
+
+/***************************************************************************//*!
+*  \brief Start receive.
+*
+*   This function starts the DMA on the receive tail slot. The UHCI
+*   packet threshold (length EOF) is set to the buffer size.
+*
+*   Preconditions:  Called with udma_spinlock held, tail slot queued.
+*
+*******************************************************************************/
+static void IRAM_ATTR startRx(void){
+
+    uint32_t slot = udma_rx.tail % UDMA_QUEUE_DEPTH;
+
+    udma_rx.is_active = true;
+    pUhci->pkt_thres.thrs = udma_rx.size[slot];
+    gdma_start(udma_rx.dma_chan, (intptr_t)&udma_rx.pDesc[slot]);
+}
+
+/******************************************************************************
+*   CallBack Functions implementation
+*******************************************************************************/
+/***************************************************************************//*!
+*  \brief Transmit EOF callback.
+*
+*   This function hands the sent buffer back and starts the next queued
+*   one, back to back.
+*
+*   Preconditions:  Called from the GDMA interrupt.
+*
+*   \param[in]  dma_chan            Transmit DMA channel.
+*   \param[in]  event_data          Unused.
+*   \param[in]  user_data           Unused.
+*
+*   \return     Higher priority task woken.
+*
+*******************************************************************************/
+static bool IRAM_ATTR txEofCallback(gdma_channel_handle_t dma_chan, gdma_event_data_t *event_data, void *user_data){
+
+    uint32_t start_cycles = esp_cpu_get_cycle_count();
+    bool is_task_woken = false;
+
+    portENTER_CRITICAL_ISR(&udma_spinlock);
+    uint32_t slot = udma_tx.tail % UDMA_QUEUE_DEPTH;
+    uint8_t *pBuffer = udma_tx.pBuffer[slot];
+    size_t len = udma_tx.size[slot];
+
+    udma_tx.pBuffer[slot] = NULL;
+    udma_tx.tail++;
+    udma_stats.nb_tx_transfers++;
+    udma_stats.nb_tx_bytes += len;
+
+    if(udma_tx.tail != udma_tx.head)    startTx();
+    else                                udma_tx.is_active = false;
+    portEXIT_CRITICAL_ISR(&udma_spinlock);
+
+    if(tx_done_callback != NULL){
+        is_task_woken = tx_done_callback(pBuffer, len);
+    }
+
+    portENTER_CRITICAL_ISR(&udma_spinlock);
+    udma_stats.nb_isr++;
+    udma_stats.isr_cycles += esp_cpu_get_cycle_count() - start_cycles;
+    portEXIT_CRITICAL_ISR(&udma_spinlock);
+
+    return is_task_woken;
+}
+
+/***************************************************************************//*!
+*  \brief Receive EOF callback.
+*
+*   This function hands the received buffer (full or ended on the RX line
+*   idle) back and starts the next queued one right away. The UART FIFO
+*   holds the incoming bytes meanwhile.
+*
+*   Preconditions:  Called from the GDMA interrupt.
+*
+*   \param[in]  dma_chan            Receive DMA channel.
+*   \param[in]  event_data          Unused.
+*   \param[in]  user_data           Unused.
+*
+*   \return     Higher priority task woken.
+*
+*******************************************************************************/
+static bool IRAM_ATTR rxEofCallback(gdma_channel_handle_t dma_chan, gdma_event_data_t *event_data, void *user_data){
+
+    uint32_t start_cycles = esp_cpu_get_cycle_count();
+    bool is_task_woken = false;
+    bool is_stalled = false;
+
+    portENTER_CRITICAL_ISR(&udma_spinlock);
+    uint32_t slot = udma_rx.tail % UDMA_QUEUE_DEPTH;
+    uint8_t *pBuffer = udma_rx.pBuffer[slot];
+    size_t len = udma_rx.pDesc[slot].dw0.length;
+
+    udma_rx.pBuffer[slot] = NULL;
+    udma_rx.tail++;
+    udma_stats.nb_rx_transfers++;
+    udma_stats.nb_rx_bytes += len;
+
+    if(udma_rx.tail != udma_rx.head){
+        startRx();
+    }
+    else{
+        udma_rx.is_active = false;
+        udma_stats.nb_rx_stalls++;
+        is_stalled = true;
+    }
+    portEXIT_CRITICAL_ISR(&udma_spinlock);
+
+    if(rx_done_callback != NULL){
+        is_task_woken = rx_done_callback(pBuffer, len, is_stalled);
+    }
+
+    portENTER_CRITICAL_ISR(&udma_spinlock);
+    udma_stats.nb_isr++;
+    udma_stats.isr_cycles += esp_cpu_get_cycle_count() - start_cycles;
+    portEXIT_CRITICAL_ISR(&udma_spinlock);
+
+    return is_task_woken;
+}
+
+/******************************************************************************
+*   Public Functions Definitions
+*******************************************************************************/
+/***************************************************************************//*!
+*  \brief UART DMA initialization.
+*
+*   This function is used to attach the UHCI controller to a UART port and
+*   to connect it to a GDMA channel pair (transparent mode: no framing, no
+*   escaping). The bytes are moved between the UART FIFOs and the caller
+*   buffers, with one interrupt per buffer instead of one per FIFO
+*   threshold.
+*
+*   Preconditions: UART port configured (baud rate, pins). UART driver not
+*                  installed on the port (both would read the RX FIFO).
+*
+*   Side Effects: UHCI controller and 2 GDMA channels taken.
+*
+*   \param[in]  pConfig             Pointer to the UART DMA config.
+*
+*   \return     Operation status
+*
+*******************************************************************************/
+UDMA_Ret_t UDMA_Init(const UDMA_Config_t *pConfig){
+
+    if(is_initialized || (pConfig == NULL) || (pConfig->port >= SOC_UART_HP_NUM)){
+        return UDMA_STATUS_ERROR;
+    }
+
+    memset(&udma_stats, 0, sizeof(udma_stats));
+    tx_done_callback = pConfig->txDoneCallback;
+    rx_done_callback = pConfig->rxDoneCallback;
+
+    //UHCI in transparent mode, receive EOF on length and RX line idle
+    pUhci = UHCI_LL_GET_HW(UDMA_UHCI_ID);
+    PERIPH_RCC_ATOMIC(){
+        uhci_ll_enable_bus_clock(UDMA_UHCI_ID, true);
+        uhci_ll_reset_register(UDMA_UHCI_ID);
+    }
+    uhci_ll_init(pUhci);
+
+    uhci_seper_chr_t seper_chr = {
+        .sub_chr_en = false,
+    };
+    uhci_swflow_ctrl_sub_chr_t swflow_chr = {
+        .flow_en = 0,
+    };
+    uhci_ll_set_seper_chr(pUhci, &seper_chr);
+    uhci_ll_set_swflow_ctrl_sub_chr(pUhci, &swflow_chr);
+    uhci_ll_set_eof_mode(pUhci, UHCI_RX_LEN_EOF | UHCI_RX_IDLE_EOF);
+    uhci_ll_attach_uart_port(pUhci, pConfig->port);
+    uart_ll_set_rx_idle_thr(UART_LL_GET_HW(pConfig->port),
+                            (pConfig->rx_idle_thr != 0) ? pConfig->rx_idle_thr : UDMA_DEFAULT_RX_IDLE_THR);
+
+    //GDMA channel pair on the UHCI trigger
+    gdma_channel_alloc_config_t tx_alloc_config = {
+        .direction = GDMA_CHANNEL_DIRECTION_TX,
+        .flags.reserve_sibling = 1,
+    };
+    if(ESP_OK != gdma_new_ahb_channel(&tx_alloc_config, &udma_tx.dma_chan)){
+        ESP_LOGE(TAG, "No free transmit DMA channel");
+        return UDMA_STATUS_ERROR;
+    }
+
+    gdma_channel_alloc_config_t rx_alloc_config = {
+        .direction = GDMA_CHANNEL_DIRECTION_RX,
+        .sibling_chan = udma_tx.dma_chan,
+    };
+    if(ESP_OK != gdma_new_ahb_channel(&rx_alloc_config, &udma_rx.dma_chan)){
+        ESP_LOGE(TAG, "No free receive DMA channel");
+        return UDMA_STATUS_ERROR;
+    }
+
+    gdma_strategy_config_t strategy_config = {
+        .owner_check = true,
+        .auto_update_desc = true,
+    };
+    gdma_tx_event_callbacks_t tx_callbacks = {
+        .on_trans_eof = txEofCallback,
+    };
+    gdma_rx_event_callbacks_t rx_callbacks = {
+        .on_recv_eof = rxEofCallback,
+    };
+
+    if((ESP_OK != gdma_connect(udma_tx.dma_chan, GDMA_MAKE_TRIGGER(GDMA_TRIG_PERIPH_UHCI, UDMA_UHCI_ID))) ||
+       (ESP_OK != gdma_connect(udma_rx.dma_chan, GDMA_MAKE_TRIGGER(GDMA_TRIG_PERIPH_UHCI, UDMA_UHCI_ID))) ||
+       (ESP_OK != gdma_apply_strategy(udma_tx.dma_chan, &strategy_config)) ||
+       (ESP_OK != gdma_apply_strategy(udma_rx.dma_chan, &strategy_config)) ||
+       (ESP_OK != gdma_register_tx_event_callbacks(udma_tx.dma_chan, &tx_callbacks, NULL)) ||
+       (ESP_OK != gdma_register_rx_event_callbacks(udma_rx.dma_chan, &rx_callbacks, NULL))){
+
+        ESP_LOGE(TAG, "Failed to connect DMA channels");
+        return UDMA_STATUS_ERROR;
+    }
+
+    is_initialized = true;
+
+    return UDMA_STATUS_OK;
+}
+
+/***************************************************************************//*!
+*  \brief Queue a transmit buffer.
+*
+*   This function is used to queue a buffer for transmission, without
+*   copy. The buffer must stay valid and unchanged until its transmit done
+*   callback. Buffers are sent in queue order, back to back.
+*
+*   Preconditions: UART DMA initialized. Can be called from an interrupt.
+*
+*   Side Effects: None.
+*
+*   \param[in]  pBuffer             Pointer to the buffer (internal RAM).
+*   \param[in]  len                 Number of bytes (up to UDMA_MAX_TRANSFER_SIZE).
+*
+*   \return     Operation status (error: queue full)
+*
+*******************************************************************************/
+UDMA_Ret_t IRAM_ATTR UDMA_Transmit(const uint8_t *pBuffer, size_t len){
+
+    UDMA_Ret_t ret = UDMA_STATUS_ERROR;
+
+    if(!is_initialized || (len == 0) || (len > UDMA_MAX_TRANSFER_SIZE) || !esp_ptr_dma_capable(pBuffer)){
+        return UDMA_STATUS_ERROR;
+    }
+
+    portENTER_CRITICAL_SAFE(&udma_spinlock);
+    if((udma_tx.head - udma_tx.tail) < UDMA_QUEUE_DEPTH){
+
+        uint32_t slot = udma_tx.head % UDMA_QUEUE_DEPTH;
+        udma_tx.pBuffer[slot] = (uint8_t *)pBuffer;
+        udma_tx.size[slot] = len;
+        mountBuffer(&udma_tx.pDesc[slot], (uint8_t *)pBuffer, len, true);
+        udma_tx.head++;
+
+        if(!udma_tx.is_active)  startTx();
+        ret = UDMA_STATUS_OK;
+    }
+    portEXIT_CRITICAL_SAFE(&udma_spinlock);
+
+    return ret;
+}
+
+/***************************************************************************//*!
+*  \brief Queue a receive buffer.
+*
+*   This function is used to queue a buffer for reception, without copy.
+*   The buffer is handed back by the receive done callback. Queue 2
+*   buffers or more to receive without gap.
+*
+*   Preconditions: UART DMA initialized. Can be called from an interrupt.
+*
+*   Side Effects: None.
+*
+*   \param[in]  pBuffer             Pointer to the buffer (internal RAM).
+*   \param[in]  size                Buffer size (up to UDMA_MAX_TRANSFER_SIZE).
+*
+*   \return     Operation status (error: queue full)
+*
+*******************************************************************************/
+UDMA_Ret_t IRAM_ATTR UDMA_Receive(uint8_t *pBuffer, size_t size){
+
+    UDMA_Ret_t ret = UDMA_STATUS_ERROR;
+
+    if(!is_initialized || (size == 0) || (size > UDMA_MAX_TRANSFER_SIZE) || !esp_ptr_dma_capable(pBuffer)){
+        return UDMA_STATUS_ERROR;
+    }
+
+    portENTER_CRITICAL_SAFE(&udma_spinlock);
+    if((udma_rx.head - udma_rx.tail) < UDMA_QUEUE_DEPTH){
+
+        uint32_t slot = udma_rx.head % UDMA_QUEUE_DEPTH;
+        udma_rx.pBuffer[slot] = pBuffer;
+        udma_rx.size[slot] = size;
+        mountBuffer(&udma_rx.pDesc[slot], pBuffer, size, false);
+        udma_rx.head++;
+
+        if(!udma_rx.is_active)  startRx();
+        ret = UDMA_STATUS_OK;
+    }
+    portEXIT_CRITICAL_SAFE(&udma_spinlock);
+
+    return ret;
+}
+
+/***************************************************************************//*!
+*  \brief Get UART DMA statistics.
+*
+*   This function is used to get the UART DMA statistics (interrupts,
+*   transfers and buffers pending).
+*
+*   Preconditions: UART DMA initialized.
+*
+*   Side Effects: None.
+*
+*   \param[out] pStats              Pointer to store the statistics.
+*
+*   \return     Operation status
+*
+*******************************************************************************/
+UDMA_Ret_t UDMA_GetStats(UDMA_Stats_t *pStats){
+
+    if(!is_initialized || (pStats == NULL)){
+        return UDMA_STATUS_ERROR;
+    }
+
+    portENTER_CRITICAL(&udma_spinlock);
+    *pStats = udma_stats;
+    pStats->tx_pending = udma_tx.head - udma_tx.tail;
+    pStats->rx_pending = udma_rx.head - udma_rx.tail;
+    portEXIT_CRITICAL(&udma_spinlock);
+
+    return UDMA_STATUS_OK;
+}
+
+/***************************************************************************//*!
+*  \brief Reset UART DMA statistics.
+*
+*   This function is used to reset the UART DMA counters (not the buffers
+*   pending).
+*
+*   Preconditions: UART DMA initialized.
+*
+*   Side Effects: None.
+*
+*   \return     Operation status
+*
+*******************************************************************************/
+UDMA_Ret_t UDMA_ResetStats(void){
+
+    if(!is_initialized){
+        return UDMA_STATUS_ERROR;
+    }
+
+    portENTER_CRITICAL(&udma_spinlock);
+    memset(&udma_stats, 0, sizeof(udma_stats));
+    portEXIT_CRITICAL(&udma_spinlock);
+
+    return UDMA_STATUS_OK;
+}
+
+/******************************************************************************
+*   Interrupts
+*******************************************************************************/
@@ -0,0 +1,163 @@
+#ifndef __UART_DMA_H
+#define __UART_DMA_H
+
+#include <stdint.h>
+#include <stdbool.h>
+#include <stddef.h>
+
+#include "hal/uart_types.h"
+
+/******************************************************************************
+*   Public Definitions
+*******************************************************************************/
+#define UDMA_QUEUE_DEPTH                    (8)//Transmit (and receive) buffers queued
+#define UDMA_MAX_TRANSFER_SIZE              (4092)//One DMA descriptor per buffer
+#define UDMA_DEFAULT_RX_IDLE_THR            (256)//Bit times
+
+/******************************************************************************
+*   Public Macros
+*******************************************************************************/
+
+
+/******************************************************************************
+*   Public Data Types
+*******************************************************************************/
+//Called from the DMA interrupt when a transmit buffer is sent, return
+//true when a higher priority task was woken.
+typedef bool (*UDMA_TxDoneCallback_t)(const uint8_t *pBuffer, size_t len);
+
+//Called from the DMA interrupt when a receive buffer is full or ended on
+//the RX line idle. The buffer is owned by the caller again (no copy),
+//is_stalled is set when no other buffer is queued. Return true when a
+//higher priority task was woken.
+typedef bool (*UDMA_RxDoneCallback_t)(uint8_t *pBuffer, size_t len, bool is_stalled);
+
+typedef struct UDMA_Config_s{
+    uart_port_t port;                   //UART port (configured, UART driver not installed)
+    uint32_t rx_idle_thr;               //Idle bit times ending a receive buffer (0 -> default)
+    UDMA_TxDoneCallback_t txDoneCallback;
+    UDMA_RxDoneCallback_t rxDoneCallback;
+}UDMA_Config_t;
+
+typedef struct UDMA_Stats_s{
+    uint32_t nb_isr;                    //Transfer done interrupts
+    uint64_t isr_cycles;                //Interrupt CPU cycles (callbacks included)
+    uint32_t nb_tx_transfers;           //Transmit buffers sent
+    uint64_t nb_tx_bytes;
+    uint32_t nb_rx_transfers;           //Receive buffers handed back
+    uint64_t nb_rx_bytes;
+    uint32_t nb_rx_stalls;              //Receive ended without buffer queued
+    uint32_t tx_pending;                //Transmit buffers queued, not sent yet
+    uint32_t rx_pending;                //Receive buffers queued, not filled yet
+}UDMA_Stats_t;
+
+typedef enum UDMA_Ret_e{
+    UDMA_STATUS_ERROR,
+    UDMA_STATUS_OK,
+}UDMA_Ret_t;
+
+/******************************************************************************
+*   Public Variables
+*******************************************************************************/
+
+
+/******************************************************************************
+*   Error Check
+*******************************************************************************/
+
+
+/******************************************************************************
+*   Public Functions Declarations
+*******************************************************************************/
+/***************************************************************************//*!
+*  \brief UART DMA initialization.
+*
+*   This function is used to attach the UHCI controller to a UART port and
+*   to connect it to a GDMA channel pair (transparent mode: no framing, no
+*   escaping). The bytes are moved between the UART FIFOs and the caller
+*   buffers, with one interrupt per buffer instead of one per FIFO
+*   threshold.
+*
+*   Preconditions: UART port configured (baud rate, pins). UART driver not
+*                  installed on the port (both would read the RX FIFO).
+*
+*   Side Effects: UHCI controller and 2 GDMA channels taken.
+*
+*   \param[in]  pConfig             Pointer to the UART DMA config.
+*
+*   \return     Operation status
+*
+*******************************************************************************/
+UDMA_Ret_t UDMA_Init(const UDMA_Config_t *pConfig);
+
+/***************************************************************************//*!
+*  \brief Queue a transmit buffer.
+*
+*   This function is used to queue a buffer for transmission, without
+*   copy. The buffer must stay valid and unchanged until its transmit done
+*   callback. Buffers are sent in queue order, back to back.
+*
+*   Preconditions: UART DMA initialized. Can be called from an interrupt.
+*
+*   Side Effects: None.
+*
+*   \param[in]  pBuffer             Pointer to the buffer (internal RAM).
+*   \param[in]  len                 Number of bytes (up to UDMA_MAX_TRANSFER_SIZE).
+*
+*   \return     Operation status (error: queue full)
+*
+*******************************************************************************/
+UDMA_Ret_t UDMA_Transmit(const uint8_t *pBuffer, size_t len);
+
+/***************************************************************************//*!
+*  \brief Queue a receive buffer.
+*
+*   This function is used to queue a buffer for reception, without copy.
+*   The buffer is handed back by the receive done callback. Queue 2
+*   buffers or more to receive without gap.
+*
+*   Preconditions: UART DMA initialized. Can be called from an interrupt.
+*
+*   Side Effects: None.
+*
+*   \param[in]  pBuffer             Pointer to the buffer (internal RAM).
+*   \param[in]  size                Buffer size (up to UDMA_MAX_TRANSFER_SIZE).
+*
+*   \return     Operation status (error: queue full)
+*
+*******************************************************************************/
+UDMA_Ret_t UDMA_Receive(uint8_t *pBuffer, size_t size);
+
+/***************************************************************************//*!
+*  \brief Get UART DMA statistics.
+*
+*   This function is used to get the UART DMA statistics (interrupts,
+*   transfers and buffers pending).
+*
+*   Preconditions: UART DMA initialized.
+*
+*   Side Effects: None.
+*
+*   \param[out] pStats              Pointer to store the statistics.
+*
+*   \return     Operation status
+*
+*******************************************************************************/
+UDMA_Ret_t UDMA_GetStats(UDMA_Stats_t *pStats);
+
+/***************************************************************************//*!
+*  \brief Reset UART DMA statistics.
+*
+*   This function is used to reset the UART DMA counters (not the buffers
+*   pending).
+*
+*   Preconditions: UART DMA initialized.
+*
+*   Side Effects: None.
+*
+*   \return     Operation status
+*
+*******************************************************************************/
+UDMA_Ret_t UDMA_ResetStats(void);
+
+#endif//__UART_DMA_H
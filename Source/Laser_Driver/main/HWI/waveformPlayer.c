@@ -0,0 +1,752 @@
+#include <string.h>
+#include <math.h>
+
+#include "freertos/FreeRTOS.h"
+#include "freertos/semphr.h"
+#include "freertos/task.h"
+
+#include "driver/gptimer.h"
+#include "esp_attr.h"
+#include "esp_log.h"
+
+#include "taskPriority.h"
+#include "memoryMap.h"
+#include "taskStats.h"
+#include "coreAffinity.h"
+#include "phaseDriver.h"
+#include "waveformPlayer.h"
+
+/******************************************************************************
+*   Private Definitions
+*******************************************************************************/
+#define WAVE_TIMER_RESOLUTION_HZ            (1000000)//1MHz -> 1us per tick
+#define WAVE_NB_BUFFER                      (2)
+
+#define WAVE_PI                             (3.14159265f)
+
+#define LOG_LOCAL_LEVEL                     (ESP_LOG_INFO)
+
+/******************************************************************************
+*   Private Macros
+*******************************************************************************/
+
+
+/******************************************************************************
+*   Private Data Types
+*******************************************************************************/
+typedef enum WAVE_Buffer_State_e{
+    WAVE_BUFFER_FREE,                   //Owned by the writer (task/stream)
+    WAVE_BUFFER_READY,                  //Owned by the playback interrupt
+}WAVE_Buffer_State_t;
+
+typedef struct WAVE_Buffer_s{
+    uint16_t samples[WAVE_BUFFER_SIZE];
+    volatile uint32_t count;
+    volatile WAVE_Buffer_State_t state;
+}WAVE_Buffer_t;
+
+typedef struct WAVE_Shape_Ctx_s{
+    WAVE_Shape_Config_t config;
+    uint32_t period_samples;            //Samples per waveform period
+    uint32_t index;                     //Sample index in the period
+    uint32_t nb_periods_done;
+}WAVE_Shape_Ctx_t;
+
+/******************************************************************************
+*   Private Functions Declaration
+*******************************************************************************/
+static void queueBuffer(uint8_t buffer_id, uint32_t count);
+static void refillBuffers(void);
+static void stopPlayback(void);
+static esp_err_t newPlaybackTimer(void *pArg);
+static uint32_t shapeRefillCallback(uint16_t *pBuffer, uint32_t size, void *pCtx);
+static bool playbackTimerCallback(gptimer_handle_t timer,
+                                  const gptimer_alarm_event_data_t *edata,
+                                  void *user_ctx);
+static void tWavePlayerTask(void *pvParameters);
+
+/******************************************************************************
+*   Public Variables
+*******************************************************************************/
+
+
+/******************************************************************************
+*   Private Variables
+*******************************************************************************/
+static SemaphoreHandle_t wave_mutex_handle = NULL;
+static StaticSemaphore_t wave_mutex_buffer;
+static portMUX_TYPE wave_spinlock = portMUX_INITIALIZER_UNLOCKED;
+static TaskHandle_t wave_task_handle = NULL;
+static StackType_t wave_task_stack[WAVE_TASK_STACK_SIZE];
+static StaticTask_t wave_task_buffer;
+static gptimer_handle_t wave_timer_handle = NULL;
+
+static WAVE_Buffer_t wave_buffers[WAVE_NB_BUFFER];
+
+//Playback state (owned by the playback interrupt)
+static volatile uint8_t play_buffer = 0;
+static volatile uint32_t play_index = 0;
+static volatile bool is_primed = false;
+static volatile bool is_starving = false;
+
+//Refill state (owned by the writer, under wave_mutex)
+static uint8_t fill_buffer = 0;
+static uint32_t fill_index = 0;
+static volatile bool is_end_of_wave = false;
+static WAVE_RefillCallback_t refill_callback = NULL;
+static void *refill_ctx = NULL;
+
+static volatile uint8_t wave_outputs = 0;
+static bool is_running = false;
+static WAVE_Shape_Ctx_t shape_ctx;
+
+//Statistics (under wave_spinlock)
+static WAVE_Stats_t wave_stats;
+
+static const char * TAG = "WAVE";
+
+/******************************************************************************
+*   Error Check
+*******************************************************************************/
+#if (WAVE_MAX_RATE_HZ > (WAVE_TIMER_RESOLUTION_HZ / 50))
+#error "Waveform player max rate too high for the timer resolution"
+#endif
+
+/******************************************************************************
+*   Private Functions Definitions
+*******************************************************************************/
+/***************************************************************************//*!
+*  \brief Queue buffer.
+*
+*   This function hand a filled buffer over to the playback interrupt.
+*
+*******************************************************************************/
+static void queueBuffer(uint8_t buffer_id, uint32_t count){
+
+    portENTER_CRITICAL(&wave_spinlock);
+    wave_buffers[buffer_id].count = count;
+    wave_buffers[buffer_id].state = WAVE_BUFFER_READY;
+    wave_stats.nb_refills++;
+    portEXIT_CRITICAL(&wave_spinlock);
+}
+
+/***************************************************************************//*!
+*  \brief Refill buffers.
+*
+*   This function fill every free buffer (in playback order) with the
+*   refill callback. Must be called with wave_mutex taken.
+*
+*******************************************************************************/
+static void refillBuffers(void){
+
+    if(refill_callback == NULL) return;
+
+    while((!is_end_of_wave) && (wave_buffers[fill_buffer].state == WAVE_BUFFER_FREE)){
+
+        uint32_t count = refill_callback(wave_buffers[fill_buffer].samples, WAVE_BUFFER_SIZE, refill_ctx);
+        if(count == 0){
+            is_end_of_wave = true;
+            break;
+        }
+
+        if(count > WAVE_BUFFER_SIZE)    count = WAVE_BUFFER_SIZE;
+        queueBuffer(fill_buffer, count);
+        fill_buffer = (fill_buffer + 1) % WAVE_NB_BUFFER;
+    }
+}
+
+/***************************************************************************//*!
+*  \brief Stop playback.
+*
+*   This function stop the playback timer, turn the phase outputs off and
+*   release the phases. Must be called with wave_mutex taken.
+*
+*******************************************************************************/
+static void stopPlayback(void){
+
+    //Phases may be used by someone else when not playing
+    if(!is_running) return;
+
+    if((ESP_OK != gptimer_stop(wave_timer_handle)) ||
+       (ESP_OK != gptimer_disable(wave_timer_handle))){
+        ESP_LOGE(TAG, "Failed to stop playback timer");
+    }
+
+    PHASE_Release(PHASE_OWNER_WAVEFORM);
+    is_running = false;
+
+    portENTER_CRITICAL(&wave_spinlock);
+    wave_stats.is_running = false;
+    portEXIT_CRITICAL(&wave_spinlock);
+}
+
+/***************************************************************************//*!
+*  \brief New playback timer.
+*
+*   This function creates the playback timer, its interrupt is allocated
+*   on the calling core (callbacks registration).
+*
+*   Preconditions:  None.
+*
+*   \param[in]  pArg                Unused.
+*
+*   \return     ESP status.
+*
+*******************************************************************************/
+static esp_err_t newPlaybackTimer(void *pArg){
+
+    gptimer_config_t timer_config = {
+        .clk_src = GPTIMER_CLK_SRC_DEFAULT,
+        .direction = GPTIMER_COUNT_UP,
+        .resolution_hz = WAVE_TIMER_RESOLUTION_HZ,
+    };
+    esp_err_t ret = gptimer_new_timer(&timer_config, &wave_timer_handle);
+    if(ret != ESP_OK)   return ret;
+
+    gptimer_event_callbacks_t timer_cbs = {
+        .on_alarm = playbackTimerCallback,
+    };
+    return gptimer_register_event_callbacks(wave_timer_handle, &timer_cbs, NULL);
+}
+
+/***************************************************************************//*!
+*  \brief Waveform player task.
+*
+*   This function is the waveform player task. The task is notified by the
+*   playback interrupt once per consumed buffer (refill), at the end of
+*   the waveform and on a phases trip (stop).
+*
+*   Preconditions:  None.
+*
+*******************************************************************************/
+static void tWavePlayerTask(void *pvParameters){
+
+    for(;;){
+
+        ulTaskNotifyTake(pdTRUE, portMAX_DELAY);
+        TSTAT_MarkRunning(false);
+
+        xSemaphoreTake(wave_mutex_handle, portMAX_DELAY);
+
+        if(is_running){
+            bool is_finished;
+            bool is_tripped;
+
+            portENTER_CRITICAL(&wave_spinlock);
+            is_finished = wave_stats.is_finished;
+            is_tripped = wave_stats.is_tripped;
+            portEXIT_CRITICAL(&wave_spinlock);
+
+            if(is_tripped){
+                stopPlayback();
+                ESP_LOGW(TAG, "Playback stopped: phases tripped");
+            }
+            else if(is_finished){
+                stopPlayback();
+                ESP_LOGI(TAG, "End of waveform");
+            }
+            else{
+                refillBuffers();
+            }
+        }
+
+        xSemaphoreGive(wave_mutex_handle);
+    }
+    vTaskDelete(NULL);
+}
+
+/******************************************************************************
+*   CallBack Functions implementation
+*******************************************************************************/
+/***************************************************************************//*!
+*  \brief Shape refill callback.
+*
+*   This function generate the next samples of the configured shape.
+*
+*******************************************************************************/
+static uint32_t shapeRefillCallback(uint16_t *pBuffer, uint32_t size, void *pCtx){
+
+    WAVE_Shape_Ctx_t *pShape = (WAVE_Shape_Ctx_t *)pCtx;
+    const WAVE_Shape_Config_t *pConfig = &pShape->config;
+    int64_t span = (int64_t)pConfig->max_duty - pConfig->min_duty;
+    uint32_t count = 0;
+
+    while(count < size){
+
+        if((pConfig->nb_periods != 0) && (pShape->nb_periods_done >= pConfig->nb_periods)){
+            break;
+        }
+
+        //64-bit math: span x index overflows 32-bit on long periods
+        int64_t offset = 0;
+        switch(pConfig->shape){
+
+            case WAVE_SHAPE_RAMP:
+            {
+                offset = (span * pShape->index) / (pShape->period_samples - 1);
+            }
+            break;
+
+            case WAVE_SHAPE_TRIANGLE:
+            {
+                uint32_t half = pShape->period_samples / 2;
+                uint32_t pos = (pShape->index < half) ? pShape->index : (pShape->period_samples - pShape->index);
+                offset = (span * pos) / half;
+            }
+            break;
+
+            case WAVE_SHAPE_SINE:
+            default:
+            {
+                //Starts at min_duty (no step at the start of the playback)
+                float angle = (2.0f * WAVE_PI * pShape->index) / pShape->period_samples;
+                offset = (int64_t)((span * (1.0f - cosf(angle)) / 2.0f) + 0.5f);
+            }
+            break;
+        }
+
+        pBuffer[count++] = (uint16_t)(pConfig->min_duty + offset);
+
+        pShape->index++;
+        if(pShape->index >= pShape->period_samples){
+            pShape->index = 0;
+            pShape->nb_periods_done++;
+        }
+    }
+
+    return count;
+}
+
+/***************************************************************************//*!
+*  \brief Playback timer callback.
+*
+*   This function is called by the playback timer interrupt. Apply the next
+*   sample of the playing buffer. Hand the buffer back to the task once
+*   consumed and switch to the other buffer. On a phases trip (outputs
+*   already held off) no more sample is applied and the task stops the
+*   playback.
+*
+*******************************************************************************/
+static bool IRAM_ATTR playbackTimerCallback(gptimer_handle_t timer,
+                                            const gptimer_alarm_event_data_t *edata,
+                                            void *user_ctx){
+
+    BaseType_t task_woken = pdFALSE;
+    bool is_notify = false;
+    bool is_sample = false;
+    uint16_t duty = 0;
+
+    portENTER_CRITICAL_ISR(&wave_spinlock);
+
+    WAVE_Buffer_t *pBuffer = &wave_buffers[play_buffer];
+
+    if(PHASE_IsTripped()){
+        if(!wave_stats.is_tripped){
+            wave_stats.is_tripped = true;
+            is_notify = true;
+        }
+    }
+    else if(pBuffer->state == WAVE_BUFFER_READY){
+        duty = pBuffer->samples[play_index++];
+        is_sample = true;
+        is_primed = true;
+        is_starving = false;
+        wave_stats.nb_samples++;
+
+        if(play_index >= pBuffer->count){
+            pBuffer->state = WAVE_BUFFER_FREE;
+            play_buffer = (play_buffer + 1) % WAVE_NB_BUFFER;
+            play_index = 0;
+            is_notify = true;
+        }
+    }
+    else if(is_end_of_wave){
+        if(!wave_stats.is_finished){
+            wave_stats.is_finished = true;
+            is_sample = true;//Outputs off
+            is_notify = true;
+        }
+    }
+    else if(is_primed){
+        //Buffer not refilled in time: hold the latest duty
+        if(!is_starving)    wave_stats.nb_underruns++;
+        is_starving = true;
+        wave_stats.nb_missed++;
+    }
+
+    portEXIT_CRITICAL_ISR(&wave_spinlock);
+
+    if(is_sample){
+        if(wave_outputs & WAVE_OUTPUT_PHASE_A)  PHASE_SetDuty(PHASE_ID_A, duty);
+        if(wave_outputs & WAVE_OUTPUT_PHASE_B)  PHASE_SetDuty(PHASE_ID_B, duty);
+    }
+
+    if(is_notify){
+        TSTAT_MarkReady(wave_task_handle);
+        vTaskNotifyGiveFromISR(wave_task_handle, &task_woken);
+    }
+
+    return (task_woken == pdTRUE);
+}
+
+/******************************************************************************
+*   Public Functions Definitions
+*******************************************************************************/
+/***************************************************************************//*!
+*  \brief Waveform player initialization.
+*
+*   This function is used to initialize the waveform player (playback timer
+*   and refill task).
+*
+*   Preconditions: Phase driver initialized.
+*
+*   Side Effects: None.
+*
+*   \return     Operation status
+*
+*******************************************************************************/
+WAVE_Ret_t WAVE_InitPlayer(void){
+
+    memset(wave_buffers, 0, sizeof(wave_buffers));
+    memset(&wave_stats, 0, sizeof(wave_stats));
+    is_running = false;
+
+    //Create mutex
+    wave_mutex_handle = xSemaphoreCreateMutexStatic(&wave_mutex_buffer);
+    if(wave_mutex_handle == NULL){
+        ESP_LOGE(TAG, "Failed to create WAVE mutex");
+        return WAVE_STATUS_ERROR;
+    }
+
+    //Init playback timer, interrupt on the control core
+    if(ESP_OK != CORE_RunOnCore(CONTROL_ISR_CORE, newPlaybackTimer, NULL)){
+        ESP_LOGE(TAG, "Failed to create playback timer");
+        return WAVE_STATUS_ERROR;
+    }
+
+    //create player task
+    wave_task_handle = xTaskCreateStaticPinnedToCore(tWavePlayerTask,
+                                                     "Wave task",
+                                                     WAVE_TASK_STACK_SIZE,
+                                                     NULL,
+                                                     WAVE_TASK_PRIORITY,
+                                                     wave_task_stack,
+                                                     &wave_task_buffer,
+                                                     WAVE_TASK_CORE);
+    if(wave_task_handle == NULL){
+
+        ESP_LOGE(TAG, "Failed to create Wave task");
+        return WAVE_STATUS_ERROR;
+    }
+
+    return WAVE_STATUS_OK;
+}
+
+/***************************************************************************//*!
+*  \brief Start waveform playback.
+*
+*   This function is used to start the playback of a duty waveform on the
+*   selected phase outputs. One sample is applied per timer interrupt
+*   (no task wakeup per sample). The samples are played from 2 buffers
+*   of WAVE_BUFFER_SIZE samples: when a buffer is consumed the player 
+*   task refills it with the refill callback. With a NULL callback, the
+*   samples are streamed with WAVE_Write(). The player takes the
+*   exclusive use of the phases until the playback stops, a phases trip
+*   (regulator fault) stops the playback.
+*
+*   Preconditions: Player initialized and stopped. Phases not used by
+*                  someone else and not tripped.
+*
+*   Side Effects: Phases enabled.
+*
+*   \param[in]  rate_hz             Playback rate.
+*   \param[in]  outputs             Phase outputs (WAVE_OUTPUT_xxx).
+*   \param[in]  callback            Refill callback (NULL -> streaming).
+*   \param[in]  pCtx                Refill callback context.
+*
+*   \return     Operation status
+*
+*******************************************************************************/
+WAVE_Ret_t WAVE_Start(uint32_t rate_hz, uint8_t outputs, WAVE_RefillCallback_t callback, void *pCtx){
+
+    if((rate_hz < WAVE_MIN_RATE_HZ) || (rate_hz > WAVE_MAX_RATE_HZ)){
+        ESP_LOGE(TAG, "Invalid playback rate: %lu Hz", rate_hz);
+        return WAVE_STATUS_ERROR;
+    }
+
+    if(((outputs & WAVE_OUTPUT_BOTH) == 0) || ((outputs & ~WAVE_OUTPUT_BOTH) != 0)){
+        ESP_LOGE(TAG, "Invalid outputs: 0x%02x", outputs);
+        return WAVE_STATUS_ERROR;
+    }
+
+    xSemaphoreTake(wave_mutex_handle, portMAX_DELAY);
+
+    if(is_running){
+        xSemaphoreGive(wave_mutex_handle);
+        ESP_LOGE(TAG, "Playback already running");
+        return WAVE_STATUS_ERROR;
+    }
+
+    //Exclusive use of the phases, refused while tripped (fault latched)
+    if(PHASE_STATUS_OK != PHASE_Acquire(PHASE_OWNER_WAVEFORM)){
+        xSemaphoreGive(wave_mutex_handle);
+        ESP_LOGE(TAG, "Phases used by someone else or tripped");
+        return WAVE_STATUS_ERROR;
+    }
+
+    //Timer stopped -> no concurrent access
+    for(uint8_t i=0; i<WAVE_NB_BUFFER; i++){
+        wave_buffers[i].count = 0;
+        wave_buffers[i].state = WAVE_BUFFER_FREE;
+    }
+    play_buffer = 0;
+    play_index = 0;
+    is_primed = false;
+    is_starving = false;
+    fill_buffer = 0;
+    fill_index = 0;
+    is_end_of_wave = false;
+    refill_callback = callback;
+    refill_ctx = pCtx;
+    wave_outputs = outputs;
+
+    memset(&wave_stats, 0, sizeof(wave_stats));
+    wave_stats.rate_hz = rate_hz;
+    wave_stats.is_running = true;
+
+    //Prefill both buffers
+    refillBuffers();
+
+    gptimer_alarm_config_t alarm_config = {
+        .reload_count = 0,
+        .alarm_count = WAVE_TIMER_RESOLUTION_HZ / rate_hz,
+        .flags.auto_reload_on_alarm = true,
+    };
+
+    PHASE_SetDuty(PHASE_ID_A, 0);
+    PHASE_SetDuty(PHASE_ID_B, 0);
+
+    if((PHASE_STATUS_OK != PHASE_SetEnable(true)) ||
+       (ESP_OK != gptimer_set_alarm_action(wave_timer_handle, &alarm_config)) ||
+       (ESP_OK != gptimer_set_raw_count(wave_timer_handle, 0)) ||
+       (ESP_OK != gptimer_enable(wave_timer_handle))){
+        PHASE_Release(PHASE_OWNER_WAVEFORM);
+        wave_stats.is_running = false;
+        xSemaphoreGive(wave_mutex_handle);
+        ESP_LOGE(TAG, "Failed to setup playback timer");
+        return WAVE_STATUS_ERROR;
+    }
+
+    if(ESP_OK != gptimer_start(wave_timer_handle)){
+        gptimer_disable(wave_timer_handle);
+        PHASE_Release(PHASE_OWNER_WAVEFORM);
+        wave_stats.is_running = false;
+        xSemaphoreGive(wave_mutex_handle);
+        ESP_LOGE(TAG, "Failed to start playback timer");
+        return WAVE_STATUS_ERROR;
+    }
+    is_running = true;
+
+    xSemaphoreGive(wave_mutex_handle);
+
+    ESP_LOGI(TAG, "Playback started at %lu Hz", rate_hz);
+
+    return WAVE_STATUS_OK;
+}
+
+/***************************************************************************//*!
+*  \brief Start shape playback.
+*
+*   This function is used to start the playback of a generated waveform
+*   (ramp, triangle or sine) on the selected phase outputs.
+*
+*   Preconditions: Player initialized and stopped. Phases not used by
+*                  someone else and not tripped.
+*
+*   Side Effects: Phases enabled.
+*
+*   \param[in]  rate_hz             Playback rate.
+*   \param[in]  outputs             Phase outputs (WAVE_OUTPUT_xxx).
+*   \param[in]  pConfig             Pointer to the shape config.
+*
+*   \return     Operation status
+*
+*******************************************************************************/
+WAVE_Ret_t WAVE_StartShape(uint32_t rate_hz, uint8_t outputs, const WAVE_Shape_Config_t *pConfig){
+
+    if((pConfig == NULL) || (pConfig->shape >= WAVE_SHAPE_INVALID) ||
+       (pConfig->min_duty > pConfig->max_duty) || (pConfig->max_duty > PHASE_DUTY_FULL_SCALE) ||
+       (pConfig->period_ms > WAVE_MAX_SHAPE_PERIOD_MS) || (rate_hz > WAVE_MAX_RATE_HZ)){
+        ESP_LOGE(TAG, "Invalid shape config");
+        return WAVE_STATUS_ERROR;
+    }
+
+    //Period and rate bounded above: fits in 32-bit
+    uint32_t period_samples = (uint32_t)(((uint64_t)pConfig->period_ms * rate_hz) / 1000);
+    if(period_samples < 2){
+        ESP_LOGE(TAG, "Shape period too short");
+        return WAVE_STATUS_ERROR;
+    }
+
+    xSemaphoreTake(wave_mutex_handle, portMAX_DELAY);
+
+    if(is_running){
+        xSemaphoreGive(wave_mutex_handle);
+        ESP_LOGE(TAG, "Playback already running");
+        return WAVE_STATUS_ERROR;
+    }
+
+    shape_ctx.config = *pConfig;
+    shape_ctx.period_samples = period_samples;
+    shape_ctx.index = 0;
+    shape_ctx.nb_periods_done = 0;
+
+    xSemaphoreGive(wave_mutex_handle);
+
+    return WAVE_Start(rate_hz, outputs, shapeRefillCallback, &shape_ctx);
+}
+
+/***************************************************************************//*!
+*  \brief Stop waveform playback.
+*
+*   This function is used to stop the playback. The phase outputs duty are
+*   set to 0 and the phases are disabled.
+*
+*   Preconditions: Player initialized.
+*
+*   Side Effects: Phases disabled.
+*
+*   \return     Operation status
+*
+*******************************************************************************/
+WAVE_Ret_t WAVE_Stop(void){
+
+    xSemaphoreTake(wave_mutex_handle, portMAX_DELAY);
+    stopPlayback();
+    xSemaphoreGive(wave_mutex_handle);
+
+    return WAVE_STATUS_OK;
+}
+
+/***************************************************************************//*!
+*  \brief Write streamed samples.
+*
+*   This function is used to append samples to the buffer being filled
+*   (streaming playback). A buffer is queued for playback when full (or
+*   with WAVE_Flush()). Only the samples fitting in the free buffers are
+*   written.
+*
+*   Preconditions: Playback started in streaming mode.
+*
+*   Side Effects: None.
+*
+*   \param[in]  pSamples            Duty samples (0.01%).
+*   \param[in]  nb_samples          Number of samples.
+*   \param[out] pNb_written         Pointer to store the number of samples written.
+*
+*   \return     Operation status
+*
+*******************************************************************************/
+WAVE_Ret_t WAVE_Write(const uint16_t *pSamples, uint32_t nb_samples, uint32_t *pNb_written){
+
+    uint32_t nb_written = 0;
+
+    if((pSamples == NULL) || (pNb_written == NULL)) return WAVE_STATUS_ERROR;
+
+    xSemaphoreTake(wave_mutex_handle, portMAX_DELAY);
+
+    if((!is_running) || (refill_callback != NULL)){
+        xSemaphoreGive(wave_mutex_handle);
+        ESP_LOGE(TAG, "Streaming playback not running");
+        return WAVE_STATUS_ERROR;
+    }
+
+    while((nb_written < nb_samples) && (wave_buffers[fill_buffer].state == WAVE_BUFFER_FREE)){
+
+        uint32_t count = nb_samples - nb_written;
+        if(count > (WAVE_BUFFER_SIZE - fill_index)) count = WAVE_BUFFER_SIZE - fill_index;
+
+        for(uint32_t i=0; i<count; i++){
+            uint16_t duty = pSamples[nb_written + i];
+            wave_buffers[fill_buffer].samples[fill_index + i] = (duty > PHASE_DUTY_FULL_SCALE) ? PHASE_DUTY_FULL_SCALE : duty;
+        }
+        fill_index += count;
+        nb_written += count;
+
+        if(fill_index >= WAVE_BUFFER_SIZE){
+            queueBuffer(fill_buffer, WAVE_BUFFER_SIZE);
+            fill_buffer = (fill_buffer + 1) % WAVE_NB_BUFFER;
+            fill_index = 0;
+        }
+    }
+
+    xSemaphoreGive(wave_mutex_handle);
+
+    *pNb_written = nb_written;
+
+    return WAVE_STATUS_OK;
+}
+
+/***************************************************************************//*!
+*  \brief Flush streamed samples.
+*
+*   This function is used to queue the buffer being filled for playback
+*   even if it is not full.
+*
+*   Preconditions: Playback started in streaming mode.
+*
+*   Side Effects: None.
+*
+*   \return     Operation status
+*
+*******************************************************************************/
+WAVE_Ret_t WAVE_Flush(void){
+
+    xSemaphoreTake(wave_mutex_handle, portMAX_DELAY);
+
+    if((!is_running) || (refill_callback != NULL)){
+        xSemaphoreGive(wave_mutex_handle);
+        ESP_LOGE(TAG, "Streaming playback not running");
+        return WAVE_STATUS_ERROR;
+    }
+
+    if((fill_index > 0) && (wave_buffers[fill_buffer].state == WAVE_BUFFER_FREE)){
+        queueBuffer(fill_buffer, fill_index);
+        fill_buffer = (fill_buffer + 1) % WAVE_NB_BUFFER;
+        fill_index = 0;
+    }
+
+    xSemaphoreGive(wave_mutex_handle);
+
+    return WAVE_STATUS_OK;
+}
+
+/***************************************************************************//*!
+*  \brief Get playback statistics.
+*
+*   This function is used to get the playback statistics (samples played,
+*   refills and underruns).
+*
+*   Preconditions: Player initialized.
+*
+*   Side Effects: None.
+*
+*   \param[out] pStats              Pointer to store the statistics.
+*
+*   \return     Operation status
+*
+*******************************************************************************/
+WAVE_Ret_t WAVE_GetStats(WAVE_Stats_t *pStats){
+
+    if(pStats == NULL)  return WAVE_STATUS_ERROR;
+
+    portENTER_CRITICAL(&wave_spinlock);
+    *pStats = wave_stats;
+    portEXIT_CRITICAL(&wave_spinlock);
+
+    return WAVE_STATUS_OK;
+}
+
+/******************************************************************************
+*   Interrupts
+*******************************************************************************/
@@ -0,0 +1,207 @@
+#ifndef __WAVEFORM_PLAYER_H
+#define __WAVEFORM_PLAYER_H
+
+#include <stdint.h>
+#include <stdbool.h>
+
+/******************************************************************************
+*   Public Definitions
+*******************************************************************************/
+#define WAVE_BUFFER_SIZE                    (256)//Samples per buffer (x2)
+
+#define WAVE_MIN_RATE_HZ                    (10)
+#define WAVE_MAX_RATE_HZ                    (10000)
+#define WAVE_DEFAULT_RATE_HZ                (10000)
+
+#define WAVE_MAX_SHAPE_PERIOD_MS            (60000)//Shape period limit (1 min)
+
+#define WAVE_OUTPUT_PHASE_A                 (0x01)
+#define WAVE_OUTPUT_PHASE_B                 (0x02)
+#define WAVE_OUTPUT_BOTH                    (WAVE_OUTPUT_PHASE_A | WAVE_OUTPUT_PHASE_B)
+
+/******************************************************************************
+*   Public Macros
+*******************************************************************************/
+//Fill pBuffer with up to size duty samples, return the number of samples 
+//written (0 -> end of waveform). Called from the player task.
+typedef uint32_t(*WAVE_RefillCallback_t)(uint16_t *pBuffer, uint32_t size, void *pCtx);
+
+/******************************************************************************
+*   Public Data Types
+*******************************************************************************/
+typedef enum WAVE_Shape_e{
+    WAVE_SHAPE_RAMP,
+    WAVE_SHAPE_TRIANGLE,
+    WAVE_SHAPE_SINE,
+
+    WAVE_SHAPE_INVALID,
+}WAVE_Shape_t;
+
+typedef struct WAVE_Shape_Config_s{
+    WAVE_Shape_t shape;
+    uint32_t period_ms;                 //Waveform period (up to WAVE_MAX_SHAPE_PERIOD_MS)
+    uint16_t min_duty;                  //Min duty (0.01%)
+    uint16_t max_duty;                  //Max duty (0.01%)
+    uint32_t nb_periods;                //Number of periods (0 -> infinite)
+}WAVE_Shape_Config_t;
+
+typedef struct WAVE_Stats_s{
+    bool is_running;                    //Playback running
+    bool is_finished;                   //End of waveform reached
+    bool is_tripped;                    //Stopped by a phases trip (fault)
+    uint32_t rate_hz;                   //Playback rate
+    uint32_t nb_samples;                //Samples played
+    uint32_t nb_refills;                //Buffers queued
+    uint32_t nb_underruns;              //Underrun events (buffer not ready)
+    uint32_t nb_missed;                 //Sample periods without sample
+}WAVE_Stats_t;
+
+typedef enum WAVE_Ret_e{
+    WAVE_STATUS_ERROR,
+    WAVE_STATUS_OK,
+}WAVE_Ret_t;
+
+/******************************************************************************
+*   Public Variables
+*******************************************************************************/
+
+
+/******************************************************************************
+*   Error Check
+*******************************************************************************/
+
+
+/******************************************************************************
+*   Public Functions Declarations
+*******************************************************************************/
+/***************************************************************************//*!
+*  \brief Waveform player initialization.
+*
+*   This function is used to initialize the waveform player (playback timer
+*   and refill task).
+*
+*   Preconditions: Phase driver initialized.
+*
+*   Side Effects: None.
+*
+*   \return     Operation status
+*
+*******************************************************************************/
+WAVE_Ret_t WAVE_InitPlayer(void);
+
+/***************************************************************************//*!
+*  \brief Start waveform playback.
+*
+*   This function is used to start the playback of a duty waveform on the
+*   selected phase outputs. One sample is applied per timer interrupt
+*   (no task wakeup per sample). The samples are played from 2 buffers
+*   of WAVE_BUFFER_SIZE samples: when a buffer is consumed the player 
+*   task refills it with the refill callback. With a NULL callback, the
+*   samples are streamed with WAVE_Write(). The player takes the
+*   exclusive use of the phases until the playback stops, a phases trip
+*   (regulator fault) stops the playback.
+*
+*   Preconditions: Player initialized and stopped. Phases not used by
+*                  someone else and not tripped.
+*
+*   Side Effects: Phases enabled.
+*
+*   \param[in]  rate_hz             Playback rate.
+*   \param[in]  outputs             Phase outputs (WAVE_OUTPUT_xxx).
+*   \param[in]  callback            Refill callback (NULL -> streaming).
+*   \param[in]  pCtx                Refill callback context.
+*
+*   \return     Operation status
+*
+*******************************************************************************/
+WAVE_Ret_t WAVE_Start(uint32_t rate_hz, uint8_t outputs, WAVE_RefillCallback_t callback, void *pCtx);
+
+/***************************************************************************//*!
+*  \brief Start shape playback.
+*
+*   This function is used to start the playback of a generated waveform
+*   (ramp, triangle or sine) on the selected phase outputs.
+*
+*   Preconditions: Player initialized and stopped. Phases not used by
+*                  someone else and not tripped.
+*
+*   Side Effects: Phases enabled.
+*
+*   \param[in]  rate_hz             Playback rate.
+*   \param[in]  outputs             Phase outputs (WAVE_OUTPUT_xxx).
+*   \param[in]  pConfig             Pointer to the shape config.
+*
+*   \return     Operation status
+*
+*******************************************************************************/
+WAVE_Ret_t WAVE_StartShape(uint32_t rate_hz, uint8_t outputs, const WAVE_Shape_Config_t *pConfig);
+
+/***************************************************************************//*!
+*  \brief Stop waveform playback.
+*
+*   This function is used to stop the playback. The phase outputs duty are
+*   set to 0 and the phases are disabled.
+*
+*   Preconditions: Player initialized.
+*
+*   Side Effects: Phases disabled.
+*
+*   \return     Operation status
+*
+*******************************************************************************/
+WAVE_Ret_t WAVE_Stop(void);
+
+/***************************************************************************//*!
+*  \brief Write streamed samples.
+*
+*   This function is used to append samples to the buffer being filled
+*   (streaming playback). A buffer is queued for playback when full (or
+*   with WAVE_Flush()). Only the samples fitting in the free buffers are
+*   written.
+*
+*   Preconditions: Playback started in streaming mode.
+*
+*   Side Effects: None.
+*
+*   \param[in]  pSamples            Duty samples (0.01%).
+*   \param[in]  nb_samples          Number of samples.
+*   \param[out] pNb_written         Pointer to store the number of samples written.
+*
+*   \return     Operation status
+*
+*******************************************************************************/
+WAVE_Ret_t WAVE_Write(const uint16_t *pSamples, uint32_t nb_samples, uint32_t *pNb_written);
+
+/***************************************************************************//*!
+*  \brief Flush streamed samples.
+*
+*   This function is used to queue the buffer being filled for playback
+*   even if it is not full.
+*
+*   Preconditions: Playback started in streaming mode.
+*
+*   Side Effects: None.
+*
+*   \return     Operation status
+*
+*******************************************************************************/
+WAVE_Ret_t WAVE_Flush(void);
+
+/***************************************************************************//*!
+*  \brief Get playback statistics.
+*
+*   This function is used to get the playback statistics (samples played,
+*   refills and underruns).
+*
+*   Preconditions: Player initialized.
+*
+*   Side Effects: None.
+*
+*   \param[out] pStats              Pointer to store the statistics.
+*
+*   \return     Operation status
+*
+*******************************************************************************/
+WAVE_Ret_t WAVE_GetStats(WAVE_Stats_t *pStats);
+
+#endif//__WAVEFORM_PLAYER_H
@@ -2,7 +2,9 @@
 #include "freertos/semphr.h"
 
 #include "esp_log.h"
+#include "esp_rom_sys.h"
 
+#include "adcController.h"
 #include "pwrMonitoring.h"
 
 /******************************************************************************
@@ -11,6 +13,9 @@
 #define BUS_VOLTAGE_AVG_SAMPLE          (16)
 #define PHASE_CURRENT_AVG_SAMPLE        (16)
 
+#define RIPPLE_SAMPLE_SPACING_US        (3)//Not a PWM period divider
+#define BUS_VOLTAGE_ATTEN               (ADC_CTRL_ATTEN_12DB)
+
 #define LOG_LOCAL_LEVEL                 (ESP_LOG_INFO)
 
 /******************************************************************************
@@ -26,6 +31,8 @@
 /******************************************************************************
 *   Private Functions Declaration
 *******************************************************************************/
+static uint32_t isqrt(uint64_t value);
+static void publishSnapshot(void);
 
 
 /******************************************************************************
@@ -37,6 +44,7 @@
 *   Private Variables
 *******************************************************************************/
 static SemaphoreHandle_t pwr_mutex_handle = NULL;
+static StaticSemaphore_t pwr_mutex_buffer;
 
 static int16_t bus_voltage_10mv = PWR_INVALID_VOLTAGE;
 static int32_t cumul_bus_voltage = 0;
@@ -46,11 +54,65 @@ static int16_t phase_b_current_10ma = PWR_INVALID_CURRENT;
 static int32_t cumul_phase_a_current = 0;
 static int32_t cumul_phase_b_current = 0;
 
+static uint16_t ripple_samples[PWR_RIPPLE_MAX_SAMPLES];
+
+//Lock free copy for the readers (odd sequence: being written)
+static PWR_Snapshot_t pwr_snapshot;
+static uint32_t pwr_snapshot_seq = 0;
+
 static const char * TAG = "PWR";
 
 /******************************************************************************
 *   Private Functions Definitions
 *******************************************************************************/
+/***************************************************************************//*!
+*  \brief Integer square root.
+*
+*   This function return the integer square root (floor) of a value.
+*
+*******************************************************************************/
+static uint32_t isqrt(uint64_t value){
+
+    uint64_t root = 0;
+    uint64_t bit = 1ULL << 62;
+
+    while(bit > value)  bit >>= 2;
+
+    while(bit != 0){
+        if(value >= (root + bit)){
+            value -= (root + bit);
+            root = (root >> 1) + bit;
+        }
+        else{
+            root >>= 1;
+        }
+        bit >>= 2;
+    }
+
+    return (uint32_t)root;
+}
+
+/***************************************************************************//*!
+*  \brief Publish snapshot.
+*
+*   This function copies the latest values to the lock free snapshot.
+*
+*   Preconditions: Single writer (under pwr mutex).
+*
+*******************************************************************************/
+static void publishSnapshot(void){
+
+    uint32_t seq = pwr_snapshot_seq;
+
+    __atomic_store_n(&pwr_snapshot_seq, seq + 1, __ATOMIC_RELAXED);
+    __atomic_thread_fence(__ATOMIC_RELEASE);
+
+    pwr_snapshot.bus_voltage_10mv = bus_voltage_10mv;
+    pwr_snapshot.phase_a_current_10ma = phase_a_current_10ma;
+    pwr_snapshot.phase_b_current_10ma = phase_b_current_10ma;
+
+    __atomic_store_n(&pwr_snapshot_seq, seq + 2, __ATOMIC_RELEASE);
+}
 
 
 /******************************************************************************
@@ -81,9 +143,10 @@ PWR_Ret_t PWR_InitMonitoring(void){
     phase_b_current_10ma = PWR_INVALID_CURRENT;
     cumul_phase_a_current = 0;
     cumul_phase_b_current = 0;
+    publishSnapshot();
 
     //Create mutex
-    pwr_mutex_handle = xSemaphoreCreateMutex();
+    pwr_mutex_handle = xSemaphoreCreateMutexStatic(&pwr_mutex_buffer);
     if(pwr_mutex_handle == NULL){
 
         ESP_LOGE(TAG, "Failed to create PWR mutex");
@@ -211,6 +274,155 @@ PWR_Ret_t PWR_GetPhaseBCurrent(int16_t *pCurrent){
     return PWR_MONITORING_STATUS_OK;
 }
 
+/***************************************************************************//*!
+*  \brief Get snapshot.
+*
+*   This function is used to get the latest bus voltage and phase currents
+*   without taking the module mutex (sequence counter, values published
+*   together by the sensor task).
+*   
+*   Preconditions: None.
+*
+*   Side Effects: None.
+*
+*   \param[out] pSnapshot               Pointer to store the values.
+*
+*   \return     Operation status (error if the snapshot was being
+*               published PWR_SNAPSHOT_MAX_RETRIES times)
+*
+*******************************************************************************/
+PWR_Ret_t PWR_GetSnapshot(PWR_Snapshot_t *pSnapshot){
+
+    if(pSnapshot == NULL)   return PWR_MONITORING_STATUS_ERROR;
+
+    //Bounded: the writer may be preempted by the reader on the same core
+    for(uint32_t i=0; i<PWR_SNAPSHOT_MAX_RETRIES; i++){
+
+        uint32_t seq = __atomic_load_n(&pwr_snapshot_seq, __ATOMIC_ACQUIRE);
+        if(seq & 1) continue;
+
+        *pSnapshot = pwr_snapshot;
+
+        __atomic_thread_fence(__ATOMIC_ACQUIRE);
+        if(seq == __atomic_load_n(&pwr_snapshot_seq, __ATOMIC_RELAXED)){
+            return PWR_MONITORING_STATUS_OK;
+        }
+    }
+
+    return PWR_MONITORING_STATUS_ERROR;
+}
+
+/***************************************************************************//*!
+*  \brief Compute ripple.
+*
+*   This function is used to compute the ripple (mean, peak to peak and
+*   AC RMS) of a voltage samples set (in mV).
+*   
+*   Preconditions: None.
+*
+*   Side Effects: None.
+*
+*   \param[in]  pSamples_mv             Voltage samples.
+*   \param[in]  nb_samples              Number of samples.
+*   \param[out] pRipple                 Pointer to store the ripple.
+*
+*   \return     Operation status
+*
+*******************************************************************************/
+PWR_Ret_t PWR_ComputeRipple(const uint16_t *pSamples_mv, uint32_t nb_samples, PWR_Ripple_t *pRipple){
+
+    if((pSamples_mv == NULL) || (nb_samples == 0) || (pRipple == NULL)){
+        ESP_LOGI(TAG, "Invalid ripple buffer");
+        return PWR_MONITORING_STATUS_ERROR;
+    }
+
+    uint16_t min_mv = UINT16_MAX;
+    uint16_t max_mv = 0;
+    uint64_t sum = 0;
+    uint64_t sum_sq = 0;
+
+    for(uint32_t i=0; i<nb_samples; i++){
+        if(pSamples_mv[i] < min_mv)    min_mv = pSamples_mv[i];
+        if(pSamples_mv[i] > max_mv)    max_mv = pSamples_mv[i];
+        sum += pSamples_mv[i];
+        sum_sq += (uint32_t)pSamples_mv[i] * pSamples_mv[i];
+    }
+
+    //AC RMS: sqrt(E[x^2] - E[x]^2) = sqrt(n.sum(x^2) - sum(x)^2) / n
+    uint64_t variance_n2 = (nb_samples * sum_sq) - (sum * sum);
+
+    pRipple->nb_samples = nb_samples;
+    pRipple->mean_mv = (uint16_t)(sum / nb_samples);
+    pRipple->pk_pk_mv = max_mv - min_mv;
+    pRipple->rms_mv = (uint16_t)(isqrt(variance_n2) / nb_samples);
+
+    return PWR_MONITORING_STATUS_OK;
+}
+
+/***************************************************************************//*!
+*  \brief Measure bus voltage ripple.
+*
+*   This function is used to measure the bus voltage ripple through
+*   ADC_CTRL_CHANNEL_BUS_VOLT. The samples are taken back to back (about
+*   one sample every few us, not synchronized with the phases PWM) so the
+*   whole PWM period is covered. Values are at the ADC input (mV).
+*   
+*   Preconditions: ADC controller available.
+*
+*   Side Effects: Blocking for the sampling duration.
+*
+*   \param[in]  nb_samples              Number of samples (max PWR_RIPPLE_MAX_SAMPLES).
+*   \param[out] pRipple                 Pointer to store the ripple.
+*
+*   \return     Operation status
+*
+*******************************************************************************/
+PWR_Ret_t PWR_MeasureBusRipple(uint32_t nb_samples, PWR_Ripple_t *pRipple){
+
+    PWR_Ret_t ret = PWR_MONITORING_STATUS_OK;
+
+    if((nb_samples == 0) || (nb_samples > PWR_RIPPLE_MAX_SAMPLES) || (pRipple == NULL)){
+        ESP_LOGI(TAG, "Invalid ripple request");
+        return PWR_MONITORING_STATUS_ERROR;
+    }
+
+    xSemaphoreTake(pwr_mutex_handle, portMAX_DELAY);
+
+    if(ADC_CTRL_STATUS_SUCCESS != ADC_SetupTimeCriticalSampling(ADC_CTRL_CHANNEL_BUS_VOLT, BUS_VOLTAGE_ATTEN)){
+        xSemaphoreGive(pwr_mutex_handle);
+        ESP_LOGE(TAG, "ADC unavailable");
+        return PWR_MONITORING_STATUS_ERROR;
+    }
+
+    for(uint32_t i=0; i<nb_samples; i++){
+        if(ADC_CTRL_STATUS_SUCCESS != ADC_StartTimeCriticalSampling(ADC_CTRL_CHANNEL_BUS_VOLT, 1, &ripple_samples[i])){
+            ret = PWR_MONITORING_STATUS_ERROR;
+            break;
+        }
+        esp_rom_delay_us(RIPPLE_SAMPLE_SPACING_US);
+    }
+
+    ADC_ReleaseAdcFromCriticalSampling(ADC_CTRL_CHANNEL_BUS_VOLT);
+
+    if(ret == PWR_MONITORING_STATUS_OK){
+        //Raw -> mV
+        if(ADC_CTRL_STATUS_SUCCESS != ADC_ApplyCalibration(ADC_CTRL_CHANNEL_BUS_VOLT,
+                                                           BUS_VOLTAGE_ATTEN,
+                                                           ripple_samples,
+                                                           nb_samples)){
+            ret = PWR_MONITORING_STATUS_ERROR;
+        }
+    }
+
+    if(ret == PWR_MONITORING_STATUS_OK){
+        ret = PWR_ComputeRipple(ripple_samples, nb_samples, pRipple);
+    }
+
+    xSemaphoreGive(pwr_mutex_handle);
+
+    return ret;
+}
+
 /******************************************************************************
 *   Interrupts
 *******************************************************************************/
@@ -9,6 +9,10 @@
 #define PWR_INVALID_VOLTAGE                     (0x8000)
 #define PWR_INVALID_CURRENT                     (0x8000)
 
+#define PWR_RIPPLE_MAX_SAMPLES                  (1024)
+
+#define PWR_SNAPSHOT_MAX_RETRIES                (4)//Snapshot being published
+
 /******************************************************************************
 *   Public Macros
 *******************************************************************************/
@@ -17,6 +21,19 @@
 /******************************************************************************
 *   Public Data Types
 *******************************************************************************/
+typedef struct PWR_Ripple_s{
+    uint32_t nb_samples;                        //Number of samples
+    uint16_t mean_mv;                           //Mean voltage (ADC input)
+    uint16_t pk_pk_mv;                          //Peak to peak ripple
+    uint16_t rms_mv;                            //AC RMS ripple
+}PWR_Ripple_t;
+
+typedef struct PWR_Snapshot_s{
+    int16_t bus_voltage_10mv;
+    int16_t phase_a_current_10ma;
+    int16_t phase_b_current_10ma;
+}PWR_Snapshot_t;
+
 typedef enum PWR_Ret_e{
     PWR_MONITORING_STATUS_ERROR,
     PWR_MONITORING_STATUS_OK,
@@ -119,4 +136,62 @@ PWR_Ret_t PWR_GetPhaseACurrent(int16_t *pCurrent_10ma);
 *******************************************************************************/
 PWR_Ret_t PWR_GetPhaseBCurrent(int16_t *pCurrent_10ma);
 
+/***************************************************************************//*!
+*  \brief Get snapshot.
+*
+*   This function is used to get the latest bus voltage and phase currents
+*   without taking the module mutex (sequence counter, values published
+*   together by the sensor task).
+*   
+*   Preconditions: None.
+*
+*   Side Effects: None.
+*
+*   \param[out] pSnapshot               Pointer to store the values.
+*
+*   \return     Operation status (error if the snapshot was being
+*               published PWR_SNAPSHOT_MAX_RETRIES times)
+*
+*******************************************************************************/
+PWR_Ret_t PWR_GetSnapshot(PWR_Snapshot_t *pSnapshot);
+
+/***************************************************************************//*!
+*  \brief Compute ripple.
+*
+*   This function is used to compute the ripple (mean, peak to peak and
+*   AC RMS) of a voltage samples set (in mV).
+*   
+*   Preconditions: None.
+*
+*   Side Effects: None.
+*
+*   \param[in]  pSamples_mv             Voltage samples.
+*   \param[in]  nb_samples              Number of samples.
+*   \param[out] pRipple                 Pointer to store the ripple.
+*
+*   \return     Operation status
+*
+*******************************************************************************/
+PWR_Ret_t PWR_ComputeRipple(const uint16_t *pSamples_mv, uint32_t nb_samples, PWR_Ripple_t *pRipple);
+
+/***************************************************************************//*!
+*  \brief Measure bus voltage ripple.
+*
+*   This function is used to measure the bus voltage ripple through
+*   ADC_CTRL_CHANNEL_BUS_VOLT. The samples are taken back to back (about
+*   one sample every few us, not synchronized with the phases PWM) so the
+*   whole PWM period is covered. Values are at the ADC input (mV).
+*   
+*   Preconditions: ADC controller available.
+*
+*   Side Effects: Blocking for the sampling duration.
+*
+*   \param[in]  nb_samples              Number of samples (max PWR_RIPPLE_MAX_SAMPLES).
+*   \param[out] pRipple                 Pointer to store the ripple.
+*
+*   \return     Operation status
+*
+*******************************************************************************/
+PWR_Ret_t PWR_MeasureBusRipple(uint32_t nb_samples, PWR_Ripple_t *pRipple);
+
 #endif//__PWR_MONITORING_H
\ No newline at end of file
@@ -9,6 +9,9 @@
 
 #include "hwi.h"
 #include "taskPriority.h"
+#include "memoryMap.h"
+#include "taskStats.h"
+#include "trace.h"
 #include "adcController.h"
 #include "sensorController.h"
 
@@ -56,7 +59,10 @@ static void disableTempSensors(void);
 *   Private Variables
 *******************************************************************************/
 static TaskHandle_t sensor_task_handle = NULL;
+static StackType_t sensor_task_stack[SENSOR_TASK_STACK_SIZE];
+static StaticTask_t sensor_task_buffer;
 static SemaphoreHandle_t sensor_semphr_handle = NULL;
+static StaticSemaphore_t sensor_semphr_buffer;
 
 static SENSOR_Step_t sensor_step = SENSOR_STEP_INVALID;
 
@@ -85,6 +91,10 @@ static void tSensorTask(void *pvParameters){
 
         if(pdTRUE == xSemaphoreTake(sensor_semphr_handle, SENSOR_SEMAPHORE_TIMEOUT_MS/portTICK_PERIOD_MS)){
 
+            //Steps paced by vTaskDelay(), the semaphore is given by the task
+            TSTAT_MarkRunning(true);
+            TRACE_EVENT(TRACE_SENSOR_STEP, sensor_step);
+
             switch(sensor_step){
 
                 case SENSOR_STEP_IDLE:
@@ -181,19 +191,22 @@ SENSOR_Ret_t SENSOR_InitController(void){
     }
 
     //Create semaphore
-    sensor_semphr_handle = xSemaphoreCreateBinary();
+    sensor_semphr_handle = xSemaphoreCreateBinaryStatic(&sensor_semphr_buffer);
     if(sensor_semphr_handle == NULL){
         ESP_LOGE(TAG, "Failed to create sensor semaphore");
         return SENSOR_STATUS_ERROR;
     }
 
     //Create task
-    if(pdTRUE != xTaskCreate(tSensorTask,
-                             "Sensor Task",
-                             2048,
-                             NULL,
-                             SENSOR_TASK_PRIORITY,
-                             &sensor_task_handle)){
+    sensor_task_handle = xTaskCreateStaticPinnedToCore(tSensorTask,
+                                                       "Sensor Task",
+                                                       SENSOR_TASK_STACK_SIZE,
+                                                       NULL,
+                                                       SENSOR_TASK_PRIORITY,
+                                                       sensor_task_stack,
+                                                       &sensor_task_buffer,
+                                                       SENSOR_TASK_CORE);
+    if(sensor_task_handle == NULL){
 
         ESP_LOGE(TAG, "Failed to create sensor task");
         return SENSOR_STATUS_ERROR;
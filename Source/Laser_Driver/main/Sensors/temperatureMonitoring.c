@@ -26,6 +26,7 @@
 /******************************************************************************
 *   Private Functions Declaration
 *******************************************************************************/
+static void publishSnapshot(void);
 
 
 /******************************************************************************
@@ -37,6 +38,7 @@
 *   Private Variables
 *******************************************************************************/
 static SemaphoreHandle_t temp_mutex_handle = NULL;
+static StaticSemaphore_t temp_mutex_buffer;
 
 static int16_t temp_load = TEMP_ERROR_INVALID;
 static int32_t cumul_temp_load = 0;
@@ -47,6 +49,10 @@ static int32_t cumul_temp_phase_a = 0;
 static int16_t temp_phase_b = TEMP_ERROR_INVALID;
 static int32_t cumul_temp_phase_b = 0;
 
+//Lock free copy for the readers (odd sequence: being written)
+static TEMP_Snapshot_t temp_snapshot;
+static uint32_t temp_snapshot_seq = 0;
+
 static TEMP_Conv_t conv_table[] = {
     //-40               //-37.5             //-35               //-32.5
     {199, -4000},       {227, -3750},       {258, -3500},       {292, -3250},
@@ -91,6 +97,27 @@ static const char * TAG = "TEMPERATURE";
 /******************************************************************************
 *   Private Functions Definitions
 *******************************************************************************/
+/***************************************************************************//*!
+*  \brief Publish snapshot.
+*
+*   This function copies the latest temperatures to the lock free snapshot.
+*
+*   Preconditions: Single writer (under temperature mutex).
+*
+*******************************************************************************/
+static void publishSnapshot(void){
+
+    uint32_t seq = temp_snapshot_seq;
+
+    __atomic_store_n(&temp_snapshot_seq, seq + 1, __ATOMIC_RELAXED);
+    __atomic_thread_fence(__ATOMIC_RELEASE);
+
+    temp_snapshot.temperature[TEMP_SENSOR_ID_PHASE_A] = temp_phase_a;
+    temp_snapshot.temperature[TEMP_SENSOR_ID_PHASE_B] = temp_phase_b;
+    temp_snapshot.temperature[TEMP_SENSOR_ID_LOAD] = temp_load;
+
+    __atomic_store_n(&temp_snapshot_seq, seq + 2, __ATOMIC_RELEASE);
+}
 
 
 /******************************************************************************
@@ -112,7 +139,7 @@ static const char * TAG = "TEMPERATURE";
 TEMP_Ret_t TEMP_InitMonitoring(void){
 
     //Create mutex
-    temp_mutex_handle = xSemaphoreCreateMutex();
+    temp_mutex_handle = xSemaphoreCreateMutexStatic(&temp_mutex_buffer);
     if(temp_mutex_handle == NULL){
         ESP_LOGE(TAG, "Failed to create temperature mutex");
         return TEMP_STATUS_ERROR;
@@ -122,11 +149,12 @@ TEMP_Ret_t TEMP_InitMonitoring(void){
     temp_load = TEMP_ERROR_INVALID;
     cumul_temp_load = 0;
 
-    temp_phase_b = TEMP_ERROR_INVALID;
+    temp_phase_a = TEMP_ERROR_INVALID;
     cumul_temp_phase_a = 0;
 
     temp_phase_b = TEMP_ERROR_INVALID;
     cumul_temp_phase_b = 0;
+    publishSnapshot();
 
     return TEMP_STATUS_OK;
 }
@@ -218,6 +246,44 @@ TEMP_Ret_t TEMP_GetTemperature(TEMP_Sensor_Id_t sensor_id, int16_t *pTemperature
     return TEMP_STATUS_OK;
 }
 
+/***************************************************************************//*!
+*  \brief Get snapshot.
+*
+*   This function is used get the latest value of every temperature sensor
+*   without taking the module mutex (sequence counter, values published
+*   together by the sensor task).
+*   
+*   Preconditions: None.
+*
+*   Side Effects: None.
+*
+*   \param[out] pSnapshot           Pointer to store the values.
+*
+*   \return     Operation status (error if the snapshot was being
+*               published TEMP_SNAPSHOT_MAX_RETRIES times)
+*
+*******************************************************************************/
+TEMP_Ret_t TEMP_GetSnapshot(TEMP_Snapshot_t *pSnapshot){
+
+    if(pSnapshot == NULL)   return TEMP_STATUS_ERROR;
+
+    //Bounded: the writer may be preempted by the reader on the same core
+    for(uint32_t i=0; i<TEMP_SNAPSHOT_MAX_RETRIES; i++){
+
+        uint32_t seq = __atomic_load_n(&temp_snapshot_seq, __ATOMIC_ACQUIRE);
+        if(seq & 1) continue;
+
+        *pSnapshot = temp_snapshot;
+
+        __atomic_thread_fence(__ATOMIC_ACQUIRE);
+        if(seq == __atomic_load_n(&temp_snapshot_seq, __ATOMIC_RELAXED)){
+            return TEMP_STATUS_OK;
+        }
+    }
+
+    return TEMP_STATUS_ERROR;
+}
+
 /******************************************************************************
 *   Interrupts
 *******************************************************************************/
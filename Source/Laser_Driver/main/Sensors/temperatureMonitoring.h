@@ -10,6 +10,8 @@
 #define TEMP_ERROR_SHORT                (0xFFFE)
 #define TEMP_ERROR_OPEN                 (0xFFFD)
 
+#define TEMP_SNAPSHOT_MAX_RETRIES       (4)//Snapshot being published
+
 /******************************************************************************
 *   Public Macros
 *******************************************************************************/
@@ -26,6 +28,10 @@ typedef enum TEMP_Sensor_Id_e{
     TEMP_SENSOR_ID_INVALID,
 }TEMP_Sensor_Id_t;
 
+typedef struct TEMP_Snapshot_s{
+    int16_t temperature[TEMP_SENSOR_ID_INVALID];//By sensor ID (0.01C)
+}TEMP_Snapshot_t;
+
 typedef enum TEMP_Ret_e{
     TEMP_STATUS_ERROR,
     TEMP_STATUS_OK,
@@ -95,5 +101,24 @@ TEMP_Ret_t TEMP_ProcessRawMeasurement(uint8_t *pMeas_buf, uint32_t size);
 *******************************************************************************/
 TEMP_Ret_t TEMP_GetTemperature(TEMP_Sensor_Id_t sensor_id, int16_t *pTemperature);
 
+/***************************************************************************//*!
+*  \brief Get snapshot.
+*
+*   This function is used get the latest value of every temperature sensor
+*   without taking the module mutex (sequence counter, values published
+*   together by the sensor task).
+*   
+*   Preconditions: None.
+*
+*   Side Effects: None.
+*
+*   \param[out] pSnapshot           Pointer to store the values.
+*
+*   \return     Operation status (error if the snapshot was being
+*               published TEMP_SNAPSHOT_MAX_RETRIES times)
+*
+*******************************************************************************/
+TEMP_Ret_t TEMP_GetSnapshot(TEMP_Snapshot_t *pSnapshot);
+
 
 #endif//__TEMPERATURE_MONITORING_H
\ No newline at end of file
@@ -0,0 +1,632 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <inttypes.h>
+
+#include "freertos/FreeRTOS.h"
+
+#include "esp_log.h"
+
+#include "currentRegulator.h"
+#include "currentRegulator_sim.h"
+#include "currentBalancer.h"
+#include "currentBalancer_sim.h"
+#include "benchmark.h"
+
+/******************************************************************************
+*   Private Definitions
+*******************************************************************************/
+#define SIM_SETPOINT_10MA                   (200)//2A
+#define SIM_MAX_OVERSHOOT_PCT               (5)
+#define SIM_MAX_ERROR_PCT                   (1)
+#define SIM_MAX_SETTLING_MS                 (15)//Including the setpoint slew ramp
+#define SIM_MIN_ERROR_BAND_10MA             (2)
+
+#define SIM_BALANCE_TOTAL_10MA              (500)//5A shared by both phases
+#define SIM_BALANCE_RTH_A                   (80)//0.8C/W (better cooled phase)
+#define SIM_BALANCE_RTH_B                   (120)//1.2C/W
+#define SIM_BALANCE_DURATION_MS             (20000)//10 heatsink time constants
+#define SIM_BALANCE_MIN_SPREAD_GAIN_PCT     (50)//Temperature spread reduction
+#define SIM_LIMIT_TOTAL_10MA                (900)//Not reachable
+
+#define SIM_RAMP_TIME_MS                    (5)
+#define SIM_RAMP_MAX_LAG_MS                 (5)//Time to target after the ramp end
+
+#define SIM_BENCH_ITERATIONS                (BENCH_MAX_ITERATIONS)
+
+#define LOG_LOCAL_LEVEL                     (ESP_LOG_INFO)
+
+/******************************************************************************
+*   Private Macros
+*******************************************************************************/
+#define LOOPS_FROM_MS(ms, rate)             (((uint32_t)(ms) * (rate)) / 1000)
+#define PCT_X100(x, ref)                    ((int32_t)(((int64_t)(x) * 10000) / (ref)))
+
+/******************************************************************************
+*   Private Data Types
+*******************************************************************************/
+typedef bool(*SIM_Scenario_Run_t)(void);
+
+typedef struct SIM_Scenario_s{
+    const char *name;
+    SIM_Scenario_Run_t run;
+}SIM_Scenario_t;
+
+typedef struct SIM_Track_s{
+    int16_t min_10ma;                   //Min real current
+    int16_t max_10ma;                   //Max real current
+    uint32_t settled_us;                //Time of last excursion outside the error band
+    int32_t sum_error_10ma;             //Sum of the error over the window
+    uint32_t nb_samples;                //Number of samples
+}SIM_Track_t;
+
+/******************************************************************************
+*   Private Functions Declaration
+*******************************************************************************/
+static void trackPhase(uint32_t nb_loops, int16_t setpoint_10ma, SIM_Track_t *pTrack);
+static bool runStepResponse(uint32_t rate_hz);
+static bool runStepResponse10k(void);
+static bool runLoopRates(void);
+static bool runBusSag(void);
+static bool runDiodeHeating(void);
+static bool runAntiWindup(void);
+static void runFixedSplit(int16_t setpoint_10ma, CREG_SIM_Plant_State_t *pStates);
+static bool runThermalSharing(void);
+static bool runThermalLimit(void);
+static bool runSoftStart(void);
+static bool runFaultRestart(void);
+static bool runBenchmarks(void);
+
+/******************************************************************************
+*   Public Variables
+*******************************************************************************/
+
+
+/******************************************************************************
+*   Private Variables
+*******************************************************************************/
+static const SIM_Scenario_t sim_scenarios[] = {
+    {"step response",   runStepResponse10k},
+    {"loop rates",      runLoopRates},
+    {"bus sag",         runBusSag},
+    {"diode heating",   runDiodeHeating},
+    {"anti-windup",     runAntiWindup},
+    {"thermal sharing", runThermalSharing},
+    {"thermal limit",   runThermalLimit},
+    {"soft start",      runSoftStart},
+    {"fault restart",   runFaultRestart},
+};
+
+static const char * TAG = "SIM";
+
+/******************************************************************************
+*   Error Check
+*******************************************************************************/
+
+
+/******************************************************************************
+*   Private Functions Definitions
+*******************************************************************************/
+/***************************************************************************//*!
+*  \brief Track phase.
+*
+*   This function advance the simulation loop by loop and track the real
+*   phase A current against the setpoint (min/max, settling time and mean
+*   error).
+*
+*******************************************************************************/
+static void trackPhase(uint32_t nb_loops, int16_t setpoint_10ma, SIM_Track_t *pTrack){
+
+    int16_t band_10ma = (setpoint_10ma * SIM_MAX_ERROR_PCT) / 100;
+    if(band_10ma < SIM_MIN_ERROR_BAND_10MA)  band_10ma = SIM_MIN_ERROR_BAND_10MA;
+
+    pTrack->min_10ma = INT16_MAX;
+    pTrack->max_10ma = INT16_MIN;
+    pTrack->settled_us = 0;
+    pTrack->sum_error_10ma = 0;
+    pTrack->nb_samples = 0;
+
+    uint64_t start_us = CREG_SIM_GetTimeUs();
+    for(uint32_t i=0; i<nb_loops; i++){
+        CREG_SIM_Plant_State_t state;
+        CREG_SIM_Advance(1);
+        CREG_SIM_GetPlantState(CREG_PHASE_A, &state);
+
+        if(state.current_10ma < pTrack->min_10ma)   pTrack->min_10ma = state.current_10ma;
+        if(state.current_10ma > pTrack->max_10ma)   pTrack->max_10ma = state.current_10ma;
+
+        int16_t error = state.current_10ma - setpoint_10ma;
+        if((error > band_10ma) || (error < -band_10ma)){
+            pTrack->settled_us = (uint32_t)(CREG_SIM_GetTimeUs() - start_us);
+        }
+
+        //Mean error over the last quarter of the window
+        if(i >= ((nb_loops * 3) / 4)){
+            pTrack->sum_error_10ma += error;
+            pTrack->nb_samples++;
+        }
+    }
+}
+
+/***************************************************************************//*!
+*  \brief Step response scenario.
+*
+*   0 -> 2A step (slew rate limited), check overshoot, settling time and
+*   steady state error.
+*
+*******************************************************************************/
+static bool runStepResponse(uint32_t rate_hz){
+
+    SIM_Track_t track;
+
+    CREG_SIM_ResetPlant();
+    CREG_SetSetpoint(CREG_PHASE_A, SIM_SETPOINT_10MA);
+    CREG_SetSetpoint(CREG_PHASE_B, SIM_SETPOINT_10MA);
+    CREG_Start(rate_hz);
+    trackPhase(LOOPS_FROM_MS(50, rate_hz), SIM_SETPOINT_10MA, &track);
+
+    CREG_Loop_Stats_t stats;
+    CREG_GetLoopStats(&stats);
+    CREG_Stop();
+
+    int32_t overshoot = PCT_X100(track.max_10ma - SIM_SETPOINT_10MA, SIM_SETPOINT_10MA);
+    int32_t error = PCT_X100(track.sum_error_10ma / (int32_t)track.nb_samples, SIM_SETPOINT_10MA);
+
+    printf("    %5"PRIu32" Hz: settling %"PRIu32" us, overshoot %"PRId32".%02"PRId32" %%, error %"PRId32" x0.01 %%, loop avg %"PRIu32" / max %"PRIu32" cycles\n",
+           rate_hz, track.settled_us, overshoot/100, abs(overshoot%100), error,
+           stats.avg_cycles, stats.max_cycles);
+
+    return (overshoot <= (SIM_MAX_OVERSHOOT_PCT * 100)) &&
+           (abs(error) <= (SIM_MAX_ERROR_PCT * 100)) &&
+           (track.settled_us <= (SIM_MAX_SETTLING_MS * 1000));
+}
+
+static bool runStepResponse10k(void){
+
+    return runStepResponse(CREG_DEFAULT_LOOP_RATE_HZ);
+}
+
+/***************************************************************************//*!
+*  \brief Loop rates scenario.
+*
+*   Step response over the supported loop rate range.
+*
+*******************************************************************************/
+static bool runLoopRates(void){
+
+    //Loop delay dominates at low rate -> lower gains
+    static const struct{
+        uint32_t rate_hz;
+        int32_t kp_q16;
+        int32_t ki_q16;
+    }rates[] = {
+        {CREG_MIN_LOOP_RATE_HZ, 2*CREG_GAIN_ONE,        6*CREG_GAIN_ONE},
+        {5000,                  CREG_DEFAULT_KP_Q16,    CREG_DEFAULT_KI_Q16},
+        {CREG_MAX_LOOP_RATE_HZ, CREG_DEFAULT_KP_Q16,    CREG_DEFAULT_KI_Q16},
+    };
+    bool pass = true;
+
+    for(uint8_t i=0; i<(sizeof(rates)/sizeof(rates[0])); i++){
+        CREG_SetGains(CREG_PHASE_A, rates[i].kp_q16, rates[i].ki_q16);
+        CREG_SetGains(CREG_PHASE_B, rates[i].kp_q16, rates[i].ki_q16);
+        pass &= runStepResponse(rates[i].rate_hz);
+    }
+    CREG_SetGains(CREG_PHASE_A, CREG_DEFAULT_KP_Q16, CREG_DEFAULT_KI_Q16);
+    CREG_SetGains(CREG_PHASE_B, CREG_DEFAULT_KP_Q16, CREG_DEFAULT_KI_Q16);
+
+    return pass;
+}
+
+/***************************************************************************//*!
+*  \brief Bus sag scenario.
+*
+*   Regulated 2A, bus voltage drops from 24V to 19V. Check the current
+*   deviation and the recovery time.
+*
+*******************************************************************************/
+static bool runBusSag(void){
+
+    SIM_Track_t track;
+    uint32_t rate_hz = CREG_DEFAULT_LOOP_RATE_HZ;
+
+    CREG_SIM_ResetPlant();
+    CREG_SetSetpoint(CREG_PHASE_A, SIM_SETPOINT_10MA);
+    CREG_SetSetpoint(CREG_PHASE_B, SIM_SETPOINT_10MA);
+    CREG_Start(rate_hz);
+    CREG_SIM_Advance(LOOPS_FROM_MS(30, rate_hz));
+
+    CREG_SIM_SetBusVoltage(1900);
+    trackPhase(LOOPS_FROM_MS(30, rate_hz), SIM_SETPOINT_10MA, &track);
+    CREG_Stop();
+
+    int32_t deviation = PCT_X100(SIM_SETPOINT_10MA - track.min_10ma, SIM_SETPOINT_10MA);
+    int32_t error = PCT_X100(track.sum_error_10ma / (int32_t)track.nb_samples, SIM_SETPOINT_10MA);
+
+    printf("    24V -> 19V: max deviation %"PRId32".%02"PRId32" %%, recovery %"PRIu32" us, error %"PRId32" x0.01 %%\n",
+           deviation/100, abs(deviation%100), track.settled_us, error);
+
+    return (abs(error) <= (SIM_MAX_ERROR_PCT * 100)) &&
+           (track.settled_us <= (SIM_MAX_SETTLING_MS * 1000));
+}
+
+/***************************************************************************//*!
+*  \brief Diode heating scenario.
+*
+*   Regulated 2A for 2s while the diodes heat up (Vf drops). Check the
+*   steady state error and report the duty compensation (= open loop drift).
+*
+*******************************************************************************/
+static bool runDiodeHeating(void){
+
+    SIM_Track_t track;
+    CREG_SIM_Plant_State_t state_start;
+    CREG_SIM_Plant_State_t state_end;
+    uint32_t rate_hz = CREG_DEFAULT_LOOP_RATE_HZ;
+
+    CREG_SIM_ResetPlant();
+    CREG_SetSetpoint(CREG_PHASE_A, SIM_SETPOINT_10MA);
+    CREG_SetSetpoint(CREG_PHASE_B, SIM_SETPOINT_10MA);
+    CREG_Start(rate_hz);
+    CREG_SIM_Advance(LOOPS_FROM_MS(20, rate_hz));
+    CREG_SIM_GetPlantState(CREG_PHASE_A, &state_start);
+
+    trackPhase(LOOPS_FROM_MS(2000, rate_hz), SIM_SETPOINT_10MA, &track);
+    CREG_SIM_GetPlantState(CREG_PHASE_A, &state_end);
+    CREG_Stop();
+
+    int32_t error = PCT_X100(track.sum_error_10ma / (int32_t)track.nb_samples, SIM_SETPOINT_10MA);
+    int32_t duty_drift = PCT_X100((int32_t)state_start.duty - state_end.duty, state_start.duty);
+
+    printf("    diode %"PRId16" -> %"PRId16" x0.01C, Vf %"PRId16" -> %"PRId16" x10mV, duty compensation %"PRId32".%02"PRId32" %%, error %"PRId32" x0.01 %%\n",
+           state_start.diode_temperature, state_end.diode_temperature,
+           state_start.diode_voltage_10mv, state_end.diode_voltage_10mv,
+           duty_drift/100, abs(duty_drift%100), error);
+
+    return (abs(error) <= (SIM_MAX_ERROR_PCT * 100)) &&
+           (state_end.diode_temperature > state_start.diode_temperature);
+}
+
+/***************************************************************************//*!
+*  \brief Anti-windup scenario.
+*
+*   Unreachable setpoint (low bus voltage) for 100ms then back to a
+*   reachable setpoint. Check the overshoot after leaving the saturation.
+*
+*******************************************************************************/
+static bool runAntiWindup(void){
+
+    SIM_Track_t track;
+    CREG_Phase_Status_t status;
+    uint32_t rate_hz = CREG_DEFAULT_LOOP_RATE_HZ;
+    int16_t setpoint_10ma = SIM_SETPOINT_10MA / 2;
+
+    CREG_SIM_ResetPlant();
+    CREG_SIM_SetBusVoltage(1200);
+    CREG_SetSetpoint(CREG_PHASE_A, CREG_MAX_SETPOINT_10MA);
+    CREG_SetSetpoint(CREG_PHASE_B, CREG_MAX_SETPOINT_10MA);
+    CREG_Start(rate_hz);
+    CREG_SIM_Advance(LOOPS_FROM_MS(100, rate_hz));
+    CREG_GetPhaseStatus(CREG_PHASE_A, &status);
+
+    CREG_SetSetpoint(CREG_PHASE_A, setpoint_10ma);
+    CREG_SetSetpoint(CREG_PHASE_B, setpoint_10ma);
+    trackPhase(LOOPS_FROM_MS(50, rate_hz), setpoint_10ma, &track);
+    CREG_Stop();
+
+    printf("    saturated %s (duty %"PRIu16"), %"PRId16" -> %"PRId16" x10mA: settling %"PRIu32" us, undershoot %"PRId32" x10mA\n",
+           status.saturated ? "yes" : "no", status.duty, status.current_10ma, setpoint_10ma,
+           track.settled_us, (int32_t)setpoint_10ma - track.min_10ma);
+
+    return status.saturated &&
+           (track.settled_us <= (SIM_MAX_SETTLING_MS * 1000));
+}
+
+/***************************************************************************//*!
+*  \brief Fixed split run.
+*
+*   Both phases regulated at the same setpoint (no balancing) with unequal
+*   heatsinks, return the phases plant state at the end of the run.
+*
+*******************************************************************************/
+static void runFixedSplit(int16_t setpoint_10ma, CREG_SIM_Plant_State_t *pStates){
+
+    uint32_t rate_hz = CREG_DEFAULT_LOOP_RATE_HZ;
+
+    CREG_SIM_ResetPlant();
+    CREG_SIM_SetHeatsinkRth(CREG_PHASE_A, SIM_BALANCE_RTH_A);
+    CREG_SIM_SetHeatsinkRth(CREG_PHASE_B, SIM_BALANCE_RTH_B);
+    CREG_SetSetpoint(CREG_PHASE_A, setpoint_10ma);
+    CREG_SetSetpoint(CREG_PHASE_B, setpoint_10ma);
+    CREG_Start(rate_hz);
+    CREG_SIM_Advance(LOOPS_FROM_MS(SIM_BALANCE_DURATION_MS, rate_hz));
+    CREG_SIM_GetPlantState(CREG_PHASE_A, &pStates[CREG_PHASE_A]);
+    CREG_SIM_GetPlantState(CREG_PHASE_B, &pStates[CREG_PHASE_B]);
+    CREG_Stop();
+}
+
+/***************************************************************************//*!
+*  \brief Thermal sharing scenario.
+*
+*   5A total with a better cooled phase A. Compare the fixed 50/50 split
+*   with the balanced split: the balanced heatsinks temperature spread must
+*   be reduced while the total current is kept.
+*
+*******************************************************************************/
+static bool runThermalSharing(void){
+
+    CREG_SIM_Plant_State_t fixed[CREG_PHASE_INVALID];
+    CREG_SIM_Plant_State_t balanced[CREG_PHASE_INVALID];
+    CBAL_Status_t status;
+
+    runFixedSplit(SIM_BALANCE_TOTAL_10MA / 2, fixed);
+
+    CREG_SIM_ResetPlant();
+    CREG_SIM_SetHeatsinkRth(CREG_PHASE_A, SIM_BALANCE_RTH_A);
+    CREG_SIM_SetHeatsinkRth(CREG_PHASE_B, SIM_BALANCE_RTH_B);
+    CBAL_SetTotalSetpoint(SIM_BALANCE_TOTAL_10MA);
+    CREG_Start(CREG_DEFAULT_LOOP_RATE_HZ);
+    CBAL_Start();
+    CBAL_SIM_Advance(SIM_BALANCE_DURATION_MS / CBAL_PERIOD_MS);
+    CREG_SIM_GetPlantState(CREG_PHASE_A, &balanced[CREG_PHASE_A]);
+    CREG_SIM_GetPlantState(CREG_PHASE_B, &balanced[CREG_PHASE_B]);
+    CBAL_GetStatus(&status);
+    CBAL_Stop();
+    CREG_Stop();
+
+    int32_t fixed_spread = abs(fixed[CREG_PHASE_B].heatsink_temperature - fixed[CREG_PHASE_A].heatsink_temperature);
+    int32_t balanced_spread = abs(balanced[CREG_PHASE_B].heatsink_temperature - balanced[CREG_PHASE_A].heatsink_temperature);
+    int32_t total_10ma = balanced[CREG_PHASE_A].current_10ma + balanced[CREG_PHASE_B].current_10ma;
+    int32_t error = PCT_X100(total_10ma - SIM_BALANCE_TOTAL_10MA, SIM_BALANCE_TOTAL_10MA);
+
+    printf("    fixed:    A %"PRId16" x10mA %"PRId16" x0.01C, B %"PRId16" x10mA %"PRId16" x0.01C\n",
+           fixed[CREG_PHASE_A].current_10ma, fixed[CREG_PHASE_A].heatsink_temperature,
+           fixed[CREG_PHASE_B].current_10ma, fixed[CREG_PHASE_B].heatsink_temperature);
+    printf("    balanced: A %"PRId16" x10mA %"PRId16" x0.01C, B %"PRId16" x10mA %"PRId16" x0.01C, share A %"PRIu16" x0.01 %%, headroom %"PRId16" x10mA\n",
+           balanced[CREG_PHASE_A].current_10ma, balanced[CREG_PHASE_A].heatsink_temperature,
+           balanced[CREG_PHASE_B].current_10ma, balanced[CREG_PHASE_B].heatsink_temperature,
+           status.share_a, status.headroom_10ma);
+    printf("    spread %"PRId32" -> %"PRId32" x0.01C, total error %"PRId32" x0.01 %%\n",
+           fixed_spread, balanced_spread, error);
+
+    return (balanced_spread <= ((fixed_spread * (100 - SIM_BALANCE_MIN_SPREAD_GAIN_PCT)) / 100)) &&
+           (abs(error) <= (SIM_MAX_ERROR_PCT * 100)) &&
+           !status.is_limited &&
+           (status.headroom_10ma > 0);
+}
+
+/***************************************************************************//*!
+*  \brief Thermal limit scenario.
+*
+*   Unreachable total current. Check that both phases stay below their
+*   maximum temperature and that the request is reported as limited with
+*   no headroom left.
+*
+*******************************************************************************/
+static bool runThermalLimit(void){
+
+    CREG_SIM_Plant_State_t states[CREG_PHASE_INVALID];
+    CBAL_Status_t status;
+    int16_t max_temp = INT16_MIN;
+    bool is_within_limits = true;
+
+    CREG_SIM_ResetPlant();
+    CREG_SIM_SetHeatsinkRth(CREG_PHASE_A, SIM_BALANCE_RTH_B);
+    CREG_SIM_SetHeatsinkRth(CREG_PHASE_B, SIM_BALANCE_RTH_B);
+    CBAL_SetTotalSetpoint(SIM_LIMIT_TOTAL_10MA);
+    CREG_Start(CREG_DEFAULT_LOOP_RATE_HZ);
+    CBAL_Start();
+
+    for(uint32_t i=0; i<(SIM_BALANCE_DURATION_MS / CBAL_PERIOD_MS); i++){
+        CBAL_SIM_Advance(1);
+        CBAL_GetStatus(&status);
+
+        for(uint8_t phase=0; phase<CREG_PHASE_INVALID; phase++){
+            CREG_SIM_GetPlantState(phase, &states[phase]);
+            if(states[phase].heatsink_temperature > max_temp)   max_temp = states[phase].heatsink_temperature;
+            if(status.phase[phase].setpoint_10ma > status.phase[phase].limit_10ma)  is_within_limits = false;
+        }
+    }
+    CBAL_Stop();
+    CREG_Stop();
+
+    printf("    request %"PRId16" x10mA: delivered %"PRId16" + %"PRId16" x10mA, max temp %"PRId16" x0.01C, headroom %"PRId16" x10mA\n",
+           status.request_10ma, states[CREG_PHASE_A].current_10ma, states[CREG_PHASE_B].current_10ma,
+           max_temp, status.headroom_10ma);
+
+    return is_within_limits &&
+           status.is_limited &&
+           (status.headroom_10ma <= SIM_MIN_ERROR_BAND_10MA) &&
+           (max_temp < CBAL_DEFAULT_MAX_TEMP);
+}
+
+/***************************************************************************//*!
+*  \brief Soft start scenario.
+*
+*   Enable-to-target benchmark: 0 -> 2A at enable for every ramp profile
+*   (5ms ramp, slew rate only for CREG_RAMP_NONE). Report the time to
+*   target (within 1%), the overshoot and the peak current slope.
+*
+*******************************************************************************/
+static bool runSoftStart(void){
+
+    static const char *profile_names[CREG_RAMP_INVALID] = {
+        "slew only", "linear", "s-curve", "exponential",
+    };
+    uint32_t rate_hz = CREG_DEFAULT_LOOP_RATE_HZ;
+    bool pass = true;
+
+    for(uint8_t profile=0; profile<CREG_RAMP_INVALID; profile++){
+
+        CREG_SIM_Plant_State_t state;
+        CREG_Phase_Status_t status;
+        int16_t max_10ma = 0;
+        int16_t prev_10ma = 0;
+        int32_t max_slope = 0;
+
+        CREG_SIM_ResetPlant();
+        CREG_SetRampProfile(profile, SIM_RAMP_TIME_MS);
+        CREG_SetSetpoint(CREG_PHASE_A, SIM_SETPOINT_10MA);
+        CREG_SetSetpoint(CREG_PHASE_B, SIM_SETPOINT_10MA);
+        CREG_Start(rate_hz);
+
+        for(uint32_t i=0; i<LOOPS_FROM_MS(30, rate_hz); i++){
+            CREG_SIM_Advance(1);
+            CREG_SIM_GetPlantState(CREG_PHASE_A, &state);
+
+            if(state.current_10ma > max_10ma)   max_10ma = state.current_10ma;
+            if((state.current_10ma - prev_10ma) > max_slope)    max_slope = state.current_10ma - prev_10ma;
+            prev_10ma = state.current_10ma;
+        }
+        CREG_GetPhaseStatus(CREG_PHASE_A, &status);
+        CREG_Stop();
+
+        int32_t overshoot = PCT_X100(max_10ma - SIM_SETPOINT_10MA, SIM_SETPOINT_10MA);
+        uint32_t max_time_us = (SIM_RAMP_TIME_MS + SIM_RAMP_MAX_LAG_MS) * 1000;
+
+        //Slope per loop -> 10mA per ms
+        printf("    %-12s: time to target %5"PRIu32" us, overshoot %"PRId32".%02"PRId32" %%, peak slope %"PRId32" x10mA/ms\n",
+               profile_names[profile], status.time_to_target_us, overshoot/100, abs(overshoot%100),
+               (max_slope * (int32_t)rate_hz) / 1000);
+
+        pass &= (status.time_to_target_us != 0) &&
+                (status.time_to_target_us <= max_time_us) &&
+                (overshoot <= (SIM_MAX_OVERSHOOT_PCT * 100));
+    }
+    CREG_SetRampProfile(CREG_DEFAULT_RAMP_PROFILE, CREG_DEFAULT_RAMP_TIME_MS);
+
+    return pass;
+}
+
+/***************************************************************************//*!
+*  \brief Fault restart scenario.
+*
+*   Fault while regulating: outputs off at the next loop. Fault cleared while
+*   running: the phases restart with the start ramp (no step). Start refused
+*   while a fault is latched.
+*
+*******************************************************************************/
+static bool runFaultRestart(void){
+
+    CREG_SIM_Plant_State_t state;
+    CREG_Phase_Status_t status;
+    uint32_t rate_hz = CREG_DEFAULT_LOOP_RATE_HZ;
+    bool pass = true;
+
+    CREG_SIM_ResetPlant();
+    CREG_SetSetpoint(CREG_PHASE_A, SIM_SETPOINT_10MA);
+    CREG_SetSetpoint(CREG_PHASE_B, SIM_SETPOINT_10MA);
+    CREG_Start(rate_hz);
+    CREG_SIM_Advance(LOOPS_FROM_MS(20, rate_hz));
+
+    //Fault -> duty 0 without waiting for the loop
+    CREG_TriggerFault(CREG_FAULT_EXTERNAL);
+    CREG_SIM_GetPlantState(CREG_PHASE_A, &state);
+    pass &= (state.duty == 0);
+
+    CREG_SIM_Advance(LOOPS_FROM_MS(10, rate_hz));
+    CREG_SIM_GetPlantState(CREG_PHASE_A, &state);
+    pass &= (state.duty == 0) && (state.current_10ma == 0);
+
+    //Clear while running -> start ramp again
+    CREG_ClearFault();
+    CREG_SIM_Advance(1);
+    CREG_GetPhaseStatus(CREG_PHASE_A, &status);
+    int16_t first_target_10ma = status.target_10ma;
+    pass &= status.ramping && (first_target_10ma < (SIM_SETPOINT_10MA / 10));
+
+    CREG_SIM_Advance(LOOPS_FROM_MS(20, rate_hz));
+    CREG_GetPhaseStatus(CREG_PHASE_A, &status);
+    pass &= (status.time_to_target_us != 0) &&
+            (status.time_to_target_us <= ((CREG_DEFAULT_RAMP_TIME_MS + SIM_RAMP_MAX_LAG_MS) * 1000));
+
+    //Start refused while latched
+    CREG_TriggerFault(CREG_FAULT_EXTERNAL);
+    CREG_Stop();
+    bool is_refused = (CREG_STATUS_OK != CREG_Start(rate_hz));
+    CREG_ClearFault();
+    CREG_Stop();
+    pass &= is_refused;
+
+    printf("    restart target %"PRId16" x10mA after 1 loop, time to target %"PRIu32" us, start refused %s\n",
+           first_target_10ma, status.time_to_target_us, is_refused ? "yes" : "no");
+
+    return pass;
+}
+
+/***************************************************************************//*!
+*  \brief Run benchmarks.
+*
+*   This function runs every registered kernel (host wall clock, same CSV
+*   as the 'bench run' shell command).
+*
+*******************************************************************************/
+static bool runBenchmarks(void){
+
+    BENCH_Result_t result;
+
+    printf("kernel,iterations,time_ns\n");
+
+    for(uint32_t i=0; i<BENCH_GetNbKernels(); i++){
+
+        if(BENCH_STATUS_OK != BENCH_Run(i, SIM_BENCH_ITERATIONS, &result)){
+            printf("# %s failed\n", BENCH_GetKernelName(i));
+            return false;
+        }
+
+        printf("%s,%"PRIu32",%"PRIu64"\n", result.name, result.nb_iterations, result.counters.time_ns);
+    }
+
+    return true;
+}
+
+/******************************************************************************
+*   CallBack Functions implementation
+*******************************************************************************/
+
+
+/******************************************************************************
+*   Public Functions Definitions
+*******************************************************************************/
+/***************************************************************************//*!
+*  \brief App main.
+*
+*   This function is the simulation entry point (linux target). Run every
+*   regulation/balancing scenario against the simulated plant, then the kernel
+*   benchmarks (wall clock), and exit with a non null status if a scenario
+*   fails.
+*
+*   Preconditions:  None.
+*
+*******************************************************************************/
+void app_main(void){
+
+    uint32_t nb_fail = 0;
+
+    if(CREG_STATUS_OK != CREG_InitRegulator()){
+        ESP_LOGE(TAG, "Failed to init regulator");
+        exit(EXIT_FAILURE);
+    }
+
+    if(CBAL_STATUS_OK != CBAL_InitBalancer()){
+        ESP_LOGE(TAG, "Failed to init balancer");
+        exit(EXIT_FAILURE);
+    }
+
+    for(uint8_t i=0; i<(sizeof(sim_scenarios)/sizeof(sim_scenarios[0])); i++){
+        printf("%s\n", sim_scenarios[i].name);
+        bool pass = sim_scenarios[i].run();
+        printf("[%s] %s\n", pass ? "PASS" : "FAIL", sim_scenarios[i].name);
+        if(!pass)   nb_fail++;
+    }
+
+    printf("%"PRIu32" / %u scenarios failed\n", nb_fail, (unsigned)(sizeof(sim_scenarios)/sizeof(sim_scenarios[0])));
+
+    printf("benchmarks\n");
+    if(!runBenchmarks())    nb_fail++;
+
+    exit((nb_fail == 0) ? EXIT_SUCCESS : EXIT_FAILURE);
+}
+
+/******************************************************************************
+*   Interrupts
+*******************************************************************************/
+
@@ -0,0 +1,755 @@
+#include <string.h>
+
+#include "freertos/FreeRTOS.h"
+#include "freertos/semphr.h"
+#include "freertos/task.h"
+
+#include "driver/i2c_master.h"
+#include "esp_lcd_panel_io.h"
+#include "esp_lcd_panel_ops.h"
+#include "esp_lcd_panel_ssd1306.h"
+#include "esp_timer.h"
+#include "esp_log.h"
+
+#include "taskPriority.h"
+#include "memoryMap.h"
+#include "taskStats.h"
+#include "hwi.h"
+#include "displayDriver.h"
+
+/******************************************************************************
+*   Private Definitions
+*******************************************************************************/
+#define DISP_I2C_ADDRESS                    (0x3C)
+#define DISP_I2C_SPEED_HZ                   (400000)
+#define DISP_I2C_GLITCH_CNT                 (7)
+
+#define DISP_CMD_BITS                       (8)
+#define DISP_PARAM_BITS                     (8)
+#define DISP_CONTROL_PHASE_BYTES            (1)
+#define DISP_DC_BIT_OFFSET                  (6)
+
+//Bus cost of an extra window (column + page range commands, data header).
+//2 dirty regions on adjacent pages are merged in a single window when the
+//extra clean bytes sent cost less than a new window.
+#define DISP_WINDOW_OVERHEAD_BYTES          (12)
+
+#define DISP_FONT_FIRST_CHAR                (' ')
+#define DISP_FONT_LAST_CHAR                 ('~')
+#define DISP_FONT_DEFAULT_CHAR              ('?')
+
+#define LOG_LOCAL_LEVEL                     (ESP_LOG_INFO)
+
+/******************************************************************************
+*   Private Macros
+*******************************************************************************/
+#define DISP_IS_PAGE_DIRTY(first, last)     ((first) <= (last))
+
+/******************************************************************************
+*   Private Data Types
+*******************************************************************************/
+typedef struct DISP_Dirty_s{
+    int16_t first;                      //First dirty column (first > last -> clean)
+    int16_t last;                       //Last dirty column
+}DISP_Dirty_t;
+
+typedef struct DISP_Window_s{
+    uint8_t first_page;
+    uint8_t last_page;
+    int16_t first_col;
+    int16_t last_col;
+}DISP_Window_t;
+
+/******************************************************************************
+*   Private Functions Declaration
+*******************************************************************************/
+static void markDirty(uint8_t page, int16_t col);
+static void applyColumn(uint8_t page, int16_t col, uint8_t mask, uint8_t bits, DISP_Color_t color);
+static void drawColumn(int16_t x, int16_t y, uint8_t mask, uint8_t bits, DISP_Color_t color);
+static uint32_t windowSize(const DISP_Window_t *pWindow);
+static DISP_Ret_t sendWindow(const DISP_Window_t *pWindow);
+static void flushFrame(void);
+static void tDisplayTask(void *pvParameters);
+
+/******************************************************************************
+*   Public Variables
+*******************************************************************************/
+
+
+/******************************************************************************
+*   Private Variables
+*******************************************************************************/
+static SemaphoreHandle_t disp_mutex_handle = NULL;
+static StaticSemaphore_t disp_mutex_buffer;
+static portMUX_TYPE disp_spinlock = portMUX_INITIALIZER_UNLOCKED;
+static TaskHandle_t disp_task_handle = NULL;
+static StackType_t disp_task_stack[DISP_TASK_STACK_SIZE];
+static StaticTask_t disp_task_buffer;
+
+static i2c_master_bus_handle_t disp_bus_handle = NULL;
+static esp_lcd_panel_io_handle_t disp_io_handle = NULL;
+static esp_lcd_panel_handle_t disp_panel_handle = NULL;
+
+//Drawing side (under disp_mutex)
+static uint8_t frame_buffer[DISP_NB_PAGES][DISP_WIDTH];
+static DISP_Dirty_t frame_dirty[DISP_NB_PAGES];
+
+//Flush side (owned by the display task)
+static uint8_t snapshot_buffer[DISP_NB_PAGES][DISP_WIDTH];
+static DISP_Dirty_t snapshot_dirty[DISP_NB_PAGES];
+static uint8_t tx_buffer[DISP_NB_PAGES * DISP_WIDTH];
+
+//Statistics (under disp_spinlock)
+static DISP_Stats_t disp_stats;
+
+//5x7 font, 1 byte per column (bit 0 -> top row)
+static const uint8_t font_5x7[][DISP_FONT_WIDTH] = {
+    {0x00, 0x00, 0x00, 0x00, 0x00},//' '
+    {0x00, 0x00, 0x5F, 0x00, 0x00},//'!'
+    {0x00, 0x07, 0x00, 0x07, 0x00},//'"'
+    {0x14, 0x7F, 0x14, 0x7F, 0x14},//'#'
+    {0x24, 0x2A, 0x7F, 0x2A, 0x12},//'$'
+    {0x23, 0x13, 0x08, 0x64, 0x62},//'%'
+    {0x36, 0x49, 0x56, 0x20, 0x50},//'&'
+    {0x00, 0x05, 0x03, 0x00, 0x00},//'''
+    {0x00, 0x1C, 0x22, 0x41, 0x00},//'('
+    {0x00, 0x41, 0x22, 0x1C, 0x00},//')'
+    {0x14, 0x08, 0x3E, 0x08, 0x14},//'*'
+    {0x08, 0x08, 0x3E, 0x08, 0x08},//'+'
+    {0x00, 0x50, 0x30, 0x00, 0x00},//','
+    {0x08, 0x08, 0x08, 0x08, 0x08},//'-'
+    {0x00, 0x60, 0x60, 0x00, 0x00},//'.'
+    {0x20, 0x10, 0x08, 0x04, 0x02},//'/'
+    {0x3E, 0x51, 0x49, 0x45, 0x3E},//'0'
+    {0x00, 0x42, 0x7F, 0x40, 0x00},//'1'
+    {0x42, 0x61, 0x51, 0x49, 0x46},//'2'
+    {0x21, 0x41, 0x45, 0x4B, 0x31},//'3'
+    {0x18, 0x14, 0x12, 0x7F, 0x10},//'4'
+    {0x27, 0x45, 0x45, 0x45, 0x39},//'5'
+    {0x3C, 0x4A, 0x49, 0x49, 0x30},//'6'
+    {0x01, 0x71, 0x09, 0x05, 0x03},//'7'
+    {0x36, 0x49, 0x49, 0x49, 0x36},//'8'
+    {0x06, 0x49, 0x49, 0x29, 0x1E},//'9'
+    {0x00, 0x36, 0x36, 0x00, 0x00},//':'
+    {0x00, 0x56, 0x36, 0x00, 0x00},//';'
+    {0x08, 0x14, 0x22, 0x41, 0x00},//'<'
+    {0x14, 0x14, 0x14, 0x14, 0x14},//'='
+    {0x00, 0x41, 0x22, 0x14, 0x08},//'>'
+    {0x02, 0x01, 0x51, 0x09, 0x06},//'?'
+    {0x32, 0x49, 0x79, 0x41, 0x3E},//'@'
+    {0x7E, 0x11, 0x11, 0x11, 0x7E},//'A'
+    {0x7F, 0x49, 0x49, 0x49, 0x36},//'B'
+    {0x3E, 0x41, 0x41, 0x41, 0x22},//'C'
+    {0x7F, 0x41, 0x41, 0x22, 0x1C},//'D'
+    {0x7F, 0x49, 0x49, 0x49, 0x41},//'E'
+    {0x7F, 0x09, 0x09, 0x09, 0x01},//'F'
+    {0x3E, 0x41, 0x49, 0x49, 0x7A},//'G'
+    {0x7F, 0x08, 0x08, 0x08, 0x7F},//'H'
+    {0x00, 0x41, 0x7F, 0x41, 0x00},//'I'
+    {0x20, 0x40, 0x41, 0x3F, 0x01},//'J'
+    {0x7F, 0x08, 0x14, 0x22, 0x41},//'K'
+    {0x7F, 0x40, 0x40, 0x40, 0x40},//'L'
+    {0x7F, 0x02, 0x0C, 0x02, 0x7F},//'M'
+    {0x7F, 0x04, 0x08, 0x10, 0x7F},//'N'
+    {0x3E, 0x41, 0x41, 0x41, 0x3E},//'O'
+    {0x7F, 0x09, 0x09, 0x09, 0x06},//'P'
+    {0x3E, 0x41, 0x51, 0x21, 0x5E},//'Q'
+    {0x7F, 0x09, 0x19, 0x29, 0x46},//'R'
+    {0x46, 0x49, 0x49, 0x49, 0x31},//'S'
+    {0x01, 0x01, 0x7F, 0x01, 0x01},//'T'
+    {0x3F, 0x40, 0x40, 0x40, 0x3F},//'U'
+    {0x1F, 0x20, 0x40, 0x20, 0x1F},//'V'
+    {0x3F, 0x40, 0x38, 0x40, 0x3F},//'W'
+    {0x63, 0x14, 0x08, 0x14, 0x63},//'X'
+    {0x07, 0x08, 0x70, 0x08, 0x07},//'Y'
+    {0x61, 0x51, 0x49, 0x45, 0x43},//'Z'
+    {0x00, 0x7F, 0x41, 0x41, 0x00},//'['
+    {0x02, 0x04, 0x08, 0x10, 0x20},//'\'
+    {0x00, 0x41, 0x41, 0x7F, 0x00},//']'
+    {0x04, 0x02, 0x01, 0x02, 0x04},//'^'
+    {0x40, 0x40, 0x40, 0x40, 0x40},//'_'
+    {0x00, 0x01, 0x02, 0x04, 0x00},//'`'
+    {0x20, 0x54, 0x54, 0x54, 0x78},//'a'
+    {0x7F, 0x48, 0x44, 0x44, 0x38},//'b'
+    {0x38, 0x44, 0x44, 0x44, 0x20},//'c'
+    {0x38, 0x44, 0x44, 0x48, 0x7F},//'d'
+    {0x38, 0x54, 0x54, 0x54, 0x18},//'e'
+    {0x08, 0x7E, 0x09, 0x01, 0x02},//'f'
+    {0x0C, 0x52, 0x52, 0x52, 0x3E},//'g'
+    {0x7F, 0x08, 0x04, 0x04, 0x78},//'h'
+    {0x00, 0x44, 0x7D, 0x40, 0x00},//'i'
+    {0x20, 0x40, 0x44, 0x3D, 0x00},//'j'
+    {0x7F, 0x10, 0x28, 0x44, 0x00},//'k'
+    {0x00, 0x41, 0x7F, 0x40, 0x00},//'l'
+    {0x7C, 0x04, 0x18, 0x04, 0x78},//'m'
+    {0x7C, 0x08, 0x04, 0x04, 0x78},//'n'
+    {0x38, 0x44, 0x44, 0x44, 0x38},//'o'
+    {0x7C, 0x14, 0x14, 0x14, 0x08},//'p'
+    {0x08, 0x14, 0x14, 0x18, 0x7C},//'q'
+    {0x7C, 0x08, 0x04, 0x04, 0x08},//'r'
+    {0x48, 0x54, 0x54, 0x54, 0x20},//'s'
+    {0x04, 0x3F, 0x44, 0x40, 0x20},//'t'
+    {0x3C, 0x40, 0x40, 0x20, 0x7C},//'u'
+    {0x1C, 0x20, 0x40, 0x20, 0x1C},//'v'
+    {0x3C, 0x40, 0x30, 0x40, 0x3C},//'w'
+    {0x44, 0x28, 0x10, 0x28, 0x44},//'x'
+    {0x0C, 0x50, 0x50, 0x50, 0x3C},//'y'
+    {0x44, 0x64, 0x54, 0x4C, 0x44},//'z'
+    {0x00, 0x08, 0x36, 0x41, 0x00},//'{'
+    {0x00, 0x00, 0x7F, 0x00, 0x00},//'|'
+    {0x00, 0x41, 0x36, 0x08, 0x00},//'}'
+    {0x08, 0x04, 0x08, 0x10, 0x08},//'~'
+};
+
+static const char * TAG = "DISP";
+
+/******************************************************************************
+*   Error Check
+*******************************************************************************/
+#if ((DISP_HEIGHT % DISP_PAGE_HEIGHT) != 0)
+#error "Display height must be a multiple of the page height"
+#endif
+
+/******************************************************************************
+*   Private Functions Definitions
+*******************************************************************************/
+/***************************************************************************//*!
+*  \brief Mark column dirty.
+*
+*   This function extend the dirty column range of a page. Must be called
+*   with disp_mutex taken.
+*
+*******************************************************************************/
+static void markDirty(uint8_t page, int16_t col){
+
+    if(!DISP_IS_PAGE_DIRTY(frame_dirty[page].first, frame_dirty[page].last)){
+        frame_dirty[page].first = col;
+        frame_dirty[page].last = col;
+        return;
+    }
+
+    if(col < frame_dirty[page].first)   frame_dirty[page].first = col;
+    if(col > frame_dirty[page].last)    frame_dirty[page].last = col;
+}
+
+/***************************************************************************//*!
+*  \brief Apply column.
+*
+*   This function update the masked pixels of a framebuffer byte (bits set
+*   -> foreground). The column is marked dirty only if the byte changes,
+*   so redrawing identical content costs no I2C transfer. Must be called
+*   with disp_mutex taken.
+*
+*******************************************************************************/
+static void applyColumn(uint8_t page, int16_t col, uint8_t mask, uint8_t bits, DISP_Color_t color){
+
+    uint8_t old_byte = frame_buffer[page][col];
+    uint8_t new_byte = old_byte;
+
+    switch(color){
+        case DISP_COLOR_BLACK:
+            new_byte = (old_byte & ~mask) | (~bits & mask);
+            break;
+        case DISP_COLOR_WHITE:
+            new_byte = (old_byte & ~mask) | (bits & mask);
+            break;
+        case DISP_COLOR_INVERT:
+            new_byte = old_byte ^ (bits & mask);
+            break;
+        default:
+            break;
+    }
+
+    if(new_byte != old_byte){
+        frame_buffer[page][col] = new_byte;
+        markDirty(page, col);
+    }
+}
+
+/***************************************************************************//*!
+*  \brief Draw column.
+*
+*   This function draw 8 vertical pixels starting at row y (bit 0 -> row y),
+*   split across 2 pages when y is not page aligned. Out of screen pixels
+*   are clipped. Must be called with disp_mutex taken.
+*
+*******************************************************************************/
+static void drawColumn(int16_t x, int16_t y, uint8_t mask, uint8_t bits, DISP_Color_t color){
+
+    if((x < 0) || (x >= DISP_WIDTH))    return;
+    if((y <= -DISP_PAGE_HEIGHT) || (y >= DISP_HEIGHT))  return;
+
+    int16_t page = (y >= 0) ? (y / DISP_PAGE_HEIGHT) : -1;
+    uint8_t shift = (uint8_t)(y - (page * DISP_PAGE_HEIGHT));
+    uint16_t mask_16 = (uint16_t)mask << shift;
+    uint16_t bits_16 = (uint16_t)bits << shift;
+
+    if(page >= 0){
+        applyColumn(page, x, mask_16 & 0xFF, bits_16 & 0xFF, color);
+    }
+
+    if((shift != 0) && ((page + 1) < DISP_NB_PAGES)){
+        applyColumn(page + 1, x, mask_16 >> 8, bits_16 >> 8, color);
+    }
+}
+
+/***************************************************************************//*!
+*  \brief Window size.
+*
+*   This function return the number of pixel bytes of a window.
+*
+*******************************************************************************/
+static uint32_t windowSize(const DISP_Window_t *pWindow){
+
+    return (uint32_t)(pWindow->last_page - pWindow->first_page + 1) *
+           (uint32_t)(pWindow->last_col - pWindow->first_col + 1);
+}
+
+/***************************************************************************//*!
+*  \brief Send window.
+*
+*   This function send a snapshot window to the panel. A single page window
+*   is sent straight from the snapshot, a multi pages window is packed
+*   first (the panel expects the window bytes page after page).
+*
+*******************************************************************************/
+static DISP_Ret_t sendWindow(const DISP_Window_t *pWindow){
+
+    const uint8_t *pData = &snapshot_buffer[pWindow->first_page][pWindow->first_col];
+    uint32_t width = pWindow->last_col - pWindow->first_col + 1;
+
+    if(pWindow->last_page != pWindow->first_page){
+        uint8_t *pPacked = tx_buffer;
+        for(uint8_t page=pWindow->first_page; page<=pWindow->last_page; page++){
+            memcpy(pPacked, &snapshot_buffer[page][pWindow->first_col], width);
+            pPacked += width;
+        }
+        pData = tx_buffer;
+    }
+
+    if(ESP_OK != esp_lcd_panel_draw_bitmap(disp_panel_handle,
+                                           pWindow->first_col,
+                                           pWindow->first_page * DISP_PAGE_HEIGHT,
+                                           pWindow->last_col + 1,
+                                           (pWindow->last_page + 1) * DISP_PAGE_HEIGHT,
+                                           pData)){
+        return DISP_STATUS_ERROR;
+    }
+
+    return DISP_STATUS_OK;
+}
+
+/***************************************************************************//*!
+*  \brief Flush frame.
+*
+*   This function snapshot the dirty regions of the framebuffer (drawing is
+*   only held for the copy) then send them to the panel, merging adjacent
+*   dirty pages in a single window when cheaper.
+*
+*******************************************************************************/
+static void flushFrame(void){
+
+    bool is_dirty = false;
+
+    //Snapshot
+    xSemaphoreTake(disp_mutex_handle, portMAX_DELAY);
+    for(uint8_t page=0; page<DISP_NB_PAGES; page++){
+        snapshot_dirty[page] = frame_dirty[page];
+        if(DISP_IS_PAGE_DIRTY(frame_dirty[page].first, frame_dirty[page].last)){
+            memcpy(&snapshot_buffer[page][frame_dirty[page].first],
+                   &frame_buffer[page][frame_dirty[page].first],
+                   frame_dirty[page].last - frame_dirty[page].first + 1);
+            frame_dirty[page].first = DISP_WIDTH;
+            frame_dirty[page].last = -1;
+            is_dirty = true;
+        }
+    }
+    xSemaphoreGive(disp_mutex_handle);
+
+    if(!is_dirty){
+        portENTER_CRITICAL(&disp_spinlock);
+        disp_stats.nb_skipped++;
+        portEXIT_CRITICAL(&disp_spinlock);
+        return;
+    }
+
+    //Send dirty windows
+    int64_t start_us = esp_timer_get_time();
+    uint32_t nb_bytes = 0;
+    uint32_t nb_windows = 0;
+    DISP_Window_t window;
+    bool is_window = false;
+
+    for(uint8_t page=0; page<=DISP_NB_PAGES; page++){
+
+        bool is_page_dirty = (page < DISP_NB_PAGES) &&
+                             DISP_IS_PAGE_DIRTY(snapshot_dirty[page].first, snapshot_dirty[page].last);
+
+        if(is_window && is_page_dirty){
+            //Try to extend the current window to this page
+            DISP_Window_t merged = window;
+            merged.last_page = page;
+            if(snapshot_dirty[page].first < merged.first_col)   merged.first_col = snapshot_dirty[page].first;
+            if(snapshot_dirty[page].last > merged.last_col)     merged.last_col = snapshot_dirty[page].last;
+
+            uint32_t split_cost = windowSize(&window) + DISP_WINDOW_OVERHEAD_BYTES +
+                                  (uint32_t)(snapshot_dirty[page].last - snapshot_dirty[page].first + 1);
+            if(windowSize(&merged) <= split_cost){
+                window = merged;
+                continue;
+            }
+        }
+
+        if(is_window){
+            if(DISP_STATUS_OK != sendWindow(&window)){
+                ESP_LOGE(TAG, "Failed to send pages %u-%u", window.first_page, window.last_page);
+            }
+            nb_bytes += windowSize(&window);
+            nb_windows++;
+            is_window = false;
+        }
+
+        if(is_page_dirty){
+            window.first_page = page;
+            window.last_page = page;
+            window.first_col = snapshot_dirty[page].first;
+            window.last_col = snapshot_dirty[page].last;
+            is_window = true;
+        }
+    }
+
+    uint32_t frame_us = (uint32_t)(esp_timer_get_time() - start_us);
+
+    portENTER_CRITICAL(&disp_spinlock);
+    disp_stats.nb_refresh++;
+    disp_stats.last_bytes = nb_bytes;
+    disp_stats.last_windows = nb_windows;
+    disp_stats.last_frame_us = frame_us;
+    disp_stats.total_bytes += nb_bytes;
+    if(nb_bytes > disp_stats.max_bytes)     disp_stats.max_bytes = nb_bytes;
+    if(frame_us > disp_stats.max_frame_us)  disp_stats.max_frame_us = frame_us;
+    portEXIT_CRITICAL(&disp_spinlock);
+}
+
+static void tDisplayTask(void *pvParameters){
+
+    ESP_LOGI(TAG, "Starting Display task");
+
+    for(;;){
+        //Refresh requests received during a flush are merged in 1 frame
+        ulTaskNotifyTake(pdTRUE, portMAX_DELAY);
+        TSTAT_MarkRunning(false);
+        flushFrame();
+    }
+    vTaskDelete(NULL);
+}
+
+/******************************************************************************
+*   CallBack Functions implementation
+*******************************************************************************/
+
+
+/******************************************************************************
+*   Public Functions Definitions
+*******************************************************************************/
+/***************************************************************************//*!
+*  \brief Display driver initialization.
+*
+*   This function is used to initialize the SSD1306 panel (I2C bus, esp_lcd
+*   panel), the RAM framebuffer and the flush task. The panel is cleared
+*   and turned on.
+*
+*   Preconditions: None.
+*
+*   Side Effects: None.
+*
+*   \return     Operation status
+*
+*******************************************************************************/
+DISP_Ret_t DISP_InitDisplay(void){
+
+    memset(frame_buffer, 0, sizeof(frame_buffer));
+    memset(&disp_stats, 0, sizeof(disp_stats));
+
+    //Panel RAM content is undefined at power up: first frame sends everything
+    for(uint8_t page=0; page<DISP_NB_PAGES; page++){
+        frame_dirty[page].first = 0;
+        frame_dirty[page].last = DISP_WIDTH - 1;
+    }
+
+    //Create mutex
+    disp_mutex_handle = xSemaphoreCreateMutexStatic(&disp_mutex_buffer);
+    if(disp_mutex_handle == NULL){
+        ESP_LOGE(TAG, "Failed to create DISP mutex");
+        return DISP_STATUS_ERROR;
+    }
+
+    //Init I2C bus
+    i2c_master_bus_config_t bus_config = {
+        .i2c_port = -1,//Auto select
+        .sda_io_num = HWI_LCD_SDA_GPIO,
+        .scl_io_num = HWI_LCD_SCL_GPIO,
+        .clk_source = I2C_CLK_SRC_DEFAULT,
+        .glitch_ignore_cnt = DISP_I2C_GLITCH_CNT,
+        .flags.enable_internal_pullup = true,
+    };
+    if(ESP_OK != i2c_new_master_bus(&bus_config, &disp_bus_handle)){
+        ESP_LOGE(TAG, "Failed to create I2C bus");
+        return DISP_STATUS_ERROR;
+    }
+
+    //Init panel IO
+    esp_lcd_panel_io_i2c_config_t io_config = {
+        .dev_addr = DISP_I2C_ADDRESS,
+        .scl_speed_hz = DISP_I2C_SPEED_HZ,
+        .control_phase_bytes = DISP_CONTROL_PHASE_BYTES,
+        .dc_bit_offset = DISP_DC_BIT_OFFSET,
+        .lcd_cmd_bits = DISP_CMD_BITS,
+        .lcd_param_bits = DISP_PARAM_BITS,
+    };
+    if(ESP_OK != esp_lcd_new_panel_io_i2c(disp_bus_handle, &io_config, &disp_io_handle)){
+        ESP_LOGE(TAG, "Failed to create panel IO");
+        return DISP_STATUS_ERROR;
+    }
+
+    //Init panel
+    esp_lcd_panel_ssd1306_config_t ssd1306_config = {
+        .height = DISP_HEIGHT,
+    };
+    esp_lcd_panel_dev_config_t panel_config = {
+        .bits_per_pixel = 1,
+        .reset_gpio_num = -1,
+        .vendor_config = &ssd1306_config,
+    };
+    if(ESP_OK != esp_lcd_new_panel_ssd1306(disp_io_handle, &panel_config, &disp_panel_handle)){
+        ESP_LOGE(TAG, "Failed to create SSD1306 panel");
+        return DISP_STATUS_ERROR;
+    }
+
+    if((ESP_OK != esp_lcd_panel_reset(disp_panel_handle)) ||
+       (ESP_OK != esp_lcd_panel_init(disp_panel_handle)) ||
+       (ESP_OK != esp_lcd_panel_disp_on_off(disp_panel_handle, true))){
+        ESP_LOGE(TAG, "Failed to init SSD1306 panel");
+        return DISP_STATUS_ERROR;
+    }
+
+    //create display task
+    disp_task_handle = xTaskCreateStaticPinnedToCore(tDisplayTask,
+                                                     "Display task",
+                                                     DISP_TASK_STACK_SIZE,
+                                                     NULL,
+                                                     DISP_TASK_PRIORITY,
+                                                     disp_task_stack,
+                                                     &disp_task_buffer,
+                                                     DISP_TASK_CORE);
+    if(disp_task_handle == NULL){
+
+        ESP_LOGE(TAG, "Failed to create Display task");
+        return DISP_STATUS_ERROR;
+    }
+
+    return DISP_Refresh();
+}
+
+/***************************************************************************//*!
+*  \brief Clear framebuffer.
+*
+*   This function is used to clear the whole framebuffer. Only the columns
+*   that were lit are marked dirty.
+*
+*   Preconditions: Display initialized.
+*
+*   Side Effects: None.
+*
+*   \return     Operation status
+*
+*******************************************************************************/
+DISP_Ret_t DISP_Clear(void){
+
+    if(disp_mutex_handle == NULL)   return DISP_STATUS_ERROR;
+
+    xSemaphoreTake(disp_mutex_handle, portMAX_DELAY);
+    for(uint8_t page=0; page<DISP_NB_PAGES; page++){
+        for(int16_t col=0; col<DISP_WIDTH; col++){
+            applyColumn(page, col, 0xFF, 0x00, DISP_COLOR_WHITE);
+        }
+    }
+    xSemaphoreGive(disp_mutex_handle);
+
+    return DISP_STATUS_OK;
+}
+
+/***************************************************************************//*!
+*  \brief Set pixel.
+*
+*   This function is used to draw a single pixel in the framebuffer.
+*   Pixels out of the screen are ignored.
+*
+*   Preconditions: Display initialized.
+*
+*   Side Effects: None.
+*
+*   \param[in]  x                   Column (0 -> DISP_WIDTH-1).
+*   \param[in]  y                   Row (0 -> DISP_HEIGHT-1).
+*   \param[in]  color               Pixel color.
+*
+*   \return     Operation status
+*
+*******************************************************************************/
+DISP_Ret_t DISP_SetPixel(int16_t x, int16_t y, DISP_Color_t color){
+
+    if(color >= DISP_COLOR_INVALID) return DISP_STATUS_ERROR;
+
+    if(disp_mutex_handle == NULL)   return DISP_STATUS_ERROR;
+
+    xSemaphoreTake(disp_mutex_handle, portMAX_DELAY);
+    drawColumn(x, y, 0x01, 0x01, color);
+    xSemaphoreGive(disp_mutex_handle);
+
+    return DISP_STATUS_OK;
+}
+
+/***************************************************************************//*!
+*  \brief Fill rectangle.
+*
+*   This function is used to fill a rectangle in the framebuffer. The
+*   rectangle is clipped to the screen.
+*
+*   Preconditions: Display initialized.
+*
+*   Side Effects: None.
+*
+*   \param[in]  x                   Left column.
+*   \param[in]  y                   Top row.
+*   \param[in]  width               Width in pixels.
+*   \param[in]  height              Height in pixels.
+*   \param[in]  color               Fill color.
+*
+*   \return     Operation status
+*
+*******************************************************************************/
+DISP_Ret_t DISP_FillRect(int16_t x, int16_t y, int16_t width, int16_t height, DISP_Color_t color){
+
+    if(color >= DISP_COLOR_INVALID) return DISP_STATUS_ERROR;
+
+    if((width <= 0) || (height <= 0))   return DISP_STATUS_ERROR;
+
+    if(disp_mutex_handle == NULL)   return DISP_STATUS_ERROR;
+
+    int16_t first_col = (x < 0) ? 0 : x;
+    int16_t last_col = ((x + width) > DISP_WIDTH) ? (DISP_WIDTH - 1) : (x + width - 1);
+
+    xSemaphoreTake(disp_mutex_handle, portMAX_DELAY);
+    for(int16_t col=first_col; col<=last_col; col++){
+        //8 rows per step, the last step is partial
+        for(int16_t row=y; row<(y + height); row+=DISP_PAGE_HEIGHT){
+            int16_t nb_rows = y + height - row;
+            uint8_t mask = (nb_rows >= DISP_PAGE_HEIGHT) ? 0xFF : (uint8_t)((1 << nb_rows) - 1);
+            drawColumn(col, row, mask, mask, color);
+        }
+    }
+    xSemaphoreGive(disp_mutex_handle);
+
+    return DISP_STATUS_OK;
+}
+
+/***************************************************************************//*!
+*  \brief Draw text.
+*
+*   This function is used to draw an ASCII string with the 5x7 font, each
+*   character cell is DISP_CHAR_WIDTH x 8 pixels (background drawn). The
+*   text is clipped to the screen, no wrapping.
+*
+*   Preconditions: Display initialized.
+*
+*   Side Effects: None.
+*
+*   \param[in]  x                   Left column.
+*   \param[in]  y                   Top row.
+*   \param[in]  pText               Null terminated string.
+*   \param[in]  color               Text color (DISP_COLOR_BLACK -> inverted text).
+*
+*   \return     Operation status
+*
+*******************************************************************************/
+DISP_Ret_t DISP_DrawText(int16_t x, int16_t y, const char *pText, DISP_Color_t color){
+
+    if(pText == NULL)   return DISP_STATUS_ERROR;
+
+    if(color >= DISP_COLOR_INVALID) return DISP_STATUS_ERROR;
+
+    if(disp_mutex_handle == NULL)   return DISP_STATUS_ERROR;
+
+    xSemaphoreTake(disp_mutex_handle, portMAX_DELAY);
+    for(; (*pText != '\0') && (x < DISP_WIDTH); pText++, x+=DISP_CHAR_WIDTH){
+
+        char c = *pText;
+        if((c < DISP_FONT_FIRST_CHAR) || (c > DISP_FONT_LAST_CHAR)) c = DISP_FONT_DEFAULT_CHAR;
+        const uint8_t *pGlyph = font_5x7[c - DISP_FONT_FIRST_CHAR];
+
+        for(uint8_t i=0; i<DISP_CHAR_WIDTH; i++){
+            uint8_t bits = (i < DISP_FONT_WIDTH) ? pGlyph[i] : 0x00;
+            //Invert only toggles the glyph, the background is kept
+            uint8_t mask = (color == DISP_COLOR_INVERT) ? bits : 0xFF;
+            drawColumn(x + i, y, mask, bits, color);
+        }
+    }
+    xSemaphoreGive(disp_mutex_handle);
+
+    return DISP_STATUS_OK;
+}
+
+/***************************************************************************//*!
+*  \brief Request display refresh.
+*
+*   This function is used to request the flush of the framebuffer changes
+*   to the panel. It never waits for the I2C transfer: the flush task
+*   snapshots the dirty regions and sends them in the background. Requests
+*   made during a flush are merged into the next frame.
+*
+*   Preconditions: Display initialized.
+*
+*   Side Effects: None.
+*
+*   \return     Operation status
+*
+*******************************************************************************/
+DISP_Ret_t DISP_Refresh(void){
+
+    if(disp_task_handle == NULL)    return DISP_STATUS_ERROR;
+
+    TSTAT_MarkReady(disp_task_handle);
+    xTaskNotifyGive(disp_task_handle);
+
+    return DISP_STATUS_OK;
+}
+
+/***************************************************************************//*!
+*  \brief Get display statistics.
+*
+*   This function is used to get the flush statistics (bytes sent and time
+*   per frame).
+*
+*   Preconditions: Display initialized.
+*
+*   Side Effects: None.
+*
+*   \param[out] pStats              Pointer to store the statistics.
+*
+*   \return     Operation status
+*
+*******************************************************************************/
+DISP_Ret_t DISP_GetStats(DISP_Stats_t *pStats){
+
+    if(pStats == NULL)  return DISP_STATUS_ERROR;
+
+    portENTER_CRITICAL(&disp_spinlock);
+    *pStats = disp_stats;
+    portEXIT_CRITICAL(&disp_spinlock);
+
+    return DISP_STATUS_OK;
+}
+
+/******************************************************************************
+*   Interrupts
+*******************************************************************************/
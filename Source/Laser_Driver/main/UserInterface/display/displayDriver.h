@@ -0,0 +1,190 @@
+#ifndef __DISPLAY_DRIVER_H
+#define __DISPLAY_DRIVER_H
+
+#include <stdint.h>
+#include <stdbool.h>
+
+/******************************************************************************
+*   Public Definitions
+*******************************************************************************/
+#define DISP_WIDTH                          (128)
+#define DISP_HEIGHT                         (64)
+#define DISP_PAGE_HEIGHT                    (8)//One page -> 8 rows, 1 byte per column
+#define DISP_NB_PAGES                       (DISP_HEIGHT / DISP_PAGE_HEIGHT)
+
+#define DISP_FONT_WIDTH                     (5)
+#define DISP_FONT_HEIGHT                    (7)
+#define DISP_CHAR_WIDTH                     (DISP_FONT_WIDTH + 1)//1 column spacing
+
+/******************************************************************************
+*   Public Macros
+*******************************************************************************/
+
+
+/******************************************************************************
+*   Public Data Types
+*******************************************************************************/
+typedef enum DISP_Color_e{
+    DISP_COLOR_BLACK,
+    DISP_COLOR_WHITE,
+    DISP_COLOR_INVERT,
+
+    DISP_COLOR_INVALID,
+}DISP_Color_t;
+
+typedef struct DISP_Stats_s{
+    uint32_t nb_refresh;                //Frames flushed to the panel
+    uint32_t nb_skipped;                //Refresh requests with nothing to flush
+    uint32_t last_bytes;                //Pixel bytes sent by the latest frame
+    uint32_t max_bytes;                 //Max pixel bytes sent per frame
+    uint32_t last_windows;              //I2C windows (column/page ranges) of the latest frame
+    uint32_t last_frame_us;             //Latest frame flush time
+    uint32_t max_frame_us;              //Max frame flush time
+    uint64_t total_bytes;               //Pixel bytes sent since init
+}DISP_Stats_t;
+
+typedef enum DISP_Ret_e{
+    DISP_STATUS_ERROR,
+    DISP_STATUS_OK,
+}DISP_Ret_t;
+
+/******************************************************************************
+*   Public Variables
+*******************************************************************************/
+
+
+/******************************************************************************
+*   Error Check
+*******************************************************************************/
+
+
+/******************************************************************************
+*   Public Functions Declarations
+*******************************************************************************/
+/***************************************************************************//*!
+*  \brief Display driver initialization.
+*
+*   This function is used to initialize the SSD1306 panel (I2C bus, esp_lcd
+*   panel), the RAM framebuffer and the flush task. The panel is cleared
+*   and turned on.
+*
+*   Preconditions: None.
+*
+*   Side Effects: None.
+*
+*   \return     Operation status
+*
+*******************************************************************************/
+DISP_Ret_t DISP_InitDisplay(void);
+
+/***************************************************************************//*!
+*  \brief Clear framebuffer.
+*
+*   This function is used to clear the whole framebuffer. Only the columns
+*   that were lit are marked dirty.
+*
+*   Preconditions: Display initialized.
+*
+*   Side Effects: None.
+*
+*   \return     Operation status
+*
+*******************************************************************************/
+DISP_Ret_t DISP_Clear(void);
+
+/***************************************************************************//*!
+*  \brief Set pixel.
+*
+*   This function is used to draw a single pixel in the framebuffer.
+*   Pixels out of the screen are ignored.
+*
+*   Preconditions: Display initialized.
+*
+*   Side Effects: None.
+*
+*   \param[in]  x                   Column (0 -> DISP_WIDTH-1).
+*   \param[in]  y                   Row (0 -> DISP_HEIGHT-1).
+*   \param[in]  color               Pixel color.
+*
+*   \return     Operation status
+*
+*******************************************************************************/
+DISP_Ret_t DISP_SetPixel(int16_t x, int16_t y, DISP_Color_t color);
+
+/***************************************************************************//*!
+*  \brief Fill rectangle.
+*
+*   This function is used to fill a rectangle in the framebuffer. The
+*   rectangle is clipped to the screen.
+*
+*   Preconditions: Display initialized.
+*
+*   Side Effects: None.
+*
+*   \param[in]  x                   Left column.
+*   \param[in]  y                   Top row.
+*   \param[in]  width               Width in pixels.
+*   \param[in]  height              Height in pixels.
+*   \param[in]  color               Fill color.
+*
+*   \return     Operation status
+*
+*******************************************************************************/
+DISP_Ret_t DISP_FillRect(int16_t x, int16_t y, int16_t width, int16_t height, DISP_Color_t color);
+
+/***************************************************************************//*!
+*  \brief Draw text.
+*
+*   This function is used to draw an ASCII string with the 5x7 font, each
+*   character cell is DISP_CHAR_WIDTH x 8 pixels (background drawn). The
+*   text is clipped to the screen, no wrapping.
+*
+*   Preconditions: Display initialized.
+*
+*   Side Effects: None.
+*
+*   \param[in]  x                   Left column.
+*   \param[in]  y                   Top row.
+*   \param[in]  pText               Null terminated string.
+*   \param[in]  color               Text color (DISP_COLOR_BLACK -> inverted text).
+*
+*   \return     Operation status
+*
+*******************************************************************************/
+DISP_Ret_t DISP_DrawText(int16_t x, int16_t y, const char *pText, DISP_Color_t color);
+
+/***************************************************************************//*!
+*  \brief Request display refresh.
+*
+*   This function is used to request the flush of the framebuffer changes
+*   to the panel. It never waits for the I2C transfer: the flush task
+*   snapshots the dirty regions and sends them in the background. Requests
+*   made during a flush are merged into the next frame.
+*
+*   Preconditions: Display initialized.
+*
+*   Side Effects: None.
+*
+*   \return     Operation status
+*
+*******************************************************************************/
+DISP_Ret_t DISP_Refresh(void);
+
+/***************************************************************************//*!
+*  \brief Get display statistics.
+*
+*   This function is used to get the flush statistics (bytes sent and time
+*   per frame).
+*
+*   Preconditions: Display initialized.
+*
+*   Side Effects: None.
+*
+*   \param[out] pStats              Pointer to store the statistics.
+*
+*   \return     Operation status
+*
+*******************************************************************************/
+DISP_Ret_t DISP_GetStats(DISP_Stats_t *pStats);
+
+#endif//__DISPLAY_DRIVER_H
@@ -6,10 +6,12 @@
 *******************************************************************************/
 #define NO_AVAILABLE_INDEX                  (0xFF)
 
+#define NB_CYCLE_COLORS                     (6)
+
 /******************************************************************************
 *   Private Macros
 *******************************************************************************/
-
+#define LDRV_MIN(a, b)                      (((a) < (b)) ? (a) : (b))
 
 /******************************************************************************
 *   Private Data Types
@@ -29,6 +31,11 @@ typedef struct LDRV_LED_Info_s{
 *******************************************************************************/
 static bool isTableFull(void);
 static uint8_t getFirstAvailableIndex(void);
+static bool setKeyframe(LDRV_CFG_Keyframe_t *pKeyframe,
+                        LDRV_Color_t color,
+                        uint32_t time_ms,
+                        bool is_fade,
+                        const LDRV_LED_Info_t *pLed_info);
 
 /******************************************************************************
 *   Public Variables
@@ -38,12 +45,22 @@ static LDRV_LED_Info_t led_table[LDRV_CFG_MAX_NB_LED];
 /******************************************************************************
 *   Private Variables
 *******************************************************************************/
-
+//Color cycle hues (red, yellow, green, aqua, blue, purple)
+static const LDRV_Color_t cycle_colors[NB_CYCLE_COLORS] = {
+    {LDRV_CFG_MAX_PWM_DUTY, LDRV_CFG_MIN_PWM_DUTY, LDRV_CFG_MIN_PWM_DUTY},
+    {LDRV_CFG_MAX_PWM_DUTY, LDRV_CFG_MAX_PWM_DUTY, LDRV_CFG_MIN_PWM_DUTY},
+    {LDRV_CFG_MIN_PWM_DUTY, LDRV_CFG_MAX_PWM_DUTY, LDRV_CFG_MIN_PWM_DUTY},
+    {LDRV_CFG_MIN_PWM_DUTY, LDRV_CFG_MAX_PWM_DUTY, LDRV_CFG_MAX_PWM_DUTY},
+    {LDRV_CFG_MIN_PWM_DUTY, LDRV_CFG_MIN_PWM_DUTY, LDRV_CFG_MAX_PWM_DUTY},
+    {LDRV_CFG_MAX_PWM_DUTY, LDRV_CFG_MIN_PWM_DUTY, LDRV_CFG_MAX_PWM_DUTY},
+};
 
 /******************************************************************************
 *   Error Check
 *******************************************************************************/
-
+#if (NB_CYCLE_COLORS > LDRV_CFG_MAX_NB_KEYFRAME)
+#error "Too many color cycle hues for a sequence"
+#endif
 
 /******************************************************************************
 *   Private Functions Definitions
@@ -94,6 +111,49 @@ static uint8_t getFirstAvailableIndex(void){
     return index;
 }
 
+/***************************************************************************//*!
+*  \brief Set keyframe
+*
+*   This function fill an effect keyframe with the led channels levels for
+*   a color (gamma and active level applied by the sequence).
+*   
+*   Preconditions: None.
+*
+*   Side Effects: None.
+*
+*   \param[out]     pKeyframe               Pointer to the keyframe
+*   \param[in]      color                   Color (single pwm led: red)
+*   \param[in]      time_ms                 Keyframe time (in ms)
+*   \param[in]      is_fade                 Fade from the previous keyframe
+*   \param[in]      pLed_info               Pointer to the led infos
+*
+*   \return         (True -> Keyframe set / False -> Not a pwm led)
+*
+*******************************************************************************/
+static bool setKeyframe(LDRV_CFG_Keyframe_t *pKeyframe,
+                        LDRV_Color_t color,
+                        uint32_t time_ms,
+                        bool is_fade,
+                        const LDRV_LED_Info_t *pLed_info){
+
+    pKeyframe->time_ms = time_ms;
+    pKeyframe->is_fade = is_fade;
+
+    if(pLed_info->led_type == LDRV_LED_TYPE_SINGLE_PWM){
+        pKeyframe->level[0] = LDRV_MIN(color.red_duty, LDRV_CFG_MAX_PWM_DUTY);
+        return true;
+    }
+
+    if(pLed_info->led_type == LDRV_LED_TYPE_RGB){
+        pKeyframe->level[0] = LDRV_MIN(color.red_duty, LDRV_CFG_MAX_PWM_DUTY);
+        pKeyframe->level[1] = LDRV_MIN(color.green_duty, LDRV_CFG_MAX_PWM_DUTY);
+        pKeyframe->level[2] = LDRV_MIN(color.blue_duty, LDRV_CFG_MAX_PWM_DUTY);
+        return true;
+    }
+
+    return false;
+}
+
 /******************************************************************************
 *   CallBack Functions implementation
 *******************************************************************************/
@@ -392,21 +452,14 @@ LDRV_Ret_t LDRV_SetLedSinglePwmDuty(uint32_t duty_cycle, LED_Handle_t led_handle
     if(duty_cycle >= LDRV_CFG_MAX_PWM_DUTY)     duty_cycle = LDRV_CFG_MAX_PWM_DUTY;
     if(duty_cycle <= LDRV_CFG_MIN_PWM_DUTY)     duty_cycle = LDRV_CFG_MIN_PWM_DUTY;
 
-    //Invserse duty-cycle if active low
-    if(led_info.config.single_pwm_config.active_level == LDRV_CFG_ACTIVE_LOW){
-        if(duty_cycle == LDRV_CFG_MAX_PWM_DUTY){
-            duty_cycle = LDRV_CFG_MIN_PWM_DUTY;
-        }
-        else if(duty_cycle == LDRV_CFG_MIN_PWM_DUTY){
-            duty_cycle = LDRV_CFG_MAX_PWM_DUTY + 1;
-        }
-        else{
-            duty_cycle = LDRV_CFG_MAX_PWM_DUTY - duty_cycle;
-        }
-    }
+    //Sequence of the led shared with the effects
+    LDRV_CFG_TakeMutex();
+    LDRV_CFG_Ret_t ret = LDRV_CFG_SetLedSinglePwmDuty(duty_cycle, 
+                                                      led_handle,
+                                                      &led_info.config.single_pwm_config);
+    LDRV_CFG_GiveMutex();
 
-    if(LDRV_CFG_STATUS_OK != LDRV_CFG_SetLedSinglePwmDuty(duty_cycle, 
-                                                          &led_info.config.single_pwm_config)){
+    if(ret != LDRV_CFG_STATUS_OK){
         return LDRV_STATUS_ERROR;
     }
 
@@ -454,22 +507,14 @@ LDRV_Ret_t LDRV_FadeLedSinglePwmDuty(uint32_t target_duty,
     if(target_duty >= LDRV_CFG_MAX_PWM_DUTY)     target_duty = LDRV_CFG_MAX_PWM_DUTY;
     if(target_duty <= LDRV_CFG_MIN_PWM_DUTY)     target_duty = LDRV_CFG_MIN_PWM_DUTY;
 
-    //Invserse duty-cycle if active low
-    if(led_info.config.single_pwm_config.active_level == LDRV_CFG_ACTIVE_LOW){
-        if(target_duty == LDRV_CFG_MAX_PWM_DUTY){
-            target_duty = LDRV_CFG_MIN_PWM_DUTY;
-        }
-        else if(target_duty == LDRV_CFG_MIN_PWM_DUTY){
-            target_duty = LDRV_CFG_MAX_PWM_DUTY + 1;
-        }
-        else{
-            target_duty = LDRV_CFG_MAX_PWM_DUTY - target_duty;
-        }
-    }
+    LDRV_CFG_TakeMutex();
+    LDRV_CFG_Ret_t ret = LDRV_CFG_FadeLedSinglePwmDuty(target_duty, 
+                                                       fade_time_ms, 
+                                                       led_handle,
+                                                       &led_info.config.single_pwm_config);
+    LDRV_CFG_GiveMutex();
 
-    if(LDRV_CFG_STATUS_OK != LDRV_CFG_FadeLedSinglePwmDuty(target_duty, 
-                                                           fade_time_ms, 
-                                                           &led_info.config.single_pwm_config)){
+    if(ret != LDRV_CFG_STATUS_OK){
         return LDRV_STATUS_ERROR;
     }
 
@@ -523,46 +568,15 @@ LDRV_Ret_t LDRV_SetLedRgbColor(LDRV_Color_t color, LED_Handle_t led_handle){
     if(color.blue_duty >= LDRV_CFG_MAX_PWM_DUTY)     color.blue_duty = LDRV_CFG_MAX_PWM_DUTY;
     if(color.blue_duty <= LDRV_CFG_MIN_PWM_DUTY)     color.blue_duty = LDRV_CFG_MIN_PWM_DUTY;
 
-    //Inverse duty-cycle if active low
-    if(led_info.config.rgb_config.active_level == LDRV_CFG_ACTIVE_LOW){
-        //Inverse red duty-cycle
-        if(color.red_duty == LDRV_CFG_MAX_PWM_DUTY){
-            color.red_duty = LDRV_CFG_MIN_PWM_DUTY;
-        }
-        else if(color.red_duty == LDRV_CFG_MIN_PWM_DUTY){
-            color.red_duty = LDRV_CFG_MAX_PWM_DUTY + 1;
-        }   
-        else{
-            color.red_duty = LDRV_CFG_MAX_PWM_DUTY - color.red_duty;
-        }
-
-        //Inverse green duty-cycle
-        if(color.green_duty == LDRV_CFG_MAX_PWM_DUTY){
-            color.green_duty = LDRV_CFG_MIN_PWM_DUTY;
-        }
-        else if(color.green_duty == LDRV_CFG_MIN_PWM_DUTY){
-            color.green_duty = LDRV_CFG_MAX_PWM_DUTY + 1;
-        }
-        else{
-            color.green_duty = LDRV_CFG_MAX_PWM_DUTY - color.green_duty;
-        }
-
-        //Inverse blue duty-cycle
-        if(color.blue_duty == LDRV_CFG_MAX_PWM_DUTY){
-            color.blue_duty = LDRV_CFG_MIN_PWM_DUTY;
-        }
-        else if(color.blue_duty == LDRV_CFG_MIN_PWM_DUTY){
-            color.blue_duty = LDRV_CFG_MAX_PWM_DUTY + 1;
-        }
-        else{
-            color.blue_duty = LDRV_CFG_MAX_PWM_DUTY - color.blue_duty;
-        }
-    }
+    LDRV_CFG_TakeMutex();
+    LDRV_CFG_Ret_t ret = LDRV_CFG_SetLedRgbColor(color.red_duty, 
+                                                 color.green_duty, 
+                                                 color.blue_duty, 
+                                                 led_handle,
+                                                 &led_info.config.rgb_config);
+    LDRV_CFG_GiveMutex();
 
-    if(LDRV_CFG_STATUS_OK != LDRV_CFG_SetLedRgbColor(color.red_duty, 
-                                                     color.green_duty, 
-                                                     color.blue_duty, 
-                                                     &led_info.config.rgb_config)){
+    if(ret != LDRV_CFG_STATUS_OK){
         return LDRV_STATUS_ERROR;
     }
 
@@ -606,47 +620,16 @@ LDRV_Ret_t LDRV_FadeLedRgbColor(LDRV_Color_t target_color,
         return LDRV_STATUS_ERROR;
     }
 
-    //Inverse duty-cycle if active low
-    if(led_info.config.rgb_config.active_level == LDRV_CFG_ACTIVE_LOW){
-        //Inverse red duty-cycle
-        if(target_color.red_duty == LDRV_CFG_MAX_PWM_DUTY){
-            target_color.red_duty = LDRV_CFG_MIN_PWM_DUTY;
-        }
-        else if(target_color.red_duty == LDRV_CFG_MIN_PWM_DUTY){
-            target_color.red_duty = LDRV_CFG_MAX_PWM_DUTY + 1;
-        }   
-        else{
-            target_color.red_duty = LDRV_CFG_MAX_PWM_DUTY - target_color.red_duty;
-        }
-
-        //Inverse green duty-cycle
-        if(target_color.green_duty == LDRV_CFG_MAX_PWM_DUTY){
-            target_color.green_duty = LDRV_CFG_MIN_PWM_DUTY;
-        }
-        else if(target_color.green_duty == LDRV_CFG_MIN_PWM_DUTY){
-            target_color.green_duty = LDRV_CFG_MAX_PWM_DUTY + 1;
-        }
-        else{
-            target_color.green_duty = LDRV_CFG_MAX_PWM_DUTY - target_color.green_duty;
-        }
-
-        //Inverse blue duty-cycle
-        if(target_color.blue_duty == LDRV_CFG_MAX_PWM_DUTY){
-            target_color.blue_duty = LDRV_CFG_MIN_PWM_DUTY;
-        }
-        else if(target_color.blue_duty == LDRV_CFG_MIN_PWM_DUTY){
-            target_color.blue_duty = LDRV_CFG_MAX_PWM_DUTY + 1;
-        }
-        else{
-            target_color.blue_duty = LDRV_CFG_MAX_PWM_DUTY - target_color.blue_duty;
-        }
-    }
+    LDRV_CFG_TakeMutex();
+    LDRV_CFG_Ret_t ret = LDRV_CFG_FadeLedRgbColor(target_color.red_duty, 
+                                                  target_color.green_duty, 
+                                                  target_color.blue_duty, 
+                                                  fade_time_ms, 
+                                                  led_handle,
+                                                  &led_info.config.rgb_config);
+    LDRV_CFG_GiveMutex();
 
-    if(LDRV_CFG_STATUS_OK != LDRV_CFG_FadeLedRgbColor(target_color.red_duty, 
-                                                      target_color.green_duty, 
-                                                      target_color.blue_duty, 
-                                                      fade_time_ms, 
-                                                      &led_info.config.rgb_config)){
+    if(ret != LDRV_CFG_STATUS_OK){
         return LDRV_STATUS_ERROR;
     }
 
@@ -745,8 +728,163 @@ LDRV_Ret_t LDRV_GetLedPwmFreq(LED_Handle_t led_handle, uint32_t *pFreq_hz){
     return LDRV_STATUS_OK;
 }
 
-/******************************************************************************
-*   Interrupts
+/***************************************************************************//*!
+*  \brief Start led effect.
+*
+*   This function is used to start an effect (blink, breathe, pulse, color
+*   cycle) on a single pwm or RGB led. The effect is compiled into LEDC
+*   hardware fade segments chained from the fade end interrupt: it loops
+*   without any task wakeup until stopped. Fades are perceptually linear.
+*   Each led plays its own effect, the running one is replaced.
+*   
+*   Preconditions: Fade service started.
+*
+*   Side Effects: None.
+*
+*   \param[in]      effect                  Effect to play
+*   \param[in]      led_handle              led handle
+*
+*   \return         Operation status
+*
 *******************************************************************************/
+LDRV_Ret_t LDRV_StartLedEffect(LDRV_Effect_t effect, LED_Handle_t led_handle){
 
+    LDRV_CFG_Keyframe_t keyframes[LDRV_CFG_MAX_NB_KEYFRAME];
+    uint8_t nb_keyframes = 0;
+    bool is_valid = true;
 
+    if(led_handle >= LDRV_CFG_MAX_NB_LED){
+        return LDRV_STATUS_ERROR;
+    }
+
+    if((effect.type >= LDRV_EFFECT_INVALID) || (effect.period_ms == 0)){
+        return LDRV_STATUS_ERROR;
+    }
+
+    LDRV_CFG_TakeMutex();
+    LDRV_LED_Info_t led_info = led_table[led_handle]; 
+    LDRV_CFG_GiveMutex();
+
+    if(led_info.active_flag == false){
+        return LDRV_STATUS_ERROR;
+    }
+
+    switch(effect.type){
+        case LDRV_EFFECT_BLINK:
+            is_valid &= setKeyframe(&keyframes[nb_keyframes++], effect.color, effect.period_ms / 2, false, &led_info);
+            is_valid &= setKeyframe(&keyframes[nb_keyframes++], LDRV_RGB_BLACK, effect.period_ms / 2, false, &led_info);
+            break;
+
+        case LDRV_EFFECT_BREATHE:
+            is_valid &= setKeyframe(&keyframes[nb_keyframes++], effect.color, effect.period_ms / 2, true, &led_info);
+            is_valid &= setKeyframe(&keyframes[nb_keyframes++], LDRV_RGB_BLACK, effect.period_ms / 2, true, &led_info);
+            break;
+
+        case LDRV_EFFECT_PULSE:
+            if((effect.nb_pulses == 0) || (effect.nb_pulses > LDRV_EFFECT_MAX_NB_PULSES)){
+                return LDRV_STATUS_ERROR;
+            }
+            //Pulses in the first half period, dark second half
+            uint32_t pulse_ms = effect.period_ms / (4 * effect.nb_pulses);
+            for(uint8_t i=0; i<effect.nb_pulses; i++){
+                is_valid &= setKeyframe(&keyframes[nb_keyframes++], effect.color, pulse_ms, false, &led_info);
+                is_valid &= setKeyframe(&keyframes[nb_keyframes++], LDRV_RGB_BLACK, pulse_ms, false, &led_info);
+            }
+            is_valid &= setKeyframe(&keyframes[nb_keyframes++], LDRV_RGB_BLACK, effect.period_ms / 2, false, &led_info);
+            break;
+
+        case LDRV_EFFECT_COLOR_CYCLE:
+            if(led_info.led_type != LDRV_LED_TYPE_RGB){
+                return LDRV_STATUS_ERROR;
+            }
+            for(uint8_t i=0; i<NB_CYCLE_COLORS; i++){
+                is_valid &= setKeyframe(&keyframes[nb_keyframes++], cycle_colors[i], effect.period_ms, true, &led_info);
+            }
+            break;
+
+        default:
+            return LDRV_STATUS_ERROR;
+    }
+
+    if(is_valid == false){
+        return LDRV_STATUS_ERROR;
+    }
+
+    LDRV_CFG_Ret_t ret = LDRV_CFG_STATUS_ERROR;
+
+    LDRV_CFG_TakeMutex();
+    if(led_info.led_type == LDRV_LED_TYPE_SINGLE_PWM){
+        ret = LDRV_CFG_StartSequence(led_handle, keyframes, nb_keyframes, 0,
+                                     &led_info.config.single_pwm_config.led_channel, 1,
+                                     led_info.config.single_pwm_config.led_timer,
+                                     led_info.config.single_pwm_config.active_level);
+    }
+    else{
+        ledc_channel_t channels[LDRV_CFG_MAX_NB_CHANNEL] = {
+            led_info.config.rgb_config.red_channel,
+            led_info.config.rgb_config.green_channel,
+            led_info.config.rgb_config.blue_channel,
+        };
+        ret = LDRV_CFG_StartSequence(led_handle, keyframes, nb_keyframes, 0,
+                                     channels, 3,
+                                     led_info.config.rgb_config.led_timer,
+                                     led_info.config.rgb_config.active_level);
+    }
+    LDRV_CFG_GiveMutex();
+
+    return (ret == LDRV_CFG_STATUS_OK) ? LDRV_STATUS_OK : LDRV_STATUS_ERROR;
+}
+
+/***************************************************************************//*!
+*  \brief Stop led effect.
+*
+*   This function is used to stop the running effect of a led. The led
+*   keeps its current brightness.
+*   
+*   Preconditions: None.
+*
+*   Side Effects: None.
+*
+*   \param[in]      led_handle              led handle
+*
+*   \return         Operation status
+*
+*******************************************************************************/
+LDRV_Ret_t LDRV_StopLedEffect(LED_Handle_t led_handle){
+
+    LDRV_CFG_TakeMutex();
+    LDRV_CFG_Ret_t ret = LDRV_CFG_StopSequence(led_handle);
+    LDRV_CFG_GiveMutex();
+
+    return (ret == LDRV_CFG_STATUS_OK) ? LDRV_STATUS_OK : LDRV_STATUS_ERROR;
+}
+
+/***************************************************************************//*!
+*  \brief Get led effect statistics.
+*
+*   This function is used to get the statistics of the current effect of a
+*   led: hardware segments chained and CPU cycles spent in the fade end
+*   interrupt.
+*   
+*   Preconditions: None.
+*
+*   Side Effects: None.
+*
+*   \param[in]      led_handle              led handle
+*   \param[out]     pStats                  Pointer to store the statistics
+*
+*   \return         Operation status
+*
+*******************************************************************************/
+LDRV_Ret_t LDRV_GetLedEffectStats(LED_Handle_t led_handle, LDRV_CFG_Sequence_Stats_t *pStats){
+
+    if(LDRV_CFG_STATUS_OK != LDRV_CFG_GetSequenceStats(led_handle, pStats)){
+        return LDRV_STATUS_ERROR;
+    }
+
+    return LDRV_STATUS_OK;
+}
+
+/******************************************************************************
+*   Interrupts
+*******************************************************************************/
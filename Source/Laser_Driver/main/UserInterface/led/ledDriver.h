@@ -19,6 +19,8 @@
 #define LDRV_RGB_ORANGE         (LDRV_Color_t){.red_duty = LDRV_CFG_MAX_PWM_DUTY, .green_duty = LDRV_CFG_MAX_PWM_DUTY/2, .blue_duty = LDRV_CFG_MIN_PWM_DUTY}
 #define LDRV_RGB_BLACK          (LDRV_Color_t){.red_duty = LDRV_CFG_MIN_PWM_DUTY, .green_duty = LDRV_CFG_MIN_PWM_DUTY, .blue_duty = LDRV_CFG_MIN_PWM_DUTY}
 
+#define LDRV_EFFECT_MAX_NB_PULSES           ((LDRV_CFG_MAX_NB_KEYFRAME - 1) / 2)
+
 /******************************************************************************
 *   Public Macros
 *******************************************************************************/
@@ -35,12 +37,28 @@ typedef enum LDRV_Led_Type_e{
     LDRV_LED_TYPE_INVALID,
 }LDRV_Led_Type_t;
 
+typedef enum LDRV_Effect_Type_e{
+    LDRV_EFFECT_BLINK,                  //On/off, half period each
+    LDRV_EFFECT_BREATHE,                //Fade in/out, half period each
+    LDRV_EFFECT_PULSE,                  //nb_pulses flashes in the first half period
+    LDRV_EFFECT_COLOR_CYCLE,            //RGB only: fade through the hues, one period each
+
+    LDRV_EFFECT_INVALID,
+}LDRV_Effect_Type_t;
+
 typedef struct LDRV_Color_s{
     uint32_t red_duty;
     uint32_t green_duty;
     uint32_t blue_duty;
 }LDRV_Color_t;
 
+typedef struct LDRV_Effect_s{
+    LDRV_Effect_Type_t type;
+    LDRV_Color_t color;                 //On color (single pwm led: red_duty)
+    uint32_t period_ms;
+    uint8_t nb_pulses;                  //Pulse only (1 to LDRV_EFFECT_MAX_NB_PULSES)
+}LDRV_Effect_t;
+
 typedef enum LDRV_Ret_e{
     LDRV_STATUS_ERROR,
     LDRV_STATUS_OK,
@@ -283,4 +301,61 @@ LDRV_Ret_t LDRV_SetLedPwmFreq(uint32_t freq_hz, LED_Handle_t led_handle);
 *******************************************************************************/
 LDRV_Ret_t LDRV_GetLedPwmFreq(LED_Handle_t led_handle, uint32_t *pFreq_hz);
 
-#endif//__LED_DRIVER_H
\ No newline at end of file
+/***************************************************************************//*!
+*  \brief Start led effect.
+*
+*   This function is used to start an effect (blink, breathe, pulse, color
+*   cycle) on a single pwm or RGB led. The effect is compiled into LEDC
+*   hardware fade segments chained from the fade end interrupt: it loops
+*   without any task wakeup until stopped. Fades are perceptually linear.
+*   Each led plays its own effect, the running one is replaced.
+*   
+*   Preconditions: Fade service started.
+*
+*   Side Effects: None.
+*
+*   \param[in]      effect                  Effect to play
+*   \param[in]      led_handle              led handle
+*
+*   \return         Operation status
+*
+*******************************************************************************/
+LDRV_Ret_t LDRV_StartLedEffect(LDRV_Effect_t effect, LED_Handle_t led_handle);
+
+/***************************************************************************//*!
+*  \brief Stop led effect.
+*
+*   This function is used to stop the running effect of a led. The led
+*   keeps its current brightness.
+*   
+*   Preconditions: None.
+*
+*   Side Effects: None.
+*
+*   \param[in]      led_handle              led handle
+*
+*   \return         Operation status
+*
+*******************************************************************************/
+LDRV_Ret_t LDRV_StopLedEffect(LED_Handle_t led_handle);
+
+/***************************************************************************//*!
+*  \brief Get led effect statistics.
+*
+*   This function is used to get the statistics of the current effect of a
+*   led: hardware segments chained and CPU cycles spent in the fade end
+*   interrupt.
+*   
+*   Preconditions: None.
+*
+*   Side Effects: None.
+*
+*   \param[in]      led_handle              led handle
+*   \param[out]     pStats                  Pointer to store the statistics
+*
+*   \return         Operation status
+*
+*******************************************************************************/
+LDRV_Ret_t LDRV_GetLedEffectStats(LED_Handle_t led_handle, LDRV_CFG_Sequence_Stats_t *pStats);
+
+#endif//__LED_DRIVER_H
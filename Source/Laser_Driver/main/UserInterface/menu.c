@@ -0,0 +1,402 @@
+#include <string.h>
+
+#include "freertos/FreeRTOS.h"
+#include "freertos/task.h"
+
+#include "esp_timer.h"
+#include "esp_log.h"
+
+#include "taskPriority.h"
+#include "memoryMap.h"
+#include "taskStats.h"
+#include "buttonDriver.h"
+#include "displayDriver.h"
+#include "menu_cfg.h"
+#include "textFormat.h"
+#include "menu.h"
+
+/******************************************************************************
+*   Private Definitions
+*******************************************************************************/
+#define MENU_NB_LINES                       (DISP_NB_PAGES)//1 text line per page
+#define MENU_NB_ITEM_LINES                  (MENU_NB_LINES - 1)//Line 0 -> title
+#define MENU_LINE_LENGTH                    (DISP_WIDTH / DISP_CHAR_WIDTH)
+#define MENU_VALUE_WIDTH                    (MENU_LINE_LENGTH - MENU_LABEL_MAX_LENGTH - MENU_UNIT_MAX_LENGTH - 1)
+
+#define LOG_LOCAL_LEVEL                     (ESP_LOG_INFO)
+
+/******************************************************************************
+*   Private Macros
+*******************************************************************************/
+
+
+/******************************************************************************
+*   Private Data Types
+*******************************************************************************/
+typedef struct MENU_State_s{
+    uint8_t selected;                   //Selected item
+    bool is_editing;
+    int32_t edit_value;                 //Value of the edited item
+}MENU_State_t;
+
+/******************************************************************************
+*   Private Functions Declaration
+*******************************************************************************/
+static int32_t clampValue(const MENU_Item_t *pItem, int32_t value);
+static size_t formatValue(char *pBuffer, size_t size, int32_t value, uint8_t decimals);
+static uint32_t drawLine(uint8_t line, const char *pText, bool is_inverted);
+static void renderMenu(void);
+static void buttonEventCallback(BTN_Id_t id, BTN_Event_t event, int64_t timestamp_us);
+static void tMenuTask(void *pvParameters);
+
+/******************************************************************************
+*   Public Variables
+*******************************************************************************/
+
+
+/******************************************************************************
+*   Private Variables
+*******************************************************************************/
+static portMUX_TYPE menu_spinlock = portMUX_INITIALIZER_UNLOCKED;
+static TaskHandle_t menu_task_handle = NULL;
+static StackType_t menu_task_stack[MENU_TASK_STACK_SIZE];
+static StaticTask_t menu_task_buffer;
+static MENU_CFG_Items_Context_t menu_items = {0};
+
+//Key handling (owned by the button scan context)
+static MENU_State_t key_state = {0};
+static int32_t entry_value = 0;         //Value when the edition started
+static bool is_select_long = false;
+
+//Shared with the render task (under menu_spinlock)
+static MENU_State_t shared_state = {0};
+static MENU_Stats_t menu_stats;
+
+//Layout cache (owned by the render task)
+static char line_cache[MENU_NB_LINES][MENU_LINE_LENGTH + 1];
+static bool line_inverted[MENU_NB_LINES];
+static uint8_t first_visible = 0;
+
+static const char * TAG = "MENU";
+
+/******************************************************************************
+*   Error Check
+*******************************************************************************/
+#if (MENU_VALUE_WIDTH < 4)
+#error "Menu label and unit too long for the display line"
+#endif
+
+/******************************************************************************
+*   Private Functions Definitions
+*******************************************************************************/
+static int32_t clampValue(const MENU_Item_t *pItem, int32_t value){
+
+    if(value < pItem->min)  return pItem->min;
+    if(value > pItem->max)  return pItem->max;
+    return value;
+}
+
+/***************************************************************************//*!
+*  \brief Format value.
+*
+*   This function format a fixed point value (250, 2 decimals -> "2.50").
+*   Return the value length.
+*
+*******************************************************************************/
+static size_t formatValue(char *pBuffer, size_t size, int32_t value, uint8_t decimals){
+
+    FMT_Buffer_t fmt;
+
+    FMT_Init(&fmt, pBuffer, size);
+
+    return FMT_Fixed(&fmt, value, decimals);
+}
+
+/***************************************************************************//*!
+*  \brief Draw line.
+*
+*   This function draw a text line (padded to the display width) if it
+*   differs from the cached layout. Return the number of lines drawn.
+*
+*******************************************************************************/
+static uint32_t drawLine(uint8_t line, const char *pText, bool is_inverted){
+
+    char padded[MENU_LINE_LENGTH + 1];
+    FMT_Buffer_t fmt;
+
+    //Cut to the display width
+    FMT_Init(&fmt, padded, sizeof(padded));
+    FMT_String(&fmt, pText);
+    FMT_Pad(&fmt, MENU_LINE_LENGTH);
+
+    if((line_inverted[line] == is_inverted) && (strcmp(padded, line_cache[line]) == 0)){
+        return 0;
+    }
+
+    DISP_DrawText(0, line * DISP_PAGE_HEIGHT, padded, is_inverted ? DISP_COLOR_BLACK : DISP_COLOR_WHITE);
+
+    memcpy(line_cache[line], padded, sizeof(padded));
+    line_inverted[line] = is_inverted;
+    return 1;
+}
+
+/***************************************************************************//*!
+*  \brief Render menu.
+*
+*   This function build the menu layout and redraw the lines that changed
+*   since the previous render, the display is refreshed only if needed.
+*
+*******************************************************************************/
+static void renderMenu(void){
+
+    MENU_State_t state;
+    char line[MENU_LINE_LENGTH + 1];
+    char value[MENU_VALUE_WIDTH + 1];
+    FMT_Buffer_t fmt;
+    uint32_t nb_drawn = 0;
+
+    portENTER_CRITICAL(&menu_spinlock);
+    state = shared_state;
+    portEXIT_CRITICAL(&menu_spinlock);
+
+    //Title
+    FMT_Init(&fmt, line, sizeof(line));
+    if(state.is_editing){
+        FMT_String(&fmt, "Edit ");
+        FMT_String(&fmt, menu_items.pTable[state.selected].pLabel);
+    }
+    else{
+        FMT_String(&fmt, MENU_CFG_TITLE);
+    }
+    nb_drawn += drawLine(0, line, false);
+
+    //Scroll to keep the selected item visible
+    if(state.selected < first_visible){
+        first_visible = state.selected;
+    }
+    else if(state.selected >= (first_visible + MENU_NB_ITEM_LINES)){
+        first_visible = state.selected - MENU_NB_ITEM_LINES + 1;
+    }
+
+    for(uint8_t i=0; i<MENU_NB_ITEM_LINES; i++){
+
+        uint8_t index = first_visible + i;
+        if(index >= menu_items.nb_item){
+            nb_drawn += drawLine(i + 1, "", false);
+            continue;
+        }
+
+        const MENU_Item_t *pItem = &menu_items.pTable[index];
+        bool is_edited = state.is_editing && (index == state.selected);
+
+        size_t value_len = formatValue(value, sizeof(value), is_edited ? state.edit_value : pItem->get_value(), pItem->decimals);
+
+        //Label left aligned, value right aligned, unit
+        FMT_Init(&fmt, line, sizeof(line));
+        FMT_String(&fmt, pItem->pLabel);
+        FMT_Pad(&fmt, MENU_LABEL_MAX_LENGTH + MENU_VALUE_WIDTH - value_len);
+        FMT_String(&fmt, value);
+        FMT_Char(&fmt, ' ');
+        FMT_String(&fmt, pItem->pUnit);
+
+        nb_drawn += drawLine(i + 1, line, index == state.selected);
+    }
+
+    if(nb_drawn > 0)    DISP_Refresh();
+
+    portENTER_CRITICAL(&menu_spinlock);
+    menu_stats.nb_renders++;
+    menu_stats.nb_lines_drawn += nb_drawn;
+    portEXIT_CRITICAL(&menu_spinlock);
+}
+
+static void tMenuTask(void *pvParameters){
+
+    ESP_LOGI(TAG, "Starting Menu task");
+
+    for(;;){
+        //Key events wake the task at once, values changed elsewhere are
+        //picked up periodically (only changed lines are sent)
+        uint32_t nb_notify = ulTaskNotifyTake(pdTRUE, MENU_REFRESH_PERIOD_MS/portTICK_PERIOD_MS);
+        TSTAT_MarkRunning(nb_notify == 0);
+        renderMenu();
+    }
+    vTaskDelete(NULL);
+}
+
+/******************************************************************************
+*   CallBack Functions implementation
+*******************************************************************************/
+/***************************************************************************//*!
+*  \brief Button event callback.
+*
+*   This function handle the key events in the button scan context: edited
+*   values are applied here (no task switch between the key and the
+*   setpoint), the render task is only notified.
+*
+*******************************************************************************/
+static void buttonEventCallback(BTN_Id_t id, BTN_Event_t event, int64_t timestamp_us){
+
+    const MENU_Item_t *pItem = &menu_items.pTable[key_state.selected];
+    bool is_update = false;
+    bool is_change = false;
+
+    switch(id){
+        case BTN_ID_P:
+        case BTN_ID_M:
+            if((event != BTN_EVENT_PRESS) && (event != BTN_EVENT_REPEAT))   break;
+
+            if(!key_state.is_editing){
+                //P -> previous item, M -> next item
+                key_state.selected = (id == BTN_ID_P) ?
+                                     ((key_state.selected + menu_items.nb_item - 1) % menu_items.nb_item) :
+                                     ((key_state.selected + 1) % menu_items.nb_item);
+                is_update = true;
+                break;
+            }
+
+            int32_t step = (event == BTN_EVENT_REPEAT) ? pItem->fast_step : pItem->step;
+            int32_t value = clampValue(pItem, key_state.edit_value + ((id == BTN_ID_P) ? step : -step));
+
+            if((value != key_state.edit_value) && pItem->set_value(value)){
+                key_state.edit_value = value;
+                is_update = true;
+                is_change = true;
+            }
+            break;
+
+        case BTN_ID_SELECT:
+            if(event == BTN_EVENT_PRESS){
+                is_select_long = false;
+            }
+            else if(event == BTN_EVENT_LONG_PRESS){
+                is_select_long = true;
+                if(key_state.is_editing){
+                    //Cancel: restore the value the edition started with
+                    pItem->set_value(entry_value);
+                    key_state.edit_value = entry_value;
+                    key_state.is_editing = false;
+                    is_update = true;
+                }
+            }
+            else if((event == BTN_EVENT_RELEASE) && (!is_select_long)){
+                if(!key_state.is_editing){
+                    entry_value = clampValue(pItem, pItem->get_value());
+                    key_state.edit_value = entry_value;
+                }
+                key_state.is_editing = !key_state.is_editing;
+                is_update = true;
+            }
+            break;
+
+        default:
+            break;
+    }
+
+    uint32_t latency_us = (uint32_t)(esp_timer_get_time() - timestamp_us);
+
+    portENTER_CRITICAL(&menu_spinlock);
+    menu_stats.nb_keys++;
+    if(is_change){
+        menu_stats.nb_changes++;
+        menu_stats.last_latency_us = latency_us;
+        if(latency_us > menu_stats.max_latency_us)  menu_stats.max_latency_us = latency_us;
+    }
+    if(is_update)   shared_state = key_state;
+    portEXIT_CRITICAL(&menu_spinlock);
+
+    if(is_update){
+        TSTAT_MarkReady(menu_task_handle);
+        xTaskNotifyGive(menu_task_handle);
+    }
+}
+
+/******************************************************************************
+*   Public Functions Definitions
+*******************************************************************************/
+/***************************************************************************//*!
+*  \brief Menu initialization.
+*
+*   This function is used to initialize the parameter menu (items from
+*   MENU_CFG_GetItemTable()), the buttons and the render task.
+*       Navigation: P/M select the item, SELECT (short) edits it.
+*       Edition: P/M adjust the value (applied at once, auto repeat when
+*       held), SELECT (short) validates, SELECT (long) restores the value
+*       the edition started with.
+*   Key events are handled in the button scan context, the display is
+*   rendered by a low priority task.
+*
+*   Preconditions: Display initialized.
+*
+*   Side Effects: None.
+*
+*   \return     Operation status
+*
+*******************************************************************************/
+MENU_Ret_t MENU_InitMenu(void){
+
+    menu_items = MENU_CFG_GetItemTable();
+    if((menu_items.pTable == NULL) || (menu_items.nb_item == 0)){
+        ESP_LOGE(TAG, "Empty menu");
+        return MENU_STATUS_ERROR;
+    }
+
+    memset(&key_state, 0, sizeof(key_state));
+    memset(&shared_state, 0, sizeof(shared_state));
+    memset(&menu_stats, 0, sizeof(menu_stats));
+    memset(line_cache, 0, sizeof(line_cache));
+    memset(line_inverted, 0, sizeof(line_inverted));
+    first_visible = 0;
+
+    //create menu task
+    menu_task_handle = xTaskCreateStaticPinnedToCore(tMenuTask,
+                                                     "Menu task",
+                                                     MENU_TASK_STACK_SIZE,
+                                                     NULL,
+                                                     MENU_TASK_PRIORITY,
+                                                     menu_task_stack,
+                                                     &menu_task_buffer,
+                                                     MENU_TASK_CORE);
+    if(menu_task_handle == NULL){
+
+        ESP_LOGE(TAG, "Failed to create Menu task");
+        return MENU_STATUS_ERROR;
+    }
+
+    if(BTN_STATUS_OK != BTN_InitDriver(buttonEventCallback)){
+        ESP_LOGE(TAG, "Failed to init buttons");
+        return MENU_STATUS_ERROR;
+    }
+
+    return MENU_STATUS_OK;
+}
+
+/***************************************************************************//*!
+*  \brief Get menu statistics.
+*
+*   This function is used to get the key handling statistics (raw key
+*   edge to value applied latency) and the render statistics.
+*
+*   Preconditions: None.
+*
+*   Side Effects: None.
+*
+*   \param[out] pStats              Pointer to store the statistics.
+*
+*   \return     Operation status
+*
+*******************************************************************************/
+MENU_Ret_t MENU_GetStats(MENU_Stats_t *pStats){
+
+    if(pStats == NULL)  return MENU_STATUS_ERROR;
+
+    portENTER_CRITICAL(&menu_spinlock);
+    *pStats = menu_stats;
+    portEXIT_CRITICAL(&menu_spinlock);
+
+    return MENU_STATUS_OK;
+}
+
+/******************************************************************************
+*   Interrupts
+*******************************************************************************/
@@ -0,0 +1,103 @@
+#ifndef __MENU_H
+#define __MENU_H
+
+#include <stdint.h>
+#include <stdbool.h>
+
+/******************************************************************************
+*   Public Definitions
+*******************************************************************************/
+#define MENU_LABEL_MAX_LENGTH               (10)
+#define MENU_UNIT_MAX_LENGTH                (3)
+
+#define MENU_REFRESH_PERIOD_MS              (500)//Values changed elsewhere (shell, balancer)
+
+/******************************************************************************
+*   Public Macros
+*******************************************************************************/
+//Item value accessors. Called from the button scan context on key press:
+//they must not block (spinlock or short mutex only).
+typedef int32_t(*MENU_GetValue_t)(void);
+typedef bool(*MENU_SetValue_t)(int32_t value);
+
+/******************************************************************************
+*   Public Data Types
+*******************************************************************************/
+typedef struct MENU_Item_s{
+    const char *pLabel;                 //Up to MENU_LABEL_MAX_LENGTH characters
+    const char *pUnit;                  //Up to MENU_UNIT_MAX_LENGTH characters
+    int32_t min;
+    int32_t max;
+    int32_t step;                       //Step per key press
+    int32_t fast_step;                  //Step per auto repeat
+    uint8_t decimals;                   //Fixed point display (250, 2 -> 2.50)
+    MENU_GetValue_t get_value;
+    MENU_SetValue_t set_value;
+}MENU_Item_t;
+
+typedef struct MENU_Stats_s{
+    uint32_t nb_keys;                   //Key events handled
+    uint32_t nb_changes;                //Values applied
+    uint32_t last_latency_us;           //Raw key edge to value applied
+    uint32_t max_latency_us;
+    uint32_t nb_renders;                //Layout renders
+    uint32_t nb_lines_drawn;            //Lines redrawn (cache miss)
+}MENU_Stats_t;
+
+typedef enum MENU_Ret_e{
+    MENU_STATUS_ERROR,
+    MENU_STATUS_OK,
+}MENU_Ret_t;
+
+/******************************************************************************
+*   Public Variables
+*******************************************************************************/
+
+
+/******************************************************************************
+*   Error Check
+*******************************************************************************/
+
+
+/******************************************************************************
+*   Public Functions Declarations
+*******************************************************************************/
+/***************************************************************************//*!
+*  \brief Menu initialization.
+*
+*   This function is used to initialize the parameter menu (items from
+*   MENU_CFG_GetItemTable()), the buttons and the render task.
+*       Navigation: P/M select the item, SELECT (short) edits it.
+*       Edition: P/M adjust the value (applied at once, auto repeat when
+*       held), SELECT (short) validates, SELECT (long) restores the value
+*       the edition started with.
+*   Key events are handled in the button scan context, the display is
+*   rendered by a low priority task.
+*
+*   Preconditions: Display initialized.
+*
+*   Side Effects: None.
+*
+*   \return     Operation status
+*
+*******************************************************************************/
+MENU_Ret_t MENU_InitMenu(void);
+
+/***************************************************************************//*!
+*  \brief Get menu statistics.
+*
+*   This function is used to get the key handling statistics (raw key
+*   edge to value applied latency) and the render statistics.
+*
+*   Preconditions: None.
+*
+*   Side Effects: None.
+*
+*   \param[out] pStats              Pointer to store the statistics.
+*
+*   \return     Operation status
+*
+*******************************************************************************/
+MENU_Ret_t MENU_GetStats(MENU_Stats_t *pStats);
+
+#endif//__MENU_H
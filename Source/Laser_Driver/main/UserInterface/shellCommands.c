@@ -0,0 +1,1500 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "freertos/FreeRTOS.h"
+#include "freertos/task.h"
+
+#include "esp_log.h"
+#include "esp_cpu.h"
+#include "esp_rom_sys.h"
+
+#include "shellCom.h"
+#include "phaseDriver.h"
+#include "pwrMonitoring.h"
+#include "currentRegulator.h"
+#include "waveformPlayer.h"
+#include "displayDriver.h"
+#include "userInterface.h"
+#include "adcController.h"
+#include "telemetry.h"
+#include "watch.h"
+#include "shellJobs.h"
+#include "taskPriority.h"
+#include "coreAffinity.h"
+#include "taskStats.h"
+#include "trace.h"
+#include "benchmark.h"
+#include "formatBench.h"
+#include "myShell_cfg.h"
+#include "shellCommands.h"
+
+/******************************************************************************
+*   Private Definitions
+*******************************************************************************/
+#define LOG_LOCAL_LEVEL                 (ESP_LOG_INFO)
+
+#define RIPPLE_DEFAULT_DUTY             (5000)//50% (worst case input ripple)
+#define RIPPLE_DEFAULT_NB_SAMPLES       (512)
+#define RIPPLE_SETTLING_MS              (20)
+
+#define RIPPLE_NB_SHIFT                 (2)
+
+#define WAVE_MAX_PUSH_SAMPLES           (16)
+
+#define LED_BENCH_DEFAULT_S             (2)
+#define LED_BENCH_MAX_S                 (60)
+#define LED_BENCH_PERIOD_MS             (1000)//Breathe period
+#define LED_BENCH_STEP_MS               (10)//Task driven duty update
+
+#define FMT_BENCH_DEFAULT_ROUNDS        (1000)
+
+#define TLM_ADC_DEFAULT_FREQ_HZ         (20000)
+
+#define TRACE_DUMP_MAX_TX_PENDING       (1024)//Output ring level pausing the dump (2048 bytes ring)
+#define TRACE_DUMP_WAIT_MS              (5)
+
+#define BENCH_LINE_SIZE                 (128)//SHCOM_Printf() line
+
+/******************************************************************************
+*   Private Macros
+*******************************************************************************/
+#define ARRAY_SIZE(arr)                 (sizeof(arr) / sizeof(arr[0]))
+
+
+/******************************************************************************
+*   Private Data Types
+*******************************************************************************/
+
+
+/******************************************************************************
+*   Private Functions Declaration
+*******************************************************************************/
+static int ledBench(LED_Handle_t led_handle, uint32_t duration_s);
+static bool parseWatchFields(const char *pList, uint32_t *pField_mask);
+static void printBenchResult(const BENCH_Result_t *pResult);
+
+/******************************************************************************
+*   Public Variables
+*******************************************************************************/
+
+
+/******************************************************************************
+*   Private Variables
+*******************************************************************************/
+static const uint16_t ripple_shift_deg[RIPPLE_NB_SHIFT] = {0, PHASE_DEFAULT_SHIFT_DEG};
+
+//Command argument schemas
+static const SHELL_CFG_Arg_Schema_t ripple_args[] = {
+    {"duty",        SHELL_CFG_ARG_INT,      true,   0, PHASE_DUTY_FULL_SCALE,   RIPPLE_DEFAULT_DUTY,        NULL},
+    {"nb_samples",  SHELL_CFG_ARG_INT,      true,   1, PWR_RIPPLE_MAX_SAMPLES,  RIPPLE_DEFAULT_NB_SAMPLES,  NULL},
+};
+
+//wave ramp|triangle|sine <period_ms> <min> <max> [cycles] [rate_hz] | stream [rate_hz] |
+//push <duty> [duty ...] | flush | stop | stat, shapes first in wave_shapes[] order
+static const char * const wave_keywords[] = {"ramp", "triangle", "sine", "stream", "push", "flush", "stop", "stat", NULL};
+static const SHELL_CFG_Arg_Schema_t wave_args[] = {
+    {"command",     SHELL_CFG_ARG_KEYWORD,  false,  0, 0,                       0,                          wave_keywords},
+};
+
+static const SHELL_CFG_Arg_Schema_t wave_shape_args[] = {
+    {"period_ms",   SHELL_CFG_ARG_INT,      false,  1, WAVE_MAX_SHAPE_PERIOD_MS, 0,                         NULL},
+    {"min",         SHELL_CFG_ARG_INT,      false,  0, PHASE_DUTY_FULL_SCALE,   0,                          NULL},
+    {"max",         SHELL_CFG_ARG_INT,      false,  0, PHASE_DUTY_FULL_SCALE,   0,                          NULL},
+    {"cycles",      SHELL_CFG_ARG_INT,      true,   0, INT32_MAX,               0,                          NULL},
+    {"rate_hz",     SHELL_CFG_ARG_INT,      true,   WAVE_MIN_RATE_HZ, WAVE_MAX_RATE_HZ, WAVE_DEFAULT_RATE_HZ, NULL},
+};
+
+static const SHELL_CFG_Arg_Schema_t wave_stream_args[] = {
+    {"rate_hz",     SHELL_CFG_ARG_INT,      true,   WAVE_MIN_RATE_HZ, WAVE_MAX_RATE_HZ, WAVE_DEFAULT_RATE_HZ, NULL},
+};
+
+static const SHELL_CFG_Arg_Schema_t wave_duty_args[] = {
+    {"duty",        SHELL_CFG_ARG_INT,      false,  0, PHASE_DUTY_FULL_SCALE,   0,                          NULL},
+};
+
+//disp stat | disp text <line> <text> | disp clear
+static const char * const disp_keywords[] = {"stat", "text", "clear", NULL};
+static const SHELL_CFG_Arg_Schema_t disp_args[] = {
+    {"command",     SHELL_CFG_ARG_KEYWORD,  false,  0, 0,                       0,                          disp_keywords},
+    {"arg",         SHELL_CFG_ARG_STRING,   true,   0, 0,                       0,                          NULL},
+    {"arg",         SHELL_CFG_ARG_STRING,   true,   0, 0,                       0,                          NULL},
+};
+
+static const SHELL_CFG_Arg_Schema_t disp_text_args[] = {
+    {"line",        SHELL_CFG_ARG_INT,      false,  0, DISP_NB_PAGES - 1,       0,                          NULL},
+    {"text",        SHELL_CFG_ARG_STRING,   false,  0, 0,                       0,                          NULL},
+};
+
+//led blink|breathe|cycle <period_ms> [duty] | pulse <nb> <period_ms> [duty] | stop | stat |
+//bench [seconds], effects first in led_effects[] order
+static const char * const led_keywords[] = {"blink", "breathe", "pulse", "cycle", "stop", "stat", "bench", NULL};
+static const SHELL_CFG_Arg_Schema_t led_args[] = {
+    {"command",     SHELL_CFG_ARG_KEYWORD,  false,  0, 0,                       0,                          led_keywords},
+    {"arg",         SHELL_CFG_ARG_STRING,   true,   0, 0,                       0,                          NULL},
+    {"arg",         SHELL_CFG_ARG_STRING,   true,   0, 0,                       0,                          NULL},
+    {"arg",         SHELL_CFG_ARG_STRING,   true,   0, 0,                       0,                          NULL},
+};
+
+static const SHELL_CFG_Arg_Schema_t led_effect_args[] = {
+    {"period_ms",   SHELL_CFG_ARG_INT,      false,  1, INT32_MAX,               0,                          NULL},
+    {"duty",        SHELL_CFG_ARG_INT,      true,   LDRV_CFG_MIN_PWM_DUTY, LDRV_CFG_MAX_PWM_DUTY, LDRV_CFG_MAX_PWM_DUTY, NULL},
+};
+
+static const SHELL_CFG_Arg_Schema_t led_pulse_args[] = {
+    {"nb_pulses",   SHELL_CFG_ARG_INT,      false,  1, LDRV_EFFECT_MAX_NB_PULSES, 0,                        NULL},
+    {"period_ms",   SHELL_CFG_ARG_INT,      false,  1, INT32_MAX,               0,                          NULL},
+    {"duty",        SHELL_CFG_ARG_INT,      true,   LDRV_CFG_MIN_PWM_DUTY, LDRV_CFG_MAX_PWM_DUTY, LDRV_CFG_MAX_PWM_DUTY, NULL},
+};
+
+static const SHELL_CFG_Arg_Schema_t led_bench_args[] = {
+    {"seconds",     SHELL_CFG_ARG_INT,      true,   1, LED_BENCH_MAX_S,         LED_BENCH_DEFAULT_S,        NULL},
+};
+
+static const char * const com_keywords[] = {"stat", "reset", NULL};
+static const SHELL_CFG_Arg_Schema_t com_args[] = {
+    {"command",     SHELL_CFG_ARG_KEYWORD,  false,  0, 0,                       0,                          com_keywords},
+};
+
+static const char * const tlm_keywords[] = {"on", "off", "rate", "adc", "stat", NULL};
+static const SHELL_CFG_Arg_Schema_t tlm_args[] = {
+    {"command",     SHELL_CFG_ARG_KEYWORD,  false,  0, 0,                       0,                          tlm_keywords},
+    {"arg",         SHELL_CFG_ARG_STRING,   true,   0, 0,                       0,                          NULL},
+    {"arg",         SHELL_CFG_ARG_STRING,   true,   0, 0,                       0,                          NULL},
+};
+
+//tlm rate <channel> <period_ms>, channels in TLM_Channel_t order (raw ADC excluded)
+static const char * const tlm_channel_keywords[] = {"adc", "power", "reg", "fault", "tasks", NULL};
+static const SHELL_CFG_Arg_Schema_t tlm_rate_args[] = {
+    {"channel",     SHELL_CFG_ARG_KEYWORD,  false,  0, 0,                       0,                          tlm_channel_keywords},
+    {"period_ms",   SHELL_CFG_ARG_INT,      false,  0, TLM_MAX_PERIOD_MS,       0,                          NULL},
+};
+
+//tlm adc <freq_hz> [divider] | tlm adc off
+static const char * const tlm_adc_off_keywords[] = {"off", NULL};
+static const SHELL_CFG_Arg_Schema_t tlm_adc_off_args[] = {
+    {"off",         SHELL_CFG_ARG_KEYWORD,  false,  0, 0,                       0,                          tlm_adc_off_keywords},
+};
+
+static const SHELL_CFG_Arg_Schema_t tlm_adc_args[] = {
+    {"freq_hz",     SHELL_CFG_ARG_INT,      false,  1, ADC_CTRL_MAX_SAMPLING_FREQ_HZ, TLM_ADC_DEFAULT_FREQ_HZ, NULL},
+    {"divider",     SHELL_CFG_ARG_INT,      true,   1, TLM_ADC_MAX_DIVIDER,     1,                          NULL},
+};
+
+static const char * const fmt_keywords[] = {"bench", NULL};
+static const SHELL_CFG_Arg_Schema_t fmt_args[] = {
+    {"command",     SHELL_CFG_ARG_KEYWORD,  false,  0, 0,                       0,                          fmt_keywords},
+    {"nb_rounds",   SHELL_CFG_ARG_INT,      true,   1, FBENCH_MAX_ROUNDS,       FMT_BENCH_DEFAULT_ROUNDS,   NULL},
+};
+
+//watch stop | watch stat, watch <fields|all> [rate_hz] otherwise
+static const char * const watch_keywords[] = {"stop", "stat", NULL};
+static const SHELL_CFG_Arg_Schema_t watch_cmd_args[] = {
+    {"command",     SHELL_CFG_ARG_KEYWORD,  false,  0, 0,                       0,                          watch_keywords},
+};
+
+static const SHELL_CFG_Arg_Schema_t watch_args[] = {
+    {"fields",      SHELL_CFG_ARG_STRING,   false,  0, 0,                       0,                          NULL},
+    {"rate_hz",     SHELL_CFG_ARG_INT,      true,   WATCH_MIN_RATE_HZ, WATCH_MAX_RATE_HZ, WATCH_DEFAULT_RATE_HZ, NULL},
+};
+
+static const char * const job_keywords[] = {"list", "kill", "stat", "reset", NULL};
+static const SHELL_CFG_Arg_Schema_t job_args[] = {
+    {"command",     SHELL_CFG_ARG_KEYWORD,  true,   0, 0,                       0,                          job_keywords},
+    {"id",          SHELL_CFG_ARG_INT,      true,   1, INT32_MAX,               0,                          NULL},
+};
+
+static const char * const job_state_names[SHJOB_STATE_INVALID] = {"free", "queued", "running"};
+
+//core [plan] | core bench [duration_ms]
+static const char * const core_keywords[] = {"plan", "bench", NULL};
+static const SHELL_CFG_Arg_Schema_t core_args[] = {
+    {"command",     SHELL_CFG_ARG_KEYWORD,  true,   0, 0,                       0,                          core_keywords},
+    {"duration_ms", SHELL_CFG_ARG_INT,      true,   CORE_BENCH_MIN_DURATION_MS, CORE_BENCH_MAX_DURATION_MS, 1000, NULL},
+};
+
+static const char * const tasks_keywords[] = {"list", "reset", NULL};
+static const SHELL_CFG_Arg_Schema_t tasks_args[] = {
+    {"command",     SHELL_CFG_ARG_KEYWORD,  true,   0, 0,                       0,                          tasks_keywords},
+};
+
+//trace start [ring|once] | trace stop | trace dump | trace stat, modes in TRACE_Mode_t order
+static const char * const trace_keywords[] = {"start", "stop", "dump", "stat", NULL};
+static const char * const trace_mode_keywords[] = {"ring", "once", NULL};
+static const SHELL_CFG_Arg_Schema_t trace_args[] = {
+    {"command",     SHELL_CFG_ARG_KEYWORD,  false,  0, 0,                       0,                          trace_keywords},
+    {"mode",        SHELL_CFG_ARG_KEYWORD,  true,   0, 0,                       TRACE_MODE_RING,            trace_mode_keywords},
+};
+
+static const char * const trace_type_names[TRACE_TYPE_INVALID] = {"point", "begin", "end"};
+
+//bench [list] | bench run [kernel|all] [nb_iterations]
+static const char * const bench_keywords[] = {"list", "run", NULL};
+static const SHELL_CFG_Arg_Schema_t bench_args[] = {
+    {"command",     SHELL_CFG_ARG_KEYWORD,  true,   0, 0,                       0,                          bench_keywords},
+    {"kernel",      SHELL_CFG_ARG_STRING,   true,   0, 0,                       0,                          NULL},
+    {"nb_iterations", SHELL_CFG_ARG_INT,    true,   1, BENCH_MAX_ITERATIONS,    BENCH_DEFAULT_ITERATIONS,   NULL},
+};
+
+static const struct{
+    const char *name;
+    BaseType_t core_id;
+}core_plan[] = {
+    {"trigger",     TRIGGER_TASK_CORE},
+    {"wave",        WAVE_TASK_CORE},
+    {"sensor",      SENSOR_TASK_CORE},
+    {"ctrl isr",    CONTROL_ISR_CORE},
+    {"ui",          UI_TASK_CORE},
+    {"shell",       SHCOM_TASK_CORE},
+    {"shell tx",    SHCOM_TX_TASK_CORE},
+    {"jobs",        SHJOB_TASK_CORE},
+    {"main",        MAIN_TASK_CORE},
+    {"telemetry",   TLM_TASK_CORE},
+    {"stats",       TSTAT_TASK_CORE},
+    {"watch",       WATCH_TASK_CORE},
+    {"menu",        MENU_TASK_CORE},
+    {"display",     DISP_TASK_CORE},
+};
+
+//wave_keywords[] order
+static const WAVE_Shape_t wave_shapes[] = {
+    WAVE_SHAPE_RAMP,
+    WAVE_SHAPE_TRIANGLE,
+    WAVE_SHAPE_SINE,
+};
+
+//led_keywords[] order
+static const LDRV_Effect_Type_t led_effects[] = {
+    LDRV_EFFECT_BLINK,
+    LDRV_EFFECT_BREATHE,
+    LDRV_EFFECT_PULSE,
+    LDRV_EFFECT_COLOR_CYCLE,
+};
+
+static const char * TAG = "SHELL CMD";
+
+/******************************************************************************
+*   Error Check
+*******************************************************************************/
+
+
+/******************************************************************************
+*   Private Functions Definitions
+*******************************************************************************/
+/***************************************************************************//*!
+*  \brief Led effect benchmark.
+*
+*   This function plays the same breathe effect twice: task driven (duty
+*   updated every LED_BENCH_STEP_MS from this task) then hardware chained
+*   (LDRV_StartLedEffect), and prints the task wakeups and the CPU time of
+*   both. The task driven time excludes the context switches.
+*
+*   \param[in]  led_handle          Single pwm led handle.
+*   \param[in]  duration_s          Duration of each run (in s).
+*
+*   \return     0 on success, -1 on error
+*
+*******************************************************************************/
+static int ledBench(LED_Handle_t led_handle, uint32_t duration_s){
+
+    uint32_t nb_steps = (duration_s * 1000) / LED_BENCH_STEP_MS;
+    uint32_t ticks_per_us = esp_rom_get_cpu_ticks_per_us();
+    uint64_t task_cycles = 0;
+    TickType_t last_wake = xTaskGetTickCount();
+
+    LDRV_StopLedEffect(led_handle);
+
+    for(uint32_t i=0; i<nb_steps; i++){
+        vTaskDelayUntil(&last_wake, pdMS_TO_TICKS(LED_BENCH_STEP_MS));
+
+        if(SHJOB_IsCancelled()) return -1;
+
+        uint32_t start_cycles = esp_cpu_get_cycle_count();
+
+        //Triangle: up the first half period, down the second
+        uint32_t phase_ms = (i * LED_BENCH_STEP_MS) % LED_BENCH_PERIOD_MS;
+        uint32_t half_ms = LED_BENCH_PERIOD_MS / 2;
+        uint32_t ramp_ms = (phase_ms < half_ms) ? phase_ms : (LED_BENCH_PERIOD_MS - phase_ms);
+        uint32_t duty = (ramp_ms * LDRV_CFG_MAX_PWM_DUTY) / half_ms;
+
+        if(LDRV_STATUS_OK != LDRV_SetLedSinglePwmDuty(duty, led_handle)){
+            SHCOM_Printf("Single pwm led only\r\n");
+            return -1;
+        }
+
+        task_cycles += esp_cpu_get_cycle_count() - start_cycles;
+    }
+
+    LDRV_Effect_t effect = {
+        .type = LDRV_EFFECT_BREATHE,
+        .color = LDRV_RGB_WHITE,
+        .period_ms = LED_BENCH_PERIOD_MS,
+    };
+
+    if(LDRV_STATUS_OK != LDRV_StartLedEffect(effect, led_handle))  return -1;
+
+    if(!SHJOB_Sleep(duration_s * 1000)){
+        LDRV_StopLedEffect(led_handle);
+        return -1;
+    }
+
+    LDRV_CFG_Sequence_Stats_t stats;
+    LDRV_GetLedEffectStats(led_handle, &stats);
+
+    SHCOM_Printf("task driven: %lu wakeups, %lu us CPU\r\n",
+                 nb_steps, (uint32_t)(task_cycles / ticks_per_us));
+    SHCOM_Printf("hw chained:  0 wakeups, %lu segments, %lu us CPU in ISR (max %lu cycles)\r\n",
+                 stats.nb_segments, (uint32_t)(stats.total_isr_cycles / ticks_per_us),
+                 stats.max_isr_cycles);
+    return 0;
+}
+
+/***************************************************************************//*!
+*  \brief Parse watch fields.
+*
+*   This function converts a comma separated list of field names ("bus,ia")
+*   or "all" to a field mask.
+*
+*   \param[in]  pList               Field list.
+*   \param[out] pField_mask         Field mask.
+*
+*   \return     false if a name is unknown
+*
+*******************************************************************************/
+static bool parseWatchFields(const char *pList, uint32_t *pField_mask){
+
+    uint32_t field_mask = 0;
+
+    if(strcmp(pList, "all") == 0){
+        *pField_mask = WATCH_FIELD_MASK(WATCH_FIELD_INVALID) - 1;
+        return true;
+    }
+
+    while(*pList != '\0'){
+
+        size_t len = strcspn(pList, ",");
+        uint8_t field = 0;
+
+        for(; field<WATCH_FIELD_INVALID; field++){
+
+            const char *pName = WATCH_GetFieldName((WATCH_Field_t)field);
+            if((strlen(pName) == len) && (strncmp(pName, pList, len) == 0))  break;
+        }
+
+        if(field == WATCH_FIELD_INVALID)    return false;
+
+        field_mask |= WATCH_FIELD_MASK(field);
+        pList += len;
+        if(*pList == ',')   pList++;
+    }
+
+    *pField_mask = field_mask;
+
+    return (field_mask != 0);
+}
+
+/***************************************************************************//*!
+*  \brief Print bench result.
+*
+*   This function prints a bench result as a CSV line (empty field: counter
+*   not measured on this platform).
+*
+*******************************************************************************/
+static void printBenchResult(const BENCH_Result_t *pResult){
+
+    const BENCH_CFG_Counters_t *pCounters = &pResult->counters;
+    const struct{
+        uint32_t mask;
+        uint64_t value;
+    }fields[] = {
+        {BENCH_CFG_COUNTER_TIME,            pCounters->time_ns},
+        {BENCH_CFG_COUNTER_CYCLES,          pCounters->cycles},
+        {BENCH_CFG_COUNTER_INSTRUCTIONS,    pCounters->instructions},
+        {BENCH_CFG_COUNTER_ICACHE_MISSES,   pCounters->icache_misses},
+        {BENCH_CFG_COUNTER_DCACHE_MISSES,   pCounters->dcache_misses},
+    };
+    char line[BENCH_LINE_SIZE];
+
+    int len = snprintf(line, sizeof(line), "%s,%lu", pResult->name, pResult->nb_iterations);
+
+    for(uint32_t i=0; (i<ARRAY_SIZE(fields)) && (len > 0) && (len < (int)sizeof(line)); i++){
+        if(pResult->counter_mask & fields[i].mask){
+            len += snprintf(&line[len], sizeof(line) - len, ",%llu", fields[i].value);
+        }else{
+            len += snprintf(&line[len], sizeof(line) - len, ",");
+        }
+    }
+
+    SHCOM_Printf("%s\r\n", line);
+}
+
+/******************************************************************************
+*   CallBack Functions implementation
+*******************************************************************************/
+
+
+/******************************************************************************
+*   Public Functions Definitions
+*******************************************************************************/
+/***************************************************************************//*!
+*  \brief Ripple shell command handler.
+*
+*   This function is the handler of the 'ripple [duty] [nb_samples]' shell
+*   command. Both phases are driven open loop at the specified duty (0.01%)
+*   and the bus voltage ripple is measured with the phases in sync (0°)
+*   and interleaved (180°).
+*
+*   Preconditions: Phases not used (regulator, waveform), no fault latched.
+*
+*   Side Effects: Phases enabled during the measurement.
+*
+*   \param[in]  argc                Number of arguments.
+*   \param[in]  argv                Arguments.
+*
+*   \return     0 on success, -1 on error
+*
+*******************************************************************************/
+int SHCMD_RippleHandler(int argc, char *argv[]){
+
+    SHELL_CFG_Arg_t args[ARRAY_SIZE(ripple_args)];
+    uint16_t prev_shift_deg = PHASE_DEFAULT_SHIFT_DEG;
+    PWR_Ripple_t ripple[RIPPLE_NB_SHIFT] = {0};
+    bool is_success = true;
+
+    if(!SHELL_CFG_ParseArgs(ripple_args, ARRAY_SIZE(ripple_args), argc, argv, args)){
+        SHCOM_Printf("Usage: ripple [duty 0-%u] [nb_samples 1-%u]\r\n", PHASE_DUTY_FULL_SCALE, PWR_RIPPLE_MAX_SAMPLES);
+        return -1;
+    }
+
+    uint32_t duty = (uint32_t)args[0].value;
+    uint32_t nb_samples = (uint32_t)args[1].value;
+
+    if(CREG_GetFault() != CREG_FAULT_NONE){
+        SHCOM_Printf("Fault latched: 0x%02x\r\n", CREG_GetFault());
+        return -1;
+    }
+
+    //Exclusive use of the phases (and of the ADC, not reserved by the regulator)
+    if(PHASE_STATUS_OK != PHASE_Acquire(PHASE_OWNER_OPEN_LOOP)){
+        SHCOM_Printf("Phases in use or tripped, stop the regulator/waveform first\r\n");
+        return -1;
+    }
+
+    PHASE_GetPhaseShift(&prev_shift_deg);
+
+    PHASE_SetDuty(PHASE_ID_A, (uint16_t)duty);
+    PHASE_SetDuty(PHASE_ID_B, (uint16_t)duty);
+    if(PHASE_STATUS_OK != PHASE_SetEnable(true)){
+        is_success = false;
+    }
+
+    for(uint8_t i=0; is_success && (i<RIPPLE_NB_SHIFT); i++){
+
+        PHASE_SetPhaseShift(ripple_shift_deg[i]);
+
+        //Ctrl-C: phases released below
+        if(!SHJOB_Sleep(RIPPLE_SETTLING_MS)){
+            is_success = false;
+            break;
+        }
+
+        if(PWR_MONITORING_STATUS_OK != PWR_MeasureBusRipple(nb_samples, &ripple[i])){
+            ESP_LOGE(TAG, "Failed to measure bus ripple");
+            is_success = false;
+            break;
+        }
+    }
+
+    //Outputs held off by a fault during the measurement
+    if(PHASE_IsTripped())   is_success = false;
+
+    PHASE_Release(PHASE_OWNER_OPEN_LOOP);
+    PHASE_SetPhaseShift(prev_shift_deg);
+
+    if(!is_success){
+        SHCOM_Printf("Ripple measurement failed\r\n");
+        return -1;
+    }
+
+    for(uint8_t i=0; i<RIPPLE_NB_SHIFT; i++){
+        SHCOM_Printf("shift %3u deg: mean %u mV, pk-pk %u mV, rms %u mV\r\n",
+                     ripple_shift_deg[i],
+                     ripple[i].mean_mv,
+                     ripple[i].pk_pk_mv,
+                     ripple[i].rms_mv);
+    }
+
+    if(ripple[0].pk_pk_mv > 0){
+        int32_t reduction = 100 - (((int32_t)ripple[1].pk_pk_mv * 100) / ripple[0].pk_pk_mv);
+        SHCOM_Printf("pk-pk reduction: %ld %%\r\n", reduction);
+    }
+
+    return 0;
+}
+
+/***************************************************************************//*!
+*  \brief Wave shell command handler.
+*
+*   This function is the handler of the 'wave' shell command (duty waveform
+*   playback on both phases):
+*       wave ramp|triangle|sine <period_ms> <min> <max> [cycles] [rate_hz]
+*       wave stream [rate_hz]
+*       wave push <duty> [duty ...]
+*       wave flush
+*       wave stop
+*       wave stat
+*
+*   Pushed samples are queued for playback once a buffer is full, 'wave
+*   flush' queues the last partial buffer (end of stream).
+*
+*   Preconditions: Phases not used (regulator, ripple), no fault latched.
+*
+*   Side Effects: Phases enabled during the playback.
+*
+*   \param[in]  argc                Number of arguments.
+*   \param[in]  argv                Arguments.
+*
+*   \return     0 on success, -1 on error
+*
+*******************************************************************************/
+int SHCMD_WaveHandler(int argc, char *argv[]){
+
+    SHELL_CFG_Arg_t args[ARRAY_SIZE(wave_args)];
+
+    //Sub command only, its arguments are parsed below (push takes a list)
+    if(!SHELL_CFG_ParseArgs(wave_args, ARRAY_SIZE(wave_args), (argc > 2) ? 2 : argc, argv, args)){
+        SHCOM_Printf("Usage: wave ramp|triangle|sine <period_ms> <min> <max> [cycles] [rate_hz]\r\n");
+        SHCOM_Printf("       wave stream [rate_hz] | push <duty> [duty ...] | flush | stop | stat\r\n");
+        return -1;
+    }
+
+    switch(args[0].value){
+
+        //wave ramp|triangle|sine <period_ms> <min> <max> [cycles] [rate_hz]
+        case 0:
+        case 1:
+        case 2:
+        {
+            SHELL_CFG_Arg_t shape_args[ARRAY_SIZE(wave_shape_args)];
+
+            if(!SHELL_CFG_ParseArgs(wave_shape_args, ARRAY_SIZE(wave_shape_args), argc - 1, &argv[1], shape_args)){
+                SHCOM_Printf("Usage: wave %s <period_ms 1-%u> <min 0-%u> <max 0-%u> [cycles] [rate_hz %u-%u]\r\n",
+                             argv[1], WAVE_MAX_SHAPE_PERIOD_MS, PHASE_DUTY_FULL_SCALE, PHASE_DUTY_FULL_SCALE, WAVE_MIN_RATE_HZ, WAVE_MAX_RATE_HZ);
+                return -1;
+            }
+
+            //Playback start: the player takes the phases (refused while used or tripped)
+            if(CREG_GetFault() != CREG_FAULT_NONE){
+                SHCOM_Printf("Fault latched: 0x%02x\r\n", CREG_GetFault());
+                return -1;
+            }
+
+            WAVE_Shape_Config_t config = {
+                .shape = wave_shapes[args[0].value],
+                .period_ms = (uint32_t)shape_args[0].value,
+                .min_duty = (uint16_t)shape_args[1].value,
+                .max_duty = (uint16_t)shape_args[2].value,
+                .nb_periods = (uint32_t)shape_args[3].value,
+            };
+
+            return (WAVE_STATUS_OK == WAVE_StartShape((uint32_t)shape_args[4].value, WAVE_OUTPUT_BOTH, &config)) ? 0 : -1;
+        }
+
+        //wave stream [rate_hz]
+        case 3:
+        {
+            SHELL_CFG_Arg_t stream_args[ARRAY_SIZE(wave_stream_args)];
+
+            if(!SHELL_CFG_ParseArgs(wave_stream_args, ARRAY_SIZE(wave_stream_args), argc - 1, &argv[1], stream_args)){
+                SHCOM_Printf("Usage: wave stream [rate_hz %u-%u]\r\n", WAVE_MIN_RATE_HZ, WAVE_MAX_RATE_HZ);
+                return -1;
+            }
+
+            if(CREG_GetFault() != CREG_FAULT_NONE){
+                SHCOM_Printf("Fault latched: 0x%02x\r\n", CREG_GetFault());
+                return -1;
+            }
+
+            return (WAVE_STATUS_OK == WAVE_Start((uint32_t)stream_args[0].value, WAVE_OUTPUT_BOTH, NULL, NULL)) ? 0 : -1;
+        }
+
+        //wave push <duty> [duty ...]
+        case 4:
+        {
+            uint16_t samples[WAVE_MAX_PUSH_SAMPLES];
+            uint32_t nb_samples = 0;
+            uint32_t nb_written = 0;
+
+            for(int i=2; i<argc; i++){
+
+                SHELL_CFG_Arg_t duty;
+
+                //Each duty checked as the only argument of a two entries argv window
+                if((nb_samples >= WAVE_MAX_PUSH_SAMPLES) ||
+                   !SHELL_CFG_ParseArgs(wave_duty_args, ARRAY_SIZE(wave_duty_args), 2, &argv[i - 1], &duty)){
+                    nb_samples = 0;
+                    break;
+                }
+                samples[nb_samples++] = (uint16_t)duty.value;
+            }
+
+            if(nb_samples == 0){
+                SHCOM_Printf("Usage: wave push <duty 0-%u> [duty ...] (up to %u)\r\n",
+                             PHASE_DUTY_FULL_SCALE, WAVE_MAX_PUSH_SAMPLES);
+                return -1;
+            }
+
+            //Queued once a buffer is full, a flush per push would underrun
+            if(WAVE_STATUS_OK != WAVE_Write(samples, nb_samples, &nb_written)){
+                SHCOM_Printf("Streaming playback not running\r\n");
+                return -1;
+            }
+
+            if(nb_written < nb_samples){
+                SHCOM_Printf("Buffers full: %lu / %lu samples written\r\n", nb_written, nb_samples);
+            }
+            return 0;
+        }
+
+        //wave flush
+        case 5:
+        {
+            if(WAVE_STATUS_OK != WAVE_Flush()){
+                SHCOM_Printf("Streaming playback not running\r\n");
+                return -1;
+            }
+            return 0;
+        }
+
+        //wave stop
+        case 6:
+        {
+            WAVE_Stop();
+            return 0;
+        }
+
+        //wave stat
+        default:
+        {
+            WAVE_Stats_t stats;
+            WAVE_GetStats(&stats);
+            SHCOM_Printf("%s%s, %lu Hz: %lu samples, %lu refills, %lu underruns (%lu missed)\r\n",
+                         stats.is_running ? "running" : "stopped",
+                         stats.is_tripped ? " (tripped)" : (stats.is_finished ? " (finished)" : ""),
+                         stats.rate_hz, stats.nb_samples, stats.nb_refills,
+                         stats.nb_underruns, stats.nb_missed);
+            return 0;
+        }
+    }
+}
+
+/***************************************************************************//*!
+*  \brief Display shell command handler.
+*
+*   This function is the handler of the 'disp' shell command:
+*       disp stat
+*       disp text <line> <text>
+*       disp clear
+*   Text and clear are flushed right away, the statistics show the bytes
+*   sent and the flush time of the latest frame.
+*
+*   Preconditions: Display initialized.
+*
+*   Side Effects: None.
+*
+*   \param[in]  argc                Number of arguments.
+*   \param[in]  argv                Arguments.
+*
+*   \return     0 on success, -1 on error
+*
+*******************************************************************************/
+int SHCMD_DispHandler(int argc, char *argv[]){
+
+    SHELL_CFG_Arg_t args[ARRAY_SIZE(disp_args)];
+
+    if(!SHELL_CFG_ParseArgs(disp_args, ARRAY_SIZE(disp_args), argc, argv, args)){
+        SHCOM_Printf("Usage: disp stat | text <line> <text> | clear\r\n");
+        return -1;
+    }
+
+    switch(args[0].value){
+
+        //disp stat
+        case 0:
+        {
+            DISP_Stats_t stats;
+            DISP_GetStats(&stats);
+            SHCOM_Printf("%lu frames (%lu skipped), last %lu bytes in %lu windows, %lu us\r\n",
+                         stats.nb_refresh, stats.nb_skipped, stats.last_bytes,
+                         stats.last_windows, stats.last_frame_us);
+            SHCOM_Printf("max %lu bytes, %lu us, total %llu bytes\r\n",
+                         stats.max_bytes, stats.max_frame_us, stats.total_bytes);
+            return 0;
+        }
+
+        //disp text <line> <text>
+        case 1:
+        {
+            SHELL_CFG_Arg_t text_args[ARRAY_SIZE(disp_text_args)];
+
+            if(!SHELL_CFG_ParseArgs(disp_text_args, ARRAY_SIZE(disp_text_args), argc - 1, &argv[1], text_args)){
+                SHCOM_Printf("Usage: disp text <line 0-%u> <text>\r\n", DISP_NB_PAGES - 1);
+                return -1;
+            }
+
+            if(DISP_STATUS_OK != DISP_DrawText(0, (uint32_t)text_args[0].value * DISP_PAGE_HEIGHT,
+                                               text_args[1].pString, DISP_COLOR_WHITE)){
+                return -1;
+            }
+            return (DISP_STATUS_OK == DISP_Refresh()) ? 0 : -1;
+        }
+
+        //disp clear
+        default:
+        {
+            if(DISP_STATUS_OK != DISP_Clear())  return -1;
+            return (DISP_STATUS_OK == DISP_Refresh()) ? 0 : -1;
+        }
+    }
+}
+
+/***************************************************************************//*!
+*  \brief Led shell command handler.
+*
+*   This function is the handler of the 'led' shell command (status led):
+*       led blink|breathe <period_ms> [duty]
+*       led pulse <nb_pulses> <period_ms> [duty]
+*       led cycle <period_ms>
+*       led stop
+*       led stat
+*       led bench [seconds]
+*   Effects are played by the LEDC hardware, chained from the fade end
+*   interrupt. The bench compares them with a task driven breathe.
+*
+*   Preconditions: UI initialized.
+*
+*   Side Effects: Bench blocks the shell for twice the duration.
+*
+*   \param[in]  argc                Number of arguments.
+*   \param[in]  argv                Arguments.
+*
+*   \return     0 on success, -1 on error
+*
+*******************************************************************************/
+int SHCMD_LedHandler(int argc, char *argv[]){
+
+    SHELL_CFG_Arg_t args[ARRAY_SIZE(led_args)];
+    LED_Handle_t led_handle = 0;
+
+    if(!SHELL_CFG_ParseArgs(led_args, ARRAY_SIZE(led_args), argc, argv, args)){
+        SHCOM_Printf("Usage: led blink|breathe <period_ms> [duty] | pulse <nb> <period_ms> [duty]\r\n");
+        SHCOM_Printf("       led cycle <period_ms> | stop | stat | bench [seconds]\r\n");
+        return -1;
+    }
+
+    if(UI_STATUS_OK != UI_GetStatusLed(&led_handle)){
+        SHCOM_Printf("Status led not initialized\r\n");
+        return -1;
+    }
+
+    switch(args[0].value){
+
+        //led blink|breathe|cycle <period_ms> [duty] | led pulse <nb> <period_ms> [duty]
+        case 0:
+        case 1:
+        case 2:
+        case 3:
+        {
+            bool is_pulse = (led_effects[args[0].value] == LDRV_EFFECT_PULSE);
+            SHELL_CFG_Arg_t effect_args[ARRAY_SIZE(led_pulse_args)];
+
+            //Pulse count comes first
+            bool is_valid = is_pulse ?
+                            SHELL_CFG_ParseArgs(led_pulse_args, ARRAY_SIZE(led_pulse_args), argc - 1, &argv[1], effect_args) :
+                            SHELL_CFG_ParseArgs(led_effect_args, ARRAY_SIZE(led_effect_args), argc - 1, &argv[1], &effect_args[1]);
+            if(!is_valid){
+                if(is_pulse){
+                    SHCOM_Printf("Usage: led pulse <nb 1-%u> <period_ms> [duty 0-%u]\r\n",
+                                 LDRV_EFFECT_MAX_NB_PULSES, LDRV_CFG_MAX_PWM_DUTY);
+                }else{
+                    SHCOM_Printf("Usage: led %s <period_ms> [duty 0-%u]\r\n", argv[1], LDRV_CFG_MAX_PWM_DUTY);
+                }
+                return -1;
+            }
+
+            uint32_t duty = (uint32_t)effect_args[2].value;
+            LDRV_Effect_t effect = {
+                .type = led_effects[args[0].value],
+                .color = (LDRV_Color_t){.red_duty = duty, .green_duty = duty, .blue_duty = duty},
+                .period_ms = (uint32_t)effect_args[1].value,
+                .nb_pulses = is_pulse ? (uint8_t)effect_args[0].value : 0,
+            };
+
+            return (LDRV_STATUS_OK == LDRV_StartLedEffect(effect, led_handle)) ? 0 : -1;
+        }
+
+        //led stop
+        case 4:
+        {
+            return (LDRV_STATUS_OK == LDRV_StopLedEffect(led_handle)) ? 0 : -1;
+        }
+
+        //led stat
+        case 5:
+        {
+            LDRV_CFG_Sequence_Stats_t stats;
+            LDRV_GetLedEffectStats(led_handle, &stats);
+            SHCOM_Printf("%s: %lu segments, %lu loops, %lu errors\r\n",
+                         stats.is_running ? "running" : "stopped",
+                         stats.nb_segments, stats.nb_loops, stats.nb_errors);
+            SHCOM_Printf("ISR %llu cycles total, max %lu cycles\r\n",
+                         stats.total_isr_cycles, stats.max_isr_cycles);
+            return 0;
+        }
+
+        //led bench [seconds]
+        default:
+        {
+            SHELL_CFG_Arg_t bench_args[ARRAY_SIZE(led_bench_args)];
+
+            if(!SHELL_CFG_ParseArgs(led_bench_args, ARRAY_SIZE(led_bench_args), argc - 1, &argv[1], bench_args)){
+                SHCOM_Printf("Usage: led bench [seconds 1-%u]\r\n", LED_BENCH_MAX_S);
+                return -1;
+            }
+            return ledBench(led_handle, (uint32_t)bench_args[0].value);
+        }
+    }
+}
+
+/***************************************************************************//*!
+*  \brief Com shell command handler.
+*
+*   This function is the handler of the 'com' shell command (shell port
+*   receive and transmit paths):
+*       com stat
+*       com reset
+*
+*   Preconditions: None.
+*
+*   Side Effects: None.
+*
+*   \param[in]  argc                Number of arguments.
+*   \param[in]  argv                Arguments.
+*
+*   \return     0 on success, -1 on error
+*
+*******************************************************************************/
+int SHCMD_ComHandler(int argc, char *argv[]){
+
+    SHELL_CFG_Arg_t args[ARRAY_SIZE(com_args)];
+
+    if(!SHELL_CFG_ParseArgs(com_args, ARRAY_SIZE(com_args), argc, argv, args)){
+        SHCOM_Printf("Usage: com stat|reset\r\n");
+        return -1;
+    }
+
+    //com reset
+    if(args[0].value == 1){
+        return (SHCOM_STATUS_OK == SHCOM_ResetStats()) ? 0 : -1;
+    }
+
+    //com stat
+    {
+        SHCOM_Stats_t stats;
+        SHCOM_GetStats(&stats);
+
+        uint32_t elapsed_ms = (uint32_t)(stats.elapsed_us / 1000);
+        uint32_t busy_us = (uint32_t)(stats.busy_cycles / esp_rom_get_cpu_ticks_per_us());
+        if(elapsed_ms == 0) elapsed_ms = 1;
+
+        SHCOM_Printf("%lu lines, %lu bytes, %lu wakeups, %lu overflows in %lu ms\r\n",
+                     stats.nb_lines, stats.nb_bytes, stats.nb_wakeups, stats.nb_overflows, elapsed_ms);
+        SHCOM_Printf("%lu lines/s, listener CPU %lu us (%lu.%02lu %%)\r\n",
+                     (uint32_t)(((uint64_t)stats.nb_lines * 1000) / elapsed_ms), busy_us,
+                     (busy_us / 10) / elapsed_ms, ((busy_us / 10) % elapsed_ms) * 100 / elapsed_ms);
+        SHCOM_Printf("tx: %lu records, %lu bytes, %lu dropped, %lu pending\r\n",
+                     stats.nb_tx_records, stats.nb_tx_bytes, stats.nb_tx_dropped, stats.tx_pending);
+
+        SHCOM_TransportStats_t *pTransport = &stats.transport;
+        uint32_t isr_us = (uint32_t)(pTransport->isr_cycles / esp_rom_get_cpu_ticks_per_us());
+
+        SHCOM_Printf("%s rx: %lu B/s, %lu queued, %lu dropped\r\n", stats.pTransport,
+                     (uint32_t)((pTransport->nb_rx_bytes * 1000) / elapsed_ms),
+                     pTransport->rx_queued, pTransport->nb_rx_dropped);
+        SHCOM_Printf("%s tx: %lu B/s, %lu queued, %lu dropped\r\n", stats.pTransport,
+                     (uint32_t)((pTransport->nb_tx_bytes * 1000) / elapsed_ms),
+                     pTransport->tx_queued, pTransport->nb_tx_dropped);
+        SHCOM_Printf("%s isr: %lu (%lu/s), CPU %lu us (%lu.%02lu %%)\r\n", stats.pTransport,
+                     pTransport->nb_isr, (uint32_t)(((uint64_t)pTransport->nb_isr * 1000) / elapsed_ms), isr_us,
+                     (isr_us / 10) / elapsed_ms, ((isr_us / 10) % elapsed_ms) * 100 / elapsed_ms);
+        return 0;
+    }
+}
+
+/***************************************************************************//*!
+*  \brief Telemetry shell command handler.
+*
+*   This function is the handler of the 'tlm' shell command (binary
+*   telemetry stream on the shell port):
+*       tlm on|off
+*       tlm rate power|reg|fault|tasks <period_ms> (0 -> off)
+*       tlm adc <freq_hz> [divider]
+*       tlm adc off
+*       tlm stat
+*
+*   Preconditions: Telemetry initialized.
+*
+*   Side Effects: None.
+*
+*   \param[in]  argc                Number of arguments.
+*   \param[in]  argv                Arguments.
+*
+*   \return     0 on success, -1 on error
+*
+*******************************************************************************/
+int SHCMD_TlmHandler(int argc, char *argv[]){
+
+    SHELL_CFG_Arg_t args[ARRAY_SIZE(tlm_args)];
+
+    if(!SHELL_CFG_ParseArgs(tlm_args, ARRAY_SIZE(tlm_args), argc, argv, args)){
+        SHCOM_Printf("Usage: tlm on|off | rate power|reg|fault|tasks <period_ms> | adc <freq_hz> [divider] | adc off | stat\r\n");
+        return -1;
+    }
+
+    switch(args[0].value){
+
+        //tlm on|off
+        case 0:
+        case 1:
+        {
+            return (TLM_STATUS_OK == TLM_SetEnable(args[0].value == 0)) ? 0 : -1;
+        }
+
+        //tlm rate <channel> <period_ms>
+        case 2:
+        {
+            SHELL_CFG_Arg_t rate_args[ARRAY_SIZE(tlm_rate_args)];
+
+            if(!SHELL_CFG_ParseArgs(tlm_rate_args, ARRAY_SIZE(tlm_rate_args), argc - 1, &argv[1], rate_args) ||
+               (TLM_STATUS_OK != TLM_SetChannelPeriod((TLM_Channel_t)rate_args[0].value, (uint32_t)rate_args[1].value))){
+
+                SHCOM_Printf("Usage: tlm rate power|reg|fault|tasks <0 | %u-%u ms>\r\n", TLM_MIN_PERIOD_MS, TLM_MAX_PERIOD_MS);
+                return -1;
+            }
+            return 0;
+        }
+
+        //tlm adc <freq_hz> [divider] | tlm adc off
+        case 3:
+        {
+            SHELL_CFG_Arg_t adc_args[ARRAY_SIZE(tlm_adc_args)];
+            SHELL_CFG_Arg_t off_args[ARRAY_SIZE(tlm_adc_off_args)];
+
+            if(SHELL_CFG_ParseArgs(tlm_adc_off_args, ARRAY_SIZE(tlm_adc_off_args), argc - 1, &argv[1], off_args)){
+                return (TLM_STATUS_OK == TLM_StopAdcStream()) ? 0 : -1;
+            }
+
+            if(!SHELL_CFG_ParseArgs(tlm_adc_args, ARRAY_SIZE(tlm_adc_args), argc - 1, &argv[1], adc_args)){
+                SHCOM_Printf("Usage: tlm adc <freq_hz> [divider 1-%u] | tlm adc off\r\n", TLM_ADC_MAX_DIVIDER);
+                return -1;
+            }
+
+            if(TLM_STATUS_OK != TLM_StartAdcStream((uint32_t)adc_args[0].value, (uint32_t)adc_args[1].value)){
+                SHCOM_Printf("Failed to start the ADC stream (regulator running?)\r\n");
+                return -1;
+            }
+            return 0;
+        }
+
+        //tlm stat
+        default:
+        {
+            TLM_Stats_t stats;
+            TLM_GetStats(&stats);
+
+            SHCOM_Printf("%s: %lu frames, %lu bytes, %lu dropped\r\n", stats.is_enabled ? "on" : "off",
+                         stats.nb_frames, stats.nb_bytes, stats.nb_dropped);
+            SHCOM_Printf("adc: %lu frames, %lu overruns, task CPU %lu us\r\n",
+                         stats.nb_adc_frames, stats.nb_adc_overruns,
+                         (uint32_t)(stats.busy_cycles / esp_rom_get_cpu_ticks_per_us()));
+            return 0;
+        }
+    }
+}
+
+/***************************************************************************//*!
+*  \brief Format shell command handler.
+*
+*   This function is the handler of the 'fmt' shell command:
+*       fmt bench [nb_rounds]
+*   The bench formats a status line with snprintf() and with the textFormat
+*   functions: cycles per line and stack use.
+*
+*   Preconditions: None.
+*
+*   Side Effects: Bench blocks the shell (interrupts enabled).
+*
+*   \param[in]  argc                Number of arguments.
+*   \param[in]  argv                Arguments.
+*
+*   \return     0 on success, -1 on error
+*
+*******************************************************************************/
+int SHCMD_FmtHandler(int argc, char *argv[]){
+
+    SHELL_CFG_Arg_t args[ARRAY_SIZE(fmt_args)];
+    FBENCH_Result_t bench;
+
+    if(!SHELL_CFG_ParseArgs(fmt_args, ARRAY_SIZE(fmt_args), argc, argv, args)){
+        SHCOM_Printf("Usage: fmt bench [nb_rounds 1-%u]\r\n", FBENCH_MAX_ROUNDS);
+        return -1;
+    }
+
+    if(FBENCH_STATUS_OK != FBENCH_Run((uint32_t)args[1].value, &bench)){
+        SHCOM_Printf("Bench failed\r\n");
+        return -1;
+    }
+
+    uint32_t ticks_per_us = esp_rom_get_cpu_ticks_per_us();
+
+    SHCOM_Printf("%lu lines of %lu chars%s\r\n", bench.nb_lines, bench.line_len,
+                 bench.is_match ? "" : " (output mismatch)");
+    SHCOM_Printf("snprintf: avg %lu cycles, max %lu cycles (%lu us), stack %lu bytes\r\n",
+                 bench.printf_avg_cycles, bench.printf_max_cycles, bench.printf_max_cycles / ticks_per_us,
+                 bench.printf_stack);
+    SHCOM_Printf("fmt:      avg %lu cycles, max %lu cycles (%lu us), stack %lu bytes\r\n",
+                 bench.fmt_avg_cycles, bench.fmt_max_cycles, bench.fmt_max_cycles / ticks_per_us,
+                 bench.fmt_stack);
+
+    return bench.is_match ? 0 : -1;
+}
+
+/***************************************************************************//*!
+*  \brief Watch shell command handler.
+*
+*   This function is the handler of the 'watch' shell command:
+*       watch <fields|all> [rate_hz]
+*       watch stop
+*       watch stat
+*   Fields are comma separated: bus, ia, ib (bus voltage, phase currents),
+*   ta, tb, tl (phase and load temperatures), da, db (phase duty).
+*
+*   Preconditions: Watch initialized.
+*
+*   Side Effects: None.
+*
+*   \param[in]  argc                Number of arguments.
+*   \param[in]  argv                Arguments.
+*
+*   \return     0 on success, -1 on error
+*
+*******************************************************************************/
+int SHCMD_WatchHandler(int argc, char *argv[]){
+
+    SHELL_CFG_Arg_t cmd_args[ARRAY_SIZE(watch_cmd_args)];
+    SHELL_CFG_Arg_t args[ARRAY_SIZE(watch_args)];
+    uint32_t field_mask = 0;
+
+    if(SHELL_CFG_ParseArgs(watch_cmd_args, ARRAY_SIZE(watch_cmd_args), argc, argv, cmd_args)){
+
+        //watch stop
+        if(cmd_args[0].value == 0){
+            return (WATCH_STATUS_OK == WATCH_Stop()) ? 0 : -1;
+        }
+
+        //watch stat
+        WATCH_Stats_t stats;
+        WATCH_GetStats(&stats);
+
+        SHCOM_Printf("%s: %lu Hz, divider %lu, %lu lines, %lu skipped, %lu dropped, %lu stale\r\n",
+                     stats.is_running ? "on" : "off", stats.rate_hz, stats.divider,
+                     stats.nb_lines, stats.nb_skipped, stats.nb_dropped, stats.nb_stale);
+        SHCOM_Printf("output ring max %lu bytes, task CPU %lu us\r\n", stats.max_tx_pending,
+                     (uint32_t)(stats.busy_cycles / esp_rom_get_cpu_ticks_per_us()));
+        return 0;
+    }
+
+    //watch <fields|all> [rate_hz]
+    if(!SHELL_CFG_ParseArgs(watch_args, ARRAY_SIZE(watch_args), argc, argv, args)){
+        SHCOM_Printf("Usage: watch <bus,ia,ib,ta,tb,tl,da,db|all> [rate_hz %u-%u] | stop | stat\r\n",
+                     WATCH_MIN_RATE_HZ, WATCH_MAX_RATE_HZ);
+        return -1;
+    }
+
+    if(!parseWatchFields(args[0].pString, &field_mask)){
+        SHCOM_Printf("Unknown field (bus,ia,ib,ta,tb,tl,da,db|all)\r\n");
+        return -1;
+    }
+
+    return (WATCH_STATUS_OK == WATCH_Start(field_mask, (uint32_t)args[1].value)) ? 0 : -1;
+}
+
+/***************************************************************************//*!
+*  \brief Job shell command handler.
+*
+*   This function is the handler of the 'job' shell command (commands run
+*   on the shell workers, '<command> ... &' in background):
+*       job [list]
+*       job kill <id>
+*       job stat
+*       job reset
+*   Ctrl-C cancels the foreground jobs.
+*
+*   Preconditions: Shell jobs initialized.
+*
+*   Side Effects: None.
+*
+*   \param[in]  argc                Number of arguments.
+*   \param[in]  argv                Arguments.
+*
+*   \return     0 on success, -1 on error
+*
+*******************************************************************************/
+int SHCMD_JobHandler(int argc, char *argv[]){
+
+    SHELL_CFG_Arg_t args[ARRAY_SIZE(job_args)];
+
+    if(!SHELL_CFG_ParseArgs(job_args, ARRAY_SIZE(job_args), argc, argv, args)){
+        SHCOM_Printf("Usage: job [list] | kill <id> | stat | reset\r\n");
+        return -1;
+    }
+
+    switch(args[0].value){
+
+        //job [list]
+        case 0:
+        {
+            SHJOB_Info_t jobs[SHJOB_MAX_JOBS];
+            uint32_t nb_jobs = SHJOB_GetJobs(jobs);
+
+            for(uint32_t i=0; i<nb_jobs; i++){
+                SHCOM_Printf("[%lu] %-8s %-10s %s %lu ms%s\r\n", jobs[i].id, job_state_names[jobs[i].state],
+                             jobs[i].command, jobs[i].is_background ? "bg" : "fg", jobs[i].elapsed_ms,
+                             jobs[i].is_cancelled ? " (cancelling)" : "");
+            }
+            if(nb_jobs == 0)    SHCOM_Printf("No job\r\n");
+            return 0;
+        }
+
+        //job kill <id>
+        case 1:
+        {
+            if(!args[1].is_set || (SHJOB_STATUS_OK != SHJOB_Cancel((uint32_t)args[1].value))){
+                SHCOM_Printf("Usage: job kill <id> (see job list)\r\n");
+                return -1;
+            }
+            return 0;
+        }
+
+        //job stat
+        case 2:
+        {
+            SHJOB_Command_Stats_t stats[SHJOB_MAX_COMMAND_STATS];
+            uint32_t nb_stats = SHJOB_GetCommandStats(stats);
+
+            for(uint32_t i=0; i<nb_stats; i++){
+                SHCOM_Printf("%-10s %lu runs, avg %lu us, max %lu us, %lu errors, %lu cancelled\r\n",
+                             stats[i].command, stats[i].nb_runs,
+                             (uint32_t)(stats[i].total_us / stats[i].nb_runs), stats[i].max_us,
+                             stats[i].nb_errors, stats[i].nb_cancelled);
+            }
+            if(nb_stats == 0)   SHCOM_Printf("No job run\r\n");
+            return 0;
+        }
+
+        //job reset
+        default:
+        {
+            SHJOB_ResetCommandStats();
+            return 0;
+        }
+    }
+}
+
+/***************************************************************************//*!
+*  \brief Core shell command handler.
+*
+*   This function is the handler of the 'core' shell command:
+*       core [plan]
+*       core bench [duration_ms]
+*   The bench measures the timer interrupt to task latency with the probe
+*   pinned to the control core, then floating, under an I/O core load.
+*
+*   Preconditions: None.
+*
+*   Side Effects: Bench blocks the shell 2 x duration_ms.
+*
+*   \param[in]  argc                Number of arguments.
+*   \param[in]  argv                Arguments.
+*
+*   \return     0 on success, -1 on error
+*
+*******************************************************************************/
+int SHCMD_CoreHandler(int argc, char *argv[]){
+
+    SHELL_CFG_Arg_t args[ARRAY_SIZE(core_args)];
+    CORE_Bench_t bench;
+
+    if(!SHELL_CFG_ParseArgs(core_args, ARRAY_SIZE(core_args), argc, argv, args)){
+        SHCOM_Printf("Usage: core [plan] | bench [duration_ms %u-%u]\r\n",
+                     CORE_BENCH_MIN_DURATION_MS, CORE_BENCH_MAX_DURATION_MS);
+        return -1;
+    }
+
+    //core [plan]
+    if(args[0].value == 0){
+        for(uint32_t i=0; i<ARRAY_SIZE(core_plan); i++){
+            if(core_plan[i].core_id == tskNO_AFFINITY)  SHCOM_Printf("%-10s any\r\n", core_plan[i].name);
+            else                                        SHCOM_Printf("%-10s %d\r\n", core_plan[i].name, core_plan[i].core_id);
+        }
+        return 0;
+    }
+
+    //core bench [duration_ms]
+    if(CORE_STATUS_OK != CORE_BenchLatency((uint32_t)args[1].value, &bench)){
+        SHCOM_Printf("Bench failed\r\n");
+        return -1;
+    }
+
+    const CORE_Latency_t *pRuns[] = {&bench.pinned, &bench.floating};
+    const char * const run_names[] = {"pinned", "floating"};
+    for(uint32_t i=0; i<ARRAY_SIZE(pRuns); i++){
+        SHCOM_Printf("%-8s %lu wakeups, min %lu ns, avg %lu ns, p99 %lu ns, max %lu ns, %lu missed\r\n",
+                     run_names[i], pRuns[i]->nb_samples, pRuns[i]->min_ns, pRuns[i]->avg_ns,
+                     pRuns[i]->p99_ns, pRuns[i]->max_ns, pRuns[i]->nb_missed);
+    }
+
+    return 0;
+}
+
+/***************************************************************************//*!
+*  \brief Tasks shell command handler.
+*
+*   This function is the handler of the 'tasks' shell command (statistics
+*   of the last window):
+*       tasks [list]
+*       tasks reset
+*   Per task: core, priority, CPU share of one core, stack left, wakeups
+*   per second and maximum scheduling latency (tasks with probes).
+*
+*   Preconditions: Task statistics initialized.
+*
+*   Side Effects: None.
+*
+*   \param[in]  argc                Number of arguments.
+*   \param[in]  argv                Arguments.
+*
+*   \return     0 on success, -1 on error
+*
+*******************************************************************************/
+int SHCMD_TasksHandler(int argc, char *argv[]){
+
+    SHELL_CFG_Arg_t args[ARRAY_SIZE(tasks_args)];
+    TSTAT_Task_Stats_t stats[TSTAT_MAX_TASKS];
+    TSTAT_Summary_t summary = {0};
+
+    if(!SHELL_CFG_ParseArgs(tasks_args, ARRAY_SIZE(tasks_args), argc, argv, args)){
+        SHCOM_Printf("Usage: tasks [list] | reset\r\n");
+        return -1;
+    }
+
+    //tasks reset
+    if(args[0].value == 1){
+        TSTAT_ResetPeaks();
+        return 0;
+    }
+
+    //tasks [list]
+    uint32_t nb_tasks = TSTAT_GetTasks(stats, &summary);
+
+    if(summary.nb_windows == 0){
+        SHCOM_Printf("No statistics yet\r\n");
+        return -1;
+    }
+
+    SHCOM_Printf("window %lu ms, sampling %lu us, %lu tasks, %lu overflows\r\n",
+                 summary.window_ms, summary.sample_us, nb_tasks, summary.nb_overflows);
+    for(uint32_t core=0; core<configNUMBER_OF_CORES; core++){
+        SHCOM_Printf("core %lu load %lu.%lu %%\r\n", core,
+                     summary.load_permille[core] / 10, summary.load_permille[core] % 10);
+    }
+
+    SHCOM_Printf("%-16s core prio  cpu %%  stack  wake/s  max lat us\r\n", "task");
+    for(uint32_t i=0; i<nb_tasks; i++){
+
+        const TSTAT_Task_Stats_t *pStats = &stats[i];
+        char core[4] = "any";
+
+        if(pStats->core_id != tskNO_AFFINITY){
+            core[0] = (char)('0' + pStats->core_id);
+            core[1] = '\0';
+        }
+
+        if(pStats->is_probed){
+            SHCOM_Printf("%-16s %4s %4u %4lu.%lu %6lu %7lu %11lu\r\n", pStats->name, core, pStats->priority,
+                         pStats->cpu_permille / 10, pStats->cpu_permille % 10, pStats->stack_free,
+                         pStats->wakeups_per_s, pStats->max_latency_us);
+        }else{
+            SHCOM_Printf("%-16s %4s %4u %4lu.%lu %6lu %7s %11s\r\n", pStats->name, core, pStats->priority,
+                         pStats->cpu_permille / 10, pStats->cpu_permille % 10, pStats->stack_free, "-", "-");
+        }
+    }
+
+    return 0;
+}
+
+/***************************************************************************//*!
+*  \brief Trace shell command handler.
+*
+*   This function is the handler of the 'trace' shell command (trace points
+*   of the sensing and control paths):
+*       trace start [ring|once]
+*       trace stop
+*       trace dump
+*       trace stat
+*   The dump stops the trace and prints one CSV line per record, oldest
+*   first: time_us,core,event,type,arg.
+*
+*   Preconditions: None.
+*
+*   Side Effects: None.
+*
+*   \param[in]  argc                Number of arguments.
+*   \param[in]  argv                Arguments.
+*
+*   \return     0 on success, -1 on error
+*
+*******************************************************************************/
+int SHCMD_TraceHandler(int argc, char *argv[]){
+
+    SHELL_CFG_Arg_t args[ARRAY_SIZE(trace_args)];
+    TRACE_Stats_t stats = {0};
+    TRACE_Record_t record;
+
+    if(!SHELL_CFG_ParseArgs(trace_args, ARRAY_SIZE(trace_args), argc, argv, args)){
+        SHCOM_Printf("Usage: trace start [ring|once] | stop | dump | stat\r\n");
+        return -1;
+    }
+
+    if(!TRACE_IS_ENABLED){
+        SHCOM_Printf("Trace disabled (TRACE_ENABLE)\r\n");
+        return -1;
+    }
+
+    switch(args[0].value){
+
+        //trace start [ring|once]
+        case 0:
+            if(TRACE_STATUS_OK != TRACE_Start((TRACE_Mode_t)args[1].value))  return -1;
+            break;
+
+        //trace stop
+        case 1:
+            TRACE_Stop();
+            break;
+
+        //trace dump
+        case 2:
+        {
+            TRACE_Stop();
+            TRACE_GetStats(&stats);
+
+            SHCOM_Printf("# %lu records, %lu kept\r\n", stats.nb_records, stats.nb_kept);
+            SHCOM_Printf("time_us,core,event,type,arg\r\n");
+
+            for(uint32_t i=0; TRACE_STATUS_OK == TRACE_GetRecord(i, &record); i++){
+
+                //Paced: output dropped when the ring is full, Ctrl-C between lines
+                while(SHCOM_GetTxPending() > TRACE_DUMP_MAX_TX_PENDING){
+                    if(!SHJOB_Sleep(TRACE_DUMP_WAIT_MS))    return -1;
+                }
+
+                uint8_t type = TRACE_RECORD_TYPE(&record);
+                SHCOM_Printf("%lu,%u,%s,%s,%u\r\n", record.time_us, TRACE_RECORD_CORE(&record),
+                             TRACE_GetEventName(record.event),
+                             (type < TRACE_TYPE_INVALID) ? trace_type_names[type] : "?", record.arg);
+            }
+            break;
+        }
+
+        //trace stat
+        default:
+            TRACE_GetStats(&stats);
+            SHCOM_Printf("%s, mode %s, %lu records, %lu kept (%u max)\r\n",
+                         stats.is_running ? "running" : "stopped", trace_mode_keywords[stats.mode],
+                         stats.nb_records, stats.nb_kept, TRACE_BUFFER_SIZE);
+            break;
+    }
+
+    return 0;
+}
+
+/***************************************************************************//*!
+*  \brief Bench shell command handler.
+*
+*   This function is the handler of the 'bench' shell command (kernel
+*   micro-benchmarks):
+*       bench [list]
+*       bench run [kernel|all] [nb_iterations]
+*   One CSV line per kernel: totals of the iterations (call overhead
+*   removed), empty fields for the counters not measured on this platform.
+*
+*   Preconditions: Called from a task pinned to a core (job worker).
+*
+*   Side Effects: None.
+*
+*   \param[in]  argc                Number of arguments.
+*   \param[in]  argv                Arguments.
+*
+*   \return     0 on success, -1 on error
+*
+*******************************************************************************/
+int SHCMD_BenchHandler(int argc, char *argv[]){
+
+    SHELL_CFG_Arg_t args[ARRAY_SIZE(bench_args)];
+    BENCH_Result_t result;
+    uint32_t first = 0;
+    uint32_t last = BENCH_GetNbKernels();
+
+    if(!SHELL_CFG_ParseArgs(bench_args, ARRAY_SIZE(bench_args), argc, argv, args)){
+        SHCOM_Printf("Usage: bench [list] | run [kernel|all] [nb_iterations 1-%u]\r\n", BENCH_MAX_ITERATIONS);
+        return -1;
+    }
+
+    //bench [list]
+    if(args[0].value == 0){
+        for(uint32_t i=0; i<BENCH_GetNbKernels(); i++){
+            SHCOM_Printf("%s\r\n", BENCH_GetKernelName(i));
+        }
+        return 0;
+    }
+
+    //bench run [kernel|all] [nb_iterations]
+    if(args[1].is_set && (strcmp(args[1].pString, "all") != 0)){
+        if(BENCH_STATUS_OK != BENCH_FindKernel(args[1].pString, &first)){
+            SHCOM_Printf("Unknown kernel %s\r\n", args[1].pString);
+            return -1;
+        }
+        last = first + 1;
+    }
+
+    SHCOM_Printf("kernel,iterations,time_ns,cycles,instructions,icache_misses,dcache_misses\r\n");
+
+    for(uint32_t i=first; i<last; i++){
+
+        if(SHJOB_IsCancelled()) return -1;
+
+        if(BENCH_STATUS_OK != BENCH_Run(i, (uint32_t)args[2].value, &result)){
+            SHCOM_Printf("# %s failed\r\n", BENCH_GetKernelName(i));
+            return -1;
+        }
+
+        printBenchResult(&result);
+    }
+
+    return 0;
+}
+
+/******************************************************************************
+*   Interrupts
+*******************************************************************************/
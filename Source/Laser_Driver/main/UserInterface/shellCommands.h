@@ -0,0 +1,325 @@
+#ifndef __SHELL_COMMANDS_H
+#define __SHELL_COMMANDS_H
+
+#include <stdint.h>
+
+/******************************************************************************
+*   Public Definitions
+*******************************************************************************/
+
+
+/******************************************************************************
+*   Public Macros
+*******************************************************************************/
+
+
+/******************************************************************************
+*   Public Data Types
+*******************************************************************************/
+
+
+/******************************************************************************
+*   Public Variables
+*******************************************************************************/
+
+
+/******************************************************************************
+*   Error Check
+*******************************************************************************/
+
+
+/******************************************************************************
+*   Public Functions Declarations
+*******************************************************************************/
+/***************************************************************************//*!
+*  \brief Ripple shell command handler.
+*
+*   This function is the handler of the 'ripple [duty] [nb_samples]' shell
+*   command. Both phases are driven open loop at the specified duty (0.01%)
+*   and the bus voltage ripple is measured with the phases in sync (0°)
+*   and interleaved (180°).
+*
+*   Preconditions: Phases not used (regulator, waveform), no fault latched.
+*
+*   Side Effects: Phases enabled during the measurement.
+*
+*   \param[in]  argc                Number of arguments.
+*   \param[in]  argv                Arguments.
+*
+*   \return     0 on success, -1 on error
+*
+*******************************************************************************/
+int SHCMD_RippleHandler(int argc, char *argv[]);
+
+/***************************************************************************//*!
+*  \brief Wave shell command handler.
+*
+*   This function is the handler of the 'wave' shell command (duty waveform
+*   playback on both phases):
+*       wave ramp|triangle|sine <period_ms> <min> <max> [cycles] [rate_hz]
+*       wave stream [rate_hz]
+*       wave push <duty> [duty ...]
+*       wave flush
+*       wave stop
+*       wave stat
+*
+*   Pushed samples are queued for playback once a buffer is full, 'wave
+*   flush' queues the last partial buffer (end of stream).
+*
+*   Preconditions: Phases not used (regulator, ripple), no fault latched.
+*
+*   Side Effects: Phases enabled during the playback.
+*
+*   \param[in]  argc                Number of arguments.
+*   \param[in]  argv                Arguments.
+*
+*   \return     0 on success, -1 on error
+*
+*******************************************************************************/
+int SHCMD_WaveHandler(int argc, char *argv[]);
+
+/***************************************************************************//*!
+*  \brief Display shell command handler.
+*
+*   This function is the handler of the 'disp' shell command:
+*       disp stat
+*       disp text <line> <text>
+*       disp clear
+*   Text and clear are flushed right away, the statistics show the bytes
+*   sent and the flush time of the latest frame.
+*
+*   Preconditions: Display initialized.
+*
+*   Side Effects: None.
+*
+*   \param[in]  argc                Number of arguments.
+*   \param[in]  argv                Arguments.
+*
+*   \return     0 on success, -1 on error
+*
+*******************************************************************************/
+int SHCMD_DispHandler(int argc, char *argv[]);
+
+/***************************************************************************//*!
+*  \brief Led shell command handler.
+*
+*   This function is the handler of the 'led' shell command (status led):
+*       led blink|breathe <period_ms> [duty]
+*       led pulse <nb_pulses> <period_ms> [duty]
+*       led cycle <period_ms>
+*       led stop
+*       led stat
+*       led bench [seconds]
+*   Effects are played by the LEDC hardware, chained from the fade end
+*   interrupt. The bench compares them with a task driven breathe.
+*
+*   Preconditions: UI initialized.
+*
+*   Side Effects: Bench blocks the shell for twice the duration.
+*
+*   \param[in]  argc                Number of arguments.
+*   \param[in]  argv                Arguments.
+*
+*   \return     0 on success, -1 on error
+*
+*******************************************************************************/
+int SHCMD_LedHandler(int argc, char *argv[]);
+
+/***************************************************************************//*!
+*  \brief Com shell command handler.
+*
+*   This function is the handler of the 'com' shell command (shell port
+*   receive and transmit paths):
+*       com stat
+*       com reset
+*
+*   Preconditions: None.
+*
+*   Side Effects: None.
+*
+*   \param[in]  argc                Number of arguments.
+*   \param[in]  argv                Arguments.
+*
+*   \return     0 on success, -1 on error
+*
+*******************************************************************************/
+int SHCMD_ComHandler(int argc, char *argv[]);
+
+/***************************************************************************//*!
+*  \brief Telemetry shell command handler.
+*
+*   This function is the handler of the 'tlm' shell command (binary
+*   telemetry stream on the shell port):
+*       tlm on|off
+*       tlm rate power|reg|fault|tasks <period_ms> (0 -> off)
+*       tlm adc <freq_hz> [divider]
+*       tlm adc off
+*       tlm stat
+*
+*   Preconditions: Telemetry initialized.
+*
+*   Side Effects: None.
+*
+*   \param[in]  argc                Number of arguments.
+*   \param[in]  argv                Arguments.
+*
+*   \return     0 on success, -1 on error
+*
+*******************************************************************************/
+int SHCMD_TlmHandler(int argc, char *argv[]);
+
+/***************************************************************************//*!
+*  \brief Format shell command handler.
+*
+*   This function is the handler of the 'fmt' shell command:
+*       fmt bench [nb_rounds]
+*   The bench formats a status line with snprintf() and with the textFormat
+*   functions: cycles per line and stack use.
+*
+*   Preconditions: None.
+*
+*   Side Effects: Bench blocks the shell (interrupts enabled).
+*
+*   \param[in]  argc                Number of arguments.
+*   \param[in]  argv                Arguments.
+*
+*   \return     0 on success, -1 on error
+*
+*******************************************************************************/
+int SHCMD_FmtHandler(int argc, char *argv[]);
+
+/***************************************************************************//*!
+*  \brief Watch shell command handler.
+*
+*   This function is the handler of the 'watch' shell command:
+*       watch <fields|all> [rate_hz]
+*       watch stop
+*       watch stat
+*   Fields are comma separated: bus, ia, ib (bus voltage, phase currents),
+*   ta, tb, tl (phase and load temperatures), da, db (phase duty).
+*
+*   Preconditions: Watch initialized.
+*
+*   Side Effects: None.
+*
+*   \param[in]  argc                Number of arguments.
+*   \param[in]  argv                Arguments.
+*
+*   \return     0 on success, -1 on error
+*
+*******************************************************************************/
+int SHCMD_WatchHandler(int argc, char *argv[]);
+
+/***************************************************************************//*!
+*  \brief Job shell command handler.
+*
+*   This function is the handler of the 'job' shell command (commands run
+*   on the shell workers, '<command> ... &' in background):
+*       job [list]
+*       job kill <id>
+*       job stat
+*       job reset
+*   Ctrl-C cancels the foreground jobs.
+*
+*   Preconditions: Shell jobs initialized.
+*
+*   Side Effects: None.
+*
+*   \param[in]  argc                Number of arguments.
+*   \param[in]  argv                Arguments.
+*
+*   \return     0 on success, -1 on error
+*
+*******************************************************************************/
+int SHCMD_JobHandler(int argc, char *argv[]);
+
+/***************************************************************************//*!
+*  \brief Core shell command handler.
+*
+*   This function is the handler of the 'core' shell command:
+*       core [plan]
+*       core bench [duration_ms]
+*   The bench measures the timer interrupt to task latency with the probe
+*   pinned to the control core, then floating, under an I/O core load.
+*
+*   Preconditions: None.
+*
+*   Side Effects: Bench blocks the shell 2 x duration_ms.
+*
+*   \param[in]  argc                Number of arguments.
+*   \param[in]  argv                Arguments.
+*
+*   \return     0 on success, -1 on error
+*
+*******************************************************************************/
+int SHCMD_CoreHandler(int argc, char *argv[]);
+
+/***************************************************************************//*!
+*  \brief Tasks shell command handler.
+*
+*   This function is the handler of the 'tasks' shell command (statistics
+*   of the last window):
+*       tasks [list]
+*       tasks reset
+*   Per task: core, priority, CPU share of one core, stack left, wakeups
+*   per second and maximum scheduling latency (tasks with probes).
+*
+*   Preconditions: Task statistics initialized.
+*
+*   Side Effects: None.
+*
+*   \param[in]  argc                Number of arguments.
+*   \param[in]  argv                Arguments.
+*
+*   \return     0 on success, -1 on error
+*
+*******************************************************************************/
+int SHCMD_TasksHandler(int argc, char *argv[]);
+
+/***************************************************************************//*!
+*  \brief Trace shell command handler.
+*
+*   This function is the handler of the 'trace' shell command (trace points
+*   of the sensing and control paths):
+*       trace start [ring|once]
+*       trace stop
+*       trace dump
+*       trace stat
+*   The dump stops the trace and prints one CSV line per record, oldest
+*   first: time_us,core,event,type,arg.
+*
+*   Preconditions: None.
+*
+*   Side Effects: None.
+*
+*   \param[in]  argc                Number of arguments.
+*   \param[in]  argv                Arguments.
+*
+*   \return     0 on success, -1 on error
+*
+*******************************************************************************/
+int SHCMD_TraceHandler(int argc, char *argv[]);
+
+/***************************************************************************//*!
+*  \brief Bench shell command handler.
+*
+*   This function is the handler of the 'bench' shell command (kernel
+*   micro-benchmarks):
+*       bench [list]
+*       bench run [kernel|all] [nb_iterations]
+*   One CSV line per kernel: totals of the iterations (call overhead
+*   removed), empty fields for the counters not measured on this platform.
+*
+*   Preconditions: Called from a task pinned to a core (job worker).
+*
+*   Side Effects: None.
+*
+*   \param[in]  argc                Number of arguments.
+*   \param[in]  argv                Arguments.
+*
+*   \return     0 on success, -1 on error
+*
+*******************************************************************************/
+int SHCMD_BenchHandler(int argc, char *argv[]);
+
+#endif//__SHELL_COMMANDS_H
@@ -0,0 +1,609 @@
+#include <string.h>
+
+#include "freertos/FreeRTOS.h"
+#include "freertos/task.h"
+#include "freertos/queue.h"
+
+#include "esp_timer.h"
+#include "esp_log.h"
+
+#include "taskPriority.h"
+#include "memoryMap.h"
+#include "taskStats.h"
+#include "shellCom.h"
+#include "myShell_cfg.h"
+#include "shellJobs.h"
+
+/******************************************************************************
+*   Private Definitions
+*******************************************************************************/
+#define SHJOB_SLEEP_STEP_MS                 (10)//Cancel latency of SHJOB_Sleep()
+#define SHJOB_NO_JOB                        (0xFF)
+
+#define LOG_LOCAL_LEVEL                     (ESP_LOG_INFO)
+
+/******************************************************************************
+*   Private Macros
+*******************************************************************************/
+
+
+/******************************************************************************
+*   Private Data Types
+*******************************************************************************/
+typedef struct SHJOB_Job_s{
+    uint32_t id;
+    SHJOB_State_t state;
+    SHJOB_Handler_t handler;
+    bool is_background;
+    bool is_cancelled;
+    int64_t start_us;
+    int argc;
+    char *argv[SHELL_MAX_ARGS];
+    char args[SHELL_RX_BUFFER_SIZE];    //Argument strings, NUL separated
+}SHJOB_Job_t;
+
+/******************************************************************************
+*   Private Functions Declaration
+*******************************************************************************/
+static uint8_t currentJob(void);
+static void accountJob(const SHJOB_Job_t *pJob, int ret, uint32_t elapsed_us);
+static void runJob(uint8_t worker, uint8_t slot);
+static void tWorkerTask(void *pvParameters);
+
+static void breakCallback(void);
+
+/******************************************************************************
+*   Public Variables
+*******************************************************************************/
+
+
+/******************************************************************************
+*   Private Variables
+*******************************************************************************/
+static QueueHandle_t job_queue = NULL;//Job slots, FIFO
+static StaticQueue_t job_queue_buffer;
+static uint8_t job_queue_storage[SHJOB_MAX_JOBS];
+static TaskHandle_t worker_task_handles[SHJOB_NB_WORKERS] = {NULL};
+static StackType_t worker_task_stacks[SHJOB_NB_WORKERS][SHJOB_TASK_STACK_SIZE];
+static StaticTask_t worker_task_buffers[SHJOB_NB_WORKERS];
+
+//Under shjob_spinlock
+static SHJOB_Job_t jobs[SHJOB_MAX_JOBS];
+static uint8_t worker_jobs[SHJOB_NB_WORKERS];//Slot run by each worker
+static uint32_t next_job_id = 1;
+static SHJOB_Command_Stats_t command_stats[SHJOB_MAX_COMMAND_STATS];
+static uint32_t nb_command_stats = 0;
+static portMUX_TYPE shjob_spinlock = portMUX_INITIALIZER_UNLOCKED;
+
+static const char * TAG = "SHJOB";
+
+/******************************************************************************
+*   Error Check
+*******************************************************************************/
+_Static_assert(SHJOB_MAX_JOBS < SHJOB_NO_JOB, "Too many job slots");
+_Static_assert(SHJOB_NB_WORKERS <= SHJOB_MAX_JOBS, "More workers than job slots");
+_Static_assert(SHJOB_NB_WORKERS == MEM_SHJOB_NB_WORKERS, "Worker stacks out of the memory map");
+_Static_assert(SHJOB_NB_WORKERS < SHCOM_MAX_SHELL_TASKS, "No shell output line for every worker");
+
+/******************************************************************************
+*   Private Functions Definitions
+*******************************************************************************/
+/***************************************************************************//*!
+*  \brief Current job.
+*
+*   This function gets the job slot run by the calling task.
+*
+*   Preconditions: Under shjob_spinlock.
+*
+*   Side Effects: None.
+*
+*   \return     Job slot, SHJOB_NO_JOB if not called from a worker
+*
+*******************************************************************************/
+static uint8_t currentJob(void){
+
+    TaskHandle_t task_handle = xTaskGetCurrentTaskHandle();
+
+    for(uint8_t worker=0; worker<SHJOB_NB_WORKERS; worker++){
+        if(worker_task_handles[worker] == task_handle)  return worker_jobs[worker];
+    }
+
+    return SHJOB_NO_JOB;
+}
+
+/***************************************************************************//*!
+*  \brief Account job.
+*
+*   This function adds a finished job to its command statistics (commands
+*   beyond SHJOB_MAX_COMMAND_STATS are not accounted).
+*
+*   Preconditions: Under shjob_spinlock.
+*
+*   Side Effects: None.
+*
+*   \param[in]  pJob                Finished job.
+*   \param[in]  ret                 Handler return value.
+*   \param[in]  elapsed_us          Run time.
+*
+*******************************************************************************/
+static void accountJob(const SHJOB_Job_t *pJob, int ret, uint32_t elapsed_us){
+
+    SHJOB_Command_Stats_t *pStats = NULL;
+
+    for(uint32_t i=0; i<nb_command_stats; i++){
+        if(strncmp(command_stats[i].command, pJob->argv[0], SHJOB_COMMAND_NAME_SIZE - 1) == 0){
+            pStats = &command_stats[i];
+            break;
+        }
+    }
+
+    if(pStats == NULL){
+        if(nb_command_stats >= SHJOB_MAX_COMMAND_STATS) return;
+
+        pStats = &command_stats[nb_command_stats++];
+        memset(pStats, 0, sizeof(SHJOB_Command_Stats_t));
+        strncpy(pStats->command, pJob->argv[0], SHJOB_COMMAND_NAME_SIZE - 1);
+    }
+
+    pStats->nb_runs++;
+    pStats->total_us += elapsed_us;
+    if(elapsed_us > pStats->max_us) pStats->max_us = elapsed_us;
+    if(ret != 0)                    pStats->nb_errors++;
+    if(pJob->is_cancelled)          pStats->nb_cancelled++;
+}
+
+/***************************************************************************//*!
+*  \brief Run job.
+*
+*   This function runs a queued job on a worker, accounts its run time and
+*   releases its slot. Background jobs report their end, cancelled jobs
+*   report the cancellation.
+*
+*   Preconditions: Called from the worker task.
+*
+*   Side Effects: None.
+*
+*   \param[in]  worker              Worker index.
+*   \param[in]  slot                Job slot.
+*
+*******************************************************************************/
+static void runJob(uint8_t worker, uint8_t slot){
+
+    SHJOB_Job_t *pJob = &jobs[slot];
+    int ret = -1;
+
+    //Cancelled while queued: not run
+    portENTER_CRITICAL(&shjob_spinlock);
+    bool is_run = !pJob->is_cancelled;
+    if(is_run){
+        pJob->state = SHJOB_STATE_RUNNING;
+        pJob->start_us = esp_timer_get_time();
+        worker_jobs[worker] = slot;
+    }
+    portEXIT_CRITICAL(&shjob_spinlock);
+
+    if(is_run)  ret = pJob->handler(pJob->argc, pJob->argv);
+    SHCOM_FlushLine();
+
+    uint32_t elapsed_us = is_run ? (uint32_t)(esp_timer_get_time() - pJob->start_us) : 0;
+
+    //Set by the listener (Ctrl-C, cancel command)
+    portENTER_CRITICAL(&shjob_spinlock);
+    bool is_cancelled = pJob->is_cancelled;
+    portEXIT_CRITICAL(&shjob_spinlock);
+
+    if(is_cancelled){
+        SHCOM_Printf("[%lu] %s cancelled\r\n", pJob->id, pJob->argv[0]);
+    }
+    else if(pJob->is_background){
+        SHCOM_Printf("[%lu] %s %s (%lu ms)\r\n", pJob->id, pJob->argv[0],
+                     (ret == 0) ? "done" : "failed", elapsed_us / 1000);
+    }
+
+    portENTER_CRITICAL(&shjob_spinlock);
+    if(is_run)  accountJob(pJob, ret, elapsed_us);
+    worker_jobs[worker] = SHJOB_NO_JOB;
+    pJob->state = SHJOB_STATE_FREE;
+    portEXIT_CRITICAL(&shjob_spinlock);
+}
+
+/***************************************************************************//*!
+*  \brief Worker task.
+*
+*   This task runs the queued commands, one at a time. The shell listener
+*   keeps reading the input meanwhile (Ctrl-C, next commands).
+*
+*   Preconditions: None.
+*
+*   Side Effects: None.
+*
+*   \param[in]  pvParameters        Worker index.
+*
+*******************************************************************************/
+static void tWorkerTask(void *pvParameters){
+
+    uint8_t worker = (uint8_t)(uintptr_t)pvParameters;
+    uint8_t slot;
+
+    //Own shell output line (not mixed with the other tasks), waits for room
+    if(SHCOM_STATUS_OK != SHCOM_RegisterShellTask()){
+        ESP_LOGE(TAG, "Failed to register shell worker %u output", worker);
+    }
+
+    for(;;){
+
+        if(pdTRUE == xQueueReceive(job_queue, &slot, portMAX_DELAY)){
+            TSTAT_MarkRunning(false);
+            runJob(worker, slot);
+        }
+    }
+    vTaskDelete(NULL);
+}
+
+/******************************************************************************
+*   CallBack Functions implementation
+*******************************************************************************/
+/***************************************************************************//*!
+*  \brief Break callback.
+*
+*   This function is called by the shell communication on Ctrl-C (listener
+*   task): the foreground jobs are cancelled.
+*
+*   Preconditions: None.
+*
+*******************************************************************************/
+static void breakCallback(void){
+
+    if(SHJOB_CancelForeground() == 0)  SHCOM_Print("^C\r\n");
+}
+
+/******************************************************************************
+*   Public Functions Definitions
+*******************************************************************************/
+/***************************************************************************//*!
+*  \brief Shell jobs initialization.
+*
+*   This function is used to initialize the shell jobs: the job queue, the
+*   worker tasks running the queued commands and the Ctrl-C handling on
+*   the shell input.
+*
+*   Preconditions: Shell communication initialized.
+*
+*   Side Effects: None.
+*
+*   \return     Operation status
+*
+*******************************************************************************/
+SHJOB_Ret_t SHJOB_InitJobs(void){
+
+    //Create queue, one entry per job slot (never full)
+    job_queue = xQueueCreateStatic(SHJOB_MAX_JOBS, sizeof(uint8_t), job_queue_storage, &job_queue_buffer);
+    if(job_queue == NULL){
+        ESP_LOGE(TAG, "Failed to create job queue");
+        return SHJOB_STATUS_ERROR;
+    }
+
+    for(uint8_t worker=0; worker<SHJOB_NB_WORKERS; worker++){
+
+        worker_jobs[worker] = SHJOB_NO_JOB;
+
+        //Create task
+        worker_task_handles[worker] = xTaskCreateStaticPinnedToCore(tWorkerTask,
+                                                                    "Shell worker",
+                                                                    SHJOB_TASK_STACK_SIZE,
+                                                                    (void *)(uintptr_t)worker,
+                                                                    SHJOB_TASK_PRIORITY,
+                                                                    worker_task_stacks[worker],
+                                                                    &worker_task_buffers[worker],
+                                                                    SHJOB_TASK_CORE);
+        if(worker_task_handles[worker] == NULL){
+
+            ESP_LOGE(TAG, "Failed to create shell worker task");
+            return SHJOB_STATUS_ERROR;
+        }
+    }
+
+    SHCOM_SetBreakCallback(breakCallback);
+
+    return SHJOB_STATUS_OK;
+}
+
+/***************************************************************************//*!
+*  \brief Submit job.
+*
+*   This function is used to queue a command on the workers: the arguments
+*   are copied, the caller (shell listener) returns to the input at once.
+*   A foreground job is cancelled by Ctrl-C, a background job (last
+*   argument SHJOB_BACKGROUND_ARG, removed) by SHJOB_Cancel() and reports
+*   its end. A command is not queued twice.
+*
+*   Preconditions: Shell jobs initialized.
+*
+*   Side Effects: None.
+*
+*   \param[in]  handler             Command handler.
+*   \param[in]  argc                Number of arguments (command included).
+*   \param[in]  argv                Arguments (command included).
+*
+*   \return     Operation status (error if the queue is full)
+*
+*******************************************************************************/
+SHJOB_Ret_t SHJOB_Submit(SHJOB_Handler_t handler, int argc, char *argv[]){
+
+    uint8_t slot = SHJOB_NO_JOB;
+    uint32_t busy_id = 0;
+    uint32_t job_id = 0;
+
+    if((job_queue == NULL) || (handler == NULL) || (argc < 1) || (argc > SHELL_MAX_ARGS)){
+        return SHJOB_STATUS_ERROR;
+    }
+
+    bool is_background = (argc > 1) && (strcmp(argv[argc - 1], SHJOB_BACKGROUND_ARG) == 0);
+    if(is_background)   argc--;
+
+    //Claim and fill the slot in one critical section (submitters may race)
+    portENTER_CRITICAL(&shjob_spinlock);
+    for(uint8_t i=0; i<SHJOB_MAX_JOBS; i++){
+
+        if(jobs[i].state == SHJOB_STATE_FREE){
+            if(slot == SHJOB_NO_JOB)    slot = i;
+        }
+        else if(jobs[i].handler == handler){
+            busy_id = jobs[i].id;
+        }
+    }
+
+    if((busy_id == 0) && (slot != SHJOB_NO_JOB)){
+
+        SHJOB_Job_t *pJob = &jobs[slot];
+        size_t offset = 0;
+
+        pJob->handler = handler;
+        pJob->is_background = is_background;
+        pJob->is_cancelled = false;
+        pJob->start_us = 0;
+        pJob->argc = argc;
+
+        for(int i=0; i<argc; i++){
+
+            size_t len = strnlen(argv[i], sizeof(pJob->args) - offset - 1);
+
+            memcpy(&pJob->args[offset], argv[i], len);
+            pJob->args[offset + len] = '\0';
+            pJob->argv[i] = &pJob->args[offset];
+            offset += len;
+            if(offset < (sizeof(pJob->args) - 1))   offset++;
+        }
+
+        pJob->id = next_job_id++;
+        pJob->state = SHJOB_STATE_QUEUED;
+        job_id = pJob->id;
+    }
+    portEXIT_CRITICAL(&shjob_spinlock);
+
+    if(busy_id != 0){
+        SHCOM_Printf("%s already queued or running [%lu]\r\n", argv[0], busy_id);
+        return SHJOB_STATUS_ERROR;
+    }
+
+    if(slot == SHJOB_NO_JOB){
+        SHCOM_Printf("Job queue full\r\n");
+        return SHJOB_STATUS_ERROR;
+    }
+
+    if(is_background)   SHCOM_Printf("[%lu] %s\r\n", job_id, argv[0]);
+
+    xQueueSend(job_queue, &slot, 0);
+
+    return SHJOB_STATUS_OK;
+}
+
+/***************************************************************************//*!
+*  \brief Cancel job.
+*
+*   This function is used to cancel a job: a queued job is dropped, a
+*   running job is flagged (SHJOB_IsCancelled()).
+*
+*   Preconditions: Shell jobs initialized.
+*
+*   Side Effects: None.
+*
+*   \param[in]  id                  Job ID.
+*
+*   \return     Operation status (error if no such job)
+*
+*******************************************************************************/
+SHJOB_Ret_t SHJOB_Cancel(uint32_t id){
+
+    bool is_found = false;
+
+    portENTER_CRITICAL(&shjob_spinlock);
+    for(uint8_t i=0; i<SHJOB_MAX_JOBS; i++){
+
+        if((jobs[i].state != SHJOB_STATE_FREE) && (jobs[i].id == id)){
+            jobs[i].is_cancelled = true;
+            is_found = true;
+        }
+    }
+    portEXIT_CRITICAL(&shjob_spinlock);
+
+    return is_found ? SHJOB_STATUS_OK : SHJOB_STATUS_ERROR;
+}
+
+/***************************************************************************//*!
+*  \brief Cancel foreground jobs.
+*
+*   This function is used to cancel every foreground job (Ctrl-C).
+*
+*   Preconditions: Shell jobs initialized.
+*
+*   Side Effects: None.
+*
+*   \return     Number of jobs cancelled
+*
+*******************************************************************************/
+uint32_t SHJOB_CancelForeground(void){
+
+    uint32_t nb_cancelled = 0;
+
+    portENTER_CRITICAL(&shjob_spinlock);
+    for(uint8_t i=0; i<SHJOB_MAX_JOBS; i++){
+
+        if((jobs[i].state != SHJOB_STATE_FREE) && !jobs[i].is_background && !jobs[i].is_cancelled){
+            jobs[i].is_cancelled = true;
+            nb_cancelled++;
+        }
+    }
+    portEXIT_CRITICAL(&shjob_spinlock);
+
+    return nb_cancelled;
+}
+
+/***************************************************************************//*!
+*  \brief Is job cancelled.
+*
+*   This function is used by the command handlers to check if their job was
+*   cancelled: the handler cleans up and returns.
+*
+*   Preconditions: None.
+*
+*   Side Effects: None.
+*
+*   \return     true if cancelled (false outside of a worker)
+*
+*******************************************************************************/
+bool SHJOB_IsCancelled(void){
+
+    bool is_cancelled = false;
+
+    portENTER_CRITICAL(&shjob_spinlock);
+    uint8_t slot = currentJob();
+    if(slot != SHJOB_NO_JOB)    is_cancelled = jobs[slot].is_cancelled;
+    portEXIT_CRITICAL(&shjob_spinlock);
+
+    return is_cancelled;
+}
+
+/***************************************************************************//*!
+*  \brief Job sleep.
+*
+*   This function is used by the command handlers instead of vTaskDelay():
+*   the delay ends early when the job is cancelled.
+*
+*   Preconditions: None.
+*
+*   Side Effects: None.
+*
+*   \param[in]  delay_ms            Delay.
+*
+*   \return     false if the job was cancelled
+*
+*******************************************************************************/
+bool SHJOB_Sleep(uint32_t delay_ms){
+
+    //Polled: the handler may use the task notification itself
+    while(delay_ms > 0){
+
+        uint32_t step_ms = (delay_ms < SHJOB_SLEEP_STEP_MS) ? delay_ms : SHJOB_SLEEP_STEP_MS;
+
+        if(SHJOB_IsCancelled()) return false;
+
+        vTaskDelay(pdMS_TO_TICKS(step_ms));
+        delay_ms -= step_ms;
+    }
+
+    return !SHJOB_IsCancelled();
+}
+
+/***************************************************************************//*!
+*  \brief Get jobs.
+*
+*   This function is used to get the queued and running jobs.
+*
+*   Preconditions: None.
+*
+*   Side Effects: None.
+*
+*   \param[out] pInfo               Jobs (SHJOB_MAX_JOBS).
+*
+*   \return     Number of jobs
+*
+*******************************************************************************/
+uint32_t SHJOB_GetJobs(SHJOB_Info_t *pInfo){
+
+    uint32_t nb_jobs = 0;
+
+    if(pInfo == NULL)   return 0;
+
+    int64_t now_us = esp_timer_get_time();
+
+    portENTER_CRITICAL(&shjob_spinlock);
+    for(uint8_t i=0; i<SHJOB_MAX_JOBS; i++){
+
+        const SHJOB_Job_t *pJob = &jobs[i];
+
+        if(pJob->state == SHJOB_STATE_FREE) continue;
+
+        SHJOB_Info_t *pJob_info = &pInfo[nb_jobs++];
+
+        pJob_info->id = pJob->id;
+        pJob_info->state = pJob->state;
+        pJob_info->is_background = pJob->is_background;
+        pJob_info->is_cancelled = pJob->is_cancelled;
+        pJob_info->elapsed_ms = (pJob->state == SHJOB_STATE_RUNNING) ?
+                                (uint32_t)((now_us - pJob->start_us) / 1000) : 0;
+        strncpy(pJob_info->command, pJob->args, SHJOB_COMMAND_NAME_SIZE - 1);
+        pJob_info->command[SHJOB_COMMAND_NAME_SIZE - 1] = '\0';
+    }
+    portEXIT_CRITICAL(&shjob_spinlock);
+
+    return nb_jobs;
+}
+
+/***************************************************************************//*!
+*  \brief Get command statistics.
+*
+*   This function is used to get the run time of the commands run as jobs
+*   since the last reset.
+*
+*   Preconditions: None.
+*
+*   Side Effects: None.
+*
+*   \param[out] pStats              Statistics (SHJOB_MAX_COMMAND_STATS).
+*
+*   \return     Number of commands
+*
+*******************************************************************************/
+uint32_t SHJOB_GetCommandStats(SHJOB_Command_Stats_t *pStats){
+
+    if(pStats == NULL)  return 0;
+
+    portENTER_CRITICAL(&shjob_spinlock);
+    uint32_t nb_stats = nb_command_stats;
+    memcpy(pStats, command_stats, nb_stats * sizeof(SHJOB_Command_Stats_t));
+    portEXIT_CRITICAL(&shjob_spinlock);
+
+    return nb_stats;
+}
+
+/***************************************************************************//*!
+*  \brief Reset command statistics.
+*
+*   This function is used to reset the command run time statistics.
+*
+*   Preconditions: None.
+*
+*   Side Effects: None.
+*
+*******************************************************************************/
+void SHJOB_ResetCommandStats(void){
+
+    portENTER_CRITICAL(&shjob_spinlock);
+    nb_command_stats = 0;
+    portEXIT_CRITICAL(&shjob_spinlock);
+}
+
+/******************************************************************************
+*   Interrupts
+*******************************************************************************/
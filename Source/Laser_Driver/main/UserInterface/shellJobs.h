@@ -0,0 +1,217 @@
+#ifndef __SHELL_JOBS_H
+#define __SHELL_JOBS_H
+
+#include <stdint.h>
+#include <stdbool.h>
+
+/******************************************************************************
+*   Public Definitions
+*******************************************************************************/
+#define SHJOB_MAX_JOBS                      (4)//Queued and running jobs
+#define SHJOB_NB_WORKERS                    (2)//A background job does not hold the next command
+#define SHJOB_MAX_COMMAND_STATS             (16)//Distinct commands accounted
+#define SHJOB_COMMAND_NAME_SIZE             (16)//Command names kept for the lists
+
+#define SHJOB_BACKGROUND_ARG                "&"//Last argument: background job
+
+/******************************************************************************
+*   Public Macros
+*******************************************************************************/
+
+
+/******************************************************************************
+*   Public Data Types
+*******************************************************************************/
+typedef int (*SHJOB_Handler_t)(int argc, char *argv[]);
+
+typedef enum SHJOB_State_e{
+    SHJOB_STATE_FREE,
+    SHJOB_STATE_QUEUED,
+    SHJOB_STATE_RUNNING,
+
+    SHJOB_STATE_INVALID,
+}SHJOB_State_t;
+
+typedef struct SHJOB_Info_s{
+    uint32_t id;
+    SHJOB_State_t state;
+    bool is_background;
+    bool is_cancelled;                  //Cancel requested, handler not returned yet
+    uint32_t elapsed_ms;                //Running time (0 while queued)
+    char command[SHJOB_COMMAND_NAME_SIZE];
+}SHJOB_Info_t;
+
+typedef struct SHJOB_Command_Stats_s{
+    char command[SHJOB_COMMAND_NAME_SIZE];
+    uint32_t nb_runs;
+    uint32_t nb_errors;                 //Handler returned an error
+    uint32_t nb_cancelled;
+    uint64_t total_us;
+    uint32_t max_us;
+}SHJOB_Command_Stats_t;
+
+typedef enum SHJOB_Ret_e{
+    SHJOB_STATUS_ERROR,
+    SHJOB_STATUS_OK,
+}SHJOB_Ret_t;
+
+/******************************************************************************
+*   Public Variables
+*******************************************************************************/
+
+
+/******************************************************************************
+*   Error Check
+*******************************************************************************/
+
+
+/******************************************************************************
+*   Public Functions Declarations
+*******************************************************************************/
+/***************************************************************************//*!
+*  \brief Shell jobs initialization.
+*
+*   This function is used to initialize the shell jobs: the job queue, the
+*   worker tasks running the queued commands and the Ctrl-C handling on
+*   the shell input.
+*
+*   Preconditions: Shell communication initialized.
+*
+*   Side Effects: None.
+*
+*   \return     Operation status
+*
+*******************************************************************************/
+SHJOB_Ret_t SHJOB_InitJobs(void);
+
+/***************************************************************************//*!
+*  \brief Submit job.
+*
+*   This function is used to queue a command on the workers: the arguments
+*   are copied, the caller (shell listener) returns to the input at once.
+*   A foreground job is cancelled by Ctrl-C, a background job (last
+*   argument SHJOB_BACKGROUND_ARG, removed) by SHJOB_Cancel() and reports
+*   its end. A command is not queued twice.
+*
+*   Preconditions: Shell jobs initialized.
+*
+*   Side Effects: None.
+*
+*   \param[in]  handler             Command handler.
+*   \param[in]  argc                Number of arguments (command included).
+*   \param[in]  argv                Arguments (command included).
+*
+*   \return     Operation status (error if the queue is full)
+*
+*******************************************************************************/
+SHJOB_Ret_t SHJOB_Submit(SHJOB_Handler_t handler, int argc, char *argv[]);
+
+/***************************************************************************//*!
+*  \brief Cancel job.
+*
+*   This function is used to cancel a job: a queued job is dropped, a
+*   running job is flagged (SHJOB_IsCancelled()).
+*
+*   Preconditions: Shell jobs initialized.
+*
+*   Side Effects: None.
+*
+*   \param[in]  id                  Job ID.
+*
+*   \return     Operation status (error if no such job)
+*
+*******************************************************************************/
+SHJOB_Ret_t SHJOB_Cancel(uint32_t id);
+
+/***************************************************************************//*!
+*  \brief Cancel foreground jobs.
+*
+*   This function is used to cancel every foreground job (Ctrl-C).
+*
+*   Preconditions: Shell jobs initialized.
+*
+*   Side Effects: None.
+*
+*   \return     Number of jobs cancelled
+*
+*******************************************************************************/
+uint32_t SHJOB_CancelForeground(void);
+
+/***************************************************************************//*!
+*  \brief Is job cancelled.
+*
+*   This function is used by the command handlers to check if their job was
+*   cancelled: the handler cleans up and returns.
+*
+*   Preconditions: None.
+*
+*   Side Effects: None.
+*
+*   \return     true if cancelled (false outside of a worker)
+*
+*******************************************************************************/
+bool SHJOB_IsCancelled(void);
+
+/***************************************************************************//*!
+*  \brief Job sleep.
+*
+*   This function is used by the command handlers instead of vTaskDelay():
+*   the delay ends early when the job is cancelled.
+*
+*   Preconditions: None.
+*
+*   Side Effects: None.
+*
+*   \param[in]  delay_ms            Delay.
+*
+*   \return     false if the job was cancelled
+*
+*******************************************************************************/
+bool SHJOB_Sleep(uint32_t delay_ms);
+
+/***************************************************************************//*!
+*  \brief Get jobs.
+*
+*   This function is used to get the queued and running jobs.
+*
+*   Preconditions: None.
+*
+*   Side Effects: None.
+*
+*   \param[out] pInfo               Jobs (SHJOB_MAX_JOBS).
+*
+*   \return     Number of jobs
+*
+*******************************************************************************/
+uint32_t SHJOB_GetJobs(SHJOB_Info_t *pInfo);
+
+/***************************************************************************//*!
+*  \brief Get command statistics.
+*
+*   This function is used to get the run time of the commands run as jobs
+*   since the last reset.
+*
+*   Preconditions: None.
+*
+*   Side Effects: None.
+*
+*   \param[out] pStats              Statistics (SHJOB_MAX_COMMAND_STATS).
+*
+*   \return     Number of commands
+*
+*******************************************************************************/
+uint32_t SHJOB_GetCommandStats(SHJOB_Command_Stats_t *pStats);
+
+/***************************************************************************//*!
+*  \brief Reset command statistics.
+*
+*   This function is used to reset the command run time statistics.
+*
+*   Preconditions: None.
+*
+*   Side Effects: None.
+*
+*******************************************************************************/
+void SHJOB_ResetCommandStats(void);
+
+#endif//__SHELL_JOBS_H
@@ -0,0 +1,751 @@
+#include <string.h>
+
+#include "freertos/FreeRTOS.h"
+#include "freertos/task.h"
+#include "freertos/semphr.h"
+
+#include "esp_attr.h"
+#include "esp_cpu.h"
+#include "esp_timer.h"
+#include "esp_rom_crc.h"
+#include "esp_log.h"
+
+#include "taskPriority.h"
+#include "memoryMap.h"
+#include "taskStats.h"
+#include "shellCom.h"
+#include "adcController.h"
+#include "pwrMonitoring.h"
+#include "currentRegulator.h"
+#include "telemetry.h"
+
+/******************************************************************************
+*   Private Definitions
+*******************************************************************************/
+#define TLM_PAYLOAD_MAX_SIZE                (TLM_FRAME_HEADER_SIZE + TLM_MAX_DATA_SIZE + TLM_FRAME_CRC_SIZE)
+#define TLM_COBS_MAX_SIZE                   (TLM_PAYLOAD_MAX_SIZE + (TLM_PAYLOAD_MAX_SIZE / 254) + 1)
+#define TLM_WIRE_MAX_SIZE                   (1 + TLM_COBS_MAX_SIZE + 1)//Start, COBS, end
+
+#define TLM_ADC_NB_FRAMES                   (2)//ISR to task mailbox (power of 2)
+#define TLM_ADC_CHANNEL_MASK                (ADC_CTRL_CHANNEL_BUS_VOLT_MASK | \
+                                             ADC_CTRL_CHANNEL_I_pA_MASK | \
+                                             ADC_CTRL_CHANNEL_I_pB_MASK)
+#define TLM_ADC_NB_CHANNELS                 (3)
+#define TLM_ADC_ATTEN                       (ADC_CTRL_ATTEN_12DB)
+
+#define TLM_REG_FLAG_SATURATED              (0x01)
+#define TLM_REG_FLAG_RAMPING                (0x02)
+#define TLM_REG_PHASE_DATA_SIZE             (9)
+
+#define TLM_TASK_CORE_FLOATING              (0xFF)
+
+#define LOG_LOCAL_LEVEL                     (ESP_LOG_INFO)
+
+/******************************************************************************
+*   Private Macros
+*******************************************************************************/
+#define TLM_PUT_U16(p, v)                   do{ (p)[0] = (uint8_t)(v); (p)[1] = (uint8_t)((uint16_t)(v) >> 8); }while(0)
+#define TLM_PUT_U32(p, v)                   do{ TLM_PUT_U16((p), (v)); TLM_PUT_U16(&(p)[2], (uint32_t)(v) >> 16); }while(0)
+#define TLM_SAT_U16(v)                      (((v) > UINT16_MAX) ? UINT16_MAX : (v))
+
+/******************************************************************************
+*   Private Data Types
+*******************************************************************************/
+typedef struct TLM_Adc_Frame_s{
+    uint32_t size;
+    uint8_t data[TLM_ADC_MAX_FRAME_SIZE];
+}TLM_Adc_Frame_t;
+
+/******************************************************************************
+*   Private Functions Declaration
+*******************************************************************************/
+static size_t cobsEncode(const uint8_t *pInput, size_t len, uint8_t *pOutput);
+static void sendFrame(TLM_Channel_t channel, const uint8_t *pData, size_t len);
+static void sendAdcFrames(void);
+static void sendPower(void);
+static void sendRegulator(void);
+static void sendFault(uint8_t *pLast_fault);
+static void sendTasks(void);
+static void tTelemetryTask(void *pvParameters);
+
+static void IRAM_ATTR adcFrameCallback(uint8_t *pResults, uint32_t frame_size);
+
+/******************************************************************************
+*   Public Variables
+*******************************************************************************/
+
+
+/******************************************************************************
+*   Private Variables
+*******************************************************************************/
+static TaskHandle_t tlm_task_handle = NULL;
+static StackType_t tlm_task_stack[TLM_TASK_STACK_SIZE];
+static StaticTask_t tlm_task_buffer;
+static SemaphoreHandle_t tlm_mutex_handle = NULL;
+static StaticSemaphore_t tlm_mutex_buffer;
+
+//Under tlm_mutex
+static bool tlm_is_enabled = false;
+static bool is_adc_streaming = false;
+static uint32_t channel_period_ms[TLM_CHANNEL_INVALID] = {0};
+
+//Only accessed from the telemetry task
+static uint16_t frame_sequence = 0;
+static uint8_t frame_payload[TLM_PAYLOAD_MAX_SIZE];
+static uint8_t frame_wire[TLM_WIRE_MAX_SIZE];
+static TSTAT_Task_Stats_t task_stats[TSTAT_MAX_TASKS];
+
+//ADC frames: written by the ADC callback (head), read by the task (tail)
+static TLM_Adc_Frame_t adc_frames[TLM_ADC_NB_FRAMES];
+static uint32_t adc_frame_head = 0;
+static uint32_t adc_frame_tail = 0;
+static volatile uint32_t adc_divider = 1;
+static uint32_t adc_divider_count = 0;//ADC callback only
+
+static TLM_Stats_t tlm_stats = {0};
+static portMUX_TYPE tlm_spinlock = portMUX_INITIALIZER_UNLOCKED;
+
+static const char * TAG = "TLM";
+
+/******************************************************************************
+*   Error Check
+*******************************************************************************/
+#if ((TLM_ADC_SAMPLES_PER_FRAME * TLM_ADC_NB_CHANNELS * ADC_CONTINUOUS_SAMPLE_SIZE_BYTE) > TLM_ADC_MAX_FRAME_SIZE)
+#error "Telemetry ADC frame larger than the frame data"
+#endif
+
+#if ((TLM_ADC_NB_FRAMES & (TLM_ADC_NB_FRAMES - 1)) != 0)
+#error "Telemetry ADC frame number must be a power of 2"
+#endif
+
+#if (configNUMBER_OF_CORES > TLM_TASK_NB_CORES) || (TSTAT_MAX_TASKS > UINT8_MAX)
+#error "Telemetry task frame does not fit the task statistics"
+#endif
+
+/******************************************************************************
+*   Private Functions Definitions
+*******************************************************************************/
+/***************************************************************************//*!
+*  \brief COBS encode.
+*
+*   This function encodes data with Consistent Overhead Byte Stuffing: the
+*   output holds no 0x00 byte (frame delimiter).
+*
+*   Preconditions: Output of len + (len / 254) + 1 bytes.
+*
+*   Side Effects: None.
+*
+*   \param[in]  pInput              Data.
+*   \param[in]  len                 Data length.
+*   \param[out] pOutput             Encoded data.
+*
+*   \return     Encoded length
+*
+*******************************************************************************/
+static size_t cobsEncode(const uint8_t *pInput, size_t len, uint8_t *pOutput){
+
+    size_t out_index = 1;
+    size_t code_index = 0;
+    uint8_t code = 1;
+
+    for(size_t i=0; i<len; i++){
+
+        if(pInput[i] != 0){
+            pOutput[out_index++] = pInput[i];
+            code++;
+        }
+
+        if((pInput[i] == 0) || (code == 0xFF)){
+            pOutput[code_index] = code;
+            code_index = out_index++;
+            code = 1;
+        }
+    }
+
+    pOutput[code_index] = code;
+
+    return out_index;
+}
+
+/***************************************************************************//*!
+*  \brief Send frame.
+*
+*   This function builds a frame (header, data, CRC), encodes it and writes
+*   it to the shell port output ring. The frame is dropped (sequence gap)
+*   when the ring is full.
+*
+*   Preconditions: Called from the telemetry task.
+*
+*   Side Effects: None.
+*
+*   \param[in]  channel             Channel.
+*   \param[in]  pData               Data.
+*   \param[in]  len                 Data length (up to TLM_MAX_DATA_SIZE).
+*
+*******************************************************************************/
+static void sendFrame(TLM_Channel_t channel, const uint8_t *pData, size_t len){
+
+    uint8_t *p = frame_payload;
+
+    if(len > TLM_MAX_DATA_SIZE) len = TLM_MAX_DATA_SIZE;
+
+    p[0] = (uint8_t)channel;
+    TLM_PUT_U16(&p[1], frame_sequence);
+    TLM_PUT_U32(&p[3], (uint32_t)esp_timer_get_time());
+    memcpy(&p[TLM_FRAME_HEADER_SIZE], pData, len);
+
+    size_t payload_len = TLM_FRAME_HEADER_SIZE + len;
+    uint16_t crc = esp_rom_crc16_le(0, p, payload_len);//CRC-16/X-25
+    TLM_PUT_U16(&p[payload_len], crc);
+    payload_len += TLM_FRAME_CRC_SIZE;
+
+    frame_wire[0] = TLM_FRAME_START;
+    size_t wire_len = 1 + cobsEncode(p, payload_len, &frame_wire[1]);
+    frame_wire[wire_len++] = TLM_FRAME_END;
+
+    frame_sequence++;
+
+    bool is_sent = (SHCOM_STATUS_OK == SHCOM_Write(frame_wire, wire_len));
+
+    portENTER_CRITICAL(&tlm_spinlock);
+    if(is_sent){
+        tlm_stats.nb_frames++;
+        tlm_stats.nb_bytes += wire_len;
+    }else{
+        tlm_stats.nb_dropped++;
+    }
+    portEXIT_CRITICAL(&tlm_spinlock);
+}
+
+/***************************************************************************//*!
+*  \brief Send ADC frames.
+*
+*   This function sends the ADC frames queued by the ADC callback.
+*
+*   Preconditions: Called from the telemetry task.
+*
+*   Side Effects: None.
+*
+*******************************************************************************/
+static void sendAdcFrames(void){
+
+    uint8_t data[TLM_MAX_DATA_SIZE];
+    uint32_t tail = adc_frame_tail;
+
+    while(tail != __atomic_load_n(&adc_frame_head, __ATOMIC_ACQUIRE)){
+
+        TLM_Adc_Frame_t *pFrame = &adc_frames[tail & (TLM_ADC_NB_FRAMES - 1)];
+
+        portENTER_CRITICAL(&tlm_spinlock);
+        uint16_t nb_overruns = (uint16_t)tlm_stats.nb_adc_overruns;
+        portEXIT_CRITICAL(&tlm_spinlock);
+
+        TLM_PUT_U16(data, nb_overruns);
+        memcpy(&data[2], pFrame->data, pFrame->size);
+
+        tail++;
+        __atomic_store_n(&adc_frame_tail, tail, __ATOMIC_RELEASE);
+
+        sendFrame(TLM_CHANNEL_ADC_RAW, data, 2 + pFrame->size);
+    }
+}
+
+/***************************************************************************//*!
+*  \brief Send power.
+*
+*   This function sends the latest bus voltage and phase currents.
+*
+*   Preconditions: Called from the telemetry task.
+*
+*   Side Effects: None.
+*
+*******************************************************************************/
+static void sendPower(void){
+
+    int16_t voltage_10mv = 0;
+    int16_t current_a_10ma = 0;
+    int16_t current_b_10ma = 0;
+    uint8_t data[6];
+
+    PWR_GetBusVoltage(&voltage_10mv);
+    PWR_GetPhaseACurrent(&current_a_10ma);
+    PWR_GetPhaseBCurrent(&current_b_10ma);
+
+    TLM_PUT_U16(&data[0], voltage_10mv);
+    TLM_PUT_U16(&data[2], current_a_10ma);
+    TLM_PUT_U16(&data[4], current_b_10ma);
+
+    sendFrame(TLM_CHANNEL_POWER, data, sizeof(data));
+}
+
+/***************************************************************************//*!
+*  \brief Send regulator.
+*
+*   This function sends the current regulator phases status.
+*
+*   Preconditions: Called from the telemetry task.
+*
+*   Side Effects: None.
+*
+*******************************************************************************/
+static void sendRegulator(void){
+
+    uint8_t data[CREG_PHASE_INVALID * TLM_REG_PHASE_DATA_SIZE];
+
+    for(uint8_t phase=0; phase<CREG_PHASE_INVALID; phase++){
+
+        CREG_Phase_Status_t status = {0};
+        uint8_t *p = &data[phase * TLM_REG_PHASE_DATA_SIZE];
+
+        CREG_GetPhaseStatus((CREG_Phase_t)phase, &status);
+
+        TLM_PUT_U16(&p[0], status.setpoint_10ma);
+        TLM_PUT_U16(&p[2], status.target_10ma);
+        TLM_PUT_U16(&p[4], status.current_10ma);
+        TLM_PUT_U16(&p[6], status.duty);
+        p[8] = (status.saturated ? TLM_REG_FLAG_SATURATED : 0) |
+               (status.ramping ? TLM_REG_FLAG_RAMPING : 0);
+    }
+
+    sendFrame(TLM_CHANNEL_REGULATOR, data, sizeof(data));
+}
+
+/***************************************************************************//*!
+*  \brief Send fault.
+*
+*   This function sends a fault event when the latched faults changed.
+*
+*   Preconditions: Called from the telemetry task.
+*
+*   Side Effects: None.
+*
+*   \param[in,out] pLast_fault      Fault flags last sent.
+*
+*******************************************************************************/
+static void sendFault(uint8_t *pLast_fault){
+
+    uint8_t fault = CREG_GetFault();
+
+    if(fault == *pLast_fault)   return;
+
+    uint8_t data[2] = {fault, *pLast_fault};
+    *pLast_fault = fault;
+
+    sendFrame(TLM_CHANNEL_FAULT, data, sizeof(data));
+}
+
+/***************************************************************************//*!
+*  \brief Send tasks.
+*
+*   This function sends the task statistics of the last window, in as many
+*   frames as needed (TLM_TASKS_PER_FRAME tasks per frame).
+*
+*   Preconditions: Called from the telemetry task.
+*
+*   Side Effects: None.
+*
+*******************************************************************************/
+static void sendTasks(void){
+
+    uint8_t data[TLM_MAX_DATA_SIZE];
+    TSTAT_Summary_t summary = {0};
+    uint32_t nb_tasks = TSTAT_GetTasks(task_stats, &summary);
+
+    if(summary.nb_windows == 0) return;
+
+    for(uint32_t first=0; first<nb_tasks; first+=TLM_TASKS_PER_FRAME){
+
+        uint32_t nb_records = nb_tasks - first;
+        if(nb_records > TLM_TASKS_PER_FRAME)    nb_records = TLM_TASKS_PER_FRAME;
+
+        memset(data, 0, TLM_TASK_HEADER_SIZE + (nb_records * TLM_TASK_RECORD_SIZE));
+        data[0] = (uint8_t)nb_tasks;
+        data[1] = (uint8_t)first;
+        for(uint32_t core=0; core<configNUMBER_OF_CORES; core++){
+            TLM_PUT_U16(&data[2 + (2 * core)], summary.load_permille[core]);
+        }
+
+        for(uint32_t i=0; i<nb_records; i++){
+
+            const TSTAT_Task_Stats_t *pStats = &task_stats[first + i];
+            uint8_t *p = &data[TLM_TASK_HEADER_SIZE + (i * TLM_TASK_RECORD_SIZE)];
+
+            strncpy((char *)p, pStats->name, TLM_TASK_NAME_SIZE);
+            p += TLM_TASK_NAME_SIZE;
+            p[0] = (pStats->core_id == tskNO_AFFINITY) ? TLM_TASK_CORE_FLOATING : (uint8_t)pStats->core_id;
+            TLM_PUT_U16(&p[1], pStats->cpu_permille);
+            TLM_PUT_U16(&p[3], TLM_SAT_U16(pStats->stack_free));
+            TLM_PUT_U16(&p[5], TLM_SAT_U16(pStats->wakeups_per_s));
+            TLM_PUT_U16(&p[7], TLM_SAT_U16(pStats->max_latency_us));
+        }
+
+        sendFrame(TLM_CHANNEL_TASKS, data, TLM_TASK_HEADER_SIZE + (nb_records * TLM_TASK_RECORD_SIZE));
+    }
+}
+
+/***************************************************************************//*!
+*  \brief Telemetry task.
+*
+*   This function is the telemetry task. It sleeps until the next channel
+*   period or an ADC frame, then sends the frames due.
+*
+*   Preconditions: None.
+*
+*******************************************************************************/
+static void tTelemetryTask(void *pvParameters){
+
+    uint32_t period_ms[TLM_CHANNEL_INVALID] = {0};
+    TickType_t next_tick[TLM_CHANNEL_INVALID] = {0};
+    uint8_t last_fault = CREG_FAULT_NONE;
+    TickType_t wait_ticks = portMAX_DELAY;
+    bool is_active = false;
+
+    ESP_LOGI(TAG, "Starting telemetry task");
+
+    for(;;){
+
+        uint32_t nb_notify = ulTaskNotifyTake(pdTRUE, wait_ticks);
+        TSTAT_MarkRunning(nb_notify == 0);
+
+        uint32_t start_cycles = esp_cpu_get_cycle_count();
+        TickType_t now = xTaskGetTickCount();
+
+        xSemaphoreTake(tlm_mutex_handle, portMAX_DELAY);
+        is_active = tlm_is_enabled;
+        for(uint8_t channel=0; channel<TLM_CHANNEL_INVALID; channel++){
+
+            //Period changed: due now
+            if(period_ms[channel] != channel_period_ms[channel]){
+                period_ms[channel] = channel_period_ms[channel];
+                next_tick[channel] = now;
+            }
+        }
+        xSemaphoreGive(tlm_mutex_handle);
+
+        wait_ticks = portMAX_DELAY;
+
+        if(!is_active){
+            //Frames queued while disabled are dropped
+            __atomic_store_n(&adc_frame_tail, __atomic_load_n(&adc_frame_head, __ATOMIC_ACQUIRE), __ATOMIC_RELEASE);
+            continue;
+        }
+
+        sendAdcFrames();
+
+        for(uint8_t channel=0; channel<TLM_CHANNEL_INVALID; channel++){
+
+            if((channel == TLM_CHANNEL_ADC_RAW) || (period_ms[channel] == 0))  continue;
+
+            TickType_t period_ticks = pdMS_TO_TICKS(period_ms[channel]);
+            if(period_ticks == 0)   period_ticks = 1;
+
+            int32_t remaining = (int32_t)(next_tick[channel] - now);
+
+            if(remaining <= 0){
+
+                switch(channel){
+                    case TLM_CHANNEL_POWER:     sendPower();                break;
+                    case TLM_CHANNEL_REGULATOR: sendRegulator();            break;
+                    case TLM_CHANNEL_FAULT:     sendFault(&last_fault);     break;
+                    case TLM_CHANNEL_TASKS:     sendTasks();                break;
+                    default:                                                break;
+                }
+
+                //Keep the rate, restart if more than a period late
+                next_tick[channel] += period_ticks;
+                if((int32_t)(next_tick[channel] - now) <= 0)    next_tick[channel] = now + period_ticks;
+                remaining = (int32_t)(next_tick[channel] - now);
+            }
+
+            if((TickType_t)remaining < wait_ticks)  wait_ticks = (TickType_t)remaining;
+        }
+
+        uint32_t cycles = esp_cpu_get_cycle_count() - start_cycles;
+
+        portENTER_CRITICAL(&tlm_spinlock);
+        tlm_stats.busy_cycles += cycles;
+        portEXIT_CRITICAL(&tlm_spinlock);
+    }
+    vTaskDelete(NULL);
+}
+
+/******************************************************************************
+*   CallBack Functions implementation
+*******************************************************************************/
+/***************************************************************************//*!
+*  \brief ADC frame callback.
+*
+*   This function is the ADC continuous sampling callback (ISR). Every
+*   divider-th frame is copied to the mailbox for the telemetry task.
+*
+*   Preconditions: None.
+*
+*   \param[in]  pResults            Raw conversions.
+*   \param[in]  frame_size          Frame size in bytes.
+*
+*******************************************************************************/
+static void IRAM_ATTR adcFrameCallback(uint8_t *pResults, uint32_t frame_size){
+
+    bool is_overrun = false;
+
+    if(++adc_divider_count < adc_divider){
+        portENTER_CRITICAL_ISR(&tlm_spinlock);
+        tlm_stats.nb_adc_frames++;
+        portEXIT_CRITICAL_ISR(&tlm_spinlock);
+        return;
+    }
+    adc_divider_count = 0;
+
+    uint32_t head = adc_frame_head;
+
+    if((head - __atomic_load_n(&adc_frame_tail, __ATOMIC_ACQUIRE)) >= TLM_ADC_NB_FRAMES){
+        is_overrun = true;
+    }else{
+        TLM_Adc_Frame_t *pFrame = &adc_frames[head & (TLM_ADC_NB_FRAMES - 1)];
+
+        pFrame->size = (frame_size < TLM_ADC_MAX_FRAME_SIZE) ? frame_size : TLM_ADC_MAX_FRAME_SIZE;
+        memcpy(pFrame->data, pResults, pFrame->size);
+
+        __atomic_store_n(&adc_frame_head, head + 1, __ATOMIC_RELEASE);
+    }
+
+    portENTER_CRITICAL_ISR(&tlm_spinlock);
+    tlm_stats.nb_adc_frames++;
+    if(is_overrun)  tlm_stats.nb_adc_overruns++;
+    portEXIT_CRITICAL_ISR(&tlm_spinlock);
+
+    if(!is_overrun){
+        BaseType_t is_woken = pdFALSE;
+        TSTAT_MarkReady(tlm_task_handle);
+        vTaskNotifyGiveFromISR(tlm_task_handle, &is_woken);
+        if(is_woken)    portYIELD_FROM_ISR();
+    }
+}
+
+/******************************************************************************
+*   Public Functions Definitions
+*******************************************************************************/
+/***************************************************************************//*!
+*  \brief Telemetry initialization.
+*
+*   This function is used to initialize the telemetry stream: binary frames
+*   multiplexed with the shell text on the shell port (decoded on the host
+*   with tools/tlm_decode.py). The stream is disabled and every channel off.
+*
+*   Preconditions: Shell communication initialized.
+*
+*   Side Effects: None.
+*
+*   \return     Operation status
+*
+*******************************************************************************/
+TLM_Ret_t TLM_InitTelemetry(void){
+
+    //Create mutex
+    tlm_mutex_handle = xSemaphoreCreateMutexStatic(&tlm_mutex_buffer);
+    if(tlm_mutex_handle == NULL){
+        ESP_LOGE(TAG, "Failed to create telemetry mutex");
+        return TLM_STATUS_ERROR;
+    }
+
+    //Create task
+    tlm_task_handle = xTaskCreateStaticPinnedToCore(tTelemetryTask,
+                                                    "Telemetry task",
+                                                    TLM_TASK_STACK_SIZE,
+                                                    NULL,
+                                                    TLM_TASK_PRIORITY,
+                                                    tlm_task_stack,
+                                                    &tlm_task_buffer,
+                                                    TLM_TASK_CORE);
+    if(tlm_task_handle == NULL){
+
+        ESP_LOGE(TAG, "Failed to create telemetry task");
+        return TLM_STATUS_ERROR;
+    }
+
+    return TLM_STATUS_OK;
+}
+
+/***************************************************************************//*!
+*  \brief Enable telemetry.
+*
+*   This function is used to enable or disable the telemetry stream. The
+*   channel settings are kept.
+*
+*   Preconditions: Telemetry initialized.
+*
+*   Side Effects: None.
+*
+*   \param[in]  is_enabled          Stream enabled.
+*
+*   \return     Operation status
+*
+*******************************************************************************/
+TLM_Ret_t TLM_SetEnable(bool is_enabled){
+
+    if(tlm_task_handle == NULL) return TLM_STATUS_ERROR;
+
+    xSemaphoreTake(tlm_mutex_handle, portMAX_DELAY);
+    tlm_is_enabled = is_enabled;
+    xSemaphoreGive(tlm_mutex_handle);
+
+    xTaskNotifyGive(tlm_task_handle);
+
+    return TLM_STATUS_OK;
+}
+
+/***************************************************************************//*!
+*  \brief Set telemetry channel period.
+*
+*   This function is used to set the period of a sampled channel (power,
+*   regulator, tasks) or the poll period of the fault channel. 0 turns the
+*   channel off. The raw ADC channel rate is set with TLM_StartAdcStream().
+*   The task statistics change every TSTAT_WINDOW_MS.
+*
+*   Preconditions: Telemetry initialized.
+*
+*   Side Effects: None.
+*
+*   \param[in]  channel             Channel.
+*   \param[in]  period_ms           Period (0, TLM_MIN_PERIOD_MS to TLM_MAX_PERIOD_MS).
+*
+*   \return     Operation status
+*
+*******************************************************************************/
+TLM_Ret_t TLM_SetChannelPeriod(TLM_Channel_t channel, uint32_t period_ms){
+
+    if(tlm_task_handle == NULL) return TLM_STATUS_ERROR;
+    if((channel == TLM_CHANNEL_ADC_RAW) || (channel >= TLM_CHANNEL_INVALID))    return TLM_STATUS_ERROR;
+    if((period_ms != 0) && ((period_ms < TLM_MIN_PERIOD_MS) || (period_ms > TLM_MAX_PERIOD_MS))){
+        return TLM_STATUS_ERROR;
+    }
+
+    xSemaphoreTake(tlm_mutex_handle, portMAX_DELAY);
+    channel_period_ms[channel] = period_ms;
+    xSemaphoreGive(tlm_mutex_handle);
+
+    xTaskNotifyGive(tlm_task_handle);
+
+    return TLM_STATUS_OK;
+}
+
+/***************************************************************************//*!
+*  \brief Start raw ADC stream.
+*
+*   This function is used to start the ADC continuous sampling of the bus
+*   voltage and phase currents. Every divider-th ADC frame (from the ADC
+*   continuous callback) is streamed on the raw ADC channel.
+*
+*   Preconditions: Telemetry initialized, ADC not used (regulator stopped).
+*
+*   Side Effects: None.
+*
+*   \param[in]  sample_freq_hz      ADC sampling frequency.
+*   \param[in]  divider             Frame decimation (1 to TLM_ADC_MAX_DIVIDER).
+*
+*   \return     Operation status
+*
+*******************************************************************************/
+TLM_Ret_t TLM_StartAdcStream(uint32_t sample_freq_hz, uint32_t divider){
+
+    if(tlm_task_handle == NULL) return TLM_STATUS_ERROR;
+    if((divider == 0) || (divider > TLM_ADC_MAX_DIVIDER))   return TLM_STATUS_ERROR;
+
+    //The regulator owns the ADC while running
+    if(CREG_IsRunning())    return TLM_STATUS_ERROR;
+
+    xSemaphoreTake(tlm_mutex_handle, portMAX_DELAY);
+
+    if(is_adc_streaming){
+        xSemaphoreGive(tlm_mutex_handle);
+        return TLM_STATUS_ERROR;
+    }
+
+    adc_divider = divider;
+    adc_divider_count = 0;
+
+    ADC_Ctrl_ContinuousConfig_t config = {
+        .channel_mask = TLM_ADC_CHANNEL_MASK,
+        .ctrl_atten = TLM_ADC_ATTEN,
+        .nb_sample = TLM_ADC_SAMPLES_PER_FRAME,
+        .sample_freq_hz = sample_freq_hz,
+        .callback = adcFrameCallback,
+    };
+
+    if(ADC_CTRL_STATUS_SUCCESS != ADC_StartSampling(ADC_CTRL_MODE_CONTINUOUS, &config)){
+        xSemaphoreGive(tlm_mutex_handle);
+        ESP_LOGE(TAG, "Failed to start ADC continuous sampling");
+        return TLM_STATUS_ERROR;
+    }
+
+    is_adc_streaming = true;
+    xSemaphoreGive(tlm_mutex_handle);
+
+    return TLM_STATUS_OK;
+}
+
+/***************************************************************************//*!
+*  \brief Stop raw ADC stream.
+*
+*   This function is used to stop the ADC continuous sampling started by
+*   TLM_StartAdcStream().
+*
+*   Preconditions: None.
+*
+*   Side Effects: None.
+*
+*   \return     Operation status
+*
+*******************************************************************************/
+TLM_Ret_t TLM_StopAdcStream(void){
+
+    if(tlm_task_handle == NULL) return TLM_STATUS_ERROR;
+
+    xSemaphoreTake(tlm_mutex_handle, portMAX_DELAY);
+
+    if(!is_adc_streaming){
+        xSemaphoreGive(tlm_mutex_handle);
+        return TLM_STATUS_OK;
+    }
+
+    if(ADC_CTRL_STATUS_SUCCESS != ADC_ReleaseAdcController(TLM_ADC_CHANNEL_MASK)){
+        xSemaphoreGive(tlm_mutex_handle);
+        return TLM_STATUS_ERROR;
+    }
+
+    is_adc_streaming = false;
+    xSemaphoreGive(tlm_mutex_handle);
+
+    return TLM_STATUS_OK;
+}
+
+/***************************************************************************//*!
+*  \brief Get telemetry statistics.
+*
+*   This function is used to get the telemetry statistics.
+*
+*   Preconditions: None.
+*
+*   Side Effects: None.
+*
+*   \param[out] pStats              Pointer to store the statistics.
+*
+*   \return     Operation status
+*
+*******************************************************************************/
+TLM_Ret_t TLM_GetStats(TLM_Stats_t *pStats){
+
+    if(pStats == NULL)  return TLM_STATUS_ERROR;
+
+    portENTER_CRITICAL(&tlm_spinlock);
+    *pStats = tlm_stats;
+    portEXIT_CRITICAL(&tlm_spinlock);
+
+    pStats->is_enabled = tlm_is_enabled;
+
+    return TLM_STATUS_OK;
+}
+
+/******************************************************************************
+*   Interrupts
+*******************************************************************************/
@@ -0,0 +1,185 @@
+#ifndef __TELEMETRY_H
+#define __TELEMETRY_H
+
+#include <stdint.h>
+#include <stdbool.h>
+
+/******************************************************************************
+*   Public Definitions
+*******************************************************************************/
+//Frame on the shell port: TLM_FRAME_START, COBS(payload), TLM_FRAME_END.
+//Payload (little endian): channel (u8), sequence (u16), timestamp us (u32),
+//data, CRC-16/X-25 of the previous fields (u16).
+#define TLM_FRAME_START                     (0x1E)//ASCII RS, never in the shell text
+#define TLM_FRAME_END                       (0x00)//COBS delimiter
+#define TLM_FRAME_HEADER_SIZE               (7)
+#define TLM_FRAME_CRC_SIZE                  (2)
+
+#define TLM_MAX_DATA_SIZE                   (256)
+#define TLM_ADC_MAX_FRAME_SIZE              (TLM_MAX_DATA_SIZE - 2)//Overrun counter first
+
+#define TLM_MIN_PERIOD_MS                   (1)
+#define TLM_MAX_PERIOD_MS                   (60000)
+#define TLM_DEFAULT_FAULT_PERIOD_MS         (10)//Fault flags poll
+
+#define TLM_ADC_SAMPLES_PER_FRAME           (16)//Per channel
+#define TLM_ADC_MAX_DIVIDER                 (1000)
+
+#define TLM_TASK_NAME_SIZE                  (8)//Truncated
+#define TLM_TASK_NB_CORES                   (2)
+#define TLM_TASK_HEADER_SIZE                (2 + (2 * TLM_TASK_NB_CORES))
+#define TLM_TASK_RECORD_SIZE                (TLM_TASK_NAME_SIZE + 9)
+#define TLM_TASKS_PER_FRAME                 ((TLM_MAX_DATA_SIZE - TLM_TASK_HEADER_SIZE) / TLM_TASK_RECORD_SIZE)
+
+/******************************************************************************
+*   Public Macros
+*******************************************************************************/
+
+
+/******************************************************************************
+*   Public Data Types
+*******************************************************************************/
+typedef enum TLM_Channel_e{
+    TLM_CHANNEL_ADC_RAW,                //Overrun counter (u16), raw ADC conversions (u32 each)
+    TLM_CHANNEL_POWER,                  //Bus voltage 10mV, phase A and B current 10mA (i16)
+    TLM_CHANNEL_REGULATOR,              //Per phase: setpoint, target, current (i16), duty (u16), flags (u8)
+    TLM_CHANNEL_FAULT,                  //Fault flags, previous fault flags (u8), on change only
+    TLM_CHANNEL_TASKS,                  //Number of tasks, first task (u8), core loads permille (u16), per task:
+                                        //name (8 chars), core (u8), CPU permille, stack free bytes,
+                                        //wakeups/s, max latency us (u16). Split in frames of TLM_TASKS_PER_FRAME
+
+    TLM_CHANNEL_INVALID,
+}TLM_Channel_t;
+
+typedef struct TLM_Stats_s{
+    bool is_enabled;
+    uint32_t nb_frames;                 //Frames written
+    uint32_t nb_bytes;                  //Encoded bytes written
+    uint32_t nb_dropped;                //Output ring full (sequence gap on the host)
+    uint32_t nb_adc_frames;             //ADC frames received (before decimation)
+    uint32_t nb_adc_overruns;           //ADC frames lost, telemetry task late
+    uint64_t busy_cycles;               //Telemetry task CPU cycles
+}TLM_Stats_t;
+
+typedef enum TLM_Ret_e{
+    TLM_STATUS_ERROR,
+    TLM_STATUS_OK,
+}TLM_Ret_t;
+
+/******************************************************************************
+*   Public Variables
+*******************************************************************************/
+
+
+/******************************************************************************
+*   Error Check
+*******************************************************************************/
+
+
+/******************************************************************************
+*   Public Functions Declarations
+*******************************************************************************/
+/***************************************************************************//*!
+*  \brief Telemetry initialization.
+*
+*   This function is used to initialize the telemetry stream: binary frames
+*   multiplexed with the shell text on the shell port (decoded on the host
+*   with tools/tlm_decode.py). The stream is disabled and every channel off.
+*
+*   Preconditions: Shell communication initialized.
+*
+*   Side Effects: None.
+*
+*   \return     Operation status
+*
+*******************************************************************************/
+TLM_Ret_t TLM_InitTelemetry(void);
+
+/***************************************************************************//*!
+*  \brief Enable telemetry.
+*
+*   This function is used to enable or disable the telemetry stream. The
+*   channel settings are kept.
+*
+*   Preconditions: Telemetry initialized.
+*
+*   Side Effects: None.
+*
+*   \param[in]  is_enabled          Stream enabled.
+*
+*   \return     Operation status
+*
+*******************************************************************************/
+TLM_Ret_t TLM_SetEnable(bool is_enabled);
+
+/***************************************************************************//*!
+*  \brief Set telemetry channel period.
+*
+*   This function is used to set the period of a sampled channel (power,
+*   regulator, tasks) or the poll period of the fault channel. 0 turns the
+*   channel off. The raw ADC channel rate is set with TLM_StartAdcStream().
+*   The task statistics change every TSTAT_WINDOW_MS.
+*
+*   Preconditions: Telemetry initialized.
+*
+*   Side Effects: None.
+*
+*   \param[in]  channel             Channel.
+*   \param[in]  period_ms           Period (0, TLM_MIN_PERIOD_MS to TLM_MAX_PERIOD_MS).
+*
+*   \return     Operation status
+*
+*******************************************************************************/
+TLM_Ret_t TLM_SetChannelPeriod(TLM_Channel_t channel, uint32_t period_ms);
+
+/***************************************************************************//*!
+*  \brief Start raw ADC stream.
+*
+*   This function is used to start the ADC continuous sampling of the bus
+*   voltage and phase currents. Every divider-th ADC frame (from the ADC
+*   continuous callback) is streamed on the raw ADC channel.
+*
+*   Preconditions: Telemetry initialized, ADC not used (regulator stopped).
+*
+*   Side Effects: None.
+*
+*   \param[in]  sample_freq_hz      ADC sampling frequency.
+*   \param[in]  divider             Frame decimation (1 to TLM_ADC_MAX_DIVIDER).
+*
+*   \return     Operation status
+*
+*******************************************************************************/
+TLM_Ret_t TLM_StartAdcStream(uint32_t sample_freq_hz, uint32_t divider);
+
+/***************************************************************************//*!
+*  \brief Stop raw ADC stream.
+*
+*   This function is used to stop the ADC continuous sampling started by
+*   TLM_StartAdcStream().
+*
+*   Preconditions: None.
+*
+*   Side Effects: None.
+*
+*   \return     Operation status
+*
+*******************************************************************************/
+TLM_Ret_t TLM_StopAdcStream(void);
+
+/***************************************************************************//*!
+*  \brief Get telemetry statistics.
+*
+*   This function is used to get the telemetry statistics.
+*
+*   Preconditions: None.
+*
+*   Side Effects: None.
+*
+*   \param[out] pStats              Pointer to store the statistics.
+*
+*   \return     Operation status
+*
+*******************************************************************************/
+TLM_Ret_t TLM_GetStats(TLM_Stats_t *pStats);
+
+#endif//__TELEMETRY_H
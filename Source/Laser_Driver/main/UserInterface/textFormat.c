@@ -0,0 +1,319 @@
+#include <string.h>
+
+#include "textFormat.h"
+
+/******************************************************************************
+*   Private Definitions
+*******************************************************************************/
+#define FMT_MAX_DEC_DIGITS                  (10)//UINT32_MAX
+#define FMT_MAX_HEX_DIGITS                  (8)
+#define FMT_MAX_DECIMALS                    (9)
+
+/******************************************************************************
+*   Private Macros
+*******************************************************************************/
+#define FMT_ABS(value)                      (((value) < 0) ? (0U - (uint32_t)(value)) : (uint32_t)(value))
+
+/******************************************************************************
+*   Private Data Types
+*******************************************************************************/
+
+
+/******************************************************************************
+*   Private Functions Declaration
+*******************************************************************************/
+static size_t appendDecimal(FMT_Buffer_t *pFmt, uint32_t value, uint8_t min_digits);
+
+/******************************************************************************
+*   Public Variables
+*******************************************************************************/
+
+
+/******************************************************************************
+*   Private Variables
+*******************************************************************************/
+static const uint32_t fmt_pow10[FMT_MAX_DECIMALS + 1] = {
+    1, 10, 100, 1000, 10000, 100000, 1000000, 10000000, 100000000, 1000000000,
+};
+
+static const char fmt_hex_digits[16] = "0123456789ABCDEF";
+
+static const struct{
+    uint8_t decimals;
+    const char *pSymbol;
+}fmt_units[FMT_UNIT_INVALID] = {
+    [FMT_UNIT_10MV] = {2, "V"},
+    [FMT_UNIT_10MA] = {2, "A"},
+    [FMT_UNIT_CENTI_DEG] = {2, "C"},
+    [FMT_UNIT_CENTI_PERCENT] = {2, "%"},
+};
+
+/******************************************************************************
+*   Error Check
+*******************************************************************************/
+
+
+/******************************************************************************
+*   Private Functions Definitions
+*******************************************************************************/
+/***************************************************************************//*!
+*  \brief Append decimal.
+*
+*   This function appends the decimal digits of a value, zero padded to a
+*   minimum number of digits.
+*
+*******************************************************************************/
+static size_t appendDecimal(FMT_Buffer_t *pFmt, uint32_t value, uint8_t min_digits){
+
+    char digits[FMT_MAX_DEC_DIGITS];
+    uint8_t nb_digits = 0;
+
+    if(min_digits > FMT_MAX_DEC_DIGITS) min_digits = FMT_MAX_DEC_DIGITS;
+
+    do{
+        digits[nb_digits++] = (char)('0' + (value % 10));
+        value /= 10;
+    }while((value != 0) || (nb_digits < min_digits));
+
+    while(nb_digits > 0){
+        FMT_Char(pFmt, digits[--nb_digits]);
+    }
+
+    return pFmt->len;
+}
+
+/******************************************************************************
+*   CallBack Functions implementation
+*******************************************************************************/
+
+
+/******************************************************************************
+*   Public Functions Definitions
+*******************************************************************************/
+/***************************************************************************//*!
+*  \brief Format init.
+*
+*   This function is use to attach a caller buffer (empty string).
+*
+*   Preconditions: None.
+*
+*   \param[out] pFmt                Format buffer.
+*   \param[in]  pBuffer             Caller buffer.
+*   \param[in]  size                Caller buffer size (terminator included).
+*
+*******************************************************************************/
+void FMT_Init(FMT_Buffer_t *pFmt, char *pBuffer, size_t size){
+
+    pFmt->pBuffer = pBuffer;
+    pFmt->size = size;
+    pFmt->len = 0;
+    pFmt->is_truncated = (pBuffer == NULL) || (size == 0);
+
+    if(!pFmt->is_truncated) pBuffer[0] = '\0';
+}
+
+/***************************************************************************//*!
+*  \brief Format character.
+*
+*   This function is use to append a character.
+*
+*   Preconditions: Format buffer initialized.
+*
+*   \param[in]  pFmt                Format buffer.
+*   \param[in]  c                   Character.
+*
+*   \return     String length.
+*
+*******************************************************************************/
+size_t FMT_Char(FMT_Buffer_t *pFmt, char c){
+
+    if(pFmt->is_truncated)  return pFmt->len;
+
+    if((pFmt->len + 1) >= pFmt->size){
+        pFmt->is_truncated = true;
+        return pFmt->len;
+    }
+
+    pFmt->pBuffer[pFmt->len++] = c;
+    pFmt->pBuffer[pFmt->len] = '\0';
+
+    return pFmt->len;
+}
+
+/***************************************************************************//*!
+*  \brief Format string.
+*
+*   This function is use to append a string.
+*
+*   Preconditions: Format buffer initialized.
+*
+*   \param[in]  pFmt                Format buffer.
+*   \param[in]  pString             String.
+*
+*   \return     String length.
+*
+*******************************************************************************/
+size_t FMT_String(FMT_Buffer_t *pFmt, const char *pString){
+
+    if(pString == NULL) return pFmt->len;
+
+    while((*pString != '\0') && !pFmt->is_truncated){
+        FMT_Char(pFmt, *pString++);
+    }
+
+    return pFmt->len;
+}
+
+/***************************************************************************//*!
+*  \brief Format padding.
+*
+*   This function is use to append spaces up to a column (left aligned
+*   field, "%-*s").
+*
+*   Preconditions: Format buffer initialized.
+*
+*   \param[in]  pFmt                Format buffer.
+*   \param[in]  column              Column reached.
+*
+*   \return     String length.
+*
+*******************************************************************************/
+size_t FMT_Pad(FMT_Buffer_t *pFmt, size_t column){
+
+    while((pFmt->len < column) && !pFmt->is_truncated){
+        FMT_Char(pFmt, ' ');
+    }
+
+    return pFmt->len;
+}
+
+/***************************************************************************//*!
+*  \brief Format unsigned integer.
+*
+*   This function is use to append an unsigned decimal integer ("%lu").
+*
+*   Preconditions: Format buffer initialized.
+*
+*   \param[in]  pFmt                Format buffer.
+*   \param[in]  value               Value.
+*
+*   \return     String length.
+*
+*******************************************************************************/
+size_t FMT_Uint(FMT_Buffer_t *pFmt, uint32_t value){
+
+    return appendDecimal(pFmt, value, 1);
+}
+
+/***************************************************************************//*!
+*  \brief Format signed integer.
+*
+*   This function is use to append a signed decimal integer ("%ld").
+*
+*   Preconditions: Format buffer initialized.
+*
+*   \param[in]  pFmt                Format buffer.
+*   \param[in]  value               Value.
+*
+*   \return     String length.
+*
+*******************************************************************************/
+size_t FMT_Int(FMT_Buffer_t *pFmt, int32_t value){
+
+    if(value < 0)   FMT_Char(pFmt, '-');
+
+    return appendDecimal(pFmt, FMT_ABS(value), 1);
+}
+
+/***************************************************************************//*!
+*  \brief Format hexadecimal.
+*
+*   This function is use to append an upper case hexadecimal integer, zero
+*   padded to a number of digits ("%0*lX", no prefix).
+*
+*   Preconditions: Format buffer initialized.
+*
+*   \param[in]  pFmt                Format buffer.
+*   \param[in]  value               Value.
+*   \param[in]  nb_digits           Minimum number of digits (0 to 8).
+*
+*   \return     String length.
+*
+*******************************************************************************/
+size_t FMT_Hex(FMT_Buffer_t *pFmt, uint32_t value, uint8_t nb_digits){
+
+    int8_t digit = FMT_MAX_HEX_DIGITS - 1;
+
+    if(nb_digits > FMT_MAX_HEX_DIGITS)  nb_digits = FMT_MAX_HEX_DIGITS;
+
+    //Skip the leading zeros (one digit at least)
+    while((digit > 0) && (digit >= nb_digits) && (((value >> (digit * 4)) & 0x0F) == 0)){
+        digit--;
+    }
+
+    for(; digit>=0; digit--){
+        FMT_Char(pFmt, fmt_hex_digits[(value >> (digit * 4)) & 0x0F]);
+    }
+
+    return pFmt->len;
+}
+
+/***************************************************************************//*!
+*  \brief Format fixed point.
+*
+*   This function is use to append a fixed point value (250, 2 decimals
+*   -> "2.50", -5, 2 decimals -> "-0.05").
+*
+*   Preconditions: Format buffer initialized.
+*
+*   \param[in]  pFmt                Format buffer.
+*   \param[in]  value               Value.
+*   \param[in]  decimals            Number of decimals (0 to 9).
+*
+*   \return     String length.
+*
+*******************************************************************************/
+size_t FMT_Fixed(FMT_Buffer_t *pFmt, int32_t value, uint8_t decimals){
+
+    uint32_t abs_value = FMT_ABS(value);
+
+    if(decimals > FMT_MAX_DECIMALS) decimals = FMT_MAX_DECIMALS;
+
+    if(value < 0)   FMT_Char(pFmt, '-');
+
+    appendDecimal(pFmt, abs_value / fmt_pow10[decimals], 1);
+
+    if(decimals == 0)   return pFmt->len;
+
+    FMT_Char(pFmt, '.');
+
+    return appendDecimal(pFmt, abs_value % fmt_pow10[decimals], decimals);
+}
+
+/***************************************************************************//*!
+*  \brief Format unit value.
+*
+*   This function is use to append a value in a project unit, with its
+*   decimals and unit symbol (2412 in 10mV -> "24.12V").
+*
+*   Preconditions: Format buffer initialized.
+*
+*   \param[in]  pFmt                Format buffer.
+*   \param[in]  value               Value.
+*   \param[in]  unit                Value unit.
+*
+*   \return     String length.
+*
+*******************************************************************************/
+size_t FMT_Unit(FMT_Buffer_t *pFmt, int32_t value, FMT_Unit_t unit){
+
+    if(unit >= FMT_UNIT_INVALID)    return FMT_Int(pFmt, value);
+
+    FMT_Fixed(pFmt, value, fmt_units[unit].decimals);
+
+    return FMT_String(pFmt, fmt_units[unit].pSymbol);
+}
+
+/******************************************************************************
+*   Interrupts
+*******************************************************************************/
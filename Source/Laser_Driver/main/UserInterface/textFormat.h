@@ -0,0 +1,194 @@
+#ifndef __TEXT_FORMAT_H
+#define __TEXT_FORMAT_H
+
+#include <stdint.h>
+#include <stdbool.h>
+#include <stddef.h>
+
+/******************************************************************************
+*   Public Definitions
+*******************************************************************************/
+
+
+/******************************************************************************
+*   Public Macros
+*******************************************************************************/
+
+
+/******************************************************************************
+*   Public Data Types
+*******************************************************************************/
+//Caller buffer, always NUL terminated. Output not fitting is cut and
+//flagged, the following calls do nothing.
+typedef struct FMT_Buffer_s{
+    char *pBuffer;
+    size_t size;                        //Buffer size (terminator included)
+    size_t len;                         //Characters written
+    bool is_truncated;
+}FMT_Buffer_t;
+
+//Project fixed point units
+typedef enum FMT_Unit_e{
+    FMT_UNIT_10MV,                      //Voltage in 10mV (2412 -> "24.12V")
+    FMT_UNIT_10MA,                      //Current in 10mA (-50 -> "-0.50A")
+    FMT_UNIT_CENTI_DEG,                 //Temperature in 0.01C (TEMP_Conv_t, 4567 -> "45.67C")
+    FMT_UNIT_CENTI_PERCENT,             //Ratio in 0.01% (5000 -> "50.00%")
+
+    FMT_UNIT_INVALID,
+}FMT_Unit_t;
+
+/******************************************************************************
+*   Public Variables
+*******************************************************************************/
+
+
+/******************************************************************************
+*   Error Check
+*******************************************************************************/
+
+
+/******************************************************************************
+*   Public Functions Declarations
+*******************************************************************************/
+/***************************************************************************//*!
+*  \brief Format init.
+*
+*   This function is use to attach a caller buffer (empty string).
+*
+*   Preconditions: None.
+*
+*   \param[out] pFmt                Format buffer.
+*   \param[in]  pBuffer             Caller buffer.
+*   \param[in]  size                Caller buffer size (terminator included).
+*
+*******************************************************************************/
+void FMT_Init(FMT_Buffer_t *pFmt, char *pBuffer, size_t size);
+
+/***************************************************************************//*!
+*  \brief Format character.
+*
+*   This function is use to append a character.
+*
+*   Preconditions: Format buffer initialized.
+*
+*   \param[in]  pFmt                Format buffer.
+*   \param[in]  c                   Character.
+*
+*   \return     String length.
+*
+*******************************************************************************/
+size_t FMT_Char(FMT_Buffer_t *pFmt, char c);
+
+/***************************************************************************//*!
+*  \brief Format string.
+*
+*   This function is use to append a string.
+*
+*   Preconditions: Format buffer initialized.
+*
+*   \param[in]  pFmt                Format buffer.
+*   \param[in]  pString             String.
+*
+*   \return     String length.
+*
+*******************************************************************************/
+size_t FMT_String(FMT_Buffer_t *pFmt, const char *pString);
+
+/***************************************************************************//*!
+*  \brief Format padding.
+*
+*   This function is use to append spaces up to a column (left aligned
+*   field, "%-*s").
+*
+*   Preconditions: Format buffer initialized.
+*
+*   \param[in]  pFmt                Format buffer.
+*   \param[in]  column              Column reached.
+*
+*   \return     String length.
+*
+*******************************************************************************/
+size_t FMT_Pad(FMT_Buffer_t *pFmt, size_t column);
+
+/***************************************************************************//*!
+*  \brief Format unsigned integer.
+*
+*   This function is use to append an unsigned decimal integer ("%lu").
+*
+*   Preconditions: Format buffer initialized.
+*
+*   \param[in]  pFmt                Format buffer.
+*   \param[in]  value               Value.
+*
+*   \return     String length.
+*
+*******************************************************************************/
+size_t FMT_Uint(FMT_Buffer_t *pFmt, uint32_t value);
+
+/***************************************************************************//*!
+*  \brief Format signed integer.
+*
+*   This function is use to append a signed decimal integer ("%ld").
+*
+*   Preconditions: Format buffer initialized.
+*
+*   \param[in]  pFmt                Format buffer.
+*   \param[in]  value               Value.
+*
+*   \return     String length.
+*
+*******************************************************************************/
+size_t FMT_Int(FMT_Buffer_t *pFmt, int32_t value);
+
+/***************************************************************************//*!
+*  \brief Format hexadecimal.
+*
+*   This function is use to append an upper case hexadecimal integer, zero
+*   padded to a number of digits ("%0*lX", no prefix).
+*
+*   Preconditions: Format buffer initialized.
+*
+*   \param[in]  pFmt                Format buffer.
+*   \param[in]  value               Value.
+*   \param[in]  nb_digits           Minimum number of digits (0 to 8).
+*
+*   \return     String length.
+*
+*******************************************************************************/
+size_t FMT_Hex(FMT_Buffer_t *pFmt, uint32_t value, uint8_t nb_digits);
+
+/***************************************************************************//*!
+*  \brief Format fixed point.
+*
+*   This function is use to append a fixed point value (250, 2 decimals
+*   -> "2.50", -5, 2 decimals -> "-0.05").
+*
+*   Preconditions: Format buffer initialized.
+*
+*   \param[in]  pFmt                Format buffer.
+*   \param[in]  value               Value.
+*   \param[in]  decimals            Number of decimals (0 to 9).
+*
+*   \return     String length.
+*
+*******************************************************************************/
+size_t FMT_Fixed(FMT_Buffer_t *pFmt, int32_t value, uint8_t decimals);
+
+/***************************************************************************//*!
+*  \brief Format unit value.
+*
+*   This function is use to append a value in a project unit, with its
+*   decimals and unit symbol (2412 in 10mV -> "24.12V").
+*
+*   Preconditions: Format buffer initialized.
+*
+*   \param[in]  pFmt                Format buffer.
+*   \param[in]  value               Value.
+*   \param[in]  unit                Value unit.
+*
+*   \return     String length.
+*
+*******************************************************************************/
+size_t FMT_Unit(FMT_Buffer_t *pFmt, int32_t value, FMT_Unit_t unit);
+
+#endif//__TEXT_FORMAT_H
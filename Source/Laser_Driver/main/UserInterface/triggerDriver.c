@@ -7,6 +7,9 @@
 #include "esp_log.h"
 
 #include "taskPriority.h"
+#include "memoryMap.h"
+#include "taskStats.h"
+#include "trace.h"
 #include "triggerDriver.h"
 
 /******************************************************************************
@@ -47,6 +50,8 @@ static uint32_t trigger_press_cptr = 0;
 static uint32_t trigger_release_cptr = 0;
 
 static TaskHandle_t trigger_task_handle = NULL;
+static StackType_t trigger_task_stack[TRIGGER_TASK_STACK_SIZE];
+static StaticTask_t trigger_task_buffer;
 
 static const char * TAG = "TRIGGER";
 
@@ -100,6 +105,7 @@ static void tTriggerTask(void *pvParameters){
                 if(new_state != current_state){
                     trigger_press_cptr = 0xFFFFFFFF;
                     current_state = new_state;
+                    TRACE_EVENT(TRACE_TRIGGER_EDGE, current_state);
                     if(state_change_callback != NULL)   state_change_callback(current_state);
                 }
             }
@@ -115,6 +121,7 @@ static void tTriggerTask(void *pvParameters){
                 if(new_state != current_state){
                     trigger_release_cptr = 0xFFFFFFFF;
                     current_state = new_state;
+                    TRACE_EVENT(TRACE_TRIGGER_EDGE, current_state);
                     if(state_change_callback != NULL)   state_change_callback(current_state);
                 }
 
@@ -122,6 +129,7 @@ static void tTriggerTask(void *pvParameters){
         }
 
         vTaskDelay(TRIGGER_MONITORING_PERIOD_MS/portTICK_PERIOD_MS);
+        TSTAT_MarkRunning(true);
     }
     vTaskDelete(NULL);
 }
@@ -174,12 +182,15 @@ TRIGGER_Ret_t TRIGGER_InitDriver(TRIGGER_Config_t *pConfig,
     current_state = TRIGGER_STATE_RELEASE;
 
     //Create Trigger task
-    if(pdPASS != xTaskCreate(tTriggerTask,
-                             "Trig task",
-                             2048,
-                             NULL,
-                             TRIGGER_TASK_PRIORITY,
-                             &trigger_task_handle)){
+    trigger_task_handle = xTaskCreateStaticPinnedToCore(tTriggerTask,
+                                                        "Trig task",
+                                                        TRIGGER_TASK_STACK_SIZE,
+                                                        NULL,
+                                                        TRIGGER_TASK_PRIORITY,
+                                                        trigger_task_stack,
+                                                        &trigger_task_buffer,
+                                                        TRIGGER_TASK_CORE);
+    if(trigger_task_handle == NULL){
 
         ESP_LOGE(TAG, "Failed to create Trigger task");
         return TRIGGER_STATUS_ERROR;
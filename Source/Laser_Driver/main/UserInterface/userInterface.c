@@ -1,34 +1,59 @@
+#include <string.h>
+
 #include "freertos/FreeRTOS.h"
-#include "freertos/queue.h"
 #include "freertos/task.h"
 
+#include "esp_attr.h"
 #include "esp_log.h"
 
 #include "taskPriority.h"
+#include "memoryMap.h"
+#include "taskStats.h"
+#include "trace.h"
 #include "hwi.h"
 #include "userInterface.h"
 
 /******************************************************************************
 *   Private Definitions
 *******************************************************************************/
-#define UI_EVENT_QUEUE_SIZE             (8)
-#define UI_EVENT_TIMEOUT_MS             (250)
-
 #define LOG_LOCAL_LEVEL                 (ESP_LOG_INFO)
 
 /******************************************************************************
 *   Private Macros
 *******************************************************************************/
+#define UI_STATE_BIT(state)             (1UL << (state))
 
+#define UI_STATUS_LED_TIMER             (LEDC_TIMER_0)
+#define UI_STATUS_LED_CHANNEL           (LEDC_CHANNEL_0)
 
 /******************************************************************************
 *   Private Data Types
 *******************************************************************************/
+typedef enum UI_Event_Class_e{
+    UI_EVENT_CLASS_CRITICAL,            //Queued in the priority lane, never merged
+    UI_EVENT_CLASS_STATE,               //Merged in the latest state bitmask
+}UI_Event_Class_t;
+
+typedef enum UI_State_e{
+    UI_STATE_TEMP,                      //Set -> over temperature
+    UI_STATE_VOLTAGE,                   //Set -> low voltage
 
+    UI_STATE_INVALID,
+}UI_State_t;
+
+typedef struct UI_Event_Info_s{
+    UI_Event_Class_t event_class;
+    UI_State_t state;                   //State events only
+    bool is_set;                        //State value carried by the event
+}UI_Event_Info_t;
 
 /******************************************************************************
 *   Private Functions Declaration
 *******************************************************************************/
+static bool queueEvent(UI_Event_t event);
+static void processEvent(UI_Event_t event);
+static void processPendingEvents(void);
+static void updateStatusLed(void);
 static void tUiTask(void *pvParameters);
 
 /******************************************************************************
@@ -40,28 +65,230 @@ static void tUiTask(void *pvParameters);
 *   Private Variables
 *******************************************************************************/
 static TaskHandle_t ui_task_handle = NULL;
-static QueueHandle_t ui_event_queue_handle = NULL;
+static StackType_t ui_task_stack[UI_TASK_STACK_SIZE];
+static StaticTask_t ui_task_buffer;
+static LED_Handle_t status_led_handle = 0;
+static bool is_status_led = false;
+static portMUX_TYPE ui_spinlock = portMUX_INITIALIZER_UNLOCKED;
+
+static const UI_Event_Info_t ui_event_info[UI_EVENT_INVALID] = {
+    [UI_EVENT_BOOT]             = {UI_EVENT_CLASS_CRITICAL, UI_STATE_INVALID, false},
+    [UI_EVENT_RESET]            = {UI_EVENT_CLASS_CRITICAL, UI_STATE_INVALID, false},
+    [UI_EVENT_OVER_TEMP]        = {UI_EVENT_CLASS_STATE,    UI_STATE_TEMP,    true},
+    [UI_EVENT_NORMAL_TEMP]      = {UI_EVENT_CLASS_STATE,    UI_STATE_TEMP,    false},
+    [UI_EVENT_LOW_VOLTAGE]      = {UI_EVENT_CLASS_STATE,    UI_STATE_VOLTAGE, true},
+    [UI_EVENT_NORMAL_VOLTAGE]   = {UI_EVENT_CLASS_STATE,    UI_STATE_VOLTAGE, false},
+};
+
+//Event delivered for each state value (cleared, set)
+static const UI_Event_t ui_state_events[UI_STATE_INVALID][2] = {
+    [UI_STATE_TEMP]             = {UI_EVENT_NORMAL_TEMP,    UI_EVENT_OVER_TEMP},
+    [UI_STATE_VOLTAGE]          = {UI_EVENT_NORMAL_VOLTAGE, UI_EVENT_LOW_VOLTAGE},
+};
+
+//Event bus (under ui_spinlock)
+static UI_Event_t critical_queue[UI_CRITICAL_QUEUE_SIZE];
+static uint8_t critical_head = 0;
+static uint8_t critical_count = 0;
+static uint32_t posted_state_mask = 0;  //Latest posted states
+static uint32_t pending_state_mask = 0; //States changed since the UI task last ran
+static UI_Stats_t ui_stats;
+
+//States seen by the UI task (owned by the UI task)
+static uint32_t current_state_mask = 0;
 
 static const char * TAG = "UI";
 
 /******************************************************************************
 *   Error Check
 *******************************************************************************/
-
+#if (UI_STATE_INVALID > 32)
+#error "Too many UI states for the state bitmask"
+#endif
 
 /******************************************************************************
 *   Private Functions Definitions
 *******************************************************************************/
-static void tUiTask(void *pvParameters){
+/***************************************************************************//*!
+*  \brief Queue event.
+*
+*   This function adds an event to the event bus: a critical event goes to
+*   the priority lane, a state event updates the latest posted states.
+*
+*   Preconditions: ui_spinlock taken.
+*
+*   Side Effects: None.
+*
+*   \param[in]  event               Event.
+*
+*   \return     UI task to notify (false: event coalesced or dropped)
+*
+*******************************************************************************/
+static bool IRAM_ATTR queueEvent(UI_Event_t event){
+
+    const UI_Event_Info_t *pInfo = &ui_event_info[event];
+
+    ui_stats.nb_posted++;
+
+    if(pInfo->event_class == UI_EVENT_CLASS_CRITICAL){
+        if(critical_count >= UI_CRITICAL_QUEUE_SIZE){
+            ui_stats.nb_dropped++;
+            return false;
+        }
+        critical_queue[(critical_head + critical_count) % UI_CRITICAL_QUEUE_SIZE] = event;
+        critical_count++;
+        return true;
+    }
+
+    uint32_t state_bit = UI_STATE_BIT(pInfo->state);
+
+    //Same as the latest posted state: nothing new for the UI task
+    if(((posted_state_mask & state_bit) != 0) == pInfo->is_set){
+        ui_stats.nb_coalesced++;
+        return false;
+    }
+
+    posted_state_mask ^= state_bit;
+
+    //Change not seen yet by the UI task: merged, already notified
+    if(pending_state_mask & state_bit){
+        ui_stats.nb_coalesced++;
+        return false;
+    }
+
+    pending_state_mask |= state_bit;
+    return true;
+}
+
+/***************************************************************************//*!
+*  \brief Process event.
+*
+*   This function handles an event in the UI task context.
+*
+*   Preconditions: Called from the UI task.
+*
+*   Side Effects: Status led effect updated.
+*
+*   \param[in]  event               Event.
+*
+*******************************************************************************/
+static void processEvent(UI_Event_t event){
+
+    ESP_LOGD(TAG, "Event %u", event);
+    TRACE_EVENT(TRACE_UI_HANDLE, event);
+
+    //Process incoming event
+
+    updateStatusLed();
+
+    portENTER_CRITICAL(&ui_spinlock);
+    ui_stats.nb_processed++;
+    portEXIT_CRITICAL(&ui_spinlock);
+}
+
+/***************************************************************************//*!
+*  \brief Update status led.
+*
+*   This function starts the status led effect of the current states
+*   (over temperature first). The effect loops in hardware, so there is no
+*   wakeup until the next event.
+*
+*   Preconditions: Called from the UI task.
+*
+*   Side Effects: Status led effect restarted.
+*
+*******************************************************************************/
+static void updateStatusLed(void){
+
+    LDRV_Effect_t effect = {
+        .type = LDRV_EFFECT_BREATHE,
+        .color = LDRV_RGB_WHITE,
+        .period_ms = UI_LED_IDLE_PERIOD_MS,
+    };
+
+    if(is_status_led == false)  return;
+
+    if(current_state_mask & UI_STATE_BIT(UI_STATE_TEMP)){
+        effect.type = LDRV_EFFECT_BLINK;
+        effect.period_ms = UI_LED_OVER_TEMP_PERIOD_MS;
+    }
+    else if(current_state_mask & UI_STATE_BIT(UI_STATE_VOLTAGE)){
+        effect.type = LDRV_EFFECT_PULSE;
+        effect.period_ms = UI_LED_LOW_VOLTAGE_PERIOD_MS;
+        effect.nb_pulses = 2;
+    }
+
+    if(LDRV_STATUS_OK != LDRV_StartLedEffect(effect, status_led_handle)){
+        ESP_LOGW(TAG, "Failed to start status led effect");
+    }
+}
+
+/***************************************************************************//*!
+*  \brief Process pending events.
+*
+*   This function drains the critical lane first, then delivers the latest
+*   value of each state that changed since the previous run.
+*
+*   Preconditions: Called from the UI task.
+*
+*   Side Effects: None.
+*
+*******************************************************************************/
+static void processPendingEvents(void){
 
-    ESP_LOGI(TAG, "Starting UI task");
     UI_Event_t event = UI_EVENT_INVALID;
+    uint32_t changed_mask = 0;
+    uint32_t state_mask = 0;
 
+    //Priority lane
     for(;;){
-        //Check if event is available
-        if(pdTRUE == xQueueReceive(ui_event_queue_handle, &event, UI_EVENT_TIMEOUT_MS/portTICK_PERIOD_MS)){
-            //Process incoming event
+        portENTER_CRITICAL(&ui_spinlock);
+        if(critical_count == 0){
+            portEXIT_CRITICAL(&ui_spinlock);
+            break;
         }
+        event = critical_queue[critical_head];
+        critical_head = (critical_head + 1) % UI_CRITICAL_QUEUE_SIZE;
+        critical_count--;
+        portEXIT_CRITICAL(&ui_spinlock);
+
+        processEvent(event);
+    }
+
+    //Latest states
+    portENTER_CRITICAL(&ui_spinlock);
+    changed_mask = pending_state_mask;
+    state_mask = posted_state_mask;
+    pending_state_mask = 0;
+    portEXIT_CRITICAL(&ui_spinlock);
+
+    for(uint8_t state=0; state<UI_STATE_INVALID; state++){
+
+        uint32_t state_bit = UI_STATE_BIT(state);
+        if((changed_mask & state_bit) == 0) continue;
+
+        //State flapped back to the value already seen: nothing to deliver
+        if(((state_mask ^ current_state_mask) & state_bit) == 0)    continue;
+
+        current_state_mask ^= state_bit;
+        processEvent(ui_state_events[state][(state_mask & state_bit) ? 1 : 0]);
+    }
+}
+
+static void tUiTask(void *pvParameters){
+
+    ESP_LOGI(TAG, "Starting UI task");
+
+    for(;;){
+        //Fully event driven: no wakeup without event
+        ulTaskNotifyTake(pdTRUE, portMAX_DELAY);
+        TSTAT_MarkRunning(false);
+
+        portENTER_CRITICAL(&ui_spinlock);
+        ui_stats.nb_wakeups++;
+        portEXIT_CRITICAL(&ui_spinlock);
+
+        processPendingEvents();
     }
     vTaskDelete(NULL);
 }
@@ -76,20 +303,40 @@ static void tUiTask(void *pvParameters){
 *******************************************************************************/
 UI_Ret_t UI_Init(void){
 
-    //Create queue
-    ui_event_queue_handle = xQueueCreate(UI_EVENT_QUEUE_SIZE, sizeof(UI_Event_t));
-    if(ui_event_queue_handle == NULL){
-        ESP_LOGE(TAG, "Failed to create UI queue");
+    memset(&ui_stats, 0, sizeof(ui_stats));
+    critical_head = 0;
+    critical_count = 0;
+    posted_state_mask = 0;
+    pending_state_mask = 0;
+    current_state_mask = 0;
+
+    //Status led (effects played by the LEDC hardware)
+    LDRV_CFG_Single_Pwm_Config_t led_config = {
+        .gpio_num = HWI_USER_LED_GPIO,
+        .active_level = LDRV_CFG_ACTIVE_HIGH,
+        .led_timer = UI_STATUS_LED_TIMER,
+        .led_channel = UI_STATUS_LED_CHANNEL,
+    };
+
+    if((LDRV_STATUS_OK != LDRV_InitDriver()) ||
+       (LDRV_STATUS_OK != LDRV_AddLedSinglePwm(led_config, &status_led_handle)) ||
+       (LDRV_STATUS_OK != LDRV_StartFadeService())){
+
+        ESP_LOGE(TAG, "Failed to initialize status led");
         return UI_STATUS_ERROR;
     }
+    is_status_led = true;
 
     //Create task
-    if(pdTRUE != xTaskCreate(tUiTask,
-                             "UI task",
-                             2048,
-                             NULL,
-                             UI_TASK_PRIORITY,
-                             &ui_task_handle)){
+    ui_task_handle = xTaskCreateStaticPinnedToCore(tUiTask,
+                                                   "UI task",
+                                                   UI_TASK_STACK_SIZE,
+                                                   NULL,
+                                                   UI_TASK_PRIORITY,
+                                                   ui_task_stack,
+                                                   &ui_task_buffer,
+                                                   UI_TASK_CORE);
+    if(ui_task_handle == NULL){
 
         ESP_LOGE(TAG, "Failed to create UI task");
         return UI_STATUS_ERROR;
@@ -98,22 +345,72 @@ UI_Ret_t UI_Init(void){
     return UI_STATUS_OK;
 }
 
-UI_Ret_t UI_PostEvent(UI_Event_t event, uint32_t timeout_ms){
+UI_Ret_t UI_PostEvent(UI_Event_t event){
 
     if(event >= UI_EVENT_INVALID)   return UI_STATUS_ERROR;
 
-    if(ui_event_queue_handle == NULL)   return UI_STATUS_ERROR;
+    if(ui_task_handle == NULL)  return UI_STATUS_ERROR;
 
-    if(ESP_OK != xQueueSend(ui_event_queue_handle, &event, timeout_ms/portTICK_PERIOD_MS)){
-        ESP_LOGI(TAG, "Failed to post event");
-        return UI_STATUS_ERROR;
+    TRACE_EVENT(TRACE_UI_POST, event);
+
+    portENTER_CRITICAL(&ui_spinlock);
+    bool is_notify = queueEvent(event);
+    portEXIT_CRITICAL(&ui_spinlock);
+
+    if(is_notify){
+        TSTAT_MarkReady(ui_task_handle);
+        xTaskNotifyGive(ui_task_handle);
+    }
+
+    return UI_STATUS_OK;
+}
+
+UI_Ret_t IRAM_ATTR UI_PostEventFromISR(UI_Event_t event, bool *pTaskWoken){
+
+    BaseType_t task_woken = pdFALSE;
+
+    if(event >= UI_EVENT_INVALID)   return UI_STATUS_ERROR;
+
+    if(ui_task_handle == NULL)  return UI_STATUS_ERROR;
+
+    TRACE_EVENT(TRACE_UI_POST, event);
+
+    portENTER_CRITICAL_ISR(&ui_spinlock);
+    bool is_notify = queueEvent(event);
+    portEXIT_CRITICAL_ISR(&ui_spinlock);
+
+    if(is_notify){
+        TSTAT_MarkReady(ui_task_handle);
+        vTaskNotifyGiveFromISR(ui_task_handle, &task_woken);
     }
 
+    if(pTaskWoken != NULL)  *pTaskWoken = (task_woken == pdTRUE);
+
+    return UI_STATUS_OK;
+}
+
+UI_Ret_t UI_GetStatusLed(LED_Handle_t *pLed_handle){
+
+    if(pLed_handle == NULL)     return UI_STATUS_ERROR;
+
+    if(is_status_led == false)  return UI_STATUS_ERROR;
+
+    *pLed_handle = status_led_handle;
+
+    return UI_STATUS_OK;
+}
+
+UI_Ret_t UI_GetStats(UI_Stats_t *pStats){
+
+    if(pStats == NULL)  return UI_STATUS_ERROR;
+
+    portENTER_CRITICAL(&ui_spinlock);
+    *pStats = ui_stats;
+    portEXIT_CRITICAL(&ui_spinlock);
+
     return UI_STATUS_OK;
 }
 
 /******************************************************************************
 *   Interrupts
 *******************************************************************************/
-
-
@@ -2,11 +2,18 @@
 #define __USER_INTERFACE_H
 
 #include <stdint.h>
+#include <stdbool.h>
+
+#include "ledDriver.h"
 
 /******************************************************************************
 *   Public Definitions
 *******************************************************************************/
+#define UI_CRITICAL_QUEUE_SIZE          (8)//Critical events waiting for the UI task
 
+#define UI_LED_IDLE_PERIOD_MS           (3000)//Breathe
+#define UI_LED_OVER_TEMP_PERIOD_MS      (250)//Fast blink
+#define UI_LED_LOW_VOLTAGE_PERIOD_MS    (1500)//Double pulse
 
 /******************************************************************************
 *   Public Macros
@@ -29,6 +36,14 @@ typedef enum UI_Event_e{
     UI_EVENT_INVALID,
 }UI_Event_t;
 
+typedef struct UI_Stats_s{
+    uint32_t nb_posted;                 //Events posted
+    uint32_t nb_coalesced;              //State events merged in the latest state
+    uint32_t nb_dropped;                //Critical events lost (critical queue full)
+    uint32_t nb_processed;              //Events processed by the UI task
+    uint32_t nb_wakeups;                //UI task wakeups
+}UI_Stats_t;
+
 typedef enum UI_Ret_e{
     UI_STATUS_ERROR,
     UI_STATUS_OK,
@@ -47,8 +62,91 @@ typedef enum UI_Ret_e{
 /******************************************************************************
 *   Public Functions Declarations
 *******************************************************************************/
+/***************************************************************************//*!
+*  \brief User interface initialization.
+*
+*   This function is used to initialize the UI event bus, the status led
+*   and the UI task. The task only wakes up when events are posted, the
+*   status led effect plays in hardware between events.
+*
+*   Preconditions: None.
+*
+*   Side Effects: None.
+*
+*   \return     Operation status
+*
+*******************************************************************************/
 UI_Ret_t UI_Init(void);
 
-UI_Ret_t UI_PostEvent(UI_Event_t event, uint32_t timeout_ms);
+/***************************************************************************//*!
+*  \brief Post UI event.
+*
+*   This function is used to post an event to the UI task, it never blocks.
+*   State events (temperature, voltage) are coalesced: the UI task only
+*   sees the latest state of each pair, posting the current state again
+*   does not wake the task. Critical events (boot, reset) go through a
+*   priority lane processed before the state events, they are dropped
+*   only if UI_CRITICAL_QUEUE_SIZE events are already waiting.
+*
+*   Preconditions: UI initialized.
+*
+*   Side Effects: None.
+*
+*   \param[in]  event               Event.
+*
+*   \return     Operation status
+*
+*******************************************************************************/
+UI_Ret_t UI_PostEvent(UI_Event_t event);
+
+/***************************************************************************//*!
+*  \brief Post UI event from ISR.
+*
+*   This function is the ISR version of UI_PostEvent().
+*
+*   Preconditions: UI initialized.
+*
+*   Side Effects: None.
+*
+*   \param[in]  event               Event.
+*   \param[out] pTaskWoken          Set to true if a context switch is required.
+*
+*   \return     Operation status
+*
+*******************************************************************************/
+UI_Ret_t UI_PostEventFromISR(UI_Event_t event, bool *pTaskWoken);
+
+/***************************************************************************//*!
+*  \brief Get UI event statistics.
+*
+*   This function is used to get the event bus counters.
+*
+*   Preconditions: None.
+*
+*   Side Effects: None.
+*
+*   \param[out] pStats              Pointer to store the statistics.
+*
+*   \return     Operation status
+*
+*******************************************************************************/
+UI_Ret_t UI_GetStats(UI_Stats_t *pStats);
+
+/***************************************************************************//*!
+*  \brief Get status led.
+*
+*   This function is used to get the status led handle (user led, single
+*   pwm led driven by the led driver).
+*
+*   Preconditions: UI initialized.
+*
+*   Side Effects: None.
+*
+*   \param[out] pLed_handle         Pointer to store the led handle.
+*
+*   \return     Operation status
+*
+*******************************************************************************/
+UI_Ret_t UI_GetStatusLed(LED_Handle_t *pLed_handle);
 
-#endif//__USER_INTERFACE_H
\ No newline at end of file
+#endif//__USER_INTERFACE_H
@@ -0,0 +1,587 @@
+#include <string.h>
+
+#include "freertos/FreeRTOS.h"
+#include "freertos/task.h"
+
+#include "esp_cpu.h"
+#include "esp_timer.h"
+#include "esp_log.h"
+
+#include "taskPriority.h"
+#include "memoryMap.h"
+#include "taskStats.h"
+#include "shellCom.h"
+#include "pwrMonitoring.h"
+#include "temperatureMonitoring.h"
+#include "currentRegulator.h"
+#include "textFormat.h"
+#include "watch.h"
+
+/******************************************************************************
+*   Private Definitions
+*******************************************************************************/
+#define WATCH_TIME_WIDTH                    (10)//Timestamp column (ms, left aligned)
+#define WATCH_VALUE_WIDTH                   (9)//Value columns (right aligned, "-327.68V")
+#define WATCH_VALUE_MAX_LEN                 (12)
+#define WATCH_LINE_MAX_LEN                  (WATCH_TIME_WIDTH + (WATCH_FIELD_INVALID * WATCH_VALUE_WIDTH) + 3)
+
+#define WATCH_MAX_TX_PENDING                (512)//Output ring level slowing the stream down (2048 bytes ring)
+#define WATCH_LOW_TX_PENDING                (128)//Output ring level speeding it back up
+#define WATCH_CALM_LINES                    (16)//Lines below the low level before halving the divider
+
+//Values not displayed as numbers
+#define WATCH_VALUE_NA                      (INT32_MIN)
+#define WATCH_VALUE_SHORT                   (INT32_MIN + 1)
+#define WATCH_VALUE_OPEN                    (INT32_MIN + 2)
+
+#define WATCH_PWR_FIELDS_MASK               (WATCH_FIELD_MASK(WATCH_FIELD_BUS_VOLTAGE) | \
+                                             WATCH_FIELD_MASK(WATCH_FIELD_PHASE_A_CURRENT) | \
+                                             WATCH_FIELD_MASK(WATCH_FIELD_PHASE_B_CURRENT))
+#define WATCH_TEMP_FIELDS_MASK              (WATCH_FIELD_MASK(WATCH_FIELD_PHASE_A_TEMP) | \
+                                             WATCH_FIELD_MASK(WATCH_FIELD_PHASE_B_TEMP) | \
+                                             WATCH_FIELD_MASK(WATCH_FIELD_LOAD_TEMP))
+#define WATCH_ALL_FIELDS_MASK               (WATCH_FIELD_MASK(WATCH_FIELD_INVALID) - 1)
+
+#define LOG_LOCAL_LEVEL                     (ESP_LOG_INFO)
+
+/******************************************************************************
+*   Private Macros
+*******************************************************************************/
+
+
+/******************************************************************************
+*   Private Data Types
+*******************************************************************************/
+typedef struct WATCH_Field_Desc_s{
+    const char *pName;
+    FMT_Unit_t unit;
+}WATCH_Field_Desc_t;
+
+typedef struct WATCH_Column_s{
+    WATCH_Field_t field;
+    FMT_Unit_t unit;
+    uint8_t end;                        //Line position after the value
+}WATCH_Column_t;
+
+//Built once per stream, read for every line
+typedef struct WATCH_Layout_s{
+    WATCH_Column_t columns[WATCH_FIELD_INVALID];
+    uint32_t nb_columns;
+    uint32_t field_mask;
+    char header[WATCH_LINE_MAX_LEN];
+}WATCH_Layout_t;
+
+/******************************************************************************
+*   Private Functions Declaration
+*******************************************************************************/
+static void buildLayout(uint32_t field_mask);
+static bool readValues(int32_t *pValues);
+static SHCOM_Ret_t sendLine(void);
+static void tWatchTask(void *pvParameters);
+
+/******************************************************************************
+*   Public Variables
+*******************************************************************************/
+
+
+/******************************************************************************
+*   Private Variables
+*******************************************************************************/
+static TaskHandle_t watch_task_handle = NULL;
+static StackType_t watch_task_stack[WATCH_TASK_STACK_SIZE];
+static StaticTask_t watch_task_buffer;
+
+//Indexed by WATCH_Field_t
+static const WATCH_Field_Desc_t field_desc[WATCH_FIELD_INVALID] = {
+    [WATCH_FIELD_BUS_VOLTAGE]       = {"bus",   FMT_UNIT_10MV},
+    [WATCH_FIELD_PHASE_A_CURRENT]   = {"ia",    FMT_UNIT_10MA},
+    [WATCH_FIELD_PHASE_B_CURRENT]   = {"ib",    FMT_UNIT_10MA},
+    [WATCH_FIELD_PHASE_A_TEMP]      = {"ta",    FMT_UNIT_CENTI_DEG},
+    [WATCH_FIELD_PHASE_B_TEMP]      = {"tb",    FMT_UNIT_CENTI_DEG},
+    [WATCH_FIELD_LOAD_TEMP]         = {"tl",    FMT_UNIT_CENTI_DEG},
+    [WATCH_FIELD_PHASE_A_DUTY]      = {"da",    FMT_UNIT_CENTI_PERCENT},
+    [WATCH_FIELD_PHASE_B_DUTY]      = {"db",    FMT_UNIT_CENTI_PERCENT},
+};
+
+//Under watch_spinlock, generation bumped by every start
+static bool watch_is_running = false;
+static uint32_t watch_field_mask = 0;
+static uint32_t watch_rate_hz = WATCH_DEFAULT_RATE_HZ;
+static uint32_t watch_generation = 0;
+
+//Only accessed from the watch task
+static WATCH_Layout_t layout;
+static char line[WATCH_LINE_MAX_LEN];
+
+static WATCH_Stats_t watch_stats = {0};
+static portMUX_TYPE watch_spinlock = portMUX_INITIALIZER_UNLOCKED;
+
+static const char * TAG = "WATCH";
+
+/******************************************************************************
+*   Error Check
+*******************************************************************************/
+#if (configTICK_RATE_HZ < WATCH_MAX_RATE_HZ)
+#error "Watch rate above the tick rate"
+#endif
+
+#if (WATCH_FIELD_INVALID > 32)
+#error "Watch fields do not fit the field mask"
+#endif
+
+_Static_assert(WATCH_LINE_MAX_LEN <= 255, "Watch column positions are 8 bits");
+
+/******************************************************************************
+*   Private Functions Definitions
+*******************************************************************************/
+/***************************************************************************//*!
+*  \brief Build layout.
+*
+*   This function places the selected fields in columns and writes the
+*   header line, so the lines only append values at known positions.
+*
+*   Preconditions: Called from the watch task.
+*
+*   Side Effects: None.
+*
+*   \param[in]  field_mask          Fields.
+*
+*******************************************************************************/
+static void buildLayout(uint32_t field_mask){
+
+    FMT_Buffer_t fmt;
+    size_t end = WATCH_TIME_WIDTH;
+
+    layout.nb_columns = 0;
+    layout.field_mask = field_mask;
+
+    FMT_Init(&fmt, layout.header, sizeof(layout.header));
+    FMT_String(&fmt, "time_ms");
+
+    for(uint8_t field=0; field<WATCH_FIELD_INVALID; field++){
+
+        if((field_mask & WATCH_FIELD_MASK(field)) == 0)  continue;
+
+        end += WATCH_VALUE_WIDTH;
+
+        WATCH_Column_t *pColumn = &layout.columns[layout.nb_columns++];
+        pColumn->field = (WATCH_Field_t)field;
+        pColumn->unit = field_desc[field].unit;
+        pColumn->end = (uint8_t)end;
+
+        //Labels right aligned on the values
+        FMT_Pad(&fmt, end - strlen(field_desc[field].pName));
+        FMT_String(&fmt, field_desc[field].pName);
+    }
+
+    FMT_String(&fmt, "\r\n");
+}
+
+/***************************************************************************//*!
+*  \brief Read values.
+*
+*   This function reads the values of the layout fields: sensor snapshots
+*   (no module mutex) and regulator status (spinlock only).
+*
+*   Preconditions: Called from the watch task.
+*
+*   Side Effects: None.
+*
+*   \param[out] pValues             Values by field (WATCH_VALUE_xxx if not a number).
+*
+*   \return     false if a snapshot was busy (values shown as n/a)
+*
+*******************************************************************************/
+static bool readValues(int32_t *pValues){
+
+    bool is_fresh = true;
+
+    for(uint8_t field=0; field<WATCH_FIELD_INVALID; field++)    pValues[field] = WATCH_VALUE_NA;
+
+    if(layout.field_mask & WATCH_PWR_FIELDS_MASK){
+
+        PWR_Snapshot_t pwr;
+
+        if(PWR_MONITORING_STATUS_OK == PWR_GetSnapshot(&pwr)){
+            if(pwr.bus_voltage_10mv != (int16_t)PWR_INVALID_VOLTAGE){
+                pValues[WATCH_FIELD_BUS_VOLTAGE] = pwr.bus_voltage_10mv;
+            }
+            if(pwr.phase_a_current_10ma != (int16_t)PWR_INVALID_CURRENT){
+                pValues[WATCH_FIELD_PHASE_A_CURRENT] = pwr.phase_a_current_10ma;
+            }
+            if(pwr.phase_b_current_10ma != (int16_t)PWR_INVALID_CURRENT){
+                pValues[WATCH_FIELD_PHASE_B_CURRENT] = pwr.phase_b_current_10ma;
+            }
+        }
+        else{
+            is_fresh = false;
+        }
+    }
+
+    if(layout.field_mask & WATCH_TEMP_FIELDS_MASK){
+
+        //Temperature fields order
+        static const TEMP_Sensor_Id_t temp_sensor[] = {TEMP_SENSOR_ID_PHASE_A, TEMP_SENSOR_ID_PHASE_B, TEMP_SENSOR_ID_LOAD};
+        TEMP_Snapshot_t temp;
+
+        if(TEMP_STATUS_OK == TEMP_GetSnapshot(&temp)){
+            for(uint8_t i=0; i<(sizeof(temp_sensor)/sizeof(temp_sensor[0])); i++){
+
+                int16_t value = temp.temperature[temp_sensor[i]];
+                int32_t *pValue = &pValues[WATCH_FIELD_PHASE_A_TEMP + i];
+
+                if(value == (int16_t)TEMP_ERROR_SHORT)          *pValue = WATCH_VALUE_SHORT;
+                else if(value == (int16_t)TEMP_ERROR_OPEN)      *pValue = WATCH_VALUE_OPEN;
+                else if(value != (int16_t)TEMP_ERROR_INVALID)   *pValue = value;
+            }
+        }
+        else{
+            is_fresh = false;
+        }
+    }
+
+    for(uint8_t phase=0; phase<CREG_PHASE_INVALID; phase++){
+
+        WATCH_Field_t field = (phase == CREG_PHASE_A) ? WATCH_FIELD_PHASE_A_DUTY : WATCH_FIELD_PHASE_B_DUTY;
+        CREG_Phase_Status_t status;
+
+        if((layout.field_mask & WATCH_FIELD_MASK(field)) &&
+           (CREG_STATUS_OK == CREG_GetPhaseStatus((CREG_Phase_t)phase, &status))){
+            pValues[field] = status.duty;
+        }
+    }
+
+    return is_fresh;
+}
+
+/***************************************************************************//*!
+*  \brief Send line.
+*
+*   This function formats a line with the layout (timestamp, then every
+*   value right aligned in its column) and writes it out.
+*
+*   Preconditions: Called from the watch task, layout built.
+*
+*   Side Effects: None.
+*
+*   \return     Operation status (error if the output ring is full)
+*
+*******************************************************************************/
+static SHCOM_Ret_t sendLine(void){
+
+    int32_t values[WATCH_FIELD_INVALID];
+    char text[WATCH_VALUE_MAX_LEN];
+    FMT_Buffer_t fmt;
+    FMT_Buffer_t value_fmt;
+
+    if(!readValues(values)){
+        portENTER_CRITICAL(&watch_spinlock);
+        watch_stats.nb_stale++;
+        portEXIT_CRITICAL(&watch_spinlock);
+    }
+
+    FMT_Init(&fmt, line, sizeof(line));
+    FMT_Uint(&fmt, (uint32_t)(esp_timer_get_time() / 1000));
+
+    for(uint32_t i=0; i<layout.nb_columns; i++){
+
+        const WATCH_Column_t *pColumn = &layout.columns[i];
+        int32_t value = values[pColumn->field];
+
+        FMT_Init(&value_fmt, text, sizeof(text));
+
+        switch(value){
+            case WATCH_VALUE_NA:    FMT_String(&value_fmt, "n/a");                  break;
+            case WATCH_VALUE_SHORT: FMT_String(&value_fmt, "short");                break;
+            case WATCH_VALUE_OPEN:  FMT_String(&value_fmt, "open");                 break;
+            default:                FMT_Unit(&value_fmt, value, pColumn->unit);     break;
+        }
+
+        FMT_Pad(&fmt, pColumn->end - value_fmt.len);
+        FMT_String(&fmt, text);
+    }
+
+    FMT_String(&fmt, "\r\n");
+
+    return SHCOM_Print(line);
+}
+
+/***************************************************************************//*!
+*  \brief Watch task.
+*
+*   This task writes the watch lines. The period is kept in microseconds
+*   and converted to ticks with the remainder carried over (rates not
+*   dividing the tick rate). When the output ring fills up, only every
+*   divider-th period writes a line: the divider doubles while the ring
+*   keeps growing and halves back after WATCH_CALM_LINES quiet lines.
+*
+*   Preconditions: None.
+*
+*   Side Effects: None.
+*
+*   \param[in]  pvParameters        Task parameters (unused).
+*
+*******************************************************************************/
+static void tWatchTask(void *pvParameters){
+
+    const uint32_t tick_us = 1000000 / configTICK_RATE_HZ;
+    uint32_t generation = 0;
+    uint32_t period_us = 0;
+    uint32_t remainder_us = 0;
+    TickType_t next_tick = 0;
+    TickType_t wait_ticks = portMAX_DELAY;
+    uint32_t divider = 1;
+    uint32_t skip_count = 0;
+    uint32_t calm_count = 0;
+    uint32_t last_pending = 0;
+
+    ESP_LOGI(TAG, "Starting watch task");
+
+    for(;;){
+
+        uint32_t nb_notify = ulTaskNotifyTake(pdTRUE, wait_ticks);
+        TSTAT_MarkRunning(nb_notify == 0);
+
+        uint32_t start_cycles = esp_cpu_get_cycle_count();
+        TickType_t now = xTaskGetTickCount();
+
+        portENTER_CRITICAL(&watch_spinlock);
+        bool is_running = watch_is_running;
+        uint32_t field_mask = watch_field_mask;
+        uint32_t rate_hz = watch_rate_hz;
+        bool is_restarted = (generation != watch_generation);
+        generation = watch_generation;
+        portEXIT_CRITICAL(&watch_spinlock);
+
+        wait_ticks = portMAX_DELAY;
+
+        if(!is_running) continue;
+
+        //New stream: layout and header once, first line now
+        if(is_restarted){
+            buildLayout(field_mask);
+            SHCOM_Print(layout.header);
+
+            period_us = 1000000 / rate_hz;
+            remainder_us = 0;
+            next_tick = now;
+            divider = 1;
+            skip_count = 0;
+            calm_count = 0;
+            last_pending = 0;
+        }
+
+        int32_t remaining = (int32_t)(next_tick - now);
+
+        if(remaining <= 0){
+
+            if(++skip_count >= divider){
+
+                skip_count = 0;
+
+                bool is_sent = (SHCOM_STATUS_OK == sendLine());
+                uint32_t pending = SHCOM_GetTxPending();
+
+                if(!is_sent || ((pending > WATCH_MAX_TX_PENDING) && (pending >= last_pending))){
+                    if(divider < WATCH_MAX_DIVIDER) divider *= 2;
+                    calm_count = 0;
+                }
+                else if((divider > 1) && (pending <= WATCH_LOW_TX_PENDING) && (++calm_count >= WATCH_CALM_LINES)){
+                    divider /= 2;
+                    calm_count = 0;
+                }
+                last_pending = pending;
+
+                portENTER_CRITICAL(&watch_spinlock);
+                if(is_sent) watch_stats.nb_lines++;
+                else        watch_stats.nb_dropped++;
+                if(pending > watch_stats.max_tx_pending)    watch_stats.max_tx_pending = pending;
+                watch_stats.divider = divider;
+                portEXIT_CRITICAL(&watch_spinlock);
+            }
+            else{
+                portENTER_CRITICAL(&watch_spinlock);
+                watch_stats.nb_skipped++;
+                portEXIT_CRITICAL(&watch_spinlock);
+            }
+
+            //Next period, restart if more than a period late
+            remainder_us += period_us;
+            TickType_t period_ticks = remainder_us / tick_us;
+            remainder_us -= period_ticks * tick_us;
+
+            next_tick += period_ticks;
+            if((int32_t)(next_tick - now) <= 0)    next_tick = now + period_ticks;
+            remaining = (int32_t)(next_tick - now);
+        }
+
+        wait_ticks = (TickType_t)remaining;
+
+        uint32_t cycles = esp_cpu_get_cycle_count() - start_cycles;
+
+        portENTER_CRITICAL(&watch_spinlock);
+        watch_stats.busy_cycles += cycles;
+        portEXIT_CRITICAL(&watch_spinlock);
+    }
+    vTaskDelete(NULL);
+}
+
+/******************************************************************************
+*   CallBack Functions implementation
+*******************************************************************************/
+
+
+/******************************************************************************
+*   Public Functions Definitions
+*******************************************************************************/
+/***************************************************************************//*!
+*  \brief Watch initialization.
+*
+*   This function is used to initialize the sensor watch: text lines of
+*   the selected readings, streamed on the shell port at a fixed rate.
+*
+*   Preconditions: Shell communication initialized.
+*
+*   Side Effects: None.
+*
+*   \return     Operation status
+*
+*******************************************************************************/
+WATCH_Ret_t WATCH_InitWatch(void){
+
+    //Create task
+    watch_task_handle = xTaskCreateStaticPinnedToCore(tWatchTask,
+                                                      "Watch task",
+                                                      WATCH_TASK_STACK_SIZE,
+                                                      NULL,
+                                                      WATCH_TASK_PRIORITY,
+                                                      watch_task_stack,
+                                                      &watch_task_buffer,
+                                                      WATCH_TASK_CORE);
+    if(watch_task_handle == NULL){
+
+        ESP_LOGE(TAG, "Failed to create watch task");
+        return WATCH_STATUS_ERROR;
+    }
+
+    return WATCH_STATUS_OK;
+}
+
+/***************************************************************************//*!
+*  \brief Start watch.
+*
+*   This function is used to start streaming the selected fields (restarts
+*   the stream if already running). The column layout and the header line
+*   are built once per start, by the watch task.
+*
+*   Preconditions: Watch initialized.
+*
+*   Side Effects: None.
+*
+*   \param[in]  field_mask          Fields (WATCH_FIELD_MASK()), not empty.
+*   \param[in]  rate_hz             Line rate (WATCH_MIN_RATE_HZ to WATCH_MAX_RATE_HZ).
+*
+*   \return     Operation status
+*
+*******************************************************************************/
+WATCH_Ret_t WATCH_Start(uint32_t field_mask, uint32_t rate_hz){
+
+    if(watch_task_handle == NULL)   return WATCH_STATUS_ERROR;
+    if((field_mask == 0) || (field_mask & ~WATCH_ALL_FIELDS_MASK))  return WATCH_STATUS_ERROR;
+    if((rate_hz < WATCH_MIN_RATE_HZ) || (rate_hz > WATCH_MAX_RATE_HZ))  return WATCH_STATUS_ERROR;
+
+    portENTER_CRITICAL(&watch_spinlock);
+    memset(&watch_stats, 0, sizeof(watch_stats));
+    watch_stats.divider = 1;
+    watch_field_mask = field_mask;
+    watch_rate_hz = rate_hz;
+    watch_generation++;
+    watch_is_running = true;
+    portEXIT_CRITICAL(&watch_spinlock);
+
+    TSTAT_MarkReady(watch_task_handle);
+    xTaskNotifyGive(watch_task_handle);
+
+    return WATCH_STATUS_OK;
+}
+
+/***************************************************************************//*!
+*  \brief Stop watch.
+*
+*   This function is used to stop the stream.
+*
+*   Preconditions: Watch initialized.
+*
+*   Side Effects: None.
+*
+*   \return     Operation status
+*
+*******************************************************************************/
+WATCH_Ret_t WATCH_Stop(void){
+
+    if(watch_task_handle == NULL)   return WATCH_STATUS_ERROR;
+
+    portENTER_CRITICAL(&watch_spinlock);
+    watch_is_running = false;
+    portEXIT_CRITICAL(&watch_spinlock);
+
+    TSTAT_MarkReady(watch_task_handle);
+    xTaskNotifyGive(watch_task_handle);
+
+    return WATCH_STATUS_OK;
+}
+
+/***************************************************************************//*!
+*  \brief Get field name.
+*
+*   This function is used to get the name of a field (shell argument and
+*   column label).
+*
+*   Preconditions: None.
+*
+*   Side Effects: None.
+*
+*   \param[in]  field               Field.
+*
+*   \return     Field name, NULL if invalid
+*
+*******************************************************************************/
+const char *WATCH_GetFieldName(WATCH_Field_t field){
+
+    if(field >= WATCH_FIELD_INVALID)    return NULL;
+
+    return field_desc[field].pName;
+}
+
+/***************************************************************************//*!
+*  \brief Get watch statistics.
+*
+*   This function is used to get the watch statistics of the current (or
+*   last) stream.
+*
+*   Preconditions: None.
+*
+*   Side Effects: None.
+*
+*   \param[out] pStats              Pointer to store the statistics.
+*
+*   \return     Operation status
+*
+*******************************************************************************/
+WATCH_Ret_t WATCH_GetStats(WATCH_Stats_t *pStats){
+
+    if(pStats == NULL)  return WATCH_STATUS_ERROR;
+
+    portENTER_CRITICAL(&watch_spinlock);
+    *pStats = watch_stats;
+    pStats->is_running = watch_is_running;
+    pStats->field_mask = watch_field_mask;
+    pStats->rate_hz = watch_rate_hz;
+    portEXIT_CRITICAL(&watch_spinlock);
+
+    return WATCH_STATUS_OK;
+}
+
+/******************************************************************************
+*   Interrupts
+*******************************************************************************/
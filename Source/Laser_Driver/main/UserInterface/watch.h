@@ -0,0 +1,151 @@
+#ifndef __WATCH_H
+#define __WATCH_H
+
+#include <stdint.h>
+#include <stdbool.h>
+
+/******************************************************************************
+*   Public Definitions
+*******************************************************************************/
+#define WATCH_MIN_RATE_HZ                   (1)
+#define WATCH_MAX_RATE_HZ                   (1000)
+#define WATCH_DEFAULT_RATE_HZ               (10)
+
+#define WATCH_MAX_DIVIDER                   (64)//Throttling, lines skipped per line sent + 1
+
+/******************************************************************************
+*   Public Macros
+*******************************************************************************/
+#define WATCH_FIELD_MASK(field)             (1UL << (field))
+
+/******************************************************************************
+*   Public Data Types
+*******************************************************************************/
+//Columns, in line order
+typedef enum WATCH_Field_e{
+    WATCH_FIELD_BUS_VOLTAGE,            //Bus voltage (10mV)
+    WATCH_FIELD_PHASE_A_CURRENT,        //Phase currents (10mA)
+    WATCH_FIELD_PHASE_B_CURRENT,
+    WATCH_FIELD_PHASE_A_TEMP,           //Temperatures (0.01C)
+    WATCH_FIELD_PHASE_B_TEMP,
+    WATCH_FIELD_LOAD_TEMP,
+    WATCH_FIELD_PHASE_A_DUTY,           //Regulator applied duty (0.01%)
+    WATCH_FIELD_PHASE_B_DUTY,
+
+    WATCH_FIELD_INVALID,
+}WATCH_Field_t;
+
+typedef struct WATCH_Stats_s{
+    bool is_running;
+    uint32_t field_mask;
+    uint32_t rate_hz;                   //Requested rate
+    uint32_t divider;                   //Current throttling (1: full rate)
+    uint32_t nb_lines;                  //Lines written
+    uint32_t nb_skipped;                //Periods skipped by throttling
+    uint32_t nb_dropped;                //Output ring full
+    uint32_t nb_stale;                  //Snapshot busy, values shown as n/a
+    uint32_t max_tx_pending;            //Output ring high level seen after a line
+    uint64_t busy_cycles;               //Watch task CPU cycles
+}WATCH_Stats_t;
+
+typedef enum WATCH_Ret_e{
+    WATCH_STATUS_ERROR,
+    WATCH_STATUS_OK,
+}WATCH_Ret_t;
+
+/******************************************************************************
+*   Public Variables
+*******************************************************************************/
+
+
+/******************************************************************************
+*   Error Check
+*******************************************************************************/
+
+
+/******************************************************************************
+*   Public Functions Declarations
+*******************************************************************************/
+/***************************************************************************//*!
+*  \brief Watch initialization.
+*
+*   This function is used to initialize the sensor watch: text lines of
+*   the selected readings, streamed on the shell port at a fixed rate.
+*
+*   Preconditions: Shell communication initialized.
+*
+*   Side Effects: None.
+*
+*   \return     Operation status
+*
+*******************************************************************************/
+WATCH_Ret_t WATCH_InitWatch(void);
+
+/***************************************************************************//*!
+*  \brief Start watch.
+*
+*   This function is used to start streaming the selected fields (restarts
+*   the stream if already running). The column layout and the header line
+*   are built once per start, by the watch task.
+*
+*   Preconditions: Watch initialized.
+*
+*   Side Effects: None.
+*
+*   \param[in]  field_mask          Fields (WATCH_FIELD_MASK()), not empty.
+*   \param[in]  rate_hz             Line rate (WATCH_MIN_RATE_HZ to WATCH_MAX_RATE_HZ).
+*
+*   \return     Operation status
+*
+*******************************************************************************/
+WATCH_Ret_t WATCH_Start(uint32_t field_mask, uint32_t rate_hz);
+
+/***************************************************************************//*!
+*  \brief Stop watch.
+*
+*   This function is used to stop the stream.
+*
+*   Preconditions: Watch initialized.
+*
+*   Side Effects: None.
+*
+*   \return     Operation status
+*
+*******************************************************************************/
+WATCH_Ret_t WATCH_Stop(void);
+
+/***************************************************************************//*!
+*  \brief Get field name.
+*
+*   This function is used to get the name of a field (shell argument and
+*   column label).
+*
+*   Preconditions: None.
+*
+*   Side Effects: None.
+*
+*   \param[in]  field               Field.
+*
+*   \return     Field name, NULL if invalid
+*
+*******************************************************************************/
+const char *WATCH_GetFieldName(WATCH_Field_t field);
+
+/***************************************************************************//*!
+*  \brief Get watch statistics.
+*
+*   This function is used to get the watch statistics of the current (or
+*   last) stream.
+*
+*   Preconditions: None.
+*
+*   Side Effects: None.
+*
+*   \param[out] pStats              Pointer to store the statistics.
+*
+*   \return     Operation status
+*
+*******************************************************************************/
+WATCH_Ret_t WATCH_GetStats(WATCH_Stats_t *pStats);
+
+#endif//__WATCH_H
@@ -19,6 +19,8 @@
 
 #include "hwi.h"
 #include "taskPriority.h"
+#include "memoryMap.h"
+#include "taskStats.h"
 
 /******************************************************************************
 *   Private Definitions
@@ -49,6 +51,8 @@ static void tMainTask(void *pvParameters);
 *   Private Variables
 *******************************************************************************/
 static TaskHandle_t main_task_handle = NULL;
+static StackType_t main_task_stack[MAIN_TASK_STACK_SIZE];
+static StaticTask_t main_task_buffer;
 
 static const char * TAG = "MAIN";
 
@@ -75,6 +79,7 @@ static void tMainTask(void *pvParameters){
     for(;;){
 
         vTaskDelay(1000/portTICK_PERIOD_MS);
+        TSTAT_MarkRunning(true);
     }
     vTaskDelete(NULL);
 }
@@ -115,12 +120,15 @@ void app_main(void){
     printf("Minimum free heap size: %" PRIu32 " bytes\n", esp_get_minimum_free_heap_size());
 
     //create main task
-    if(pdTRUE != xTaskCreate(tMainTask,
-                             "Main task",
-                             2048,
-                             NULL,
-                             MAIN_TASK_PRIORITY,
-                             &main_task_handle)){
+    main_task_handle = xTaskCreateStaticPinnedToCore(tMainTask,
+                                                     "Main task",
+                                                     MAIN_TASK_STACK_SIZE,
+                                                     NULL,
+                                                     MAIN_TASK_PRIORITY,
+                                                     main_task_stack,
+                                                     &main_task_buffer,
+                                                     MAIN_TASK_CORE);
+    if(main_task_handle == NULL){
 
         ESP_LOGE(TAG, "Failed to create Main task");
         while(1);//Stall here...
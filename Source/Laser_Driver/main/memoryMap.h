@@ -0,0 +1,101 @@
+#ifndef __MEMORY_MAP_H
+#define __MEMORY_MAP_H
+
+/******************************************************************************
+*   Public Definitions
+*******************************************************************************/
+//Task stacks in bytes (StackType_t is uint8_t). The stacks, task control
+//blocks, queues and mutexes are static buffers of their module: nothing
+//is taken from the heap at init. Only the transient bench and driver
+//install tasks (CORE_RunOnCore(), benches) use the heap while they run
+#define MAIN_TASK_STACK_SIZE            (2048)
+#define DISP_TASK_STACK_SIZE            (2048)
+#define MENU_TASK_STACK_SIZE            (2048)
+#define WATCH_TASK_STACK_SIZE           (3072)//Line layout and formatting
+#define TLM_TASK_STACK_SIZE             (3072)//Frame encoding
+#define SHJOB_TASK_STACK_SIZE           (4096)//Per worker, command handlers (benches, printf)
+#define SHCOM_TASK_STACK_SIZE           (2048)
+#define SHCOM_TX_TASK_STACK_SIZE        (2048)
+#define UI_TASK_STACK_SIZE              (2048)
+#define SENSOR_TASK_STACK_SIZE          (2048)
+#define WAVE_TASK_STACK_SIZE            (2048)
+#define TRIGGER_TASK_STACK_SIZE         (2048)
+#define TSTAT_TASK_STACK_SIZE           (2048)
+
+#define MEM_SHJOB_NB_WORKERS            (2)//SHJOB_NB_WORKERS
+
+//Persistent task stacks, checked at compile time
+#define MEM_TASK_STACK_BUDGET           (36864)
+#define MEM_TASK_STACK_TOTAL            (MAIN_TASK_STACK_SIZE +                         \
+                                         DISP_TASK_STACK_SIZE +                         \
+                                         MENU_TASK_STACK_SIZE +                         \
+                                         WATCH_TASK_STACK_SIZE +                        \
+                                         TLM_TASK_STACK_SIZE +                          \
+                                         (SHJOB_TASK_STACK_SIZE * MEM_SHJOB_NB_WORKERS) + \
+                                         SHCOM_TASK_STACK_SIZE +                        \
+                                         SHCOM_TX_TASK_STACK_SIZE +                     \
+                                         UI_TASK_STACK_SIZE +                           \
+                                         SENSOR_TASK_STACK_SIZE +                       \
+                                         WAVE_TASK_STACK_SIZE +                         \
+                                         TRIGGER_TASK_STACK_SIZE +                      \
+                                         TSTAT_TASK_STACK_SIZE)
+
+//Static RAM of the application (.data + .bss of the main component), checked
+//on the link map after each build by tools/ram_budget.py (report in
+//ram_budget.txt, build failed if a budget is exceeded)
+#define MEM_APP_RAM_BUDGET              (92160)
+
+//Per module budgets in bytes (module: source file name), stacks included.
+//Modules not listed only count in MEM_APP_RAM_BUDGET
+#define MEM_MODULE_BUDGETS(BUDGET)                                                      \
+    BUDGET(main,                    3072)                                               \
+    BUDGET(shellCom,                8192)/*Output ring*/                                \
+    BUDGET(shellComUART,            2560)/*DMA buffers*/                                \
+    BUDGET(shellJobs,               13312)                                              \
+    BUDGET(shellCommands,           2048)                                               \
+    BUDGET(myShell_cfg,             2560)/*Bench command table*/                        \
+    BUDGET(watch,                   4608)                                               \
+    BUDGET(telemetry,               7168)/*Task statistics copy*/                       \
+    BUDGET(textFormat,              512)                                                \
+    BUDGET(userInterface,           3072)                                               \
+    BUDGET(menu,                    3072)                                               \
+    BUDGET(displayDriver,           6656)/*Frame buffers*/                              \
+    BUDGET(triggerDriver,           3072)                                               \
+    BUDGET(ledDriver_cfg,           4608)/*Effect sequence*/                            \
+    BUDGET(sensorController,        3072)                                               \
+    BUDGET(pwrMonitoring,           3072)/*Ripple samples*/                             \
+    BUDGET(waveformPlayer,          4608)                                               \
+    BUDGET(currentRegulator,        1024)                                               \
+    BUDGET(coreAffinity,            1536)                                               \
+    BUDGET(taskStats,               6144)/*Task list snapshot*/                         \
+    BUDGET(trace,                   8704)/*Trace records*/                              \
+    BUDGET(benchKernels,            2560)/*Kernel input data*/
+
+/******************************************************************************
+*   Public Macros
+*******************************************************************************/
+
+
+/******************************************************************************
+*   Public Data Types
+*******************************************************************************/
+
+
+/******************************************************************************
+*   Public Variables
+*******************************************************************************/
+
+
+/******************************************************************************
+*   Error Check
+*******************************************************************************/
+#if (MEM_TASK_STACK_TOTAL > MEM_TASK_STACK_BUDGET)
+#error "Task stacks exceed MEM_TASK_STACK_BUDGET"
+#endif
+
+/******************************************************************************
+*   Public Functions
+*******************************************************************************/
+
+
+#endif//__MEMORY_MAP_H
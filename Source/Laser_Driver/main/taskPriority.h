@@ -4,15 +4,50 @@
 /******************************************************************************
 *   Public Definitions
 *******************************************************************************/
+#define TSTAT_TASK_PRIORITY             (1)//Statistics sampling, lowest application task
+#define DISP_TASK_PRIORITY              (2)//Background flush, below every task
+#define MENU_TASK_PRIORITY              (3)
+#define WATCH_TASK_PRIORITY             (3)//Text stream, throttled by the output ring
 #define MAIN_TASK_PRIORITY              (4)
+#define TLM_TASK_PRIORITY               (4)//Below the sensor and control tasks
+#define SHJOB_TASK_PRIORITY             (4)//Shell commands, below the listener (Ctrl-C)
 #define SHCOM_TASK_PRIORITY             (5)
+#define SHCOM_TX_TASK_PRIORITY          (5)//Blocked on the UART most of the time
 #define SENSOR_TASK_PRIORITY            (6)
 #define UI_TASK_PRIORITY                (7)
+#define WAVE_TASK_PRIORITY              (8)
 #define TRIGGER_TASK_PRIORITY           (9)
 
+//Core placement: sensor acquisition, waveform and trigger (and their
+//interrupts) on the control core, user interface and communication on the
+//I/O core with app_main and esp_timer. 0: every task floats
+#define TASK_CORE_PINNING               (1)
+#define CONTROL_CORE_ID                 (1)//APP CPU
+#define IO_CORE_ID                      (0)//PRO CPU
+
+#define TSTAT_TASK_CORE                 TASK_CORE(IO_CORE_ID)
+#define DISP_TASK_CORE                  TASK_CORE(IO_CORE_ID)
+#define MENU_TASK_CORE                  TASK_CORE(IO_CORE_ID)
+#define WATCH_TASK_CORE                 TASK_CORE(IO_CORE_ID)
+#define MAIN_TASK_CORE                  TASK_CORE(IO_CORE_ID)
+#define TLM_TASK_CORE                   TASK_CORE(IO_CORE_ID)
+#define SHJOB_TASK_CORE                 TASK_CORE(IO_CORE_ID)
+#define SHCOM_TASK_CORE                 TASK_CORE(IO_CORE_ID)
+#define SHCOM_TX_TASK_CORE              TASK_CORE(IO_CORE_ID)
+#define UI_TASK_CORE                    TASK_CORE(IO_CORE_ID)
+#define SENSOR_TASK_CORE                TASK_CORE(CONTROL_CORE_ID)
+#define WAVE_TASK_CORE                  TASK_CORE(CONTROL_CORE_ID)
+#define TRIGGER_TASK_CORE               TASK_CORE(CONTROL_CORE_ID)
+#define CONTROL_ISR_CORE                TASK_CORE(CONTROL_CORE_ID)//Regulator, ADC and playback timers
+
 /******************************************************************************
 *   Public Macros
 *******************************************************************************/
+#if (TASK_CORE_PINNING == 1)
+#define TASK_CORE(core)                 (core)
+#else
+#define TASK_CORE(core)                 (tskNO_AFFINITY)
+#endif
 
 
 /******************************************************************************
@@ -28,6 +63,9 @@
 /******************************************************************************
 *   Error Check
 *******************************************************************************/
+#if (TASK_CORE_PINNING == 1) && (CONTROL_CORE_ID == IO_CORE_ID)
+#error "The control and I/O paths must be on different cores"
+#endif
 
 
 /******************************************************************************
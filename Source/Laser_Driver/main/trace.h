@@ -0,0 +1,206 @@
+#ifndef __TRACE_H
+#define __TRACE_H
+
+#include <stdint.h>
+#include <stdbool.h>
+
+#include "sdkconfig.h"
+
+/******************************************************************************
+*   Public Definitions
+*******************************************************************************/
+//Trace points of the sensing and control paths, recorded in a RAM ring
+//(HWI/trace.c) and dumped with the 'trace' shell command. 0: every trace
+//point is removed at compile time
+#define TRACE_ENABLE                        (1)
+
+#define TRACE_BUFFER_SIZE                   (1024)//Records (power of 2), 8 bytes each
+
+//Trace points: identifier, name in the dump
+#define TRACE_EVENTS(EVENT)                                                             \
+    EVENT(ADC_FRAME,        adc_frame)      /*ADC continuous frame (ISR), arg: bytes*/  \
+    EVENT(SENSOR_STEP,      sensor_step)    /*Sensor task step, arg: step*/             \
+    EVENT(REG_LOOP,         reg_loop)       /*Regulation loop (ISR), begin/end*/        \
+    EVENT(REG_FAULT,        reg_fault)      /*Regulator fault latched, arg: flags*/     \
+    EVENT(TRIGGER_EDGE,     trigger_edge)   /*Debounced trigger change, arg: state*/    \
+    EVENT(UI_POST,          ui_post)        /*UI event posted, arg: event*/             \
+    EVENT(UI_HANDLE,        ui_handle)      /*UI event handled, arg: event*/            \
+    EVENT(USER,             user)           /*Ad hoc trace point*/
+
+/******************************************************************************
+*   Public Macros
+*******************************************************************************/
+#if (TRACE_ENABLE == 1) && !defined(CONFIG_IDF_TARGET_LINUX)
+#define TRACE_IS_ENABLED                    (1)
+#define TRACE_EVENT(event, arg)             TRACE_Record((event), TRACE_TYPE_POINT, (uint16_t)(arg))
+#define TRACE_BEGIN(event, arg)             TRACE_Record((event), TRACE_TYPE_BEGIN, (uint16_t)(arg))
+#define TRACE_END(event, arg)               TRACE_Record((event), TRACE_TYPE_END, (uint16_t)(arg))
+#else
+#define TRACE_IS_ENABLED                    (0)
+#define TRACE_EVENT(event, arg)             do{}while(0)
+#define TRACE_BEGIN(event, arg)             do{}while(0)
+#define TRACE_END(event, arg)               do{}while(0)
+#endif
+
+//Record type and core
+#define TRACE_TYPE_MASK                     (0x0F)
+#define TRACE_CORE_SHIFT                    (4)
+#define TRACE_RECORD_TYPE(pRecord)          ((pRecord)->type_core & TRACE_TYPE_MASK)
+#define TRACE_RECORD_CORE(pRecord)          ((pRecord)->type_core >> TRACE_CORE_SHIFT)
+
+/******************************************************************************
+*   Public Data Types
+*******************************************************************************/
+#define TRACE_EVENT_ID(id, name)            TRACE_##id,
+typedef enum TRACE_Event_e{
+    TRACE_EVENTS(TRACE_EVENT_ID)
+
+    TRACE_INVALID,
+}TRACE_Event_t;
+#undef TRACE_EVENT_ID
+
+typedef enum TRACE_Type_e{
+    TRACE_TYPE_POINT,
+    TRACE_TYPE_BEGIN,
+    TRACE_TYPE_END,
+
+    TRACE_TYPE_INVALID,
+}TRACE_Type_t;
+
+typedef enum TRACE_Mode_e{
+    TRACE_MODE_RING,                    //Overwrite: last TRACE_BUFFER_SIZE records
+    TRACE_MODE_ONCE,                    //Stop when full: first TRACE_BUFFER_SIZE records
+
+    TRACE_MODE_INVALID,
+}TRACE_Mode_t;
+
+typedef struct TRACE_Record_s{
+    uint32_t time_us;                   //esp_timer, common to both cores
+    uint8_t event;                      //TRACE_Event_t
+    uint8_t type_core;                  //Type (bits 0-3), core (bits 4-7)
+    uint16_t arg;
+}TRACE_Record_t;
+
+typedef struct TRACE_Stats_s{
+    bool is_running;
+    TRACE_Mode_t mode;
+    uint32_t nb_records;                //Recorded since the start
+    uint32_t nb_kept;                   //In the buffer (the others overwritten or dropped)
+}TRACE_Stats_t;
+
+typedef enum TRACE_Ret_e{
+    TRACE_STATUS_ERROR,
+    TRACE_STATUS_OK,
+}TRACE_Ret_t;
+
+/******************************************************************************
+*   Public Variables
+*******************************************************************************/
+
+
+/******************************************************************************
+*   Error Check
+*******************************************************************************/
+#if ((TRACE_BUFFER_SIZE & (TRACE_BUFFER_SIZE - 1)) != 0)
+#error "Trace buffer size must be a power of 2"
+#endif
+
+/******************************************************************************
+*   Public Functions Declarations
+*******************************************************************************/
+/***************************************************************************//*!
+*  \brief Record trace event.
+*
+*   This function records a trace event with its time and core (use the
+*   TRACE_EVENT(), TRACE_BEGIN() and TRACE_END() macros). It is lock free
+*   and returns at once while the trace is stopped.
+*
+*   Preconditions: None. Task or ISR.
+*
+*   Side Effects: None.
+*
+*   \param[in]  event               Event.
+*   \param[in]  type                Point, begin or end.
+*   \param[in]  arg                 Event argument.
+*
+*******************************************************************************/
+void TRACE_Record(TRACE_Event_t event, TRACE_Type_t type, uint16_t arg);
+
+/***************************************************************************//*!
+*  \brief Start trace.
+*
+*   This function is used to clear the trace buffer and start recording.
+*
+*   Preconditions: None.
+*
+*   Side Effects: None.
+*
+*   \param[in]  mode                Ring or once.
+*
+*   \return     Operation status
+*
+*******************************************************************************/
+TRACE_Ret_t TRACE_Start(TRACE_Mode_t mode);
+
+/***************************************************************************//*!
+*  \brief Stop trace.
+*
+*   This function is used to stop recording. The records are kept until
+*   the next start.
+*
+*   Preconditions: None.
+*
+*   Side Effects: None.
+*
+*******************************************************************************/
+void TRACE_Stop(void);
+
+/***************************************************************************//*!
+*  \brief Get trace record.
+*
+*   This function is used to read the records of a stopped trace, oldest
+*   first.
+*
+*   Preconditions: Trace stopped.
+*
+*   Side Effects: None.
+*
+*   \param[in]  index               Record index (0: oldest).
+*   \param[out] pRecord             Record.
+*
+*   \return     Operation status (error past the last record or running)
+*
+*******************************************************************************/
+TRACE_Ret_t TRACE_GetRecord(uint32_t index, TRACE_Record_t *pRecord);
+
+/***************************************************************************//*!
+*  \brief Get event name.
+*
+*   This function returns the name of an event in the dump.
+*
+*   Preconditions: None.
+*
+*   Side Effects: None.
+*
+*   \param[in]  event               Event.
+*
+*   \return     Name ("?" if invalid)
+*
+*******************************************************************************/
+const char *TRACE_GetEventName(uint8_t event);
+
+/***************************************************************************//*!
+*  \brief Get trace statistics.
+*
+*   This function is used to get the trace state and counters.
+*
+*   Preconditions: None.
+*
+*   Side Effects: None.
+*
+*   \param[out] pStats              Statistics.
+*
+*******************************************************************************/
+void TRACE_GetStats(TRACE_Stats_t *pStats);
+
+#endif//__TRACE_H
@@ -0,0 +1,123 @@
+#!/usr/bin/env python3
+"""Static RAM budget check.
+
+Sums the RAM input sections (.data, .bss, DRAM_ATTR, COMMON) of every module
+(source file) of the application library in the link map, and compares them
+with the budgets of the memory map (main/memoryMap.h):
+    MEM_APP_RAM_BUDGET              whole library
+    BUDGET(<module>, <bytes>)       per module (MEM_MODULE_BUDGETS)
+
+The report is printed. It is written to the output file only when every
+budget is met, so a failed check fails the next build again.
+
+Usage: ram_budget.py <link map> <memoryMap.h> <output report> [library]
+"""
+
+import os
+import re
+import sys
+
+DEFAULT_LIBRARY = "libmain.a"
+
+RAM_SECTIONS = (".data", ".bss", ".sdata", ".sbss", ".dram1", "COMMON")
+
+INPUT_SECTION = re.compile(r"^ (\S+)\s+0x([0-9a-fA-F]+)\s+0x([0-9a-fA-F]+)\s+(\S.*)$")
+WRAPPED_NAME = re.compile(r"^ (\S+)$")
+WRAPPED_REST = re.compile(r"^\s+0x([0-9a-fA-F]+)\s+0x([0-9a-fA-F]+)\s+(\S.*)$")
+
+
+def parse_budgets(path):
+    with open(path, "r", encoding="utf-8") as f:
+        source = f.read()
+    app = re.search(r"#define\s+MEM_APP_RAM_BUDGET\s+\((\d+)\)", source)
+    if app is None:
+        raise ValueError("MEM_APP_RAM_BUDGET not found in %s" % path)
+    modules = [(m, int(b)) for m, b in re.findall(r"BUDGET\((\w+),\s*(\d+)\)", source)]
+    return int(app.group(1)), modules
+
+
+def module_of(obj, library):
+    """Return the module of an input file of the library, None otherwise."""
+    m = re.search(re.escape(library) + r"\(([^)]+)\)$", obj.strip())
+    if m is None:
+        return None
+    return m.group(1).split(".")[0]
+
+
+def parse_map(path, library):
+    """Return {module: bytes} of the RAM input sections of the library."""
+    used = {}
+    with open(path, "r", encoding="utf-8", errors="replace") as f:
+        lines = f.read().splitlines()
+    # Discarded sections are listed before the memory map
+    try:
+        start = lines.index("Linker script and memory map")
+    except ValueError:
+        raise ValueError("memory map not found in %s" % path)
+    pending = None
+    for line in lines[start:]:
+        if pending is not None:
+            m = WRAPPED_REST.match(line)
+            name, pending = pending, None
+            if m is None:
+                continue
+            size, obj = int(m.group(2), 16), m.group(3)
+        else:
+            m = INPUT_SECTION.match(line)
+            if m is None:
+                w = WRAPPED_NAME.match(line)
+                if w is not None:
+                    pending = w.group(1)
+                continue
+            name, size, obj = m.group(1), int(m.group(3), 16), m.group(4)
+        if size == 0 or not name.startswith(RAM_SECTIONS):
+            continue
+        module = module_of(obj, library)
+        if module is not None:
+            used[module] = used.get(module, 0) + size
+    return used
+
+
+def report_line(name, used, budget):
+    if budget is None:
+        return "%-24s%10d%10s\n" % (name, used, "-")
+    return "%-24s%10d%10d%6d%%%s\n" % (name, used, budget, used * 100 // budget,
+                                       "  OVER" if used > budget else "")
+
+
+def main(argv):
+    if len(argv) < 4:
+        sys.stderr.write(__doc__)
+        return 1
+    library = argv[4] if len(argv) > 4 else DEFAULT_LIBRARY
+    app_budget, budgets = parse_budgets(argv[2])
+    used = parse_map(argv[1], library)
+
+    out = "Static RAM of %s (.data + .bss, bytes)\n" % library
+    out += "%-24s%10s%10s\n" % ("module", "used", "budget")
+    nb_over = 0
+    for module, budget in budgets:
+        out += report_line(module, used.get(module, 0), budget)
+        nb_over += used.get(module, 0) > budget
+    others = sorted(m for m in used if m not in dict(budgets))
+    for module in others:
+        out += report_line(module, used[module], None)
+    total = sum(used.values())
+    out += report_line("total", total, app_budget)
+    nb_over += total > app_budget
+
+    if nb_over:
+        sys.stderr.write(out)
+        sys.stderr.write("RAM budget exceeded (main/memoryMap.h)\n")
+        if os.path.exists(argv[3]):
+            os.remove(argv[3])
+        return 1
+
+    sys.stdout.write(out)
+    with open(argv[3], "w", encoding="utf-8") as f:
+        f.write(out)
+    return 0
+
+
+if __name__ == "__main__":
+    sys.exit(main(sys.argv))
@@ -0,0 +1,234 @@
+#!/usr/bin/env python3
+"""Telemetry stream decoder.
+
+Separates the binary telemetry frames (UserInterface/telemetry.h) from the
+shell text on the shell port, checks them and reports dropped frames
+(sequence gaps), corrupted frames and the rate of every channel.
+
+Wire format: 0x1E, COBS(payload), 0x00
+Payload (little endian): channel u8, sequence u16, timestamp us u32, data,
+CRC-16/X-25 u16 of the previous fields.
+
+Usage:
+    tlm_decode.py /dev/ttyUSB0 [--baud 921600] [--text] [--frames]
+    tlm_decode.py /dev/ttyACM0 [--text] [--frames]   (USB Serial/JTAG, baud ignored)
+    tlm_decode.py capture.bin [--text] [--frames]
+
+Serial ports need pyserial. Send 'tlm on' and 'tlm rate ...' from a
+terminal or with --send.
+"""
+
+import argparse
+import struct
+import sys
+import time
+
+FRAME_START = 0x1E
+FRAME_END = 0x00
+HEADER_SIZE = 7
+CRC_SIZE = 2
+MAX_WIRE_SIZE = 1 + 267 + 1
+
+CHANNELS = ["adc", "power", "reg", "fault", "tasks"]
+FAULTS = {0x01: "overcurrent", 0x02: "external"}
+TASK_HEADER_SIZE = 6
+TASK_RECORD_SIZE = 17
+
+
+def crc16_x25(data):
+    crc = 0xFFFF
+    for b in data:
+        crc ^= b
+        for _ in range(8):
+            crc = (crc >> 1) ^ 0x8408 if crc & 1 else crc >> 1
+    return crc ^ 0xFFFF
+
+
+def cobs_decode(data):
+    out = bytearray()
+    i = 0
+    while i < len(data):
+        code = data[i]
+        if code == 0 or i + code > len(data):
+            raise ValueError("bad COBS block")
+        out += data[i + 1:i + code]
+        i += code
+        if code < 0xFF and i < len(data):
+            out.append(0)
+    return bytes(out)
+
+
+def decode_data(channel, data):
+    if channel == 0:
+        overruns = struct.unpack_from("<H", data)[0]
+        values = {}
+        for (word,) in struct.iter_unpack("<I", data[2:2 + ((len(data) - 2) // 4) * 4]):
+            values.setdefault((word >> 13) & 0xF, []).append(word & 0xFFF)
+        means = " ".join("ch%d=%d" % (ch, sum(v) // len(v)) for ch, v in sorted(values.items()))
+        return "overruns=%d %s" % (overruns, means)
+    if channel == 1:
+        bus, ia, ib = struct.unpack_from("<hhh", data)
+        return "bus=%.2fV ia=%.2fA ib=%.2fA" % (bus / 100, ia / 100, ib / 100)
+    if channel == 2:
+        out = []
+        for phase in range(len(data) // 9):
+            sp, tg, cur, duty, flags = struct.unpack_from("<hhhHB", data, phase * 9)
+            out.append("%s: sp=%.2f tg=%.2f i=%.2fA duty=%.2f%%%s%s" % (
+                "AB"[phase] if phase < 2 else phase, sp / 100, tg / 100, cur / 100, duty / 100,
+                " sat" if flags & 1 else "", " ramp" if flags & 2 else ""))
+        return " | ".join(out)
+    if channel == 3:
+        fault, previous = data[0], data[1]
+        names = [n for bit, n in FAULTS.items() if fault & bit] or ["none"]
+        return "fault=0x%02X (%s) previous=0x%02X" % (fault, ",".join(names), previous)
+    if channel == 4:
+        nb_tasks, first, load0, load1 = struct.unpack_from("<BBHH", data)
+        out = ["tasks %d-%d/%d load=%.1f%%,%.1f%%" % (
+            first, first + (len(data) - TASK_HEADER_SIZE) // TASK_RECORD_SIZE - 1, nb_tasks, load0 / 10, load1 / 10)]
+        for offset in range(TASK_HEADER_SIZE, len(data) - TASK_RECORD_SIZE + 1, TASK_RECORD_SIZE):
+            name = data[offset:offset + 8].split(b"\0")[0].decode("ascii", "replace")
+            core, cpu, stack, wakeups, latency = struct.unpack_from("<BHHHH", data, offset + 8)
+            out.append("%s: core=%s cpu=%.1f%% stack=%d wake=%d/s lat=%dus" % (
+                name, "any" if core == 0xFF else core, cpu / 10, stack, wakeups, latency))
+        return " | ".join(out)
+    return data.hex()
+
+
+class Decoder:
+
+    def __init__(self, show_text, show_frames):
+        self.show_text = show_text
+        self.show_frames = show_frames
+        self.in_frame = False
+        self.frame = bytearray()
+        self.text = bytearray()
+        self.last_seq = None
+        self.nb_frames = 0
+        self.nb_dropped = 0
+        self.nb_corrupted = 0
+        self.nb_adc_overruns = 0
+        self.channel_count = [0] * len(CHANNELS)
+        self.first_us = None
+        self.last_us = None
+
+    def feed(self, chunk):
+        for b in chunk:
+            if self.in_frame:
+                if b == FRAME_END:
+                    self.in_frame = False
+                    self.frame_done(bytes(self.frame))
+                elif len(self.frame) >= MAX_WIRE_SIZE:
+                    # Lost end delimiter: drop and resync on text
+                    self.in_frame = False
+                    self.nb_corrupted += 1
+                else:
+                    self.frame.append(b)
+            elif b == FRAME_START:
+                self.in_frame = True
+                self.frame = bytearray()
+            else:
+                self.text_byte(b)
+
+    def text_byte(self, b):
+        if not self.show_text:
+            return
+        if b == 0x0A:
+            sys.stdout.write("text: " + self.text.decode("ascii", "replace").rstrip("\r") + "\n")
+            self.text = bytearray()
+        else:
+            self.text.append(b)
+
+    def frame_done(self, encoded):
+        try:
+            payload = cobs_decode(encoded)
+        except ValueError:
+            self.nb_corrupted += 1
+            return
+
+        if len(payload) < HEADER_SIZE + CRC_SIZE:
+            self.nb_corrupted += 1
+            return
+
+        crc = struct.unpack_from("<H", payload, len(payload) - CRC_SIZE)[0]
+        if crc != crc16_x25(payload[:-CRC_SIZE]):
+            self.nb_corrupted += 1
+            return
+
+        channel, seq, timestamp_us = struct.unpack_from("<BHI", payload)
+        data = payload[HEADER_SIZE:-CRC_SIZE]
+
+        if self.last_seq is not None:
+            self.nb_dropped += (seq - self.last_seq - 1) & 0xFFFF
+        self.last_seq = seq
+
+        self.nb_frames += 1
+        if self.first_us is None:
+            self.first_us = timestamp_us
+        self.last_us = timestamp_us
+        if channel < len(self.channel_count):
+            self.channel_count[channel] += 1
+        if channel == 0 and len(data) >= 2:
+            self.nb_adc_overruns = struct.unpack_from("<H", data)[0]
+
+        if self.show_frames:
+            name = CHANNELS[channel] if channel < len(CHANNELS) else str(channel)
+            sys.stdout.write("%10.6f #%05d %-5s %s\n" % (timestamp_us / 1e6, seq, name, decode_data(channel, data)))
+
+    def device_elapsed_s(self):
+        if self.first_us is None or self.last_us == self.first_us:
+            return 1e-3
+        return ((self.last_us - self.first_us) & 0xFFFFFFFF) / 1e6
+
+    def report(self, elapsed_s):
+        rates = " ".join("%s=%.1f/s" % (name, count / elapsed_s)
+                         for name, count in zip(CHANNELS, self.channel_count) if count)
+        total = self.nb_frames + self.nb_dropped
+        sys.stderr.write("frames=%d dropped=%d (%.2f%%) corrupted=%d adc_overruns=%d %s\n" % (
+            self.nb_frames, self.nb_dropped, (100.0 * self.nb_dropped / total) if total else 0.0,
+            self.nb_corrupted, self.nb_adc_overruns, rates))
+
+
+def main():
+    parser = argparse.ArgumentParser(description="Decode the telemetry stream of the shell port.")
+    parser.add_argument("source", help="serial port or capture file ('-' for stdin)")
+    parser.add_argument("--baud", type=int, default=921600)
+    parser.add_argument("--text", action="store_true", help="print the shell text")
+    parser.add_argument("--frames", action="store_true", help="print every decoded frame")
+    parser.add_argument("--send", action="append", default=[], help="shell command to send first (serial)")
+    parser.add_argument("--report", type=float, default=1.0, help="report period in seconds")
+    args = parser.parse_args()
+
+    decoder = Decoder(args.text, args.frames)
+    start = time.monotonic()
+    last_report = start
+
+    if args.source == "-" or not args.source.startswith(("/dev/", "COM")):
+        stream = sys.stdin.buffer if args.source == "-" else open(args.source, "rb")
+        while True:
+            chunk = stream.read(4096)
+            if not chunk:
+                break
+            decoder.feed(chunk)
+        # Capture: rates over the device timestamps
+        decoder.report(decoder.device_elapsed_s())
+        return 0
+
+    import serial  # pyserial, only needed for live ports
+
+    with serial.Serial(args.source, args.baud, timeout=0.1) as port:
+        for command in args.send:
+            port.write((command + "\r").encode("ascii"))
+        try:
+            while True:
+                decoder.feed(port.read(4096))
+                now = time.monotonic()
+                if now - last_report >= args.report:
+                    decoder.report(now - start)
+                    last_report = now
+        except KeyboardInterrupt:
+            decoder.report(time.monotonic() - start)
+    return 0
+
+
+if __name__ == "__main__":
+    sys.exit(main())
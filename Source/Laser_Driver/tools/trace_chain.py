@@ -0,0 +1,130 @@
+#!/usr/bin/env python3
+"""Trace dump analysis.
+
+Reads the CSV dump of the 'trace dump' shell command (main/trace.h) and
+reports, per event, the count and the interval between occurrences, the
+duration of the begin/end spans, and the latency of event chains: for each
+occurrence of the first event of a chain, the time to the next occurrence
+of each following event.
+
+CSV: time_us,core,event,type,arg (type: point, begin or end). Lines starting
+with '#' and the shell text around the dump are ignored.
+
+Usage:
+    trace_chain.py dump.csv
+    trace_chain.py dump.csv --chain adc_frame,sensor_step,ui_post,ui_handle
+    trace_chain.py dump.csv --chain trigger_edge,ui_post --arg
+"""
+
+import argparse
+import sys
+
+TIME_WRAP = 1 << 32
+
+
+def parse(path):
+    """Return [(time_us, core, event, type, arg)], time unwrapped."""
+    records = []
+    offset = 0
+    last = None
+    with open(path, "r", encoding="utf-8", errors="replace") as f:
+        for line in f:
+            fields = line.strip().split(",")
+            if len(fields) != 5 or not fields[0].isdigit():
+                continue
+            t = int(fields[0])
+            if last is not None and t + offset < last - TIME_WRAP // 2:
+                offset += TIME_WRAP
+            t += offset
+            last = t
+            records.append((t, int(fields[1]), fields[2], fields[3], int(fields[4])))
+    return records
+
+
+def stats_line(name, values):
+    if not values:
+        return "%-24s%8d\n" % (name, 0)
+    values = sorted(values)
+    p99 = values[min(len(values) - 1, len(values) * 99 // 100)]
+    return "%-24s%8d%10d%10d%10d%10d\n" % (name, len(values), values[0],
+                                           sum(values) // len(values), p99, values[-1])
+
+
+def header(title):
+    return "%-24s%8s%10s%10s%10s%10s\n" % (title, "count", "min us", "avg us", "p99 us", "max us")
+
+
+def report_events(records):
+    out = header("interval")
+    times = {}
+    for t, _, event, rtype, _ in records:
+        if rtype != "end":
+            times.setdefault(event, []).append(t)
+    for event in sorted(times):
+        out += stats_line(event, [b - a for a, b in zip(times[event], times[event][1:])])
+    return out
+
+
+def report_spans(records):
+    out = header("span")
+    open_spans = {}
+    spans = {}
+    for t, core, event, rtype, _ in records:
+        if rtype == "begin":
+            open_spans[(event, core)] = t
+        elif rtype == "end" and (event, core) in open_spans:
+            spans.setdefault(event, []).append(t - open_spans.pop((event, core)))
+    for event in sorted(spans):
+        out += stats_line(event, spans[event])
+    return out
+
+
+def report_chain(records, chain, match_arg):
+    """Latency from each occurrence of chain[0] to the next of each link."""
+    out = header(" > ".join(chain))
+    latencies = [[] for _ in chain[1:]]
+    points = [r for r in records if r[3] != "end"]
+    for i, (t0, _, event, _, arg) in enumerate(points):
+        if event != chain[0]:
+            continue
+        j = i + 1
+        for link, name in enumerate(chain[1:]):
+            while j < len(points) and (points[j][2] != name or
+                                       (match_arg and points[j][4] != arg)):
+                j += 1
+            if j >= len(points):
+                break
+            latencies[link].append(points[j][0] - t0)
+            j += 1
+    for link, name in enumerate(chain[1:]):
+        out += stats_line("-> " + name, latencies[link])
+    return out
+
+
+def main():
+    parser = argparse.ArgumentParser(description="Trace dump analysis")
+    parser.add_argument("dump", help="CSV dump of 'trace dump'")
+    parser.add_argument("--chain", help="comma separated events, first one starts the chain")
+    parser.add_argument("--arg", action="store_true", help="chain events must have the same arg")
+    args = parser.parse_args()
+
+    records = parse(args.dump)
+    if not records:
+        sys.stderr.write("No trace record in %s\n" % args.dump)
+        return 1
+
+    out = "%d records, %d us\n\n" % (len(records), records[-1][0] - records[0][0])
+    out += report_events(records) + "\n"
+    out += report_spans(records)
+    if args.chain:
+        chain = args.chain.split(",")
+        if len(chain) < 2:
+            sys.stderr.write("A chain needs two events at least\n")
+            return 1
+        out += "\n" + report_chain(records, chain, args.arg)
+    sys.stdout.write(out)
+    return 0
+
+
+if __name__ == "__main__":
+    sys.exit(main())
@@ -120,6 +120,17 @@ typedef struct {
     ledc_cb_t fade_cb;                  /**< LEDC fade_end callback function */
 } ledc_cbs_t;
 
+/**
+ * @brief LEDC channel parameters of a batched update
+ */
+typedef struct {
+    ledc_channel_t channel;             /**< LEDC channel, bound to the batch timer */
+    uint32_t target_duty;               /**< Duty to set, or target duty of the fade [0, (2**duty_resolution)] */
+    uint32_t scale;                     /**< Duty change of each fade step, 0 to set target_duty at once */
+    uint32_t cycle_num;                 /**< PWM cycles of each fade step. With scale 0: hold time in cycles before the
+                                             fade end event, 0 to set the duty without fade end event */
+} ledc_batch_param_t;
+
 /**
  * @brief LEDC channel configuration
  *        Configure LEDC channel with the given channel/output gpio_num/interrupt/source timer/frequency(Hz)/LEDC duty
@@ -584,6 +595,68 @@ esp_err_t ledc_set_fade_time_and_start(ledc_mode_t speed_mode, ledc_channel_t ch
  */
 esp_err_t ledc_set_fade_step_and_start(ledc_mode_t speed_mode, ledc_channel_t channel, uint32_t target_duty, uint32_t scale, uint32_t cycle_num, ledc_fade_mode_t fade_mode);
 
+/**
+ * @brief Set and start LEDC fade function from an ISR (e.g. from the LEDC_FADE_END_EVT callback)
+ *
+ * @note  Call ledc_fade_func_install() and configure the fade of the channel once from a task before
+ *        calling this function, so that the channel fade object exists.
+ * @note  This function never blocks: if a fade is still running on the channel it returns ESP_ERR_INVALID_STATE.
+ *        Calling it from the fade end callback of the same channel chains fades without any task wakeup.
+ *
+ * @param speed_mode Select the LEDC channel group with specified speed mode. Note that not all targets support high speed mode.
+ * @param channel LEDC channel index (0 - LEDC_CHANNEL_MAX-1), select from ledc_channel_t
+ * @param target_duty Target duty of fading [0, (2**duty_resolution)]
+ * @param scale Controls the increase or decrease step scale, 0 to set the target duty at once and hold it
+ * @param cycle_num increase or decrease the duty every cycle_num cycles (scale 0: hold time in cycles)
+ *
+ * @return
+ *     - ESP_OK Success
+ *     - ESP_ERR_INVALID_ARG Parameter error
+ *     - ESP_ERR_INVALID_STATE Channel not initialized, fade service not installed or fade in progress
+ */
+esp_err_t ledc_set_fade_step_and_start_isr(ledc_mode_t speed_mode, ledc_channel_t channel, uint32_t target_duty, uint32_t scale, uint32_t cycle_num);
+
+/**
+ * @brief Set the duty or start the fade of several channels of a timer at once
+ *
+ * All the channels are configured under a single lock acquisition and latched by the hardware on the same PWM period
+ * boundary: the channels of a RGB led change color together instead of one after the other.
+ *
+ * @note  Channels with a fade end event (cycle_num > 0) need the fade service (ledc_fade_func_install()). They are
+ *        started in LEDC_FADE_NO_WAIT mode, the fade end callback of each channel is called as for a single fade.
+ * @note  The function waits for the fades in progress on the channels, as ledc_set_duty() does.
+ *
+ * @param speed_mode Select the LEDC channel group with specified speed mode. Note that not all targets support high speed mode.
+ * @param timer_sel LEDC timer the channels are bound to
+ * @param params Channel parameters
+ * @param param_num Number of channels (1 - LEDC_CHANNEL_MAX, each channel at most once)
+ *
+ * @return
+ *     - ESP_OK Success
+ *     - ESP_ERR_INVALID_ARG Parameter error (channel not bound to timer_sel, duty, scale or cycle_num out of range)
+ *     - ESP_ERR_INVALID_STATE Channel not initialized or fade service not installed
+ */
+esp_err_t ledc_set_batch_and_update(ledc_mode_t speed_mode, ledc_timer_t timer_sel, const ledc_batch_param_t *params, uint32_t param_num);
+
+/**
+ * @brief Set the duty or start the fade of several channels of a timer at once from an ISR
+ *
+ * Same as ledc_set_batch_and_update(), without blocking: if a fade is still running on one of the channels, no
+ * channel is updated. Calling it from a fade end callback restarts several channels in phase.
+ *
+ *
+ * @param speed_mode Select the LEDC channel group with specified speed mode. Note that not all targets support high speed mode.
+ * @param timer_sel LEDC timer the channels are bound to
+ * @param params Channel parameters
+ * @param param_num Number of channels (1 - LEDC_CHANNEL_MAX, each channel at most once)
+ *
+ * @return
+ *     - ESP_OK Success
+ *     - ESP_ERR_INVALID_ARG Parameter error
+ *     - ESP_ERR_INVALID_STATE Channel not initialized, fade service not installed or fade in progress
+ */
+esp_err_t ledc_set_batch_and_update_isr(ledc_mode_t speed_mode, ledc_timer_t timer_sel, const ledc_batch_param_t *params, uint32_t param_num);
+
 /**
  * @brief LEDC callback registration function
  *
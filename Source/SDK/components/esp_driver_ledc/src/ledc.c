@@ -117,6 +117,8 @@ static _lock_t s_ledc_mutex[LEDC_SPEED_MODE_MAX];
 #define LEDC_FADE_TOO_FAST_STR    "LEDC FADE TOO FAST"
 #define DIM(array)                (sizeof(array)/sizeof(*array))
 #define LEDC_IS_DIV_INVALID(div)  ((div) <= LEDC_LL_FRACTIONAL_MAX || (div) > LEDC_TIMER_DIV_NUM_MAX)
+#define LEDC_BATCH_GUARD_SHIFT    (6)                             // Batch latch kept out of the last 1/64 of the PWM period
+#define LEDC_BATCH_GUARD_MAX_READ (1024)                          // Bound of the batch guard wait (timer paused)
 
 static __attribute__((unused)) const char *LEDC_NOT_INIT = "LEDC is not initialized";
 static __attribute__((unused)) const char *LEDC_FADE_SERVICE_ERR_STR = "LEDC fade service not installed";
@@ -1618,6 +1620,221 @@ esp_err_t ledc_set_fade_step_and_start(ledc_mode_t speed_mode, ledc_channel_t ch
     return ESP_OK;
 }
 
+static IRAM_ATTR esp_err_t _ledc_batch_check(ledc_mode_t speed_mode, ledc_timer_t timer_sel, const ledc_batch_param_t *params, uint32_t param_num)
+{
+    LEDC_ARG_CHECK_ISR(speed_mode < LEDC_SPEED_MODE_MAX, "speed_mode");
+    LEDC_ARG_CHECK_ISR(timer_sel < LEDC_TIMER_MAX, "timer_sel");
+    LEDC_ARG_CHECK_ISR((params != NULL) && (param_num > 0) && (param_num <= LEDC_CHANNEL_MAX), "params");
+    LEDC_CHECK_ISR(p_ledc_obj[speed_mode] != NULL, LEDC_NOT_INIT, ESP_ERR_INVALID_STATE);
+    uint32_t max_duty = 0;
+    uint32_t channel_mask = 0;
+    ledc_hal_get_max_duty(&(p_ledc_obj[speed_mode]->ledc_hal), timer_sel, &max_duty);
+    for (uint32_t i = 0; i < param_num; i++) {
+        const ledc_batch_param_t *param = &params[i];
+        ledc_timer_t channel_timer;
+        LEDC_ARG_CHECK_ISR(param->channel < LEDC_CHANNEL_MAX, "channel");
+        LEDC_ARG_CHECK_ISR((channel_mask & BIT(param->channel)) == 0, "channel");
+        ledc_hal_get_channel_timer(&(p_ledc_obj[speed_mode]->ledc_hal), param->channel, &channel_timer);
+        LEDC_ARG_CHECK_ISR(channel_timer == timer_sel, "timer_sel");
+        LEDC_ARG_CHECK_ISR(param->target_duty <= max_duty, "target_duty");
+        LEDC_ARG_CHECK_ISR(param->scale <= LEDC_LL_DUTY_SCALE_MAX, "fade scale");
+        LEDC_ARG_CHECK_ISR(param->cycle_num <= LEDC_LL_DUTY_CYCLE_MAX, "cycle_num");
+        LEDC_ARG_CHECK_ISR((param->scale == 0) || (param->cycle_num > 0), "cycle_num");
+        channel_mask |= BIT(param->channel);
+    }
+    return ESP_OK;
+}
+
+// Called with ledc_spinlock taken, the channel fade (if any) owned and idle
+static IRAM_ATTR void _ledc_batch_channel_config(ledc_mode_t speed_mode, const ledc_batch_param_t *param)
+{
+    ledc_hal_context_t *hal = &(p_ledc_obj[speed_mode]->ledc_hal);
+    ledc_channel_t channel = param->channel;
+    if (param->cycle_num == 0) {
+        // Plain duty update, as ledc_set_duty()
+        ledc_duty_config(speed_mode, channel, LEDC_VAL_NO_CHANGE, param->target_duty, 1, 1, 1, 0);
+    } else {
+        ledc_fade_t *fade = s_ledc_fade_rec[speed_mode][channel];
+        uint32_t duty_cur = 0;
+        uint32_t max_duty = 0;
+        ledc_timer_t timer_sel;
+        ledc_hal_get_duty(hal, channel, &duty_cur);
+        ledc_hal_get_channel_timer(hal, channel, &timer_sel);
+        ledc_hal_get_max_duty(hal, timer_sel, &max_duty);
+        // Same counter overflow guard as _ledc_set_fade_with_step (ledc_get_max_duty is not in IRAM)
+        if (duty_cur == max_duty) {
+            duty_cur -= 1;
+        }
+        fade->speed_mode = speed_mode;
+        fade->target_duty = param->target_duty;
+        fade->cycle_num = param->cycle_num;
+        fade->scale = param->scale;
+        fade->mode = LEDC_FADE_NO_WAIT;
+        uint32_t step_num = 0;
+        ledc_duty_direction_t dir = LEDC_DUTY_DIR_INCREASE;
+        if (param->scale > 0) {
+            if (duty_cur > param->target_duty) {
+                dir = LEDC_DUTY_DIR_DECREASE;
+                step_num = (duty_cur - param->target_duty) / param->scale;
+            } else {
+                step_num = (param->target_duty - duty_cur) / param->scale;
+            }
+            step_num = step_num > LEDC_DUTY_NUM_MAX ? LEDC_DUTY_NUM_MAX : step_num;
+        }
+        fade->direction = dir;
+        if (step_num > 0) {
+            ledc_duty_config(speed_mode, channel, LEDC_VAL_NO_CHANGE, duty_cur, dir, step_num, param->cycle_num, param->scale);
+        } else {
+            // Directly set duty to the target and hold it, the fade end interrupt fires after cycle_num cycles
+            fade->scale = 0;
+            ledc_duty_config(speed_mode, channel, LEDC_VAL_NO_CHANGE, param->target_duty, 1, 1, param->cycle_num, 0);
+        }
+        ledc_hal_clear_fade_end_intr_status(hal, channel);
+        ledc_hal_set_fade_end_intr(hal, channel, true);
+        fade->fsm = LEDC_FSM_HW_FADE;
+    }
+    ledc_hal_set_sig_out_en(hal, channel, true);
+    ledc_hal_set_duty_start(hal, channel, true);
+}
+
+// Called with ledc_spinlock taken: latch all the channels on the same PWM period boundary
+static IRAM_ATTR void _ledc_batch_latch(ledc_mode_t speed_mode, ledc_timer_t timer_sel, const ledc_batch_param_t *params, uint32_t param_num)
+{
+#if LEDC_LL_TIMER_CNT_READABLE
+    if (param_num > 1) {
+        // The channel updates take effect on the next timer overflow: keep them out of the end of the period
+        ledc_hal_context_t *hal = &(p_ledc_obj[speed_mode]->ledc_hal);
+        uint32_t max_duty = 0;
+        uint32_t timer_cnt = 0;
+        ledc_hal_get_max_duty(hal, timer_sel, &max_duty);
+        uint32_t guard_cnt = max_duty - MAX(max_duty >> LEDC_BATCH_GUARD_SHIFT, 1);
+        for (int i = 0; i < LEDC_BATCH_GUARD_MAX_READ; i++) {
+            ledc_ll_get_timer_cnt(hal->dev, speed_mode, timer_sel, &timer_cnt);
+            if (timer_cnt < guard_cnt) {
+                break;
+            }
+        }
+    }
+#endif
+    for (uint32_t i = 0; i < param_num; i++) {
+        ledc_ls_channel_update(speed_mode, params[i].channel);
+    }
+}
+
+static IRAM_ATTR void _ledc_batch_release_isr(ledc_mode_t speed_mode, uint32_t channel_mask)
+{
+    for (int channel = 0; channel < LEDC_CHANNEL_MAX; channel++) {
+        if (channel_mask & BIT(channel)) {
+            xSemaphoreGiveFromISR(s_ledc_fade_rec[speed_mode][channel]->ledc_fade_sem, NULL);
+        }
+    }
+}
+
+esp_err_t IRAM_ATTR ledc_set_fade_step_and_start_isr(ledc_mode_t speed_mode, ledc_channel_t channel, uint32_t target_duty, uint32_t scale, uint32_t cycle_num)
+{
+    LEDC_ARG_CHECK_ISR(speed_mode < LEDC_SPEED_MODE_MAX, "speed_mode");
+    LEDC_ARG_CHECK_ISR(channel < LEDC_CHANNEL_MAX, "channel");
+    LEDC_CHECK_ISR(p_ledc_obj[speed_mode] != NULL, LEDC_NOT_INIT, ESP_ERR_INVALID_STATE);
+    LEDC_CHECK_ISR(s_ledc_fade_rec[speed_mode][channel] != NULL, LEDC_FADE_SERVICE_ERR_STR, ESP_ERR_INVALID_STATE);
+    LEDC_ARG_CHECK_ISR((cycle_num > 0) && (cycle_num <= LEDC_LL_DUTY_CYCLE_MAX), "cycle_num");
+    ledc_timer_t timer_sel;
+    ledc_hal_get_channel_timer(&(p_ledc_obj[speed_mode]->ledc_hal), channel, &timer_sel);
+    const ledc_batch_param_t param = {
+        .channel = channel,
+        .target_duty = target_duty,
+        .scale = scale,
+        .cycle_num = cycle_num,
+    };
+    return ledc_set_batch_and_update_isr(speed_mode, timer_sel, &param, 1);
+}
+
+esp_err_t ledc_set_batch_and_update(ledc_mode_t speed_mode, ledc_timer_t timer_sel, const ledc_batch_param_t *params, uint32_t param_num)
+{
+    esp_err_t ret = _ledc_batch_check(speed_mode, timer_sel, params, param_num);
+    if (ret != ESP_OK) {
+        return ret;
+    }
+    uint32_t channel_mask = 0;
+    uint32_t fade_mask = 0;
+    for (uint32_t i = 0; i < param_num; i++) {
+        if (params[i].cycle_num > 0) {
+            LEDC_CHECK(ledc_fade_channel_init_check(speed_mode, params[i].channel) == ESP_OK, LEDC_FADE_INIT_ERROR_STR, ESP_FAIL);
+            fade_mask |= BIT(params[i].channel);
+        }
+        channel_mask |= BIT(params[i].channel);
+    }
+    // Channel order: no deadlock between two batches sharing channels
+    for (int channel = 0; channel < LEDC_CHANNEL_MAX; channel++) {
+        if (channel_mask & BIT(channel)) {
+            _ledc_op_lock_acquire(speed_mode, channel);
+            /* The channel configuration should not be changed before the fade operation is done. */
+            _ledc_fade_hw_acquire(speed_mode, channel);
+        }
+    }
+    portENTER_CRITICAL(&ledc_spinlock);
+    for (uint32_t i = 0; i < param_num; i++) {
+        _ledc_batch_channel_config(speed_mode, &params[i]);
+    }
+    _ledc_batch_latch(speed_mode, timer_sel, params, param_num);
+    portEXIT_CRITICAL(&ledc_spinlock);
+    for (int channel = 0; channel < LEDC_CHANNEL_MAX; channel++) {
+        if (channel_mask & BIT(channel)) {
+            // Fades in progress keep the hardware, released by the fade end ISR
+            if ((fade_mask & BIT(channel)) == 0) {
+                _ledc_fade_hw_release(speed_mode, channel);
+            }
+            _ledc_op_lock_release(speed_mode, channel);
+        }
+    }
+    return ESP_OK;
+}
+
+esp_err_t IRAM_ATTR ledc_set_batch_and_update_isr(ledc_mode_t speed_mode, ledc_timer_t timer_sel, const ledc_batch_param_t *params, uint32_t param_num)
+{
+    esp_err_t ret = _ledc_batch_check(speed_mode, timer_sel, params, param_num);
+    if (ret != ESP_OK) {
+        return ret;
+    }
+    for (uint32_t i = 0; i < param_num; i++) {
+        if (params[i].cycle_num > 0) {
+            LEDC_CHECK_ISR(s_ledc_fade_rec[speed_mode][params[i].channel] != NULL, LEDC_FADE_SERVICE_ERR_STR, ESP_ERR_INVALID_STATE);
+        }
+    }
+    // Same ownership as _ledc_fade_hw_acquire, without blocking: the fade end ISR gives it back
+    uint32_t owned_mask = 0;
+    for (uint32_t i = 0; i < param_num; i++) {
+        ledc_fade_t *fade = s_ledc_fade_rec[speed_mode][params[i].channel];
+        if (fade == NULL) {
+            continue;
+        }
+        if (xSemaphoreTakeFromISR(fade->ledc_fade_sem, NULL) != pdTRUE) {
+            _ledc_batch_release_isr(speed_mode, owned_mask);
+            return ESP_ERR_INVALID_STATE;
+        }
+        owned_mask |= BIT(params[i].channel);
+    }
+    portENTER_CRITICAL_ISR(&ledc_spinlock);
+    for (uint32_t i = 0; i < param_num; i++) {
+        ledc_fade_t *fade = s_ledc_fade_rec[speed_mode][params[i].channel];
+        if ((fade != NULL) && (fade->fsm != LEDC_FSM_IDLE)) {
+            portEXIT_CRITICAL_ISR(&ledc_spinlock);
+            _ledc_batch_release_isr(speed_mode, owned_mask);
+            return ESP_ERR_INVALID_STATE;
+        }
+    }
+    for (uint32_t i = 0; i < param_num; i++) {
+        _ledc_batch_channel_config(speed_mode, &params[i]);
+        // Fades in progress keep the hardware, released by the fade end ISR
+        if (params[i].cycle_num > 0) {
+            owned_mask &= ~BIT(params[i].channel);
+        }
+    }
+    _ledc_batch_latch(speed_mode, timer_sel, params, param_num);
+    portEXIT_CRITICAL_ISR(&ledc_spinlock);
+    _ledc_batch_release_isr(speed_mode, owned_mask);
+    return ESP_OK;
+}
+
 #if SOC_LEDC_GAMMA_CURVE_FADE_SUPPORTED
 static esp_err_t _ledc_set_multi_fade(ledc_mode_t speed_mode, ledc_channel_t channel, uint32_t start_duty, const ledc_fade_param_config_t *fade_params_list, uint32_t list_len)
 {
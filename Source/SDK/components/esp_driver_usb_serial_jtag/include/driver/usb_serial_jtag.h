@@ -83,6 +83,18 @@ int usb_serial_jtag_write_bytes(const void* src, size_t size, TickType_t ticks_t
  */
 esp_err_t usb_serial_jtag_wait_tx_done(TickType_t ticks_to_wait);
 
+/**
+ * @brief Get the number of bytes waiting in the driver buffers
+ *
+ * @param[out] rx_size Bytes received, not read yet (NULL: not returned)
+ * @param[out] tx_size Bytes written, not sent to the host yet (NULL: not returned)
+ *
+ * @return
+ *     - ESP_OK   Success
+ *     - ESP_ERR_INVALID_STATE Driver not installed
+ */
+esp_err_t usb_serial_jtag_get_buffered_data_len(size_t *rx_size, size_t *tx_size);
+
 /**
  * @brief Uninstall USB-SERIAL-JTAG driver.
  *
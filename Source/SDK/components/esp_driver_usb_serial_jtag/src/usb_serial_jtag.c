@@ -41,9 +41,11 @@ typedef struct {
 
     // RX parameters
     RingbufHandle_t rx_ring_buf;        /*!< RX ring buffer handler */
+    size_t rx_buf_size;                 /*!< RX ring buffer size */
 
     // TX parameters
     RingbufHandle_t tx_ring_buf;        /*!< TX ring buffer handler */
+    size_t tx_buf_size;                 /*!< TX ring buffer size */
     uint8_t tx_stash_buf[USB_SER_JTAG_ENDP_SIZE];  /*!< Data buffer to stash TX FIFO data */
     size_t tx_stash_cnt;                           /*!< Number of stashed TX FIFO bytes */
 
@@ -174,6 +176,8 @@ esp_err_t usb_serial_jtag_driver_install(usb_serial_jtag_driver_config_t *usb_se
         return ESP_ERR_NO_MEM;
     }
     p_usb_serial_jtag_obj->tx_stash_cnt = 0;
+    p_usb_serial_jtag_obj->rx_buf_size = usb_serial_jtag_config->rx_buffer_size;
+    p_usb_serial_jtag_obj->tx_buf_size = usb_serial_jtag_config->tx_buffer_size;
 
     p_usb_serial_jtag_obj->rx_ring_buf = xRingbufferCreate(usb_serial_jtag_config->rx_buffer_size, RINGBUF_TYPE_BYTEBUF);
     if (p_usb_serial_jtag_obj->rx_ring_buf == NULL) {
@@ -375,6 +379,23 @@ bool usb_serial_jtag_read_ready(void)
     return items_waiting != 0;
 }
 
+esp_err_t usb_serial_jtag_get_buffered_data_len(size_t *rx_size, size_t *tx_size)
+{
+    ESP_RETURN_ON_FALSE(p_usb_serial_jtag_obj != NULL, ESP_ERR_INVALID_STATE, USB_SERIAL_JTAG_TAG, "The driver hasn't been initialized");
+
+    if (rx_size) {
+        size_t rx_free = xRingbufferGetCurFreeSize(p_usb_serial_jtag_obj->rx_ring_buf);
+        *rx_size = (rx_free < p_usb_serial_jtag_obj->rx_buf_size) ? (p_usb_serial_jtag_obj->rx_buf_size - rx_free) : 0;
+    }
+    if (tx_size) {
+        // Ring buffer and the bytes stashed for the TX FIFO
+        size_t tx_free = xRingbufferGetCurFreeSize(p_usb_serial_jtag_obj->tx_ring_buf);
+        *tx_size = ((tx_free < p_usb_serial_jtag_obj->tx_buf_size) ? (p_usb_serial_jtag_obj->tx_buf_size - tx_free) : 0) +
+                   p_usb_serial_jtag_obj->tx_stash_cnt;
+    }
+    return ESP_OK;
+}
+
 bool usb_serial_jtag_write_ready(void)
 {
     // sign that the driver is write ready is that the TX ring buffer is not full
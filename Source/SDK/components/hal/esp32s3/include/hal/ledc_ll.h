@@ -27,6 +27,7 @@ extern "C" {
 #define LEDC_LL_HPOINT_VAL_MAX     (LEDC_HPOINT_LSCH0_V)
 #define LEDC_LL_FRACTIONAL_BITS    (8)
 #define LEDC_LL_FRACTIONAL_MAX     ((1 << LEDC_LL_FRACTIONAL_BITS) - 1)
+#define LEDC_LL_TIMER_CNT_READABLE (1)
 
 #define LEDC_LL_GLOBAL_CLOCKS { \
                                 LEDC_SLOW_CLK_APB, \
@@ -273,6 +274,21 @@ static inline void ledc_ll_get_max_duty(ledc_dev_t *hw, ledc_mode_t speed_mode,
     *max_duty = (1 << (LEDC.timer_group[speed_mode].timer[timer_sel].conf.duty_resolution));
 }
 
+/**
+ * @brief Get LEDC timer counter value
+ *
+ * @param hw Beginning address of the peripheral registers
+ * @param speed_mode LEDC speed_mode, high-speed mode or low-speed mode
+ * @param timer_sel LEDC timer index (0-3), select from ledc_timer_t
+ * @param timer_cnt Pointer to accept the timer counter value
+ *
+ * @return None
+ */
+static inline void ledc_ll_get_timer_cnt(ledc_dev_t *hw, ledc_mode_t speed_mode, ledc_timer_t timer_sel, uint32_t *timer_cnt)
+{
+    *timer_cnt = hw->timer_group[speed_mode].timer[timer_sel].value.timer_cnt;
+}
+
 /**
  * @brief Update channel configure when select low speed mode
  *